@@ -0,0 +1,27 @@
+#
+# Find the native LZ4 includes and library
+#
+# This module defines
+# LZ4_INCLUDE_DIR, where to find lz4.h, etc.
+# LZ4_LIBRARIES, the libraries to link against to use LZ4.
+# LZ4_FOUND, If false, do not try to use LZ4.
+
+# also defined, but not for general use are
+# LZ4_LIBRARY, where to find the LZ4 library.
+
+FIND_PATH(LZ4_INCLUDE_DIR lz4.h
+  /usr/local/include
+  /usr/include
+)
+
+FIND_LIBRARY(LZ4_LIBRARY lz4
+  /usr/lib
+  /usr/local/lib
+)
+
+IF(LZ4_INCLUDE_DIR)
+  IF(LZ4_LIBRARY)
+    SET( LZ4_FOUND "YES" )
+    SET( LZ4_LIBRARIES ${LZ4_LIBRARY} )
+  ENDIF(LZ4_LIBRARY)
+ENDIF(LZ4_INCLUDE_DIR)
@@ -74,6 +74,26 @@ void MyDeleteCallback(vtkObject*, unsigned long, void*, void*)
   called = 1;
 }
 
+// A callback that counts the objects deleted.
+static int deleted = 0;
+void MyCountCallback(vtkObject*, unsigned long, void*, void*)
+{
+  ++deleted;
+}
+
+// Create loops and delete them, so that their collection is deferred
+// in batched mode.
+#define NUMBER_OF_LOOPS 100
+static void DeleteLoops(vtkCallbackCommand* cc)
+{
+  for(int i=0; i < NUMBER_OF_LOOPS; ++i)
+    {
+    vtkTestReferenceLoop* obj = vtkTestReferenceLoop::New();
+    obj->AddObserver(vtkCommand::DeleteEvent, cc);
+    obj->Delete();
+    }
+}
+
 // Main test function.
 int TestGarbageCollector(int,char *[])
 {
@@ -115,5 +135,73 @@ int TestGarbageCollector(int,char *[])
     return 1;
     }
 
+  // In batched mode nothing is collected until asked, even when
+  // deferred collection is popped.
+  vtkSmartPointer<vtkCallbackCommand> counter =
+    vtkSmartPointer<vtkCallbackCommand>::New();
+  counter->SetCallback(MyCountCallback);
+  vtkGarbageCollector::SetBatchedCollection(1);
+  vtkGarbageCollector::ResetStatistics();
+  deleted = 0;
+  DeleteLoops(counter);
+  vtkGarbageCollector::DeferredCollectionPush();
+  vtkGarbageCollector::DeferredCollectionPop();
+  if(deleted != 0 ||
+     vtkGarbageCollector::GetNumberOfDeferredChecks() != NUMBER_OF_LOOPS)
+    {
+    cerr << "Batched collection deleted " << deleted << " objects and kept "
+         << vtkGarbageCollector::GetNumberOfDeferredChecks()
+         << " checks." << endl;
+    return 1;
+    }
+
+  // Incremental collection with no time does one walk.
+  int left = vtkGarbageCollector::CollectIncrementally(0.0);
+  if(left != NUMBER_OF_LOOPS-1 || deleted != 1 ||
+     vtkGarbageCollector::GetNumberOfCollections() != 1 ||
+     vtkGarbageCollector::GetNumberOfCollectedObjects() != 2)
+    {
+    cerr << "Incremental collection left " << left << " checks and deleted "
+         << deleted << " objects in "
+         << vtkGarbageCollector::GetNumberOfCollections()
+         << " walks." << endl;
+    return 1;
+    }
+  left = vtkGarbageCollector::CollectIncrementally(1000.0);
+  if(left != 0 || deleted != NUMBER_OF_LOOPS)
+    {
+    cerr << "Incremental collection left " << left << " checks." << endl;
+    return 1;
+    }
+
+  // Collecting all at once walks once.
+  vtkGarbageCollector::ResetStatistics();
+  deleted = 0;
+  DeleteLoops(counter);
+  vtkGarbageCollector::Collect();
+  if(deleted != NUMBER_OF_LOOPS ||
+     vtkGarbageCollector::GetNumberOfCollections() != 1 ||
+     vtkGarbageCollector::GetNumberOfVisitedObjects() != 2*NUMBER_OF_LOOPS ||
+     vtkGarbageCollector::GetNumberOfCollectedObjects() != 2*NUMBER_OF_LOOPS ||
+     vtkGarbageCollector::GetCollectionTime() < 0)
+    {
+    cerr << "Batched collection deleted " << deleted << " objects in "
+         << vtkGarbageCollector::GetNumberOfCollections()
+         << " walks." << endl;
+    return 1;
+    }
+
+  // Turning batched mode off collects what is left.
+  deleted = 0;
+  DeleteLoops(counter);
+  vtkGarbageCollector::SetBatchedCollection(0);
+  if(deleted != NUMBER_OF_LOOPS ||
+     vtkGarbageCollector::GetNumberOfDeferredChecks() != 0)
+    {
+    cerr << "Leaving batched mode deleted " << deleted << " objects."
+         << endl;
+    return 1;
+    }
+
   return 0;
 }
@@ -0,0 +1,155 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestTaskScheduler.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of vtkTaskScheduler.
+// .SECTION Description
+// Checks that ParallelFor covers its range exactly once, that calls can
+// nest, and that vtkMultiThreader can run its single method on the
+// scheduler.
+
+#include "vtkMultiThreader.h"
+#include "vtkTaskScheduler.h"
+
+#define VTK_TEST_TASK_SIZE 10000
+#define VTK_TEST_TASK_OUTER 16
+
+static int TestTaskSchedulerCounts[VTK_TEST_TASK_OUTER * VTK_TEST_TASK_SIZE];
+
+static void TestTaskSchedulerIncrement(void *data, vtkIdType begin,
+                                       vtkIdType end)
+{
+  int *counts = static_cast<int *>(data);
+  for (vtkIdType i = begin; i < end; ++i)
+    {
+    ++counts[i];
+    }
+}
+
+static void TestTaskSchedulerNested(void *data, vtkIdType begin,
+                                    vtkIdType end)
+{
+  vtkTaskScheduler *scheduler = static_cast<vtkTaskScheduler *>(data);
+  for (vtkIdType i = begin; i < end; ++i)
+    {
+    scheduler->ParallelFor(0, VTK_TEST_TASK_SIZE, 7,
+                           TestTaskSchedulerIncrement,
+                           TestTaskSchedulerCounts + i * VTK_TEST_TASK_SIZE);
+    }
+}
+
+static int TestTaskSchedulerCheck(int expected, const char *name)
+{
+  for (int i = 0; i < VTK_TEST_TASK_OUTER * VTK_TEST_TASK_SIZE; ++i)
+    {
+    if (TestTaskSchedulerCounts[i] != expected)
+      {
+      cerr << name << ": index " << i << " was visited "
+           << TestTaskSchedulerCounts[i] << " times, expected "
+           << expected << "\n";
+      return 1;
+      }
+    }
+  return 0;
+}
+
+static int TestTaskSchedulerThreadIds[VTK_MAX_THREADS];
+static vtkMultiThreaderIDType TestTaskSchedulerCaller;
+static int TestTaskSchedulerCallerMismatch;
+
+static VTK_THREAD_RETURN_TYPE TestTaskSchedulerSingleMethod(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  ++TestTaskSchedulerThreadIds[info->ThreadID];
+  if (info->ThreadID == 0 &&
+      !vtkMultiThreader::ThreadsEqual(vtkMultiThreader::GetCurrentThreadID(),
+                                      TestTaskSchedulerCaller))
+    {
+    TestTaskSchedulerCallerMismatch = 1;
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+int TestTaskScheduler(int,char *[])
+{
+  int retVal = 0;
+  int i;
+  vtkTaskScheduler *scheduler = vtkTaskScheduler::New();
+  scheduler->SetNumberOfThreads(4);
+
+  // A flat loop, with an explicit and an automatic grain.
+  for (i = 0; i < VTK_TEST_TASK_OUTER * VTK_TEST_TASK_SIZE; ++i)
+    {
+    TestTaskSchedulerCounts[i] = 0;
+    }
+  scheduler->ParallelFor(0, VTK_TEST_TASK_OUTER * VTK_TEST_TASK_SIZE, 13,
+                         TestTaskSchedulerIncrement, TestTaskSchedulerCounts);
+  retVal |= TestTaskSchedulerCheck(1, "Flat loop");
+  scheduler->ParallelFor(0, VTK_TEST_TASK_OUTER * VTK_TEST_TASK_SIZE, 0,
+                         TestTaskSchedulerIncrement, TestTaskSchedulerCounts);
+  retVal |= TestTaskSchedulerCheck(2, "Automatic grain");
+
+  // Nested loops, repeated so that the workers are reused.
+  for (int repeat = 0; repeat < 10; ++repeat)
+    {
+    scheduler->ParallelFor(0, VTK_TEST_TASK_OUTER, 1,
+                           TestTaskSchedulerNested, scheduler);
+    }
+  retVal |= TestTaskSchedulerCheck(12, "Nested loop");
+
+  // Changing the number of threads restarts the workers.
+  scheduler->SetNumberOfThreads(1);
+  scheduler->ParallelFor(0, VTK_TEST_TASK_OUTER * VTK_TEST_TASK_SIZE, 100,
+                         TestTaskSchedulerIncrement, TestTaskSchedulerCounts);
+  retVal |= TestTaskSchedulerCheck(13, "Single thread");
+  scheduler->SetNumberOfThreads(3);
+  scheduler->ParallelFor(0, VTK_TEST_TASK_OUTER, 1,
+                         TestTaskSchedulerNested, scheduler);
+  retVal |= TestTaskSchedulerCheck(14, "Restarted workers");
+  scheduler->Delete();
+
+  // The multithreader runs every thread id once, and id 0 on this thread.
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  threader->UseTaskSchedulerOn();
+  threader->SetNumberOfThreads(8);
+  threader->SetSingleMethod(TestTaskSchedulerSingleMethod, 0);
+  TestTaskSchedulerCaller = vtkMultiThreader::GetCurrentThreadID();
+  TestTaskSchedulerCallerMismatch = 0;
+  for (i = 0; i < VTK_MAX_THREADS; ++i)
+    {
+    TestTaskSchedulerThreadIds[i] = 0;
+    }
+  for (i = 0; i < 5; ++i)
+    {
+    threader->SingleMethodExecute();
+    }
+  for (i = 0; i < VTK_MAX_THREADS; ++i)
+    {
+    int expected = (i < threader->GetNumberOfThreads() ? 5 : 0);
+    if (TestTaskSchedulerThreadIds[i] != expected)
+      {
+      cerr << "Thread id " << i << " ran " << TestTaskSchedulerThreadIds[i]
+           << " times, expected " << expected << "\n";
+      retVal = 1;
+      }
+    }
+  if (TestTaskSchedulerCallerMismatch)
+    {
+    cerr << "Thread id 0 did not run on the calling thread\n";
+    retVal = 1;
+    }
+  threader->Delete();
+
+  return retVal;
+}
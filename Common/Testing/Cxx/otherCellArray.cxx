@@ -20,9 +20,14 @@
 #include "vtkDebugLeaks.h"
 
 #include "vtkCellArray.h"
+#include "vtkCellLinks.h"
+#include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
+#include "vtkIntArray.h"
+#include "vtkPoints.h"
 #include "vtkQuad.h"
+#include "vtkUnstructuredGrid.h"
 
 int TestCellArray(ostream& strm)
 {
@@ -79,8 +84,205 @@ int TestCellArray(ostream& strm)
   return 0;
 }
 
+// Compare the cells of ca with the interleaved list cells.
+static int CompareCells(vtkCellArray *ca, const vtkIdType *cells,
+                        vtkIdType numCells, ostream& strm)
+{
+  vtkIdList *ids = vtkIdList::New();
+  vtkIdType npts, *pts, i, j;
+  const vtkIdType *cell = cells;
+  int retVal = 0;
+  for (i = 0; i < numCells; i++, cell += cell[0] + 1)
+    {
+    ca->GetCellAtId(i, ids);
+    if (ids->GetNumberOfIds() != cell[0])
+      {
+      retVal = 1;
+      }
+    for (j = 0; !retVal && j < cell[0]; j++)
+      {
+      retVal = (ids->GetId(j) != cell[j+1]);
+      }
+    ca->GetCellAtId(i, npts, pts);
+    if (npts != cell[0])
+      {
+      retVal = 1;
+      }
+    for (j = 0; !retVal && j < npts; j++)
+      {
+      retVal = (pts[j] != cell[j+1]);
+      }
+    if (retVal)
+      {
+      strm << "Cell " << i << " differs" << endl;
+      break;
+      }
+    }
+  ids->Delete();
+  return retVal;
+}
+
+int TestCellArrayOffsets(ostream& strm)
+{
+  strm << "Test CellArray Offsets Start" << endl;
+  int retVal = 0;
+
+  // A triangle, a quad, a vertex and a tetra.
+  const vtkIdType cells[16] = {3, 0, 1, 2, 4, 2, 3, 4, 5, 1, 6,
+                               4, 0, 2, 4, 6};
+  int offsetValues[5] = {0, 3, 7, 8, 12};
+  int connectivityValues[12] = {0, 1, 2, 2, 3, 4, 5, 6, 0, 2, 4, 6};
+  vtkIntArray *offsets = vtkIntArray::New();
+  offsets->SetArray(offsetValues, 5, 1);
+  vtkIntArray *connectivity = vtkIntArray::New();
+  connectivity->SetArray(connectivityValues, 12, 1);
+
+  // Arrays of ints are used as they are.
+  vtkCellArray *ca = vtkCellArray::New();
+  ca->SetData(offsets, connectivity);
+  if (ca->IsStorageInterleaved() || ca->GetNumberOfCells() != 4 ||
+      ca->GetNumberOfConnectivityEntries() != 16 || ca->GetSize() != 16 ||
+      ca->GetMaxCellSize() != 4)
+    {
+    strm << "SetData with int arrays gave the wrong sizes" << endl;
+    retVal = 1;
+    }
+  vtkIdList *ids = vtkIdList::New();
+  ca->GetCellAtId(1, ids);
+  if (ids->GetNumberOfIds() != 4 || ids->GetId(3) != 5 ||
+      ca->GetConnectivityArray() != connectivity)
+    {
+    strm << "GetCellAtId changed or misread the int arrays" << endl;
+    retVal = 1;
+    }
+  retVal |= CompareCells(ca, cells, 4, strm);
+
+  // Traversal converts to the interleaved list.
+  vtkIdType npts, *pts;
+  ca->InitTraversal();
+  ca->GetNextCell(npts, pts);
+  if (!ca->IsStorageInterleaved() || ca->GetNumberOfCells() != 4 ||
+      ca->GetNumberOfConnectivityEntries() != 16 || npts != 3 ||
+      memcmp(ca->GetPointer(), cells, 16*sizeof(vtkIdType)))
+    {
+    strm << "Traversal did not convert to the interleaved list" << endl;
+    retVal = 1;
+    }
+  retVal |= CompareCells(ca, cells, 4, strm);
+
+  // Inserting a cell also converts.
+  vtkIdTypeArray *idOffsets = vtkIdTypeArray::New();
+  vtkIdTypeArray *idConnectivity = vtkIdTypeArray::New();
+  vtkIdType i;
+  for (i = 0; i < 5; i++)
+    {
+    idOffsets->InsertNextValue(offsetValues[i]);
+    }
+  for (i = 0; i < 12; i++)
+    {
+    idConnectivity->InsertNextValue(connectivityValues[i]);
+    }
+  ca->SetData(idOffsets, idConnectivity);
+  retVal |= CompareCells(ca, cells, 4, strm);
+  if (ca->GetConnectivityArray() != idConnectivity)
+    {
+    strm << "GetCellAtId copied a vtkIdTypeArray" << endl;
+    retVal = 1;
+    }
+  vtkIdType last[4] = {3, 5, 6, 7};
+  if (ca->InsertNextCell(3, last+1) != 4 || !ca->IsStorageInterleaved() ||
+      ca->GetNumberOfConnectivityEntries() != 20)
+    {
+    strm << "InsertNextCell did not convert to the interleaved list" << endl;
+    retVal = 1;
+    }
+  vtkIdType cells5[20];
+  memcpy(cells5, cells, 16*sizeof(vtkIdType));
+  memcpy(cells5+16, last, 4*sizeof(vtkIdType));
+  retVal |= CompareCells(ca, cells5, 5, strm);
+
+  // Bad arrays are rejected.
+  offsetValues[0] = 1;
+  int display = vtkObject::GetGlobalWarningDisplay();
+  vtkObject::GlobalWarningDisplayOff();
+  ca->SetData(offsets, connectivity);
+  vtkObject::SetGlobalWarningDisplay(display);
+  offsetValues[0] = 0;
+  if (!ca->IsStorageInterleaved() || ca->GetNumberOfCells() != 5)
+    {
+    strm << "SetData accepted offsets that do not start with 0" << endl;
+    retVal = 1;
+    }
+
+  // An unstructured grid uses the arrays without cell locations.
+  vtkUnstructuredGrid *grid = vtkUnstructuredGrid::New();
+  vtkPoints *points = vtkPoints::New();
+  for (i = 0; i < 8; i++)
+    {
+    points->InsertNextPoint(i % 2, (i/2) % 2, i/4);
+    }
+  grid->SetPoints(points);
+  points->Delete();
+  int types[4] = {VTK_TRIANGLE, VTK_QUAD, VTK_VERTEX, VTK_TETRA};
+  ca->SetData(offsets, connectivity);
+  grid->SetCells(types, ca);
+  if (ca->GetConnectivityArray() != connectivity)
+    {
+    strm << "SetCells copied the connectivity" << endl;
+    retVal = 1;
+    }
+  vtkGenericCell *cell = vtkGenericCell::New();
+  grid->GetCell(3, cell);
+  grid->GetCellPoints(1, ids);
+  vtkCellLinks *links = vtkCellLinks::New();
+  links->Allocate(8);
+  links->BuildLinks(grid, ca);
+  if (ca->IsStorageInterleaved() || cell->GetCellType() != VTK_TETRA ||
+      cell->GetPointId(3) != 6 || ids->GetId(0) != 2 ||
+      grid->GetCell(1)->GetPointId(3) != 5 || links->GetNcells(2) != 3 ||
+      links->GetNcells(7) != 0)
+    {
+    strm << "The grid did not use the offsets" << endl;
+    retVal = 1;
+    }
+  vtkIdTypeArray *locations = grid->GetCellLocationsArray();
+  if (!locations || locations->GetNumberOfTuples() != 4 ||
+      locations->GetValue(3) != 11 || !ca->IsStorageInterleaved())
+    {
+    strm << "GetCellLocationsArray did not build the locations" << endl;
+    retVal = 1;
+    }
+  grid->GetCellPoints(3, npts, pts);
+  if (npts != 4 || pts[3] != 6)
+    {
+    strm << "The grid cells changed with the locations" << endl;
+    retVal = 1;
+    }
+
+  links->Delete();
+  cell->Delete();
+  grid->Delete();
+  ids->Delete();
+  idOffsets->Delete();
+  idConnectivity->Delete();
+  ca->Delete();
+  offsets->Delete();
+  connectivity->Delete();
+  strm << "Test CellArray Offsets Complete" << endl;
+
+  return retVal;
+}
+
 int otherCellArray(int,char *[])
 {
   ostrstream vtkmsg_with_warning_C4701; 
-  return TestCellArray(vtkmsg_with_warning_C4701);
+  int retVal = TestCellArray(vtkmsg_with_warning_C4701);
+  retVal |= TestCellArrayOffsets(vtkmsg_with_warning_C4701);
+  if (retVal)
+    {
+    vtkmsg_with_warning_C4701 << ends;
+    cerr << vtkmsg_with_warning_C4701.str();
+    vtkmsg_with_warning_C4701.rdbuf()->freeze(0);
+    }
+  return retVal;
 } 
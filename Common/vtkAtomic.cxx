@@ -0,0 +1,130 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkAtomic.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkAtomic.h"
+
+#if defined(__GNUC__) && \
+  ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 1)))
+# define VTK_ATOMIC_GCC
+#elif defined(_MSC_VER) && (_MSC_VER >= 1400)
+# define VTK_ATOMIC_WIN32
+# include "vtkWindows.h"
+#else
+# include "vtkCriticalSection.h"
+// Serializes the operations when there are no atomic instructions.
+static vtkSimpleCriticalSection vtkAtomicLock;
+#endif
+
+//----------------------------------------------------------------------------
+int vtkAtomic::IsLockFree()
+{
+#if defined(VTK_ATOMIC_GCC) || defined(VTK_ATOMIC_WIN32)
+  return 1;
+#else
+  return 0;
+#endif
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkAtomic::FetchAndAdd(volatile vtkIdType *value,
+                                 vtkIdType increment)
+{
+#if defined(VTK_ATOMIC_GCC)
+  return __sync_fetch_and_add(value, increment);
+#elif defined(VTK_ATOMIC_WIN32)
+# if VTK_SIZEOF_ID_TYPE == 8
+  return static_cast<vtkIdType>(InterlockedExchangeAdd64(
+    reinterpret_cast<volatile LONGLONG *>(value),
+    static_cast<LONGLONG>(increment)));
+# else
+  return static_cast<vtkIdType>(InterlockedExchangeAdd(
+    reinterpret_cast<volatile LONG *>(value),
+    static_cast<LONG>(increment)));
+# endif
+#else
+  vtkAtomicLock.Lock();
+  vtkIdType previous = *value;
+  *value = previous + increment;
+  vtkAtomicLock.Unlock();
+  return previous;
+#endif
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkAtomic::CompareAndSwap(volatile vtkIdType *value,
+                                    vtkIdType oldValue, vtkIdType newValue)
+{
+#if defined(VTK_ATOMIC_GCC)
+  return __sync_val_compare_and_swap(value, oldValue, newValue);
+#elif defined(VTK_ATOMIC_WIN32)
+# if VTK_SIZEOF_ID_TYPE == 8
+  return static_cast<vtkIdType>(InterlockedCompareExchange64(
+    reinterpret_cast<volatile LONGLONG *>(value),
+    static_cast<LONGLONG>(newValue), static_cast<LONGLONG>(oldValue)));
+# else
+  return static_cast<vtkIdType>(InterlockedCompareExchange(
+    reinterpret_cast<volatile LONG *>(value),
+    static_cast<LONG>(newValue), static_cast<LONG>(oldValue)));
+# endif
+#else
+  vtkAtomicLock.Lock();
+  vtkIdType previous = *value;
+  if (previous == oldValue)
+    {
+    *value = newValue;
+    }
+  vtkAtomicLock.Unlock();
+  return previous;
+#endif
+}
+
+//----------------------------------------------------------------------------
+void *vtkAtomic::CompareAndSwapPointer(void *volatile *value,
+                                       void *oldValue, void *newValue)
+{
+#if defined(VTK_ATOMIC_GCC)
+  return __sync_val_compare_and_swap(value, oldValue, newValue);
+#elif defined(VTK_ATOMIC_WIN32)
+  return InterlockedCompareExchangePointer(
+    reinterpret_cast<PVOID volatile *>(value), newValue, oldValue);
+#else
+  vtkAtomicLock.Lock();
+  void *previous = *value;
+  if (previous == oldValue)
+    {
+    *value = newValue;
+    }
+  vtkAtomicLock.Unlock();
+  return previous;
+#endif
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkAtomic::Load(volatile vtkIdType *value)
+{
+#if defined(VTK_ATOMIC_GCC)
+  vtkIdType result = *value;
+  __sync_synchronize();
+  return result;
+#elif defined(VTK_ATOMIC_WIN32)
+  vtkIdType result = *value;
+  MemoryBarrier();
+  return result;
+#else
+  vtkAtomicLock.Lock();
+  vtkIdType result = *value;
+  vtkAtomicLock.Unlock();
+  return result;
+#endif
+}
@@ -0,0 +1,58 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkAtomic.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkAtomic - atomic operations on ids shared by threads
+// .SECTION Description
+// vtkAtomic provides the few atomic operations used by the tasks of
+// vtkTaskScheduler to share counters and lists without locks.  They use
+// the GCC __sync builtins or the Windows Interlocked functions.  Other
+// compilers get the same operations serialized by a lock, which is
+// correct but slow; IsLockFree() tells which is used, so that callers can
+// choose to do the work in a single task instead.
+// .SECTION See Also
+// vtkTaskScheduler vtkSimpleCriticalSection
+
+#ifndef __vtkAtomic_h
+#define __vtkAtomic_h
+
+#include "vtkSystemIncludes.h"
+
+class VTK_COMMON_EXPORT vtkAtomic
+{
+public:
+  // Description:
+  // Return 1 if the operations use atomic instructions, or 0 if they are
+  // serialized by a lock.
+  static int IsLockFree();
+
+  // Description:
+  // Atomically add increment to *value and return the value it had.
+  static vtkIdType FetchAndAdd(volatile vtkIdType *value,
+                               vtkIdType increment);
+
+  // Description:
+  // Atomically replace *value by newValue if it equals oldValue, and
+  // return the value it had.
+  static vtkIdType CompareAndSwap(volatile vtkIdType *value,
+                                  vtkIdType oldValue, vtkIdType newValue);
+  static void *CompareAndSwapPointer(void *volatile *value,
+                                     void *oldValue, void *newValue);
+
+  // Description:
+  // Read a value stored by CompareAndSwap() on another thread, and make
+  // the data written before it by that thread visible to this one.
+  static vtkIdType Load(volatile vtkIdType *value);
+};
+
+#endif
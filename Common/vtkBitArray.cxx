@@ -34,6 +34,10 @@ vtkBitArray::~vtkBitArray()
     {
     delete [] this->Array;
     }
+  else
+    {
+    this->ReleaseUserArray(this->Array);
+    }
   delete [] this->Tuple;
 }
 
@@ -68,6 +72,10 @@ void vtkBitArray::SetArray(unsigned char* array, vtkIdType size, int save)
   else 
     {
       vtkDebugMacro (<<"Warning, array not deleted, but will point to new array.");
+      if (array != this->Array)
+        {
+        this->ReleaseUserArray(this->Array);
+        }
     }
 
   vtkDebugMacro(<<"Setting array to: " << array);
@@ -97,6 +105,10 @@ int vtkBitArray::Allocate(vtkIdType sz, vtkIdType vtkNotUsed(ext))
       {
       delete [] this->Array;
       }
+    else
+      {
+      this->ReleaseUserArray(this->Array);
+      }
     this->Size = ( sz > 0 ? sz : 1);
     if ( (this->Array = new unsigned char[(this->Size+7)/8]) == NULL )
       {
@@ -117,6 +129,10 @@ void vtkBitArray::Initialize()
     {
     delete [] this->Array;
     }
+  else
+    {
+    this->ReleaseUserArray(this->Array);
+    }
   this->Array = NULL;
   this->Size = 0;
   this->MaxId = -1;
@@ -151,6 +167,10 @@ void vtkBitArray::DeepCopy(vtkDataArray *ia)
       {
       delete [] this->Array;
       }
+    else
+      {
+      this->ReleaseUserArray(this->Array);
+      }
 
     this->NumberOfComponents = ia->GetNumberOfComponents();
     this->MaxId = ia->GetMaxId();
@@ -220,6 +240,10 @@ unsigned char *vtkBitArray::ResizeAndExtend(vtkIdType sz)
       {
         delete[] this->Array;
       }
+    else
+      {
+      this->ReleaseUserArray(this->Array);
+      }
     }
 
   if (newSize < this->Size)
@@ -265,6 +289,10 @@ int vtkBitArray::Resize(vtkIdType sz)
       {
         delete[] this->Array;
       }
+    else
+      {
+      this->ReleaseUserArray(this->Array);
+      }
     }
 
   if (newSize < this->Size)
@@ -58,6 +58,9 @@ vtkDataArray::vtkDataArray(vtkIdType numComp)
 
   this->NumberOfComponents = (numComp < 1 ? 1 : numComp);
   this->Name = 0;
+
+  this->UserArrayReleaseFunction = 0;
+  this->UserArrayReleaseClientData = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -70,6 +73,27 @@ vtkDataArray::~vtkDataArray()
   this->SetName(0);
 }
 
+//----------------------------------------------------------------------------
+void vtkDataArray::SetUserArrayReleaseFunction(UserArrayReleaseFunctionType f,
+                                               void* clientData)
+{
+  this->UserArrayReleaseFunction = f;
+  this->UserArrayReleaseClientData = clientData;
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArray::ReleaseUserArray(void* array)
+{
+  UserArrayReleaseFunctionType f = this->UserArrayReleaseFunction;
+  void* clientData = this->UserArrayReleaseClientData;
+  this->UserArrayReleaseFunction = 0;
+  this->UserArrayReleaseClientData = 0;
+  if(f && array)
+    {
+    f(array, clientData);
+    }
+}
+
 //----------------------------------------------------------------------------
 template <class IT, class OT>
 void vtkDeepCopyArrayOfDifferentType(IT *input, OT *output,
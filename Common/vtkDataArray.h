@@ -280,6 +280,21 @@ public:
                             vtkIdType vtkNotUsed(size),
                             int vtkNotUsed(save)) {};
 
+  //BTX
+  // Description:
+  // Set a function to call when the array given to SetVoidArray with
+  // save set to 1 is no longer used by this array, because it is
+  // replaced, reallocated, released or the array is destroyed.  The
+  // function is called once, with the user array and clientData, and
+  // is then forgotten.  This lets the owner of memory that is not
+  // allocated with new or malloc, such as a memory mapped file, release
+  // it when the array is done with it.  Set it after SetVoidArray.
+  typedef void (*UserArrayReleaseFunctionType)(void* array,
+                                               void* clientData);
+  void SetUserArrayReleaseFunction(UserArrayReleaseFunctionType f,
+                                   void* clientData);
+  //ETX
+
   // Description:
   // This method copies the array data to the void pointer specified
   // by the user.  It is up to the user to allocate enough memory for
@@ -390,6 +405,15 @@ protected:
   vtkTimeStamp 
      ComponentRangeComputeTime[VTK_MAXIMUM_NUMBER_OF_CACHED_COMPONENT_RANGES];
   double ComponentRange[VTK_MAXIMUM_NUMBER_OF_CACHED_COMPONENT_RANGES][2];
+
+  // Called by subclasses when they stop using a user array given with
+  // save set to 1.
+  void ReleaseUserArray(void* array);
+
+  //BTX
+  UserArrayReleaseFunctionType UserArrayReleaseFunction;
+  void* UserArrayReleaseClientData;
+  //ETX
   
 private:
   double* GetTupleN(vtkIdType i, int n);
@@ -44,6 +44,10 @@ vtkDataArrayTemplate<T>::~vtkDataArrayTemplate()
     {
     free(this->Array);
     }
+  else
+    {
+    this->ReleaseUserArray(this->Array);
+    }
   if(this->Tuple)
     {
     free(this->Tuple);
@@ -68,6 +72,10 @@ void vtkDataArrayTemplate<T>::SetArray(T* array, vtkIdType size, int save)
   else
     {
     vtkDebugMacro (<<"Warning, array not deleted, but will point to new array.");
+    if(array != this->Array)
+      {
+      this->ReleaseUserArray(this->Array);
+      }
     }
 
   vtkDebugMacro(<<"Setting array to: " << static_cast<void*>(array));
@@ -91,6 +99,10 @@ int vtkDataArrayTemplate<T>::Allocate(vtkIdType sz, vtkIdType)
       {
       free(this->Array);
       }
+    else
+      {
+      this->ReleaseUserArray(this->Array);
+      }
 
     this->Array = 0;
     this->Size = 0;
@@ -120,6 +132,10 @@ void vtkDataArrayTemplate<T>::Initialize()
     {
     free(this->Array);
     }
+  else
+    {
+    this->ReleaseUserArray(this->Array);
+    }
   this->Array = 0;
   this->Size = 0;
   this->MaxId = -1;
@@ -155,6 +171,10 @@ void vtkDataArrayTemplate<T>::DeepCopy(vtkDataArray* fa)
     {
     free(this->Array);
     }
+  else
+    {
+    this->ReleaseUserArray(this->Array);
+    }
 
   // Copy the given array into new memory.
   this->NumberOfComponents = fa->GetNumberOfComponents();
@@ -242,6 +262,7 @@ T* vtkDataArrayTemplate<T>::ResizeAndExtend(vtkIdType sz)
     // Copy the data from the old array.
     memcpy(newArray, this->Array,
            (newSize < this->Size ? newSize : this->Size) * sizeof(T));
+    this->ReleaseUserArray(this->Array);
     }
   else
     {
@@ -17,6 +17,7 @@
 #include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkSmartPointerBase.h"
+#include "vtkTimerLog.h"
 
 #include <vtkstd/queue>
 #include <vtkstd/stack>
@@ -172,6 +173,9 @@ public:
   void DeferredCollectionPush();
   void DeferredCollectionPop();
 
+  // Turn batched collection on or off.
+  void SetBatchedCollection(int batched);
+
   // Map from object to number of stored references.
 #if VTK_GARBAGE_COLLECTOR_HASH
   typedef vtksys::hash_map<vtkObjectBase*, int, vtkGarbageCollectorHash>
@@ -187,6 +191,17 @@ public:
   // The number of times DeferredCollectionPush has been called not
   // matched by a DeferredCollectionPop.
   int DeferredCollectionCount;
+
+  // Whether checks are deferred until the application collects.
+  int BatchedCollection;
+
+  // Collection statistics, and the number of walks in progress so
+  // that nested walks are not timed twice.
+  unsigned long NumberOfCollections;
+  unsigned long NumberOfVisitedObjects;
+  unsigned long NumberOfCollectedObjects;
+  double CollectionTime;
+  int CollectionDepth;
 };
 
 //----------------------------------------------------------------------------
@@ -207,7 +222,8 @@ public:
   // Prevent normal vtkObject reference counting behavior.
   virtual void UnRegister(vtkObjectBase*);
 
-  // Perform a collection check.
+  // Perform a collection check from the given root, or from all the
+  // objects whose check was deferred if it is null.
   void CollectInternal(vtkObjectBase* root);
 
 
@@ -340,6 +356,9 @@ public:
   // Count for visit order of Tarjan's algorithm.
   int VisitCount;
 
+  // The number of objects deleted.
+  unsigned long NumberOfCollectedObjects;
+
   // The singleton instance from which to take references when passing
   // references to the entries.
   vtkGarbageCollectorSingleton* Singleton;
@@ -410,6 +429,7 @@ vtkGarbageCollectorImpl::vtkGarbageCollectorImpl()
   this->VisitCount = 0;
   this->Current = 0;
   this->NumberOfComponents = 0;
+  this->NumberOfCollectedObjects = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -503,6 +523,25 @@ void vtkGarbageCollectorImpl::FindComponents(vtkObjectBase* root)
     {
     this->MaybeVisit(root);
     }
+  else if(this->Singleton)
+    {
+    // Walk from all the deferred objects.  Visiting an object takes its
+    // references from the singleton, and the singleton keeps the
+    // others alive until they are visited.  Checks deferred during the
+    // walk are left for the next one.
+    vtkstd::vector<vtkObjectBase*> roots;
+    roots.reserve(this->Singleton->References.size());
+    for(ReferencesType::iterator i = this->Singleton->References.begin();
+        i != this->Singleton->References.end(); ++i)
+      {
+      roots.push_back(i->first);
+      }
+    for(vtkstd::vector<vtkObjectBase*>::iterator r = roots.begin();
+        r != roots.end(); ++r)
+      {
+      this->MaybeVisit(*r);
+      }
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -700,6 +739,7 @@ void vtkGarbageCollectorImpl::CollectComponent(ComponentType* c)
     assert((*e)->Object->GetReferenceCount() == 1);
     vtkGarbageCollectorToObjectBaseFriendship::UnRegister((*e)->Object, this);
     }
+  this->NumberOfCollectedObjects += static_cast<unsigned long>(c->size());
 }
 
 //----------------------------------------------------------------------------
@@ -863,7 +903,12 @@ void vtkGarbageCollector::ClassFinalize()
   // objects, they just will not have the option of deferred
   // collection.  In order to get it they need only to include
   // vtkGarbageCollectorManager.h so that this singleton stays around
-  // longer.
+  // longer.  Checks left by batched collection are done first.
+  if(vtkGarbageCollectorSingletonInstance->BatchedCollection)
+    {
+    vtkGarbageCollectorSingletonInstance->BatchedCollection = 0;
+    vtkGarbageCollector::Collect();
+    }
   delete vtkGarbageCollectorSingletonInstance;
   vtkGarbageCollectorSingletonInstance = 0;
 }
@@ -874,13 +919,73 @@ void vtkGarbageCollector::Report(vtkObjectBase*, void*, const char*)
   vtkErrorMacro("vtkGarbageCollector::Report should be overridden.");
 }
 
+//----------------------------------------------------------------------------
+// Do one collection check from the given root, or from all deferred
+// objects if it is null, and record its statistics in the main thread.
+static void vtkGarbageCollectorCollectWalk(vtkObjectBase* root)
+{
+  vtkGarbageCollectorSingleton* singleton = 0;
+  if(vtkGarbageCollectorIsMainThread())
+    {
+    singleton = vtkGarbageCollectorSingletonInstance;
+    }
+  double startTime = 0;
+  if(singleton && singleton->CollectionDepth++ == 0)
+    {
+    startTime = vtkTimerLog::GetUniversalTime();
+    }
+
+  unsigned long visited;
+  unsigned long collected;
+  {
+  // Create a collector instance.
+  vtkGarbageCollectorImpl collector;
+
+  vtkDebugWithObjectMacro((&collector), "Starting collection check.");
+
+  // Collect leaked objects.
+  collector.CollectInternal(root);
+
+  vtkDebugWithObjectMacro((&collector), "Finished collection check.");
+
+  visited = static_cast<unsigned long>(collector.Visited.size());
+  collected = collector.NumberOfCollectedObjects;
+  }
+
+  if(singleton)
+    {
+    ++singleton->NumberOfCollections;
+    singleton->NumberOfVisitedObjects += visited;
+    singleton->NumberOfCollectedObjects += collected;
+    if(--singleton->CollectionDepth == 0)
+      {
+      singleton->CollectionTime += vtkTimerLog::GetUniversalTime() - startTime;
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkGarbageCollector::Collect()
 {
   // This must be called only from the main thread.
   assert(vtkGarbageCollectorIsMainThread());
 
-  // Keep collecting until no deferred checks exist.
+  // Keep collecting until no deferred checks exist.  Each check walks
+  // from all the objects deferred when it starts.
+  while(vtkGarbageCollectorSingletonInstance &&
+        vtkGarbageCollectorSingletonInstance->TotalNumberOfReferences > 0)
+    {
+    vtkGarbageCollectorCollectWalk(0);
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkGarbageCollector::CollectIncrementally(double maximumTime)
+{
+  // This must be called only from the main thread.
+  assert(vtkGarbageCollectorIsMainThread());
+
+  double startTime = vtkTimerLog::GetUniversalTime();
   while(vtkGarbageCollectorSingletonInstance &&
         vtkGarbageCollectorSingletonInstance->TotalNumberOfReferences > 0)
     {
@@ -889,22 +994,86 @@ void vtkGarbageCollector::Collect()
     // other objects from the singleton's references.
     vtkObjectBase* root =
       vtkGarbageCollectorSingletonInstance->References.begin()->first;
-    vtkGarbageCollector::Collect(root);
+    vtkGarbageCollectorCollectWalk(root);
+    if(vtkTimerLog::GetUniversalTime() - startTime >= maximumTime)
+      {
+      break;
+      }
     }
+  return vtkGarbageCollector::GetNumberOfDeferredChecks();
 }
 
 //----------------------------------------------------------------------------
 void vtkGarbageCollector::Collect(vtkObjectBase* root)
 {
-  // Create a collector instance.
-  vtkGarbageCollectorImpl collector;
+  vtkGarbageCollectorCollectWalk(root);
+}
 
-  vtkDebugWithObjectMacro((&collector), "Starting collection check.");
+//----------------------------------------------------------------------------
+void vtkGarbageCollector::SetBatchedCollection(int batched)
+{
+  // This must be called only from the main thread.
+  assert(vtkGarbageCollectorIsMainThread());
 
-  // Collect leaked objects.
-  collector.CollectInternal(root);
+  // Forward the call to the singleton.
+  if(vtkGarbageCollectorSingletonInstance)
+    {
+    vtkGarbageCollectorSingletonInstance->SetBatchedCollection(batched);
+    }
+}
 
-  vtkDebugWithObjectMacro((&collector), "Finished collection check.");
+//----------------------------------------------------------------------------
+int vtkGarbageCollector::GetBatchedCollection()
+{
+  return (vtkGarbageCollectorSingletonInstance?
+          vtkGarbageCollectorSingletonInstance->BatchedCollection : 0);
+}
+
+//----------------------------------------------------------------------------
+int vtkGarbageCollector::GetNumberOfDeferredChecks()
+{
+  return (vtkGarbageCollectorSingletonInstance?
+          vtkGarbageCollectorSingletonInstance->TotalNumberOfReferences : 0);
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkGarbageCollector::GetNumberOfCollections()
+{
+  return (vtkGarbageCollectorSingletonInstance?
+          vtkGarbageCollectorSingletonInstance->NumberOfCollections : 0);
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkGarbageCollector::GetNumberOfVisitedObjects()
+{
+  return (vtkGarbageCollectorSingletonInstance?
+          vtkGarbageCollectorSingletonInstance->NumberOfVisitedObjects : 0);
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkGarbageCollector::GetNumberOfCollectedObjects()
+{
+  return (vtkGarbageCollectorSingletonInstance?
+          vtkGarbageCollectorSingletonInstance->NumberOfCollectedObjects : 0);
+}
+
+//----------------------------------------------------------------------------
+double vtkGarbageCollector::GetCollectionTime()
+{
+  return (vtkGarbageCollectorSingletonInstance?
+          vtkGarbageCollectorSingletonInstance->CollectionTime : 0);
+}
+
+//----------------------------------------------------------------------------
+void vtkGarbageCollector::ResetStatistics()
+{
+  if(vtkGarbageCollectorSingletonInstance)
+    {
+    vtkGarbageCollectorSingletonInstance->NumberOfCollections = 0;
+    vtkGarbageCollectorSingletonInstance->NumberOfVisitedObjects = 0;
+    vtkGarbageCollectorSingletonInstance->NumberOfCollectedObjects = 0;
+    vtkGarbageCollectorSingletonInstance->CollectionTime = 0;
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -972,6 +1141,12 @@ vtkGarbageCollectorSingleton::vtkGarbageCollectorSingleton()
 {
   this->TotalNumberOfReferences = 0;
   this->DeferredCollectionCount = 0;
+  this->BatchedCollection = 0;
+  this->NumberOfCollections = 0;
+  this->NumberOfVisitedObjects = 0;
+  this->NumberOfCollectedObjects = 0;
+  this->CollectionTime = 0;
+  this->CollectionDepth = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -1038,13 +1213,15 @@ int vtkGarbageCollectorSingleton::CheckAccept()
   // construction.  We do not want to perform deferred collection
   // while an object is under construction because the reference walk
   // might call ReportReferences on a partially constructed object!
-  return this->DeferredCollectionCount > 0;
+  // Batched collection is safe because it collects only when the
+  // application asks.
+  return this->DeferredCollectionCount > 0 || this->BatchedCollection;
 }
 
 //----------------------------------------------------------------------------
 void vtkGarbageCollectorSingleton::DeferredCollectionPush()
 {
-  if(++this->DeferredCollectionCount <= 0)
+  if(++this->DeferredCollectionCount <= 0 && !this->BatchedCollection)
     {
     // Deferred collection is disabled.  Collect immediately.
     vtkGarbageCollector::Collect();
@@ -1054,7 +1231,19 @@ void vtkGarbageCollectorSingleton::DeferredCollectionPush()
 //----------------------------------------------------------------------------
 void vtkGarbageCollectorSingleton::DeferredCollectionPop()
 {
-  if(--this->DeferredCollectionCount <= 0)
+  if(--this->DeferredCollectionCount <= 0 && !this->BatchedCollection)
+    {
+    // Deferred collection is disabled.  Collect immediately.
+    vtkGarbageCollector::Collect();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkGarbageCollectorSingleton::SetBatchedCollection(int batched)
+{
+  int wasBatched = this->BatchedCollection;
+  this->BatchedCollection = batched? 1 : 0;
+  if(wasBatched && !batched && this->DeferredCollectionCount <= 0)
     {
     // Deferred collection is disabled.  Collect immediately.
     vtkGarbageCollector::Collect();
@@ -104,9 +104,20 @@ public:
   // are held by objects in the original component.  These removed
   // references are handled as any other and their corresponding
   // checks may be deferred.  This method keeps collecting until no
-  // deferred collection checks remain.
+  // deferred collection checks remain.  All the objects deferred when
+  // it is called are walked together, so that each object reachable
+  // from several of them is visited once.
   static void Collect();
 
+  // Description:
+  // Collect using the objects whose collection was deferred, one
+  // reference graph walk at a time, until none remain or maximumTime
+  // seconds have passed.  At least one walk is done if any check is
+  // deferred.  A walk is never interrupted, so it may take longer than
+  // maximumTime when the objects reachable from one deferred object
+  // are many.  Returns the number of deferred checks left.
+  static int CollectIncrementally(double maximumTime);
+
   // Description:
   // Collect immediately using the given object as the root for a
   // reference graph walk.  Strongly connected components in the
@@ -127,6 +138,32 @@ public:
   static void DeferredCollectionPush();
   static void DeferredCollectionPop();
 
+  // Description:
+  // Set/Get whether collection is batched.  When on, the checks of
+  // objects that may be in reference loops are deferred as if
+  // DeferredCollectionPush() had been called, and they are done only
+  // when the application calls Collect() or CollectIncrementally(),
+  // for example while it is idle.  Objects are deleted as they would
+  // be otherwise, but only then.  Turning it off collects immediately
+  // unless collection is still deferred.  It is off by default.
+  static void SetBatchedCollection(int batched);
+  static int GetBatchedCollection();
+
+  // Description:
+  // Get the number of deferred collection checks waiting.
+  static int GetNumberOfDeferredChecks();
+
+  // Description:
+  // Statistics of the collections done in the main thread since the
+  // program started or ResetStatistics() was called: the number of
+  // reference graph walks, the number of objects they visited and
+  // deleted, and the total time they took in seconds.
+  static unsigned long GetNumberOfCollections();
+  static unsigned long GetNumberOfVisitedObjects();
+  static unsigned long GetNumberOfCollectedObjects();
+  static double GetCollectionTime();
+  static void ResetStatistics();
+
   // Description:
   // Set/Get global garbage collection debugging flag.  When set to 1,
   // all garbage collection checks will produce debugging information.
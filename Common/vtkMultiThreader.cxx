@@ -16,6 +16,7 @@
 
 #include "vtkMutexLock.h"
 #include "vtkObjectFactory.h"
+#include "vtkTaskScheduler.h"
 #include "vtkWindows.h"
 
 vtkCxxRevisionMacro(vtkMultiThreader, "1.50.12.1");
@@ -143,6 +144,20 @@ int vtkMultiThreader::GetGlobalDefaultNumberOfThreads()
   return vtkMultiThreaderGlobalDefaultNumberOfThreads;
 }
 
+// Initialize static member that controls whether new threaders run
+// SingleMethodExecute on the global task scheduler.
+static int vtkMultiThreaderGlobalDefaultUseTaskScheduler = 0;
+
+void vtkMultiThreader::SetGlobalDefaultUseTaskScheduler(int val)
+{
+  vtkMultiThreaderGlobalDefaultUseTaskScheduler = val;
+}
+
+int vtkMultiThreader::GetGlobalDefaultUseTaskScheduler()
+{
+  return vtkMultiThreaderGlobalDefaultUseTaskScheduler;
+}
+
 // Constructor. Default all the methods to NULL. Since the
 // ThreadInfoArray is static, the ThreadIDs can be initialized here
 // and will not change.
@@ -164,7 +179,8 @@ vtkMultiThreader::vtkMultiThreader()
   this->SingleMethod = NULL;
   this->NumberOfThreads = 
     vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
-
+  this->UseTaskScheduler =
+    vtkMultiThreader::GetGlobalDefaultUseTaskScheduler();
 }
 
 // Destructor. Nothing allocated so nothing needs to be done here.
@@ -213,6 +229,25 @@ void vtkMultiThreader::SetMultipleMethod( int index,
     }
 }
 
+// The data passed to the task scheduler by SingleMethodExecute.
+struct vtkMultiThreaderTaskData
+{
+  vtkThreadFunctionType Method;
+  vtkMultiThreader::ThreadInfo *ThreadInfoArray;
+};
+
+// Run the single method for the thread ids in [begin, end).
+static void vtkMultiThreaderExecuteTask(void *data, vtkIdType begin,
+                                        vtkIdType end)
+{
+  vtkMultiThreaderTaskData *taskData =
+    static_cast<vtkMultiThreaderTaskData *>(data);
+  for (vtkIdType i = begin; i < end; ++i)
+    {
+    taskData->Method((void *)(&taskData->ThreadInfoArray[i]));
+    }
+}
+
 // Execute the method set as the SingleMethod on NumberOfThreads threads.
 void vtkMultiThreader::SingleMethodExecute()
 {
@@ -244,7 +279,24 @@ void vtkMultiThreader::SingleMethodExecute()
     {
     this->NumberOfThreads = vtkMultiThreaderGlobalMaximumNumberOfThreads;
     }
-  
+
+  // Run the invocations as tasks on the persistent threads of the
+  // global scheduler.  The scheduler runs the range starting at 0 on
+  // this thread, as the code below does.
+  if (this->UseTaskScheduler && this->NumberOfThreads > 1)
+    {
+    for (thread_loop = 0; thread_loop < this->NumberOfThreads; thread_loop++)
+      {
+      this->ThreadInfoArray[thread_loop].UserData        = this->SingleData;
+      this->ThreadInfoArray[thread_loop].NumberOfThreads = this->NumberOfThreads;
+      }
+    vtkMultiThreaderTaskData taskData;
+    taskData.Method = this->SingleMethod;
+    taskData.ThreadInfoArray = this->ThreadInfoArray;
+    vtkTaskScheduler::GetGlobalScheduler()->ParallelFor(
+      0, this->NumberOfThreads, 1, vtkMultiThreaderExecuteTask, &taskData);
+    return;
+    }
     
   // We are using sproc (on SGIs), pthreads(on Suns), or a single thread
   // (the default)  
@@ -769,6 +821,8 @@ void vtkMultiThreader::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent); 
 
   os << indent << "Thread Count: " << this->NumberOfThreads << "\n";
+  os << indent << "Use Task Scheduler: "
+     << (this->UseTaskScheduler ? "On\n" : "Off\n");
   os << indent << "Global Maximum Number Of Threads: " << 
     vtkMultiThreaderGlobalMaximumNumberOfThreads << endl;
   os << "Thread system used: " <<
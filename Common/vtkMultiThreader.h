@@ -18,6 +18,15 @@
 // execution using sproc() on an SGI, or pthread_create on any platform
 // supporting POSIX threads.  This class can be used to execute a single
 // method on multiple threads, or to specify a method per thread. 
+//
+// When UseTaskScheduler is on, SingleMethodExecute() does not create
+// threads but runs the NumberOfThreads invocations of the single method
+// as tasks of the global vtkTaskScheduler, whose threads persist between
+// calls.  The invocations then may share threads, so they must not wait
+// for each other.  The invocation with ThreadID 0 always runs on the
+// calling thread.
+// .SECTION See Also
+// vtkTaskScheduler
 
 #ifndef __vtkMultiThreader_h
 #define __vtkMultiThreader_h
@@ -138,6 +147,20 @@ public:
   static void SetGlobalDefaultNumberOfThreads(int val);
   static int  GetGlobalDefaultNumberOfThreads();
 
+  // Description:
+  // Set/Get whether SingleMethodExecute() runs on the persistent threads
+  // of the global vtkTaskScheduler instead of creating new threads.
+  // MultipleMethodExecute() and SpawnThread() always create threads.
+  vtkSetMacro(UseTaskScheduler, int);
+  vtkGetMacro(UseTaskScheduler, int);
+  vtkBooleanMacro(UseTaskScheduler, int);
+
+  // Description:
+  // Set/Get the value which is used to initialize UseTaskScheduler in the
+  // constructor.  Initially this default is off.
+  static void SetGlobalDefaultUseTaskScheduler(int val);
+  static int  GetGlobalDefaultUseTaskScheduler();
+
   // These methods are excluded from Tcl wrapping 1) because the
   // wrapper gives up on them and 2) because they really shouldn't be
   // called from a script anyway.
@@ -193,6 +216,9 @@ protected:
   // The number of threads to use
   int                        NumberOfThreads;
 
+  // Whether SingleMethodExecute uses the global vtkTaskScheduler
+  int                        UseTaskScheduler;
+
   // An array of thread info containing a thread id
   // (0, 1, 2, .. VTK_MAX_THREADS-1), the thread count, and a pointer
   // to void so that user data can be passed to each thread
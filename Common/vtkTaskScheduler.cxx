@@ -0,0 +1,636 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkTaskScheduler.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkTaskScheduler.h"
+
+#include "vtkCriticalSection.h"
+#include "vtkMultiThreader.h"
+#include "vtkObjectFactory.h"
+
+#include <vtkstd/deque>
+#include <vtkstd/vector>
+
+#if defined(VTK_USE_PTHREADS)
+# include <pthread.h>
+# define VTK_TASK_SCHEDULER_THREADS
+#elif defined(VTK_USE_WIN32_THREADS)
+# include "vtkWindows.h"
+# define VTK_TASK_SCHEDULER_THREADS
+#endif
+
+vtkCxxRevisionMacro(vtkTaskScheduler, "1.1");
+vtkStandardNewMacro(vtkTaskScheduler);
+
+vtkTaskScheduler *vtkTaskScheduler::GlobalScheduler = 0;
+vtkTaskSchedulerCleanup vtkTaskScheduler::Cleanup;
+
+//----------------------------------------------------------------------------
+vtkTaskSchedulerCleanup::vtkTaskSchedulerCleanup()
+{
+}
+
+//----------------------------------------------------------------------------
+vtkTaskSchedulerCleanup::~vtkTaskSchedulerCleanup()
+{
+  // Destroy any remaining scheduler and join its threads.
+  vtkTaskScheduler::SetGlobalScheduler(0);
+}
+
+//----------------------------------------------------------------------------
+// A set of ranges submitted by one call to ParallelFor.  Pending counts
+// the ranges of the group that are queued or running.
+struct vtkTaskSchedulerGroup
+{
+  vtkTaskFunctionType Function;
+  void *Data;
+  vtkIdType Grain;
+  vtkIdType Pending;
+};
+
+struct vtkTaskSchedulerTask
+{
+  vtkTaskSchedulerGroup *Group;
+  vtkIdType Begin;
+  vtkIdType End;
+};
+
+// The queue of one thread.  The owner pushes and pops at the back, other
+// threads steal from the front where the largest ranges are.
+struct vtkTaskSchedulerQueue
+{
+  vtkSimpleCriticalSection Lock;
+  vtkstd::deque<vtkTaskSchedulerTask> Tasks;
+};
+
+#if defined(VTK_USE_PTHREADS)
+extern "C" { typedef void *(*vtkTaskSchedulerThreadFunctionType)(void *); }
+#endif
+
+//----------------------------------------------------------------------------
+class vtkTaskSchedulerInternals
+{
+public:
+  vtkTaskSchedulerInternals(vtkTaskScheduler *self);
+  ~vtkTaskSchedulerInternals();
+
+  // Queue 0 is shared by all threads that are not workers of this
+  // scheduler.  Worker i owns queue i.
+  int GetCurrentQueue();
+  void SetCurrentQueue(int queue);
+
+  void Push(int queue, const vtkTaskSchedulerTask& task);
+  int Pop(int queue, vtkTaskSchedulerTask& task);
+  void Execute(int queue, vtkTaskSchedulerTask task);
+  void Finish(vtkTaskSchedulerGroup *group);
+
+  void WorkerLoop(int queue);
+
+  // Synchronization of the sleeping threads.  All counters below are
+  // protected by this lock.
+  void Lock();
+  void Unlock();
+  void Wait();
+  void Signal();
+  void Broadcast();
+
+  vtkTaskScheduler *Self;
+  vtkstd::vector<vtkTaskSchedulerQueue*> Queues;
+  vtkIdType QueuedTasks;
+  int Running;
+  int Exit;
+
+  vtkIdType TasksExecuted;
+  vtkIdType TasksStolen;
+
+#if defined(VTK_USE_PTHREADS)
+  pthread_mutex_t Mutex;
+  pthread_cond_t Wake;
+  pthread_key_t QueueKey;
+  vtkstd::vector<pthread_t> Threads;
+#elif defined(VTK_USE_WIN32_THREADS)
+  CRITICAL_SECTION Mutex;
+  HANDLE Wake;
+  int Sleepers;
+  DWORD QueueKey;
+  vtkstd::vector<HANDLE> Threads;
+#endif
+};
+
+//----------------------------------------------------------------------------
+struct vtkTaskSchedulerWorkerInfo
+{
+  vtkTaskSchedulerInternals *Internals;
+  int Queue;
+};
+
+#ifdef VTK_TASK_SCHEDULER_THREADS
+# if defined(VTK_USE_PTHREADS)
+static void *vtkTaskSchedulerWorker(void *arg)
+# else
+static DWORD WINAPI vtkTaskSchedulerWorker(LPVOID arg)
+# endif
+{
+  vtkTaskSchedulerWorkerInfo *info =
+    static_cast<vtkTaskSchedulerWorkerInfo *>(arg);
+  vtkTaskSchedulerInternals *internals = info->Internals;
+  int queue = info->Queue;
+  delete info;
+  internals->WorkerLoop(queue);
+  return 0;
+}
+#endif
+
+//----------------------------------------------------------------------------
+vtkTaskSchedulerInternals::vtkTaskSchedulerInternals(vtkTaskScheduler *self)
+{
+  this->Self = self;
+  this->QueuedTasks = 0;
+  this->Running = 0;
+  this->Exit = 0;
+  this->TasksExecuted = 0;
+  this->TasksStolen = 0;
+#if defined(VTK_USE_PTHREADS)
+  pthread_mutex_init(&this->Mutex, 0);
+  pthread_cond_init(&this->Wake, 0);
+  pthread_key_create(&this->QueueKey, 0);
+#elif defined(VTK_USE_WIN32_THREADS)
+  InitializeCriticalSection(&this->Mutex);
+  this->Wake = CreateSemaphore(0, 0, 0x7fffffff, 0);
+  this->Sleepers = 0;
+  this->QueueKey = TlsAlloc();
+#endif
+}
+
+//----------------------------------------------------------------------------
+vtkTaskSchedulerInternals::~vtkTaskSchedulerInternals()
+{
+  for (unsigned int i = 0; i < this->Queues.size(); ++i)
+    {
+    delete this->Queues[i];
+    }
+#if defined(VTK_USE_PTHREADS)
+  pthread_key_delete(this->QueueKey);
+  pthread_cond_destroy(&this->Wake);
+  pthread_mutex_destroy(&this->Mutex);
+#elif defined(VTK_USE_WIN32_THREADS)
+  TlsFree(this->QueueKey);
+  CloseHandle(this->Wake);
+  DeleteCriticalSection(&this->Mutex);
+#endif
+}
+
+//----------------------------------------------------------------------------
+int vtkTaskSchedulerInternals::GetCurrentQueue()
+{
+  // The key stores the queue index plus one so that threads that never
+  // set it map to the shared queue 0.
+  void *value = 0;
+#if defined(VTK_USE_PTHREADS)
+  value = pthread_getspecific(this->QueueKey);
+#elif defined(VTK_USE_WIN32_THREADS)
+  value = TlsGetValue(this->QueueKey);
+#endif
+  return value ? static_cast<int>(reinterpret_cast<size_t>(value)) - 1 : 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkTaskSchedulerInternals::SetCurrentQueue(int queue)
+{
+  void *value = reinterpret_cast<void *>(static_cast<size_t>(queue + 1));
+#if defined(VTK_USE_PTHREADS)
+  pthread_setspecific(this->QueueKey, value);
+#elif defined(VTK_USE_WIN32_THREADS)
+  TlsSetValue(this->QueueKey, value);
+#else
+  (void)value;
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkTaskSchedulerInternals::Lock()
+{
+#if defined(VTK_USE_PTHREADS)
+  pthread_mutex_lock(&this->Mutex);
+#elif defined(VTK_USE_WIN32_THREADS)
+  EnterCriticalSection(&this->Mutex);
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkTaskSchedulerInternals::Unlock()
+{
+#if defined(VTK_USE_PTHREADS)
+  pthread_mutex_unlock(&this->Mutex);
+#elif defined(VTK_USE_WIN32_THREADS)
+  LeaveCriticalSection(&this->Mutex);
+#endif
+}
+
+//----------------------------------------------------------------------------
+// Must be called with the lock held.  The lock is held again on return.
+void vtkTaskSchedulerInternals::Wait()
+{
+#if defined(VTK_USE_PTHREADS)
+  pthread_cond_wait(&this->Wake, &this->Mutex);
+#elif defined(VTK_USE_WIN32_THREADS)
+  // The semaphore counts wake-ups, so a release that happens between
+  // leaving the critical section and waiting is not lost.
+  ++this->Sleepers;
+  LeaveCriticalSection(&this->Mutex);
+  WaitForSingleObject(this->Wake, INFINITE);
+  EnterCriticalSection(&this->Mutex);
+#endif
+}
+
+//----------------------------------------------------------------------------
+// Must be called with the lock held.
+void vtkTaskSchedulerInternals::Signal()
+{
+#if defined(VTK_USE_PTHREADS)
+  pthread_cond_signal(&this->Wake);
+#elif defined(VTK_USE_WIN32_THREADS)
+  if (this->Sleepers > 0)
+    {
+    --this->Sleepers;
+    ReleaseSemaphore(this->Wake, 1, 0);
+    }
+#endif
+}
+
+//----------------------------------------------------------------------------
+// Must be called with the lock held.
+void vtkTaskSchedulerInternals::Broadcast()
+{
+#if defined(VTK_USE_PTHREADS)
+  pthread_cond_broadcast(&this->Wake);
+#elif defined(VTK_USE_WIN32_THREADS)
+  if (this->Sleepers > 0)
+    {
+    ReleaseSemaphore(this->Wake, this->Sleepers, 0);
+    this->Sleepers = 0;
+    }
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkTaskSchedulerInternals::Push(int queue,
+                                     const vtkTaskSchedulerTask& task)
+{
+  // Count the task before it becomes visible so that a thread that
+  // takes and finishes it cannot complete the group early.
+  vtkTaskSchedulerQueue *q = this->Queues[queue];
+  this->Lock();
+  ++task.Group->Pending;
+  ++this->QueuedTasks;
+  q->Lock.Lock();
+  q->Tasks.push_back(task);
+  q->Lock.Unlock();
+  this->Signal();
+  this->Unlock();
+}
+
+//----------------------------------------------------------------------------
+// Take a task from the given queue, or steal one from another queue.
+int vtkTaskSchedulerInternals::Pop(int queue, vtkTaskSchedulerTask& task)
+{
+  int numQueues = static_cast<int>(this->Queues.size());
+  int found = 0;
+  int stolen = 0;
+  vtkTaskSchedulerQueue *q = this->Queues[queue];
+  q->Lock.Lock();
+  if (!q->Tasks.empty())
+    {
+    task = q->Tasks.back();
+    q->Tasks.pop_back();
+    found = 1;
+    }
+  q->Lock.Unlock();
+
+  for (int i = 1; !found && i < numQueues; ++i)
+    {
+    q = this->Queues[(queue + i) % numQueues];
+    q->Lock.Lock();
+    if (!q->Tasks.empty())
+      {
+      task = q->Tasks.front();
+      q->Tasks.pop_front();
+      found = stolen = 1;
+      }
+    q->Lock.Unlock();
+    }
+
+  if (found)
+    {
+    this->Lock();
+    --this->QueuedTasks;
+    this->TasksStolen += stolen;
+    this->Unlock();
+    }
+  return found;
+}
+
+//----------------------------------------------------------------------------
+void vtkTaskSchedulerInternals::Execute(int queue, vtkTaskSchedulerTask task)
+{
+  vtkTaskSchedulerGroup *group = task.Group;
+
+  // Keep the lower half and offer the upper half to other threads
+  // until the range is small enough.
+  while (task.End - task.Begin > group->Grain)
+    {
+    vtkTaskSchedulerTask upper = task;
+    upper.Begin = task.Begin + (task.End - task.Begin) / 2;
+    task.End = upper.Begin;
+    this->Push(queue, upper);
+    }
+
+  group->Function(group->Data, task.Begin, task.End);
+  this->Finish(group);
+}
+
+//----------------------------------------------------------------------------
+void vtkTaskSchedulerInternals::Finish(vtkTaskSchedulerGroup *group)
+{
+  this->Lock();
+  ++this->TasksExecuted;
+  if (--group->Pending == 0)
+    {
+    this->Broadcast();
+    }
+  this->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkTaskSchedulerInternals::WorkerLoop(int queue)
+{
+  this->SetCurrentQueue(queue);
+  vtkTaskSchedulerTask task;
+  for (;;)
+    {
+    if (this->Pop(queue, task))
+      {
+      this->Execute(queue, task);
+      continue;
+      }
+    this->Lock();
+    while (!this->Exit && this->QueuedTasks == 0)
+      {
+      this->Wait();
+      }
+    int exitNow = this->Exit;
+    this->Unlock();
+    if (exitNow)
+      {
+      break;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkTaskScheduler::vtkTaskScheduler()
+{
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  this->Internals = new vtkTaskSchedulerInternals(this);
+}
+
+//----------------------------------------------------------------------------
+vtkTaskScheduler::~vtkTaskScheduler()
+{
+  this->StopWorkers();
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+vtkTaskScheduler *vtkTaskScheduler::GetGlobalScheduler()
+{
+  if (!vtkTaskScheduler::GlobalScheduler)
+    {
+    vtkTaskScheduler::GlobalScheduler = vtkTaskScheduler::New();
+    }
+  return vtkTaskScheduler::GlobalScheduler;
+}
+
+//----------------------------------------------------------------------------
+void vtkTaskScheduler::SetGlobalScheduler(vtkTaskScheduler *scheduler)
+{
+  if (vtkTaskScheduler::GlobalScheduler == scheduler)
+    {
+    return;
+    }
+  if (vtkTaskScheduler::GlobalScheduler)
+    {
+    vtkTaskScheduler::GlobalScheduler->Delete();
+    }
+  vtkTaskScheduler::GlobalScheduler = scheduler;
+  if (scheduler)
+    {
+    scheduler->Register(0);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkTaskScheduler::SetNumberOfThreads(int num)
+{
+  num = (num < 1 ? 1 : (num > VTK_MAX_THREADS ? VTK_MAX_THREADS : num));
+  if (num == this->NumberOfThreads)
+    {
+    return;
+    }
+  this->StopWorkers();
+  this->NumberOfThreads = num;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkTaskScheduler::StartWorkers()
+{
+#ifdef VTK_TASK_SCHEDULER_THREADS
+  vtkTaskSchedulerInternals *internals = this->Internals;
+  internals->Lock();
+  if (internals->Running)
+    {
+    internals->Unlock();
+    return;
+    }
+  while (static_cast<int>(internals->Queues.size()) < this->NumberOfThreads)
+    {
+    internals->Queues.push_back(new vtkTaskSchedulerQueue);
+    }
+  internals->Exit = 0;
+  for (int i = 1; i < this->NumberOfThreads; ++i)
+    {
+    vtkTaskSchedulerWorkerInfo *info = new vtkTaskSchedulerWorkerInfo;
+    info->Internals = internals;
+    info->Queue = i;
+# if defined(VTK_USE_PTHREADS)
+    pthread_t thread;
+    int threadError = pthread_create(
+      &thread, 0,
+      reinterpret_cast<vtkTaskSchedulerThreadFunctionType>(
+        vtkTaskSchedulerWorker), info);
+    if (threadError != 0)
+      {
+      delete info;
+      vtkErrorMacro(<< "Unable to create a thread.  pthread_create() returned "
+                    << threadError);
+      continue;
+      }
+    internals->Threads.push_back(thread);
+# else
+    DWORD threadId;
+    HANDLE thread = CreateThread(0, 0, vtkTaskSchedulerWorker, info, 0,
+                                 &threadId);
+    if (thread == NULL)
+      {
+      delete info;
+      vtkErrorMacro("Error in thread creation !!!");
+      continue;
+      }
+    internals->Threads.push_back(thread);
+# endif
+    }
+  internals->Running = 1;
+  internals->Unlock();
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkTaskScheduler::StopWorkers()
+{
+#ifdef VTK_TASK_SCHEDULER_THREADS
+  vtkTaskSchedulerInternals *internals = this->Internals;
+  internals->Lock();
+  if (!internals->Running)
+    {
+    internals->Unlock();
+    return;
+    }
+  internals->Exit = 1;
+  internals->Broadcast();
+  internals->Unlock();
+
+  for (unsigned int i = 0; i < internals->Threads.size(); ++i)
+    {
+# if defined(VTK_USE_PTHREADS)
+    pthread_join(internals->Threads[i], 0);
+# else
+    WaitForSingleObject(internals->Threads[i], INFINITE);
+    CloseHandle(internals->Threads[i]);
+# endif
+    }
+  internals->Threads.clear();
+
+  internals->Lock();
+  internals->Running = 0;
+  internals->Exit = 0;
+  internals->Unlock();
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkTaskScheduler::ParallelFor(vtkIdType begin, vtkIdType end,
+                                   vtkIdType grain,
+                                   vtkTaskFunctionType f, void *data)
+{
+  if (end <= begin || !f)
+    {
+    return;
+    }
+
+  vtkIdType length = end - begin;
+  if (grain <= 0)
+    {
+    grain = length / (8 * this->NumberOfThreads);
+    grain = (grain < 1 ? 1 : grain);
+    }
+
+  vtkTaskSchedulerInternals *internals = this->Internals;
+
+#ifdef VTK_TASK_SCHEDULER_THREADS
+  if (this->NumberOfThreads > 1 && length > grain)
+    {
+    this->StartWorkers();
+
+    vtkTaskSchedulerGroup group;
+    group.Function = f;
+    group.Data = data;
+    group.Grain = grain;
+    group.Pending = 1;
+
+    vtkTaskSchedulerTask task;
+    task.Group = &group;
+    task.Begin = begin;
+    task.End = end;
+
+    // The calling thread executes the first range itself.
+    int queue = internals->GetCurrentQueue();
+    internals->Execute(queue, task);
+
+    // Help with queued work until all ranges of the group are done.
+    for (;;)
+      {
+      internals->Lock();
+      vtkIdType pending = group.Pending;
+      internals->Unlock();
+      if (pending == 0)
+        {
+        break;
+        }
+      if (internals->Pop(queue, task))
+        {
+        internals->Execute(queue, task);
+        continue;
+        }
+      internals->Lock();
+      while (group.Pending != 0 && internals->QueuedTasks == 0)
+        {
+        internals->Wait();
+        }
+      internals->Unlock();
+      }
+    return;
+    }
+#endif
+
+  for (vtkIdType b = begin; b < end; b += grain)
+    {
+    ++internals->TasksExecuted;
+    f(data, b, (end - b > grain ? b + grain : end));
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkTaskScheduler::GetNumberOfTasksExecuted()
+{
+  return this->Internals->TasksExecuted;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkTaskScheduler::GetNumberOfTasksStolen()
+{
+  return this->Internals->TasksStolen;
+}
+
+//----------------------------------------------------------------------------
+void vtkTaskScheduler::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+  os << indent << "Running: " << this->Internals->Running << "\n";
+  os << indent << "NumberOfTasksExecuted: "
+     << this->Internals->TasksExecuted << "\n";
+  os << indent << "NumberOfTasksStolen: "
+     << this->Internals->TasksStolen << "\n";
+}
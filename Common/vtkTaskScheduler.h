@@ -0,0 +1,132 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkTaskScheduler.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkTaskScheduler - A persistent work-stealing pool of threads
+// .SECTION Description
+// vtkTaskScheduler keeps a set of worker threads alive between calls so
+// that the cost of creating and joining threads is paid only once.  Work
+// is submitted with ParallelFor(), which executes a function over an index
+// range.  The range is split lazily: the thread executing a range pushes
+// its upper half on its own queue until the range is no larger than the
+// grain size, and idle threads steal the largest pending ranges from the
+// queues of busy threads.  The thread that calls ParallelFor() takes part
+// in the work, and keeps executing queued ranges while it waits for its
+// own to complete, so ParallelFor() may be called from inside a task.
+//
+// The range starting at the first index is always executed by the thread
+// that called ParallelFor().  Code that must run on the calling thread,
+// such as progress reporting, can rely on this.
+//
+// When VTK is built without thread support the ranges are executed
+// serially by the calling thread.
+// .SECTION See Also
+// vtkMultiThreader
+
+#ifndef __vtkTaskScheduler_h
+#define __vtkTaskScheduler_h
+
+#include "vtkObject.h"
+
+//BTX
+// The function executed by vtkTaskScheduler::ParallelFor for each
+// sub-range [begin, end) of the requested range.
+typedef void (*vtkTaskFunctionType)(void *data,
+                                    vtkIdType begin, vtkIdType end);
+
+class vtkTaskSchedulerInternals;
+class vtkTaskScheduler;
+
+// Deletes the global scheduler (and joins its threads) on exit.
+class VTK_COMMON_EXPORT vtkTaskSchedulerCleanup
+{
+public:
+  vtkTaskSchedulerCleanup();
+  ~vtkTaskSchedulerCleanup();
+};
+//ETX
+
+class VTK_COMMON_EXPORT vtkTaskScheduler : public vtkObject
+{
+public:
+  static vtkTaskScheduler *New();
+
+  vtkTypeRevisionMacro(vtkTaskScheduler,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Return the scheduler shared by all of VTK.  It is created on first
+  // use with vtkMultiThreader::GetGlobalDefaultNumberOfThreads() threads.
+  static vtkTaskScheduler *GetGlobalScheduler();
+
+  // Description:
+  // Replace the scheduler shared by all of VTK.  No tasks may be running
+  // on the previous scheduler.
+  static void SetGlobalScheduler(vtkTaskScheduler *scheduler);
+
+  // Description:
+  // Set/Get the number of threads that execute tasks, including the
+  // thread that calls ParallelFor().  It is clamped to the range
+  // 1 - VTK_MAX_THREADS.  Changing it stops the running workers; new
+  // ones are started on the next call to ParallelFor().  It must not be
+  // changed while tasks are running.
+  void SetNumberOfThreads(int num);
+  vtkGetMacro(NumberOfThreads, int);
+
+  //BTX
+  // Description:
+  // Call f(data, b, e) for sub-ranges [b, e) that together cover
+  // [begin, end) exactly once, and return when all of them are done.
+  // No sub-range is longer than grain.  A grain of zero or less selects
+  // a grain that gives each thread several ranges to balance the load.
+  void ParallelFor(vtkIdType begin, vtkIdType end, vtkIdType grain,
+                   vtkTaskFunctionType f, void *data);
+  //ETX
+
+  // Description:
+  // Return the number of ranges executed, and of those the number taken
+  // from the queue of another thread, since the scheduler was created.
+  // The values are meant for checking load balance and are updated
+  // without synchronizing with running tasks.
+  vtkIdType GetNumberOfTasksExecuted();
+  vtkIdType GetNumberOfTasksStolen();
+
+protected:
+  vtkTaskScheduler();
+  ~vtkTaskScheduler();
+
+  // Start the worker threads if they are not running.
+  void StartWorkers();
+
+  // Ask the worker threads to exit and wait for them.
+  void StopWorkers();
+
+  int NumberOfThreads;
+
+  //BTX
+  friend class vtkTaskSchedulerInternals;
+  friend class vtkTaskSchedulerCleanup;
+  //ETX
+  vtkTaskSchedulerInternals *Internals;
+
+  static vtkTaskScheduler *GlobalScheduler;
+  //BTX
+  static vtkTaskSchedulerCleanup Cleanup;
+  //ETX
+
+private:
+  vtkTaskScheduler(const vtkTaskScheduler&);  // Not implemented.
+  void operator=(const vtkTaskScheduler&);  // Not implemented.
+};
+
+#endif
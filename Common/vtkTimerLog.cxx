@@ -36,8 +36,17 @@
 #include <sys/types.h>
 #include <time.h>
 #endif
+#include "vtkCriticalSection.h"
 #include "vtkObjectFactory.h"
 
+#include <vtkstd/vector>
+
+#if defined(VTK_USE_PTHREADS)
+# include <pthread.h>
+#elif defined(VTK_USE_WIN32_THREADS)
+# include "vtkWindows.h"
+#endif
+
 vtkCxxRevisionMacro(vtkTimerLog, "1.42.12.1");
 vtkStandardNewMacro(vtkTimerLog);
 
@@ -50,6 +59,7 @@ public:
   ~vtkTimerLogCleanup()
     {
     vtkTimerLog::CleanupLog();
+    vtkTimerLog::CleanupTrace();
     }
 };
 static vtkTimerLogCleanup vtkTimerLogCleanupInstance;
@@ -61,6 +71,8 @@ int vtkTimerLog::MaxEntries = 100;
 int vtkTimerLog::NextEntry = 0;
 int vtkTimerLog::WrapFlag = 0;
 vtkTimerLogEntry *vtkTimerLog::TimerLog = NULL;
+int vtkTimerLog::Tracing = 0;
+double vtkTimerLog::TraceStartTime = 0.0;
 
 #ifdef CLK_TCK
 int vtkTimerLog::TicksPerSecond = CLK_TCK;
@@ -483,6 +495,313 @@ void vtkTimerLog::DumpLog(const char *filename)
 }
 
 
+//----------------------------------------------------------------------------
+// One opening ('B') or closing ('E') of a scope, in the format of the
+// Chrome trace events.  Closing events have no name.
+struct vtkTimerLogTraceEvent
+{
+  double Time;
+  const char *Category;
+  char Phase;
+  char Name[VTK_TRACE_EVENT_LENGTH];
+};
+
+// The events of one thread, appended only by that thread.  Depth counts
+// the scopes it has open.
+struct vtkTimerLogTraceBuffer
+{
+  int Depth;
+  vtkstd::vector<vtkTimerLogTraceEvent> Events;
+};
+
+// The buffers of all threads that recorded events, in the order they
+// first did.  The lock protects the list, not the events.  The buffers
+// live until the program exits so that the pointers kept by the threads
+// stay valid.
+class vtkTimerLogTraceInternals
+{
+public:
+  vtkTimerLogTraceInternals()
+    {
+#if defined(VTK_USE_PTHREADS)
+    pthread_key_create(&this->BufferKey, 0);
+#elif defined(VTK_USE_WIN32_THREADS)
+    this->BufferKey = TlsAlloc();
+#else
+    this->Buffer = 0;
+#endif
+    }
+  ~vtkTimerLogTraceInternals()
+    {
+    for (size_t i = 0; i < this->Buffers.size(); ++i)
+      {
+      delete this->Buffers[i];
+      }
+#if defined(VTK_USE_PTHREADS)
+    pthread_key_delete(this->BufferKey);
+#elif defined(VTK_USE_WIN32_THREADS)
+    TlsFree(this->BufferKey);
+#endif
+    }
+
+  // Return the buffer of the calling thread, creating it if create is
+  // set, or 0.
+  vtkTimerLogTraceBuffer *GetBuffer(int create)
+    {
+    void *value;
+#if defined(VTK_USE_PTHREADS)
+    value = pthread_getspecific(this->BufferKey);
+#elif defined(VTK_USE_WIN32_THREADS)
+    value = TlsGetValue(this->BufferKey);
+#else
+    value = this->Buffer;
+#endif
+    vtkTimerLogTraceBuffer *buffer =
+      static_cast<vtkTimerLogTraceBuffer *>(value);
+    if (!buffer && create)
+      {
+      buffer = new vtkTimerLogTraceBuffer;
+      buffer->Depth = 0;
+      this->Lock.Lock();
+      this->Buffers.push_back(buffer);
+      this->Lock.Unlock();
+#if defined(VTK_USE_PTHREADS)
+      pthread_setspecific(this->BufferKey, buffer);
+#elif defined(VTK_USE_WIN32_THREADS)
+      TlsSetValue(this->BufferKey, buffer);
+#else
+      this->Buffer = buffer;
+#endif
+      }
+    return buffer;
+    }
+
+  vtkSimpleCriticalSection Lock;
+  vtkstd::vector<vtkTimerLogTraceBuffer *> Buffers;
+#if defined(VTK_USE_PTHREADS)
+  pthread_key_t BufferKey;
+#elif defined(VTK_USE_WIN32_THREADS)
+  DWORD BufferKey;
+#else
+  vtkTimerLogTraceBuffer *Buffer;
+#endif
+};
+
+// Created when tracing is first turned on, which must happen before
+// traced code runs on other threads.
+static vtkTimerLogTraceInternals *vtkTimerLogTrace = 0;
+
+//----------------------------------------------------------------------------
+void vtkTimerLog::SetTracing(int v)
+{
+  if (v && !vtkTimerLog::Tracing)
+    {
+    if (!vtkTimerLogTrace)
+      {
+      vtkTimerLogTrace = new vtkTimerLogTraceInternals;
+      }
+    if (vtkTimerLog::GetNumberOfTraceEvents() == 0)
+      {
+      vtkTimerLog::TraceStartTime = vtkTimerLog::GetUniversalTime();
+      }
+    }
+  vtkTimerLog::Tracing = v;
+}
+
+//----------------------------------------------------------------------------
+void vtkTimerLog::MarkStartTraceEvent(const char *category,
+                                      const char *event)
+{
+  if (!vtkTimerLog::Tracing)
+    {
+    return;
+    }
+
+  vtkTimerLogTraceBuffer *buffer = vtkTimerLogTrace->GetBuffer(1);
+  buffer->Events.resize(buffer->Events.size() + 1);
+  vtkTimerLogTraceEvent& e = buffer->Events.back();
+  e.Category = category ? category : "";
+  e.Phase = 'B';
+  strncpy(e.Name, event ? event : "", VTK_TRACE_EVENT_LENGTH - 1);
+  e.Name[VTK_TRACE_EVENT_LENGTH - 1] = '\0';
+  ++buffer->Depth;
+  e.Time = vtkTimerLog::GetUniversalTime();
+}
+
+//----------------------------------------------------------------------------
+void vtkTimerLog::MarkEndTraceEvent()
+{
+  double time = vtkTimerLog::GetUniversalTime();
+  vtkTimerLogTraceBuffer *buffer =
+    vtkTimerLogTrace ? vtkTimerLogTrace->GetBuffer(0) : 0;
+  if (!buffer || buffer->Depth == 0)
+    {
+    return;
+    }
+
+  buffer->Events.resize(buffer->Events.size() + 1);
+  vtkTimerLogTraceEvent& e = buffer->Events.back();
+  e.Time = time;
+  e.Category = "";
+  e.Phase = 'E';
+  e.Name[0] = '\0';
+  --buffer->Depth;
+}
+
+//----------------------------------------------------------------------------
+int vtkTimerLog::GetNumberOfTraceEvents()
+{
+  int num = 0;
+  if (vtkTimerLogTrace)
+    {
+    for (size_t i = 0; i < vtkTimerLogTrace->Buffers.size(); ++i)
+      {
+      num += static_cast<int>(vtkTimerLogTrace->Buffers[i]->Events.size());
+      }
+    }
+  return num;
+}
+
+//----------------------------------------------------------------------------
+int vtkTimerLog::GetNumberOfTraceThreads()
+{
+  int num = 0;
+  if (vtkTimerLogTrace)
+    {
+    for (size_t i = 0; i < vtkTimerLogTrace->Buffers.size(); ++i)
+      {
+      if (!vtkTimerLogTrace->Buffers[i]->Events.empty())
+        {
+        ++num;
+        }
+      }
+    }
+  return num;
+}
+
+//----------------------------------------------------------------------------
+// The buffers are kept, since the threads hold on to them, but scopes
+// that are still open will not be closed in the new trace.
+void vtkTimerLog::ResetTrace()
+{
+  if (vtkTimerLogTrace)
+    {
+    for (size_t i = 0; i < vtkTimerLogTrace->Buffers.size(); ++i)
+      {
+      vtkTimerLogTrace->Buffers[i]->Events.clear();
+      vtkTimerLogTrace->Buffers[i]->Depth = 0;
+      }
+    }
+  vtkTimerLog::TraceStartTime = vtkTimerLog::GetUniversalTime();
+}
+
+//----------------------------------------------------------------------------
+void vtkTimerLog::CleanupTrace()
+{
+  vtkTimerLog::Tracing = 0;
+  delete vtkTimerLogTrace;
+  vtkTimerLogTrace = 0;
+}
+
+//----------------------------------------------------------------------------
+static void vtkTimerLogWriteJSONString(ostream& os, const char *str)
+{
+  static const char hex[] = "0123456789abcdef";
+  os << '"';
+  for (; *str; ++str)
+    {
+    unsigned char c = static_cast<unsigned char>(*str);
+    if (c == '"' || c == '\\')
+      {
+      os << '\\' << *str;
+      }
+    else if (c < 0x20)
+      {
+      os << "\\u00" << hex[c >> 4] << hex[c & 15];
+      }
+    else
+      {
+      os << *str;
+      }
+    }
+  os << '"';
+}
+
+//----------------------------------------------------------------------------
+void vtkTimerLog::DumpTrace(ostream& os)
+{
+  os << "{\"traceEvents\":[";
+  const char *separator = "\n";
+  int threadId = 0;
+  size_t numBuffers = vtkTimerLogTrace ? vtkTimerLogTrace->Buffers.size() : 0;
+  for (size_t i = 0; i < numBuffers; ++i)
+    {
+    vtkTimerLogTraceBuffer *buffer = vtkTimerLogTrace->Buffers[i];
+    if (buffer->Events.empty())
+      {
+      continue;
+      }
+    os << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+       << "\"tid\":" << threadId << ",\"args\":{\"name\":\"Thread "
+       << threadId << "\"}}";
+    separator = ",\n";
+    for (size_t j = 0; j < buffer->Events.size(); ++j)
+      {
+      const vtkTimerLogTraceEvent& e = buffer->Events[j];
+      os << separator << "{";
+      if (e.Phase == 'B')
+        {
+        os << "\"name\":";
+        vtkTimerLogWriteJSONString(os, e.Name);
+        os << ",\"cat\":";
+        vtkTimerLogWriteJSONString(os, e.Category);
+        os << ",";
+        }
+      char ts[64];
+      sprintf(ts, "%.3f", (e.Time - vtkTimerLog::TraceStartTime)*1.0e6);
+      os << "\"ph\":\"" << e.Phase << "\",\"ts\":" << ts
+         << ",\"pid\":1,\"tid\":" << threadId << "}";
+      }
+    ++threadId;
+    }
+  os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+//----------------------------------------------------------------------------
+int vtkTimerLog::WriteTrace(const char *filename)
+{
+  ofstream os(filename);
+  if (!os)
+    {
+    return 0;
+    }
+  vtkTimerLog::DumpTrace(os);
+  os.close();
+  return os ? 1 : 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkTimerLogTraceScope::Start(const char *category,
+                                  vtkObjectBase *object,
+                                  const char *method)
+{
+  char name[VTK_TRACE_EVENT_LENGTH];
+  size_t length = 0;
+  const char *className = object ? object->GetClassName() : "";
+  while (*className && length < VTK_TRACE_EVENT_LENGTH - 3)
+    {
+    name[length++] = *className++;
+    }
+  name[length++] = ':';
+  name[length++] = ':';
+  while (*method && length < VTK_TRACE_EVENT_LENGTH - 1)
+    {
+    name[length++] = *method++;
+    }
+  name[length] = '\0';
+  vtkTimerLog::MarkStartTraceEvent(category, name);
+}
+
 //----------------------------------------------------------------------------
 // Print method for vtkTimerLog.
 void vtkTimerLog::PrintSelf(ostream& os, vtkIndent indent)
@@ -495,6 +814,9 @@ void vtkTimerLog::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "NextEntry: " << vtkTimerLog::NextEntry << "\n";
   os << indent << "WrapFlag: " << vtkTimerLog::WrapFlag << "\n";
   os << indent << "TicksPerSecond: " << vtkTimerLog::TicksPerSecond << "\n";
+  os << indent << "Tracing: " << vtkTimerLog::Tracing << "\n";
+  os << indent << "NumberOfTraceEvents: "
+     << vtkTimerLog::GetNumberOfTraceEvents() << "\n";
   os << "\n";
 
   os << indent << "Entry \tWall Time\tCpuTicks\tEvent\n";
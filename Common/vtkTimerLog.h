@@ -21,6 +21,15 @@
 // In addition, vtkTimerLog allows the user to simply get the current
 // time, and to start/stop a simple timer separate from the timing
 // table logging.
+//
+// vtkTimerLog also records a trace of nested scopes for each thread,
+// separate from the timing table.  When tracing is on, the executives
+// open a scope for each pipeline pass and each request sent to an
+// algorithm, readers for their I/O, and render windows and renderers
+// for rendering.  Each thread appends to its own list of events
+// without locking, so tracing adds little to the cost of the traced
+// code.  The trace is written in the Chrome trace event format (JSON),
+// which chrome://tracing and similar viewers display as a timeline.
 
 #ifndef __vtkTimerLog_h
 #define __vtkTimerLog_h
@@ -60,6 +69,7 @@
 
 
 #define VTK_LOG_EVENT_LENGTH 40
+#define VTK_TRACE_EVENT_LENGTH 64
 
 //BTX
 typedef struct
@@ -87,6 +97,50 @@ public:
   static void LoggingOn() {vtkTimerLog::SetLogging(1);}
   static void LoggingOff() {vtkTimerLog::SetLogging(0);}
 
+  // Description:
+  // Turn recording of the trace of nested scopes on or off.  Turning it
+  // on starts the time of the trace if it is empty.  By default,
+  // tracing is off.
+  static void SetTracing(int v);
+  static int GetTracing() {return vtkTimerLog::Tracing;}
+  static void TracingOn() {vtkTimerLog::SetTracing(1);}
+  static void TracingOff() {vtkTimerLog::SetTracing(0);}
+
+  // Description:
+  // Open a scope named EventString on the trace of the calling thread,
+  // or close the last scope it opened.  The category groups the scopes
+  // in the viewer ("Executive", "Algorithm", "IO" and "Render" are used
+  // by VTK) and must be a string that lives as long as the trace, such
+  // as a literal.  The name is copied and truncated to
+  // VTK_TRACE_EVENT_LENGTH-1 characters.  Nothing is recorded when
+  // tracing is off, but scopes opened before tracing was turned off
+  // are still closed.
+  static void MarkStartTraceEvent(const char *category,
+                                  const char *EventString);
+  static void MarkEndTraceEvent();
+
+  // Description:
+  // Write the trace in the Chrome trace event format.  Times are in
+  // microseconds from the start of the trace, and each thread that
+  // recorded events is shown with its own id, in the order the threads
+  // first recorded.  No traced code may be running.  WriteTrace returns
+  // 0 if the file cannot be written.
+  static int WriteTrace(const char *filename);
+//BTX
+  static void DumpTrace(ostream& os);
+//ETX
+
+  // Description:
+  // Return the number of events (the opening and the closing of scopes)
+  // and of threads in the trace.
+  static int GetNumberOfTraceEvents();
+  static int GetNumberOfTraceThreads();
+
+  // Description:
+  // Clear the trace and restart its time.  No traced code may be
+  // running.
+  static void ResetTrace();
+
   // Description:
   // Set/Get the maximum number of entries allowed in the timer log
   static void SetMaxEntries(int a);
@@ -190,6 +244,9 @@ protected:
   static int               TicksPerSecond;
   static vtkTimerLogEntry *TimerLog;
 
+  static int               Tracing;
+  static double            TraceStartTime;
+
 #ifdef _WIN32
 #ifndef _WIN32_WCE
   static timeb             FirstWallTime;
@@ -211,6 +268,9 @@ protected:
   double EndTime;
 
   //BTX
+  friend class vtkTimerLogCleanup;
+  static void CleanupTrace();
+
   static void DumpEntry(ostream& os, int index, double time, double deltatime,
                         int tick, int deltatick, const char *event);
   //ETX
@@ -221,6 +281,47 @@ private:
 };
 
 
+//BTX
+// Opens a trace scope on construction and closes it on destruction, so
+// that every return path of the scope closes it.  The name is
+// ClassName::method when given an object.
+class VTK_COMMON_EXPORT vtkTimerLogTraceScope
+{
+public:
+  vtkTimerLogTraceScope(const char *category, const char *name)
+    {
+    this->Active = vtkTimerLog::GetTracing();
+    if (this->Active)
+      {
+      vtkTimerLog::MarkStartTraceEvent(category, name);
+      }
+    }
+  vtkTimerLogTraceScope(const char *category, vtkObjectBase *object,
+                        const char *method)
+    {
+    this->Active = vtkTimerLog::GetTracing();
+    if (this->Active)
+      {
+      this->Start(category, object, method);
+      }
+    }
+  ~vtkTimerLogTraceScope()
+    {
+    if (this->Active)
+      {
+      vtkTimerLog::MarkEndTraceEvent();
+      }
+    }
+protected:
+  void Start(const char *category, vtkObjectBase *object,
+             const char *method);
+  int Active;
+private:
+  vtkTimerLogTraceScope(const vtkTimerLogTraceScope&);  // Not implemented.
+  void operator=(const vtkTimerLogTraceScope&);  // Not implemented.
+};
+//ETX
+
 //
 // Set built-in type.  Creates member Set"name"() (e.g., SetVisibility());
 //
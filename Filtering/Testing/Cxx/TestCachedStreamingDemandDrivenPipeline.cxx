@@ -0,0 +1,231 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCachedStreamingDemandDrivenPipeline.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of vtkCachedStreamingDemandDrivenPipeline.
+// .SECTION Description
+// Updates an image source through the cached executive for several time
+// steps, extents and values of a cache key, and checks which updates
+// execute the source and which are served from the cache, the values of
+// the output, the statistics, and that the least recently used images
+// are evicted to stay under the memory limit.
+
+#include "vtkCachedStreamingDemandDrivenPipeline.h"
+#include "vtkImageAlgorithm.h"
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkInformationIntegerKey.h"
+#include "vtkInformationVector.h"
+#include "vtkObjectFactory.h"
+
+class vtkTestCachedSource : public vtkImageAlgorithm
+{
+public:
+  static vtkTestCachedSource *New();
+  vtkTypeRevisionMacro(vtkTestCachedSource,vtkImageAlgorithm);
+
+  // Multiplies the values when set in the output information.
+  static vtkInformationIntegerKey* SCALE();
+
+  int NumberOfExecutions;
+
+protected:
+  vtkTestCachedSource()
+    {
+    this->SetNumberOfInputPorts(0);
+    this->NumberOfExecutions = 0;
+    }
+
+  virtual int RequestInformation(vtkInformation *,
+                                 vtkInformationVector **,
+                                 vtkInformationVector *outputVector)
+    {
+    int wholeExtent[6] = { 0, 19, 0, 19, 0, 19 };
+    vtkInformation *outInfo = outputVector->GetInformationObject(0);
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(),
+                 wholeExtent, 6);
+    vtkDataObject::SetPointDataActiveScalarInfo(outInfo, VTK_DOUBLE, 1);
+    return 1;
+    }
+
+  virtual int RequestData(vtkInformation *,
+                          vtkInformationVector **,
+                          vtkInformationVector *outputVector)
+    {
+    ++this->NumberOfExecutions;
+    vtkInformation *outInfo = outputVector->GetInformationObject(0);
+    vtkImageData *output = this->AllocateOutputData(
+      outInfo->Get(vtkDataObject::DATA_OBJECT()));
+    int t = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_INDEX());
+    int scale = outInfo->Has(SCALE()) ? outInfo->Get(SCALE()) : 1;
+    int extent[6];
+    output->GetExtent(extent);
+    double *ptr = static_cast<double *>(output->GetScalarPointer());
+    for (int k = extent[4]; k <= extent[5]; ++k)
+      {
+      for (int j = extent[2]; j <= extent[3]; ++j)
+        {
+        for (int i = extent[0]; i <= extent[1]; ++i)
+          {
+          *ptr++ = scale*(i + 100.0*j + 10000.0*k + 1000000.0*t);
+          }
+        }
+      }
+    return 1;
+    }
+
+private:
+  vtkTestCachedSource(const vtkTestCachedSource&);  // Not implemented.
+  void operator=(const vtkTestCachedSource&);  // Not implemented.
+};
+
+vtkCxxRevisionMacro(vtkTestCachedSource, "1.1");
+vtkStandardNewMacro(vtkTestCachedSource);
+vtkInformationKeyMacro(vtkTestCachedSource, SCALE, Integer);
+
+// Update the extent at time t and check the output and whether the
+// source executed.
+static int UpdateAndCheck(vtkTestCachedSource *source, int x0, int x1,
+                          int t, int scale, int execute)
+{
+  vtkImageData *output = source->GetOutput();
+  vtkInformation *outInfo = source->GetExecutive()->GetOutputInformation(0);
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_INDEX(), t);
+  int updateExtent[6] = { x0, x1, 0, 19, 0, 19 };
+  output->SetUpdateExtent(updateExtent);
+  int executions = source->NumberOfExecutions;
+  source->Update();
+
+  int retVal = 0;
+  if (source->NumberOfExecutions - executions != execute)
+    {
+    cerr << "Time " << t << ", extent " << x0 << " to " << x1 << ": "
+         << (execute ? "served from the cache" : "executed") << "\n";
+    retVal = 1;
+    }
+  int extent[6];
+  output->GetExtent(extent);
+  if (extent[0] > x0 || extent[1] < x1)
+    {
+    cerr << "Time " << t << ": output extent " << extent[0] << " to "
+         << extent[1] << " does not contain " << x0 << " to " << x1 << "\n";
+    return 1;
+    }
+  int ijk[3] = { x1, 7, 3 };
+  double value = output->GetScalarComponentAsDouble(ijk[0], ijk[1], ijk[2], 0);
+  double expected = scale*(ijk[0] + 100.0*ijk[1] + 10000.0*ijk[2] +
+                           1000000.0*t);
+  if (value != expected)
+    {
+    cerr << "Time " << t << ": value " << value << " instead of "
+         << expected << "\n";
+    retVal = 1;
+    }
+  return retVal;
+}
+
+static int CheckStatistics(vtkCachedStreamingDemandDrivenPipeline *executive,
+                           unsigned long hits, unsigned long misses,
+                           unsigned long evictions, int cached)
+{
+  if (executive->GetNumberOfCacheHits() != hits ||
+      executive->GetNumberOfCacheMisses() != misses ||
+      executive->GetNumberOfCacheEvictions() != evictions ||
+      executive->GetNumberOfCachedDataObjects() != cached)
+    {
+    cerr << executive->GetNumberOfCacheHits() << " hits, "
+         << executive->GetNumberOfCacheMisses() << " misses, "
+         << executive->GetNumberOfCacheEvictions() << " evictions and "
+         << executive->GetNumberOfCachedDataObjects() << " images instead of "
+         << hits << ", " << misses << ", " << evictions << " and " << cached
+         << "\n";
+    return 1;
+    }
+  return 0;
+}
+
+int TestCachedStreamingDemandDrivenPipeline(int, char *[])
+{
+  int retVal = 0;
+  vtkTestCachedSource *source = vtkTestCachedSource::New();
+  vtkCachedStreamingDemandDrivenPipeline *executive =
+    vtkCachedStreamingDemandDrivenPipeline::New();
+  source->SetExecutive(executive);
+  executive->Delete();
+  executive->AddCacheKey(vtkTestCachedSource::SCALE());
+
+  // Each time step executes once, and a smaller extent is served from
+  // the image that contains it.
+  retVal |= UpdateAndCheck(source, 0, 19, 0, 1, 1);
+  retVal |= UpdateAndCheck(source, 2, 5, 0, 1, 0);
+  retVal |= UpdateAndCheck(source, 0, 19, 1, 1, 1);
+  retVal |= UpdateAndCheck(source, 0, 19, 2, 1, 1);
+  retVal |= UpdateAndCheck(source, 3, 9, 0, 1, 0);
+  retVal |= UpdateAndCheck(source, 0, 19, 1, 1, 0);
+  retVal |= UpdateAndCheck(source, 0, 19, 1, 1, 0);
+  retVal |= CheckStatistics(executive, 2, 3, 0, 3);
+
+  // The cache key is part of the request.
+  vtkInformation *outInfo = executive->GetOutputInformation(0);
+  outInfo->Set(vtkTestCachedSource::SCALE(), 2);
+  retVal |= UpdateAndCheck(source, 0, 19, 1, 2, 1);
+  outInfo->Remove(vtkTestCachedSource::SCALE());
+  retVal |= UpdateAndCheck(source, 0, 19, 1, 1, 0);
+  retVal |= CheckStatistics(executive, 3, 4, 0, 4);
+
+  // A memory limit of two and a half images keeps the two most recently
+  // used: time 1 and time 1 scaled.
+  unsigned long size = executive->GetCacheMemorySize() / 4;
+  executive->SetCacheMemoryLimit(size*5/2);
+  retVal |= CheckStatistics(executive, 3, 4, 2, 2);
+  if (executive->GetCacheMemorySize() > size*5/2)
+    {
+    cerr << "The images take " << executive->GetCacheMemorySize()
+         << " kilobytes\n";
+    retVal = 1;
+    }
+  retVal |= UpdateAndCheck(source, 0, 19, 2, 1, 1);
+  retVal |= UpdateAndCheck(source, 0, 19, 1, 1, 0);
+  outInfo->Set(vtkTestCachedSource::SCALE(), 2);
+  retVal |= UpdateAndCheck(source, 0, 19, 1, 2, 1);
+  outInfo->Remove(vtkTestCachedSource::SCALE());
+  retVal |= CheckStatistics(executive, 4, 6, 4, 2);
+
+  // An image larger than the limit is not kept, but the output still
+  // serves the requests it satisfies.
+  executive->SetCacheMemoryLimit(size/2);
+  retVal |= UpdateAndCheck(source, 0, 19, 3, 1, 1);
+  retVal |= UpdateAndCheck(source, 1, 19, 3, 1, 0);
+  retVal |= CheckStatistics(executive, 4, 7, 6, 0);
+
+  // Modifying the source removes its images.
+  executive->SetCacheMemoryLimit(0);
+  executive->ResetCacheStatistics();
+  retVal |= UpdateAndCheck(source, 0, 19, 0, 1, 1);
+  retVal |= UpdateAndCheck(source, 0, 19, 1, 1, 1);
+  source->Modified();
+  retVal |= UpdateAndCheck(source, 0, 19, 0, 1, 1);
+  retVal |= CheckStatistics(executive, 0, 3, 0, 1);
+
+  // So does a smaller cache size, the least recently used first.
+  retVal |= UpdateAndCheck(source, 0, 19, 1, 1, 1);
+  retVal |= UpdateAndCheck(source, 0, 19, 2, 1, 1);
+  retVal |= UpdateAndCheck(source, 0, 19, 0, 1, 0);
+  executive->SetCacheSize(2);
+  retVal |= UpdateAndCheck(source, 0, 19, 2, 1, 0);
+  retVal |= UpdateAndCheck(source, 0, 19, 1, 1, 1);
+  retVal |= CheckStatistics(executive, 2, 6, 2, 2);
+
+  source->Delete();
+  return retVal;
+}
@@ -0,0 +1,217 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestConcurrentMergePoints.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of vtkConcurrentMergePoints.
+// .SECTION Description
+// Inserts the corners of the cells of a grid from the threads of the
+// task scheduler, with a table much smaller than the number of points,
+// and checks that after compaction the points and their ids are those
+// that vtkMergePoints gives when the corners are inserted in order.
+// Also checks that zeros of either sign merge and that insertions
+// without an order key compact the same way every time.
+
+#include "vtkConcurrentMergePoints.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMergePoints.h"
+#include "vtkPoints.h"
+#include "vtkTaskScheduler.h"
+
+#define GRID_SIZE 40
+#define NUMBER_OF_CELLS (GRID_SIZE*GRID_SIZE*GRID_SIZE)
+
+struct TestInsertData
+{
+  vtkConcurrentMergePoints *Locator;
+  vtkIdType *InsertedIds;
+  int Ordered;
+};
+
+static void GetCorner(vtkIdType cellId, int corner, double x[3])
+{
+  vtkIdType i = cellId % GRID_SIZE;
+  vtkIdType j = (cellId / GRID_SIZE) % GRID_SIZE;
+  vtkIdType k = cellId / (GRID_SIZE*GRID_SIZE);
+  x[0] = 0.1*(i + (corner & 1)) - 1.0;
+  x[1] = 0.1*(j + ((corner >> 1) & 1)) - 1.0;
+  x[2] = 0.3*(k + ((corner >> 2) & 1));
+}
+
+static void InsertCorners(void *arg, vtkIdType begin, vtkIdType end)
+{
+  TestInsertData *data = static_cast<TestInsertData *>(arg);
+  double x[3];
+  for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+    for (int corner = 0; corner < 8; ++corner)
+      {
+      GetCorner(cellId, corner, x);
+      vtkIdType *ptId = data->InsertedIds + 8*cellId + corner;
+      if (data->Ordered)
+        {
+        data->Locator->InsertUniquePoint(x, 8*cellId + corner, *ptId);
+        }
+      else
+        {
+        data->Locator->InsertUniquePoint(x, *ptId);
+        }
+      }
+    }
+}
+
+// Insert the corners in parallel, compact, and return the final id of
+// each corner in finalIds.
+static vtkIdType InsertInParallel(vtkConcurrentMergePoints *locator,
+                                  int ordered, vtkPoints *points,
+                                  vtkIdType *finalIds)
+{
+  vtkIdType *insertedIds = new vtkIdType[8*NUMBER_OF_CELLS];
+  locator->InitPointInsertion(1000);
+  TestInsertData data;
+  data.Locator = locator;
+  data.InsertedIds = insertedIds;
+  data.Ordered = ordered;
+  vtkTaskScheduler::GetGlobalScheduler()->ParallelFor(
+    0, NUMBER_OF_CELLS, 16, InsertCorners, &data);
+
+  vtkIdTypeArray *pointMap = vtkIdTypeArray::New();
+  vtkIdType numPts = locator->Compact(points, pointMap);
+  for (vtkIdType i = 0; i < 8*NUMBER_OF_CELLS; ++i)
+    {
+    finalIds[i] = pointMap->GetValue(insertedIds[i]);
+    }
+  pointMap->Delete();
+  delete [] insertedIds;
+  return numPts;
+}
+
+int TestConcurrentMergePoints(int, char *[])
+{
+  int retVal = 0;
+  vtkTaskScheduler::GetGlobalScheduler()->SetNumberOfThreads(4);
+  vtkIdType numCorners = 8*NUMBER_OF_CELLS;
+  vtkIdType numExpected = (GRID_SIZE + 1)*(GRID_SIZE + 1)*(GRID_SIZE + 1);
+  vtkIdType i;
+
+  // The serial reference.
+  vtkPoints *serialPoints = vtkPoints::New();
+  vtkMergePoints *merge = vtkMergePoints::New();
+  double bounds[6] = { -1.0, 3.0, -1.0, 3.0, 0.0, 12.0 };
+  merge->InitPointInsertion(serialPoints, bounds);
+  vtkIdType *serialIds = new vtkIdType[numCorners];
+  double x[3];
+  for (i = 0; i < numCorners; ++i)
+    {
+    GetCorner(i / 8, static_cast<int>(i % 8), x);
+    merge->InsertUniquePoint(x, serialIds[i]);
+    }
+  merge->Delete();
+
+  vtkConcurrentMergePoints *locator = vtkConcurrentMergePoints::New();
+  vtkPoints *points = vtkPoints::New();
+  vtkIdType *finalIds = new vtkIdType[numCorners];
+  for (int pass = 0; pass < 3; ++pass)
+    {
+    vtkIdType numPts = InsertInParallel(locator, 1, points, finalIds);
+    if (numPts != numExpected ||
+        locator->GetNumberOfPoints() != numExpected ||
+        serialPoints->GetNumberOfPoints() != numExpected)
+      {
+      cerr << "Expected " << numExpected << " points, got " << numPts
+           << " (serial " << serialPoints->GetNumberOfPoints() << ")\n";
+      retVal = 1;
+      break;
+      }
+    for (i = 0; i < numCorners; ++i)
+      {
+      if (finalIds[i] != serialIds[i])
+        {
+        cerr << "Pass " << pass << ": corner " << i << " has id "
+             << finalIds[i] << " instead of " << serialIds[i] << "\n";
+        retVal = 1;
+        break;
+        }
+      }
+    for (i = 0; i < numPts; ++i)
+      {
+      double *p = points->GetPoint(i);
+      double *q = serialPoints->GetPoint(i);
+      if (p[0] != q[0] || p[1] != q[1] || p[2] != q[2])
+        {
+        cerr << "Pass " << pass << ": point " << i << " differs\n";
+        retVal = 1;
+        break;
+        }
+      }
+    }
+  cout << locator->GetNumberOfInsertedIds() - numExpected
+       << " ids unused by racing insertions\n";
+
+  // Without order keys the points are sorted by their coordinates.
+  vtkPoints *unorderedPoints = vtkPoints::New();
+  vtkIdType *unorderedIds = new vtkIdType[numCorners];
+  InsertInParallel(locator, 0, unorderedPoints, unorderedIds);
+  for (int pass = 0; pass < 2; ++pass)
+    {
+    InsertInParallel(locator, 0, points, finalIds);
+    for (i = 0; i < numCorners; ++i)
+      {
+      if (finalIds[i] != unorderedIds[i])
+        {
+        cerr << "Unordered insertion is not deterministic\n";
+        retVal = 1;
+        break;
+        }
+      }
+    }
+  for (i = 1; i < unorderedPoints->GetNumberOfPoints(); ++i)
+    {
+    double p[3];
+    double q[3];
+    unorderedPoints->GetPoint(i - 1, p);
+    unorderedPoints->GetPoint(i, q);
+    int c = 0;
+    while (c < 2 && p[c] == q[c])
+      {
+      ++c;
+      }
+    if (p[c] >= q[c])
+      {
+      cerr << "Unordered points are not sorted at " << i << "\n";
+      retVal = 1;
+      break;
+      }
+    }
+
+  // Zeros of either sign are the same point.
+  locator->InitPointInsertion(10);
+  double zero[3] = { 0.0, 0.0, 0.0 };
+  double negativeZero[3] = { -0.0, 0.0, -0.0 };
+  vtkIdType id0;
+  vtkIdType id1;
+  if (!locator->InsertUniquePoint(zero, id0) ||
+      locator->InsertUniquePoint(negativeZero, id1) || id0 != id1)
+    {
+    cerr << "Signed zeros were not merged\n";
+    retVal = 1;
+    }
+
+  delete [] unorderedIds;
+  unorderedPoints->Delete();
+  delete [] finalIds;
+  delete [] serialIds;
+  points->Delete();
+  serialPoints->Delete();
+  locator->Delete();
+  return retVal;
+}
@@ -0,0 +1,215 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPrefetchingStreamingDemandDrivenPipeline.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of vtkPrefetchingStreamingDemandDrivenPipeline.
+// .SECTION Description
+// Plays the time steps of a source forwards and backwards through a
+// filter using the prefetching executive, and checks the output values,
+// which time steps the source reads, and the statistics.  Also checks
+// explicit prefetching, and deleting the pipeline while a time step is
+// read ahead.
+
+#include "vtkImageAlgorithm.h"
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPrefetchingStreamingDemandDrivenPipeline.h"
+
+#define NUMBER_OF_TIME_STEPS 10
+
+// A source with time steps whose values are the time index.
+class vtkTestTimeSource : public vtkImageAlgorithm
+{
+public:
+  static vtkTestTimeSource *New();
+  vtkTypeRevisionMacro(vtkTestTimeSource,vtkImageAlgorithm);
+
+  int NumberOfExecutions;
+
+protected:
+  vtkTestTimeSource()
+    {
+    this->SetNumberOfInputPorts(0);
+    this->NumberOfExecutions = 0;
+    }
+
+  virtual int RequestInformation(vtkInformation *,
+                                 vtkInformationVector **,
+                                 vtkInformationVector *outputVector)
+    {
+    int wholeExtent[6] = { 0, 9, 0, 9, 0, 9 };
+    double timeSteps[NUMBER_OF_TIME_STEPS];
+    for (int i = 0; i < NUMBER_OF_TIME_STEPS; ++i)
+      {
+      timeSteps[i] = 0.5*i;
+      }
+    vtkInformation *outInfo = outputVector->GetInformationObject(0);
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(),
+                 wholeExtent, 6);
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(),
+                 timeSteps, NUMBER_OF_TIME_STEPS);
+    vtkDataObject::SetPointDataActiveScalarInfo(outInfo, VTK_DOUBLE, 1);
+    return 1;
+    }
+
+  virtual int RequestData(vtkInformation *,
+                          vtkInformationVector **,
+                          vtkInformationVector *outputVector)
+    {
+    ++this->NumberOfExecutions;
+    vtkInformation *outInfo = outputVector->GetInformationObject(0);
+    vtkImageData *output = this->AllocateOutputData(
+      outInfo->Get(vtkDataObject::DATA_OBJECT()));
+    int t = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_INDEX());
+    double *ptr = static_cast<double *>(output->GetScalarPointer());
+    for (vtkIdType i = 0; i < output->GetNumberOfPoints(); ++i)
+      {
+      ptr[i] = t;
+      }
+    output->GetInformation()->Set(vtkDataObject::DATA_TIME_INDEX(), t);
+    return 1;
+    }
+
+private:
+  vtkTestTimeSource(const vtkTestTimeSource&);  // Not implemented.
+  void operator=(const vtkTestTimeSource&);  // Not implemented.
+};
+
+vtkCxxRevisionMacro(vtkTestTimeSource, "1.1");
+vtkStandardNewMacro(vtkTestTimeSource);
+
+// A filter that passes its input through.
+class vtkTestTimePassThrough : public vtkImageAlgorithm
+{
+public:
+  static vtkTestTimePassThrough *New();
+  vtkTypeRevisionMacro(vtkTestTimePassThrough,vtkImageAlgorithm);
+
+protected:
+  vtkTestTimePassThrough() {}
+
+  virtual int RequestData(vtkInformation *,
+                          vtkInformationVector **inputVector,
+                          vtkInformationVector *outputVector)
+    {
+    vtkImageData *input = vtkImageData::SafeDownCast(
+      inputVector[0]->GetInformationObject(0)->Get(
+        vtkDataObject::DATA_OBJECT()));
+    vtkImageData *output = vtkImageData::SafeDownCast(
+      outputVector->GetInformationObject(0)->Get(
+        vtkDataObject::DATA_OBJECT()));
+    output->ShallowCopy(input);
+    output->GetInformation()->CopyEntry(input->GetInformation(),
+                                        vtkDataObject::DATA_TIME_INDEX());
+    return 1;
+    }
+
+private:
+  vtkTestTimePassThrough(const vtkTestTimePassThrough&);  // Not implemented.
+  void operator=(const vtkTestTimePassThrough&);  // Not implemented.
+};
+
+vtkCxxRevisionMacro(vtkTestTimePassThrough, "1.1");
+vtkStandardNewMacro(vtkTestTimePassThrough);
+
+// Update the filter at time t and check its output, then wait for the
+// time step read ahead and check how many times the source executed.
+static int UpdateAndCheck(vtkTestTimePassThrough *filter,
+                          vtkTestTimeSource *source, int t, int executions)
+{
+  vtkPrefetchingStreamingDemandDrivenPipeline *exec =
+    vtkPrefetchingStreamingDemandDrivenPipeline::SafeDownCast(
+      filter->GetExecutive());
+  vtkInformation *outInfo = exec->GetOutputInformation(0);
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_INDEX(), t);
+  filter->Update();
+
+  int retVal = 0;
+  vtkImageData *output = filter->GetOutput();
+  vtkDataArray *scalars = output->GetPointData()->GetScalars();
+  if (!scalars || scalars->GetNumberOfTuples() != 1000 ||
+      scalars->GetComponent(0, 0) != t || scalars->GetComponent(999, 0) != t)
+    {
+    cerr << "Time " << t << ": wrong output\n";
+    retVal = 1;
+    }
+  exec->WaitForPrefetch();
+  if (source->NumberOfExecutions != executions)
+    {
+    cerr << "Time " << t << ": " << source->NumberOfExecutions
+         << " executions of the source instead of " << executions << "\n";
+    retVal = 1;
+    }
+  return retVal;
+}
+
+int TestPrefetchingStreamingDemandDrivenPipeline(int, char *[])
+{
+  int retVal = 0;
+  vtkTestTimeSource *source = vtkTestTimeSource::New();
+  vtkTestTimePassThrough *filter = vtkTestTimePassThrough::New();
+  vtkPrefetchingStreamingDemandDrivenPipeline *exec =
+    vtkPrefetchingStreamingDemandDrivenPipeline::New();
+  filter->SetExecutive(exec);
+  exec->Delete();
+  filter->SetInputConnection(source->GetOutputPort());
+
+  // Forwards, each step reads the next one ahead.
+  retVal |= UpdateAndCheck(filter, source, 0, 2);
+  retVal |= UpdateAndCheck(filter, source, 1, 3);
+  retVal |= UpdateAndCheck(filter, source, 2, 4);
+  // Updating again does not execute anything.
+  retVal |= UpdateAndCheck(filter, source, 2, 4);
+  // Backwards, step 3 was read for nothing, then the direction is
+  // followed.
+  retVal |= UpdateAndCheck(filter, source, 1, 6);
+  retVal |= UpdateAndCheck(filter, source, 0, 6);
+  if (exec->GetNumberOfPrefetches() != 4 ||
+      exec->GetNumberOfPrefetchHits() != 3)
+    {
+    cerr << exec->GetNumberOfPrefetches() << " prefetches and "
+         << exec->GetNumberOfPrefetchHits() << " hits instead of 4 and 3\n";
+    retVal = 1;
+    }
+
+  // Explicit prefetching only.
+  exec->PrefetchTimeStepsOff();
+  exec->ResetPrefetchStatistics();
+  retVal |= UpdateAndCheck(filter, source, 5, 7);
+  if (!exec->PrefetchTimeStep(7) || exec->PrefetchTimeStep(NUMBER_OF_TIME_STEPS))
+    {
+    cerr << "Explicit prefetching was not done as asked\n";
+    retVal = 1;
+    }
+  retVal |= UpdateAndCheck(filter, source, 7, 8);
+  if (exec->GetNumberOfPrefetches() != 1 ||
+      exec->GetNumberOfPrefetchHits() != 1)
+    {
+    cerr << "Explicit prefetching: " << exec->GetNumberOfPrefetches()
+         << " prefetches and " << exec->GetNumberOfPrefetchHits()
+         << " hits instead of 1 and 1\n";
+    retVal = 1;
+    }
+
+  // Delete the pipeline while a time step is read ahead.
+  exec->PrefetchTimeStepsOn();
+  vtkInformation *outInfo = exec->GetOutputInformation(0);
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_INDEX(), 8);
+  filter->Update();
+  filter->Delete();
+  source->Delete();
+  return retVal;
+}
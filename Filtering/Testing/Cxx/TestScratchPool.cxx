@@ -0,0 +1,337 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestScratchPool.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of vtkScratchPool.
+// .SECTION Description
+// Checks that a pool gives back the objects released to it, empty, that
+// it keeps a bounded number of them, and that it counts allocations and
+// acquisitions.  Checks that each thread has its own pool and that the
+// counts of the threads that exited are kept.  Checks that a generic
+// cell keeps the cells of the types it used, and that an algorithm
+// calling vtkPointSet::FindCell allocates nothing once the pool is
+// warm, as its information reports.
+
+#include "vtkCellArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkScratchPool.h"
+#include "vtkTaskScheduler.h"
+
+#define GRID_SIZE 20
+#define NUMBER_OF_PROBES 200
+
+// A source that locates points in a grid of quads with FindCell().
+class vtkTestFindCellSource : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkTestFindCellSource *New();
+  vtkTypeRevisionMacro(vtkTestFindCellSource,vtkPolyDataAlgorithm);
+
+  int NumberOfCellsFound;
+
+protected:
+  vtkTestFindCellSource()
+    {
+    this->SetNumberOfInputPorts(0);
+    this->NumberOfCellsFound = 0;
+    this->Grid = vtkPolyData::New();
+    vtkPoints *points = vtkPoints::New();
+    for (int j = 0; j <= GRID_SIZE; ++j)
+      {
+      for (int i = 0; i <= GRID_SIZE; ++i)
+        {
+        points->InsertNextPoint(i, j, 0.0);
+        }
+      }
+    vtkCellArray *quads = vtkCellArray::New();
+    for (int j = 0; j < GRID_SIZE; ++j)
+      {
+      for (int i = 0; i < GRID_SIZE; ++i)
+        {
+        vtkIdType p = j*(GRID_SIZE + 1) + i;
+        vtkIdType quad[4] = { p, p + 1, p + GRID_SIZE + 2,
+                              p + GRID_SIZE + 1 };
+        quads->InsertNextCell(4, quad);
+        }
+      }
+    this->Grid->SetPoints(points);
+    this->Grid->SetPolys(quads);
+    points->Delete();
+    quads->Delete();
+    }
+  ~vtkTestFindCellSource()
+    {
+    this->Grid->Delete();
+    }
+
+  virtual int RequestData(vtkInformation *,
+                          vtkInformationVector **,
+                          vtkInformationVector *)
+    {
+    vtkGenericCell *cell = vtkGenericCell::New();
+    double pcoords[3];
+    double weights[4];
+    int subId;
+    this->NumberOfCellsFound = 0;
+    for (int i = 0; i < NUMBER_OF_PROBES; ++i)
+      {
+      double x[3] = { 0.37 + 0.09*i, 0.11 + 0.07*i, 0.0 };
+      if (this->Grid->FindCell(x, NULL, cell, -1, 1e-6,
+                               subId, pcoords, weights) >= 0)
+        {
+        ++this->NumberOfCellsFound;
+        }
+      }
+    cell->Delete();
+    return 1;
+    }
+
+  vtkPolyData *Grid;
+
+private:
+  vtkTestFindCellSource(const vtkTestFindCellSource&);  // Not implemented.
+  void operator=(const vtkTestFindCellSource&);  // Not implemented.
+};
+
+vtkCxxRevisionMacro(vtkTestFindCellSource, "1.1");
+vtkStandardNewMacro(vtkTestFindCellSource);
+
+struct TestPoolData
+{
+  vtkScratchPool *Pools[VTK_MAX_THREADS];
+  int Failed;
+};
+
+// Take and give back lists from the pool of each task.
+static void UsePool(void *arg, vtkIdType begin, vtkIdType end)
+{
+  TestPoolData *data = static_cast<TestPoolData *>(arg);
+  vtkScratchPool *pool = vtkScratchPool::GetThreadPool();
+  for (vtkIdType i = begin; i < end; ++i)
+    {
+    vtkIdList *list = pool->AcquireIdList();
+    if (list->GetNumberOfIds() != 0)
+      {
+      data->Failed = 1;
+      }
+    list->InsertNextId(i);
+    pool->ReleaseIdList(list);
+    }
+  if (vtkScratchPool::GetThreadPool() != pool)
+    {
+    data->Failed = 1;
+    }
+}
+
+// Take ten lists at once from the pool of a thread that then exits.
+static VTK_THREAD_RETURN_TYPE UseThreadPool(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  TestPoolData *data = static_cast<TestPoolData *>(info->UserData);
+  vtkScratchPool *pool = vtkScratchPool::GetThreadPool();
+  data->Pools[info->ThreadID] = pool;
+  vtkIdList *lists[10];
+  int i;
+  for (i = 0; i < 10; ++i)
+    {
+    lists[i] = pool->AcquireIdList();
+    }
+  for (i = 0; i < 10; ++i)
+    {
+    pool->ReleaseIdList(lists[i]);
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+int TestScratchPool(int, char *[])
+{
+  int retVal = 0;
+  int i;
+
+  // Released objects are given back empty.
+  vtkScratchPool *pool = vtkScratchPool::New();
+  vtkIdList *list = pool->AcquireIdList();
+  list->InsertNextId(3);
+  pool->ReleaseIdList(list);
+  vtkIdList *again = pool->AcquireIdList();
+  if (again != list || again->GetNumberOfIds() != 0)
+    {
+    cerr << "The released list was not reused empty\n";
+    retVal = 1;
+    }
+  pool->ReleaseIdList(again);
+
+  vtkDoubleArray *array = pool->AcquireDoubleArray();
+  array->SetNumberOfComponents(3);
+  array->InsertNextTuple3(1.0, 2.0, 3.0);
+  pool->ReleaseDoubleArray(array);
+  array = pool->AcquireDoubleArray();
+  if (array->GetNumberOfComponents() != 1 || array->GetNumberOfTuples() != 0)
+    {
+    cerr << "The released array was not reset\n";
+    retVal = 1;
+    }
+  pool->ReleaseDoubleArray(array);
+
+  // Points of another type are not kept.
+  vtkPoints *points = pool->AcquirePoints();
+  points->SetDataTypeToDouble();
+  pool->ReleasePoints(points);
+  points = pool->AcquirePoints();
+  if (points->GetDataType() != VTK_FLOAT || points->GetNumberOfPoints() != 0)
+    {
+    cerr << "The points do not have the float type\n";
+    retVal = 1;
+    }
+  pool->ReleasePoints(points);
+  if (pool->GetNumberOfAllocations() != 4 ||
+      pool->GetNumberOfAcquisitions() != 6)
+    {
+    cerr << pool->GetNumberOfAllocations() << " allocations and "
+         << pool->GetNumberOfAcquisitions() << " acquisitions instead of "
+         << "4 and 6\n";
+    retVal = 1;
+    }
+
+  // At most VTK_SCRATCH_POOL_SIZE objects of a kind are kept.
+  vtkGenericCell *cells[VTK_SCRATCH_POOL_SIZE + 10];
+  for (i = 0; i < VTK_SCRATCH_POOL_SIZE + 10; ++i)
+    {
+    cells[i] = pool->AcquireGenericCell();
+    }
+  for (i = 0; i < VTK_SCRATCH_POOL_SIZE + 10; ++i)
+    {
+    pool->ReleaseGenericCell(cells[i]);
+    }
+  unsigned long allocations = pool->GetNumberOfAllocations();
+  for (i = 0; i < VTK_SCRATCH_POOL_SIZE + 10; ++i)
+    {
+    cells[i] = pool->AcquireGenericCell();
+    }
+  for (i = 0; i < VTK_SCRATCH_POOL_SIZE + 10; ++i)
+    {
+    pool->ReleaseGenericCell(cells[i]);
+    }
+  if (pool->GetNumberOfAllocations() - allocations != 10)
+    {
+    cerr << pool->GetNumberOfAllocations() - allocations
+         << " cells allocated again instead of 10\n";
+    retVal = 1;
+    }
+
+  // The totals include the counts of deleted pools.
+  unsigned long totalAllocations =
+    vtkScratchPool::GetTotalNumberOfAllocations();
+  unsigned long totalAcquisitions =
+    vtkScratchPool::GetTotalNumberOfAcquisitions();
+  allocations = pool->GetNumberOfAllocations();
+  pool->Delete();
+  if (vtkScratchPool::GetTotalNumberOfAllocations() != totalAllocations ||
+      vtkScratchPool::GetTotalNumberOfAcquisitions() != totalAcquisitions ||
+      totalAllocations < allocations)
+    {
+    cerr << "The totals changed when a pool was deleted\n";
+    retVal = 1;
+    }
+
+  // Each thread of the task scheduler uses its own pool.
+  TestPoolData data;
+  data.Failed = 0;
+  vtkTaskScheduler::GetGlobalScheduler()->SetNumberOfThreads(4);
+  vtkTaskScheduler::GetGlobalScheduler()->ParallelFor(
+    0, 10000, 10, UsePool, &data);
+  if (data.Failed ||
+      vtkScratchPool::GetTotalNumberOfAcquisitions() - totalAcquisitions !=
+      10000)
+    {
+    cerr << "The pools of the task scheduler threads failed\n";
+    retVal = 1;
+    }
+
+  // The counts of the pools of exited threads are kept.
+  totalAllocations = vtkScratchPool::GetTotalNumberOfAllocations();
+  totalAcquisitions = vtkScratchPool::GetTotalNumberOfAcquisitions();
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  threader->UseTaskSchedulerOff();
+  threader->SetNumberOfThreads(4);
+  threader->SetSingleMethod(UseThreadPool, &data);
+  threader->SingleMethodExecute();
+  threader->Delete();
+  if (vtkScratchPool::GetTotalNumberOfAcquisitions() - totalAcquisitions != 40
+      || vtkScratchPool::GetTotalNumberOfAllocations() - totalAllocations > 40)
+    {
+    cerr << "The counts of the exited threads were lost\n";
+    retVal = 1;
+    }
+
+  // A generic cell keeps the cells of the types it used.
+  vtkGenericCell *cell = vtkGenericCell::New();
+  cell->SetCellType(VTK_TETRA);
+  vtkPoints *tetraPoints = cell->Points;
+  cell->SetCellType(VTK_HEXAHEDRON);
+  if (cell->GetCellType() != VTK_HEXAHEDRON || cell->Points == tetraPoints)
+    {
+    cerr << "The generic cell did not change type\n";
+    retVal = 1;
+    }
+  cell->SetCellType(VTK_TETRA);
+  if (cell->GetCellType() != VTK_TETRA || cell->Points != tetraPoints)
+    {
+    cerr << "The generic cell did not keep its tetrahedron\n";
+    retVal = 1;
+    }
+  vtkObject::GlobalWarningDisplayOff();
+  cell->SetCellType(VTK_CONVEX_POINT_SET + 100);
+  vtkObject::GlobalWarningDisplayOn();
+  if (cell->GetCellType() != VTK_EMPTY_CELL)
+    {
+    cerr << "An unsupported type did not give an empty cell\n";
+    retVal = 1;
+    }
+  cell->Delete();
+
+  // Once the pool of the thread is warm, FindCell() allocates nothing.
+  vtkTestFindCellSource *source = vtkTestFindCellSource::New();
+  for (int pass = 0; pass < 2; ++pass)
+    {
+    source->Modified();
+    source->Update();
+    }
+  vtkInformation *info = source->GetInformation();
+  if (source->NumberOfCellsFound != NUMBER_OF_PROBES ||
+      !info->Has(vtkScratchPool::EXECUTION_ACQUISITIONS()) ||
+      info->Get(vtkScratchPool::EXECUTION_ACQUISITIONS()) <
+      2*NUMBER_OF_PROBES ||
+      info->Get(vtkScratchPool::EXECUTION_ALLOCATIONS()) != 0)
+    {
+    cerr << source->NumberOfCellsFound << " cells found with "
+         << info->Get(vtkScratchPool::EXECUTION_ALLOCATIONS())
+         << " allocations and "
+         << info->Get(vtkScratchPool::EXECUTION_ACQUISITIONS())
+         << " acquisitions\n";
+    retVal = 1;
+    }
+  source->Delete();
+
+  return retVal;
+}
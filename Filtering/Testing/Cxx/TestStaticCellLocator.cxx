@@ -0,0 +1,324 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestStaticCellLocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of vtkStaticCellLocator.
+// .SECTION Description
+// Builds the locator of a grid of distorted tetrahedra, with holes, with
+// one and with four threads and checks that the buckets are the same,
+// and with divisions set by hand, which must be clamped.
+// Compares FindCell(), FindClosestPoint() and IntersectWithLine() with a
+// search of all the cells, and the batch queries with the single ones.
+
+#include "vtkCellType.h"
+#include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMath.h"
+#include "vtkPoints.h"
+#include "vtkStaticCellLocator.h"
+#include "vtkTaskScheduler.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <math.h>
+
+#define GRID_SIZE 12
+#define NUMBER_OF_QUERIES 500
+
+// Six tetrahedra in most cubes of a grid of GRID_SIZE points along each
+// axis, with the inner points moved a little.  A third of the cubes are
+// left empty.
+static vtkUnstructuredGrid *MakeGrid()
+{
+  vtkPoints *points = vtkPoints::New();
+  points->SetDataTypeToDouble();
+  int i, j, k;
+  for (k = 0; k < GRID_SIZE; ++k)
+    {
+    for (j = 0; j < GRID_SIZE; ++j)
+      {
+      for (i = 0; i < GRID_SIZE; ++i)
+        {
+        int inner = i > 0 && j > 0 && k > 0 && i < GRID_SIZE - 1 &&
+          j < GRID_SIZE - 1 && k < GRID_SIZE - 1;
+        double x[3] = { 1.0*i, 0.5*j, 2.0*k };
+        for (int a = 0; inner && a < 3; ++a)
+          {
+          x[a] += vtkMath::Random(-0.075, 0.075);
+          }
+        points->InsertNextPoint(x);
+        }
+      }
+    }
+
+  vtkUnstructuredGrid *grid = vtkUnstructuredGrid::New();
+  grid->SetPoints(points);
+  points->Delete();
+  grid->Allocate(6*(GRID_SIZE-1)*(GRID_SIZE-1)*(GRID_SIZE-1));
+  static const int axes[6][2] =
+    { {0, 1}, {0, 2}, {1, 0}, {1, 2}, {2, 0}, {2, 1} };
+  static const int steps[3] = { 1, GRID_SIZE, GRID_SIZE*GRID_SIZE };
+  for (k = 0; k < GRID_SIZE - 1; ++k)
+    {
+    for (j = 0; j < GRID_SIZE - 1; ++j)
+      {
+      for (i = 0; i < GRID_SIZE - 1; ++i)
+        {
+        if (vtkMath::Random() < 0.33)
+          {
+          continue;
+          }
+        vtkIdType v0 = i + steps[1]*j + steps[2]*k;
+        for (int t = 0; t < 6; ++t)
+          {
+          vtkIdType ids[4];
+          ids[0] = v0;
+          ids[1] = v0 + steps[axes[t][0]];
+          ids[2] = ids[1] + steps[axes[t][1]];
+          ids[3] = v0 + steps[0] + steps[1] + steps[2];
+          grid->InsertNextCell(VTK_TETRA, 4, ids);
+          }
+        }
+      }
+    }
+  return grid;
+}
+
+static int Different(double a, double b)
+{
+  return fabs(a - b) > 1e-9*(1.0 + fabs(a) + fabs(b));
+}
+
+int TestStaticCellLocator(int, char *[])
+{
+  int retVal = 0;
+  vtkTaskScheduler *scheduler = vtkTaskScheduler::GetGlobalScheduler();
+  vtkMath::RandomSeed(8775070);
+  vtkUnstructuredGrid *grid = MakeGrid();
+  vtkIdType numCells = grid->GetNumberOfCells();
+  vtkIdType i, j;
+
+  // Buckets smaller than the cells, so that cells are in several.
+  scheduler->SetNumberOfThreads(1);
+  vtkStaticCellLocator *serial = vtkStaticCellLocator::New();
+  serial->SetNumberOfCellsPerBucket(1);
+  serial->SetDataSet(grid);
+  serial->BuildLocator();
+  scheduler->SetNumberOfThreads(4);
+  vtkStaticCellLocator *locator = vtkStaticCellLocator::New();
+  locator->SetNumberOfCellsPerBucket(1);
+  locator->SetDataSet(grid);
+  locator->BuildLocator();
+
+  // The buckets do not depend on the number of threads.
+  vtkIdList *a = vtkIdList::New();
+  vtkIdList *b = vtkIdList::New();
+  if (locator->GetNumberOfBuckets() != serial->GetNumberOfBuckets() ||
+      locator->GetNumberOfBuckets() < 2)
+    {
+    cerr << locator->GetNumberOfBuckets() << " buckets instead of "
+         << serial->GetNumberOfBuckets() << "\n";
+    retVal = 1;
+    }
+  for (i = 0; !retVal && i < locator->GetNumberOfBuckets(); ++i)
+    {
+    locator->GetBucketCells(i, a);
+    serial->GetBucketCells(i, b);
+    int same = a->GetNumberOfIds() == b->GetNumberOfIds();
+    for (j = 0; same && j < a->GetNumberOfIds(); ++j)
+      {
+      same = a->GetId(j) == b->GetId(j);
+      }
+    if (!same)
+      {
+      cerr << "The cells of bucket " << i << " differ\n";
+      retVal = 1;
+      }
+    }
+  a->Delete();
+  b->Delete();
+  serial->Delete();
+
+  // Points and segments, some of them outside of the grid.
+  vtkPoints *queries = vtkPoints::New();
+  vtkPoints *ends = vtkPoints::New();
+  for (i = 0; i < NUMBER_OF_QUERIES; ++i)
+    {
+    double x[3];
+    x[0] = vtkMath::Random(-1.5, 12.5);
+    x[1] = vtkMath::Random(-0.75, 6.25);
+    x[2] = vtkMath::Random(-3.0, 25.0);
+    queries->InsertNextPoint(x);
+    x[0] = vtkMath::Random(-1.5, 12.5);
+    x[1] = vtkMath::Random(-0.75, 6.25);
+    x[2] = vtkMath::Random(-3.0, 25.0);
+    ends->InsertNextPoint(x);
+    }
+
+  vtkIdTypeArray *found = vtkIdTypeArray::New();
+  locator->FindCells(queries, 1e-12, found);
+  vtkIdTypeArray *closest = vtkIdTypeArray::New();
+  vtkDoubleArray *closestDist2 = vtkDoubleArray::New();
+  vtkPoints *closestPoints = vtkPoints::New();
+  closestPoints->SetDataTypeToDouble();
+  locator->FindClosestPoints(queries, closest, closestDist2, closestPoints);
+  vtkIdTypeArray *hit = vtkIdTypeArray::New();
+  vtkDoubleArray *hitT = vtkDoubleArray::New();
+  locator->IntersectWithLines(queries, ends, 0.0, hit, hitT);
+
+  vtkGenericCell *cell = vtkGenericCell::New();
+  double pcoords[3], weights[4], point[3], d2, t;
+  int subId;
+  vtkIdType cellId;
+  int numFound = 0;
+  int numHits = 0;
+  for (i = 0; i < NUMBER_OF_QUERIES; ++i)
+    {
+    double x[3], end[3];
+    queries->GetPoint(i, x);
+    ends->GetPoint(i, end);
+
+    // Search all the cells.
+    vtkIdType containing = -1;
+    double minDist2 = VTK_DOUBLE_MAX;
+    double minT = VTK_DOUBLE_MAX;
+    for (j = 0; j < numCells; ++j)
+      {
+      grid->GetCell(j, cell);
+      int ret = cell->EvaluatePosition(x, point, subId, pcoords, d2, weights);
+      if (containing < 0 && ret == 1 && d2 <= 1e-12)
+        {
+        containing = j;
+        }
+      if (ret != -1 && d2 < minDist2)
+        {
+        minDist2 = d2;
+        }
+      if (cell->IntersectWithLine(x, end, 0.0, t, point, pcoords, subId) &&
+          t < minT)
+        {
+        minT = t;
+        }
+      }
+
+    cellId = locator->FindCell(x, 1e-12, cell, pcoords, weights);
+    if (cellId != containing || found->GetValue(i) != containing)
+      {
+      cerr << "Query " << i << ": found cell " << cellId << " and "
+           << found->GetValue(i) << " instead of " << containing << "\n";
+      retVal = 1;
+      break;
+      }
+    numFound += (containing >= 0);
+
+    locator->FindClosestPoint(x, point, cell, cellId, subId, d2);
+    double closestPoint[3];
+    closestPoints->GetPoint(i, closestPoint);
+    if (Different(d2, minDist2) || closestDist2->GetValue(i) != d2 ||
+        closest->GetValue(i) != cellId || closestPoint[0] != point[0] ||
+        closestPoint[1] != point[1] || closestPoint[2] != point[2])
+      {
+      cerr << "Query " << i << ": closest cell " << cellId << " at " << d2
+           << " and " << closest->GetValue(i) << " at "
+           << closestDist2->GetValue(i) << " instead of " << minDist2 << "\n";
+      retVal = 1;
+      break;
+      }
+
+    int intersects = locator->IntersectWithLine(x, end, 0.0, t, point,
+                                                pcoords, subId, cellId, cell);
+    if (intersects != (minT < VTK_DOUBLE_MAX) ||
+        (intersects && (Different(t, minT) || hit->GetValue(i) != cellId ||
+                        hitT->GetValue(i) != t)) ||
+        (!intersects && (hit->GetValue(i) != -1 || hitT->GetValue(i) != 0.0)))
+      {
+      cerr << "Query " << i << ": intersection with " << cellId << " at "
+           << t << " and " << hit->GetValue(i) << " at " << hitT->GetValue(i)
+           << " instead of " << minT << "\n";
+      retVal = 1;
+      break;
+      }
+    numHits += intersects;
+
+    // Within a radius smaller than the distance nothing is found.
+    if (minDist2 > 0.01 &&
+        locator->FindClosestPointWithinRadius(x, 0.9*sqrt(minDist2), point,
+                                              cell, cellId, subId, d2))
+      {
+      cerr << "Query " << i << ": cell " << cellId << " found at " << d2
+           << ", beyond the radius\n";
+      retVal = 1;
+      break;
+      }
+    }
+  cout << numFound << " points in cells and " << numHits
+       << " segments intersecting cells\n";
+  if (numFound == 0 || numFound == NUMBER_OF_QUERIES ||
+      numHits == 0 || numHits == NUMBER_OF_QUERIES)
+    {
+    retVal = 1;
+    }
+
+  // Without the cell bounds the same cells are found.
+  locator->CacheCellBoundsOff();
+  vtkIdTypeArray *uncached = vtkIdTypeArray::New();
+  locator->FindCells(queries, 1e-12, uncached);
+  for (i = 0; i < NUMBER_OF_QUERIES; ++i)
+    {
+    if (uncached->GetValue(i) != found->GetValue(i))
+      {
+      cerr << "Query " << i << ": found cell " << uncached->GetValue(i)
+           << " without the cell bounds\n";
+      retVal = 1;
+      break;
+      }
+    }
+
+  // Divisions set by hand are clamped like automatic ones.
+  locator->AutomaticOff();
+  locator->SetDivisions(5000, 0, 3);
+  locator->BuildLocator();
+  int *divs = locator->GetDivisions();
+  if (divs[0] != 1024 || divs[1] != 1 || divs[2] != 3)
+    {
+    cerr << "Divisions " << divs[0] << ", " << divs[1] << ", " << divs[2]
+         << " instead of 1024, 1, 3\n";
+    retVal = 1;
+    }
+  locator->FindCells(queries, 1e-12, uncached);
+  for (i = 0; i < NUMBER_OF_QUERIES; ++i)
+    {
+    if (uncached->GetValue(i) != found->GetValue(i))
+      {
+      cerr << "Query " << i << ": found cell " << uncached->GetValue(i)
+           << " with divisions set by hand\n";
+      retVal = 1;
+      break;
+      }
+    }
+
+  uncached->Delete();
+  cell->Delete();
+  hitT->Delete();
+  hit->Delete();
+  closestPoints->Delete();
+  closestDist2->Delete();
+  closest->Delete();
+  found->Delete();
+  ends->Delete();
+  queries->Delete();
+  locator->Delete();
+  grid->Delete();
+  return retVal;
+}
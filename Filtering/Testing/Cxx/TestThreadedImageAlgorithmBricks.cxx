@@ -0,0 +1,182 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestThreadedImageAlgorithmBricks.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the brick split mode of vtkThreadedImageAlgorithm.
+// .SECTION Description
+// Generates an image in slab and in brick mode and checks that every
+// point gets the same value, and that the recorded bricks cover the
+// extent without overlap.  The number of bricks of a huge extent must
+// be bounded.
+
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkObjectFactory.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkThreadedImageAlgorithm.h"
+
+class vtkTestBrickSource : public vtkThreadedImageAlgorithm
+{
+public:
+  static vtkTestBrickSource *New();
+  vtkTypeRevisionMacro(vtkTestBrickSource,vtkThreadedImageAlgorithm);
+
+protected:
+  vtkTestBrickSource()
+    {
+    this->SetNumberOfInputPorts(0);
+    this->SetNumberOfThreads(4);
+    }
+
+  virtual int RequestInformation(vtkInformation *,
+                                 vtkInformationVector **,
+                                 vtkInformationVector *outputVector)
+    {
+    int wholeExtent[6] = { 0, 63, -5, 40, 2, 20 };
+    vtkInformation *outInfo = outputVector->GetInformationObject(0);
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(),
+                 wholeExtent, 6);
+    vtkDataObject::SetPointDataActiveScalarInfo(outInfo, VTK_DOUBLE, 1);
+    return 1;
+    }
+
+  virtual void ThreadedRequestData(vtkInformation *,
+                                   vtkInformationVector **,
+                                   vtkInformationVector *,
+                                   vtkImageData ***,
+                                   vtkImageData **outData,
+                                   int extent[6], int)
+    {
+    for (int k = extent[4]; k <= extent[5]; ++k)
+      {
+      for (int j = extent[2]; j <= extent[3]; ++j)
+        {
+        double *ptr = static_cast<double *>(
+          outData[0]->GetScalarPointer(extent[0], j, k));
+        for (int i = extent[0]; i <= extent[1]; ++i)
+          {
+          *ptr++ = i + 100.0*j + 10000.0*k;
+          }
+        }
+      }
+    }
+
+private:
+  vtkTestBrickSource(const vtkTestBrickSource&);  // Not implemented.
+  void operator=(const vtkTestBrickSource&);  // Not implemented.
+};
+
+vtkCxxRevisionMacro(vtkTestBrickSource, "1.1");
+vtkStandardNewMacro(vtkTestBrickSource);
+
+static int CheckBrickImage(vtkImageData *image, const char *mode)
+{
+  int extent[6];
+  image->GetExtent(extent);
+  for (int k = extent[4]; k <= extent[5]; ++k)
+    {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+      {
+      for (int i = extent[0]; i <= extent[1]; ++i)
+        {
+        double value = image->GetScalarComponentAsDouble(i, j, k, 0);
+        if (value != i + 100.0*j + 10000.0*k)
+          {
+          cerr << mode << ": wrong value " << value << " at "
+               << i << ", " << j << ", " << k << "\n";
+          return 1;
+          }
+        }
+      }
+    }
+  return 0;
+}
+
+int TestThreadedImageAlgorithmBricks(int,char *[])
+{
+  int retVal = 0;
+  vtkTestBrickSource *source = vtkTestBrickSource::New();
+
+  source->Update();
+  retVal |= CheckBrickImage(source->GetOutput(), "Slab");
+  if (source->GetNumberOfPieces() != 0)
+    {
+    cerr << "Slab mode recorded " << source->GetNumberOfPieces()
+         << " pieces\n";
+    retVal = 1;
+    }
+
+  // 2048 bytes is 256 doubles: four rows of 64 points.
+  source->SetSplitModeToBrick();
+  source->SetDesiredBytesPerPiece(2048);
+  source->Modified();
+  source->Update();
+  retVal |= CheckBrickImage(source->GetOutput(), "Brick");
+
+  int numPieces = source->GetNumberOfPieces();
+  if (numPieces != 12*19)
+    {
+    cerr << "Brick mode used " << numPieces << " pieces, expected "
+         << 12*19 << "\n";
+    retVal = 1;
+    }
+  vtkIdType points = 0;
+  for (int piece = 0; piece < numPieces; ++piece)
+    {
+    int ext[6];
+    source->GetPieceExtent(piece, ext);
+    points += static_cast<vtkIdType>(ext[1] - ext[0] + 1) *
+      (ext[3] - ext[2] + 1) * (ext[5] - ext[4] + 1);
+    if (source->GetPieceTime(piece) < 0.0)
+      {
+      cerr << "Negative time for piece " << piece << "\n";
+      retVal = 1;
+      }
+    }
+  if (points != source->GetOutput()->GetNumberOfPoints())
+    {
+    cerr << "Bricks cover " << points << " points, expected "
+         << source->GetOutput()->GetNumberOfPoints() << "\n";
+    retVal = 1;
+    }
+
+  // Bricks smaller than a row split the rows as well.
+  source->SetDesiredBytesPerPiece(100);
+  source->Modified();
+  source->Update();
+  retVal |= CheckBrickImage(source->GetOutput(), "Small brick");
+
+  // Tiny bricks of a huge extent are made larger to bound their number.
+  int hugeExtent[6] = { 0, 99999, 0, 99999, 0, 9999 };
+  int brickSize[3];
+  source->SetDesiredBytesPerPiece(1);
+  int numBricks = source->ComputeBrickSize(hugeExtent, 1, brickSize);
+  vtkIdType expected = 1;
+  for (int i = 0; i < 3; ++i)
+    {
+    int size = hugeExtent[2*i+1] - hugeExtent[2*i] + 1;
+    expected *= (size + brickSize[i] - 1) / brickSize[i];
+    }
+  if (numBricks < 1 || numBricks > VTK_THREADED_IMAGE_MAX_BRICKS ||
+      numBricks != expected)
+    {
+    cerr << "A huge extent was split into " << numBricks << " bricks of "
+         << brickSize[0] << "x" << brickSize[1] << "x" << brickSize[2]
+         << "\n";
+    retVal = 1;
+    }
+
+  source->Delete();
+  return retVal;
+}
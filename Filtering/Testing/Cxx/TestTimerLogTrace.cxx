@@ -0,0 +1,235 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestTimerLogTrace.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the trace of nested scopes recorded by vtkTimerLog.
+// .SECTION Description
+// Records nested scopes on the main thread and on the threads of the
+// task scheduler, checks that nothing is recorded when tracing is off,
+// that every scope is closed on the thread that opened it, and that
+// names are escaped in the JSON output.  Then updates a threaded image
+// source and checks that the executive and the algorithm scopes are in
+// the trace.
+
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkObjectFactory.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTaskScheduler.h"
+#include "vtkThreadedImageAlgorithm.h"
+#include "vtkTimerLog.h"
+#include "vtksys/SystemTools.hxx"
+
+#include <vtksys/ios/sstream>
+#include <vtkstd/map>
+#include <vtkstd/string>
+
+class vtkTestTraceSource : public vtkThreadedImageAlgorithm
+{
+public:
+  static vtkTestTraceSource *New();
+  vtkTypeRevisionMacro(vtkTestTraceSource,vtkThreadedImageAlgorithm);
+
+protected:
+  vtkTestTraceSource()
+    {
+    this->SetNumberOfInputPorts(0);
+    this->SetNumberOfThreads(4);
+    }
+
+  virtual int RequestInformation(vtkInformation *,
+                                 vtkInformationVector **,
+                                 vtkInformationVector *outputVector)
+    {
+    int wholeExtent[6] = { 0, 31, 0, 31, 0, 31 };
+    vtkInformation *outInfo = outputVector->GetInformationObject(0);
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(),
+                 wholeExtent, 6);
+    vtkDataObject::SetPointDataActiveScalarInfo(outInfo, VTK_FLOAT, 1);
+    return 1;
+    }
+
+  virtual void ThreadedRequestData(vtkInformation *,
+                                   vtkInformationVector **,
+                                   vtkInformationVector *,
+                                   vtkImageData ***,
+                                   vtkImageData **outData,
+                                   int extent[6], int)
+    {
+    for (int k = extent[4]; k <= extent[5]; ++k)
+      {
+      for (int j = extent[2]; j <= extent[3]; ++j)
+        {
+        float *ptr = static_cast<float *>(
+          outData[0]->GetScalarPointer(extent[0], j, k));
+        for (int i = extent[0]; i <= extent[1]; ++i)
+          {
+          *ptr++ = static_cast<float>(i + j + k);
+          }
+        }
+      }
+    }
+
+private:
+  vtkTestTraceSource(const vtkTestTraceSource&);  // Not implemented.
+  void operator=(const vtkTestTraceSource&);  // Not implemented.
+};
+
+vtkCxxRevisionMacro(vtkTestTraceSource, "1.1");
+vtkStandardNewMacro(vtkTestTraceSource);
+
+static void TraceRange(void *, vtkIdType begin, vtkIdType end)
+{
+  for (vtkIdType i = begin; i < end; ++i)
+    {
+    vtkTimerLogTraceScope outer("Test", "Outer");
+    vtkTimerLogTraceScope inner("Test", "Inner");
+    }
+}
+
+// Check that the opening and closing events of each thread in the
+// trace nest properly, and return the number of opening events.
+static int CheckNesting(const vtkstd::string& trace)
+{
+  vtkstd::map<vtkstd::string, int> depths;
+  int opened = 0;
+  vtksys_ios::istringstream lines(trace);
+  vtkstd::string line;
+  while (vtkstd::getline(lines, line))
+    {
+    vtkstd::string::size_type tid = line.find("\"tid\":");
+    if (tid == vtkstd::string::npos)
+      {
+      continue;
+      }
+    vtkstd::string thread = line.substr(tid, line.find('}', tid) - tid);
+    if (line.find("\"ph\":\"B\"") != vtkstd::string::npos)
+      {
+      ++depths[thread];
+      ++opened;
+      }
+    else if (line.find("\"ph\":\"E\"") != vtkstd::string::npos &&
+             --depths[thread] < 0)
+      {
+      return -1;
+      }
+    }
+  for (vtkstd::map<vtkstd::string, int>::iterator i = depths.begin();
+       i != depths.end(); ++i)
+    {
+    if (i->second != 0)
+      {
+      return -1;
+      }
+    }
+  return opened;
+}
+
+int TestTimerLogTrace(int, char *[])
+{
+  int retVal = 0;
+  vtkTaskScheduler::GetGlobalScheduler()->SetNumberOfThreads(4);
+
+  // Nothing is recorded while tracing is off, and unmatched ends are
+  // ignored.
+  vtkTimerLog::ResetTrace();
+  vtkTimerLog::MarkStartTraceEvent("Test", "Ignored");
+  vtkTimerLog::MarkEndTraceEvent();
+  vtkTimerLog::TracingOn();
+  vtkTimerLog::MarkEndTraceEvent();
+  if (vtkTimerLog::GetNumberOfTraceEvents() != 0)
+    {
+    cerr << "Events were recorded while tracing was off\n";
+    retVal = 1;
+    }
+
+  // Nested scopes on several threads.
+  {
+  vtkTimerLogTraceScope scope("Test", "Quoted \"name\" with \\ and\ttab");
+  vtkTaskScheduler::GetGlobalScheduler()->ParallelFor(0, 1000, 10,
+                                                      TraceRange, 0);
+  }
+  if (vtkTimerLog::GetNumberOfTraceEvents() != 2 + 4*1000)
+    {
+    cerr << "Expected " << 2 + 4*1000 << " events, got "
+         << vtkTimerLog::GetNumberOfTraceEvents() << "\n";
+    retVal = 1;
+    }
+  vtksys_ios::ostringstream trace;
+  vtkTimerLog::DumpTrace(trace);
+  if (CheckNesting(trace.str()) != 1 + 2*1000)
+    {
+    cerr << "The scopes of the threads do not nest\n";
+    retVal = 1;
+    }
+  if (trace.str().find("\"Quoted \\\"name\\\" with \\\\ and\\u0009tab\"") ==
+      vtkstd::string::npos)
+    {
+    cerr << "The name was not escaped\n";
+    retVal = 1;
+    }
+  cout << vtkTimerLog::GetNumberOfTraceThreads() << " threads traced\n";
+
+  // Scopes opened while tracing are closed after it is turned off.
+  vtkTimerLog::ResetTrace();
+  {
+  vtkTimerLogTraceScope scope("Test", "Open");
+  vtkTimerLog::TracingOff();
+  vtkTimerLogTraceScope ignored("Test", "Ignored");
+  }
+  if (vtkTimerLog::GetNumberOfTraceEvents() != 2)
+    {
+    cerr << "The open scope was not closed after tracing was turned off\n";
+    retVal = 1;
+    }
+
+  // The executives trace the pipeline passes and the requests.
+  vtkTimerLog::ResetTrace();
+  vtkTimerLog::TracingOn();
+  vtkTestTraceSource *source = vtkTestTraceSource::New();
+  source->Update();
+  vtkTimerLog::TracingOff();
+  source->Delete();
+  const char *fileName = "TestTimerLogTrace.json";
+  if (!vtkTimerLog::WriteTrace(fileName))
+    {
+    cerr << "Could not write " << fileName << "\n";
+    retVal = 1;
+    }
+  vtksys_ios::ostringstream pipelineTrace;
+  vtkTimerLog::DumpTrace(pipelineTrace);
+  const char *names[5] = {
+    "\"vtkTestTraceSource::UpdateInformation\",\"cat\":\"Executive\"",
+    "\"vtkTestTraceSource::PropagateUpdateExtent\",\"cat\":\"Executive\"",
+    "\"vtkTestTraceSource::UpdateData\",\"cat\":\"Executive\"",
+    "\"vtkTestTraceSource::RequestData\",\"cat\":\"Algorithm\"",
+    "\"vtkTestTraceSource::ThreadedRequestData\",\"cat\":\"Algorithm\"" };
+  for (int i = 0; i < 5; ++i)
+    {
+    if (pipelineTrace.str().find(names[i]) == vtkstd::string::npos)
+      {
+      cerr << "The trace has no scope " << names[i] << "\n";
+      retVal = 1;
+      }
+    }
+  if (CheckNesting(pipelineTrace.str()) <= 0)
+    {
+    cerr << "The scopes of the pipeline do not nest\n";
+    retVal = 1;
+    }
+  vtksys::SystemTools::RemoveFile(fileName);
+  vtkTimerLog::ResetTrace();
+
+  return retVal;
+}
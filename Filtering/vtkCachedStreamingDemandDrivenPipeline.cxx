@@ -20,78 +20,305 @@
 
 #include "vtkAlgorithm.h"
 #include "vtkAlgorithmOutput.h"
-#include "vtkImageData.h"
+#include "vtkCellData.h"
+#include "vtkDataSet.h"
 #include "vtkInformation.h"
+#include "vtkInformationDoubleKey.h"
 #include "vtkInformationVector.h"
 #include "vtkPointData.h"
 
+#include <vtkstd/list>
+#include <vtkstd/vector>
+
 vtkCxxRevisionMacro(vtkCachedStreamingDemandDrivenPipeline, "1.6");
 vtkStandardNewMacro(vtkCachedStreamingDemandDrivenPipeline);
 
+//----------------------------------------------------------------------------
+// A retained output and the request it satisfies.
+class vtkCachedStreamingDemandDrivenPipelineEntry
+{
+public:
+  vtkDataObject* Data;
+  unsigned long Time; // update time of the output it was copied from
+  unsigned long Size; // in kilobytes
+
+  int ExtentType;
+  int Piece;
+  int NumberOfPieces;
+  int GhostLevel;
+  int Extent[6];
+  int HasTimeIndex;
+  int TimeIndex;
+  // Whether the output information had each cache key, and its value.
+  vtkstd::vector<int> KeyValues;
+
+  vtkCachedStreamingDemandDrivenPipelineEntry()
+    {
+    this->Data = 0;
+    this->Time = 0;
+    this->Size = 0;
+    this->ExtentType = -1; // satisfies nothing
+    this->Piece = this->NumberOfPieces = this->GhostLevel = 0;
+    for(int i=0; i < 6; ++i)
+      {
+      this->Extent[i] = 0;
+      }
+    this->HasTimeIndex = this->TimeIndex = 0;
+    }
+
+  // Return whether this entry satisfies the request, that is whether it
+  // has the same piece, or an extent containing the non-empty requested
+  // extent, and the same time index and cache key values.
+  int Satisfies(const vtkCachedStreamingDemandDrivenPipelineEntry& request)
+    const
+    {
+    if(this->ExtentType != request.ExtentType ||
+       this->HasTimeIndex != request.HasTimeIndex ||
+       (this->HasTimeIndex && this->TimeIndex != request.TimeIndex) ||
+       this->KeyValues != request.KeyValues)
+      {
+      return 0;
+      }
+    if(this->ExtentType == VTK_PIECES_EXTENT)
+      {
+      return (this->Piece == request.Piece &&
+              this->NumberOfPieces == request.NumberOfPieces &&
+              this->GhostLevel == request.GhostLevel);
+      }
+    if(this->ExtentType == VTK_3D_EXTENT)
+      {
+      const int* ue = request.Extent;
+      return (ue[0] <= ue[1] && ue[2] <= ue[3] && ue[4] <= ue[5] &&
+              ue[0] >= this->Extent[0] && ue[1] <= this->Extent[1] &&
+              ue[2] >= this->Extent[2] && ue[3] <= this->Extent[3] &&
+              ue[4] >= this->Extent[4] && ue[5] <= this->Extent[5]);
+      }
+    return 0;
+    }
+};
+
+//----------------------------------------------------------------------------
+class vtkCachedStreamingDemandDrivenPipelineInternals
+{
+public:
+  typedef vtkstd::list<vtkCachedStreamingDemandDrivenPipelineEntry>
+    EntriesType;
+
+  // The retained outputs, the most recently used first.
+  EntriesType Entries;
+  unsigned long MemorySize;
+
+  vtkstd::vector<vtkInformationIntegerKey*> Keys;
+
+  // What the output holds, valid while its update time is OutputTime.
+  // A request that it satisfies is neither a hit nor a miss.
+  vtkCachedStreamingDemandDrivenPipelineEntry Output;
+  unsigned long OutputTime;
+
+  vtkCachedStreamingDemandDrivenPipelineInternals()
+    {
+    this->MemorySize = 0;
+    this->OutputTime = 0;
+    }
+
+  ~vtkCachedStreamingDemandDrivenPipelineInternals()
+    {
+    while(!this->Entries.empty())
+      {
+      this->Remove(this->Entries.begin());
+      }
+    }
+
+  void Remove(EntriesType::iterator it)
+    {
+    it->Data->Delete();
+    this->MemorySize -= it->Size;
+    this->Entries.erase(it);
+    }
+
+  // Fill the request part of entry from the output information.
+  void GetRequest(vtkInformation* outInfo, int extentType,
+                  vtkCachedStreamingDemandDrivenPipelineEntry& entry)
+    {
+    typedef vtkStreamingDemandDrivenPipeline SDDP;
+    entry.ExtentType = extentType;
+    entry.Piece = outInfo->Get(SDDP::UPDATE_PIECE_NUMBER());
+    entry.NumberOfPieces = outInfo->Get(SDDP::UPDATE_NUMBER_OF_PIECES());
+    entry.GhostLevel = outInfo->Get(SDDP::UPDATE_NUMBER_OF_GHOST_LEVELS());
+    if(extentType == VTK_3D_EXTENT)
+      {
+      outInfo->Get(SDDP::UPDATE_EXTENT(), entry.Extent);
+      }
+    else
+      {
+      for(int i=0; i < 6; ++i)
+        {
+        entry.Extent[i] = 0;
+        }
+      }
+    entry.HasTimeIndex = outInfo->Has(SDDP::UPDATE_TIME_INDEX());
+    entry.TimeIndex =
+      entry.HasTimeIndex? outInfo->Get(SDDP::UPDATE_TIME_INDEX()) : 0;
+    entry.KeyValues.clear();
+    for(unsigned int k=0; k < this->Keys.size(); ++k)
+      {
+      int has = outInfo->Has(this->Keys[k]);
+      entry.KeyValues.push_back(has);
+      entry.KeyValues.push_back(has? outInfo->Get(this->Keys[k]) : 0);
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+// Share the data of from with to.  Datasets copy their structure and
+// attributes so that a retained copy does not get pipeline information.
+static void vtkCachedStreamingDemandDrivenPipelineCopy(vtkDataObject* from,
+                                                       vtkDataObject* to)
+{
+  vtkDataSet* fromDS = vtkDataSet::SafeDownCast(from);
+  vtkDataSet* toDS = vtkDataSet::SafeDownCast(to);
+  if(fromDS && toDS)
+    {
+    toDS->CopyStructure(fromDS);
+    toDS->GetPointData()->ShallowCopy(fromDS->GetPointData());
+    toDS->GetCellData()->ShallowCopy(fromDS->GetCellData());
+    if(from->GetFieldData() && to->GetFieldData())
+      {
+      to->GetFieldData()->ShallowCopy(from->GetFieldData());
+      }
+    }
+  else
+    {
+    to->ShallowCopy(from);
+    }
+  vtkInformation* fromInfo = from->GetInformation();
+  vtkInformation* toInfo = to->GetInformation();
+  toInfo->CopyEntry(fromInfo, vtkDataObject::DATA_TIME_INDEX());
+  toInfo->CopyEntry(fromInfo, vtkDataObject::DATA_TIME());
+}
 
 //----------------------------------------------------------------------------
 vtkCachedStreamingDemandDrivenPipeline
 ::vtkCachedStreamingDemandDrivenPipeline()
 {
-  this->CacheSize = 0;
-  this->Data = NULL;
-  this->Times = NULL;
-  
-  this->SetCacheSize(10);
+  this->CachedStreamingDemandDrivenInternal =
+    new vtkCachedStreamingDemandDrivenPipelineInternals;
+  this->CacheSize = 10;
+  this->CacheMemoryLimit = 0;
+  this->NumberOfCacheHits = 0;
+  this->NumberOfCacheMisses = 0;
+  this->NumberOfCacheEvictions = 0;
 }
 
 //----------------------------------------------------------------------------
 vtkCachedStreamingDemandDrivenPipeline
 ::~vtkCachedStreamingDemandDrivenPipeline()
 {
-  this->SetCacheSize(0);
+  delete this->CachedStreamingDemandDrivenInternal;
 }
 
 //----------------------------------------------------------------------------
 void vtkCachedStreamingDemandDrivenPipeline::SetCacheSize(int size)
 {
-  int idx;
-  
   if (size == this->CacheSize)
     {
     return;
     }
   
   this->Modified();
-  
-  // free the old data
-  for (idx = 0; idx < this->CacheSize; ++idx)
+  this->CacheSize = size;
+  this->TrimCache(this->CacheSize,
+                  this->CacheMemoryLimit? this->CacheMemoryLimit :
+                  VTK_UNSIGNED_LONG_MAX);
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedStreamingDemandDrivenPipeline
+::SetCacheMemoryLimit(unsigned long limit)
+{
+  if (limit == this->CacheMemoryLimit)
     {
-    if (this->Data[idx])
-      {
-      this->Data[idx]->Delete();
-      this->Data[idx] = NULL;
-      }
+    return;
     }
-  if (this->Data)
+  
+  this->Modified();
+  this->CacheMemoryLimit = limit;
+  this->TrimCache(this->CacheSize,
+                  this->CacheMemoryLimit? this->CacheMemoryLimit :
+                  VTK_UNSIGNED_LONG_MAX);
+}
+
+//----------------------------------------------------------------------------
+int vtkCachedStreamingDemandDrivenPipeline::GetNumberOfCachedDataObjects()
+{
+  return static_cast<int>(
+    this->CachedStreamingDemandDrivenInternal->Entries.size());
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkCachedStreamingDemandDrivenPipeline::GetCacheMemorySize()
+{
+  return this->CachedStreamingDemandDrivenInternal->MemorySize;
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedStreamingDemandDrivenPipeline
+::AddCacheKey(vtkInformationIntegerKey* key)
+{
+  if(key)
     {
-    delete [] this->Data;
-    this->Data = NULL;
+    this->CachedStreamingDemandDrivenInternal->Keys.push_back(key);
+    this->Modified();
     }
-  if (this->Times)
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedStreamingDemandDrivenPipeline::RemoveAllCacheKeys()
+{
+  if(!this->CachedStreamingDemandDrivenInternal->Keys.empty())
     {
-    delete [] this->Times;
-    this->Times = NULL;
+    this->CachedStreamingDemandDrivenInternal->Keys.clear();
+    this->Modified();
     }
-  
-  this->CacheSize = size;
-  if (size == 0)
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedStreamingDemandDrivenPipeline::ResetCacheStatistics()
+{
+  this->NumberOfCacheHits = 0;
+  this->NumberOfCacheMisses = 0;
+  this->NumberOfCacheEvictions = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedStreamingDemandDrivenPipeline::TrimCache(int maxSize,
+                                                       unsigned long maxMemory)
+{
+  vtkCachedStreamingDemandDrivenPipelineInternals* internal =
+    this->CachedStreamingDemandDrivenInternal;
+
+  // Outputs computed before the pipeline was modified are not valid.
+  unsigned long pmt = this->GetPipelineMTime();
+  vtkCachedStreamingDemandDrivenPipelineInternals::EntriesType::iterator it =
+    internal->Entries.begin();
+  while(it != internal->Entries.end())
     {
-    return;
+    if(it->Time < pmt)
+      {
+      internal->Remove(it++);
+      }
+    else
+      {
+      ++it;
+      }
     }
-  
-  this->Data = new vtkDataObject* [size];
-  this->Times = new unsigned long [size];
 
-  for (idx = 0; idx < size; ++idx)
+  while(!internal->Entries.empty() &&
+        (static_cast<int>(internal->Entries.size()) > maxSize ||
+         internal->MemorySize > maxMemory))
     {
-    this->Data[idx] = NULL;
-    this->Times[idx] = 0;
+    internal->Remove(--internal->Entries.end());
+    ++this->NumberOfCacheEvictions;
     }
 }
 
@@ -101,6 +328,14 @@ void vtkCachedStreamingDemandDrivenPipeline
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "CacheSize: " << this->CacheSize << "\n";
+  os << indent << "CacheMemoryLimit: " << this->CacheMemoryLimit << "\n";
+  os << indent << "NumberOfCachedDataObjects: "
+     << this->GetNumberOfCachedDataObjects() << "\n";
+  os << indent << "CacheMemorySize: " << this->GetCacheMemorySize() << "\n";
+  os << indent << "NumberOfCacheHits: " << this->NumberOfCacheHits << "\n";
+  os << indent << "NumberOfCacheMisses: " << this->NumberOfCacheMisses << "\n";
+  os << indent << "NumberOfCacheEvictions: "
+     << this->NumberOfCacheEvictions << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -163,18 +398,12 @@ int vtkCachedStreamingDemandDrivenPipeline
     return 1;
     }
 
-  // First look through the cached data to see if it is still valid.
-  int i;
-  unsigned long pmt = this->GetPipelineMTime();
-  for (i = 0; i < this->CacheSize; ++i)
-    {
-    if (this->Data[i] && this->Times[i] < pmt)
-      {
-      this->Data[i]->Delete();
-      this->Data[i] = NULL;
-      this->Times[i] = 0;
-      }
-    }
+  // First remove the cached data that is no longer valid.
+  vtkCachedStreamingDemandDrivenPipelineInternals* internal =
+    this->CachedStreamingDemandDrivenInternal;
+  this->TrimCache(this->CacheSize,
+                  this->CacheMemoryLimit? this->CacheMemoryLimit :
+                  VTK_UNSIGNED_LONG_MAX);
 
   // We need to check the requested update extent.  Get the output
   // port information and data information.  We do not need to check
@@ -183,79 +412,34 @@ int vtkCachedStreamingDemandDrivenPipeline
   vtkInformation* outInfo = outInfoVec->GetInformationObject(outputPort);
   vtkDataObject* dataObject = outInfo->Get(vtkDataObject::DATA_OBJECT());
   vtkInformation* dataInfo = dataObject->GetInformation();
-  if(dataInfo->Get(vtkDataObject::DATA_EXTENT_TYPE()) == VTK_PIECES_EXTENT)
-    {
-    int updatePiece = outInfo->Get(UPDATE_PIECE_NUMBER());
-    int updateNumberOfPieces = outInfo->Get(UPDATE_NUMBER_OF_PIECES());
-    int updateGhostLevel = outInfo->Get(UPDATE_NUMBER_OF_GHOST_LEVELS());
+  vtkCachedStreamingDemandDrivenPipelineEntry request;
+  internal->GetRequest(outInfo,
+                       dataInfo->Get(vtkDataObject::DATA_EXTENT_TYPE()),
+                       request);
 
-    // check to see if any data in the cache fits this request
-    for (i = 0; i < this->CacheSize; ++i)
-      {
-      if (this->Data[i])
-        {
-        dataInfo = this->Data[i]->GetInformation();
-        
-        // Check the unstructured extent.  If we do not have the requested
-        // piece, we need to execute.
-        int dataPiece = dataInfo->Get(vtkDataObject::DATA_PIECE_NUMBER());
-        int dataNumberOfPieces = 
-          dataInfo->Get(vtkDataObject::DATA_NUMBER_OF_PIECES());
-        int dataGhostLevel = 
-          dataInfo->Get(vtkDataObject::DATA_NUMBER_OF_GHOST_LEVELS());
-        if (dataInfo->Get(vtkDataObject::DATA_EXTENT_TYPE()) == 
-            VTK_PIECES_EXTENT && dataPiece == updatePiece &&
-            dataNumberOfPieces == updateNumberOfPieces &&
-            dataGhostLevel == updateGhostLevel)
-          {
-          // we have a matching data we must copy it to our output, but for
-          // now we don't support polydata
-          return 1;
-          }
-        }
-      }
+  // Does the output already have it?
+  if(internal->OutputTime == dataObject->GetUpdateTime() &&
+     internal->Output.Satisfies(request))
+    {
+    return 0;
     }
-  else if (dataInfo->Get(vtkDataObject::DATA_EXTENT_TYPE()) == VTK_3D_EXTENT)
+
+  // check to see if any data in the cache fits this request
+  vtkCachedStreamingDemandDrivenPipelineInternals::EntriesType::iterator it;
+  for(it = internal->Entries.begin(); it != internal->Entries.end(); ++it)
     {
-    // Check the structured extent.  If the update extent is outside
-    // of the extent and not empty, we need to execute.
-    int dataExtent[6];
-    int updateExtent[6];
-    outInfo->Get(UPDATE_EXTENT(), updateExtent);
-
-    // check to see if any data in the cache fits this request
-    for (i = 0; i < this->CacheSize; ++i)
+    if(it->Satisfies(request))
       {
-      if (this->Data[i])
-        {
-        dataInfo = this->Data[i]->GetInformation();
-        dataInfo->Get(vtkDataObject::DATA_EXTENT(), dataExtent);
-        if(dataInfo->Get(vtkDataObject::DATA_EXTENT_TYPE()) == 
-           VTK_3D_EXTENT &&
-           !(updateExtent[0] < dataExtent[0] ||
-             updateExtent[1] > dataExtent[1] ||
-             updateExtent[2] < dataExtent[2] ||
-             updateExtent[3] > dataExtent[3] ||
-             updateExtent[4] < dataExtent[4] ||
-             updateExtent[5] > dataExtent[5]) &&
-           (updateExtent[0] <= updateExtent[1] &&
-            updateExtent[2] <= updateExtent[3] &&
-            updateExtent[4] <= updateExtent[5]))
-          {
-          // we have a match
-          // Pass this data to output.
-          vtkImageData *id = vtkImageData::SafeDownCast(dataObject);
-          vtkImageData *id2 = vtkImageData::SafeDownCast(this->Data[i]);
-          if (id && id2)
-            {
-            id->SetExtent(dataExtent);
-            id->GetPointData()->PassData(id2->GetPointData());
-            // not sure if we need this
-            dataObject->DataHasBeenGenerated();
-            return 0;
-            }
-          }
-        }
+      // Make it the most recently used and pass its data to the output.
+      internal->Entries.splice(internal->Entries.begin(),
+                               internal->Entries, it);
+      vtkCachedStreamingDemandDrivenPipelineCopy(it->Data, dataObject);
+      dataObject->DataHasBeenGenerated();
+      internal->Output = *it;
+      internal->Output.Data = 0;
+      internal->OutputTime = dataObject->GetUpdateTime();
+      ++this->NumberOfCacheHits;
+      return 0;
       }
     }
   
@@ -263,7 +447,6 @@ int vtkCachedStreamingDemandDrivenPipeline
   return 1;
 }
 
-
 //----------------------------------------------------------------------------
 int vtkCachedStreamingDemandDrivenPipeline
 ::ExecuteData(vtkInformation* request,
@@ -278,60 +461,57 @@ int vtkCachedStreamingDemandDrivenPipeline
     }
   
   // first do the ususal thing
+  ++this->NumberOfCacheMisses;
   int result = this->Superclass::ExecuteData(request, inInfoVec, outInfoVec);
-  
-  // then save the newly generated data
-  unsigned long bestTime = VTK_LARGE_INTEGER;
-  int bestIdx = 0;
-  
-  // Save the image in cache.
-  // Find a spot to put the data.
-  for (int i = 0; i < this->CacheSize; ++i)
-    {
-    if (this->Data[i] == NULL)
-      {
-      bestIdx = i;
-      bestTime = 0;
-      break;
-      }
-    if (this->Times[i] < bestTime)
-      {
-      bestIdx = i;
-      bestTime = this->Times[i];
-      }
-    }
 
+  // then save the newly generated data.  It has the extent or the piece
+  // that was generated, and the time index and cache keys that were
+  // requested.
+  vtkCachedStreamingDemandDrivenPipelineInternals* internal =
+    this->CachedStreamingDemandDrivenInternal;
   vtkInformation* outInfo = outInfoVec->GetInformationObject(0);
   vtkDataObject* dataObject = outInfo->Get(vtkDataObject::DATA_OBJECT());
-  if (this->Data[bestIdx] == NULL)
+  vtkInformation* dataInfo = dataObject->GetInformation();
+  vtkCachedStreamingDemandDrivenPipelineEntry& entry = internal->Output;
+  int extentType = dataInfo->Get(vtkDataObject::DATA_EXTENT_TYPE());
+  internal->GetRequest(outInfo, extentType, entry);
+  if (extentType == VTK_PIECES_EXTENT)
     {
-    this->Data[bestIdx] = dataObject->NewInstance();
+    entry.Piece = dataInfo->Get(vtkDataObject::DATA_PIECE_NUMBER());
+    entry.NumberOfPieces =
+      dataInfo->Get(vtkDataObject::DATA_NUMBER_OF_PIECES());
+    entry.GhostLevel =
+      dataInfo->Get(vtkDataObject::DATA_NUMBER_OF_GHOST_LEVELS());
+    }
+  else if (extentType == VTK_3D_EXTENT)
+    {
+    dataInfo->Get(vtkDataObject::DATA_EXTENT(), entry.Extent);
+    }
+  internal->OutputTime = result? dataObject->GetUpdateTime() : 0;
+  if (!result || this->CacheSize <= 0)
+    {
+    return result;
     }
-  this->Data[bestIdx]->ReleaseData();
 
-  vtkImageData *id = vtkImageData::SafeDownCast(dataObject);  
-  if (id)
+  entry.Data = dataObject->NewInstance();
+  vtkCachedStreamingDemandDrivenPipelineCopy(dataObject, entry.Data);
+  entry.Time = dataObject->GetUpdateTime();
+  entry.Size = entry.Data->GetActualMemorySize();
+
+  // Make room for it, unless it does not fit at all.
+  unsigned long limit =
+    this->CacheMemoryLimit? this->CacheMemoryLimit : VTK_UNSIGNED_LONG_MAX;
+  if (entry.Size <= limit)
     {
-    vtkInformation* inInfo = inInfoVec[0]->GetInformationObject(0);
-    vtkImageData *input = 
-      vtkImageData::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
-    id->SetExtent(input->GetExtent());
-    id->GetPointData()->PassData(input->GetPointData());
-    id->DataHasBeenGenerated();
+    this->TrimCache(this->CacheSize - 1, limit - entry.Size);
+    internal->Entries.push_front(entry);
+    internal->MemorySize += entry.Size;
     }
-  
-  vtkImageData *id2 = vtkImageData::SafeDownCast(this->Data[bestIdx]);
-  if (id && id2)
+  else
     {
-    id2->SetExtent(id->GetExtent());
-    id2->SetScalarType(id->GetScalarType());
-    id2->SetNumberOfScalarComponents(
-      id->GetNumberOfScalarComponents());
-    id2->GetPointData()->SetScalars(
-      id->GetPointData()->GetScalars());
+    entry.Data->Delete();
     }
-  
-  this->Times[bestIdx] = dataObject->GetUpdateTime();
+  entry.Data = 0;
   
   return result;
 }
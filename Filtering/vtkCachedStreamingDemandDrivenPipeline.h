@@ -12,9 +12,22 @@
      PURPOSE.  See the above copyright notice for more information.
 
 =========================================================================*/
-// .NAME vtkCachedStreamingDemandDrivenPipeline -
+// .NAME vtkCachedStreamingDemandDrivenPipeline - executive that keeps previous outputs
 // .SECTION Description
-// vtkCachedStreamingDemandDrivenPipeline
+// vtkCachedStreamingDemandDrivenPipeline keeps shallow copies of the
+// outputs of its algorithm and gives one back instead of executing when
+// it satisfies a new request.  A cached output satisfies a request when
+// it has the requested piece, number of pieces and ghost level, or an
+// extent that contains the requested update extent, and the same time
+// index and values of the keys given to AddCacheKey().  Scrubbing back
+// and forth through time steps or panning over an extent is then served
+// from memory.
+//
+// The least recently used outputs are removed when there are more than
+// CacheSize of them, or when together they take more than
+// CacheMemoryLimit, as measured by vtkDataObject::GetActualMemorySize().
+// All of them are removed when the pipeline is modified.  The numbers of
+// hits, misses and evictions tell how well the cache works.
 
 #ifndef __vtkCachedStreamingDemandDrivenPipeline_h
 #define __vtkCachedStreamingDemandDrivenPipeline_h
@@ -45,6 +58,37 @@ public:
   void SetCacheSize(int size);
   vtkGetMacro(CacheSize, int);
 
+  // Description:
+  // The maximum memory, in kilobytes, that the retained outputs may
+  // take.  An output larger than this is not retained.  The default, 0,
+  // is no limit other than CacheSize.
+  void SetCacheMemoryLimit(unsigned long limit);
+  vtkGetMacro(CacheMemoryLimit, unsigned long);
+
+  // Description:
+  // Return the number of retained outputs and the memory, in kilobytes,
+  // that they take.
+  int GetNumberOfCachedDataObjects();
+  unsigned long GetCacheMemorySize();
+
+  // Description:
+  // Make the value of an integer key of the output information part of
+  // the request that a retained output must match, in addition to the
+  // piece, extent and time index.  Use this for keys that the algorithm
+  // reads to decide what it produces.
+  void AddCacheKey(vtkInformationIntegerKey* key);
+  void RemoveAllCacheKeys();
+
+  // Description:
+  // The number of requests served from the cache, the number of
+  // executions of the algorithm, and the number of outputs removed to
+  // make room for others, since construction or the last call to
+  // ResetCacheStatistics().
+  vtkGetMacro(NumberOfCacheHits, unsigned long);
+  vtkGetMacro(NumberOfCacheMisses, unsigned long);
+  vtkGetMacro(NumberOfCacheEvictions, unsigned long);
+  void ResetCacheStatistics();
+
 protected:
   vtkCachedStreamingDemandDrivenPipeline();
   ~vtkCachedStreamingDemandDrivenPipeline();
@@ -55,11 +99,18 @@ protected:
   virtual int ExecuteData(vtkInformation* request,
                           vtkInformationVector** inInfoVec,
                           vtkInformationVector* outInfoVec);
+
+  // Remove the retained outputs that are older than the pipeline, then
+  // the least recently used ones until there are at most maxSize
+  // and they take no more than maxMemory kilobytes.
+  void TrimCache(int maxSize, unsigned long maxMemory);
   
   int CacheSize;
-  
-  vtkDataObject **Data;
-  unsigned long *Times;
+  unsigned long CacheMemoryLimit;
+
+  unsigned long NumberOfCacheHits;
+  unsigned long NumberOfCacheMisses;
+  unsigned long NumberOfCacheEvictions;
 
 private:
   vtkCachedStreamingDemandDrivenPipelineInternals* CachedStreamingDemandDrivenInternal;
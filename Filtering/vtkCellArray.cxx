@@ -22,6 +22,12 @@ vtkStandardNewMacro(vtkCellArray);
 vtkCellArray::vtkCellArray()
 {
   this->Ia = vtkIdTypeArray::New();
+  this->Offsets = NULL;
+  this->Connectivity = NULL;
+  this->OffsetsPointer = NULL;
+  this->ConnectivityPointer = NULL;
+  this->OffsetsSize = 0;
+  this->ConnectivitySize = 0;
   this->NumberOfCells = 0;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
@@ -36,6 +42,19 @@ void vtkCellArray::DeepCopy (vtkCellArray *ca)
     return;
     }
 
+  if (ca->Offsets)
+    {
+    vtkDataArray *offsets = ca->Offsets->NewInstance();
+    vtkDataArray *connectivity = ca->Connectivity->NewInstance();
+    offsets->DeepCopy(ca->Offsets);
+    connectivity->DeepCopy(ca->Connectivity);
+    this->SetData(offsets, connectivity);
+    offsets->Delete();
+    connectivity->Delete();
+    return;
+    }
+
+  this->ReleaseOffsets();
   this->Ia->DeepCopy(ca->Ia);
   this->NumberOfCells = ca->NumberOfCells;
   this->InsertLocation = ca->InsertLocation;
@@ -46,6 +65,7 @@ void vtkCellArray::DeepCopy (vtkCellArray *ca)
 vtkCellArray::~vtkCellArray()
 {
   this->Ia->Delete();
+  this->ReleaseOffsets();
 }
 
 
@@ -56,6 +76,22 @@ int vtkCellArray::GetMaxCellSize()
 {
   int i, npts=0, maxSize=0;
 
+  if ( this->Offsets )
+    {
+    vtkIdType cellId, loc, next;
+    loc = this->GetIdValue(this->OffsetsPointer, this->OffsetsSize, 0);
+    for (cellId=0; cellId < this->NumberOfCells; cellId++, loc=next)
+      {
+      next = this->GetIdValue(this->OffsetsPointer, this->OffsetsSize,
+                              cellId+1);
+      if ( next - loc > maxSize )
+        {
+        maxSize = static_cast<int>(next - loc);
+        }
+      }
+    return maxSize;
+    }
+
   for (i=0; i<this->Ia->GetMaxId(); i+=(npts+1))
     {
     if ( (npts=this->Ia->GetValue(i)) > maxSize )
@@ -80,13 +116,188 @@ void vtkCellArray::SetCells(vtkIdType ncells, vtkIdTypeArray *cells)
     this->NumberOfCells = ncells;
     this->InsertLocation = cells->GetMaxId() + 1;
     this->TraversalLocation = 0;
+    this->ReleaseOffsets();
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkCellArray::IsIdArray(vtkDataArray *array)
+{
+  int size = array->GetDataTypeSize();
+  if ( array->GetNumberOfComponents() != 1 || (size != 4 && size != 8) )
+    {
+    return 0;
+    }
+  switch (array->GetDataType())
+    {
+    case VTK_ID_TYPE:
+    case VTK_INT:
+    case VTK_LONG:
+    case VTK_LONG_LONG:
+    case VTK___INT64:
+      return 1;
+    }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+// Reference the offsets and connectivity arrays instead of the list.
+void vtkCellArray::SetData(vtkDataArray *offsets, vtkDataArray *connectivity)
+{
+  if ( !offsets || !connectivity )
+    {
+    vtkErrorMacro("SetData: Both the offsets and the connectivity are "
+                  "needed.");
+    return;
+    }
+  if ( !vtkCellArray::IsIdArray(offsets) ||
+       !vtkCellArray::IsIdArray(connectivity) )
+    {
+    vtkErrorMacro("SetData: The offsets and the connectivity must be "
+                  "arrays of 32 or 64 bit integers with one component.");
+    return;
+    }
+  vtkIdType numCells = offsets->GetNumberOfTuples() - 1;
+  if ( numCells < 0 ||
+       this->GetIdValue(offsets->GetVoidPointer(0),
+                        offsets->GetDataTypeSize(), 0) != 0 ||
+       this->GetIdValue(offsets->GetVoidPointer(0),
+                        offsets->GetDataTypeSize(), numCells) >
+       connectivity->GetNumberOfTuples() )
+    {
+    vtkErrorMacro("SetData: The offsets must start with 0 and end with at "
+                  "most the number of point ids.");
+    return;
+    }
+
+  offsets->Register(this);
+  connectivity->Register(this);
+  this->ReleaseOffsets();
+  this->Ia->Initialize();
+  this->Offsets = offsets;
+  this->Connectivity = connectivity;
+  this->OffsetsPointer = offsets->GetVoidPointer(0);
+  this->ConnectivityPointer = connectivity->GetVoidPointer(0);
+  this->OffsetsSize = offsets->GetDataTypeSize();
+  this->ConnectivitySize = connectivity->GetDataTypeSize();
+
+  this->NumberOfCells = numCells;
+  this->InsertLocation = 0;
+  this->TraversalLocation = 0;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ReleaseOffsets()
+{
+  if ( this->Offsets )
+    {
+    this->Offsets->UnRegister(this);
+    this->Connectivity->UnRegister(this);
+    this->Offsets = NULL;
+    this->Connectivity = NULL;
+    this->OffsetsPointer = NULL;
+    this->ConnectivityPointer = NULL;
+    this->OffsetsSize = 0;
+    this->ConnectivitySize = 0;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Write the cells of the offsets and connectivity arrays in the list.
+void vtkCellArray::ConvertToInterleaved()
+{
+  if ( !this->Offsets )
+    {
+    return;
+    }
+
+  vtkIdType size = this->GetNumberOfConnectivityEntries();
+  vtkIdType *ptr = this->Ia->WritePointer(0, size);
+  vtkIdType cellId, i, loc, next;
+  loc = this->GetIdValue(this->OffsetsPointer, this->OffsetsSize, 0);
+  for (cellId=0; cellId < this->NumberOfCells; cellId++, loc=next)
+    {
+    next = this->GetIdValue(this->OffsetsPointer, this->OffsetsSize,
+                            cellId+1);
+    *ptr++ = next - loc;
+    for (i=loc; i < next; i++)
+      {
+      *ptr++ = this->GetIdValue(this->ConnectivityPointer,
+                                this->ConnectivitySize, i);
+      }
+    }
+
+  this->ReleaseOffsets();
+  this->InsertLocation = size;
+  this->TraversalLocation = 0;
+}
+
+//----------------------------------------------------------------------------
+// Copy a connectivity array of the other integer size into a
+// vtkIdTypeArray.
+void vtkCellArray::ConvertConnectivityToIdType()
+{
+  if ( !this->Offsets || 
+       this->ConnectivitySize == static_cast<int>(sizeof(vtkIdType)) )
+    {
+    return;
+    }
+
+  vtkIdType i, size = this->Connectivity->GetNumberOfTuples();
+  vtkIdTypeArray *connectivity = vtkIdTypeArray::New();
+  vtkIdType *ptr = connectivity->WritePointer(0, size);
+  for (i=0; i < size; i++)
+    {
+    ptr[i] = this->GetIdValue(this->ConnectivityPointer,
+                              this->ConnectivitySize, i);
+    }
+
+  this->Connectivity->UnRegister(this);
+  this->Connectivity = connectivity;
+  this->ConnectivityPointer = ptr;
+  this->ConnectivitySize = sizeof(vtkIdType);
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::GetCellAtId(vtkIdType cellId, vtkIdList *ptIds)
+{
+  vtkIdType i, npts;
+  if ( this->Offsets )
+    {
+    vtkIdType loc = this->GetIdValue(this->OffsetsPointer, this->OffsetsSize,
+                                     cellId);
+    npts = this->GetIdValue(this->OffsetsPointer, this->OffsetsSize,
+                            cellId+1) - loc;
+    ptIds->SetNumberOfIds(npts);
+    for (i=0; i < npts; i++)
+      {
+      ptIds->SetId(i, this->GetIdValue(this->ConnectivityPointer,
+                                       this->ConnectivitySize, loc+i));
+      }
+    }
+  else
+    {
+    vtkIdType *pts;
+    this->GetCellAtId(cellId, npts, pts);
+    ptIds->SetNumberOfIds(npts);
+    for (i=0; i < npts; i++)
+      {
+      ptIds->SetId(i, pts[i]);
+      }
     }
 }
 
 //----------------------------------------------------------------------------
 unsigned long vtkCellArray::GetActualMemorySize()
 {
-  return this->Ia->GetActualMemorySize();
+  unsigned long size = this->Ia->GetActualMemorySize();
+  if ( this->Offsets )
+    {
+    size += this->Offsets->GetActualMemorySize() +
+      this->Connectivity->GetActualMemorySize();
+    }
+  return size;
 }
 
 //----------------------------------------------------------------------------
@@ -97,4 +308,6 @@ void vtkCellArray::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Number Of Cells: " << this->NumberOfCells << endl;
   os << indent << "Insert Location: " << this->InsertLocation << endl;
   os << indent << "Traversal Location: " << this->TraversalLocation << endl;
+  os << indent << "Storage: "
+     << (this->Offsets ? "Offsets and connectivity" : "Interleaved") << endl;
 }
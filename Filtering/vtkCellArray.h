@@ -26,6 +26,12 @@
 // using the vtkCellTypes and vtkCellLinks objects to extend the definition of 
 // the data structure.
 //
+// Optionally the cells can instead be kept in two arrays, the offsets of the
+// cells and their point ids (see SetData()).  A cell is then found from its
+// id in constant time, and the arrays may be 32 or 64 bit arrays owned by
+// someone else.  The methods that expose the interleaved list convert the
+// cells to it first.
+//
 // .SECTION See Also
 // vtkCellTypes vtkCellLinks
 
@@ -50,12 +56,12 @@ public:
   // Description:
   // Allocate memory and set the size to extend by.
   int Allocate(const vtkIdType sz, const int ext=1000) 
-    {return this->Ia->Allocate(sz,ext);}
+    {if (this->Offsets) {this->Reset();} return this->Ia->Allocate(sz,ext);}
 
   // Description:
   // Free any memory and reset to an empty state.
   void Initialize() 
-    {this->Ia->Initialize();}
+    {if (this->Offsets) {this->Reset();} this->Ia->Initialize();}
 
   // Description:
   // Get the number of cells in the array.
@@ -79,7 +85,9 @@ public:
   // Description:
   // A cell traversal methods that is more efficient than vtkDataSet traversal
   // methods.  InitTraversal() initializes the traversal of the list of cells.
-  void InitTraversal() {this->TraversalLocation=0;};
+  void InitTraversal() 
+    {if (this->Offsets) {this->ConvertToInterleaved();}
+    this->TraversalLocation=0;};
 
   // Description:
   // A cell traversal methods that is more efficient than vtkDataSet traversal
@@ -89,21 +97,34 @@ public:
 
   // Description:
   // Get the size of the allocated connectivity array.
+  // With the arrays given to SetData(), this is the size the interleaved
+  // list would have.
   vtkIdType GetSize() 
-    {return this->Ia->GetSize();}
+    {return (this->Offsets ? this->GetNumberOfConnectivityEntries() :
+             this->Ia->GetSize());}
   
   // Description:
   // Get the total number of entries (i.e., data values) in the connectivity 
   // array. This may be much less than the allocated size (i.e., return value 
   // from GetSize().)
-  vtkIdType GetNumberOfConnectivityEntries() 
-    {return this->Ia->GetMaxId()+1;}
+  vtkIdType GetNumberOfConnectivityEntries();
 
   // Description:
   // Internal method used to retrieve a cell given an offset into
   // the internal array.
   void GetCell(vtkIdType loc, vtkIdType &npts, vtkIdType* &pts);
 
+  // Description:
+  // Get the point ids of a cell given its id.  With the arrays given to
+  // SetData() this takes constant time; with the interleaved list the
+  // cells before it are walked.  The first version returns a pointer into
+  // the connectivity, so it calls ConvertConnectivityToIdType() first:
+  // until the connectivity holds vtkIdType values it modifies the array,
+  // and it is not safe to call from several threads.  The second version
+  // never modifies the array.
+  void GetCellAtId(vtkIdType cellId, vtkIdType &npts, vtkIdType* &pts);
+  void GetCellAtId(vtkIdType cellId, vtkIdList *ptIds);
+
   // Description:
   // Insert a cell object. Return the cell id of the cell.
   vtkIdType InsertNextCell(vtkCell *cell);
@@ -171,7 +192,8 @@ public:
   // Description:
   // Get pointer to array of cell data.
   vtkIdType *GetPointer() 
-    {return this->Ia->GetPointer(0);}
+    {if (this->Offsets) {this->ConvertToInterleaved();}
+    return this->Ia->GetPointer(0);}
 
   // Description:
   // Get pointer to data array for purpose of direct writes of data. Size is the
@@ -188,6 +210,50 @@ public:
   // beginning of the list; the insertion location is set to the end of the
   // list.
   void SetCells(vtkIdType ncells, vtkIdTypeArray *cells);
+
+  // Description:
+  // Define the cells with two arrays instead of the interleaved list: cell
+  // i has the point ids connectivity[offsets[i]] to
+  // connectivity[offsets[i+1]-1], so offsets has one more value than there
+  // are cells and starts with 0.  Both arrays must have one component of
+  // 32 or 64 bit signed integers (vtkIntArray, vtkIdTypeArray,
+  // vtkLongLongArray...).  They are referenced, not copied, so they can
+  // wrap buffers owned by the caller (see vtkIntArray::SetArray()), and
+  // must not be resized while the cell array uses them.  The methods that
+  // expose the interleaved list, such as GetData(), GetPointer(),
+  // InitTraversal() and InsertNextCell(), call ConvertToInterleaved().
+  void SetData(vtkDataArray *offsets, vtkDataArray *connectivity);
+
+  // Description:
+  // Return whether SetData() accepts the array: one component of 32 or 64
+  // bit signed integers.
+  static int IsIdArray(vtkDataArray *array);
+
+  // Description:
+  // Get the arrays given to SetData(), or NULL when the cells are in the
+  // interleaved list.
+  vtkDataArray *GetOffsetsArray() 
+    {return this->Offsets;}
+  vtkDataArray *GetConnectivityArray() 
+    {return this->Connectivity;}
+
+  // Description:
+  // Return 1 when the cells are in the interleaved list (the default), 0
+  // when they are in the arrays given to SetData().
+  int IsStorageInterleaved() 
+    {return (this->Offsets == NULL);}
+
+  // Description:
+  // Copy the cells given to SetData() into the interleaved list, and
+  // release the arrays.
+  void ConvertToInterleaved();
+
+  // Description:
+  // Replace a connectivity array given to SetData() whose values do not
+  // have the size of vtkIdType by a vtkIdTypeArray copy, so that pointers
+  // to the point ids can be returned.  Call it before accessing the cells
+  // from several threads.
+  void ConvertConnectivityToIdType();
   
   // Description:
   // Perform a deep copy (no reference counting) of the given cell array.
@@ -196,14 +262,15 @@ public:
   // Description:
   // Return the underlying data as a data array.
   vtkIdTypeArray* GetData() 
-    {return this->Ia;}
+    {if (this->Offsets) {this->ConvertToInterleaved();} return this->Ia;}
 
   // Description:
   // Reuse list. Reset to initial condition.
   void Reset();
 
   // Description:
-  // Reclaim any extra memory.
+  // Reclaim any extra memory.  The arrays given to SetData() are left as
+  // they are.
   void Squeeze() 
     {this->Ia->Squeeze();}
 
@@ -220,11 +287,31 @@ protected:
   vtkCellArray();
   ~vtkCellArray();
 
+  // Release the arrays given to SetData().
+  void ReleaseOffsets();
+
+  //BTX
+  // Get value i of an array of 4 or 8 byte integers.
+  static vtkIdType GetIdValue(const void *array, int size, vtkIdType i)
+    {
+    return (size == 8 ?
+            static_cast<vtkIdType>(static_cast<const vtkTypeInt64 *>(array)[i]) :
+            static_cast<vtkIdType>(static_cast<const vtkTypeInt32 *>(array)[i]));
+    }
+  //ETX
+
   vtkIdType NumberOfCells;
   vtkIdType InsertLocation;     //keep track of current insertion point
   vtkIdType TraversalLocation;   //keep track of traversal position
   vtkIdTypeArray *Ia;
 
+  vtkDataArray *Offsets;        //cell offsets, instead of the list in Ia
+  vtkDataArray *Connectivity;   //point ids of the cells with Offsets
+  void *OffsetsPointer;
+  void *ConnectivityPointer;
+  int OffsetsSize;              //size of the values of Offsets
+  int ConnectivitySize;         //size of the values of Connectivity
+
 private:
   vtkCellArray(const vtkCellArray&);  // Not implemented.
   void operator=(const vtkCellArray&);  // Not implemented.
@@ -235,6 +322,10 @@ private:
 inline vtkIdType vtkCellArray::InsertNextCell(vtkIdType npts,
                                               const vtkIdType* pts)
 {
+  if ( this->Offsets )
+    {
+    this->ConvertToInterleaved();
+    }
   vtkIdType i = this->Ia->GetMaxId() + 1;
   vtkIdType *ptr = this->Ia->WritePointer(i, npts+1);
   
@@ -252,6 +343,10 @@ inline vtkIdType vtkCellArray::InsertNextCell(vtkIdType npts,
 //----------------------------------------------------------------------------
 inline vtkIdType vtkCellArray::InsertNextCell(vtkIdList *pts)
 {
+  if ( this->Offsets )
+    {
+    this->ConvertToInterleaved();
+    }
   vtkIdType npts = pts->GetNumberOfIds();
   vtkIdType i = this->Ia->GetMaxId() + 1;
   vtkIdType *ptr = this->Ia->WritePointer(i,npts+1);
@@ -270,6 +365,10 @@ inline vtkIdType vtkCellArray::InsertNextCell(vtkIdList *pts)
 //----------------------------------------------------------------------------
 inline vtkIdType vtkCellArray::InsertNextCell(int npts)
 {
+  if ( this->Offsets )
+    {
+    this->ConvertToInterleaved();
+    }
   this->InsertLocation = this->Ia->InsertNextValue(npts) + 1;
   this->NumberOfCells++;
 
@@ -291,6 +390,10 @@ inline void vtkCellArray::UpdateCellCount(int npts)
 //----------------------------------------------------------------------------
 inline vtkIdType vtkCellArray::InsertNextCell(vtkCell *cell)
 {
+  if ( this->Offsets )
+    {
+    this->ConvertToInterleaved();
+    }
   int npts = cell->GetNumberOfPoints();
   vtkIdType i = this->Ia->GetMaxId() + 1;
   vtkIdType *ptr = this->Ia->WritePointer(i,npts+1);
@@ -313,6 +416,7 @@ inline void vtkCellArray::Reset()
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
   this->Ia->Reset();
+  this->ReleaseOffsets();
 }
 
 //----------------------------------------------------------------------------
@@ -326,6 +430,11 @@ inline int vtkCellArray::GetNextCell(vtkIdType& npts, vtkIdType* &pts)
     this->TraversalLocation += npts;
     return 1;
     }
+  else if ( this->Offsets )
+    { // traversal started without InitTraversal()
+    this->ConvertToInterleaved();
+    return this->GetNextCell(npts, pts);
+    }
   else
     {
     return 0;
@@ -340,6 +449,45 @@ inline void vtkCellArray::GetCell(vtkIdType loc, vtkIdType &npts,
   pts  = this->Ia->GetPointer(loc);
 }
 
+//----------------------------------------------------------------------------
+inline void vtkCellArray::GetCellAtId(vtkIdType cellId, vtkIdType &npts,
+                                      vtkIdType* &pts)
+{
+  if ( this->Offsets )
+    {
+    if ( this->ConnectivitySize != static_cast<int>(sizeof(vtkIdType)) )
+      {
+      this->ConvertConnectivityToIdType();
+      }
+    vtkIdType loc = this->GetIdValue(this->OffsetsPointer, this->OffsetsSize,
+                                     cellId);
+    npts = this->GetIdValue(this->OffsetsPointer, this->OffsetsSize,
+                            cellId + 1) - loc;
+    pts = static_cast<vtkIdType *>(this->ConnectivityPointer) + loc;
+    }
+  else
+    {
+    vtkIdType loc = 0;
+    for (vtkIdType i = 0; i < cellId; i++)
+      {
+      loc += this->Ia->GetValue(loc) + 1;
+      }
+    this->GetCell(loc, npts, pts);
+    }
+}
+
+//----------------------------------------------------------------------------
+inline vtkIdType vtkCellArray::GetNumberOfConnectivityEntries()
+{
+  if ( this->Offsets )
+    {
+    return this->NumberOfCells + 
+      this->GetIdValue(this->OffsetsPointer, this->OffsetsSize,
+                       this->NumberOfCells);
+    }
+  return this->Ia->GetMaxId()+1;
+}
+
 //----------------------------------------------------------------------------
 inline void vtkCellArray::ReverseCell(vtkIdType loc)
 {
@@ -373,6 +521,7 @@ inline vtkIdType *vtkCellArray::WritePointer(const vtkIdType ncells,
   this->NumberOfCells = ncells;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
+  this->ReleaseOffsets();
   return this->Ia->WritePointer(0,size);
 }
 
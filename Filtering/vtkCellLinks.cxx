@@ -214,6 +214,38 @@ void vtkCellLinks::BuildLinks(vtkDataSet *data, vtkCellArray *Connectivity)
   unsigned short *linkLoc;
   vtkIdType npts=0;
   vtkIdType *pts=0;
+
+  // cells kept with offsets are visited by id, leaving them as they are
+  if ( !Connectivity->IsStorageInterleaved() )
+    {
+    vtkIdType numCells = Connectivity->GetNumberOfCells();
+    for (cellId=0; cellId < numCells; cellId++)
+      {
+      Connectivity->GetCellAtId(cellId, npts, pts);
+      for (j=0; j < npts; j++)
+        {
+        this->IncrementLinkCount(pts[j]);      
+        }      
+      }
+
+    this->AllocateLinks(numPts);
+    this->MaxId = numPts - 1;
+
+    linkLoc = new unsigned short[numPts];
+    memset(linkLoc, 0, numPts*sizeof(unsigned short));
+
+    for (cellId=0; cellId < numCells; cellId++)
+      {
+      Connectivity->GetCellAtId(cellId, npts, pts);
+      for (j=0; j < npts; j++)
+        {
+        this->InsertCellReference(pts[j], (linkLoc[pts[j]])++, cellId);      
+        }      
+      }
+    delete [] linkLoc;
+    return;
+    }
+
   vtkIdType loc = Connectivity->GetTraversalLocation();
   
   // traverse data to determine number of uses of each point
@@ -0,0 +1,355 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkConcurrentMergePoints.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkConcurrentMergePoints.h"
+
+#include "vtkAtomic.h"
+#include "vtkIdTypeArray.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
+
+vtkCxxRevisionMacro(vtkConcurrentMergePoints, "1.1");
+vtkStandardNewMacro(vtkConcurrentMergePoints);
+
+// The nodes are stored in segments that double in size, so that they
+// never move and the table grows without stopping the inserting threads.
+#define VTK_CONCURRENT_MERGE_POINTS_FIRST_SEGMENT 1024
+#define VTK_CONCURRENT_MERGE_POINTS_MAX_SEGMENTS 40
+
+//----------------------------------------------------------------------------
+struct vtkConcurrentMergePointsNode
+{
+  double X[3];
+  volatile vtkIdType Order;
+  vtkIdType Next;
+};
+
+//----------------------------------------------------------------------------
+// A distinct point as sorted by Compact().
+struct vtkConcurrentMergePointsEntry
+{
+  vtkIdType Order;
+  double X[3];
+  vtkIdType Id;
+
+  bool operator<(const vtkConcurrentMergePointsEntry& other) const
+    {
+    if (this->Order != other.Order)
+      {
+      return this->Order < other.Order;
+      }
+    for (int i = 0; i < 3; ++i)
+      {
+      if (this->X[i] != other.X[i])
+        {
+        return this->X[i] < other.X[i];
+        }
+      }
+    return false;
+    }
+};
+
+//----------------------------------------------------------------------------
+class vtkConcurrentMergePointsInternals
+{
+public:
+  vtkConcurrentMergePointsInternals()
+    {
+    this->Heads = 0;
+    this->NumberOfHeads = 0;
+    for (int s = 0; s < VTK_CONCURRENT_MERGE_POINTS_MAX_SEGMENTS; ++s)
+      {
+      this->Segments[s] = 0;
+      }
+    this->NumberOfNodes = 0;
+    this->NumberOfPoints = 0;
+    }
+
+  ~vtkConcurrentMergePointsInternals()
+    {
+    this->Release();
+    }
+
+  void Release()
+    {
+    delete [] this->Heads;
+    this->Heads = 0;
+    this->NumberOfHeads = 0;
+    for (int s = 0; s < VTK_CONCURRENT_MERGE_POINTS_MAX_SEGMENTS; ++s)
+      {
+      delete [] this->Segments[s];
+      this->Segments[s] = 0;
+      }
+    this->NumberOfNodes = 0;
+    this->NumberOfPoints = 0;
+    }
+
+  // Return the node with the given id.  The segment holding it is
+  // allocated by the first thread that needs it.
+  vtkConcurrentMergePointsNode *GetNode(vtkIdType id)
+    {
+    vtkIdType first = VTK_CONCURRENT_MERGE_POINTS_FIRST_SEGMENT;
+    vtkIdType q = id/first + 1;
+    int s = 0;
+    while (q >>= 1)
+      {
+      ++s;
+      }
+    vtkIdType start = first*((static_cast<vtkIdType>(1) << s) - 1);
+    vtkConcurrentMergePointsNode *segment = this->Segments[s];
+    if (!segment)
+      {
+      segment = this->AllocateSegment(s);
+      }
+    return segment + (id - start);
+    }
+
+  vtkConcurrentMergePointsNode *AllocateSegment(int s)
+    {
+    vtkIdType size =
+      static_cast<vtkIdType>(VTK_CONCURRENT_MERGE_POINTS_FIRST_SEGMENT) << s;
+    vtkConcurrentMergePointsNode *segment =
+      new vtkConcurrentMergePointsNode[size];
+    vtkConcurrentMergePointsNode *previous =
+      static_cast<vtkConcurrentMergePointsNode *>(
+        vtkAtomic::CompareAndSwapPointer(
+          reinterpret_cast<void *volatile *>(&this->Segments[s]),
+          0, segment));
+    if (previous)
+      {
+      // Another thread allocated it first.
+      delete [] segment;
+      return previous;
+      }
+    return segment;
+    }
+
+  vtkIdType *Heads;
+  vtkIdType NumberOfHeads;
+  vtkConcurrentMergePointsNode *volatile
+    Segments[VTK_CONCURRENT_MERGE_POINTS_MAX_SEGMENTS];
+  volatile vtkIdType NumberOfNodes;
+  volatile vtkIdType NumberOfPoints;
+};
+
+//----------------------------------------------------------------------------
+vtkConcurrentMergePoints::vtkConcurrentMergePoints()
+{
+  this->DataType = VTK_FLOAT;
+  this->Internals = new vtkConcurrentMergePointsInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkConcurrentMergePoints::~vtkConcurrentMergePoints()
+{
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkConcurrentMergePoints::Initialize()
+{
+  this->Internals->Release();
+}
+
+//----------------------------------------------------------------------------
+void vtkConcurrentMergePoints::InitPointInsertion(vtkIdType estimatedSize)
+{
+  this->Internals->Release();
+
+  // About one point per chain.
+  vtkIdType numHeads = 64;
+  while (numHeads < estimatedSize && numHeads < (VTK_LARGE_ID >> 2))
+    {
+    numHeads <<= 1;
+    }
+  this->Internals->Heads = new vtkIdType[numHeads];
+  for (vtkIdType i = 0; i < numHeads; ++i)
+    {
+    this->Internals->Heads[i] = -1;
+    }
+  this->Internals->NumberOfHeads = numHeads;
+}
+
+//----------------------------------------------------------------------------
+int vtkConcurrentMergePoints::InsertUniquePoint(const double x[3],
+                                                vtkIdType order,
+                                                vtkIdType &ptId)
+{
+  vtkConcurrentMergePointsInternals *internals = this->Internals;
+  if (!internals->Heads)
+    {
+    vtkErrorMacro("InitPointInsertion() must be called first.");
+    ptId = -1;
+    return 0;
+    }
+
+  // Round to the precision of the points, and make the zeros positive so
+  // that their bits hash alike.
+  double p[3];
+  int i;
+  for (i = 0; i < 3; ++i)
+    {
+    p[i] = (this->DataType == VTK_FLOAT ?
+            static_cast<double>(static_cast<float>(x[i])) : x[i]) + 0.0;
+    }
+
+  vtkTypeUInt32 words[6];
+  memcpy(words, p, sizeof(words));
+  vtkTypeUInt32 hash = 2166136261U;
+  for (i = 0; i < 6; ++i)
+    {
+    hash = (hash ^ words[i])*16777619U;
+    }
+  hash ^= hash >> 15;
+  hash *= 0x85ebca6bU;
+  hash ^= hash >> 13;
+
+  volatile vtkIdType *head = internals->Heads +
+    (static_cast<vtkIdType>(hash) & (internals->NumberOfHeads - 1));
+  vtkIdType first = vtkAtomic::Load(head);
+  vtkIdType stop = -1;
+  vtkIdType newId = -1;
+  vtkConcurrentMergePointsNode *newNode = 0;
+  for (;;)
+    {
+    // Look for the point among the nodes added since the last look.
+    for (vtkIdType id = first; id != stop; )
+      {
+      vtkConcurrentMergePointsNode *node = internals->GetNode(id);
+      if (node->X[0] == p[0] && node->X[1] == p[1] && node->X[2] == p[2])
+        {
+        vtkIdType current = node->Order;
+        while (order < current)
+          {
+          vtkIdType previous =
+            vtkAtomic::CompareAndSwap(&node->Order, current, order);
+          if (previous == current)
+            {
+            break;
+            }
+          current = previous;
+          }
+        // A node allocated by a previous attempt stays unused.
+        ptId = id;
+        return 0;
+        }
+      id = node->Next;
+      }
+
+    if (!newNode)
+      {
+      newId = vtkAtomic::FetchAndAdd(&internals->NumberOfNodes, 1);
+      newNode = internals->GetNode(newId);
+      newNode->X[0] = p[0];
+      newNode->X[1] = p[1];
+      newNode->X[2] = p[2];
+      newNode->Order = order;
+      }
+    newNode->Next = first;
+
+    // Publish the node as the head of the chain, unless another thread
+    // changed the head meanwhile, in which case only the nodes it added
+    // have to be looked at again.
+    vtkIdType previous = vtkAtomic::CompareAndSwap(head, first, newId);
+    if (previous == first)
+      {
+      vtkAtomic::FetchAndAdd(&internals->NumberOfPoints, 1);
+      ptId = newId;
+      return 1;
+      }
+    stop = first;
+    first = previous;
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkConcurrentMergePoints::GetNumberOfPoints()
+{
+  return this->Internals->NumberOfPoints;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkConcurrentMergePoints::GetNumberOfInsertedIds()
+{
+  return this->Internals->NumberOfNodes;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkConcurrentMergePoints::Compact(vtkPoints *points,
+                                            vtkIdTypeArray *pointMap)
+{
+  vtkConcurrentMergePointsInternals *internals = this->Internals;
+
+  // Collect the nodes that made it into a chain.
+  vtkstd::vector<vtkConcurrentMergePointsEntry> entries;
+  entries.reserve(internals->NumberOfPoints);
+  vtkIdType i;
+  for (i = 0; i < internals->NumberOfHeads; ++i)
+    {
+    for (vtkIdType id = internals->Heads[i]; id >= 0; )
+      {
+      vtkConcurrentMergePointsNode *node = internals->GetNode(id);
+      vtkConcurrentMergePointsEntry entry;
+      entry.Order = node->Order;
+      entry.X[0] = node->X[0];
+      entry.X[1] = node->X[1];
+      entry.X[2] = node->X[2];
+      entry.Id = id;
+      entries.push_back(entry);
+      id = node->Next;
+      }
+    }
+  vtkstd::sort(entries.begin(), entries.end());
+
+  vtkIdType numPts = static_cast<vtkIdType>(entries.size());
+  if (points)
+    {
+    points->SetNumberOfPoints(numPts);
+    for (i = 0; i < numPts; ++i)
+      {
+      points->SetPoint(i, entries[i].X);
+      }
+    }
+  if (pointMap)
+    {
+    pointMap->SetNumberOfComponents(1);
+    pointMap->SetNumberOfTuples(internals->NumberOfNodes);
+    vtkIdType *map = pointMap->GetPointer(0);
+    for (i = 0; i < internals->NumberOfNodes; ++i)
+      {
+      map[i] = -1;
+      }
+    for (i = 0; i < numPts; ++i)
+      {
+      map[entries[i].Id] = i;
+      }
+    }
+  return numPts;
+}
+
+//----------------------------------------------------------------------------
+void vtkConcurrentMergePoints::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Data Type: "
+     << (this->DataType == VTK_FLOAT ? "float" : "double") << "\n";
+  os << indent << "Number Of Points: "
+     << this->Internals->NumberOfPoints << "\n";
+  os << indent << "Number Of Chains: "
+     << this->Internals->NumberOfHeads << "\n";
+}
@@ -0,0 +1,124 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkConcurrentMergePoints.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkConcurrentMergePoints - merge exactly coincident points from several threads
+// .SECTION Description
+// vtkConcurrentMergePoints merges precisely coincident points like
+// vtkMergePoints, but InsertUniquePoint() may be called from several
+// threads at once, for example from the tasks of a
+// vtkTaskScheduler::ParallelFor().  Points are kept in a hash table keyed
+// by their coordinates whose chains are extended with an atomic compare
+// and swap, so inserting threads never wait for each other.  (On
+// compilers without atomic operations a lock is used instead.)  The table
+// needs no bounds and grows as needed; the estimated number of points
+// given to InitPointInsertion() only sets the number of chains.
+//
+// The ids returned by InsertUniquePoint() depend on the order in which
+// the threads happen to insert the points.  Once all insertions are done,
+// Compact() copies the points to a vtkPoints in a deterministic order and
+// returns the map from the inserted ids to the final ones, which is used
+// to renumber the connectivity built with the inserted ids.  Each
+// insertion may carry an order key; a point is placed by the smallest key
+// it was inserted with and then by its coordinates.  When the keys follow
+// the order in which a serial filter would visit the points (for example
+// cellId*8 + corner), the final ids are those that vtkMergePoints would
+// have given in that serial filter.
+//
+// .SECTION Caveats
+// Coordinates are rounded to the precision of the DataType before they
+// are compared, as vtkMergePoints does for its vtkPoints.  Zeros of either
+// sign are merged.  Compact() and InitPointInsertion() must not be called
+// while points are being inserted.
+//
+// .SECTION See Also
+// vtkMergePoints vtkPointLocator vtkTaskScheduler
+
+#ifndef __vtkConcurrentMergePoints_h
+#define __vtkConcurrentMergePoints_h
+
+#include "vtkObject.h"
+
+class vtkConcurrentMergePointsInternals;
+class vtkIdTypeArray;
+class vtkPoints;
+
+class VTK_FILTERING_EXPORT vtkConcurrentMergePoints : public vtkObject
+{
+public:
+  static vtkConcurrentMergePoints *New();
+  vtkTypeRevisionMacro(vtkConcurrentMergePoints,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Set/Get the precision at which the coordinates are compared,
+  // VTK_FLOAT (the default) or VTK_DOUBLE.  It should match the data type
+  // of the points given to Compact(), and must be set before
+  // InitPointInsertion().
+  vtkSetClampMacro(DataType,int,VTK_FLOAT,VTK_DOUBLE);
+  vtkGetMacro(DataType,int);
+  void SetDataTypeToFloat() {this->SetDataType(VTK_FLOAT);}
+  void SetDataTypeToDouble() {this->SetDataType(VTK_DOUBLE);}
+
+  // Description:
+  // Discard the inserted points and prepare the table for about
+  // estimatedSize points.  More points may be inserted at a small cost
+  // in speed.
+  void InitPointInsertion(vtkIdType estimatedSize);
+
+  // Description:
+  // Insert the point x unless a coincident point was inserted before.
+  // Return 1 if the point was inserted, 0 if it was already there.  In
+  // either case the inserted id of the point is returned in ptId.  The
+  // point keeps the smallest order key it is inserted with.  Insertions
+  // without a key sort after all keyed ones.  Both may be called from
+  // several threads at once.
+  int InsertUniquePoint(const double x[3], vtkIdType order, vtkIdType &ptId);
+  int InsertUniquePoint(const double x[3], vtkIdType &ptId)
+    {return this->InsertUniquePoint(x, VTK_LARGE_ID, ptId);}
+
+  // Description:
+  // Return the number of distinct points inserted so far.
+  vtkIdType GetNumberOfPoints();
+
+  // Description:
+  // Return the number of inserted ids handed out so far.  The ids range
+  // from 0 to this number minus one; a few of them may be unused when
+  // threads raced to insert the same point.
+  vtkIdType GetNumberOfInsertedIds();
+
+  // Description:
+  // Copy the distinct points to points in their deterministic order.
+  // If pointMap is given, it is resized to GetNumberOfInsertedIds() and
+  // value i is set to the final id of the point that was given inserted
+  // id i, or -1 if id i is unused.  Return the number of points.
+  vtkIdType Compact(vtkPoints *points, vtkIdTypeArray *pointMap);
+
+  // Description:
+  // Release the table and the inserted points.
+  void Initialize();
+
+protected:
+  vtkConcurrentMergePoints();
+  ~vtkConcurrentMergePoints();
+
+  int DataType;
+
+  vtkConcurrentMergePointsInternals *Internals;
+
+private:
+  vtkConcurrentMergePoints(const vtkConcurrentMergePoints&);  // Not implemented.
+  void operator=(const vtkConcurrentMergePoints&);  // Not implemented.
+};
+
+#endif
@@ -24,6 +24,7 @@
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
 #include "vtkPointData.h"
+#include "vtkScratchPool.h"
 #include "vtkSource.h"
 
 #include <math.h>
@@ -235,8 +236,8 @@ void vtkDataSet::GetCellNeighbors(vtkIdType cellId, vtkIdList *ptIds,
                                   vtkIdList *cellIds)
 {
   vtkIdType i, numPts;
-  vtkIdList *otherCells = vtkIdList::New();
-  otherCells->Allocate(VTK_CELL_SIZE);
+  vtkScratchPool *pool = vtkScratchPool::GetThreadPool();
+  vtkIdList *otherCells = pool->AcquireIdList();
 
   // load list with candidate cells, remove current cell
   this->GetPointCells(ptIds->GetId(0), cellIds);
@@ -252,7 +253,7 @@ void vtkDataSet::GetCellNeighbors(vtkIdType cellId, vtkIdList *ptIds,
       }
     }
   
-  otherCells->Delete();
+  pool->ReleaseIdList(otherCells);
 }
 
 //----------------------------------------------------------------------------
@@ -278,11 +279,12 @@ void vtkDataSet::GetCellTypes(vtkCellTypes *types)
 // Subclasses should override this method for efficiency.
 void vtkDataSet::GetCellBounds(vtkIdType cellId, double bounds[6])
 {
-  vtkGenericCell *cell = vtkGenericCell::New();
+  vtkScratchPool *pool = vtkScratchPool::GetThreadPool();
+  vtkGenericCell *cell = pool->AcquireGenericCell();
 
   this->GetCell(cellId, cell);
   cell->GetBounds(bounds);
-  cell->Delete();
+  pool->ReleaseGenericCell(cell);
 }
 
 //----------------------------------------------------------------------------
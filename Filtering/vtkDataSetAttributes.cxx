@@ -556,10 +556,12 @@ void vtkDataSetAttributes::InterpolatePoint(vtkDataSetAttributes *fromPd,
                                             vtkIdType toId, vtkIdList *ptIds, 
                                             double *weights)
 {
-  int i;
-  for(i=this->RequiredArrays.BeginIndex(); !this->RequiredArrays.End(); 
-      i=this->RequiredArrays.NextIndex())
+  // The list of required arrays is read without moving its iterator, so
+  // that several threads may interpolate at once.
+  int numArrays = this->RequiredArrays.GetListSize();
+  for (int k = 0; k < numArrays; ++k)
     {
+    int i = this->RequiredArrays.GetIndex(k);
     this->InterpolateTuple(fromPd->Data[i], 
                            this->Data[this->TargetIndices[i]], 
                            toId, ptIds, weights);
@@ -97,6 +97,9 @@ public:
   // Description:
   // Interpolate data set attributes from other data set attributes
   // given cell or point ids and associated interpolation weights.
+  // Several threads may interpolate into different toId at once when
+  // the arrays already hold toId, for example after SetNumberOfTuples(),
+  // and are not bit arrays.
   void InterpolatePoint(vtkDataSetAttributes *fromPd, vtkIdType toId, 
                         vtkIdList *ids, double *weights);
   
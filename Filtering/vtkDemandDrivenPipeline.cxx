@@ -32,6 +32,8 @@
 #include "vtkInstantiator.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkScratchPool.h"
+#include "vtkTimerLog.h"
 
 #include "vtkImageData.h"
 #include "vtkPolyData.h"
@@ -354,6 +356,8 @@ int vtkDemandDrivenPipeline::UpdateDataObject()
     {
     return 0;
     }
+  vtkTimerLogTraceScope scope("Executive", this->Algorithm,
+                              "UpdateDataObject");
 
   // Update the pipeline mtime first.
   if(!this->UpdatePipelineMTime())
@@ -386,6 +390,8 @@ int vtkDemandDrivenPipeline::UpdateInformation()
     {
     return 0;
     }
+  vtkTimerLogTraceScope scope("Executive", this->Algorithm,
+                              "UpdateInformation");
 
   // Do the data-object creation pass before the information pass.
   if(!this->UpdateDataObject())
@@ -418,6 +424,7 @@ int vtkDemandDrivenPipeline::UpdateData(int outputPort)
     {
     return 0;
     }
+  vtkTimerLogTraceScope scope("Executive", this->Algorithm, "UpdateData");
 
   // Range check.
   if(outputPort < -1 ||
@@ -453,6 +460,9 @@ int vtkDemandDrivenPipeline::ExecuteDataObject(vtkInformation* request,
                                                vtkInformationVector** inInfo,
                                                vtkInformationVector* outInfo)
 {
+  vtkTimerLogTraceScope scope("Algorithm", this->Algorithm,
+                              "RequestDataObject");
+
   // Invoke the request on the algorithm.
   int result = this->CallAlgorithm(request, vtkExecutive::RequestDownstream,
                                    inInfo, outInfo);
@@ -490,6 +500,8 @@ int vtkDemandDrivenPipeline::ExecuteInformation
     }
 
   // Invoke the request on the algorithm.
+  vtkTimerLogTraceScope scope("Algorithm", this->Algorithm,
+                              "RequestInformation");
   return this->CallAlgorithm(request, vtkExecutive::RequestDownstream,
                              inInfoVec, outInfoVec);
 }
@@ -499,10 +511,20 @@ int vtkDemandDrivenPipeline::ExecuteData(vtkInformation* request,
                                          vtkInformationVector** inInfo,
                                          vtkInformationVector* outInfo)
 {
+  vtkTimerLogTraceScope scope("Algorithm", this->Algorithm, "RequestData");
   this->ExecuteDataStart(request, inInfo, outInfo);
   // Invoke the request on the algorithm.
+  unsigned long allocations = vtkScratchPool::GetTotalNumberOfAllocations();
+  unsigned long acquisitions = vtkScratchPool::GetTotalNumberOfAcquisitions();
   int result = this->CallAlgorithm(request, vtkExecutive::RequestDownstream,
                                    inInfo, outInfo);
+
+  // Record how much the algorithm used the scratch pools.
+  vtkInformation* algInfo = this->Algorithm->GetInformation();
+  algInfo->Set(vtkScratchPool::EXECUTION_ALLOCATIONS(), static_cast<int>(
+                 vtkScratchPool::GetTotalNumberOfAllocations() - allocations));
+  algInfo->Set(vtkScratchPool::EXECUTION_ACQUISITIONS(), static_cast<int>(
+                 vtkScratchPool::GetTotalNumberOfAcquisitions()-acquisitions));
   this->ExecuteDataEnd(request, inInfo, outInfo);
 
   return result;
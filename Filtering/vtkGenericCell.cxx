@@ -47,13 +47,24 @@ vtkStandardNewMacro(vtkGenericCell);
 // Construct cell.
 vtkGenericCell::vtkGenericCell()
 {
+  for (int i = 0; i <= VTK_CONVEX_POINT_SET; ++i)
+    {
+    this->CellCache[i] = NULL;
+    }
   this->Cell = vtkEmptyCell::New();
+  this->CellCache[VTK_EMPTY_CELL] = this->Cell;
 }  
 
 //----------------------------------------------------------------------------
 vtkGenericCell::~vtkGenericCell()
 {
-  this->Cell->Delete();
+  for (int i = 0; i <= VTK_CONVEX_POINT_SET; ++i)
+    {
+    if ( this->CellCache[i] )
+      {
+      this->CellCache[i]->Delete();
+      }
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -206,99 +217,97 @@ int vtkGenericCell::IsPrimaryCell()
   return this->Cell->IsPrimaryCell();
 }
 
+//----------------------------------------------------------------------------
+// Create a cell of the given type, or return NULL if the type is not
+// supported.
+static vtkCell *vtkGenericCellNewCell(int cellType)
+{
+  switch (cellType)
+    {
+    case VTK_EMPTY_CELL:
+      return vtkEmptyCell::New();
+    case VTK_VERTEX:
+      return vtkVertex::New();
+    case VTK_POLY_VERTEX:
+      return vtkPolyVertex::New();
+    case VTK_LINE:
+      return vtkLine::New();
+    case VTK_POLY_LINE:
+      return vtkPolyLine::New();
+    case VTK_TRIANGLE:
+      return vtkTriangle::New();
+    case VTK_TRIANGLE_STRIP:
+      return vtkTriangleStrip::New();
+    case VTK_POLYGON:
+      return vtkPolygon::New();
+    case VTK_PIXEL:
+      return vtkPixel::New();
+    case VTK_QUAD:
+      return vtkQuad::New();
+    case VTK_TETRA:
+      return vtkTetra::New();
+    case VTK_VOXEL:
+      return vtkVoxel::New();
+    case VTK_HEXAHEDRON:
+      return vtkHexahedron::New();
+    case VTK_WEDGE:
+      return vtkWedge::New();
+    case VTK_PYRAMID:
+      return vtkPyramid::New();
+    case VTK_PENTAGONAL_PRISM:
+      return vtkPentagonalPrism::New();
+    case VTK_HEXAGONAL_PRISM:
+      return vtkHexagonalPrism::New();
+    case VTK_QUADRATIC_EDGE:
+      return vtkQuadraticEdge::New();
+    case VTK_QUADRATIC_TRIANGLE:
+      return vtkQuadraticTriangle::New();
+    case VTK_QUADRATIC_QUAD:
+      return vtkQuadraticQuad::New();
+    case VTK_QUADRATIC_TETRA:
+      return vtkQuadraticTetra::New();
+    case VTK_QUADRATIC_HEXAHEDRON:
+      return vtkQuadraticHexahedron::New();
+    case VTK_QUADRATIC_WEDGE:
+      return vtkQuadraticWedge::New();
+    case VTK_QUADRATIC_PYRAMID:
+      return vtkQuadraticPyramid::New();
+    case VTK_CONVEX_POINT_SET:
+      return vtkConvexPointSet::New();
+    }
+  return NULL;
+}
+
 //----------------------------------------------------------------------------
 // Set the type of dereferenced cell. Checks to see whether cell type
-// has changed and creates a new cell only if necessary.
+// has changed and creates a new cell only if no cell of that type was
+// used before.
 void vtkGenericCell::SetCellType(int cellType)
 {
   if ( this->Cell->GetCellType() != cellType )
     {
-    this->Points->UnRegister(this);
-    this->PointIds->UnRegister(this);
-    this->PointIds = NULL;
-    this->Cell->Delete();
-
-    switch (cellType)
+    vtkCell *cell = NULL;
+    if ( cellType >= 0 && cellType <= VTK_CONVEX_POINT_SET )
+      {
+      cell = this->CellCache[cellType];
+      if ( !cell )
+        {
+        cell = this->CellCache[cellType] = vtkGenericCellNewCell(cellType);
+        }
+      }
+    if ( !cell )
       {
-      case VTK_EMPTY_CELL:
-        this->Cell = vtkEmptyCell::New();
-        break;
-      case VTK_VERTEX:
-        this->Cell = vtkVertex::New();
-        break;
-      case VTK_POLY_VERTEX:
-        this->Cell = vtkPolyVertex::New();
-        break;
-      case VTK_LINE:
-        this->Cell = vtkLine::New();
-        break;
-      case VTK_POLY_LINE:
-        this->Cell = vtkPolyLine::New();
-        break;
-      case VTK_TRIANGLE:
-        this->Cell = vtkTriangle::New();
-        break;
-      case VTK_TRIANGLE_STRIP:
-        this->Cell = vtkTriangleStrip::New();
-        break;
-      case VTK_POLYGON:
-        this->Cell = vtkPolygon::New();
-        break;
-      case VTK_PIXEL:
-        this->Cell = vtkPixel::New();
-        break;
-      case VTK_QUAD:
-        this->Cell = vtkQuad::New();
-        break;
-      case VTK_TETRA:
-        this->Cell = vtkTetra::New();
-        break;
-      case VTK_VOXEL:
-        this->Cell = vtkVoxel::New();
-        break;
-      case VTK_HEXAHEDRON:
-        this->Cell = vtkHexahedron::New();
-        break;
-      case VTK_WEDGE:
-        this->Cell = vtkWedge::New();
-        break;
-      case VTK_PYRAMID:
-        this->Cell = vtkPyramid::New();
-        break;
-      case VTK_PENTAGONAL_PRISM:
-        this->Cell = vtkPentagonalPrism::New();
-        break;
-      case VTK_HEXAGONAL_PRISM:
-        this->Cell = vtkHexagonalPrism::New();
-        break;
-      case VTK_QUADRATIC_EDGE:
-        this->Cell = vtkQuadraticEdge::New();
-        break;
-      case VTK_QUADRATIC_TRIANGLE:
-        this->Cell = vtkQuadraticTriangle::New();
-        break;
-      case VTK_QUADRATIC_QUAD:
-        this->Cell = vtkQuadraticQuad::New();
-        break;
-      case VTK_QUADRATIC_TETRA:
-        this->Cell = vtkQuadraticTetra::New();
-        break;
-      case VTK_QUADRATIC_HEXAHEDRON:
-        this->Cell = vtkQuadraticHexahedron::New();
-        break;
-      case VTK_QUADRATIC_WEDGE:
-        this->Cell = vtkQuadraticWedge::New();
-        break;
-      case VTK_QUADRATIC_PYRAMID:
-        this->Cell = vtkQuadraticPyramid::New();
-        break;
-      case VTK_CONVEX_POINT_SET:
-        this->Cell = vtkConvexPointSet::New();
-        break;
-      default:
-        vtkErrorMacro(<<"Unsupported cell type! Setting to vtkEmptyCell");
-        this->SetCellType(VTK_EMPTY_CELL);
+      vtkErrorMacro(<<"Unsupported cell type! Setting to vtkEmptyCell");
+      cell = this->CellCache[VTK_EMPTY_CELL];
+      if ( cell == this->Cell )
+        {
+        return;
+        }
       }
+
+    this->Points->UnRegister(this);
+    this->PointIds->UnRegister(this);
+    this->Cell = cell;
     this->Points = this->Cell->Points;
     this->Points->Register(this);
     this->PointIds = this->Cell->PointIds;
@@ -20,6 +20,10 @@
 // like any type of cell, it just dereferences an internal representation.
 // The SetCellType() methods use #define constants; these are defined in
 // the file vtkCellType.h.
+//
+// The cells of the types used are kept, so a generic cell that goes back
+// and forth between a few types, as when it is filled with the cells of
+// an unstructured grid, creates each of them only once.
 
 // .SECTION See Also
 // vtkCell vtkDataSet
@@ -115,6 +119,7 @@ protected:
   ~vtkGenericCell();
 
   vtkCell *Cell;
+  vtkCell *CellCache[VTK_CONVEX_POINT_SET+1]; // the cells of each type used
   
 private:
   vtkGenericCell(const vtkGenericCell&);  // Not implemented.
@@ -18,6 +18,7 @@
 #include "vtkImageData.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkScratchPool.h"
 #include "vtkVoxel.h"
 
 vtkCxxRevisionMacro(vtkImplicitVolume, "1.31");
@@ -113,10 +114,6 @@ void vtkImplicitVolume::EvaluateGradient(double x[3], double n[3])
   double pcoords[3], weights[8], *v;
   vtkDoubleArray *gradient; 
   
-  gradient = vtkDoubleArray::New();
-  gradient->SetNumberOfComponents(3);
-  gradient->SetNumberOfTuples(8);
-
   // See if a volume is defined
   if ( !this->Volume ||
   !(scalars = this->Volume->GetPointData()->GetScalars()) )
@@ -125,6 +122,11 @@ void vtkImplicitVolume::EvaluateGradient(double x[3], double n[3])
     return;
     }
 
+  vtkScratchPool *pool = vtkScratchPool::GetThreadPool();
+  gradient = pool->AcquireDoubleArray();
+  gradient->SetNumberOfComponents(3);
+  gradient->SetNumberOfTuples(8);
+
   // Find the cell that contains xyz and get it
   if ( this->Volume->ComputeStructuredCoordinates(x,ijk,pcoords) )
     {
@@ -148,7 +150,7 @@ void vtkImplicitVolume::EvaluateGradient(double x[3], double n[3])
       n[i] = this->OutGradient[i];
       }
     }
-  gradient->Delete();
+  pool->ReleaseDoubleArray(gradient);
 }
 
 void vtkImplicitVolume::PrintSelf(ostream& os, vtkIndent indent)
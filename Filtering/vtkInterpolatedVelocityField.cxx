@@ -61,7 +61,6 @@ vtkInterpolatedVelocityField::~vtkInterpolatedVelocityField()
   delete this->DataSets;
 }
 
-static int tmp_count=0;
 // Evaluate u,v,w at x,y,z,t
 int vtkInterpolatedVelocityField::FunctionValues(double* x, double* f)
 {
@@ -78,7 +77,6 @@ int vtkInterpolatedVelocityField::FunctionValues(double* x, double* f)
   int retVal = this->FunctionValues(ds, x, f);
   if (!retVal)
     {
-    tmp_count = 0;
     for(DataSetsTypeBase::iterator i = this->DataSets->begin();
         i != this->DataSets->end(); ++i)
       {
@@ -97,7 +95,6 @@ int vtkInterpolatedVelocityField::FunctionValues(double* x, double* f)
     this->ClearLastCellId();
     return 0;
     }
-  tmp_count++;
   return retVal;
 }
 
@@ -0,0 +1,550 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkIntervalScalarTree.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkIntervalScalarTree.h"
+
+#include "vtkCell.h"
+#include "vtkDataSet.h"
+#include "vtkDoubleArray.h"
+#include "vtkFieldData.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkTaskScheduler.h"
+
+#include <vtkstd/algorithm>
+
+vtkCxxRevisionMacro(vtkIntervalScalarTree, "1.1");
+vtkStandardNewMacro(vtkIntervalScalarTree);
+
+// Subtrees with more cells than this are built on separate tasks.
+#define VTK_INTERVAL_SCALAR_TREE_TASK_SIZE 10000
+
+static const char *vtkIntervalScalarTreeNodesName =
+  "vtkIntervalScalarTreeNodes";
+static const char *vtkIntervalScalarTreeCellsName =
+  "vtkIntervalScalarTreeCells";
+static const char *vtkIntervalScalarTreeRangesName =
+  "vtkIntervalScalarTreeRanges";
+
+//----------------------------------------------------------------------------
+// The state shared by the tasks that build the tree.
+struct vtkIntervalScalarTreeBuild
+{
+  vtkDataSet *DataSet;
+  vtkDataArray *Scalars;
+  double *Mins;
+  double *Maxs;
+  vtkIdType *Ids;
+  double *Nodes;
+  vtkIdType *Cells;
+  double *Ranges;
+};
+
+// A subtree to be built by a task.
+struct vtkIntervalScalarTreeSubtrees
+{
+  vtkIntervalScalarTreeBuild *Build;
+  vtkIdType Begin[2];
+  vtkIdType End[2];
+};
+
+//----------------------------------------------------------------------------
+// Orders cell ids by the midpoint of their ranges.
+class vtkIntervalScalarTreeMidLess
+{
+public:
+  vtkIntervalScalarTreeMidLess(const double *mins, const double *maxs)
+    : Mins(mins), Maxs(maxs) {}
+  bool operator()(vtkIdType a, vtkIdType b) const
+    {
+    return this->Mins[a] + this->Maxs[a] < this->Mins[b] + this->Maxs[b];
+    }
+  const double *Mins;
+  const double *Maxs;
+};
+
+// Orders cell ids by increasing minimum, then by id.
+class vtkIntervalScalarTreeMinLess
+{
+public:
+  vtkIntervalScalarTreeMinLess(const double *mins) : Mins(mins) {}
+  bool operator()(vtkIdType a, vtkIdType b) const
+    {
+    return this->Mins[a] < this->Mins[b] ||
+      (this->Mins[a] == this->Mins[b] && a < b);
+    }
+  const double *Mins;
+};
+
+// Orders cell ids by decreasing maximum, then by id.
+class vtkIntervalScalarTreeMaxGreater
+{
+public:
+  vtkIntervalScalarTreeMaxGreater(const double *maxs) : Maxs(maxs) {}
+  bool operator()(vtkIdType a, vtkIdType b) const
+    {
+    return this->Maxs[a] > this->Maxs[b] ||
+      (this->Maxs[a] == this->Maxs[b] && a < b);
+    }
+  const double *Maxs;
+};
+
+// Predicates used to split the cells of a subtree around its center.
+class vtkIntervalScalarTreeContains
+{
+public:
+  vtkIntervalScalarTreeContains(const double *mins, const double *maxs,
+                                double center)
+    : Mins(mins), Maxs(maxs), Center(center) {}
+  bool operator()(vtkIdType a) const
+    {
+    return this->Mins[a] <= this->Center && this->Center <= this->Maxs[a];
+    }
+  const double *Mins;
+  const double *Maxs;
+  double Center;
+};
+
+class vtkIntervalScalarTreeBelow
+{
+public:
+  vtkIntervalScalarTreeBelow(const double *maxs, double center)
+    : Maxs(maxs), Center(center) {}
+  bool operator()(vtkIdType a) const
+    {
+    return this->Maxs[a] < this->Center;
+    }
+  const double *Maxs;
+  double Center;
+};
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkIntervalScalarTreeComputeRanges(vtkIntervalScalarTreeBuild *build,
+                                        T *scalars, vtkIdType begin,
+                                        vtkIdType end)
+{
+  int numComp = build->Scalars->GetNumberOfComponents();
+  vtkIdList *ptIds = vtkIdList::New();
+  ptIds->Allocate(VTK_CELL_SIZE);
+  for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+    build->DataSet->GetCellPoints(cellId, ptIds);
+    vtkIdType numPts = ptIds->GetNumberOfIds();
+    double min = VTK_DOUBLE_MAX;
+    double max = -VTK_DOUBLE_MAX;
+    for (vtkIdType i = 0; i < numPts; ++i)
+      {
+      double s = static_cast<double>(scalars[numComp*ptIds->GetId(i)]);
+      if (s < min)
+        {
+        min = s;
+        }
+      if (s > max)
+        {
+        max = s;
+        }
+      }
+    build->Mins[cellId] = min;
+    build->Maxs[cellId] = max;
+    }
+  ptIds->Delete();
+}
+
+static void vtkIntervalScalarTreeComputeRangesTask(void *data,
+                                                   vtkIdType begin,
+                                                   vtkIdType end)
+{
+  vtkIntervalScalarTreeBuild *build =
+    static_cast<vtkIntervalScalarTreeBuild *>(data);
+  switch (build->Scalars->GetDataType())
+    {
+    vtkTemplateMacro(
+      vtkIntervalScalarTreeComputeRanges(
+        build, static_cast<VTK_TT *>(build->Scalars->GetVoidPointer(0)),
+        begin, end));
+    }
+}
+
+//----------------------------------------------------------------------------
+static void vtkIntervalScalarTreeBuildSubtreesTask(void *data,
+                                                   vtkIdType begin,
+                                                   vtkIdType end);
+
+// Build the subtree of the cells with ids Ids[begin, end).  Its node is
+// stored at index begin, followed by the straddling cells, then by the
+// subtree of the cells below the center and the one above it.
+static void vtkIntervalScalarTreeBuildSubtree(vtkIntervalScalarTreeBuild *b,
+                                              vtkIdType begin,
+                                              vtkIdType end)
+{
+  if (begin >= end)
+    {
+    return;
+    }
+
+  // The median of the midpoints is contained by at least one cell, and
+  // leaves at most half of the cells on each side.
+  vtkIdType *ids = b->Ids;
+  vtkstd::nth_element(ids + begin, ids + begin + (end - begin)/2, ids + end,
+                      vtkIntervalScalarTreeMidLess(b->Mins, b->Maxs));
+  vtkIdType median = ids[begin + (end - begin)/2];
+  double center = 0.5*(b->Mins[median] + b->Maxs[median]);
+
+  vtkIdType *straddleEnd = vtkstd::partition(
+    ids + begin, ids + end,
+    vtkIntervalScalarTreeContains(b->Mins, b->Maxs, center));
+  vtkIdType *belowEnd = vtkstd::partition(
+    straddleEnd, ids + end, vtkIntervalScalarTreeBelow(b->Maxs, center));
+  vtkIdType numStraddle = static_cast<vtkIdType>(straddleEnd - ids) - begin;
+  vtkIdType numBelow = static_cast<vtkIdType>(belowEnd - straddleEnd);
+
+  double *node = b->Nodes + 3*begin;
+  node[0] = center;
+  node[1] = static_cast<double>(numStraddle);
+  node[2] = static_cast<double>(numBelow);
+
+  vtkIdType i;
+  vtkstd::sort(ids + begin, straddleEnd,
+               vtkIntervalScalarTreeMinLess(b->Mins));
+  for (i = begin; i < begin + numStraddle; ++i)
+    {
+    b->Cells[2*i] = ids[i];
+    b->Ranges[2*i] = b->Mins[ids[i]];
+    }
+  vtkstd::sort(ids + begin, straddleEnd,
+               vtkIntervalScalarTreeMaxGreater(b->Maxs));
+  for (i = begin; i < begin + numStraddle; ++i)
+    {
+    b->Cells[2*i + 1] = ids[i];
+    b->Ranges[2*i + 1] = b->Maxs[ids[i]];
+    }
+
+  vtkIntervalScalarTreeSubtrees subtrees;
+  subtrees.Build = b;
+  subtrees.Begin[0] = begin + numStraddle;
+  subtrees.End[0] = subtrees.Begin[0] + numBelow;
+  subtrees.Begin[1] = subtrees.End[0];
+  subtrees.End[1] = end;
+  if (end - begin > VTK_INTERVAL_SCALAR_TREE_TASK_SIZE)
+    {
+    vtkTaskScheduler::GetGlobalScheduler()->ParallelFor(
+      0, 2, 1, vtkIntervalScalarTreeBuildSubtreesTask, &subtrees);
+    }
+  else
+    {
+    vtkIntervalScalarTreeBuildSubtreesTask(&subtrees, 0, 2);
+    }
+}
+
+static void vtkIntervalScalarTreeBuildSubtreesTask(void *data,
+                                                   vtkIdType begin,
+                                                   vtkIdType end)
+{
+  vtkIntervalScalarTreeSubtrees *subtrees =
+    static_cast<vtkIntervalScalarTreeSubtrees *>(data);
+  for (vtkIdType i = begin; i < end; ++i)
+    {
+    vtkIntervalScalarTreeBuildSubtree(subtrees->Build, subtrees->Begin[i],
+                                      subtrees->End[i]);
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkIntervalScalarTree::vtkIntervalScalarTree()
+{
+  this->Nodes = NULL;
+  this->Cells = NULL;
+  this->Ranges = NULL;
+  this->TreeScalars = NULL;
+  this->TraversalCells = vtkIdList::New();
+  this->TraversalIndex = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkIntervalScalarTree::~vtkIntervalScalarTree()
+{
+  this->Initialize();
+  this->TraversalCells->Delete();
+}
+
+//----------------------------------------------------------------------------
+// Initialize locator. Frees memory and resets object as appropriate.
+void vtkIntervalScalarTree::Initialize()
+{
+  if ( this->Nodes )
+    {
+    this->Nodes->UnRegister(this);
+    this->Cells->UnRegister(this);
+    this->Ranges->UnRegister(this);
+    }
+  this->Nodes = NULL;
+  this->Cells = NULL;
+  this->Ranges = NULL;
+  this->TreeScalars = NULL;
+  this->TraversalCells->Reset();
+  this->TraversalIndex = 0;
+}
+
+//----------------------------------------------------------------------------
+// Construct the scalar tree from the dataset provided. Checks build times
+// and modified time from input and reconstructs the tree if necessary.
+void vtkIntervalScalarTree::BuildTree()
+{
+  vtkIdType numCells;
+
+  // Check input...see whether we have to rebuild
+  //
+  if ( !this->DataSet || (numCells = this->DataSet->GetNumberOfCells()) < 1 )
+    {
+    vtkErrorMacro( << "No data to build tree with");
+    return;
+    }
+
+  vtkDataArray *scalars = this->Scalars ? this->Scalars :
+    this->DataSet->GetPointData()->GetScalars();
+  if ( ! scalars )
+    {
+    vtkErrorMacro( << "No scalar data to build trees with");
+    return;
+    }
+
+  if ( this->Nodes != NULL && scalars == this->TreeScalars
+    && this->BuildTime > this->MTime
+    && this->BuildTime > this->DataSet->GetMTime()
+    && this->BuildTime > scalars->GetMTime() )
+    {
+    return;
+    }
+
+  vtkDebugMacro( << "Building interval scalar tree..." );
+
+  this->Initialize();
+
+  vtkIntervalScalarTreeBuild build;
+  build.DataSet = this->DataSet;
+  build.Scalars = scalars;
+  build.Mins = new double[numCells];
+  build.Maxs = new double[numCells];
+
+  // GetCellPoints() is thread safe once it has been called from a single
+  // thread.
+  vtkIdList *ptIds = vtkIdList::New();
+  this->DataSet->GetCellPoints(0, ptIds);
+  ptIds->Delete();
+  vtkTaskScheduler::GetGlobalScheduler()->ParallelFor(
+    0, numCells, 0, vtkIntervalScalarTreeComputeRangesTask, &build);
+
+  // Cells without points, or with NaN scalars, contain no value.
+  vtkIdType numTreeCells = 0;
+  vtkIdType cellId;
+  build.Ids = new vtkIdType[numCells];
+  for ( cellId=0; cellId < numCells; cellId++ )
+    {
+    if ( build.Mins[cellId] <= build.Maxs[cellId] )
+      {
+      build.Ids[numTreeCells++] = cellId;
+      }
+    }
+
+  this->Nodes = vtkDoubleArray::New();
+  this->Nodes->SetName(vtkIntervalScalarTreeNodesName);
+  this->Nodes->SetNumberOfComponents(3);
+  this->Nodes->SetNumberOfTuples(numTreeCells);
+  this->Cells = vtkIdTypeArray::New();
+  this->Cells->SetName(vtkIntervalScalarTreeCellsName);
+  this->Cells->SetNumberOfComponents(2);
+  this->Cells->SetNumberOfTuples(numTreeCells);
+  this->Ranges = vtkDoubleArray::New();
+  this->Ranges->SetName(vtkIntervalScalarTreeRangesName);
+  this->Ranges->SetNumberOfComponents(2);
+  this->Ranges->SetNumberOfTuples(numTreeCells);
+
+  // Only the first entry of a subtree holds a node.
+  build.Nodes = this->Nodes->GetPointer(0);
+  build.Cells = this->Cells->GetPointer(0);
+  build.Ranges = this->Ranges->GetPointer(0);
+  memset(build.Nodes, 0, 3*numTreeCells*sizeof(double));
+  vtkIntervalScalarTreeBuildSubtree(&build, 0, numTreeCells);
+
+  delete [] build.Ids;
+  delete [] build.Mins;
+  delete [] build.Maxs;
+
+  this->TreeScalars = scalars;
+  this->BuildTime.Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkIntervalScalarTree::GetCellsAtValue(double value, vtkIdList *cellIds)
+{
+  cellIds->Reset();
+  if ( !this->Nodes || value != value )
+    {
+    return;
+    }
+
+  const double *nodes = this->Nodes->GetPointer(0);
+  const vtkIdType *cells = this->Cells->GetPointer(0);
+  const double *ranges = this->Ranges->GetPointer(0);
+  vtkIdType begin = 0;
+  vtkIdType end = this->Nodes->GetNumberOfTuples();
+  vtkIdType i;
+
+  // Visit one node per level, and scan its straddling cells only as long
+  // as they contain the value.
+  while ( begin < end )
+    {
+    double center = nodes[3*begin];
+    vtkIdType numStraddle = static_cast<vtkIdType>(nodes[3*begin + 1]);
+    vtkIdType numBelow = static_cast<vtkIdType>(nodes[3*begin + 2]);
+    vtkIdType straddleEnd = begin + numStraddle;
+    if ( value < center )
+      {
+      for ( i=begin; i < straddleEnd && ranges[2*i] <= value; i++ )
+        {
+        cellIds->InsertNextId(cells[2*i]);
+        }
+      end = straddleEnd + numBelow;
+      begin = straddleEnd;
+      }
+    else if ( value > center )
+      {
+      for ( i=begin; i < straddleEnd && ranges[2*i + 1] >= value; i++ )
+        {
+        cellIds->InsertNextId(cells[2*i + 1]);
+        }
+      begin = straddleEnd + numBelow;
+      }
+    else
+      {
+      for ( i=begin; i < straddleEnd; i++ )
+        {
+        cellIds->InsertNextId(cells[2*i]);
+        }
+      break;
+      }
+    }
+
+  vtkIdType numIds = cellIds->GetNumberOfIds();
+  if ( numIds > 0 )
+    {
+    vtkIdType *ids = cellIds->GetPointer(0);
+    vtkstd::sort(ids, ids + numIds);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Begin to traverse the cells based on a scalar value. Returned cells
+// will have scalar values that span the scalar value specified.
+void vtkIntervalScalarTree::InitTraversal(double scalarValue)
+{
+  this->BuildTree();
+  this->ScalarValue = scalarValue;
+  this->TraversalIndex = 0;
+  this->GetCellsAtValue(scalarValue, this->TraversalCells);
+}
+
+//----------------------------------------------------------------------------
+// Return the next cell whose scalar range contains the value specified to
+// initialize traversal. The value NULL is returned if the list is
+// exhausted.
+vtkCell *vtkIntervalScalarTree::GetNextCell(vtkIdType& cellId,
+                                            vtkIdList* &cellPts,
+                                            vtkDataArray *cellScalars)
+{
+  if ( this->TraversalIndex >= this->TraversalCells->GetNumberOfIds() )
+    {
+    return NULL;
+    }
+
+  cellId = this->TraversalCells->GetId(this->TraversalIndex++);
+  vtkCell *cell = this->DataSet->GetCell(cellId);
+  cellPts = cell->GetPointIds();
+  cellScalars->SetNumberOfTuples(cellPts->GetNumberOfIds());
+  this->TreeScalars->GetTuples(cellPts, cellScalars);
+  return cell;
+}
+
+//----------------------------------------------------------------------------
+void vtkIntervalScalarTree::StoreTree(vtkFieldData *fieldData)
+{
+  this->BuildTree();
+  if ( !this->Nodes || !fieldData )
+    {
+    return;
+    }
+  fieldData->AddArray(this->Nodes);
+  fieldData->AddArray(this->Cells);
+  fieldData->AddArray(this->Ranges);
+
+  // The field data may belong to the dataset, whose modification does
+  // not affect the tree.
+  this->BuildTime.Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkIntervalScalarTree::LoadTree(vtkFieldData *fieldData)
+{
+  if ( !this->DataSet || !fieldData )
+    {
+    return 0;
+    }
+  vtkDataArray *scalars = this->Scalars ? this->Scalars :
+    this->DataSet->GetPointData()->GetScalars();
+  vtkDoubleArray *nodes = vtkDoubleArray::SafeDownCast(
+    fieldData->GetArray(vtkIntervalScalarTreeNodesName));
+  vtkIdTypeArray *cells = vtkIdTypeArray::SafeDownCast(
+    fieldData->GetArray(vtkIntervalScalarTreeCellsName));
+  vtkDoubleArray *ranges = vtkDoubleArray::SafeDownCast(
+    fieldData->GetArray(vtkIntervalScalarTreeRangesName));
+  if ( !scalars || !nodes || !cells || !ranges ||
+       nodes->GetNumberOfComponents() != 3 ||
+       cells->GetNumberOfComponents() != 2 ||
+       ranges->GetNumberOfComponents() != 2 ||
+       cells->GetNumberOfTuples() != nodes->GetNumberOfTuples() ||
+       ranges->GetNumberOfTuples() != nodes->GetNumberOfTuples() ||
+       nodes->GetNumberOfTuples() > this->DataSet->GetNumberOfCells() )
+    {
+    return 0;
+    }
+
+  this->Initialize();
+  this->Nodes = nodes;
+  this->Nodes->Register(this);
+  this->Cells = cells;
+  this->Cells->Register(this);
+  this->Ranges = ranges;
+  this->Ranges->Register(this);
+  this->TreeScalars = scalars;
+  this->BuildTime.Modified();
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkIntervalScalarTree::GetNumberOfTreeCells()
+{
+  return this->Nodes ? this->Nodes->GetNumberOfTuples() : 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkIntervalScalarTree::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Number Of Tree Cells: "
+     << this->GetNumberOfTreeCells() << "\n";
+}
@@ -0,0 +1,129 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkIntervalScalarTree.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkIntervalScalarTree - organize cells in an interval tree of their scalar ranges
+// .SECTION Description
+// vtkIntervalScalarTree is a scalar tree that returns exactly the cells
+// whose scalar range contains the value given to InitTraversal(), in time
+// proportional to the depth of the tree plus the number of cells
+// returned.  vtkSimpleScalarTree, by contrast, returns every cell of the
+// leaves whose range contains the value, and checks each of them.
+//
+// The tree is a pointerless centered interval tree over the (min,max)
+// scalar range of each cell.  Each node holds a center value, the cells
+// whose range contains it sorted by increasing minimum and by decreasing
+// maximum, and two subtrees with the cells entirely below and entirely
+// above the center.  A query visits one node per level and stops scanning
+// the sorted cells of a node at the first one that does not contain the
+// value.  The cell ranges are computed, and large subtrees are built, on
+// the threads of the vtkTaskScheduler.
+//
+// The tree is kept as three arrays.  StoreTree() adds them to a field
+// data, for example that of a copy of the dataset before it is written,
+// and LoadTree() takes them back instead of building the tree again.
+// The cells are returned in increasing id order, so contouring with this
+// tree gives the same output as with vtkSimpleScalarTree.
+
+// .SECTION See Also
+// vtkScalarTree vtkSimpleScalarTree vtkTaskScheduler
+
+#ifndef __vtkIntervalScalarTree_h
+#define __vtkIntervalScalarTree_h
+
+#include "vtkScalarTree.h"
+
+class vtkDoubleArray;
+class vtkFieldData;
+class vtkIdTypeArray;
+
+class VTK_FILTERING_EXPORT vtkIntervalScalarTree : public vtkScalarTree
+{
+public:
+  static vtkIntervalScalarTree *New();
+
+  // Description:
+  // Standard type related macros and PrintSelf() method.
+  vtkTypeRevisionMacro(vtkIntervalScalarTree,vtkScalarTree);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Construct the scalar tree from the dataset provided. Checks build times
+  // and modified time from input and reconstructs the tree if necessary.
+  virtual void BuildTree();
+
+  // Description:
+  // Initialize locator. Frees memory and resets object as appropriate.
+  virtual void Initialize();
+
+  // Description:
+  // Begin to traverse the cells based on a scalar value. Returned cells
+  // will have scalar values that span the scalar value specified.
+  virtual void InitTraversal(double scalarValue);
+
+  // Description:
+  // Return the next cell whose scalar range contains the value specified
+  // to initialize traversal. The value NULL is returned if the list is
+  // exhausted. Make sure that InitTraversal() has been invoked first or
+  // you'll get erratic behavior.
+  virtual vtkCell *GetNextCell(vtkIdType &cellId, vtkIdList* &ptIds,
+                               vtkDataArray *cellScalars);
+
+  // Description:
+  // Set cellIds to the ids of the cells whose scalar range contains
+  // value, in increasing order.  The tree must be built first.  The
+  // traversal is not changed, so several threads may call this at once.
+  void GetCellsAtValue(double value, vtkIdList *cellIds);
+
+  // Description:
+  // Build the tree if needed and add its arrays to fieldData, replacing
+  // those of a previous call.
+  void StoreTree(vtkFieldData *fieldData);
+
+  // Description:
+  // Use the tree arrays that StoreTree() added to fieldData, instead of
+  // building the tree, until the dataset or the scalars are modified.
+  // The arrays must have been stored for the same dataset and scalars.
+  // Return 1 if fieldData had tree arrays for the number of cells of the
+  // dataset, 0 otherwise.
+  int LoadTree(vtkFieldData *fieldData);
+
+  // Description:
+  // Return the number of cells in the tree, which leaves out the cells
+  // without points.
+  vtkIdType GetNumberOfTreeCells();
+
+protected:
+  vtkIntervalScalarTree();
+  ~vtkIntervalScalarTree();
+
+  // The center, number of straddling cells and number of cells of the
+  // lower subtree of each node, at the index of the first cell of the
+  // subtree of the node.
+  vtkDoubleArray *Nodes;
+  // The straddling cells of each node sorted by increasing minimum, then
+  // by decreasing maximum.
+  vtkIdTypeArray *Cells;
+  // The minimum and the maximum of the cells.
+  vtkDoubleArray *Ranges;
+
+  vtkDataArray *TreeScalars; // the scalars the tree was built from
+  vtkIdList *TraversalCells;
+  vtkIdType TraversalIndex;
+
+private:
+  vtkIntervalScalarTree(const vtkIntervalScalarTree&);  // Not implemented.
+  void operator=(const vtkIntervalScalarTree&);  // Not implemented.
+};
+
+#endif
@@ -161,7 +161,7 @@ vtkIdType vtkPointLocator::FindClosestPoint(const double x[3])
   int i, j;
   double minDist2;
   double dist2 = VTK_DOUBLE_MAX;
-  double *pt;
+  double pt[3];
   int closest, level;
   vtkIdType ptId, cno;
   vtkIdList *ptIds;
@@ -209,7 +209,7 @@ vtkIdType vtkPointLocator::FindClosestPoint(const double x[3])
         for (j=0; j < ptIds->GetNumberOfIds(); j++) 
           {
           ptId = ptIds->GetId(j);
-          pt = this->DataSet->GetPoint(ptId);
+          this->DataSet->GetPoint(ptId, pt);
           if ( (dist2 = vtkMath::Distance2BetweenPoints(x,pt)) < minDist2 ) 
             {
             closest = ptId;
@@ -238,7 +238,7 @@ vtkIdType vtkPointLocator::FindClosestPoint(const double x[3])
         for (j=0; j < ptIds->GetNumberOfIds(); j++) 
           {
           ptId = ptIds->GetId(j);
-          pt = this->DataSet->GetPoint(ptId);
+          this->DataSet->GetPoint(ptId, pt);
           if ( (dist2 = vtkMath::Distance2BetweenPoints(x,pt)) < minDist2 ) 
             {
             closest = ptId;
@@ -20,6 +20,7 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkPointLocator.h"
+#include "vtkScratchPool.h"
 #include "vtkSource.h"
 
 vtkCxxRevisionMacro(vtkPointSet, "1.3.12.1");
@@ -83,12 +84,22 @@ void vtkPointSet::ComputeBounds()
 
   if ( this->Points )
     {
+    // Nothing is written when the bounds did not change, so that several
+    // threads may ask for them.
     bounds = this->Points->GetBounds();
+    int changed = 0;
     for (int i=0; i<6; i++)
       {
-      this->Bounds[i] = bounds[i];
+      changed = changed || this->Bounds[i] != bounds[i];
+      }
+    if ( changed )
+      {
+      for (int j=0; j<6; j++)
+        {
+        this->Bounds[j] = bounds[j];
+        }
+      this->ComputeTime.Modified();
       }
-    this->ComputeTime.Modified();
     }
 }
 
@@ -158,10 +169,11 @@ vtkIdType vtkPointSet::FindCell(double x[3], vtkCell *cell,
     return -1;
     }
 
-  cellIds = vtkIdList::New();
-  cellIds->Allocate(8,100);
-  ptIds = vtkIdList::New();
-  ptIds->Allocate(8,100);
+  // The lists come from the pool of the thread, and keep their memory
+  // from one call to the next.
+  vtkScratchPool *pool = vtkScratchPool::GetThreadPool();
+  cellIds = pool->AcquireIdList();
+  ptIds = pool->AcquireIdList();
 
   if ( !this->Locator )
     {
@@ -185,8 +197,8 @@ vtkIdType vtkPointSet::FindCell(double x[3], vtkCell *cell,
     ptId = this->Locator->FindClosestPoint(x);
     if ( ptId < 0 )
       {
-      cellIds->Delete();
-      ptIds->Delete();
+      pool->ReleaseIdList(cellIds);
+      pool->ReleaseIdList(ptIds);
       return (-1); //if point completely outside of data
       }
 
@@ -217,8 +229,8 @@ vtkIdType vtkPointSet::FindCell(double x[3], vtkCell *cell,
                                     pcoords, dist2,weights) == 1
              && dist2 <= tol2 ) )
         {
-        cellIds->Delete();
-        ptIds->Delete();  
+        pool->ReleaseIdList(cellIds);
+        pool->ReleaseIdList(ptIds);
         return cellId;
         }
       }
@@ -271,16 +283,16 @@ vtkIdType vtkPointSet::FindCell(double x[3], vtkCell *cell,
                                                  dist2,weights) == 1 ) )
            && dist2 <= tol2 )
         {
-        cellIds->Delete();
-        ptIds->Delete();  
+        pool->ReleaseIdList(cellIds);
+        pool->ReleaseIdList(ptIds);
         return cellId;
         }
 
       }//for a walk
     }//if we have a starting cell
 
-  cellIds->Delete();
-  ptIds->Delete();
+  pool->ReleaseIdList(cellIds);
+  pool->ReleaseIdList(ptIds);
 
   //sometimes the initial cell is a really bad guess so we'll
   //just ignore it and start from scratch as a last resort
@@ -20,6 +20,7 @@
 #include "vtkDoubleArray.h"
 #include "vtkLine.h"
 #include "vtkPoints.h"
+#include "vtkScratchPool.h"
 
 vtkCxxRevisionMacro(vtkPolyLine, "1.1");
 vtkStandardNewMacro(vtkPolyLine);
@@ -457,7 +458,8 @@ void vtkPolyLine::Clip(double value, vtkDataArray *cellScalars,
                        int insideOut)
 {
   int i, numLines=this->Points->GetNumberOfPoints() - 1;
-  vtkDoubleArray *lineScalars=vtkDoubleArray::New();
+  vtkScratchPool *pool = vtkScratchPool::GetThreadPool();
+  vtkDoubleArray *lineScalars=pool->AcquireDoubleArray();
   lineScalars->SetNumberOfTuples(2);
 
   for ( i=0; i < numLines; i++)
@@ -475,7 +477,7 @@ void vtkPolyLine::Clip(double value, vtkDataArray *cellScalars,
                     inCd, cellId, outCd, insideOut);
     }
   
-  lineScalars->Delete();
+  pool->ReleaseDoubleArray(lineScalars);
 }
 
 //----------------------------------------------------------------------------
@@ -0,0 +1,349 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkPrefetchingStreamingDemandDrivenPipeline.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPrefetchingStreamingDemandDrivenPipeline.h"
+
+#include "vtkAlgorithm.h"
+#include "vtkCriticalSection.h"
+#include "vtkDataObject.h"
+#include "vtkInformation.h"
+#include "vtkInformationDoubleVectorKey.h"
+#include "vtkInformationExecutivePortVectorKey.h"
+#include "vtkInformationIntegerKey.h"
+#include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
+#include "vtkObjectFactory.h"
+
+vtkCxxRevisionMacro(vtkPrefetchingStreamingDemandDrivenPipeline, "1.1");
+vtkStandardNewMacro(vtkPrefetchingStreamingDemandDrivenPipeline);
+
+//----------------------------------------------------------------------------
+static VTK_THREAD_RETURN_TYPE vtkPrefetchingThread(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  static_cast<vtkPrefetchingStreamingDemandDrivenPipeline*>(info->UserData)
+    ->InternalPrefetch();
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+vtkPrefetchingStreamingDemandDrivenPipeline
+::vtkPrefetchingStreamingDemandDrivenPipeline()
+{
+  this->PrefetchTimeSteps = 1;
+  this->NumberOfPrefetches = 0;
+  this->NumberOfPrefetchHits = 0;
+  this->LastTimeIndex = -1;
+  this->TimeIndexStep = 1;
+  this->Threader = vtkMultiThreader::New();
+  this->PrefetchThreadID = -1;
+  this->PrefetchLock = vtkCriticalSection::New();
+  this->PrefetchFinished = 0;
+  this->PrefetchResult = 0;
+  this->PrefetchInformation = 0;
+  this->PrefetchProducer = 0;
+  this->PrefetchProducerPort = 0;
+  this->PrefetchHadTimeIndex = 0;
+  this->PrefetchRestoreTimeIndex = 0;
+  this->PrefetchPipelineMTime = 0;
+  this->PrefetchedDataTime = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkPrefetchingStreamingDemandDrivenPipeline
+::~vtkPrefetchingStreamingDemandDrivenPipeline()
+{
+  // The pipeline may already be half destroyed: only wait for the thread.
+  this->JoinPrefetchThread();
+  this->Threader->Delete();
+  this->PrefetchLock->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkPrefetchingStreamingDemandDrivenPipeline
+::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "PrefetchTimeSteps: "
+     << (this->PrefetchTimeSteps ? "On" : "Off") << "\n";
+  os << indent << "NumberOfPrefetches: " << this->NumberOfPrefetches << "\n";
+  os << indent << "NumberOfPrefetchHits: "
+     << this->NumberOfPrefetchHits << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkPrefetchingStreamingDemandDrivenPipeline::ResetPrefetchStatistics()
+{
+  this->NumberOfPrefetches = 0;
+  this->NumberOfPrefetchHits = 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkPrefetchingStreamingDemandDrivenPipeline::PrefetchTimeStep(int index)
+{
+  this->WaitForPrefetch();
+#if !defined(VTK_USE_PTHREADS) && !defined(VTK_HP_PTHREADS) && \
+    !defined(VTK_USE_WIN32_THREADS)
+  // Without threads there is nothing to gain.
+  (void)index;
+  return 0;
+#else
+  if(!this->Algorithm || this->GetNumberOfInputPorts() < 1 ||
+     this->GetInputInformation()[0]->GetNumberOfInformationObjects() < 1)
+    {
+    return 0;
+    }
+  vtkInformation* inInfo =
+    this->GetInputInformation()[0]->GetInformationObject(0);
+
+  // The producer must be a streaming executive that only we use, and
+  // the index must be a time step it has not been asked for.
+  vtkExecutive* producer;
+  int producerPort;
+  inInfo->Get(vtkExecutive::PRODUCER(), producer, producerPort);
+  if(!vtkStreamingDemandDrivenPipeline::SafeDownCast(producer) ||
+     inInfo->Length(vtkExecutive::CONSUMERS()) != 1 ||
+     index < 0 || index >= inInfo->Length(TIME_STEPS()) ||
+     (inInfo->Has(UPDATE_TIME_INDEX()) &&
+      inInfo->Get(UPDATE_TIME_INDEX()) == index))
+    {
+    return 0;
+    }
+
+  // Release the input now, so that the thread does not unregister the
+  // arrays our output may share with it.
+  vtkDataObject* input = inInfo->Get(vtkDataObject::DATA_OBJECT());
+  if(input)
+    {
+    input->ReleaseData();
+    }
+
+  // Reference counts are not atomic, and the garbage collector follows
+  // the consumers of the input to this executive and downstream.  Detach
+  // the producer from us until the thread is done.
+  this->PrefetchPipelineMTime = this->PipelineMTime;
+  this->PrefetchInformation = inInfo;
+  this->PrefetchProducer = producer;
+  this->PrefetchProducerPort = producerPort;
+  this->PrefetchHadTimeIndex = inInfo->Has(UPDATE_TIME_INDEX());
+  this->PrefetchRestoreTimeIndex =
+    this->PrefetchHadTimeIndex ? inInfo->Get(UPDATE_TIME_INDEX()) : 0;
+  inInfo->Set(UPDATE_TIME_INDEX(), index);
+  this->PrefetchFinished = 0;
+  this->PrefetchResult = 0;
+  inInfo->Remove(vtkExecutive::CONSUMERS(), this, 0);
+
+  this->PrefetchThreadID =
+    this->Threader->SpawnThread(vtkPrefetchingThread, this);
+  if(this->PrefetchThreadID < 0)
+    {
+    this->WaitForPrefetch();
+    return 0;
+    }
+  ++this->NumberOfPrefetches;
+  return 1;
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkPrefetchingStreamingDemandDrivenPipeline::InternalPrefetch()
+{
+  vtkStreamingDemandDrivenPipeline* producer =
+    static_cast<vtkStreamingDemandDrivenPipeline*>(this->PrefetchProducer);
+  int result = producer->Update(this->PrefetchProducerPort);
+  this->PrefetchLock->Lock();
+  this->PrefetchResult = result;
+  this->PrefetchFinished = 1;
+  this->PrefetchLock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+int vtkPrefetchingStreamingDemandDrivenPipeline::IsPrefetchRunning()
+{
+  if(this->PrefetchThreadID < 0)
+    {
+    return 0;
+    }
+  this->PrefetchLock->Lock();
+  int finished = this->PrefetchFinished;
+  this->PrefetchLock->Unlock();
+  return !finished;
+}
+
+//----------------------------------------------------------------------------
+void vtkPrefetchingStreamingDemandDrivenPipeline::JoinPrefetchThread()
+{
+  if(this->PrefetchThreadID >= 0)
+    {
+    this->Threader->TerminateThread(this->PrefetchThreadID);
+    this->PrefetchThreadID = -1;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPrefetchingStreamingDemandDrivenPipeline::WaitForPrefetch()
+{
+  if(!this->PrefetchInformation)
+    {
+    return;
+    }
+  this->JoinPrefetchThread();
+
+  // Attach the producer again, and restore the request it had so that
+  // the next one is compared with what it was really asked for.
+  vtkInformation* inInfo = this->PrefetchInformation;
+  this->PrefetchInformation = 0;
+  this->PrefetchProducer = 0;
+  inInfo->Append(vtkExecutive::CONSUMERS(), this, 0);
+  if(this->PrefetchHadTimeIndex)
+    {
+    inInfo->Set(UPDATE_TIME_INDEX(), this->PrefetchRestoreTimeIndex);
+    }
+  else
+    {
+    inInfo->Remove(UPDATE_TIME_INDEX());
+    }
+
+  vtkDataObject* input = inInfo->Get(vtkDataObject::DATA_OBJECT());
+  if(this->PrefetchResult && this->PrefetchFinished && input)
+    {
+    this->PrefetchedDataTime = input->GetUpdateTime();
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkPrefetchingStreamingDemandDrivenPipeline
+::ExecuteData(vtkInformation* request,
+              vtkInformationVector** inInfoVec,
+              vtkInformationVector* outInfoVec)
+{
+  // Count the executions that use the data read ahead, and follow the
+  // direction and the stride of the requested time steps.
+  int timeIndex = -1;
+  if(this->GetNumberOfInputPorts() > 0 &&
+     inInfoVec[0]->GetNumberOfInformationObjects() > 0)
+    {
+    vtkInformation* inInfo = inInfoVec[0]->GetInformationObject(0);
+    if(inInfo->Has(UPDATE_TIME_INDEX()))
+      {
+      timeIndex = inInfo->Get(UPDATE_TIME_INDEX());
+      vtkDataObject* input = inInfo->Get(vtkDataObject::DATA_OBJECT());
+      if(this->PrefetchedDataTime && input &&
+         input->GetUpdateTime() == this->PrefetchedDataTime)
+        {
+        ++this->NumberOfPrefetchHits;
+        }
+      if(this->LastTimeIndex >= 0 && timeIndex != this->LastTimeIndex)
+        {
+        this->TimeIndexStep = timeIndex - this->LastTimeIndex;
+        }
+      this->LastTimeIndex = timeIndex;
+      }
+    }
+  this->PrefetchedDataTime = 0;
+
+  int result = this->Superclass::ExecuteData(request, inInfoVec, outInfoVec);
+
+  if(result && timeIndex >= 0 && this->PrefetchTimeSteps &&
+     !this->ContinueExecuting)
+    {
+    this->PrefetchTimeStep(timeIndex + this->TimeIndexStep);
+    }
+  return result;
+}
+
+//----------------------------------------------------------------------------
+int vtkPrefetchingStreamingDemandDrivenPipeline
+::ForwardUpstream(vtkInformation* request)
+{
+  this->WaitForPrefetch();
+  return this->Superclass::ForwardUpstream(request);
+}
+
+//----------------------------------------------------------------------------
+int vtkPrefetchingStreamingDemandDrivenPipeline
+::CallAlgorithm(vtkInformation* request, int direction,
+                vtkInformationVector** inInfo,
+                vtkInformationVector* outInfo)
+{
+  this->WaitForPrefetch();
+  return this->Superclass::CallAlgorithm(request, direction, inInfo, outInfo);
+}
+
+//----------------------------------------------------------------------------
+int vtkPrefetchingStreamingDemandDrivenPipeline
+::ComputePipelineMTime(vtkInformation* request,
+                       vtkInformationVector** inInfoVec,
+                       vtkInformationVector* outInfoVec,
+                       int requestFromOutputPort,
+                       unsigned long* mtime)
+{
+  if(!this->IsPrefetchRunning())
+    {
+    this->WaitForPrefetch();
+    return this->Superclass::ComputePipelineMTime(request, inInfoVec,
+                                                  outInfoVec,
+                                                  requestFromOutputPort,
+                                                  mtime);
+    }
+
+  // Do not wait for the thread, nor visit the pipeline it updates: it
+  // may not be modified meanwhile, so its time is the one it had.
+  this->InAlgorithm = 1;
+  int result =
+    this->Algorithm->ComputePipelineMTime(request, inInfoVec, outInfoVec,
+                                          requestFromOutputPort,
+                                          &this->PipelineMTime);
+  this->InAlgorithm = 0;
+  if(!result)
+    {
+    return 0;
+    }
+  if(this->PrefetchPipelineMTime > this->PipelineMTime)
+    {
+    this->PipelineMTime = this->PrefetchPipelineMTime;
+    }
+  *mtime = this->PipelineMTime;
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+vtkDataObject*
+vtkPrefetchingStreamingDemandDrivenPipeline::GetInputData(int port,
+                                                          int connection)
+{
+  this->WaitForPrefetch();
+  return this->Superclass::GetInputData(port, connection);
+}
+
+//----------------------------------------------------------------------------
+vtkDataObject*
+vtkPrefetchingStreamingDemandDrivenPipeline
+::GetInputData(int port, int connection, vtkInformationVector** inInfoVec)
+{
+  this->WaitForPrefetch();
+  return this->Superclass::GetInputData(port, connection, inInfoVec);
+}
+
+//----------------------------------------------------------------------------
+void vtkPrefetchingStreamingDemandDrivenPipeline
+::ReportReferences(vtkGarbageCollector* collector)
+{
+  // A collection that reaches the upstream pipeline through us must not
+  // run while the thread changes it.  Only wait: the references may not
+  // change during the collection.
+  this->JoinPrefetchThread();
+  this->Superclass::ReportReferences(collector);
+}
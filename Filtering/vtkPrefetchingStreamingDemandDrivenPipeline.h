@@ -0,0 +1,164 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkPrefetchingStreamingDemandDrivenPipeline.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPrefetchingStreamingDemandDrivenPipeline - executive that reads time steps ahead
+// .SECTION Description
+// vtkPrefetchingStreamingDemandDrivenPipeline is an executive for the
+// algorithm directly downstream of a time-varying reader.  After each
+// execution for a time step, it predicts the next time step that will be
+// requested, and updates its input for that step on a background thread
+// while the application renders the current one.  When the next request
+// arrives, the executive waits for the background update to finish and
+// then proceeds as usual.  If the prediction was right, the input is
+// already up to date and the reader does not execute again.  The input
+// then holds the next time step, so that executing again for the same
+// time step, for example after a parameter of the algorithm changed,
+// reads it again.
+//
+// The predicted time step is the last one plus the difference between
+// the last two different ones, so that playback in either direction and
+// with any stride is followed.  An application that knows better, for
+// example from the play mode of its animation scene, can call
+// PrefetchTimeStep() itself.
+//
+// Time steps are read ahead only when the input information has
+// TIME_STEPS, the request has an UPDATE_TIME_INDEX, and this executive
+// is the only consumer of its first input.  While a time step is read
+// ahead, the algorithms upstream run on another thread: they must not be
+// used, modified or deleted directly until WaitForPrefetch() has been
+// called or a request has been made through this executive.  The
+// executive keeps the upstream and downstream pipelines apart for the
+// garbage collector meanwhile.
+
+// .SECTION See Also
+// vtkStreamingDemandDrivenPipeline vtkCachedStreamingDemandDrivenPipeline
+
+#ifndef __vtkPrefetchingStreamingDemandDrivenPipeline_h
+#define __vtkPrefetchingStreamingDemandDrivenPipeline_h
+
+#include "vtkStreamingDemandDrivenPipeline.h"
+
+class vtkCriticalSection;
+class vtkMultiThreader;
+
+class VTK_FILTERING_EXPORT vtkPrefetchingStreamingDemandDrivenPipeline :
+  public vtkStreamingDemandDrivenPipeline
+{
+public:
+  static vtkPrefetchingStreamingDemandDrivenPipeline* New();
+  vtkTypeRevisionMacro(vtkPrefetchingStreamingDemandDrivenPipeline,
+                       vtkStreamingDemandDrivenPipeline);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Whether to read the predicted time step ahead after each execution.
+  // It is on by default.
+  vtkSetMacro(PrefetchTimeSteps, int);
+  vtkGetMacro(PrefetchTimeSteps, int);
+  vtkBooleanMacro(PrefetchTimeSteps, int);
+
+  // Description:
+  // Start updating the input for the given time index on a background
+  // thread, after waiting for a previous one.  Return 1 if it was
+  // started, 0 if the index is out of range or the input cannot be
+  // updated ahead.
+  int PrefetchTimeStep(int timeIndex);
+
+  // Description:
+  // Wait for the background update of the input, if any, and hand its
+  // result over to the pipeline.
+  void WaitForPrefetch();
+
+  // Description:
+  // The number of time steps read ahead, and the number of executions
+  // that used one of them, since construction or the last call to
+  // ResetPrefetchStatistics().
+  vtkGetMacro(NumberOfPrefetches, int);
+  vtkGetMacro(NumberOfPrefetchHits, int);
+  void ResetPrefetchStatistics();
+
+  // Description:
+  // Update the input for the prefetched time step.  For internal use
+  // only: this runs on the background thread.
+  void InternalPrefetch();
+
+  // Description:
+  // Overridden to wait for the background update before the input is
+  // used.
+  virtual int CallAlgorithm(vtkInformation* request, int direction,
+                            vtkInformationVector** inInfo,
+                            vtkInformationVector* outInfo);
+  virtual int ComputePipelineMTime(vtkInformation* request,
+                                   vtkInformationVector** inInfoVec,
+                                   vtkInformationVector* outInfoVec,
+                                   int requestFromOutputPort,
+                                   unsigned long* mtime);
+  virtual vtkDataObject* GetInputData(int port, int connection);
+  virtual vtkDataObject* GetInputData(int port, int connection,
+                                      vtkInformationVector **inInfoVec);
+
+protected:
+  vtkPrefetchingStreamingDemandDrivenPipeline();
+  ~vtkPrefetchingStreamingDemandDrivenPipeline();
+
+  virtual int ExecuteData(vtkInformation* request,
+                          vtkInformationVector** inInfoVec,
+                          vtkInformationVector* outInfoVec);
+  virtual int ForwardUpstream(vtkInformation* request);
+  virtual void ReportReferences(vtkGarbageCollector*);
+
+  // Wait for the background thread to end, without touching the
+  // pipeline.
+  void JoinPrefetchThread();
+
+  // Return whether the background update is still running.
+  int IsPrefetchRunning();
+
+  int PrefetchTimeSteps;
+  int NumberOfPrefetches;
+  int NumberOfPrefetchHits;
+
+  // The last time index the input was updated for in a request, and the
+  // difference between the last two different ones.
+  int LastTimeIndex;
+  int TimeIndexStep;
+
+  vtkMultiThreader* Threader;
+  int PrefetchThreadID;
+  vtkCriticalSection* PrefetchLock;
+  int PrefetchFinished;
+  int PrefetchResult;
+
+  // The input information being updated ahead, its producer, and what
+  // to restore in it when the update is handed over.
+  vtkInformation* PrefetchInformation;
+  vtkExecutive* PrefetchProducer;
+  int PrefetchProducerPort;
+  int PrefetchHadTimeIndex;
+  int PrefetchRestoreTimeIndex;
+
+  // The pipeline time when the background update started, used instead
+  // of visiting the upstream pipeline while it runs.
+  unsigned long PrefetchPipelineMTime;
+
+  // The update time of the input data produced ahead, until an
+  // execution uses it or not.
+  unsigned long PrefetchedDataTime;
+
+private:
+  vtkPrefetchingStreamingDemandDrivenPipeline(const vtkPrefetchingStreamingDemandDrivenPipeline&);  // Not implemented.
+  void operator=(const vtkPrefetchingStreamingDemandDrivenPipeline&);  // Not implemented.
+};
+
+#endif
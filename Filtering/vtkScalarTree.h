@@ -51,6 +51,13 @@ public:
   virtual void SetDataSet(vtkDataSet*);
   vtkGetObjectMacro(DataSet,vtkDataSet);
 
+  // Description:
+  // Set/Get the point scalars to build the tree from.  When none are
+  // set, the active point scalars of the DataSet are used.  Filters set
+  // them to the array they process, which need not be the active one.
+  virtual void SetScalars(vtkDataArray*);
+  vtkGetObjectMacro(Scalars,vtkDataArray);
+
   // Description:
   // Construct the scalar tree from the dataset provided. Checks build times
   // and modified time from input and reconstructs the tree if necessary.
@@ -78,7 +85,7 @@ protected:
   ~vtkScalarTree();
 
   vtkDataSet   *DataSet;    //the dataset over which the scalar tree is built
-  vtkDataArray *Scalars;    //the scalars of the DataSet
+  vtkDataArray *Scalars;    //the scalars to build from, or NULL for the active ones
 
   vtkTimeStamp BuildTime; //time at which tree was built
   double       ScalarValue; //current scalar value for traversal
@@ -0,0 +1,364 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkScratchPool.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkScratchPool.h"
+
+#include "vtkCriticalSection.h"
+#include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkInformation.h"
+#include "vtkInformationIntegerKey.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
+
+#if defined(VTK_USE_PTHREADS)
+# include <pthread.h>
+#elif defined(VTK_USE_WIN32_THREADS)
+# include "vtkWindows.h"
+#endif
+
+vtkCxxRevisionMacro(vtkScratchPool, "1.1");
+vtkStandardNewMacro(vtkScratchPool);
+
+vtkInformationKeyMacro(vtkScratchPool, EXECUTION_ALLOCATIONS, Integer);
+vtkInformationKeyMacro(vtkScratchPool, EXECUTION_ACQUISITIONS, Integer);
+
+//----------------------------------------------------------------------------
+class vtkScratchPoolInternals
+{
+public:
+  vtkstd::vector<vtkIdList*> IdLists;
+  vtkstd::vector<vtkPoints*> Points;
+  vtkstd::vector<vtkDoubleArray*> DoubleArrays;
+  vtkstd::vector<vtkGenericCell*> GenericCells;
+};
+
+//----------------------------------------------------------------------------
+#if defined(VTK_USE_PTHREADS)
+static void vtkScratchPoolThreadExit(void *value);
+#endif
+
+//----------------------------------------------------------------------------
+// All the pools, for the statistics, and the pools of the threads.  The
+// lock protects the lists and the counts of the deleted pools.
+class vtkScratchPoolRegistry
+{
+public:
+  vtkScratchPoolRegistry()
+    {
+    this->RetiredAllocations = 0;
+    this->RetiredAcquisitions = 0;
+#if defined(VTK_USE_PTHREADS)
+    pthread_key_create(&this->PoolKey, vtkScratchPoolThreadExit);
+#elif defined(VTK_USE_WIN32_THREADS)
+    this->PoolKey = TlsAlloc();
+#else
+    this->Pool = 0;
+#endif
+    }
+  ~vtkScratchPoolRegistry()
+    {
+    // Delete the pools of the threads still running, including the main
+    // thread.  They remove themselves from the lists.
+    vtkstd::vector<vtkScratchPool*> threadPools = this->ThreadPools;
+    this->ThreadPools.clear();
+    for (size_t i = 0; i < threadPools.size(); ++i)
+      {
+      threadPools[i]->Delete();
+      }
+#if defined(VTK_USE_PTHREADS)
+    pthread_key_delete(this->PoolKey);
+#elif defined(VTK_USE_WIN32_THREADS)
+    TlsFree(this->PoolKey);
+#endif
+    }
+
+  vtkScratchPool *GetThreadPool()
+    {
+    void *value;
+#if defined(VTK_USE_PTHREADS)
+    value = pthread_getspecific(this->PoolKey);
+#elif defined(VTK_USE_WIN32_THREADS)
+    value = TlsGetValue(this->PoolKey);
+#else
+    value = this->Pool;
+#endif
+    vtkScratchPool *pool = static_cast<vtkScratchPool *>(value);
+    if (!pool)
+      {
+      pool = vtkScratchPool::New();
+      this->Lock.Lock();
+      this->ThreadPools.push_back(pool);
+      this->Lock.Unlock();
+#if defined(VTK_USE_PTHREADS)
+      pthread_setspecific(this->PoolKey, pool);
+#elif defined(VTK_USE_WIN32_THREADS)
+      TlsSetValue(this->PoolKey, pool);
+#else
+      this->Pool = pool;
+#endif
+      }
+    return pool;
+    }
+
+  // Delete the pool of a thread that exits.
+  void DeleteThreadPool(vtkScratchPool *pool)
+    {
+    this->Lock.Lock();
+    vtkstd::vector<vtkScratchPool*>::iterator i =
+      vtkstd::find(this->ThreadPools.begin(), this->ThreadPools.end(), pool);
+    int found = (i != this->ThreadPools.end());
+    if (found)
+      {
+      this->ThreadPools.erase(i);
+      }
+    this->Lock.Unlock();
+    if (found)
+      {
+      pool->Delete();
+      }
+    }
+
+  void AddPool(vtkScratchPool *pool)
+    {
+    this->Lock.Lock();
+    this->Pools.push_back(pool);
+    this->Lock.Unlock();
+    }
+
+  void RemovePool(vtkScratchPool *pool)
+    {
+    this->Lock.Lock();
+    vtkstd::vector<vtkScratchPool*>::iterator i =
+      vtkstd::find(this->Pools.begin(), this->Pools.end(), pool);
+    if (i != this->Pools.end())
+      {
+      this->Pools.erase(i);
+      }
+    this->RetiredAllocations += pool->GetNumberOfAllocations();
+    this->RetiredAcquisitions += pool->GetNumberOfAcquisitions();
+    this->Lock.Unlock();
+    }
+
+  // Sum the counts of all the pools.  Those of the other threads may be
+  // changing, and are read as they are.
+  void GetTotals(unsigned long& allocations, unsigned long& acquisitions)
+    {
+    this->Lock.Lock();
+    allocations = this->RetiredAllocations;
+    acquisitions = this->RetiredAcquisitions;
+    for (size_t i = 0; i < this->Pools.size(); ++i)
+      {
+      allocations += this->Pools[i]->GetNumberOfAllocations();
+      acquisitions += this->Pools[i]->GetNumberOfAcquisitions();
+      }
+    this->Lock.Unlock();
+    }
+
+  vtkSimpleCriticalSection Lock;
+  vtkstd::vector<vtkScratchPool*> Pools;
+  vtkstd::vector<vtkScratchPool*> ThreadPools;
+  unsigned long RetiredAllocations;
+  unsigned long RetiredAcquisitions;
+#if defined(VTK_USE_PTHREADS)
+  pthread_key_t PoolKey;
+#elif defined(VTK_USE_WIN32_THREADS)
+  DWORD PoolKey;
+#else
+  vtkScratchPool *Pool;
+#endif
+};
+
+static vtkScratchPoolRegistry vtkScratchPoolPools;
+
+#if defined(VTK_USE_PTHREADS)
+//----------------------------------------------------------------------------
+static void vtkScratchPoolThreadExit(void *value)
+{
+  vtkScratchPoolPools.DeleteThreadPool(static_cast<vtkScratchPool *>(value));
+}
+#endif
+
+//----------------------------------------------------------------------------
+// Take an object from a free list, or create one.
+template <class T>
+static T *vtkScratchPoolAcquire(vtkstd::vector<T*>& objects,
+                                unsigned long& allocations)
+{
+  if (objects.empty())
+    {
+    ++allocations;
+    return T::New();
+    }
+  T *obj = objects.back();
+  objects.pop_back();
+  return obj;
+}
+
+//----------------------------------------------------------------------------
+// Put an object back in a free list, or delete it if the list is full.
+template <class T>
+static void vtkScratchPoolRelease(vtkstd::vector<T*>& objects, T *obj)
+{
+  if (objects.size() < VTK_SCRATCH_POOL_SIZE)
+    {
+    objects.push_back(obj);
+    }
+  else
+    {
+    obj->Delete();
+    }
+}
+
+//----------------------------------------------------------------------------
+// Delete the objects of a free list.
+template <class T>
+static void vtkScratchPoolClear(vtkstd::vector<T*>& objects)
+{
+  for (size_t i = 0; i < objects.size(); ++i)
+    {
+    objects[i]->Delete();
+    }
+  objects.clear();
+}
+
+//----------------------------------------------------------------------------
+vtkScratchPool::vtkScratchPool()
+{
+  this->NumberOfAllocations = 0;
+  this->NumberOfAcquisitions = 0;
+  this->Internals = new vtkScratchPoolInternals;
+  vtkScratchPoolPools.AddPool(this);
+}
+
+//----------------------------------------------------------------------------
+vtkScratchPool::~vtkScratchPool()
+{
+  vtkScratchPoolPools.RemovePool(this);
+  vtkScratchPoolClear(this->Internals->IdLists);
+  vtkScratchPoolClear(this->Internals->Points);
+  vtkScratchPoolClear(this->Internals->DoubleArrays);
+  vtkScratchPoolClear(this->Internals->GenericCells);
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+vtkScratchPool *vtkScratchPool::GetThreadPool()
+{
+  return vtkScratchPoolPools.GetThreadPool();
+}
+
+//----------------------------------------------------------------------------
+vtkIdList *vtkScratchPool::AcquireIdList()
+{
+  ++this->NumberOfAcquisitions;
+  return vtkScratchPoolAcquire(this->Internals->IdLists,
+                               this->NumberOfAllocations);
+}
+
+//----------------------------------------------------------------------------
+vtkPoints *vtkScratchPool::AcquirePoints()
+{
+  ++this->NumberOfAcquisitions;
+  return vtkScratchPoolAcquire(this->Internals->Points,
+                               this->NumberOfAllocations);
+}
+
+//----------------------------------------------------------------------------
+vtkDoubleArray *vtkScratchPool::AcquireDoubleArray()
+{
+  ++this->NumberOfAcquisitions;
+  return vtkScratchPoolAcquire(this->Internals->DoubleArrays,
+                               this->NumberOfAllocations);
+}
+
+//----------------------------------------------------------------------------
+vtkGenericCell *vtkScratchPool::AcquireGenericCell()
+{
+  ++this->NumberOfAcquisitions;
+  return vtkScratchPoolAcquire(this->Internals->GenericCells,
+                               this->NumberOfAllocations);
+}
+
+//----------------------------------------------------------------------------
+void vtkScratchPool::ReleaseIdList(vtkIdList *list)
+{
+  list->Reset();
+  vtkScratchPoolRelease(this->Internals->IdLists, list);
+}
+
+//----------------------------------------------------------------------------
+void vtkScratchPool::ReleasePoints(vtkPoints *points)
+{
+  if (points->GetDataType() != VTK_FLOAT)
+    {
+    points->Delete();
+    return;
+    }
+  points->Reset();
+  vtkScratchPoolRelease(this->Internals->Points, points);
+}
+
+//----------------------------------------------------------------------------
+void vtkScratchPool::ReleaseDoubleArray(vtkDoubleArray *array)
+{
+  array->Reset();
+  array->SetNumberOfComponents(1);
+  vtkScratchPoolRelease(this->Internals->DoubleArrays, array);
+}
+
+//----------------------------------------------------------------------------
+void vtkScratchPool::ReleaseGenericCell(vtkGenericCell *cell)
+{
+  vtkScratchPoolRelease(this->Internals->GenericCells, cell);
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkScratchPool::GetTotalNumberOfAllocations()
+{
+  unsigned long allocations;
+  unsigned long acquisitions;
+  vtkScratchPoolPools.GetTotals(allocations, acquisitions);
+  return allocations;
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkScratchPool::GetTotalNumberOfAcquisitions()
+{
+  unsigned long allocations;
+  unsigned long acquisitions;
+  vtkScratchPoolPools.GetTotals(allocations, acquisitions);
+  return acquisitions;
+}
+
+//----------------------------------------------------------------------------
+void vtkScratchPool::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Number Of Allocations: "
+     << this->NumberOfAllocations << "\n";
+  os << indent << "Number Of Acquisitions: "
+     << this->NumberOfAcquisitions << "\n";
+  os << indent << "Id Lists: " << this->Internals->IdLists.size() << "\n";
+  os << indent << "Points: " << this->Internals->Points.size() << "\n";
+  os << indent << "Double Arrays: "
+     << this->Internals->DoubleArrays.size() << "\n";
+  os << indent << "Generic Cells: "
+     << this->Internals->GenericCells.size() << "\n";
+}
@@ -0,0 +1,113 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkScratchPool.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkScratchPool - per-thread pool of temporary lists, points and cells
+// .SECTION Description
+// vtkScratchPool keeps id lists, points, double arrays and generic cells
+// that code called once per cell or per point can take instead of
+// creating and deleting its own.  Objects given back are reset but keep
+// their memory, like the blocks of vtkHeap, so that after the first few
+// calls taking one allocates nothing.  A pool is not thread safe: each
+// thread uses its own, returned by GetThreadPool().  The pool of a thread
+// is deleted when the thread exits, except on Windows where it is kept
+// until the program exits.
+//
+// An object must be given back to the pool it was taken from, and must
+// not be kept or registered by the caller afterwards.  A pool keeps at
+// most VTK_SCRATCH_POOL_SIZE objects of each kind, and deletes others.
+//
+// Each pool counts the objects it had to create and the objects taken
+// from it.  vtkDemandDrivenPipeline stores the increase of the totals
+// over all pools during each execution of an algorithm in its
+// information, under the EXECUTION_ALLOCATIONS() and
+// EXECUTION_ACQUISITIONS() keys.
+
+// .SECTION See Also
+// vtkHeap vtkGenericCell
+
+#ifndef __vtkScratchPool_h
+#define __vtkScratchPool_h
+
+#include "vtkObject.h"
+
+#define VTK_SCRATCH_POOL_SIZE 64
+
+class vtkDoubleArray;
+class vtkGenericCell;
+class vtkIdList;
+class vtkInformationIntegerKey;
+class vtkPoints;
+class vtkScratchPoolInternals;
+
+class VTK_FILTERING_EXPORT vtkScratchPool : public vtkObject
+{
+public:
+  static vtkScratchPool *New();
+  vtkTypeRevisionMacro(vtkScratchPool,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Return the pool of the calling thread, created when first asked
+  // for.  It must not be deleted.
+  static vtkScratchPool *GetThreadPool();
+
+  // Description:
+  // Take an empty id list, points, double array or generic cell from
+  // the pool, creating one if there is none.  The points have the
+  // float type, and the array has one component.
+  vtkIdList *AcquireIdList();
+  vtkPoints *AcquirePoints();
+  vtkDoubleArray *AcquireDoubleArray();
+  vtkGenericCell *AcquireGenericCell();
+
+  // Description:
+  // Give back an object taken from this pool.
+  void ReleaseIdList(vtkIdList *list);
+  void ReleasePoints(vtkPoints *points);
+  void ReleaseDoubleArray(vtkDoubleArray *array);
+  void ReleaseGenericCell(vtkGenericCell *cell);
+
+  // Description:
+  // The number of objects this pool created, and the number of objects
+  // taken from it.
+  vtkGetMacro(NumberOfAllocations, unsigned long);
+  vtkGetMacro(NumberOfAcquisitions, unsigned long);
+
+  // Description:
+  // The same numbers summed over all the pools, including those of the
+  // threads that exited.
+  static unsigned long GetTotalNumberOfAllocations();
+  static unsigned long GetTotalNumberOfAcquisitions();
+
+  // Description:
+  // Keys set in the information of an algorithm after each execution
+  // to the objects allocated and taken by all pools meanwhile.
+  static vtkInformationIntegerKey* EXECUTION_ALLOCATIONS();
+  static vtkInformationIntegerKey* EXECUTION_ACQUISITIONS();
+
+protected:
+  vtkScratchPool();
+  ~vtkScratchPool();
+
+  unsigned long NumberOfAllocations;
+  unsigned long NumberOfAcquisitions;
+
+  vtkScratchPoolInternals *Internals;
+
+private:
+  vtkScratchPool(const vtkScratchPool&);  // Not implemented.
+  void operator=(const vtkScratchPool&);  // Not implemented.
+};
+
+#endif
@@ -85,15 +85,19 @@ void vtkSimpleScalarTree::BuildTree()
     return;
     }
 
+  // GetScalars() returns the scalars given to the superclass, if any.
+  vtkDataArray *scalars = this->GetScalars();
   if ( this->Tree != NULL && this->BuildTime > this->MTime 
-    && this->BuildTime > this->DataSet->GetMTime() )
+    && this->BuildTime > this->DataSet->GetMTime()
+    && (!scalars || this->BuildTime > scalars->GetMTime()) )
     {
     return;
     }
 
   vtkDebugMacro( << "Building scalar tree..." );
 
-  this->Scalars = this->DataSet->GetPointData()->GetScalars();
+  this->Scalars = scalars ? scalars :
+    this->DataSet->GetPointData()->GetScalars();
   if ( ! this->Scalars )
     {
     vtkErrorMacro( << "No scalar data to build trees with");
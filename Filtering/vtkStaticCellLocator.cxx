@@ -0,0 +1,1050 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkStaticCellLocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkStaticCellLocator.h"
+
+#include "vtkAtomic.h"
+#include "vtkBox.h"
+#include "vtkCellArray.h"
+#include "vtkDataSet.h"
+#include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkScratchPool.h"
+#include "vtkTaskScheduler.h"
+
+#include <vtkstd/algorithm>
+
+#include <math.h>
+#include <string.h>
+
+vtkCxxRevisionMacro(vtkStaticCellLocator, "1.1");
+vtkStandardNewMacro(vtkStaticCellLocator);
+
+// The number of cells, or of queries, handled by a task.
+#define VTK_STATIC_CELL_LOCATOR_TASK_SIZE 1024
+
+// The largest number of buckets along an axis.
+#define VTK_STATIC_CELL_LOCATOR_MAX_DIVISIONS 1024
+
+//----------------------------------------------------------------------------
+// What the tasks building the buckets need.  The cells are counted and
+// placed in the buckets with atomic additions, so the tasks need no
+// scratch space of their own.
+struct vtkStaticCellLocatorBuildData
+{
+  vtkDataSet *DataSet;
+  double *CellBounds; // NULL if the bounds are not kept
+  double Bounds[6];
+  double H[3];
+  int Divisions[3];
+  vtkIdType NumberOfBuckets;
+  int Parallel;       // whether several tasks share the counts
+  vtkIdType *Counts;  // the count, then the next position, of each bucket
+  vtkIdType *Offsets;
+  vtkIdType *CellIds;
+};
+
+//----------------------------------------------------------------------------
+// Add one to *value, atomically if several tasks share it, and return
+// the value it had.
+static inline vtkIdType vtkStaticCellLocatorFetchAndIncrement(
+  vtkStaticCellLocatorBuildData *bd, vtkIdType *value)
+{
+  if (!bd->Parallel)
+    {
+    return (*value)++;
+    }
+  return vtkAtomic::FetchAndAdd(value, 1);
+}
+
+//----------------------------------------------------------------------------
+// Compute the range of buckets overlapped by the bounds of cellId,
+// enlarged by a hundredth of a bucket as vtkCellLocator does.
+static void vtkStaticCellLocatorGetCellBuckets(
+  vtkStaticCellLocatorBuildData *bd, vtkIdType cellId,
+  int ijkMin[3], int ijkMax[3])
+{
+  double cellBounds[6];
+  double *bounds = cellBounds;
+  if (bd->CellBounds)
+    {
+    bounds = bd->CellBounds + 6*cellId;
+    }
+  else
+    {
+    bd->DataSet->GetCellBounds(cellId, cellBounds);
+    }
+  for (int i = 0; i < 3; ++i)
+    {
+    double hTol = bd->H[i]/100.0;
+    ijkMin[i] = (int)((bounds[2*i] - bd->Bounds[2*i] - hTol) / bd->H[i]);
+    ijkMax[i] = (int)((bounds[2*i+1] - bd->Bounds[2*i] + hTol) / bd->H[i]);
+    ijkMin[i] = (ijkMin[i] < 0 ? 0 : ijkMin[i]);
+    ijkMax[i] = (ijkMax[i] >= bd->Divisions[i] ?
+                 bd->Divisions[i] - 1 : ijkMax[i]);
+    }
+}
+
+//----------------------------------------------------------------------------
+static void vtkStaticCellLocatorComputeBounds(void *arg, vtkIdType begin,
+                                              vtkIdType end)
+{
+  vtkStaticCellLocatorBuildData *bd =
+    static_cast<vtkStaticCellLocatorBuildData *>(arg);
+  for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+    bd->DataSet->GetCellBounds(cellId, bd->CellBounds + 6*cellId);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Count the cells [begin, end) in each bucket.
+static void vtkStaticCellLocatorCountCells(void *arg, vtkIdType begin,
+                                           vtkIdType end)
+{
+  vtkStaticCellLocatorBuildData *bd =
+    static_cast<vtkStaticCellLocatorBuildData *>(arg);
+  int ijkMin[3], ijkMax[3];
+  int i, j, k;
+  for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+    vtkStaticCellLocatorGetCellBuckets(bd, cellId, ijkMin, ijkMax);
+    for (k = ijkMin[2]; k <= ijkMax[2]; ++k)
+      {
+      for (j = ijkMin[1]; j <= ijkMax[1]; ++j)
+        {
+        vtkIdType idx = ((vtkIdType)k*bd->Divisions[1] + j)*
+          bd->Divisions[0];
+        for (i = ijkMin[0]; i <= ijkMax[0]; ++i)
+          {
+          vtkStaticCellLocatorFetchAndIncrement(bd, bd->Counts + idx + i);
+          }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Place the cells [begin, end) in the buckets.  The counts hold the next
+// free position of each bucket.
+static void vtkStaticCellLocatorFillBuckets(void *arg, vtkIdType begin,
+                                            vtkIdType end)
+{
+  vtkStaticCellLocatorBuildData *bd =
+    static_cast<vtkStaticCellLocatorBuildData *>(arg);
+  int ijkMin[3], ijkMax[3];
+  int i, j, k;
+  for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+    vtkStaticCellLocatorGetCellBuckets(bd, cellId, ijkMin, ijkMax);
+    for (k = ijkMin[2]; k <= ijkMax[2]; ++k)
+      {
+      for (j = ijkMin[1]; j <= ijkMax[1]; ++j)
+        {
+        vtkIdType idx = ((vtkIdType)k*bd->Divisions[1] + j)*
+          bd->Divisions[0];
+        for (i = ijkMin[0]; i <= ijkMax[0]; ++i)
+          {
+          bd->CellIds[vtkStaticCellLocatorFetchAndIncrement(
+                        bd, bd->Counts + idx + i)] = cellId;
+          }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Sort the cells of the buckets [begin, end), which the tasks filling
+// them left in any order.
+static void vtkStaticCellLocatorSortBuckets(void *arg, vtkIdType begin,
+                                            vtkIdType end)
+{
+  vtkStaticCellLocatorBuildData *bd =
+    static_cast<vtkStaticCellLocatorBuildData *>(arg);
+  for (vtkIdType bucket = begin; bucket < end; ++bucket)
+    {
+    vtkstd::sort(bd->CellIds + bd->Offsets[bucket],
+                 bd->CellIds + bd->Offsets[bucket + 1]);
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkStaticCellLocator::vtkStaticCellLocator()
+{
+  this->NumberOfCellsPerBucket = 10;
+  this->Divisions[0] = this->Divisions[1] = this->Divisions[2] = 1;
+  this->CacheCellBounds = 1;
+  for (int i = 0; i < 3; ++i)
+    {
+    this->Bounds[2*i] = 0.0;
+    this->Bounds[2*i+1] = 1.0;
+    this->H[i] = 1.0;
+    }
+  this->MaxCellSize = 0;
+  this->Offsets = vtkIdTypeArray::New();
+  this->CellIds = vtkIdTypeArray::New();
+  this->CellBounds = vtkDoubleArray::New();
+  this->CellBounds->SetNumberOfComponents(6);
+}
+
+//----------------------------------------------------------------------------
+vtkStaticCellLocator::~vtkStaticCellLocator()
+{
+  this->Offsets->Delete();
+  this->CellIds->Delete();
+  this->CellBounds->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticCellLocator::FreeSearchStructure()
+{
+  this->Offsets->Initialize();
+  this->CellIds->Initialize();
+  this->CellBounds->Initialize();
+  this->CellBounds->SetNumberOfComponents(6);
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticCellLocator::BuildLocator()
+{
+  vtkIdType numCells;
+  int i;
+
+  if ( this->DataSet && this->Offsets->GetNumberOfTuples() > 0 &&
+       this->BuildTime > this->MTime &&
+       this->BuildTime > this->DataSet->GetMTime() )
+    {
+    return;
+    }
+
+  vtkDebugMacro( << "Filling buckets..." );
+
+  if ( !this->DataSet || (numCells = this->DataSet->GetNumberOfCells()) < 1 )
+    {
+    vtkErrorMacro( << "No cells to subdivide");
+    return;
+    }
+  this->FreeSearchStructure();
+
+  // Size the buckets as vtkCellLocator sizes its octants.
+  double *bounds = this->DataSet->GetBounds();
+  double length = this->DataSet->GetLength();
+  for (i = 0; i < 3; ++i)
+    {
+    this->Bounds[2*i] = bounds[2*i];
+    this->Bounds[2*i+1] = bounds[2*i+1];
+    if ( (this->Bounds[2*i+1] - this->Bounds[2*i]) <= (length/1000.0) )
+      {
+      // bump out the bounds a little of if min==max
+      this->Bounds[2*i] -= length/100.0;
+      this->Bounds[2*i+1] += length/100.0;
+      }
+    }
+  if ( length <= 0.0 )
+    {
+    for (i = 0; i < 3; ++i)
+      {
+      this->Bounds[2*i+1] = this->Bounds[2*i] + 1.0;
+      }
+    }
+
+  if ( this->Automatic )
+    {
+    // Buckets of about equal sides, NumberOfCellsPerBucket cells each.
+    double volume = 1.0;
+    for (i = 0; i < 3; ++i)
+      {
+      volume *= this->Bounds[2*i+1] - this->Bounds[2*i];
+      }
+    double numBuckets = (double)numCells / this->NumberOfCellsPerBucket;
+    double side = pow(volume / numBuckets, 1.0/3.0);
+    for (i = 0; i < 3; ++i)
+      {
+      double ndivs = ceil((this->Bounds[2*i+1] - this->Bounds[2*i]) / side);
+      this->Divisions[i] = (ndivs > VTK_STATIC_CELL_LOCATOR_MAX_DIVISIONS ?
+                            VTK_STATIC_CELL_LOCATOR_MAX_DIVISIONS :
+                            (int)ndivs);
+      }
+    }
+  for (i = 0; i < 3; ++i)
+    {
+    this->Divisions[i] = (this->Divisions[i] < 1 ? 1 :
+                          (this->Divisions[i] >
+                           VTK_STATIC_CELL_LOCATOR_MAX_DIVISIONS ?
+                           VTK_STATIC_CELL_LOCATOR_MAX_DIVISIONS :
+                           this->Divisions[i]));
+    this->H[i] = (this->Bounds[2*i+1] - this->Bounds[2*i]) /
+      this->Divisions[i];
+    }
+  this->MaxCellSize = this->DataSet->GetMaxCellSize();
+
+  vtkTaskScheduler *scheduler = vtkTaskScheduler::GetGlobalScheduler();
+  vtkStaticCellLocatorBuildData bd;
+  bd.DataSet = this->DataSet;
+  for (i = 0; i < 3; ++i)
+    {
+    bd.Bounds[2*i] = this->Bounds[2*i];
+    bd.Bounds[2*i+1] = this->Bounds[2*i+1];
+    bd.H[i] = this->H[i];
+    bd.Divisions[i] = this->Divisions[i];
+    }
+  bd.NumberOfBuckets = this->GetNumberOfBuckets();
+
+  // The first cell bounds are computed here, since poly data builds its
+  // cells when they are first asked for.
+  double cellBounds[6];
+  this->DataSet->GetCellBounds(0, cellBounds);
+  bd.CellBounds = NULL;
+  if ( this->CacheCellBounds )
+    {
+    this->CellBounds->SetNumberOfTuples(numCells);
+    bd.CellBounds = this->CellBounds->GetPointer(0);
+    scheduler->ParallelFor(0, numCells, VTK_STATIC_CELL_LOCATOR_TASK_SIZE,
+                           vtkStaticCellLocatorComputeBounds, &bd);
+    }
+
+  // Count the cells in each bucket, turn the counts into the start of
+  // each bucket, then fill the buckets.
+  // Without atomic instructions the buckets are built by a single task.
+  bd.Parallel =
+    (scheduler->GetNumberOfThreads() > 1 && vtkAtomic::IsLockFree());
+  vtkIdType grain =
+    (bd.Parallel ? VTK_STATIC_CELL_LOCATOR_TASK_SIZE : numCells);
+  bd.Counts = new vtkIdType[bd.NumberOfBuckets];
+  memset(bd.Counts, 0, bd.NumberOfBuckets*sizeof(vtkIdType));
+  scheduler->ParallelFor(0, numCells, grain,
+                         vtkStaticCellLocatorCountCells, &bd);
+
+  this->Offsets->SetNumberOfValues(bd.NumberOfBuckets + 1);
+  bd.Offsets = this->Offsets->GetPointer(0);
+  vtkIdType total = 0;
+  for (vtkIdType bucket = 0; bucket < bd.NumberOfBuckets; ++bucket)
+    {
+    bd.Offsets[bucket] = total;
+    total += bd.Counts[bucket];
+    bd.Counts[bucket] = bd.Offsets[bucket];
+    }
+  bd.Offsets[bd.NumberOfBuckets] = total;
+
+  this->CellIds->SetNumberOfValues(total);
+  bd.CellIds = this->CellIds->GetPointer(0);
+  scheduler->ParallelFor(0, numCells, grain,
+                         vtkStaticCellLocatorFillBuckets, &bd);
+  delete [] bd.Counts;
+  if (bd.Parallel)
+    {
+    scheduler->ParallelFor(0, bd.NumberOfBuckets,
+                           VTK_STATIC_CELL_LOCATOR_TASK_SIZE,
+                           vtkStaticCellLocatorSortBuckets, &bd);
+    }
+
+  this->BuildTime.Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkStaticCellLocator::GetNumberOfBuckets()
+{
+  return (vtkIdType)this->Divisions[0]*this->Divisions[1]*this->Divisions[2];
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticCellLocator::GetBucketCells(vtkIdType bucket,
+                                          vtkIdList *cellIds)
+{
+  cellIds->Reset();
+  if ( bucket < 0 || bucket + 1 >= this->Offsets->GetNumberOfTuples() )
+    {
+    return;
+    }
+  vtkIdType *offsets = this->Offsets->GetPointer(0);
+  vtkIdType *ids = this->CellIds->GetPointer(0);
+  for (vtkIdType i = offsets[bucket]; i < offsets[bucket+1]; ++i)
+    {
+    cellIds->InsertNextId(ids[i]);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticCellLocator::GetBucketIndices(const double x[3], int ijk[3])
+{
+  for (int i = 0; i < 3; ++i)
+    {
+    double d = floor((x[i] - this->Bounds[2*i]) / this->H[i]);
+    if ( d < 0.0 )
+      {
+      ijk[i] = 0;
+      }
+    else if ( d >= this->Divisions[i] )
+      {
+      ijk[i] = this->Divisions[i] - 1;
+      }
+    else
+      {
+      ijk[i] = (int)d;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+double vtkStaticCellLocator::Distance2ToCellBounds(const double x[3],
+                                                   vtkIdType cellId)
+{
+  double cellBounds[6];
+  double *bounds = cellBounds;
+  if ( this->CacheCellBounds )
+    {
+    bounds = this->CellBounds->GetPointer(6*cellId);
+    }
+  else
+    {
+    this->DataSet->GetCellBounds(cellId, cellBounds);
+    }
+  double dist2 = 0.0;
+  for (int i = 0; i < 3; ++i)
+    {
+    double d = 0.0;
+    if ( x[i] < bounds[2*i] )
+      {
+      d = bounds[2*i] - x[i];
+      }
+    else if ( x[i] > bounds[2*i+1] )
+      {
+      d = x[i] - bounds[2*i+1];
+      }
+    dist2 += d*d;
+    }
+  return dist2;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkStaticCellLocator::FindCell(double x[3], double tol2,
+                                         vtkGenericCell *cell,
+                                         double pcoords[3], double *weights)
+{
+  if ( this->Offsets->GetNumberOfTuples() == 0 )
+    {
+    return -1;
+    }
+  int i;
+  for (i = 0; i < 3; ++i)
+    {
+    double tol = sqrt(tol2);
+    if ( x[i] < this->Bounds[2*i] - tol || x[i] > this->Bounds[2*i+1] + tol )
+      {
+      return -1;
+      }
+    }
+
+  int ijk[3];
+  this->GetBucketIndices(x, ijk);
+  vtkIdType bucket = ((vtkIdType)ijk[2]*this->Divisions[1] + ijk[1])*
+    this->Divisions[0] + ijk[0];
+  vtkIdType *offsets = this->Offsets->GetPointer(0);
+  vtkIdType *ids = this->CellIds->GetPointer(0);
+  double closestPoint[3];
+  double dist2;
+  int subId;
+  for (vtkIdType idx = offsets[bucket]; idx < offsets[bucket+1]; ++idx)
+    {
+    vtkIdType cellId = ids[idx];
+    if ( this->Distance2ToCellBounds(x, cellId) > tol2 )
+      {
+      continue;
+      }
+    this->DataSet->GetCell(cellId, cell);
+    if ( cell->EvaluatePosition(x, closestPoint, subId, pcoords, dist2,
+                                weights) == 1 && dist2 <= tol2 )
+      {
+      return cellId;
+      }
+    }
+  return -1;
+}
+
+//----------------------------------------------------------------------------
+// Clip the segment a0 + t*dir, 0 <= t <= 1, to bounds.  Return 0 if it
+// does not reach them.
+static int vtkStaticCellLocatorClipSegment(const double bounds[6],
+                                           const double a0[3],
+                                           const double dir[3],
+                                           double &t0, double &t1)
+{
+  t0 = 0.0;
+  t1 = 1.0;
+  for (int i = 0; i < 3; ++i)
+    {
+    if ( dir[i] == 0.0 )
+      {
+      if ( a0[i] < bounds[2*i] || a0[i] > bounds[2*i+1] )
+        {
+        return 0;
+        }
+      continue;
+      }
+    double ta = (bounds[2*i] - a0[i]) / dir[i];
+    double tb = (bounds[2*i+1] - a0[i]) / dir[i];
+    if ( ta > tb )
+      {
+      double tmp = ta;
+      ta = tb;
+      tb = tmp;
+      }
+    t0 = (ta > t0 ? ta : t0);
+    t1 = (tb < t1 ? tb : t1);
+    }
+  return t0 <= t1;
+}
+
+//----------------------------------------------------------------------------
+int vtkStaticCellLocator::IntersectWithLine(double a0[3], double a1[3],
+                                            double tol, double& t,
+                                            double x[3], double pcoords[3],
+                                            int &subId, vtkIdType &cellId,
+                                            vtkGenericCell *cell)
+{
+  cellId = -1;
+  double dir[3];
+  double tEnter, tExit;
+  int i;
+  for (i = 0; i < 3; ++i)
+    {
+    dir[i] = a1[i] - a0[i];
+    }
+  if ( this->Offsets->GetNumberOfTuples() == 0 ||
+       !vtkStaticCellLocatorClipSegment(this->Bounds, a0, dir,
+                                        tEnter, tExit) )
+    {
+    return 0;
+    }
+
+  // Walk the buckets along the segment from where it enters them.
+  int ijk[3], step[3];
+  double tNext[3], tDelta[3];
+  double p[3];
+  for (i = 0; i < 3; ++i)
+    {
+    p[i] = a0[i] + tEnter*dir[i];
+    }
+  this->GetBucketIndices(p, ijk);
+  for (i = 0; i < 3; ++i)
+    {
+    if ( dir[i] > 0.0 )
+      {
+      step[i] = 1;
+      tNext[i] = (this->Bounds[2*i] + (ijk[i]+1)*this->H[i] - a0[i]) / dir[i];
+      tDelta[i] = this->H[i] / dir[i];
+      }
+    else if ( dir[i] < 0.0 )
+      {
+      step[i] = -1;
+      tNext[i] = (this->Bounds[2*i] + ijk[i]*this->H[i] - a0[i]) / dir[i];
+      tDelta[i] = -this->H[i] / dir[i];
+      }
+    else
+      {
+      step[i] = 0;
+      tNext[i] = VTK_DOUBLE_MAX;
+      tDelta[i] = 0.0;
+      }
+    }
+
+  vtkIdType *offsets = this->Offsets->GetPointer(0);
+  vtkIdType *ids = this->CellIds->GetPointer(0);
+  double cellBounds[6];
+  double *boundsPtr = cellBounds;
+  double hitPosition[3];
+  double hitT;
+  double bestT = VTK_DOUBLE_MAX;
+  double cellT, cellX[3], cellPcoords[3];
+  int cellSubId;
+  vtkIdType bestCellId = -1;
+  for (;;)
+    {
+    vtkIdType bucket = ((vtkIdType)ijk[2]*this->Divisions[1] + ijk[1])*
+      this->Divisions[0] + ijk[0];
+    for (vtkIdType idx = offsets[bucket]; idx < offsets[bucket+1]; ++idx)
+      {
+      vtkIdType cId = ids[idx];
+      if ( this->CacheCellBounds )
+        {
+        boundsPtr = this->CellBounds->GetPointer(6*cId);
+        }
+      else
+        {
+        this->DataSet->GetCellBounds(cId, cellBounds);
+        }
+      if ( !vtkBox::IntersectBox(boundsPtr, a0, dir, hitPosition, hitT) ||
+           hitT > bestT )
+        {
+        continue;
+        }
+      this->DataSet->GetCell(cId, cell);
+      if ( cell->IntersectWithLine(a0, a1, tol, cellT, cellX, cellPcoords,
+                                   cellSubId) && cellT < bestT )
+        {
+        bestT = cellT;
+        bestCellId = cId;
+        }
+      }
+
+    // Stop once the closest intersection is in the buckets walked.
+    double tBucketExit = tExit;
+    int axis = -1;
+    for (i = 0; i < 3; ++i)
+      {
+      if ( tNext[i] < tBucketExit )
+        {
+        tBucketExit = tNext[i];
+        axis = i;
+        }
+      }
+    if ( (bestCellId >= 0 && bestT <= tBucketExit) || axis < 0 )
+      {
+      break;
+      }
+    ijk[axis] += step[axis];
+    if ( ijk[axis] < 0 || ijk[axis] >= this->Divisions[axis] )
+      {
+      break;
+      }
+    tNext[axis] += tDelta[axis];
+    }
+
+  if ( bestCellId < 0 )
+    {
+    return 0;
+    }
+  // Evaluate the intersection again to leave the cell in cell.
+  this->DataSet->GetCell(bestCellId, cell);
+  cell->IntersectWithLine(a0, a1, tol, t, x, pcoords, subId);
+  cellId = bestCellId;
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticCellLocator::FindClosestPoint(double x[3],
+                                            double closestPoint[3],
+                                            vtkGenericCell *cell,
+                                            vtkIdType &cellId, int &subId,
+                                            double& dist2)
+{
+  int inside;
+  cellId = -1;
+  dist2 = VTK_DOUBLE_MAX;
+  this->FindClosestPointWithinRadius(x, VTK_DOUBLE_MAX, closestPoint, cell,
+                                     cellId, subId, dist2, inside);
+}
+
+//----------------------------------------------------------------------------
+int vtkStaticCellLocator::FindClosestPointWithinRadius(double x[3],
+                                                       double radius,
+                                                       double closestPoint[3],
+                                                       vtkGenericCell *cell,
+                                                       vtkIdType &cellId,
+                                                       int &subId,
+                                                       double& dist2)
+{
+  int inside;
+  return this->FindClosestPointWithinRadius(x, radius, closestPoint, cell,
+                                            cellId, subId, dist2, inside);
+}
+
+//----------------------------------------------------------------------------
+// Visit the buckets in shells of increasing distance from the bucket of
+// x, until the buckets not visited are farther than the closest cell
+// found.
+int vtkStaticCellLocator::FindClosestPointWithinRadius(double x[3],
+                                                       double radius,
+                                                       double closestPoint[3],
+                                                       vtkGenericCell *cell,
+                                                       vtkIdType &cellId,
+                                                       int &subId,
+                                                       double& dist2,
+                                                       int &inside)
+{
+  if ( this->Offsets->GetNumberOfTuples() == 0 )
+    {
+    return 0;
+    }
+
+  vtkScratchPool *pool = vtkScratchPool::GetThreadPool();
+  vtkDoubleArray *weightsArray = pool->AcquireDoubleArray();
+  double *weights = weightsArray->WritePointer(0, this->MaxCellSize + 1);
+  double bestDist2 = (radius < sqrt(VTK_DOUBLE_MAX) ?
+                      radius*radius : VTK_DOUBLE_MAX);
+  vtkIdType bestCellId = -1;
+  vtkIdType *offsets = this->Offsets->GetPointer(0);
+  vtkIdType *ids = this->CellIds->GetPointer(0);
+  double point[3], pcoords[3], d2;
+  int ijk[3], lo[3], hi[3], sub, ret;
+  int i, j, k;
+  this->GetBucketIndices(x, ijk);
+
+  for (int level = 0; ; ++level)
+    {
+    int whole = 1;
+    for (i = 0; i < 3; ++i)
+      {
+      lo[i] = ijk[i] - level;
+      hi[i] = ijk[i] + level;
+      whole = whole && lo[i] <= 0 && hi[i] >= this->Divisions[i] - 1;
+      }
+
+    // The buckets of the shell, skipping the inside already visited.
+    for (k = (lo[2] < 0 ? 0 : lo[2]);
+         k <= hi[2] && k < this->Divisions[2]; ++k)
+      {
+      for (j = (lo[1] < 0 ? 0 : lo[1]);
+           j <= hi[1] && j < this->Divisions[1]; ++j)
+        {
+        int onShell = (k == lo[2] || k == hi[2] || j == lo[1] || j == hi[1]);
+        for (i = (lo[0] < 0 ? 0 : lo[0]);
+             i <= hi[0] && i < this->Divisions[0]; ++i)
+          {
+          if ( !onShell && i != lo[0] && i != hi[0] )
+            {
+            continue;
+            }
+          double bucketDist2 = 0.0;
+          int n[3] = { i, j, k };
+          for (int a = 0; a < 3; ++a)
+            {
+            double bmin = this->Bounds[2*a] + n[a]*this->H[a];
+            double d = 0.0;
+            if ( x[a] < bmin )
+              {
+              d = bmin - x[a];
+              }
+            else if ( x[a] > bmin + this->H[a] )
+              {
+              d = x[a] - bmin - this->H[a];
+              }
+            bucketDist2 += d*d;
+            }
+          if ( bucketDist2 >= bestDist2 )
+            {
+            continue;
+            }
+          vtkIdType bucket = ((vtkIdType)k*this->Divisions[1] + j)*
+            this->Divisions[0] + i;
+          for (vtkIdType idx = offsets[bucket]; idx < offsets[bucket+1];
+               ++idx)
+            {
+            vtkIdType cId = ids[idx];
+            if ( this->Distance2ToCellBounds(x, cId) >= bestDist2 )
+              {
+              continue;
+              }
+            this->DataSet->GetCell(cId, cell);
+            ret = cell->EvaluatePosition(x, point, sub, pcoords, d2, weights);
+            if ( ret != -1 && d2 < bestDist2 )
+              {
+              bestDist2 = d2;
+              bestCellId = cId;
+              closestPoint[0] = point[0];
+              closestPoint[1] = point[1];
+              closestPoint[2] = point[2];
+              subId = sub;
+              inside = ret;
+              }
+            }
+          }
+        }
+      }
+    if ( whole )
+      {
+      break;
+      }
+
+    // Any bucket not visited yet is beyond a side of the block visited
+    // that is not on the bounds.
+    double minDist = VTK_DOUBLE_MAX;
+    for (i = 0; i < 3; ++i)
+      {
+      if ( lo[i] > 0 )
+        {
+        double d = x[i] - (this->Bounds[2*i] + lo[i]*this->H[i]);
+        minDist = (d < minDist ? d : minDist);
+        }
+      if ( hi[i] < this->Divisions[i] - 1 )
+        {
+        double d = this->Bounds[2*i] + (hi[i]+1)*this->H[i] - x[i];
+        minDist = (d < minDist ? d : minDist);
+        }
+      }
+    if ( minDist*minDist >= bestDist2 )
+      {
+      break;
+      }
+    }
+  pool->ReleaseDoubleArray(weightsArray);
+
+  if ( bestCellId < 0 )
+    {
+    return 0;
+    }
+  this->DataSet->GetCell(bestCellId, cell);
+  cellId = bestCellId;
+  dist2 = bestDist2;
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+// What the tasks answering many queries need.
+struct vtkStaticCellLocatorQueryData
+{
+  vtkStaticCellLocator *Locator;
+  vtkPoints *Points;
+  vtkPoints *Ends;
+  double Tolerance;
+  vtkIdType *CellIds;
+  double *Values;
+  vtkPoints *ClosestPoints;
+  int MaxCellSize;
+};
+
+//----------------------------------------------------------------------------
+static void vtkStaticCellLocatorFindCells(void *arg, vtkIdType begin,
+                                          vtkIdType end)
+{
+  vtkStaticCellLocatorQueryData *qd =
+    static_cast<vtkStaticCellLocatorQueryData *>(arg);
+  vtkScratchPool *pool = vtkScratchPool::GetThreadPool();
+  vtkGenericCell *cell = pool->AcquireGenericCell();
+  vtkDoubleArray *weightsArray = pool->AcquireDoubleArray();
+  double *weights = weightsArray->WritePointer(0, qd->MaxCellSize + 1);
+  double x[3], pcoords[3];
+  for (vtkIdType i = begin; i < end; ++i)
+    {
+    qd->Points->GetPoint(i, x);
+    qd->CellIds[i] = qd->Locator->FindCell(x, qd->Tolerance, cell, pcoords,
+                                           weights);
+    }
+  pool->ReleaseDoubleArray(weightsArray);
+  pool->ReleaseGenericCell(cell);
+}
+
+//----------------------------------------------------------------------------
+static void vtkStaticCellLocatorIntersectLines(void *arg, vtkIdType begin,
+                                               vtkIdType end)
+{
+  vtkStaticCellLocatorQueryData *qd =
+    static_cast<vtkStaticCellLocatorQueryData *>(arg);
+  vtkScratchPool *pool = vtkScratchPool::GetThreadPool();
+  vtkGenericCell *cell = pool->AcquireGenericCell();
+  double a0[3], a1[3], x[3], pcoords[3], t;
+  int subId;
+  for (vtkIdType i = begin; i < end; ++i)
+    {
+    qd->Points->GetPoint(i, a0);
+    qd->Ends->GetPoint(i, a1);
+    if ( !qd->Locator->IntersectWithLine(a0, a1, qd->Tolerance, t, x,
+                                         pcoords, subId, qd->CellIds[i],
+                                         cell) )
+      {
+      t = 0.0;
+      }
+    qd->Values[i] = t;
+    }
+  pool->ReleaseGenericCell(cell);
+}
+
+//----------------------------------------------------------------------------
+static void vtkStaticCellLocatorFindClosestPoints(void *arg,
+                                                  vtkIdType begin,
+                                                  vtkIdType end)
+{
+  vtkStaticCellLocatorQueryData *qd =
+    static_cast<vtkStaticCellLocatorQueryData *>(arg);
+  vtkScratchPool *pool = vtkScratchPool::GetThreadPool();
+  vtkGenericCell *cell = pool->AcquireGenericCell();
+  double x[3], closestPoint[3];
+  int subId;
+  for (vtkIdType i = begin; i < end; ++i)
+    {
+    qd->Points->GetPoint(i, x);
+    qd->Locator->FindClosestPoint(x, closestPoint, cell, qd->CellIds[i],
+                                  subId, qd->Values[i]);
+    if ( qd->ClosestPoints )
+      {
+      qd->ClosestPoints->SetPoint(i, closestPoint);
+      }
+    }
+  pool->ReleaseGenericCell(cell);
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticCellLocator::FindCells(vtkPoints *points, double tol2,
+                                     vtkIdTypeArray *cellIds)
+{
+  this->BuildLocator();
+  vtkIdType numPts = points->GetNumberOfPoints();
+  cellIds->SetNumberOfComponents(1);
+  cellIds->SetNumberOfTuples(numPts);
+
+  vtkStaticCellLocatorQueryData qd;
+  qd.Locator = this;
+  qd.Points = points;
+  qd.Tolerance = tol2;
+  qd.CellIds = cellIds->GetPointer(0);
+  qd.MaxCellSize = this->MaxCellSize;
+  vtkTaskScheduler::GetGlobalScheduler()->ParallelFor(
+    0, numPts, VTK_STATIC_CELL_LOCATOR_TASK_SIZE,
+    vtkStaticCellLocatorFindCells, &qd);
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticCellLocator::IntersectWithLines(vtkPoints *p1, vtkPoints *p2,
+                                              double tol,
+                                              vtkIdTypeArray *cellIds,
+                                              vtkDoubleArray *t)
+{
+  this->BuildLocator();
+  vtkIdType numLines = p1->GetNumberOfPoints();
+  if ( p2->GetNumberOfPoints() < numLines )
+    {
+    vtkErrorMacro(<< "There are fewer end points than start points");
+    return;
+    }
+  cellIds->SetNumberOfComponents(1);
+  cellIds->SetNumberOfTuples(numLines);
+  t->SetNumberOfComponents(1);
+  t->SetNumberOfTuples(numLines);
+
+  vtkStaticCellLocatorQueryData qd;
+  qd.Locator = this;
+  qd.Points = p1;
+  qd.Ends = p2;
+  qd.Tolerance = tol;
+  qd.CellIds = cellIds->GetPointer(0);
+  qd.Values = t->GetPointer(0);
+  vtkTaskScheduler::GetGlobalScheduler()->ParallelFor(
+    0, numLines, VTK_STATIC_CELL_LOCATOR_TASK_SIZE,
+    vtkStaticCellLocatorIntersectLines, &qd);
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticCellLocator::FindClosestPoints(vtkPoints *points,
+                                             vtkIdTypeArray *cellIds,
+                                             vtkDoubleArray *dist2,
+                                             vtkPoints *closestPoints)
+{
+  this->BuildLocator();
+  vtkIdType numPts = points->GetNumberOfPoints();
+  cellIds->SetNumberOfComponents(1);
+  cellIds->SetNumberOfTuples(numPts);
+  dist2->SetNumberOfComponents(1);
+  dist2->SetNumberOfTuples(numPts);
+  if ( closestPoints )
+    {
+    closestPoints->SetNumberOfPoints(numPts);
+    }
+
+  vtkStaticCellLocatorQueryData qd;
+  qd.Locator = this;
+  qd.Points = points;
+  qd.CellIds = cellIds->GetPointer(0);
+  qd.Values = dist2->GetPointer(0);
+  qd.ClosestPoints = closestPoints;
+  vtkTaskScheduler::GetGlobalScheduler()->ParallelFor(
+    0, numPts, VTK_STATIC_CELL_LOCATOR_TASK_SIZE,
+    vtkStaticCellLocatorFindClosestPoints, &qd);
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticCellLocator::GenerateRepresentation(int vtkNotUsed(level),
+                                                  vtkPolyData *pd)
+{
+  vtkPoints *pts = vtkPoints::New();
+  vtkCellArray *polys = vtkCellArray::New();
+  vtkIdType numBuckets = this->Offsets->GetNumberOfTuples() - 1;
+  vtkIdType *offsets = this->Offsets->GetPointer(0);
+  int ijk[3];
+
+  for (ijk[2] = 0; numBuckets > 0 && ijk[2] < this->Divisions[2]; ++ijk[2])
+    {
+    for (ijk[1] = 0; ijk[1] < this->Divisions[1]; ++ijk[1])
+      {
+      for (ijk[0] = 0; ijk[0] < this->Divisions[0]; ++ijk[0])
+        {
+        vtkIdType bucket = ((vtkIdType)ijk[2]*this->Divisions[1] + ijk[1])*
+          this->Divisions[0] + ijk[0];
+        if ( offsets[bucket] == offsets[bucket+1] )
+          {
+          continue;
+          }
+        // A face on each side whose neighbor is empty or outside.
+        for (int axis = 0; axis < 3; ++axis)
+          {
+          for (int side = 0; side < 2; ++side)
+            {
+            int n[3] = { ijk[0], ijk[1], ijk[2] };
+            n[axis] += (side ? 1 : -1);
+            if ( n[axis] >= 0 && n[axis] < this->Divisions[axis] )
+              {
+              vtkIdType neighbor = ((vtkIdType)n[2]*this->Divisions[1] +
+                                    n[1])*this->Divisions[0] + n[0];
+              if ( offsets[neighbor] != offsets[neighbor+1] )
+                {
+                continue;
+                }
+              }
+            int u = (axis + 1) % 3;
+            int v = (axis + 2) % 3;
+            vtkIdType ids[4];
+            for (int corner = 0; corner < 4; ++corner)
+              {
+              int c[3] = { ijk[0], ijk[1], ijk[2] };
+              c[axis] += side;
+              c[u] += (corner == 1 || corner == 2);
+              c[v] += (corner >= 2);
+              double x[3];
+              for (int i = 0; i < 3; ++i)
+                {
+                x[i] = this->Bounds[2*i] + c[i]*this->H[i];
+                }
+              ids[corner] = pts->InsertNextPoint(x);
+              }
+            polys->InsertNextCell(4, ids);
+            }
+          }
+        }
+      }
+    }
+
+  pd->SetPoints(pts);
+  pts->Delete();
+  pd->SetPolys(polys);
+  polys->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticCellLocator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Number of Cells Per Bucket: "
+     << this->NumberOfCellsPerBucket << "\n";
+  os << indent << "Divisions: (" << this->Divisions[0] << ", "
+     << this->Divisions[1] << ", " << this->Divisions[2] << ")\n";
+  os << indent << "Cache Cell Bounds: "
+     << (this->CacheCellBounds ? "On\n" : "Off\n");
+  os << indent << "Number of Cells in Buckets: "
+     << this->CellIds->GetNumberOfTuples() << "\n";
+}
@@ -0,0 +1,187 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkStaticCellLocator.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkStaticCellLocator - cell locator built once into flat bucket arrays
+// .SECTION Description
+// vtkStaticCellLocator answers the queries of vtkCellLocator for datasets
+// that do not change once the locator is built.  The bounds of the
+// dataset are divided into a uniform grid of buckets, and the ids of the
+// cells overlapping each bucket are kept in one array, in increasing
+// order, with a second array giving where the cells of each bucket
+// start.  Walking a bucket is a scan of contiguous ids.
+//
+// BuildLocator() computes the cell bounds, counts the cells of each
+// bucket and fills the buckets on the threads of the vtkTaskScheduler,
+// with atomic counters shared by the threads, then sorts the cells of
+// each bucket, so the buckets are the same whatever the number of
+// threads.  The queries change nothing in the
+// locator: several threads may query it at once, each with its own
+// generic cell, provided GetCell() of the dataset may be called from
+// several threads, as for vtkUnstructuredGrid, vtkPolyData and
+// vtkImageData once the locator is built.  FindCells(),
+// IntersectWithLines() and FindClosestPoints() answer many queries on
+// the threads of the scheduler.
+//
+// The buckets have about the same size along each axis.  When Automatic
+// is on (the default) their number is chosen for NumberOfCellsPerBucket
+// cells per bucket on average; otherwise Divisions gives it.  There are
+// at most 1024 buckets along each axis.
+
+// .SECTION Caveats
+// The locator must be built again after the dataset is modified; the
+// single queries do not do it.  IntersectWithLine() returns the
+// intersection closest to the start of the line, and FindClosestPoint()
+// the first cell of smallest distance, so where cells overlap the
+// results may differ from vtkCellLocator.
+
+// .SECTION See Also
+// vtkCellLocator vtkLocator vtkTaskScheduler
+
+#ifndef __vtkStaticCellLocator_h
+#define __vtkStaticCellLocator_h
+
+#include "vtkLocator.h"
+
+class vtkDoubleArray;
+class vtkGenericCell;
+class vtkIdList;
+class vtkIdTypeArray;
+class vtkPoints;
+
+class VTK_FILTERING_EXPORT vtkStaticCellLocator : public vtkLocator
+{
+public:
+  static vtkStaticCellLocator *New();
+  vtkTypeRevisionMacro(vtkStaticCellLocator,vtkLocator);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Specify the average number of cells in each bucket when Automatic is
+  // on.  The default is 10.
+  vtkSetClampMacro(NumberOfCellsPerBucket,int,1,VTK_LARGE_INTEGER);
+  vtkGetMacro(NumberOfCellsPerBucket,int);
+
+  // Description:
+  // Set/Get the number of buckets along each axis.  It is used when
+  // Automatic is off, and set by BuildLocator() otherwise.
+  vtkSetVector3Macro(Divisions,int);
+  vtkGetVectorMacro(Divisions,int,3);
+
+  // Description:
+  // Boolean controls whether the bounds of the cells are kept, which
+  // needs 48 bytes per cell and avoids computing them in each query.
+  // On by default.
+  vtkSetMacro(CacheCellBounds,int);
+  vtkGetMacro(CacheCellBounds,int);
+  vtkBooleanMacro(CacheCellBounds,int);
+
+  // Description:
+  // Return the id of a cell that contains x, within the squared distance
+  // tol2 for cells of lower dimension, or -1 if there is none.  The
+  // cells are tried in increasing id order.  cell is left with the cell
+  // found, and pcoords and weights, which must hold as many values as
+  // the largest cell has points, with its parametric coordinates and
+  // interpolation weights at x.
+  vtkIdType FindCell(double x[3], double tol2, vtkGenericCell *cell,
+                     double pcoords[3], double *weights);
+
+  // Description:
+  // Return 1 if the segment a0-a1 intersects a cell, 0 otherwise.  The
+  // intersection closest to a0 is returned in t (the parametric
+  // coordinate along the segment), x, pcoords, subId and cellId, and cell
+  // is left with the cell intersected.  tol is given to the
+  // IntersectWithLine() method of the cells.
+  int IntersectWithLine(double a0[3], double a1[3], double tol,
+                        double& t, double x[3], double pcoords[3],
+                        int &subId, vtkIdType &cellId,
+                        vtkGenericCell *cell);
+
+  // Description:
+  // Return the closest point to x on the cells and the cell it is on,
+  // with the squared distance.  The closest point need not be a vertex
+  // of the cell.  cellId is -1 if the dataset has no cells.  cell is
+  // left with the closest cell.
+  void FindClosestPoint(double x[3], double closestPoint[3],
+                        vtkGenericCell *cell, vtkIdType &cellId,
+                        int &subId, double& dist2);
+
+  // Description:
+  // Like FindClosestPoint(), but only for points closer to x than
+  // radius.  Return 1 if a point is found, 0 otherwise, in which case
+  // the other values are undefined.  inside is set to 1 if x is inside
+  // the closest cell, 0 otherwise.
+  int FindClosestPointWithinRadius(double x[3], double radius,
+                                   double closestPoint[3],
+                                   vtkGenericCell *cell, vtkIdType &cellId,
+                                   int &subId, double& dist2, int &inside);
+  int FindClosestPointWithinRadius(double x[3], double radius,
+                                   double closestPoint[3],
+                                   vtkGenericCell *cell, vtkIdType &cellId,
+                                   int &subId, double& dist2);
+
+  // Description:
+  // Batch versions of the queries above, executed on the threads of the
+  // vtkTaskScheduler after building the locator if needed.  The results
+  // for point (or segment) i are at index i of the output arrays, which
+  // are resized, with a cell id of -1 where nothing is found.  The
+  // segments of IntersectWithLines() go from p1 to p2, and t is set to
+  // 0 where they intersect no cell.  closestPoints may be NULL.
+  void FindCells(vtkPoints *points, double tol2, vtkIdTypeArray *cellIds);
+  void IntersectWithLines(vtkPoints *p1, vtkPoints *p2, double tol,
+                          vtkIdTypeArray *cellIds, vtkDoubleArray *t);
+  void FindClosestPoints(vtkPoints *points, vtkIdTypeArray *cellIds,
+                         vtkDoubleArray *dist2, vtkPoints *closestPoints);
+
+  // Description:
+  // Return the number of buckets, and set cellIds to the cells of a
+  // bucket.  The locator must have been built.
+  vtkIdType GetNumberOfBuckets();
+  void GetBucketCells(vtkIdType bucket, vtkIdList *cellIds);
+
+  // Description:
+  // Satisfy vtkLocator abstract interface.  The representation is made
+  // of the faces between non-empty buckets and the others; level is not
+  // used.
+  void FreeSearchStructure();
+  void BuildLocator();
+  void GenerateRepresentation(int level, vtkPolyData *pd);
+
+protected:
+  vtkStaticCellLocator();
+  ~vtkStaticCellLocator();
+
+  // Set ijk to the bucket containing x, or the closest one if x is
+  // outside of the bounds.
+  void GetBucketIndices(const double x[3], int ijk[3]);
+
+  // Return the squared distance from x to the bounds of cellId.
+  double Distance2ToCellBounds(const double x[3], vtkIdType cellId);
+
+  int NumberOfCellsPerBucket;
+  int Divisions[3];
+  int CacheCellBounds;
+  double Bounds[6]; // bounds of the buckets
+  double H[3];      // width of the buckets
+  int MaxCellSize;
+
+  vtkIdTypeArray *Offsets; // where the cells of each bucket start
+  vtkIdTypeArray *CellIds; // the cells of all the buckets
+  vtkDoubleArray *CellBounds;
+
+private:
+  vtkStaticCellLocator(const vtkStaticCellLocator&);  // Not implemented.
+  void operator=(const vtkStaticCellLocator&);  // Not implemented.
+};
+
+#endif
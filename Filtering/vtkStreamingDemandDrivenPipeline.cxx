@@ -28,6 +28,7 @@
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
 
 vtkCxxRevisionMacro(vtkStreamingDemandDrivenPipeline, "1.35.2.1");
 vtkStandardNewMacro(vtkStreamingDemandDrivenPipeline);
@@ -124,8 +125,12 @@ int vtkStreamingDemandDrivenPipeline
 
       // Invoke the request on the algorithm.
       this->LastPropogateUpdateExtentShortCircuited = 0;
+      {
+      vtkTimerLogTraceScope scope("Algorithm", this->Algorithm,
+                                  "RequestUpdateExtent");
       result = this->CallAlgorithm(request, vtkExecutive::RequestUpstream,
                                    inInfoVec, outInfoVec);
+      }
       
       // Propagate the update extent to all inputs.
       if(result)
@@ -479,6 +484,8 @@ int vtkStreamingDemandDrivenPipeline::PropagateUpdateExtent(int outputPort)
     {
     return 0;
     }
+  vtkTimerLogTraceScope scope("Executive", this->Algorithm,
+                              "PropagateUpdateExtent");
 
   // Range check.
   if(outputPort < -1 ||
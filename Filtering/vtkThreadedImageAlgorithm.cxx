@@ -24,6 +24,8 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTaskScheduler.h"
+#include "vtkTimerLog.h"
 #include "vtkTrivialProducer.h"
 
 vtkCxxRevisionMacro(vtkThreadedImageAlgorithm, "1.11");
@@ -32,13 +34,57 @@ vtkCxxRevisionMacro(vtkThreadedImageAlgorithm, "1.11");
 vtkThreadedImageAlgorithm::vtkThreadedImageAlgorithm()
 {
   this->Threader = vtkMultiThreader::New();
+  // Image pieces are independent, so they can run on the persistent
+  // threads of the task scheduler instead of paying for thread creation
+  // on every update.
+  this->Threader->UseTaskSchedulerOn();
   this->NumberOfThreads = this->Threader->GetNumberOfThreads();
+
+  this->SplitMode = VTK_THREADED_IMAGE_SPLIT_SLAB;
+  this->DesiredBytesPerPiece = 65536;
+  this->NumberOfPieces = 0;
+  this->PieceExtents = 0;
+  this->PieceTimes = 0;
 }
 
 //----------------------------------------------------------------------------
 vtkThreadedImageAlgorithm::~vtkThreadedImageAlgorithm()
 {
   this->Threader->Delete();
+  delete [] this->PieceExtents;
+  delete [] this->PieceTimes;
+}
+
+//----------------------------------------------------------------------------
+const char *vtkThreadedImageAlgorithm::GetSplitModeAsString()
+{
+  if (this->SplitMode == VTK_THREADED_IMAGE_SPLIT_BRICK)
+    {
+    return "Brick";
+    }
+  return "Slab";
+}
+
+//----------------------------------------------------------------------------
+void vtkThreadedImageAlgorithm::GetPieceExtent(int piece, int extent[6])
+{
+  if (piece < 0 || piece >= this->NumberOfPieces)
+    {
+    vtkErrorMacro("Piece " << piece << " out of range.");
+    return;
+    }
+  memcpy(extent, this->PieceExtents + 6*piece, 6*sizeof(int));
+}
+
+//----------------------------------------------------------------------------
+double vtkThreadedImageAlgorithm::GetPieceTime(int piece)
+{
+  if (piece < 0 || piece >= this->NumberOfPieces)
+    {
+    vtkErrorMacro("Piece " << piece << " out of range.");
+    return 0.0;
+    }
+  return this->PieceTimes[piece];
 }
 
 //----------------------------------------------------------------------------
@@ -47,6 +93,25 @@ void vtkThreadedImageAlgorithm::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent);
   
   os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+  os << indent << "SplitMode: " << this->GetSplitModeAsString() << "\n";
+  os << indent << "DesiredBytesPerPiece: "
+     << this->DesiredBytesPerPiece << "\n";
+  os << indent << "NumberOfPieces: " << this->NumberOfPieces << "\n";
+  if (this->NumberOfPieces > 0)
+    {
+    double minTime = this->PieceTimes[0];
+    double maxTime = this->PieceTimes[0];
+    double total = 0.0;
+    for (int i = 0; i < this->NumberOfPieces; ++i)
+      {
+      double t = this->PieceTimes[i];
+      minTime = (t < minTime ? t : minTime);
+      maxTime = (t > maxTime ? t : maxTime);
+      total += t;
+      }
+    os << indent << "PieceTimes: min " << minTime << ", max " << maxTime
+       << ", mean " << total / this->NumberOfPieces << "\n";
+    }
 }
 
 struct vtkImageThreadStruct
@@ -123,22 +188,12 @@ int vtkThreadedImageAlgorithm::SplitExtent(int splitExt[6],
 }
 
 
-// this mess is really a simple function. All it does is call
-// the ThreadedExecute method after setting the correct
-// extent for this thread. Its just a pain to calculate
-// the correct extent.
-VTK_THREAD_RETURN_TYPE vtkThreadedImageAlgorithmThreadedExecute( void *arg )
+// Get the extent that the filter must generate: the update extent of the
+// output port that made the request, or that of the first connected input
+// when the filter has no outputs.  Returns 0 if there is no such extent.
+static int vtkThreadedImageAlgorithmGetExecuteExtent(vtkImageThreadStruct *str,
+                                                     int ext[6])
 {
-  vtkImageThreadStruct *str;
-  int ext[6], splitExt[6], total;
-  int threadId, threadCount;
-  
-  threadId = ((vtkMultiThreader::ThreadInfo *)(arg))->ThreadID;
-  threadCount = ((vtkMultiThreader::ThreadInfo *)(arg))->NumberOfThreads;
-  
-  str = (vtkImageThreadStruct *)
-    (((vtkMultiThreader::ThreadInfo *)(arg))->UserData);
-
   // if we have an output
   if (str->Filter->GetNumberOfOutputPorts())
     {
@@ -150,7 +205,7 @@ VTK_THREAD_RETURN_TYPE vtkThreadedImageAlgorithmThreadedExecute( void *arg )
     // update directly, for now an error
     if (outputPort == -1)
       {
-      return VTK_THREAD_RETURN_VALUE;
+      return 0;
       }
   
     // get the update extent from the output port
@@ -180,10 +235,34 @@ VTK_THREAD_RETURN_TYPE vtkThreadedImageAlgorithmThreadedExecute( void *arg )
       }
     if (inPort >= str->Filter->GetNumberOfInputPorts())
       {
-      return VTK_THREAD_RETURN_VALUE;
+      return 0;
       }
     }
   
+  return 1;
+}
+
+// this mess is really a simple function. All it does is call
+// the ThreadedExecute method after setting the correct
+// extent for this thread. Its just a pain to calculate
+// the correct extent.
+VTK_THREAD_RETURN_TYPE vtkThreadedImageAlgorithmThreadedExecute( void *arg )
+{
+  vtkImageThreadStruct *str;
+  int ext[6], splitExt[6], total;
+  int threadId, threadCount;
+  
+  threadId = ((vtkMultiThreader::ThreadInfo *)(arg))->ThreadID;
+  threadCount = ((vtkMultiThreader::ThreadInfo *)(arg))->NumberOfThreads;
+  
+  str = (vtkImageThreadStruct *)
+    (((vtkMultiThreader::ThreadInfo *)(arg))->UserData);
+
+  if (!vtkThreadedImageAlgorithmGetExecuteExtent(str, ext))
+    {
+    return VTK_THREAD_RETURN_VALUE;
+    }
+
   // execute the actual method with appropriate extent
   // first find out how many pieces extent can be split into.
   total = str->Filter->SplitExtent(splitExt, ext, threadId, threadCount);
@@ -197,6 +276,8 @@ VTK_THREAD_RETURN_TYPE vtkThreadedImageAlgorithmThreadedExecute( void *arg )
       {
       return VTK_THREAD_RETURN_VALUE;
       }
+    vtkTimerLogTraceScope scope("Algorithm", str->Filter,
+                                "ThreadedRequestData");
     str->Filter->ThreadedRequestData(str->Request,
                                      str->InputsInfo, str->OutputsInfo,
                                      str->Inputs, str->Outputs, 
@@ -213,6 +294,151 @@ VTK_THREAD_RETURN_TYPE vtkThreadedImageAlgorithmThreadedExecute( void *arg )
 }
 
 
+//----------------------------------------------------------------------------
+int vtkThreadedImageAlgorithm::ComputeBrickSize(int extent[6],
+                                                int bytesPerPoint,
+                                                int brickSize[3])
+{
+  int dims[3];
+  int i;
+  for (i = 0; i < 3; ++i)
+    {
+    dims[i] = extent[2*i+1] - extent[2*i] + 1;
+    if (dims[i] < 1)
+      {
+      brickSize[0] = brickSize[1] = brickSize[2] = 0;
+      return 0;
+      }
+    }
+
+  // Grow the brick along x first so that it covers contiguous memory,
+  // then along y and z.
+  vtkIdType points = this->DesiredBytesPerPiece /
+    (bytesPerPoint > 0 ? bytesPerPoint : 1);
+  points = (points < 1 ? 1 : points);
+  // The number of bricks is counted in double, which cannot overflow.
+  double numberOfBricks = 1.0;
+  for (i = 0; i < 3; ++i)
+    {
+    vtkIdType size = (points < dims[i] ? points : dims[i]);
+    size = (size < 1 ? 1 : size);
+    brickSize[i] = static_cast<int>(size);
+    points /= size;
+    numberOfBricks *= (dims[i] - 1) / brickSize[i] + 1;
+    }
+
+  // Keep the number of bricks, and the extents and times recorded for
+  // them, bounded.
+  while (numberOfBricks > VTK_THREADED_IMAGE_MAX_BRICKS)
+    {
+    int axis = (brickSize[2] < dims[2] ? 2 : (brickSize[1] < dims[1] ? 1 : 0));
+    brickSize[axis] = (brickSize[axis] < dims[axis]/2 ?
+                       2*brickSize[axis] : dims[axis]);
+    numberOfBricks = 1.0;
+    for (i = 0; i < 3; ++i)
+      {
+      numberOfBricks *= (dims[i] - 1) / brickSize[i] + 1;
+      }
+    }
+
+  return static_cast<int>(numberOfBricks);
+}
+
+//----------------------------------------------------------------------------
+// The information needed to execute the bricks of one update.
+struct vtkImageBrickStruct
+{
+  vtkImageThreadStruct *Thread;
+  int Extent[6];
+  int BrickSize[3];
+  int NumberOfBricks[3];
+  int *PieceExtents;
+  double *PieceTimes;
+};
+
+//----------------------------------------------------------------------------
+// Execute the bricks [begin, end) and record how long each one took.
+static void vtkThreadedImageAlgorithmBrickExecute(void *arg, vtkIdType begin,
+                                                  vtkIdType end)
+{
+  vtkImageBrickStruct *bricks = static_cast<vtkImageBrickStruct *>(arg);
+  vtkImageThreadStruct *str = bricks->Thread;
+
+  for (vtkIdType brick = begin; brick < end; ++brick)
+    {
+    int idx[3];
+    idx[0] = static_cast<int>(brick % bricks->NumberOfBricks[0]);
+    idx[1] = static_cast<int>((brick / bricks->NumberOfBricks[0]) %
+                              bricks->NumberOfBricks[1]);
+    idx[2] = static_cast<int>(brick / bricks->NumberOfBricks[0] /
+                              bricks->NumberOfBricks[1]);
+
+    int *splitExt = bricks->PieceExtents + 6*brick;
+    for (int i = 0; i < 3; ++i)
+      {
+      splitExt[2*i] = bricks->Extent[2*i] + idx[i]*bricks->BrickSize[i];
+      splitExt[2*i+1] = splitExt[2*i] + bricks->BrickSize[i] - 1;
+      if (splitExt[2*i+1] > bricks->Extent[2*i+1])
+        {
+        splitExt[2*i+1] = bricks->Extent[2*i+1];
+        }
+      }
+
+    vtkTimerLogTraceScope scope("Algorithm", str->Filter,
+                                "ThreadedRequestData");
+    double startTime = vtkTimerLog::GetUniversalTime();
+    str->Filter->ThreadedRequestData(str->Request,
+                                     str->InputsInfo, str->OutputsInfo,
+                                     str->Inputs, str->Outputs,
+                                     splitExt, static_cast<int>(brick));
+    bricks->PieceTimes[brick] = vtkTimerLog::GetUniversalTime() - startTime;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Split the extent into bricks and execute them on the task scheduler.
+// Returns 0 if there is nothing to execute.
+static int vtkThreadedImageAlgorithmExecuteBricks(vtkImageThreadStruct *str,
+                                                  int bytesPerPoint,
+                                                  int &numberOfPieces,
+                                                  int *&pieceExtents,
+                                                  double *&pieceTimes)
+{
+  vtkImageBrickStruct bricks;
+  bricks.Thread = str;
+  if (!vtkThreadedImageAlgorithmGetExecuteExtent(str, bricks.Extent))
+    {
+    return 0;
+    }
+  int total = str->Filter->ComputeBrickSize(bricks.Extent, bytesPerPoint,
+                                            bricks.BrickSize);
+  if (total <= 0)
+    {
+    return 0;
+    }
+  for (int i = 0; i < 3; ++i)
+    {
+    int size = bricks.Extent[2*i+1] - bricks.Extent[2*i] + 1;
+    bricks.NumberOfBricks[i] = (size - 1) / bricks.BrickSize[i] + 1;
+    }
+
+  if (total != numberOfPieces)
+    {
+    delete [] pieceExtents;
+    delete [] pieceTimes;
+    numberOfPieces = total;
+    pieceExtents = new int [6*static_cast<size_t>(total)];
+    pieceTimes = new double [total];
+    }
+  bricks.PieceExtents = pieceExtents;
+  bricks.PieceTimes = pieceTimes;
+
+  vtkTaskScheduler::GetGlobalScheduler()->ParallelFor(
+    0, total, 1, vtkThreadedImageAlgorithmBrickExecute, &bricks);
+
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 // This is the superclasses style of Execute method.  Convert it into
 // an imaging style Execute method.
@@ -283,13 +509,47 @@ int vtkThreadedImageAlgorithm::RequestData(
     this->CopyAttributeData(str.Inputs[0][0],str.Outputs[0],inputVector);
     }
     
-  this->Threader->SetNumberOfThreads(this->NumberOfThreads);
-  this->Threader->SetSingleMethod(vtkThreadedImageAlgorithmThreadedExecute, &str);  
-
   // always shut off debugging to avoid threading problems with GetMacros
   int debug = this->Debug;
   this->Debug = 0;
-  this->Threader->SingleMethodExecute();
+
+  if (this->SplitMode == VTK_THREADED_IMAGE_SPLIT_BRICK &&
+      this->NumberOfThreads > 1)
+    {
+    // size the bricks by the output scalars, or by the input scalars
+    // when there is no output
+    vtkImageData *sizeData = 0;
+    if (str.Outputs)
+      {
+      sizeData = str.Outputs[0];
+      }
+    else if (str.Inputs && str.Inputs[0])
+      {
+      sizeData = str.Inputs[0][0];
+      }
+    int bytesPerPoint = 1;
+    if (sizeData)
+      {
+      bytesPerPoint = sizeData->GetScalarSize() *
+        sizeData->GetNumberOfScalarComponents();
+      }
+    if (!vtkThreadedImageAlgorithmExecuteBricks(&str, bytesPerPoint,
+                                                this->NumberOfPieces,
+                                                this->PieceExtents,
+                                                this->PieceTimes))
+      {
+      this->NumberOfPieces = 0;
+      }
+    }
+  else
+    {
+    this->NumberOfPieces = 0;
+    this->Threader->SetNumberOfThreads(this->NumberOfThreads);
+    this->Threader->SetSingleMethod(vtkThreadedImageAlgorithmThreadedExecute,
+                                    &str);
+    this->Threader->SingleMethodExecute();
+    }
+
   this->Debug = debug;
 
   // free up the arrays
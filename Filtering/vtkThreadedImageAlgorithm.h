@@ -19,14 +19,33 @@
 // into smaller extents so that the vtkImageData limits are observed. It 
 // also provides support for multithreading. If you don't need any of this
 // functionality, consider using vtkSimpleImageToImageAlgorithm instead.
+// The pieces are executed on the persistent threads of the global
+// vtkTaskScheduler, so no threads are created for each update.
+//
+// By default the update extent is split into one slab per thread.  In
+// brick mode it is instead split into many small bricks of about
+// DesiredBytesPerPiece bytes of output, which idle threads take as they
+// become free.  This balances kernels whose cost varies across the
+// extent.  In brick mode the threadId passed to ThreadedRequestData() is
+// the brick number, so brick mode must only be used by filters that do
+// not keep per-thread state indexed by threadId.  The bricks run on all
+// the threads of the global vtkTaskScheduler; setting NumberOfThreads to
+// one still executes the whole extent at once.  The execution time of
+// every brick is recorded for checking the load balance.
 // .SECTION See also
-// vtkSimpleImageToImageAlgorithm
+// vtkSimpleImageToImageAlgorithm vtkTaskScheduler
 
 #ifndef __vtkThreadedImageAlgorithm_h
 #define __vtkThreadedImageAlgorithm_h
 
 #include "vtkImageAlgorithm.h"
 
+#define VTK_THREADED_IMAGE_SPLIT_SLAB 0
+#define VTK_THREADED_IMAGE_SPLIT_BRICK 1
+
+// The largest number of bricks an extent is split into.
+#define VTK_THREADED_IMAGE_MAX_BRICKS 65536
+
 class vtkImageData;
 class vtkMultiThreader;
 
@@ -58,17 +77,63 @@ public:
   vtkSetClampMacro( NumberOfThreads, int, 1, VTK_MAX_THREADS );
   vtkGetMacro( NumberOfThreads, int );
 
+  // Description:
+  // Set/Get how the update extent is divided among the threads.  Slab
+  // mode gives each thread one piece.  Brick mode hands out many small
+  // pieces as threads become free.  The default is slab mode.
+  vtkSetClampMacro(SplitMode, int, VTK_THREADED_IMAGE_SPLIT_SLAB,
+                   VTK_THREADED_IMAGE_SPLIT_BRICK);
+  vtkGetMacro(SplitMode, int);
+  void SetSplitModeToSlab()
+    {this->SetSplitMode(VTK_THREADED_IMAGE_SPLIT_SLAB);}
+  void SetSplitModeToBrick()
+    {this->SetSplitMode(VTK_THREADED_IMAGE_SPLIT_BRICK);}
+  const char *GetSplitModeAsString();
+
+  // Description:
+  // Set/Get the size in bytes of output that each brick should cover in
+  // brick mode.  Pick it so that a brick and the input it reads fit in
+  // the cache; cheap kernels do better with larger bricks.  The default
+  // is 65536.
+  vtkSetClampMacro(DesiredBytesPerPiece, vtkIdType, 1, VTK_LARGE_ID);
+  vtkGetMacro(DesiredBytesPerPiece, vtkIdType);
+
+  // Description:
+  // Get the number of bricks of the last execution in brick mode, and
+  // the extent and wall-clock time in seconds of each of them.
+  vtkGetMacro(NumberOfPieces, int);
+  void GetPieceExtent(int piece, int extent[6]);
+  double GetPieceTime(int piece);
+
   // Description:
   // Putting this here until I merge graphics and imaging streaming.
   virtual int SplitExtent(int splitExt[6], int startExt[6], 
                           int num, int total); 
 
+  // Description:
+  // Compute the dimensions of the bricks that the given extent is split
+  // into in brick mode, for the given number of bytes per output point.
+  // Bricks span whole rows when a row fits in DesiredBytesPerPiece, and
+  // whole slices when a slice fits.  The bricks are made larger when
+  // more than VTK_THREADED_IMAGE_MAX_BRICKS would be needed.  Returns the
+  // number of bricks.
+  virtual int ComputeBrickSize(int extent[6], int bytesPerPoint,
+                               int brickSize[3]);
+
 protected:
   vtkThreadedImageAlgorithm();
   ~vtkThreadedImageAlgorithm();
 
   vtkMultiThreader *Threader;
   int NumberOfThreads;
+
+  int SplitMode;
+  vtkIdType DesiredBytesPerPiece;
+
+  // The bricks of the last execution and their execution times.
+  int NumberOfPieces;
+  int *PieceExtents;
+  double *PieceTimes;
   
   // Description:
   // This is called by the superclass.
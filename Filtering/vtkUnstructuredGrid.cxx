@@ -376,7 +376,6 @@ int vtkUnstructuredGrid::GetCellType(vtkIdType cellId)
 vtkCell *vtkUnstructuredGrid::GetCell(vtkIdType cellId)
 {
   int i;
-  int loc;
   vtkCell *cell = NULL;
   vtkIdType *pts, numPts;
 
@@ -588,9 +587,7 @@ vtkCell *vtkUnstructuredGrid::GetCell(vtkIdType cellId)
     return NULL;
     }
 
-  loc = this->Locations->GetValue(cellId);
-  vtkDebugMacro(<< "location = " <<  loc);
-  this->Connectivity->GetCell(loc,numPts,pts);
+  this->GetCellPoints(cellId,numPts,pts);
 
   cell->PointIds->SetNumberOfIds(numPts);
   cell->Points->SetNumberOfPoints(numPts);
@@ -613,14 +610,12 @@ vtkCell *vtkUnstructuredGrid::GetCell(vtkIdType cellId)
 void vtkUnstructuredGrid::GetCell(vtkIdType cellId, vtkGenericCell *cell)
 {
   int i;
-  int    loc;
   double  x[3];
   vtkIdType *pts, numPts;
 
   cell->SetCellType((int)Types->GetValue(cellId));
 
-  loc = this->Locations->GetValue(cellId);
-  this->Connectivity->GetCell(loc,numPts,pts);
+  this->GetCellPoints(cellId,numPts,pts);
 
   cell->PointIds->SetNumberOfIds(numPts);
   cell->Points->SetNumberOfPoints(numPts);
@@ -644,12 +639,10 @@ void vtkUnstructuredGrid::GetCell(vtkIdType cellId, vtkGenericCell *cell)
 void vtkUnstructuredGrid::GetCellBounds(vtkIdType cellId, double bounds[6])
 {
   int i;
-  int loc;
   double x[3];
   vtkIdType *pts, numPts;
 
-  loc = this->Locations->GetValue(cellId);
-  this->Connectivity->GetCell(loc,numPts,pts);
+  this->GetCellPoints(cellId,numPts,pts);
 
   // carefully compute the bounds
   if (numPts)
@@ -705,6 +698,7 @@ vtkIdType vtkUnstructuredGrid::GetNumberOfCells()
 vtkIdType vtkUnstructuredGrid::InsertNextCell(int type, vtkIdList *ptIds)
 {
   vtkIdType npts = ptIds->GetNumberOfIds();
+  this->BuildLocations();
   // insert connectivity
   this->Connectivity->InsertNextCell(ptIds);
   // insert type and storage information
@@ -721,6 +715,7 @@ vtkIdType vtkUnstructuredGrid::InsertNextCell(int type, vtkIdList *ptIds)
 vtkIdType vtkUnstructuredGrid::InsertNextCell(int type, vtkIdType npts,
                                               vtkIdType *pts)
 {
+  this->BuildLocations();
   // insert connectivity
   this->Connectivity->InsertNextCell(npts,pts);
   // insert type and storage information
@@ -763,7 +758,19 @@ void vtkUnstructuredGrid::SetCells(int type, vtkCellArray *cells)
   if ( this->Locations)
     {
     this->Locations->UnRegister(this);
+    this->Locations = NULL;
+    }
+
+  // cells kept with offsets need no locations
+  if ( !cells->IsStorageInterleaved() )
+    {
+    for (i=0; i < cells->GetNumberOfCells(); i++)
+      {
+      this->Types->InsertNextValue((unsigned char) type);
+      }
+    return;
     }
+
   this->Locations = vtkIdTypeArray::New();
   this->Locations->Allocate(cells->GetNumberOfCells(),1000);
   this->Locations->Register(this);
@@ -809,7 +816,19 @@ void vtkUnstructuredGrid::SetCells(int *types, vtkCellArray *cells)
   if ( this->Locations)
     {
     this->Locations->UnRegister(this);
+    this->Locations = NULL;
     }
+
+  // cells kept with offsets need no locations
+  if ( !cells->IsStorageInterleaved() )
+    {
+    for (i=0; i < cells->GetNumberOfCells(); i++)
+      {
+      this->Types->InsertNextValue((unsigned char) types[i]);
+      }
+    return;
+    }
+
   this->Locations = vtkIdTypeArray::New();
   this->Locations->Allocate(cells->GetNumberOfCells(),1000);
   this->Locations->Register(this);
@@ -861,7 +880,30 @@ void vtkUnstructuredGrid::SetCells(vtkUnsignedCharArray *cellTypes,
     {
     this->Locations->Register(this);
     }
+}
+
+//----------------------------------------------------------------------------
+void vtkUnstructuredGrid::BuildLocations()
+{
+  vtkIdType *pts = 0;
+  vtkIdType npts = 0;
+
+  if ( this->Locations || !this->Connectivity )
+    {
+    return;
+    }
+
+  this->Locations = vtkIdTypeArray::New();
+  this->Locations->Allocate(this->Connectivity->GetNumberOfCells(),1000);
+  this->Locations->Register(this);
+  this->Locations->Delete();
 
+  for (this->Connectivity->InitTraversal(); 
+       this->Connectivity->GetNextCell(npts,pts);)
+    {
+    this->Locations->InsertNextValue(
+      this->Connectivity->GetTraversalLocation(npts));
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -884,11 +926,9 @@ void vtkUnstructuredGrid::BuildLinks()
 void vtkUnstructuredGrid::GetCellPoints(vtkIdType cellId, vtkIdList *ptIds)
 {
   int i;
-  int loc;
   vtkIdType *pts, numPts;
 
-  loc = this->Locations->GetValue(cellId);
-  this->Connectivity->GetCell(loc,numPts,pts);
+  this->GetCellPoints(cellId,numPts,pts);
   ptIds->SetNumberOfIds(numPts);
   for (i=0; i<numPts; i++)
     {
@@ -905,6 +945,16 @@ void vtkUnstructuredGrid::GetCellPoints(vtkIdType cellId, vtkIdType& npts,
 {
   int loc;
 
+  if ( !this->Locations )
+    {
+    if ( !this->Connectivity->IsStorageInterleaved() )
+      {
+      this->Connectivity->GetCellAtId(cellId,npts,pts);
+      return;
+      }
+    this->BuildLocations();
+    }
+
   loc = this->Locations->GetValue(cellId);
 
   this->Connectivity->GetCell(loc,npts,pts);
@@ -1016,6 +1066,7 @@ void vtkUnstructuredGrid::ReplaceCell(vtkIdType cellId, int npts,
 {
   int loc;
 
+  this->BuildLocations();
   loc = this->Locations->GetValue(cellId);
   this->Connectivity->ReplaceCell(loc,npts,pts);
 }
@@ -85,7 +85,8 @@ public:
 
   int GetCellType(vtkIdType cellId);
   vtkUnsignedCharArray* GetCellTypesArray() { return this->Types; }
-  vtkIdTypeArray* GetCellLocationsArray() { return this->Locations; }
+  vtkIdTypeArray* GetCellLocationsArray() 
+    { this->BuildLocations(); return this->Locations; }
   void Squeeze();
   void Initialize();
   int GetMaxCellSize();
@@ -96,7 +97,13 @@ public:
 
   // Description:
   // Special methods specific to vtkUnstructuredGrid for defining the cells
-  // composing the dataset.
+  // composing the dataset.  Cells kept with offsets (see
+  // vtkCellArray::SetData()) are used as they are, without cell locations,
+  // when no locations are given.  Point ids that do not have the size of
+  // vtkIdType are converted, into a copy of the connectivity, by the first
+  // GetCell() or GetCellPoints(), which must then be called from a single
+  // thread.  GetCellLocationsArray() builds the locations, and the
+  // interleaved list, when they are needed.
   void SetCells(int type, vtkCellArray *cells);
   void SetCells(int *types, vtkCellArray *cells);
   void SetCells(vtkUnsignedCharArray *cellTypes, vtkIdTypeArray *cellLocations, 
@@ -177,6 +184,10 @@ protected:
   vtkUnstructuredGrid();
   ~vtkUnstructuredGrid();
 
+  // Build the cell locations if there are none, which converts cells kept
+  // with offsets to the interleaved list.
+  void BuildLocations();
+
   // used by GetCell method
   vtkVertex              *Vertex;
   vtkPolyVertex          *PolyVertex;
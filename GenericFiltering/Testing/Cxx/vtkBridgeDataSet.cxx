@@ -33,6 +33,8 @@
 #include "vtkGenericAttributeCollection.h"
 #include "vtkPointData.h"
 #include "vtkCellData.h"
+#include "vtkPointSet.h"
+#include "vtkPoints.h"
 #include "vtkBridgeAttribute.h"
 #include "vtkGenericCellTessellator.h"
 #include "vtkGenericEdgeTable.h"
@@ -123,6 +125,49 @@ void vtkBridgeDataSet::SetDataSet(vtkDataSet *ds)
   this->Modified();
 }
 
+//----------------------------------------------------------------------------
+// Description:
+// Shallow copy. The dataset of `src' is shallow copied, so that the cells
+// and the point locator built by the copy are not shared with `src'. The
+// points are deep copied: vtkPoints::GetPoint() writes to its array.
+void vtkBridgeDataSet::ShallowCopy(vtkDataObject *src)
+{
+  this->Superclass::ShallowCopy(src);
+  vtkBridgeDataSet *other=vtkBridgeDataSet::SafeDownCast(src);
+  if(other!=0&&other->Implementation!=0)
+    {
+    vtkDataSet *ds=other->Implementation->NewInstance();
+    ds->ShallowCopy(other->Implementation);
+    vtkPointSet *ps=vtkPointSet::SafeDownCast(ds);
+    if(ps!=0&&ps->GetPoints()!=0)
+      {
+      vtkPoints *points=vtkPoints::New();
+      points->SetDataType(ps->GetPoints()->GetDataType());
+      points->DeepCopy(ps->GetPoints());
+      ps->SetPoints(points);
+      points->Delete();
+      }
+    this->SetDataSet(ds);
+    ds->Delete();
+    }
+}
+
+//----------------------------------------------------------------------------
+// Description:
+// Deep copy.
+void vtkBridgeDataSet::DeepCopy(vtkDataObject *src)
+{
+  this->Superclass::DeepCopy(src);
+  vtkBridgeDataSet *other=vtkBridgeDataSet::SafeDownCast(src);
+  if(other!=0&&other->Implementation!=0)
+    {
+    vtkDataSet *ds=other->Implementation->NewInstance();
+    ds->DeepCopy(other->Implementation);
+    this->SetDataSet(ds);
+    ds->Delete();
+    }
+}
+
 //----------------------------------------------------------------------------
 // Description:
 // Number of points composing the dataset. See NewPointIterator for more
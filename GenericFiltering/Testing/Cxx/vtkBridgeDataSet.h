@@ -36,6 +36,14 @@ public:
   // Set the dataset that will be manipulated through the adaptor interface.
   // \pre ds_exists: ds!=0
   void SetDataSet(vtkDataSet *ds);
+
+  // Description:
+  // Shallow and Deep copy. The copy manipulates its own shallow or deep
+  // copy of the dataset of `src', with its own attributes, so that another
+  // thread can use it while `src' is in use.
+  void ShallowCopy(vtkDataObject *src);
+  void DeepCopy(vtkDataObject *src);
+
   // Description:
   // Number of points composing the dataset. See NewPointIterator for more
   // details.
@@ -26,10 +26,12 @@
 #include "vtkRungeKutta2.h"
 #include "vtkRungeKutta4.h"
 #include "vtkRungeKutta45.h"
+#include "vtkTaskScheduler.h"
 #include "vtkGenericDataSet.h"
 #include "vtkGenericAttributeCollection.h"
 #include "vtkGenericAttribute.h"
 #include "vtkGenericAdaptorCell.h"
+#include "vtkGenericCellIterator.h"
 #include <assert.h>
 
 #include "vtkInformation.h"
@@ -74,6 +76,7 @@ vtkGenericStreamTracer::vtkGenericStreamTracer()
 
   this->ComputeVorticity = 1;
   this->RotationScale = 1.0;
+  this->ThreadedIntegration = 0;
 
   this->InputVectorsSelection = 0;
 
@@ -710,6 +713,51 @@ int vtkGenericStreamTracer::CheckInputs(
   return VTK_OK;
 }
 
+//-----------------------------------------------------------------------------
+// The streamlines of a range of seeds, with what is needed to integrate
+// them.  When the seeds are integrated one after the other, the outputs
+// are those of the filter.
+class vtkGenericStreamTracerLines
+{
+public:
+  vtkDataArray* SeedSource;
+  vtkIdList* SeedIds;
+  vtkIntArray* IntegrationDirections;
+  vtkIdType Begin;
+  vtkIdType End;
+  int ReportProgress;
+
+  vtkGenericInterpolatedVelocityField* Func;
+  vtkInitialValueProblemSolver* Integrator;
+  double* Values; // point centered attributes at some point
+
+  vtkPoints* Points;
+  vtkCellArray* Lines;
+  vtkDataSetAttributes* PointData;
+  vtkDoubleArray* Time;
+  vtkIntArray* RetVals;
+  vtkDoubleArray* Vorticity;
+  vtkDoubleArray* Rotation;
+  vtkDoubleArray* AngularVel;
+
+  double LastPoint[3];
+  int LastPointSet;
+  double LastUsedTimeStep;
+  int LastUsedTimeStepSet;
+  int Abort;
+};
+
+// The ranges of seeds integrated together on the threads.
+struct vtkGenericStreamTracerTaskData
+{
+  vtkGenericStreamTracer* Self;
+  vtkGenericStreamTracerLines* Ranges;
+};
+
+// The number of ranges of seeds for each thread.  Streamlines differ in
+// length, so there are more ranges than threads to balance the work.
+#define VTK_GENERIC_STREAM_TRACER_RANGES_PER_THREAD 8
+
 //-----------------------------------------------------------------------------
 void vtkGenericStreamTracer::Integrate(
   vtkGenericDataSet *input0,
@@ -726,10 +774,6 @@ void vtkGenericStreamTracer::Integrate(
   // Useful pointers
   vtkDataSetAttributes* outputPD = output->GetPointData();
   vtkDataSetAttributes* outputCD = output->GetCellData();
-  vtkGenericDataSet* input;
-  vtkGenericAttribute* inVectors;
-  
-  int direction=1;
 
   if (this->GetIntegrator() == 0)
     {
@@ -737,10 +781,6 @@ void vtkGenericStreamTracer::Integrate(
     return;
     }
 
-  // Used in GetCell() 
-//  vtkGenericCell* cell = vtkGenericCell::New();
-  vtkGenericAdaptorCell *cell=0;
-  
   // Create a new integrator, the type is the same as Integrator
   vtkInitialValueProblemSolver* integrator = 
     this->GetIntegrator()->NewInstance();
@@ -822,18 +862,141 @@ void vtkGenericStreamTracer::Integrate(
   // Note:  It is an overestimation to have the estimate the same number of
   // output points and input points.  We sill have to squeeze at end.
 
-  vtkIdType numPtsTotal=0;
-  double velocity[3];
+  vtkGenericStreamTracerLines lines;
+  lines.SeedSource = seedSource;
+  lines.SeedIds = seedIds;
+  lines.IntegrationDirections = integrationDirections;
+  lines.Begin = 0;
+  lines.End = numLines;
+  lines.ReportProgress = 1;
+  lines.Func = func;
+  lines.Integrator = integrator;
+  lines.Values = values;
+  lines.Points = outputPoints;
+  lines.Lines = outputLines;
+  lines.PointData = outputPD;
+  lines.Time = time;
+  lines.RetVals = retVals;
+  lines.Vorticity = vorticity;
+  lines.Rotation = rotation;
+  lines.AngularVel = angularVel;
+  lines.LastPointSet = 0;
+  lines.LastUsedTimeStepSet = 0;
+  lines.Abort = 0;
+
+  int shouldAbort;
+  int threaded = 0;
+  if (this->ThreadedIntegration)
+    {
+    threaded = this->IntegrateInThreads(input0, &lines);
+    }
+  if (threaded)
+    {
+    shouldAbort = (threaded < 0);
+    }
+  else
+    {
+    this->IntegrateLines(&lines);
+    shouldAbort = lines.Abort;
+    }
+  if (lines.LastPointSet)
+    {
+    memcpy(lastPoint, lines.LastPoint, 3*sizeof(double));
+    }
+  if (lines.LastUsedTimeStepSet)
+    {
+    this->LastUsedTimeStep = lines.LastUsedTimeStep;
+    }
 
-  int shouldAbort = 0;
+  if (!shouldAbort)
+    {
+    // Create the output polyline
+    output->SetPoints(outputPoints);
+    outputPD->AddArray(time);
+    if (vorticity)
+      {
+      outputPD->AddArray(vorticity);
+      outputPD->AddArray(rotation);
+      outputPD->AddArray(angularVel);
+      }
+    
+    vtkIdType numPts = outputPoints->GetNumberOfPoints();
+    if ( numPts > 1 )
+      {
+      // Assign geometry and attributes
+      output->SetLines(outputLines);
+      if (this->GenerateNormalsInIntegrate)
+        {
+        this->GenerateNormals(output, 0);
+        }
 
-  for(int currentLine = 0; currentLine < numLines; currentLine++)
+      outputCD->AddArray(retVals);
+      }
+    }
+
+  if (vorticity)
+    {
+    vorticity->Delete();
+    rotation->Delete();
+    angularVel->Delete();
+    }
+
+ 
+  retVals->Delete();
+
+  outputPoints->Delete();
+  outputLines->Delete();
+
+  time->Delete();
+
+
+  integrator->Delete();
+  
+  delete[] values;
+  
+  output->Squeeze();
+  return;
+}
+
+//-----------------------------------------------------------------------------
+void vtkGenericStreamTracer::IntegrateLines(vtkGenericStreamTracerLines *lines)
+{
+  int i;
+  vtkIdType numLines = lines->SeedIds->GetNumberOfIds();
+
+  // Useful pointers
+  vtkGenericInterpolatedVelocityField* func = lines->Func;
+  vtkInitialValueProblemSolver* integrator = lines->Integrator;
+  double* values = lines->Values;
+  vtkPoints* outputPoints = lines->Points;
+  vtkCellArray* outputLines = lines->Lines;
+  vtkDataSetAttributes* outputPD = lines->PointData;
+  vtkDoubleArray* time = lines->Time;
+  vtkIntArray* retVals = lines->RetVals;
+  vtkDoubleArray* vorticity = lines->Vorticity;
+  vtkDoubleArray* rotation = lines->Rotation;
+  vtkDoubleArray* angularVel = lines->AngularVel;
+  vtkGenericDataSet* input;
+  vtkGenericAttribute* inVectors;
+  vtkGenericAdaptorCell *cell=0;
+  int c;
+  
+  int direction=1;
+
+  vtkIdType numPtsTotal=outputPoints->GetNumberOfPoints();
+  double velocity[3];
+
+  for(vtkIdType currentLine = lines->Begin; currentLine < lines->End;
+      currentLine++)
     {
 
     double progress = static_cast<double>(currentLine)/numLines;
-    this->UpdateProgress(progress);
+    if (lines->ReportProgress)
+      {
+      this->UpdateProgress(progress);
+      }
 
-    switch (integrationDirections->GetValue(currentLine))
+    switch (lines->IntegrationDirections->GetValue(currentLine))
       {
       case FORWARD:
         direction = 1;
@@ -853,7 +1016,7 @@ void vtkGenericStreamTracer::Integrate(
 
     
     // Initial point
-    seedSource->GetTuple(seedIds->GetId(currentLine), point1);
+    lines->SeedSource->GetTuple(lines->SeedIds->GetId(currentLine), point1);
     memcpy(point2, point1, 3*sizeof(double));
     if (!func->FunctionValues(point1, velocity))
       {
@@ -958,7 +1121,7 @@ void vtkGenericStreamTracer::Integrate(
         break;
         }
 
-      if ( numSteps++ % 1000 == 1 )
+      if ( numSteps++ % 1000 == 1 && lines->ReportProgress )
         {
         progress = 
           (currentLine + propagation / this->MaximumPropagation.Interval) /
@@ -967,7 +1130,7 @@ void vtkGenericStreamTracer::Integrate(
 
         if (this->GetAbortExecute())
           {
-          shouldAbort = 1;
+          lines->Abort = 1;
           break;
           }
         }
@@ -998,7 +1161,8 @@ void vtkGenericStreamTracer::Integrate(
           }
         maxStep = delT.Interval;
         }
-      this->LastUsedTimeStep = delT.Interval;
+      lines->LastUsedTimeStep = delT.Interval;
+      lines->LastUsedTimeStepSet = 1;
           
       // Calculate the next step using the integrator provided
       // Break if the next point is out of bounds.
@@ -1008,7 +1172,8 @@ void vtkGenericStreamTracer::Integrate(
                                        this->MaximumError, error)) != 0)
         {
         retVal = tmp;
-        memcpy(lastPoint, point2, 3*sizeof(double));
+        memcpy(lines->LastPoint, point2, 3*sizeof(double));
+        lines->LastPointSet = 1;
         break;
         }
 
@@ -1029,7 +1194,8 @@ void vtkGenericStreamTracer::Integrate(
       if ( !func->FunctionValues(point2, velocity) )
         {
         retVal = OUT_OF_DOMAIN;
-        memcpy(lastPoint, point2, 3*sizeof(double));
+        memcpy(lines->LastPoint, point2, 3*sizeof(double));
+        lines->LastPointSet = 1;
         break;
         }
       
@@ -1123,7 +1289,7 @@ void vtkGenericStreamTracer::Integrate(
       // End Integration
       }
 
-    if (shouldAbort)
+    if (lines->Abort)
       {
       break;
       }
@@ -1138,55 +1304,222 @@ void vtkGenericStreamTracer::Integrate(
       retVals->InsertNextValue(retVal);
       }
     }
+}
 
-  if (!shouldAbort)
+//-----------------------------------------------------------------------------
+// Append the tuples of from to to, which have the same type and number
+// of components.
+static void vtkGenericStreamTracerAppendArray(vtkDataArray* to,
+                                              vtkDataArray* from)
+{
+  vtkIdType numTuples = from->GetNumberOfTuples();
+  if (numTuples == 0)
     {
-    // Create the output polyline
-    output->SetPoints(outputPoints);
-    outputPD->AddArray(time);
-    if (vorticity)
+    return;
+    }
+  if (from->GetDataType() == VTK_BIT)
+    {
+    for (vtkIdType i = 0; i < numTuples; i++)
       {
-      outputPD->AddArray(vorticity);
-      outputPD->AddArray(rotation);
-      outputPD->AddArray(angularVel);
+      to->InsertNextTuple(from->GetTuple(i));
       }
-    
-    vtkIdType numPts = outputPoints->GetNumberOfPoints();
-    if ( numPts > 1 )
-      {
-      // Assign geometry and attributes
-      output->SetLines(outputLines);
-      if (this->GenerateNormalsInIntegrate)
-        {
-        this->GenerateNormals(output, 0);
-        }
+    return;
+    }
+  vtkIdType numValues = numTuples*from->GetNumberOfComponents();
+  void* dest = to->WriteVoidPointer(
+    to->GetNumberOfTuples()*to->GetNumberOfComponents(), numValues);
+  memcpy(dest, from->GetVoidPointer(0), numValues*from->GetDataTypeSize());
+}
 
-      outputCD->AddArray(retVals);
-      }
+//-----------------------------------------------------------------------------
+void vtkGenericStreamTracer::IntegrateLinesTask(void *arg, vtkIdType begin,
+                                                vtkIdType end)
+{
+  vtkGenericStreamTracerTaskData* td =
+    static_cast<vtkGenericStreamTracerTaskData*>(arg);
+  for (vtkIdType range = begin; range < end; range++)
+    {
+    td->Self->IntegrateLines(td->Ranges + range);
     }
+}
 
-  if (vorticity)
+//-----------------------------------------------------------------------------
+int vtkGenericStreamTracer::IntegrateInThreads(
+  vtkGenericDataSet *input,
+  vtkGenericStreamTracerLines *lines)
+{
+  vtkTaskScheduler* scheduler = vtkTaskScheduler::GetGlobalScheduler();
+  int numThreads = scheduler->GetNumberOfThreads();
+  vtkIdType numLines = lines->SeedIds->GetNumberOfIds();
+
+  // With several inputs, where a streamline starts depends on where the
+  // previous one ended.
+  if (numThreads < 2 || numLines < 2 ||
+      this->GetNumberOfInputConnections(0) != 1)
     {
-    vorticity->Delete();
-    rotation->Delete();
-    angularVel->Delete();
+    return 0;
     }
 
- 
-  retVals->Delete();
+  vtkDebugMacro(<<"Integrating " << numLines << " seeds on "
+                << numThreads << " threads");
+
+  int numComponents = lines->PointData->GetNumberOfComponents();
+
+  vtkIdType numRanges = numThreads*VTK_GENERIC_STREAM_TRACER_RANGES_PER_THREAD;
+  numRanges = (numRanges < numLines ? numRanges : numLines);
+  vtkIdType rangesPerRound = 2*numThreads;
+  rangesPerRound = (rangesPerRound < numRanges ? rangesPerRound : numRanges);
+  vtkGenericStreamTracerLines* ranges =
+    new vtkGenericStreamTracerLines[rangesPerRound];
+  vtkGenericStreamTracerTaskData td;
+  td.Self = this;
+  td.Ranges = ranges;
+
+  // Adaptors cache cells and attribute values, and build their bounds and
+  // cells on first use.  These are built here, then each range of a round
+  // integrates in its own copy of the input, which is reused by the ranges
+  // at the same place in the next rounds.
+  input->GetLength();
+  vtkGenericCellIterator* it = input->NewCellIterator();
+  it->Begin();
+  if (!it->IsAtEnd())
+    {
+    it->GetCell();
+    }
+  it->Delete();
+  vtkGenericDataSet** inputs = new vtkGenericDataSet*[rangesPerRound];
+  vtkIdType r;
+  for (r = 0; r < rangesPerRound; r++)
+    {
+    inputs[r] = input->NewInstance();
+    inputs[r]->ShallowCopy(input);
+    inputs[r]->GetLength();
+    }
 
-  outputPoints->Delete();
-  outputLines->Delete();
+  // Integrate a few ranges per thread at a time, reporting progress and
+  // checking for abort in between.
+  int abort = 0;
+  for (vtkIdType first = 0; first < numRanges && !abort;
+       first += rangesPerRound)
+    {
+    vtkIdType numRound = numRanges - first;
+    numRound = (numRound < rangesPerRound ? numRound : rangesPerRound);
+    this->UpdateProgress(static_cast<double>(first)/numRanges);
+    abort = this->GetAbortExecute();
+    if (abort)
+      {
+      break;
+      }
 
-  time->Delete();
+    int a;
+    int numArrays = lines->PointData->GetNumberOfArrays();
+    for (r = 0; r < numRound; r++)
+      {
+      vtkGenericStreamTracerLines* range = ranges + r;
+      *range = *lines;
+      range->Begin = (first + r)*numLines/numRanges;
+      range->End = (first + r + 1)*numLines/numRanges;
+      range->ReportProgress = 0;
+      range->Func = lines->Func->NewInstance();
+      range->Func->CopyParameters(lines->Func);
+      range->Func->SelectVectors(this->InputVectorsSelection);
+      range->Func->AddDataSet(inputs[r]);
+      range->Integrator = lines->Integrator->NewInstance();
+      range->Integrator->SetFunctionSet(range->Func);
+      range->Values = new double[numComponents];
+      range->Points = vtkPoints::New();
+      range->Points->SetDataType(lines->Points->GetDataType());
+      range->Lines = vtkCellArray::New();
+      range->PointData = vtkPointData::New();
+      for (a = 0; a < numArrays; a++)
+        {
+        vtkDataArray* array = lines->PointData->GetArray(a);
+        vtkDataArray* rangeArray =
+          vtkDataArray::CreateDataArray(array->GetDataType());
+        rangeArray->SetNumberOfComponents(array->GetNumberOfComponents());
+        range->PointData->AddArray(rangeArray);
+        rangeArray->Delete();
+        }
+      range->Time = vtkDoubleArray::New();
+      range->RetVals = vtkIntArray::New();
+      if (lines->Vorticity)
+        {
+        range->Vorticity = vtkDoubleArray::New();
+        range->Vorticity->SetNumberOfComponents(3);
+        range->Rotation = vtkDoubleArray::New();
+        range->AngularVel = vtkDoubleArray::New();
+        }
+      range->LastPointSet = 0;
+      range->LastUsedTimeStepSet = 0;
+      }
 
+    scheduler->ParallelFor(0, numRound, 1,
+                           vtkGenericStreamTracer::IntegrateLinesTask, &td);
 
-  integrator->Delete();
-  
-  delete[] values;
-  
-  output->Squeeze();
-  return;
+    // Append the streamlines in the order of the seeds.
+    for (r = 0; r < numRound; r++)
+      {
+      vtkGenericStreamTracerLines* range = ranges + r;
+      vtkIdType offset = lines->Points->GetNumberOfPoints();
+      vtkGenericStreamTracerAppendArray(lines->Points->GetData(),
+                                        range->Points->GetData());
+      for (a = 0; a < numArrays; a++)
+        {
+        vtkGenericStreamTracerAppendArray(lines->PointData->GetArray(a),
+                                          range->PointData->GetArray(a));
+        }
+      vtkGenericStreamTracerAppendArray(lines->Time, range->Time);
+      vtkGenericStreamTracerAppendArray(lines->RetVals, range->RetVals);
+      vtkIdType npts;
+      vtkIdType* pts;
+      range->Lines->InitTraversal();
+      while (range->Lines->GetNextCell(npts, pts))
+        {
+        lines->Lines->InsertNextCell(npts);
+        for (vtkIdType i = 0; i < npts; i++)
+          {
+          lines->Lines->InsertCellPoint(pts[i] + offset);
+          }
+        }
+      if (lines->Vorticity)
+        {
+        vtkGenericStreamTracerAppendArray(lines->Vorticity, range->Vorticity);
+        vtkGenericStreamTracerAppendArray(lines->Rotation, range->Rotation);
+        vtkGenericStreamTracerAppendArray(lines->AngularVel,
+                                          range->AngularVel);
+        range->Vorticity->Delete();
+        range->Rotation->Delete();
+        range->AngularVel->Delete();
+        }
+      if (range->LastPointSet)
+        {
+        memcpy(lines->LastPoint, range->LastPoint, 3*sizeof(double));
+        lines->LastPointSet = 1;
+        }
+      if (range->LastUsedTimeStepSet)
+        {
+        lines->LastUsedTimeStep = range->LastUsedTimeStep;
+        lines->LastUsedTimeStepSet = 1;
+        }
+
+      range->Points->Delete();
+      range->Lines->Delete();
+      range->PointData->Delete();
+      range->Time->Delete();
+      range->RetVals->Delete();
+      delete [] range->Values;
+      range->Integrator->Delete();
+      range->Func->Delete();
+      }
+    }
+
+  for (r = 0; r < rangesPerRound; r++)
+    {
+    inputs[r]->Delete();
+    }
+  delete [] inputs;
+  delete [] ranges;
+  return abort ? -1 : 1;
 }
 
 //-----------------------------------------------------------------------------
@@ -1210,6 +1543,13 @@ void vtkGenericStreamTracer::GenerateNormals(vtkPolyData* output,
       vtkDoubleArray* normals = vtkDoubleArray::New();
       normals->SetNumberOfComponents(3);
       normals->SetNumberOfTuples(numPts);
+      // Make sure the normals are initialized in case 
+      // GenerateSlidingNormals() fails and returns before
+      // creating all normals
+      for(vtkIdType idx=0; idx<numPts; idx++)
+        {
+        normals->SetTuple3(idx, 1, 0, 0);
+        }
         
       lineNormalGenerator->GenerateSlidingNormals(outputPoints,
                                                   outputLines,
@@ -1425,6 +1765,8 @@ void vtkGenericStreamTracer::PrintSelf(ostream& os,
   os << indent << "Vorticity computation: " 
      << (this->ComputeVorticity ? " On" : " Off") << endl;
   os << indent << "Rotation scale: " << this->RotationScale << endl;
+  os << indent << "Threaded integration: "
+     << (this->ThreadedIntegration ? " On" : " Off") << endl;
 
   if (this->InputVectorsSelection)
     {
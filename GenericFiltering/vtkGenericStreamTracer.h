@@ -75,6 +75,7 @@ class vtkGenericInterpolatedVelocityField;
 class vtkDataSet;
 class vtkGenericAttribute;
 class vtkGenericDataSet;
+class vtkGenericStreamTracerLines;
 
 class VTK_GENERIC_FILTERING_EXPORT vtkGenericStreamTracer : public vtkPolyDataAlgorithm
 {
@@ -277,6 +278,21 @@ public:
   vtkGetMacro(ComputeVorticity, int);
   vtkBooleanMacro(ComputeVorticity, int);
 
+  // Description:
+  // Turn on/off integrating the seeds on the threads of the
+  // vtkTaskScheduler.  Each thread integrates with its own velocity
+  // field, and the streamlines are output in the order of the seeds, so
+  // the output is the same as when the seeds are integrated one after the
+  // other.  Adaptors cache cells and attribute values, so each thread works
+  // on its own copy of the input, made with NewInstance() and
+  // ShallowCopy().  The adaptor must make a copy that does not share these
+  // caches with the input, which vtkGenericDataSet does not require, so
+  // this is off by default.  With several inputs the seeds are integrated
+  // one after the other anyway.
+  vtkSetMacro(ThreadedIntegration, int);
+  vtkGetMacro(ThreadedIntegration, int);
+  vtkBooleanMacro(ThreadedIntegration, int);
+
   // Description
   // This can be used to scale the rate with which the streamribbons
   // twist. The default is 1.
@@ -327,6 +343,18 @@ protected:
                  vtkIntArray* integrationDirections,
                  double lastPoint[3],
                  vtkGenericInterpolatedVelocityField* func);
+
+  // Integrate the seeds of lines, appending the streamlines to its
+  // outputs.
+  void IntegrateLines(vtkGenericStreamTracerLines *lines);
+
+  // Integrate the seeds in ranges of seeds on the threads of the
+  // vtkTaskScheduler, and append the streamlines to the outputs in the
+  // order of the seeds.  Return 0 without integrating if there are
+  // several inputs, -1 if the filter was aborted and 1 otherwise.
+  int IntegrateInThreads(vtkGenericDataSet *input,
+                         vtkGenericStreamTracerLines *lines);
+  static void IntegrateLinesTask(void *arg, vtkIdType begin, vtkIdType end);
   void SimpleIntegrate(double seed[3], 
                        double lastPoint[3], 
                        double delt,
@@ -390,6 +418,7 @@ protected:
 
   int ComputeVorticity;
   double RotationScale;
+  int ThreadedIntegration;
 
   vtkGenericInterpolatedVelocityField* InterpolatorPrototype;
 
@@ -0,0 +1,313 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestIntervalScalarTree.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of vtkIntervalScalarTree and of its use by the filters.
+// .SECTION Description
+// Builds the tree over a tetrahedral grid with the threads of the task
+// scheduler and checks that it returns exactly the cells whose range
+// contains each value, in increasing order.  Checks that
+// a stored tree can be loaded, and that the tree follows the scalars it
+// is given.  Then checks that vtkContourFilter and vtkCutter give the
+// same output with and without a scalar tree, and that the cutter keeps
+// its tree when only the cut values change.
+
+#include "vtkCellArray.h"
+#include "vtkContourFilter.h"
+#include "vtkCutter.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkDoubleArray.h"
+#include "vtkFieldData.h"
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkImageData.h"
+#include "vtkIntervalScalarTree.h"
+#include "vtkPlane.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkTaskScheduler.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <math.h>
+
+static vtkUnstructuredGrid *MakeGrid()
+{
+  vtkImageData *image = vtkImageData::New();
+  image->SetDimensions(25, 25, 25);
+  image->SetSpacing(0.1, 0.1, 0.1);
+  vtkFloatArray *scalars = vtkFloatArray::New();
+  scalars->SetName("Scalars");
+  vtkFloatArray *other = vtkFloatArray::New();
+  other->SetName("Other");
+  unsigned int seed = 1;
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+    double x[3];
+    image->GetPoint(i, x);
+    seed = seed*1103515245 + 12345;
+    double noise = ((seed >> 16) % 1000)*0.0001;
+    scalars->InsertNextValue(static_cast<float>(
+      sqrt(x[0]*x[0] + x[1]*x[1] + x[2]*x[2]) + noise));
+    other->InsertNextValue(static_cast<float>(sin(3.0*x[0]) + x[2]));
+    }
+  image->GetPointData()->SetScalars(scalars);
+  image->GetPointData()->AddArray(other);
+  scalars->Delete();
+  other->Delete();
+
+  vtkDataSetTriangleFilter *tetra = vtkDataSetTriangleFilter::New();
+  tetra->SetInput(image);
+  tetra->Update();
+  vtkUnstructuredGrid *grid = vtkUnstructuredGrid::New();
+  grid->ShallowCopy(tetra->GetOutput());
+  tetra->Delete();
+  image->Delete();
+  return grid;
+}
+
+// Check the cells returned by the tree against those found by looking
+// at every cell.
+static int CheckValue(vtkDataSet *grid, vtkDataArray *scalars,
+                      vtkIntervalScalarTree *tree, double value)
+{
+  vtkIdList *cellIds = vtkIdList::New();
+  tree->GetCellsAtValue(value, cellIds);
+
+  vtkIdList *expected = vtkIdList::New();
+  vtkIdList *ptIds = vtkIdList::New();
+  for (vtkIdType cellId = 0; cellId < grid->GetNumberOfCells(); ++cellId)
+    {
+    grid->GetCellPoints(cellId, ptIds);
+    double min = VTK_DOUBLE_MAX;
+    double max = -VTK_DOUBLE_MAX;
+    for (vtkIdType i = 0; i < ptIds->GetNumberOfIds(); ++i)
+      {
+      double s = scalars->GetComponent(ptIds->GetId(i), 0);
+      min = s < min ? s : min;
+      max = s > max ? s : max;
+      }
+    if (min <= value && value <= max)
+      {
+      expected->InsertNextId(cellId);
+      }
+    }
+
+  int retVal = 0;
+  if (cellIds->GetNumberOfIds() != expected->GetNumberOfIds())
+    {
+    cerr << "Value " << value << ": " << cellIds->GetNumberOfIds()
+         << " cells instead of " << expected->GetNumberOfIds() << "\n";
+    retVal = 1;
+    }
+  else
+    {
+    for (vtkIdType i = 0; i < expected->GetNumberOfIds(); ++i)
+      {
+      if (cellIds->GetId(i) != expected->GetId(i))
+        {
+        cerr << "Value " << value << ": cells differ at " << i << "\n";
+        retVal = 1;
+        break;
+        }
+      }
+    }
+
+  ptIds->Delete();
+  expected->Delete();
+  cellIds->Delete();
+  return retVal;
+}
+
+static int ComparePolyData(vtkPolyData *a, vtkPolyData *b, const char *name)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfCells() != b->GetNumberOfCells() ||
+      a->GetNumberOfPoints() == 0)
+    {
+    cerr << name << ": " << a->GetNumberOfPoints() << " points and "
+         << a->GetNumberOfCells() << " cells instead of "
+         << b->GetNumberOfPoints() << " and " << b->GetNumberOfCells()
+         << "\n";
+    return 1;
+    }
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+    {
+    double p[3];
+    double q[3];
+    a->GetPoint(i, p);
+    b->GetPoint(i, q);
+    if (p[0] != q[0] || p[1] != q[1] || p[2] != q[2])
+      {
+      cerr << name << ": point " << i << " differs\n";
+      return 1;
+      }
+    }
+  vtkCellArray *pa = a->GetPolys();
+  vtkCellArray *pb = b->GetPolys();
+  if (pa->GetNumberOfConnectivityEntries() !=
+      pb->GetNumberOfConnectivityEntries() ||
+      memcmp(pa->GetPointer(), pb->GetPointer(),
+             pa->GetNumberOfConnectivityEntries()*sizeof(vtkIdType)) != 0)
+    {
+    cerr << name << ": the polygons differ\n";
+    return 1;
+    }
+  return 0;
+}
+
+int TestIntervalScalarTree(int, char *[])
+{
+  int retVal = 0;
+  vtkTaskScheduler::GetGlobalScheduler()->SetNumberOfThreads(4);
+  vtkUnstructuredGrid *grid = MakeGrid();
+  vtkDataArray *scalars = grid->GetPointData()->GetScalars();
+  vtkDataArray *other = grid->GetPointData()->GetArray("Other");
+  double values[6] = { -1.0, 0.0, 0.5, 1.3, 2.0, 5.0 };
+  int i;
+
+  // The active scalars.
+  vtkIntervalScalarTree *tree = vtkIntervalScalarTree::New();
+  tree->SetDataSet(grid);
+  tree->BuildTree();
+  if (tree->GetNumberOfTreeCells() != grid->GetNumberOfCells())
+    {
+    cerr << "The tree has " << tree->GetNumberOfTreeCells()
+         << " cells instead of " << grid->GetNumberOfCells() << "\n";
+    retVal = 1;
+    }
+  for (i = 0; i < 6; ++i)
+    {
+    retVal |= CheckValue(grid, scalars, tree, values[i]);
+    }
+  // A scalar value of a point is contained by the range of its cells.
+  retVal |= CheckValue(grid, scalars, tree, scalars->GetComponent(100, 0));
+
+  // A stored tree is used without building it again.
+  vtkFieldData *fieldData = vtkFieldData::New();
+  tree->StoreTree(fieldData);
+  vtkIntervalScalarTree *loaded = vtkIntervalScalarTree::New();
+  loaded->SetDataSet(grid);
+  if (!loaded->LoadTree(fieldData))
+    {
+    cerr << "The stored tree could not be loaded\n";
+    retVal = 1;
+    }
+  vtkFieldData *again = vtkFieldData::New();
+  loaded->StoreTree(again);
+  if (fieldData->GetArray("vtkIntervalScalarTreeNodes") == 0 ||
+      again->GetArray("vtkIntervalScalarTreeNodes") !=
+      fieldData->GetArray("vtkIntervalScalarTreeNodes"))
+    {
+    cerr << "The loaded tree was built again\n";
+    retVal = 1;
+    }
+  again->Delete();
+  retVal |= CheckValue(grid, scalars, loaded, 1.3);
+  vtkFieldData *empty = vtkFieldData::New();
+  if (loaded->LoadTree(empty))
+    {
+    cerr << "A tree was loaded from empty field data\n";
+    retVal = 1;
+    }
+  empty->Delete();
+  fieldData->Delete();
+  loaded->Delete();
+
+  // Other scalars, and modified scalars, build the tree again.
+  tree->SetScalars(other);
+  tree->BuildTree();
+  for (i = 0; i < 6; ++i)
+    {
+    retVal |= CheckValue(grid, other, tree, values[i]);
+    }
+  for (vtkIdType ptId = 0; ptId < other->GetNumberOfTuples(); ++ptId)
+    {
+    other->SetComponent(ptId, 0, -other->GetComponent(ptId, 0));
+    }
+  other->Modified();
+  tree->BuildTree();
+  retVal |= CheckValue(grid, other, tree, -0.5);
+  tree->Delete();
+
+  // The contour filter gives the same output with a scalar tree.
+  vtkContourFilter *contour = vtkContourFilter::New();
+  contour->SetInput(grid);
+  contour->SetValue(0, 0.7);
+  contour->SetValue(1, 1.6);
+  contour->Update();
+  vtkPolyData *expected = vtkPolyData::New();
+  expected->DeepCopy(contour->GetOutput());
+  contour->UseScalarTreeOn();
+  contour->Update();
+  retVal |= ComparePolyData(contour->GetOutput(), expected, "Contour");
+  contour->Delete();
+
+  // So does the cutter, in both orders.
+  vtkPlane *plane = vtkPlane::New();
+  plane->SetOrigin(1.2, 1.2, 1.2);
+  plane->SetNormal(1.0, 0.5, 0.25);
+  vtkCutter *cutter = vtkCutter::New();
+  cutter->SetInput(grid);
+  cutter->SetCutFunction(plane);
+  for (int sortBy = VTK_SORT_BY_VALUE; sortBy <= VTK_SORT_BY_CELL; ++sortBy)
+    {
+    cutter->SetSortBy(sortBy);
+    cutter->UseScalarTreeOff();
+    cutter->GenerateValues(3, -0.5, 0.5);
+    cutter->Update();
+    expected->DeepCopy(cutter->GetOutput());
+    cutter->UseScalarTreeOn();
+    cutter->Update();
+    retVal |= ComparePolyData(cutter->GetOutput(), expected,
+                              cutter->GetSortByAsString());
+    }
+
+  // Changing the values only keeps the tree.
+  vtkIntervalScalarTree *cutterTree =
+    vtkIntervalScalarTree::SafeDownCast(cutter->GetScalarTree());
+  fieldData = vtkFieldData::New();
+  cutterTree->StoreTree(fieldData);
+  vtkDataArray *nodes = fieldData->GetArray("vtkIntervalScalarTreeNodes");
+  nodes->Register(0);
+  cutter->SetValue(0, 0.1);
+  cutter->Update();
+  cutterTree->StoreTree(fieldData);
+  if (fieldData->GetArray("vtkIntervalScalarTreeNodes") != nodes)
+    {
+    cerr << "The cutter built its tree again\n";
+    retVal = 1;
+    }
+  // Moving the plane builds it again.
+  plane->SetOrigin(1.0, 1.0, 1.0);
+  cutter->Update();
+  cutterTree->StoreTree(fieldData);
+  if (fieldData->GetArray("vtkIntervalScalarTreeNodes") == nodes)
+    {
+    cerr << "The cutter did not follow the cut function\n";
+    retVal = 1;
+    }
+  nodes->UnRegister(0);
+  fieldData->Delete();
+  cutter->UseScalarTreeOff();
+  cutter->Update();
+  expected->DeepCopy(cutter->GetOutput());
+  cutter->UseScalarTreeOn();
+  cutter->Update();
+  retVal |= ComparePolyData(cutter->GetOutput(), expected, "Moved plane");
+
+  cutter->Delete();
+  plane->Delete();
+  expected->Delete();
+  grid->Delete();
+  return retVal;
+}
@@ -0,0 +1,272 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestKdTreeBatchQueries.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the parallel build and batch queries of vtkKdTree.
+// .SECTION Description
+// Builds k-d trees from points and from cells with one and with four
+// threads and checks that they are the same.  Checks the duplicate point
+// map of points that are each given twice, and compares FindPoints(),
+// FindClosestPoints() and FindPointsWithinRadius() with a search of all
+// the points.
+
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkKdTree.h"
+#include "vtkMath.h"
+#include "vtkPoints.h"
+#include "vtkTaskScheduler.h"
+
+#define NUMBER_OF_POINTS 30000
+#define NUMBER_OF_QUERIES 300
+
+// Compare the regions and the points in them of two trees.
+static int CompareTrees(vtkKdTree *a, vtkKdTree *b, int withPoints)
+{
+  if (a->GetNumberOfRegions() != b->GetNumberOfRegions())
+    {
+    cerr << a->GetNumberOfRegions() << " regions instead of "
+         << b->GetNumberOfRegions() << "\n";
+    return 1;
+    }
+  for (int r = 0; r < a->GetNumberOfRegions(); ++r)
+    {
+    double ba[6];
+    double bb[6];
+    a->GetRegionBounds(r, ba);
+    b->GetRegionBounds(r, bb);
+    for (int i = 0; i < 6; ++i)
+      {
+      if (ba[i] != bb[i])
+        {
+        cerr << "The bounds of region " << r << " differ\n";
+        return 1;
+        }
+      }
+    if (withPoints)
+      {
+      vtkIdTypeArray *pa = a->GetPointsInRegion(r);
+      vtkIdTypeArray *pb = b->GetPointsInRegion(r);
+      int same = pa->GetNumberOfTuples() == pb->GetNumberOfTuples();
+      for (vtkIdType i = 0; same && i < pa->GetNumberOfTuples(); ++i)
+        {
+        same = pa->GetValue(i) == pb->GetValue(i);
+        }
+      pa->Delete();
+      pb->Delete();
+      if (!same)
+        {
+        cerr << "The points of region " << r << " differ\n";
+        return 1;
+        }
+      }
+    }
+  return 0;
+}
+
+static double Distance2(vtkPoints *points, vtkIdType id, double x[3])
+{
+  double p[3];
+  points->GetPoint(id, p);
+  return (p[0] - x[0])*(p[0] - x[0]) + (p[1] - x[1])*(p[1] - x[1]) +
+    (p[2] - x[2])*(p[2] - x[2]);
+}
+
+int TestKdTreeBatchQueries(int, char *[])
+{
+  int retVal = 0;
+  vtkTaskScheduler *scheduler = vtkTaskScheduler::GetGlobalScheduler();
+  vtkMath::RandomSeed(8775070);
+  vtkIdType i;
+  vtkIdType j;
+
+  // Each point is given twice, the copy being at i + NUMBER_OF_POINTS.
+  vtkPoints *points = vtkPoints::New();
+  points->SetNumberOfPoints(2*NUMBER_OF_POINTS);
+  for (i = 0; i < NUMBER_OF_POINTS; ++i)
+    {
+    double x[3];
+    x[0] = vtkMath::Random();
+    x[1] = vtkMath::Random(0.0, 0.5);
+    x[2] = vtkMath::Random(0.0, 0.25);
+    points->SetPoint(i, x);
+    points->SetPoint(i + NUMBER_OF_POINTS, x);
+    }
+
+  scheduler->SetNumberOfThreads(1);
+  vtkKdTree *serial = vtkKdTree::New();
+  serial->BuildLocatorFromPoints(points);
+  scheduler->SetNumberOfThreads(4);
+  vtkKdTree *tree = vtkKdTree::New();
+  tree->BuildLocatorFromPoints(points);
+  retVal |= CompareTrees(tree, serial, 1);
+  serial->Delete();
+
+  // Exact duplicates are mapped to the same unique point.
+  vtkIdTypeArray *map = tree->BuildMapForDuplicatePoints(0.0);
+  for (i = 0; map && i < NUMBER_OF_POINTS; ++i)
+    {
+    vtkIdType id = map->GetValue(i);
+    if ((id != i && id != i + NUMBER_OF_POINTS) ||
+        map->GetValue(i + NUMBER_OF_POINTS) != id)
+      {
+      cerr << "Point " << i << " is mapped to " << id << " and "
+           << map->GetValue(i + NUMBER_OF_POINTS) << "\n";
+      retVal = 1;
+      break;
+      }
+    }
+  if (map)
+    {
+    map->Delete();
+    }
+  else
+    {
+    retVal = 1;
+    }
+
+  // With a tolerance, points are mapped to unique points within it.
+  map = tree->BuildMapForDuplicatePoints(0.01f);
+  vtkIdType numUnique = 0;
+  for (i = 0; map && i < 2*NUMBER_OF_POINTS; ++i)
+    {
+    vtkIdType id = map->GetValue(i);
+    double x[3];
+    points->GetPoint(i, x);
+    if (map->GetValue(id) != id || Distance2(points, id, x) > 0.0001)
+      {
+      cerr << "Point " << i << " is mapped to " << id << "\n";
+      retVal = 1;
+      break;
+      }
+    numUnique += (id == i);
+    }
+  cout << numUnique << " unique points within 0.01\n";
+  if (map)
+    {
+    map->Delete();
+    }
+  else
+    {
+    retVal = 1;
+    }
+
+  // Batch queries, some of them outside of the points.
+  vtkPoints *queries = vtkPoints::New();
+  queries->SetNumberOfPoints(NUMBER_OF_QUERIES);
+  for (i = 0; i < NUMBER_OF_QUERIES; ++i)
+    {
+    double x[3];
+    if (i % 3 == 0)
+      {
+      points->GetPoint(i*7, x);
+      }
+    else
+      {
+      x[0] = vtkMath::Random(-0.2, 1.2);
+      x[1] = vtkMath::Random(-0.1, 0.6);
+      x[2] = vtkMath::Random(-0.1, 0.4);
+      }
+    queries->SetPoint(i, x);
+    }
+  vtkIdTypeArray *ids = vtkIdTypeArray::New();
+  vtkDoubleArray *dist2 = vtkDoubleArray::New();
+  tree->FindClosestPoints(queries, ids, dist2);
+  vtkIdTypeArray *found = vtkIdTypeArray::New();
+  tree->FindPoints(queries, found);
+  vtkIdList *within = vtkIdList::New();
+  for (i = 0; i < NUMBER_OF_QUERIES; ++i)
+    {
+    double x[3];
+    queries->GetPoint(i, x);
+    double minDist2 = VTK_DOUBLE_MAX;
+    vtkIdType numWithin = 0;
+    for (j = 0; j < 2*NUMBER_OF_POINTS; ++j)
+      {
+      double d2 = Distance2(points, j, x);
+      minDist2 = d2 < minDist2 ? d2 : minDist2;
+      numWithin += (d2 <= 0.0025);
+      }
+    if (ids->GetNumberOfTuples() != NUMBER_OF_QUERIES ||
+        dist2->GetValue(i) != minDist2 ||
+        Distance2(points, ids->GetValue(i), x) != minDist2)
+      {
+      cerr << "Query " << i << ": closest point " << ids->GetValue(i)
+           << " at " << dist2->GetValue(i) << " instead of " << minDist2
+           << "\n";
+      retVal = 1;
+      break;
+      }
+    vtkIdType id = found->GetValue(i);
+    if ((i % 3 == 0) != (id >= 0) ||
+        (id >= 0 && Distance2(points, id, x) != 0.0))
+      {
+      cerr << "Query " << i << ": found point " << id << "\n";
+      retVal = 1;
+      break;
+      }
+    tree->FindPointsWithinRadius(0.05, x, within);
+    int correct = within->GetNumberOfIds() == numWithin;
+    for (j = 0; correct && j < within->GetNumberOfIds(); ++j)
+      {
+      correct = Distance2(points, within->GetId(j), x) <= 0.0025;
+      }
+    if (!correct)
+      {
+      cerr << "Query " << i << ": " << within->GetNumberOfIds()
+           << " points within the radius instead of " << numWithin << "\n";
+      retVal = 1;
+      break;
+      }
+    }
+  within->Delete();
+  found->Delete();
+  dist2->Delete();
+  ids->Delete();
+  queries->Delete();
+  tree->Delete();
+  points->Delete();
+
+  // The cell centers are computed in parallel.
+  vtkImageData *image = vtkImageData::New();
+  image->SetDimensions(40, 30, 35);
+  image->SetSpacing(0.1, 0.2, 0.15);
+  scheduler->SetNumberOfThreads(1);
+  serial = vtkKdTree::New();
+  serial->SetDataSet(image);
+  serial->BuildLocator();
+  scheduler->SetNumberOfThreads(4);
+  tree = vtkKdTree::New();
+  tree->SetDataSet(image);
+  tree->BuildLocator();
+  retVal |= CompareTrees(tree, serial, 0);
+  int *regions = tree->AllGetRegionContainingCell();
+  int *serialRegions = serial->AllGetRegionContainingCell();
+  for (i = 0; i < image->GetNumberOfCells(); ++i)
+    {
+    if (regions[i] != serialRegions[i])
+      {
+      cerr << "Cell " << i << " is in region " << regions[i]
+           << " instead of " << serialRegions[i] << "\n";
+      retVal = 1;
+      break;
+      }
+    }
+  tree->Delete();
+  serial->Delete();
+  image->Delete();
+
+  return retVal;
+}
@@ -0,0 +1,184 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestProbeFilterThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of vtkProbeFilter on the threads of the task scheduler.
+// .SECTION Description
+// Probes a tetrahedral grid with scattered points, some of them outside
+// of the grid, with a volume and with a plane, and probes an image with
+// the scattered points.  Each probe is done with one and with four
+// threads, and the outputs and the valid points must be the same.
+
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkProbeFilter.h"
+#include "vtkTaskScheduler.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <math.h>
+
+static vtkImageData *MakeImage()
+{
+  vtkImageData *image = vtkImageData::New();
+  image->SetDimensions(20, 22, 24);
+  image->SetSpacing(0.1, 0.1, 0.1);
+  vtkFloatArray *scalars = vtkFloatArray::New();
+  scalars->SetName("Scalars");
+  vtkDoubleArray *vectors = vtkDoubleArray::New();
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+    double x[3];
+    image->GetPoint(i, x);
+    scalars->InsertNextValue(static_cast<float>(sin(4.0*x[0]) + x[1]*x[2]));
+    vectors->InsertNextTuple3(x[1], cos(x[2]), x[0]*x[0]);
+    }
+  image->GetPointData()->SetScalars(scalars);
+  image->GetPointData()->SetVectors(vectors);
+  scalars->Delete();
+  vectors->Delete();
+  return image;
+}
+
+// Probe source at the points of input with the given number of threads.
+static vtkDataSet *Probe(vtkDataSet *input, vtkDataSet *source,
+                         int numThreads, vtkIdTypeArray *validPoints)
+{
+  vtkTaskScheduler::GetGlobalScheduler()->SetNumberOfThreads(numThreads);
+  vtkProbeFilter *probe = vtkProbeFilter::New();
+  probe->SetInput(input);
+  probe->SetSource(source);
+  probe->Update();
+  vtkDataSet *output = probe->GetOutput()->NewInstance();
+  output->ShallowCopy(probe->GetOutput());
+  validPoints->DeepCopy(probe->GetValidPoints());
+  probe->Delete();
+  return output;
+}
+
+static int CompareProbes(vtkDataSet *input, vtkDataSet *source,
+                         const char *name)
+{
+  vtkIdTypeArray *serialValid = vtkIdTypeArray::New();
+  vtkDataSet *serial = Probe(input, source, 1, serialValid);
+  vtkIdTypeArray *valid = vtkIdTypeArray::New();
+  vtkDataSet *output = Probe(input, source, 4, valid);
+
+  int retVal = 0;
+  vtkIdType i;
+  if (valid->GetNumberOfTuples() != serialValid->GetNumberOfTuples() ||
+      valid->GetNumberOfTuples() == 0 ||
+      valid->GetNumberOfTuples() == input->GetNumberOfPoints())
+    {
+    cerr << name << ": " << valid->GetNumberOfTuples()
+         << " valid points instead of " << serialValid->GetNumberOfTuples()
+         << "\n";
+    retVal = 1;
+    }
+  for (i = 0; !retVal && i < valid->GetNumberOfTuples(); ++i)
+    {
+    if (valid->GetValue(i) != serialValid->GetValue(i))
+      {
+      cerr << name << ": valid point " << i << " differs\n";
+      retVal = 1;
+      }
+    }
+
+  vtkPointData *pd = output->GetPointData();
+  vtkPointData *serialPD = serial->GetPointData();
+  if (pd->GetNumberOfArrays() != serialPD->GetNumberOfArrays() ||
+      pd->GetNumberOfArrays() != 2)
+    {
+    cerr << name << ": " << pd->GetNumberOfArrays()
+         << " arrays instead of " << serialPD->GetNumberOfArrays() << "\n";
+    retVal = 1;
+    }
+  for (int a = 0; !retVal && a < pd->GetNumberOfArrays(); ++a)
+    {
+    vtkDataArray *array = pd->GetArray(a);
+    vtkDataArray *serialArray = serialPD->GetArray(a);
+    if (array->GetNumberOfTuples() != input->GetNumberOfPoints() ||
+        serialArray->GetNumberOfTuples() != input->GetNumberOfPoints() ||
+        array->GetDataType() != serialArray->GetDataType() ||
+        memcmp(array->GetVoidPointer(0), serialArray->GetVoidPointer(0),
+               array->GetNumberOfTuples()*array->GetNumberOfComponents()*
+               array->GetDataTypeSize()) != 0)
+      {
+      cerr << name << ": array " << array->GetName() << " differs\n";
+      retVal = 1;
+      }
+    }
+
+  output->Delete();
+  valid->Delete();
+  serial->Delete();
+  serialValid->Delete();
+  return retVal;
+}
+
+int TestProbeFilterThreads(int, char *[])
+{
+  int retVal = 0;
+  vtkImageData *image = MakeImage();
+  vtkDataSetTriangleFilter *tetra = vtkDataSetTriangleFilter::New();
+  tetra->SetInput(image);
+  tetra->Update();
+  vtkUnstructuredGrid *grid = vtkUnstructuredGrid::New();
+  grid->ShallowCopy(tetra->GetOutput());
+  tetra->Delete();
+
+  // Scattered points, some of them outside of the data.
+  unsigned int seed = 1;
+  vtkPoints *points = vtkPoints::New();
+  for (int i = 0; i < 20000; ++i)
+    {
+    double x[3];
+    for (int j = 0; j < 3; ++j)
+      {
+      seed = seed*1103515245 + 12345;
+      x[j] = 2.6*((seed >> 8) % 100000)*0.00001 - 0.2;
+      }
+    points->InsertNextPoint(x);
+    }
+  vtkPolyData *scattered = vtkPolyData::New();
+  scattered->SetPoints(points);
+  points->Delete();
+  retVal |= CompareProbes(scattered, grid, "Grid");
+  retVal |= CompareProbes(scattered, image, "Image");
+  scattered->Delete();
+
+  // A volume and a plane that extend beyond the data.
+  vtkImageData *volume = vtkImageData::New();
+  volume->SetDimensions(30, 25, 20);
+  volume->SetOrigin(-0.1, 0.05, 0.0);
+  volume->SetSpacing(0.075, 0.1, 0.13);
+  retVal |= CompareProbes(volume, grid, "Volume in grid");
+  volume->Delete();
+  vtkImageData *plane = vtkImageData::New();
+  plane->SetDimensions(150, 1, 120);
+  plane->SetOrigin(-0.2, 1.03, -0.1);
+  plane->SetSpacing(0.02, 1.0, 0.025);
+  retVal |= CompareProbes(plane, grid, "Plane in grid");
+  plane->Delete();
+
+  grid->Delete();
+  image->Delete();
+  return retVal;
+}
@@ -0,0 +1,181 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestStreamTracerThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of vtkStreamTracer on the threads of the task scheduler.
+// .SECTION Description
+// Traces streamlines in both directions from scattered seeds, some of
+// them outside of the data, through a tetrahedral grid and through an
+// image, with second order and adaptive Runge-Kutta.  Each trace is done
+// with one and with four threads, and the outputs must be the same.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkMath.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkStreamTracer.h"
+#include "vtkTaskScheduler.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <math.h>
+
+static vtkImageData *MakeImage()
+{
+  vtkImageData *image = vtkImageData::New();
+  image->SetDimensions(16, 18, 20);
+  image->SetSpacing(0.1, 0.1, 0.1);
+  vtkFloatArray *scalars = vtkFloatArray::New();
+  scalars->SetName("Scalars");
+  vtkDoubleArray *vectors = vtkDoubleArray::New();
+  vectors->SetName("Velocity");
+  vectors->SetNumberOfComponents(3);
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+    double x[3];
+    image->GetPoint(i, x);
+    scalars->InsertNextValue(static_cast<float>(x[0]*x[1] + x[2]));
+    // A swirl around the center, drifting along z.
+    vectors->InsertNextTuple3(0.9 - x[1] + 0.1*sin(3.0*x[2]), x[0] - 0.8,
+                              0.2 + 0.1*cos(2.0*x[0]));
+    }
+  image->GetPointData()->SetScalars(scalars);
+  image->GetPointData()->SetVectors(vectors);
+  scalars->Delete();
+  vectors->Delete();
+  return image;
+}
+
+static int CompareArrays(vtkDataArray *a, vtkDataArray *b)
+{
+  return a && b && a->GetDataType() == b->GetDataType() &&
+    a->GetNumberOfTuples() == b->GetNumberOfTuples() &&
+    a->GetNumberOfComponents() == b->GetNumberOfComponents() &&
+    memcmp(a->GetVoidPointer(0), b->GetVoidPointer(0),
+           a->GetNumberOfTuples()*a->GetNumberOfComponents()*
+           a->GetDataTypeSize()) == 0;
+}
+
+// Trace the streamlines of input from seeds with the given number of
+// threads.
+static vtkPolyData *Trace(vtkDataSet *input, vtkDataSet *seeds,
+                          int integrator, int numThreads)
+{
+  vtkTaskScheduler::GetGlobalScheduler()->SetNumberOfThreads(numThreads);
+  vtkStreamTracer *tracer = vtkStreamTracer::New();
+  tracer->SetInput(input);
+  tracer->SetSource(seeds);
+  tracer->SetIntegratorType(integrator);
+  tracer->SetIntegrationDirectionToBoth();
+  tracer->SetMaximumPropagation(3.0);
+  tracer->SetInitialIntegrationStep(0.3);
+  tracer->Update();
+  vtkPolyData *output = vtkPolyData::New();
+  output->ShallowCopy(tracer->GetOutput());
+  tracer->Delete();
+  return output;
+}
+
+static int CompareTraces(vtkDataSet *input, vtkDataSet *seeds,
+                         int integrator, const char *name)
+{
+  vtkPolyData *serial = Trace(input, seeds, integrator, 1);
+  vtkPolyData *output = Trace(input, seeds, integrator, 4);
+
+  int retVal = 0;
+  vtkIdType numLines = output->GetNumberOfLines();
+  cout << name << ": " << numLines << " streamlines of "
+       << output->GetNumberOfPoints() << " points\n";
+  if (numLines != serial->GetNumberOfLines() || numLines < 100 ||
+      !CompareArrays(output->GetPoints()->GetData(),
+                     serial->GetPoints()->GetData()) ||
+      !CompareArrays(output->GetLines()->GetData(),
+                     serial->GetLines()->GetData()))
+    {
+    cerr << name << ": the streamlines differ\n";
+    retVal = 1;
+    }
+
+  vtkPointData *pd = output->GetPointData();
+  vtkPointData *serialPD = serial->GetPointData();
+  if (pd->GetNumberOfArrays() != serialPD->GetNumberOfArrays() ||
+      pd->GetNumberOfArrays() < 7)
+    {
+    cerr << name << ": " << pd->GetNumberOfArrays()
+         << " point arrays instead of " << serialPD->GetNumberOfArrays()
+         << "\n";
+    retVal = 1;
+    }
+  for (int a = 0; !retVal && a < pd->GetNumberOfArrays(); ++a)
+    {
+    if (!CompareArrays(pd->GetArray(a), serialPD->GetArray(a)))
+      {
+      cerr << name << ": array " << pd->GetArray(a)->GetName()
+           << " differs\n";
+      retVal = 1;
+      }
+    }
+  if (!retVal &&
+      !CompareArrays(output->GetCellData()->GetArray("ReasonForTermination"),
+                     serial->GetCellData()->GetArray("ReasonForTermination")))
+    {
+    cerr << name << ": the reasons for termination differ\n";
+    retVal = 1;
+    }
+
+  output->Delete();
+  serial->Delete();
+  return retVal;
+}
+
+int TestStreamTracerThreads(int, char *[])
+{
+  int retVal = 0;
+  vtkImageData *image = MakeImage();
+  vtkDataSetTriangleFilter *tetra = vtkDataSetTriangleFilter::New();
+  tetra->SetInput(image);
+  tetra->Update();
+  vtkUnstructuredGrid *grid = vtkUnstructuredGrid::New();
+  grid->ShallowCopy(tetra->GetOutput());
+  tetra->Delete();
+
+  // Scattered seeds, some of them outside of the data.
+  vtkMath::RandomSeed(8775070);
+  vtkPoints *points = vtkPoints::New();
+  for (int i = 0; i < 300; ++i)
+    {
+    points->InsertNextPoint(vtkMath::Random(-0.1, 2.1),
+                            vtkMath::Random(-0.1, 2.1),
+                            vtkMath::Random(-0.1, 2.1));
+    }
+  vtkPolyData *seeds = vtkPolyData::New();
+  seeds->SetPoints(points);
+  points->Delete();
+
+  retVal |= CompareTraces(grid, seeds, vtkStreamTracer::RUNGE_KUTTA2,
+                          "Grid, RK2");
+  retVal |= CompareTraces(grid, seeds, vtkStreamTracer::RUNGE_KUTTA45,
+                          "Grid, RK45");
+  retVal |= CompareTraces(image, seeds, vtkStreamTracer::RUNGE_KUTTA4,
+                          "Image, RK4");
+
+  seeds->Delete();
+  grid->Delete();
+  image->Delete();
+  return retVal;
+}
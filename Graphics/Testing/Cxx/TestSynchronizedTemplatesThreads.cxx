@@ -0,0 +1,256 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSynchronizedTemplatesThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the threaded synchronized templates filters.
+// .SECTION Description
+// Contours an image and a structured grid on one and on several threads
+// and checks that the outputs have the same points, triangles and
+// attributes.  The scalars are integers so that many contour points fall
+// on grid vertices, where the slabs are stitched.  The saddle field puts
+// the apex of a cone on a slab boundary.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkContourFilter.h"
+#include "vtkFloatArray.h"
+#include "vtkGridSynchronizedTemplates3D.h"
+#include "vtkImageData.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkShortArray.h"
+#include "vtkStructuredGrid.h"
+#include "vtkSynchronizedTemplates3D.h"
+
+#define VTK_TEST_DIM_X 23
+#define VTK_TEST_DIM_Y 19
+#define VTK_TEST_DIM_Z 31
+
+static void FillContourTestData(vtkDataSet *data, int saddle)
+{
+  vtkShortArray *scalars = vtkShortArray::New();
+  scalars->SetName("Distance");
+  vtkFloatArray *extra = vtkFloatArray::New();
+  extra->SetName("Extra");
+  for (int k = 0; k < VTK_TEST_DIM_Z; ++k)
+    {
+    for (int j = 0; j < VTK_TEST_DIM_Y; ++j)
+      {
+      for (int i = 0; i < VTK_TEST_DIM_X; ++i)
+        {
+        int x = i - 11, y = j - 9, z = k - 15;
+        scalars->InsertNextValue(
+          static_cast<short>(saddle ? x*x + y*y - z*z : x*x + y*y + z*z));
+        extra->InsertNextValue(static_cast<float>(i + 0.5*j - 0.25*k));
+        }
+      }
+    }
+  data->GetPointData()->SetScalars(scalars);
+  data->GetPointData()->AddArray(extra);
+  scalars->Delete();
+  extra->Delete();
+
+  vtkFloatArray *cellIds = vtkFloatArray::New();
+  cellIds->SetName("CellIds");
+  vtkIdType numCells = (VTK_TEST_DIM_X-1)*(VTK_TEST_DIM_Y-1)*(VTK_TEST_DIM_Z-1);
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+    {
+    cellIds->InsertNextValue(static_cast<float>(cellId));
+    }
+  data->GetCellData()->AddArray(cellIds);
+  cellIds->Delete();
+}
+
+// The threaded output has its points in a different order, but the same
+// triangles in the same order.  Compare the triangles through the
+// coordinates and attributes of their points.
+static int CompareContours(vtkPolyData *serial, vtkPolyData *threaded,
+                           const char *name)
+{
+  if (serial->GetNumberOfPoints() != threaded->GetNumberOfPoints() ||
+      serial->GetNumberOfPolys() != threaded->GetNumberOfPolys())
+    {
+    cerr << name << ": " << threaded->GetNumberOfPoints() << " points and "
+         << threaded->GetNumberOfPolys() << " triangles, expected "
+         << serial->GetNumberOfPoints() << " and "
+         << serial->GetNumberOfPolys() << "\n";
+    return 1;
+    }
+  if (serial->GetNumberOfPolys() == 0)
+    {
+    cerr << name << ": no triangles\n";
+    return 1;
+    }
+  vtkPointData *serialPD = serial->GetPointData();
+  vtkPointData *threadedPD = threaded->GetPointData();
+  if (serialPD->GetNumberOfArrays() != threadedPD->GetNumberOfArrays())
+    {
+    cerr << name << ": " << threadedPD->GetNumberOfArrays()
+         << " point arrays, expected " << serialPD->GetNumberOfArrays()
+         << "\n";
+    return 1;
+    }
+
+  vtkCellArray *serialPolys = serial->GetPolys();
+  vtkCellArray *threadedPolys = threaded->GetPolys();
+  vtkIdType npts1, *pts1, npts2, *pts2;
+  vtkIdType cellId = 0;
+  serialPolys->InitTraversal();
+  threadedPolys->InitTraversal();
+  while (serialPolys->GetNextCell(npts1, pts1) &&
+         threadedPolys->GetNextCell(npts2, pts2))
+    {
+    for (int idx = 0; idx < 3; ++idx)
+      {
+      double x1[3], x2[3];
+      serial->GetPoint(pts1[idx], x1);
+      threaded->GetPoint(pts2[idx], x2);
+      if (x1[0] != x2[0] || x1[1] != x2[1] || x1[2] != x2[2])
+        {
+        cerr << name << ": triangle " << cellId << " differs\n";
+        return 1;
+        }
+      for (int a = 0; a < serialPD->GetNumberOfArrays(); ++a)
+        {
+        vtkDataArray *array1 = serialPD->GetArray(a);
+        vtkDataArray *array2 = threadedPD->GetArray(a);
+        for (int c = 0; c < array1->GetNumberOfComponents(); ++c)
+          {
+          if (array1->GetComponent(pts1[idx], c) !=
+              array2->GetComponent(pts2[idx], c))
+            {
+            cerr << name << ": array " << array1->GetName()
+                 << " differs on triangle " << cellId << "\n";
+            return 1;
+            }
+          }
+        }
+      }
+    vtkDataArray *cellIds1 = serial->GetCellData()->GetArray("CellIds");
+    vtkDataArray *cellIds2 = threaded->GetCellData()->GetArray("CellIds");
+    if (!cellIds2 ||
+        cellIds1->GetComponent(cellId, 0) != cellIds2->GetComponent(cellId, 0))
+      {
+      cerr << name << ": cell data differs on triangle " << cellId << "\n";
+      return 1;
+      }
+    ++cellId;
+    }
+  return 0;
+}
+
+int TestSynchronizedTemplatesThreads(int, char *[])
+{
+  int retVal = 0;
+  double values[3] = { 49.0, 100.0, 130.5 };
+  int idx;
+
+  vtkImageData *image = vtkImageData::New();
+  image->SetDimensions(VTK_TEST_DIM_X, VTK_TEST_DIM_Y, VTK_TEST_DIM_Z);
+  image->SetSpacing(0.5, 1.0, 1.5);
+  FillContourTestData(image, 0);
+
+  vtkStructuredGrid *grid = vtkStructuredGrid::New();
+  grid->SetDimensions(VTK_TEST_DIM_X, VTK_TEST_DIM_Y, VTK_TEST_DIM_Z);
+  vtkPoints *points = vtkPoints::New();
+  for (vtkIdType ptId = 0; ptId < image->GetNumberOfPoints(); ++ptId)
+    {
+    double x[3];
+    image->GetPoint(ptId, x);
+    x[0] += 0.1*x[2];
+    points->InsertNextPoint(x);
+    }
+  grid->SetPoints(points);
+  points->Delete();
+  FillContourTestData(grid, 0);
+
+  vtkSynchronizedTemplates3D *serialImage = vtkSynchronizedTemplates3D::New();
+  vtkSynchronizedTemplates3D *threadedImage =
+    vtkSynchronizedTemplates3D::New();
+  vtkGridSynchronizedTemplates3D *serialGrid =
+    vtkGridSynchronizedTemplates3D::New();
+  vtkGridSynchronizedTemplates3D *threadedGrid =
+    vtkGridSynchronizedTemplates3D::New();
+  serialImage->SetInput(image);
+  threadedImage->SetInput(image);
+  serialGrid->SetInput(grid);
+  threadedGrid->SetInput(grid);
+  serialImage->SetNumberOfThreads(1);
+  threadedImage->SetNumberOfThreads(4);
+  serialGrid->SetNumberOfThreads(1);
+  threadedGrid->SetNumberOfThreads(4);
+  for (idx = 0; idx < 3; ++idx)
+    {
+    serialImage->SetValue(idx, values[idx]);
+    threadedImage->SetValue(idx, values[idx]);
+    serialGrid->SetValue(idx, values[idx]);
+    threadedGrid->SetValue(idx, values[idx]);
+    }
+  serialImage->Update();
+  threadedImage->Update();
+  serialGrid->Update();
+  threadedGrid->Update();
+  retVal |= CompareContours(serialImage->GetOutput(),
+                            threadedImage->GetOutput(), "Image");
+  retVal |= CompareContours(serialGrid->GetOutput(),
+                            threadedGrid->GetOutput(), "Grid");
+
+  // A single value is split into more slabs.
+  serialImage->SetNumberOfContours(1);
+  threadedImage->SetNumberOfContours(1);
+  serialImage->Update();
+  threadedImage->Update();
+  retVal |= CompareContours(serialImage->GetOutput(),
+                            threadedImage->GetOutput(), "Image, one value");
+
+  // Eight slabs, one of them starting at the apex of the cone.
+  vtkImageData *saddle = vtkImageData::New();
+  saddle->SetDimensions(VTK_TEST_DIM_X, VTK_TEST_DIM_Y, VTK_TEST_DIM_Z);
+  FillContourTestData(saddle, 1);
+  vtkSynchronizedTemplates3D *serialSaddle =
+    vtkSynchronizedTemplates3D::New();
+  vtkSynchronizedTemplates3D *threadedSaddle =
+    vtkSynchronizedTemplates3D::New();
+  serialSaddle->SetInput(saddle);
+  threadedSaddle->SetInput(saddle);
+  serialSaddle->SetNumberOfThreads(1);
+  threadedSaddle->SetNumberOfThreads(4);
+  serialSaddle->SetValue(0, 0.0);
+  threadedSaddle->SetValue(0, 0.0);
+  serialSaddle->Update();
+  threadedSaddle->Update();
+  retVal |= CompareContours(serialSaddle->GetOutput(),
+                            threadedSaddle->GetOutput(), "Saddle");
+  serialSaddle->Delete();
+  threadedSaddle->Delete();
+  saddle->Delete();
+
+  // vtkContourFilter passes its number of threads on.
+  vtkContourFilter *contour = vtkContourFilter::New();
+  contour->SetInput(image);
+  contour->SetNumberOfThreads(3);
+  contour->SetValue(0, values[0]);
+  contour->Update();
+  retVal |= CompareContours(serialImage->GetOutput(), contour->GetOutput(),
+                            "Contour filter");
+
+  contour->Delete();
+  serialImage->Delete();
+  threadedImage->Delete();
+  serialGrid->Delete();
+  threadedGrid->Delete();
+  image->Delete();
+  grid->Delete();
+  return retVal;
+}
@@ -26,13 +26,14 @@
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkIntervalScalarTree.h"
 #include "vtkMergePoints.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearSynchronizedTemplates.h"
-#include "vtkSimpleScalarTree.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
 #include "vtkSynchronizedTemplates2D.h"
@@ -62,6 +63,8 @@ vtkContourFilter::vtkContourFilter()
   this->UseScalarTree = 0;
   this->ScalarTree = NULL;
 
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+
   this->SynchronizedTemplates2D = vtkSynchronizedTemplates2D::New();
   this->SynchronizedTemplates3D = vtkSynchronizedTemplates3D::New();
   this->GridSynchronizedTemplates = vtkGridSynchronizedTemplates3D::New();
@@ -174,6 +177,7 @@ int vtkContourFilter::RequestUpdateExtent(vtkInformation* request,
       this->SynchronizedTemplates3D->SetComputeNormals(this->ComputeNormals);
       this->SynchronizedTemplates3D->SetComputeGradients(this->ComputeGradients);
       this->SynchronizedTemplates3D->SetComputeScalars(this->ComputeScalars);      
+      this->SynchronizedTemplates3D->SetNumberOfThreads(this->NumberOfThreads);
       return this->SynchronizedTemplates3D->
         ProcessRequest(request,inputVector,outputVector);
       }
@@ -214,6 +218,7 @@ int vtkContourFilter::RequestUpdateExtent(vtkInformation* request,
       this->GridSynchronizedTemplates->SetComputeNormals(this->ComputeNormals);
       this->GridSynchronizedTemplates->SetComputeGradients(this->ComputeGradients);
       this->GridSynchronizedTemplates->SetComputeScalars(this->ComputeScalars);
+      this->GridSynchronizedTemplates->SetNumberOfThreads(this->NumberOfThreads);
       return this->GridSynchronizedTemplates->
         ProcessRequest(request,inputVector,outputVector);
       }
@@ -293,6 +298,7 @@ int vtkContourFilter::RequestData(
       this->SynchronizedTemplates3D->SetComputeNormals(this->ComputeNormals);
       this->SynchronizedTemplates3D->SetComputeGradients(this->ComputeGradients);
       this->SynchronizedTemplates3D->SetComputeScalars(this->ComputeScalars);      
+      this->SynchronizedTemplates3D->SetNumberOfThreads(this->NumberOfThreads);
       this->SynchronizedTemplates3D->
         SetInputArrayToProcess(0,this->GetInputArrayInformation(0));
       return 
@@ -337,6 +343,7 @@ int vtkContourFilter::RequestData(
       this->GridSynchronizedTemplates->SetComputeNormals(this->ComputeNormals);
       this->GridSynchronizedTemplates->SetComputeGradients(this->ComputeGradients);
       this->GridSynchronizedTemplates->SetComputeScalars(this->ComputeScalars);
+      this->GridSynchronizedTemplates->SetNumberOfThreads(this->NumberOfThreads);
       this->GridSynchronizedTemplates->
         SetInputArrayToProcess(0,this->GetInputArrayInformation(0));
       return this->GridSynchronizedTemplates->
@@ -501,9 +508,10 @@ int vtkContourFilter::RequestData(
       vtkCell *cell;
       if ( this->ScalarTree == NULL )
         {
-        this->ScalarTree = vtkSimpleScalarTree::New();
+        this->ScalarTree = vtkIntervalScalarTree::New();
         }
       this->ScalarTree->SetDataSet(input);
+      this->ScalarTree->SetScalars(inScalars);
       // Note: This will have problems when input contains 2D and 3D cells.
       // CellData will get scrabled because of the implicit ordering of
       // verts, lines and polys in vtkPolyData.  The solution
@@ -644,6 +652,7 @@ void vtkContourFilter::PrintSelf(ostream& os, vtkIndent indent)
     {
     os << indent << "Locator: (none)\n";
     }
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
 }
 
 //----------------------------------------------------------------------------
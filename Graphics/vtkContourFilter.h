@@ -30,7 +30,13 @@
 // vtkScalarTree. A scalar tree is used to quickly locate cells that
 // contain a contour surface. This is especially effective if multiple
 // contours are being extracted. If you want to use a scalar tree,
-// invoke the method UseScalarTreeOn().
+// invoke the method UseScalarTreeOn(). A vtkIntervalScalarTree is used
+// unless another tree is set; it is kept across executions, so changing
+// only the contour values does not build it again.
+//
+// Structured points and structured grids of dimension three are contoured
+// by the synchronized templates filters, which split the work over
+// NumberOfThreads threads.
 
 // .SECTION Caveats
 // For unstructured data or structured grids, normals and gradients
@@ -136,6 +142,13 @@ public:
   void SetArrayComponent( int );
   int  GetArrayComponent();
 
+  // Description:
+  // Set/Get the number of threads used to contour image data and
+  // structured grids.  It defaults to
+  // vtkMultiThreader::GetGlobalDefaultNumberOfThreads().
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
 protected:
   vtkContourFilter();
   ~vtkContourFilter();
@@ -157,6 +170,7 @@ protected:
   vtkPointLocator *Locator;
   int UseScalarTree;
   vtkScalarTree *ScalarTree;
+  int NumberOfThreads;
   
   vtkSynchronizedTemplates2D *SynchronizedTemplates2D;
   vtkSynchronizedTemplates3D *SynchronizedTemplates3D;
@@ -21,11 +21,11 @@
 #include "vtkFloatArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkIntervalScalarTree.h"
 #include "vtkMergePoints.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
-#include "vtkSimpleScalarTree.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkCutter.h"
 
@@ -267,9 +267,10 @@ void vtkContourGridExecute(vtkContourGrid *self, vtkDataSet *input,
     //
     if ( scalarTree == NULL )
       {
-      scalarTree = vtkSimpleScalarTree::New();
+      scalarTree = vtkIntervalScalarTree::New();
       }
     scalarTree->SetDataSet(input);
+    scalarTree->SetScalars(inScalars);
     //
     // Loop over all contour values.  Then for each contour value, 
     // loop over all cells.
@@ -30,7 +30,9 @@
 // vtkScalarTree. A scalar tree is used to quickly locate cells that
 // contain a contour surface. This is especially effective if multiple
 // contours are being extracted. If you want to use a scalar tree,
-// invoke the method UseScalarTreeOn().
+// invoke the method UseScalarTreeOn(). A vtkIntervalScalarTree is used
+// unless another tree is set; it is kept across executions, so changing
+// only the contour values does not build it again.
 //
 
 // .SECTION Caveats
@@ -20,12 +20,14 @@
 #include "vtkDataSet.h"
 #include "vtkDoubleArray.h"
 #include "vtkFloatArray.h"
+#include "vtkGarbageCollector.h"
 #include "vtkGenericCell.h"
 #include "vtkGridSynchronizedTemplates3D.h"
 #include "vtkImageData.h"
 #include "vtkImplicitFunction.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkIntervalScalarTree.h"
 #include "vtkMergePoints.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
@@ -38,11 +40,15 @@
 #include "vtkSynchronizedTemplatesCutter3D.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
+
 #include <math.h>
 
 vtkCxxRevisionMacro(vtkCutter, "1.85");
 vtkStandardNewMacro(vtkCutter);
 vtkCxxSetObjectMacro(vtkCutter,CutFunction,vtkImplicitFunction);
+vtkCxxSetObjectMacro(vtkCutter,ScalarTree,vtkScalarTree);
 
 // Construct with user-specified implicit function; initial value of 0.0; and
 // generating cut scalars turned off.
@@ -53,6 +59,9 @@ vtkCutter::vtkCutter(vtkImplicitFunction *cf)
   this->CutFunction = cf;
   this->GenerateCutScalars = 0;
   this->Locator = NULL;
+  this->UseScalarTree = 0;
+  this->ScalarTree = NULL;
+  this->CutScalars = NULL;
 
   this->SynchronizedTemplates3D = vtkSynchronizedTemplates3D::New();
   this->SynchronizedTemplatesCutter3D = vtkSynchronizedTemplatesCutter3D::New();
@@ -69,6 +78,11 @@ vtkCutter::~vtkCutter()
     this->Locator->UnRegister(this);
     this->Locator = NULL;
     }
+  this->SetScalarTree(NULL);
+  if ( this->CutScalars )
+    {
+    this->CutScalars->Delete();
+    }
 
   this->SynchronizedTemplates3D->Delete();
   this->SynchronizedTemplatesCutter3D->Delete();
@@ -363,7 +377,12 @@ int vtkCutter::RequestData(
       }
     }
 
-  if (input->GetDataObjectType() == VTK_UNSTRUCTURED_GRID)
+  if (this->UseScalarTree)
+    {
+    vtkDebugMacro(<< "Executing Scalar Tree Cutter");
+    this->ScalarTreeCutter(input, output);
+    }
+  else if (input->GetDataObjectType() == VTK_UNSTRUCTURED_GRID)
     { 
     vtkDebugMacro(<< "Executing Unstructured Grid Cutter");   
     this->UnstructuredGridCutter(input, output);
@@ -728,6 +747,7 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
       // Loop over all cells; get scalar values for all cell points
       // and process each cell.
       //
+      cellArrayIt = 0;
       for (cellId=0; cellId < numCells && !abortExecute; cellId++)
         {
         if ( !(++cut % progressInterval) )
@@ -771,21 +791,9 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
           vtkCell *cell = input->GetCell(cellId);
           cellIds = cell->GetPointIds();
           cutScalars->GetTuples(cellIds,cellScalars);
-          // Loop over all contour values.
-          for (iter=0; iter < numContours && !abortExecute; iter++)
-            {
-            if ( !(++cut % progressInterval) )
-              {
-              vtkDebugMacro(<<"Cutting #" << cut);
-              this->UpdateProgress ((double)cut/numCuts);
-              abortExecute = this->GetAbortExecute();
-              }
-            value = this->ContourValues->GetValue(iter);
-              
-            cell->Contour(value, cellScalars, this->Locator, 
-                          newVerts, newLines, newPolys, inPD, outPD,
-                          inCD, cellId, outCD);
-            }
+          cell->Contour(val, cellScalars, this->Locator, 
+                        newVerts, newLines, newPolys, inPD, outPD,
+                        inCD, cellId, outCD);
           }
         
         } // for all cells
@@ -928,6 +936,254 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
   output->Squeeze();
 }
 
+// Append to cellIds the cells whose cut values span value.
+static void vtkCutterAddCellsAtValue(vtkScalarTree *tree, double value,
+                                     vtkIdList *valueCells,
+                                     vtkDoubleArray *cellScalars,
+                                     vtkstd::vector<vtkIdType>& cellIds)
+{
+  vtkIntervalScalarTree *intervalTree =
+    vtkIntervalScalarTree::SafeDownCast(tree);
+  if ( intervalTree )
+    {
+    intervalTree->BuildTree();
+    intervalTree->GetCellsAtValue(value, valueCells);
+    vtkIdType *ids = valueCells->GetPointer(0);
+    cellIds.insert(cellIds.end(), ids, ids + valueCells->GetNumberOfIds());
+    }
+  else
+    {
+    vtkIdType cellId;
+    vtkIdList *ptIds;
+    for ( tree->InitTraversal(value);
+          tree->GetNextCell(cellId, ptIds, cellScalars) != NULL; )
+      {
+      cellIds.push_back(cellId);
+      }
+    }
+}
+
+// Cut unstructured data visiting only the cells given by a scalar tree
+// over the values of the cut function.  The values and the tree are kept
+// until the input or the cut function change.  The output is the same as
+// that of DataSetCutter().
+void vtkCutter::ScalarTreeCutter(vtkDataSet *input, vtkPolyData *output)
+{
+  vtkIdType cellId, i;
+  int iter;
+  vtkIdList *cellIds;
+  vtkGenericCell *cell;
+  vtkCellArray *newVerts, *newLines, *newPolys;
+  vtkPoints *newPoints;
+  vtkDoubleArray *cellScalars;
+  double value;
+  vtkIdType estimatedSize, numCells=input->GetNumberOfCells();
+  vtkIdType numPts=input->GetNumberOfPoints();
+  vtkPointData *inPD, *outPD;
+  vtkCellData *inCD=input->GetCellData(), *outCD=output->GetCellData();
+  int numContours=this->ContourValues->GetNumberOfContours();
+  int abortExecute=0;
+
+  if ( numCells < 1 )
+    {
+    return;
+    }
+
+  // Evaluate the cut function unless the values kept from a previous
+  // execution are current.
+  if ( this->ScalarTree == NULL )
+    {
+    this->ScalarTree = vtkIntervalScalarTree::New();
+    }
+  if ( this->CutScalars == NULL || this->ScalarTree->GetDataSet() != input
+       || this->CutScalars->GetNumberOfTuples() != numPts
+       || this->CutScalarsTime.GetMTime() < input->GetMTime()
+       || this->CutScalarsTime.GetMTime() < this->CutFunction->GetMTime() )
+    {
+    if ( this->CutScalars == NULL )
+      {
+      this->CutScalars = vtkDoubleArray::New();
+      }
+    this->CutScalars->SetNumberOfTuples(numPts);
+    double *s = this->CutScalars->GetPointer(0);
+    for ( i=0; i < numPts; i++ )
+      {
+      s[i] = this->CutFunction->FunctionValue(input->GetPoint(i));
+      }
+    this->CutScalars->Modified();
+    this->CutScalarsTime.Modified();
+    }
+  this->ScalarTree->SetDataSet(input);
+  this->ScalarTree->SetScalars(this->CutScalars);
+
+  // Create objects to hold output of contour operation
+  //
+  estimatedSize = (vtkIdType) pow ((double) numCells, .75) * numContours;
+  estimatedSize = estimatedSize / 1024 * 1024; //multiple of 1024
+  if (estimatedSize < 1024)
+    {
+    estimatedSize = 1024;
+    }
+
+  newPoints = vtkPoints::New();
+  newPoints->Allocate(estimatedSize,estimatedSize/2);
+  newVerts = vtkCellArray::New();
+  newVerts->Allocate(estimatedSize,estimatedSize/2);
+  newLines = vtkCellArray::New();
+  newLines->Allocate(estimatedSize,estimatedSize/2);
+  newPolys = vtkCellArray::New();
+  newPolys->Allocate(estimatedSize,estimatedSize/2);
+  cellScalars = vtkDoubleArray::New();
+  cellScalars->Allocate(VTK_CELL_SIZE);
+
+  // Interpolate data along edge. If generating cut scalars, do necessary setup
+  if ( this->GenerateCutScalars )
+    {
+    inPD = vtkPointData::New();
+    inPD->ShallowCopy(input->GetPointData());//copies original attributes
+    inPD->SetScalars(this->CutScalars);
+    }
+  else 
+    {
+    inPD = input->GetPointData();
+    }
+  outPD = output->GetPointData();
+  outPD->InterpolateAllocate(inPD,estimatedSize,estimatedSize/2);
+  outCD->CopyAllocate(inCD,estimatedSize,estimatedSize/2);
+    
+  // locator used to merge potentially duplicate points
+  if ( this->Locator == NULL )
+    {
+    this->CreateDefaultLocator();
+    }
+  this->Locator->InitPointInsertion (newPoints, input->GetBounds());
+
+  cell = vtkGenericCell::New();
+  vtkIdList *valueCells = vtkIdList::New();
+  vtkstd::vector<vtkIdType> cutCells;
+
+  if ( this->SortBy == VTK_SORT_BY_CELL )
+    {
+    // For each contour value, cut the cells that span it in order.
+    for (iter=0; iter < numContours && !abortExecute; iter++)
+      {
+      value = this->ContourValues->GetValue(iter);
+      cutCells.clear();
+      vtkCutterAddCellsAtValue(this->ScalarTree, value, valueCells,
+                               cellScalars, cutCells);
+      vtkIdType numCutCells = static_cast<vtkIdType>(cutCells.size());
+      vtkIdType progressInterval = numCutCells/20 + 1;
+      for (i=0; i < numCutCells && !abortExecute; i++)
+        {
+        if ( !((i + 1) % progressInterval) )
+          {
+          vtkDebugMacro(<<"Cutting #" << i);
+          this->UpdateProgress ((iter + (double)i/numCutCells)/numContours);
+          abortExecute = this->GetAbortExecute();
+          }
+        cellId = cutCells[i];
+        input->GetCell(cellId,cell);
+        cellIds = cell->GetPointIds();
+        cellScalars->SetNumberOfTuples(cellIds->GetNumberOfIds());
+        this->CutScalars->GetTuples(cellIds,cellScalars);
+        cell->Contour(value, cellScalars, this->Locator, 
+                      newVerts, newLines, newPolys, inPD, outPD,
+                      inCD, cellId, outCD);
+        }
+      }
+    }
+  else // VTK_SORT_BY_VALUE:
+    {
+    // Cut the cells that span any of the values, in order, lower
+    // dimensional cells first as DataSetCutter() does.
+    for (iter=0; iter < numContours; iter++)
+      {
+      vtkCutterAddCellsAtValue(this->ScalarTree,
+                               this->ContourValues->GetValue(iter),
+                               valueCells, cellScalars, cutCells);
+      }
+    vtkstd::sort(cutCells.begin(), cutCells.end());
+    cutCells.erase(vtkstd::unique(cutCells.begin(), cutCells.end()),
+                   cutCells.end());
+    vtkIdType numCutCells = static_cast<vtkIdType>(cutCells.size());
+    vtkIdType progressInterval = numCutCells/20 + 1;
+
+    unsigned char cellTypeDimensions[VTK_NUMBER_OF_CELL_TYPES];
+    vtkCutter::GetCellTypeDimensions(cellTypeDimensions);
+    int dimensionality;
+    for (dimensionality = 1; dimensionality <= 3; ++dimensionality)
+      {
+      for (i=0; i < numCutCells && !abortExecute; i++)
+        {
+        cellId = cutCells[i];
+        int cellType = input->GetCellType(cellId);
+        if (cellType >= VTK_NUMBER_OF_CELL_TYPES)
+          { // Protect against new cell types added.
+          vtkErrorMacro("Unknown cell type " << cellType);
+          continue;
+          }
+        if (cellTypeDimensions[cellType] != dimensionality)
+          {
+          continue;
+          }
+        if ( dimensionality == 3 && !((i + 1) % progressInterval) )
+          {
+          vtkDebugMacro(<<"Cutting #" << i);
+          this->UpdateProgress ((double)i/numCutCells);
+          abortExecute = this->GetAbortExecute();
+          }
+        input->GetCell(cellId,cell);
+        cellIds = cell->GetPointIds();
+        cellScalars->SetNumberOfTuples(cellIds->GetNumberOfIds());
+        this->CutScalars->GetTuples(cellIds,cellScalars);
+        for (iter=0; iter < numContours; iter++)
+          {
+          value = this->ContourValues->GetValue(iter);
+          cell->Contour(value, cellScalars, this->Locator, 
+                        newVerts, newLines, newPolys, inPD, outPD,
+                        inCD, cellId, outCD);
+          }
+        }
+      }
+    }
+
+  // Update ourselves.  Because we don't know upfront how many verts, lines,
+  // polys we've created, take care to reclaim memory. 
+  //
+  valueCells->Delete();
+  cell->Delete();
+  cellScalars->Delete();
+
+  if ( this->GenerateCutScalars )
+    {
+    inPD->Delete();
+    }
+
+  output->SetPoints(newPoints);
+  newPoints->Delete();
+
+  if (newVerts->GetNumberOfCells())
+    {
+    output->SetVerts(newVerts);
+    }
+  newVerts->Delete();
+
+  if (newLines->GetNumberOfCells())
+    {
+    output->SetLines(newLines);
+    }
+  newLines->Delete();
+
+  if (newPolys->GetNumberOfCells())
+    {
+    output->SetPolys(newPolys);
+    }
+  newPolys->Delete();
+
+  this->Locator->Initialize();//release any extra memory
+  output->Squeeze();
+}
+
 // Specify a spatial locator for merging points. By default, 
 // an instance of vtkMergePoints is used.
 void vtkCutter::SetLocator(vtkPointLocator *locator)
@@ -996,4 +1252,24 @@ void vtkCutter::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Generate Cut Scalars: " 
      << (this->GenerateCutScalars ? "On\n" : "Off\n");
+
+  os << indent << "Use Scalar Tree: " 
+     << (this->UseScalarTree ? "On\n" : "Off\n");
+  if ( this->ScalarTree )
+    {
+    os << indent << "Scalar Tree: " << this->ScalarTree << "\n";
+    }
+  else
+    {
+    os << indent << "Scalar Tree: (none)\n";
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkCutter::ReportReferences(vtkGarbageCollector* collector)
+{
+  this->Superclass::ReportReferences(collector);
+  // The scalar tree shares our input and is therefore involved in a
+  // reference loop.
+  vtkGarbageCollectorReport(collector, this->ScalarTree, "ScalarTree");
 }
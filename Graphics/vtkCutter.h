@@ -53,7 +53,9 @@
 #define VTK_NUMBER_OF_CELL_TYPES 68
 
 class vtkImplicitFunction;
+class vtkDoubleArray;
 class vtkPointLocator;
+class vtkScalarTree;
 class vtkSynchronizedTemplates3D;
 class vtkSynchronizedTemplatesCutter3D;
 class vtkGridSynchronizedTemplates3D;
@@ -136,6 +138,22 @@ public:
   vtkGetMacro(GenerateCutScalars,int);
   vtkBooleanMacro(GenerateCutScalars,int);
 
+  // Description:
+  // Enable the use of a scalar tree over the values of the cut function
+  // to find the cells to cut in unstructured data.  The values of the
+  // cut function and the tree are kept until the input or the cut
+  // function change, so that changing only the cut values does not
+  // compute them again.
+  vtkSetMacro(UseScalarTree,int);
+  vtkGetMacro(UseScalarTree,int);
+  vtkBooleanMacro(UseScalarTree,int);
+
+  // Description:
+  // Set/Get the scalar tree used when UseScalarTree is on.  By default a
+  // vtkIntervalScalarTree is created.
+  virtual void SetScalarTree(vtkScalarTree*);
+  vtkGetObjectMacro(ScalarTree,vtkScalarTree);
+
   // Description:
   // Specify a spatial locator for merging points. By default, 
   // an instance of vtkMergePoints is used.
@@ -182,8 +200,10 @@ protected:
   virtual int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *);
   virtual int RequestUpdateExtent(vtkInformation *, vtkInformationVector **, vtkInformationVector *);
   virtual int FillInputPortInformation(int port, vtkInformation *info);
+  virtual void ReportReferences(vtkGarbageCollector*);
   void UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output);
   void DataSetCutter(vtkDataSet *input, vtkPolyData *output);
+  void ScalarTreeCutter(vtkDataSet *input, vtkPolyData *output);
   void StructuredPointsCutter(vtkDataSet *, vtkPolyData *,
                               vtkInformation *, vtkInformationVector **, 
                               vtkInformationVector *);
@@ -200,6 +220,11 @@ protected:
   int SortBy;
   vtkContourValues *ContourValues;
   int GenerateCutScalars;
+
+  int UseScalarTree;
+  vtkScalarTree *ScalarTree;
+  vtkDoubleArray *CutScalars; // cut function values kept for the tree
+  vtkTimeStamp CutScalarsTime;
 private:
   vtkCutter(const vtkCutter&);  // Not implemented.
   void operator=(const vtkCutter&);  // Not implemented.
@@ -17,15 +17,18 @@
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCharArray.h"
+#include "vtkCriticalSection.h"
 #include "vtkDoubleArray.h"
 #include "vtkExtentTranslator.h"
 #include "vtkFloatArray.h"
 #include "vtkGridSynchronizedTemplates3D.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkIntArray.h"
 #include "vtkLongArray.h"
 #include "vtkMath.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
@@ -33,6 +36,8 @@
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
 #include "vtkStructuredPoints.h"
+#include "vtkSynchronizedTemplatesMerger.h"
+#include "vtkTaskScheduler.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnsignedIntArray.h"
 #include "vtkUnsignedLongArray.h"
@@ -62,6 +67,8 @@ vtkGridSynchronizedTemplates3D::vtkGridSynchronizedTemplates3D()
   this->MinimumPieceSize[1] = 10;
   this->MinimumPieceSize[2] = 10;
 
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+
   // by default process active point scalars
   this->SetInputArrayToProcess(0,0,0,vtkDataObject::FIELD_ASSOCIATION_POINTS,
                                vtkDataSetAttributes::SCALARS);
@@ -95,6 +102,11 @@ unsigned long vtkGridSynchronizedTemplates3D::GetMTime()
   return mTime;
 }
 
+//----------------------------------------------------------------------------
+// Serializes the output initialization of slabs contoured in parallel,
+// which registers the lookup tables of the input arrays.
+static vtkSimpleCriticalSection vtkGridSynchronizedTemplates3DInitializeLock;
+
 //----------------------------------------------------------------------------
 void vtkGridSynchronizedTemplates3DInitializeOutput(int *ext,
                                                     vtkStructuredGrid *input,
@@ -336,18 +348,20 @@ if (ComputeScalars) \
 } 
 
 //----------------------------------------------------------------------------
-// Contouring filter specialized for images
+// Contouring filter specialized for images.  The ids of the edges on the
+// bottom and top planes of the extent are recorded in bottomEdges and
+// topEdges when they are not NULL.
 template <class T, class PointsType>
 void ContourGrid(vtkGridSynchronizedTemplates3D *self,
                  int *exExt, T *scalars,
-                 vtkStructuredGrid *input, vtkPolyData *output, PointsType*, vtkDataArray *inScalars)
+                 vtkStructuredGrid *input, vtkPolyData *output, PointsType*, vtkDataArray *inScalars,
+                 double *values, int numContours,
+                 vtkIdTypeArray *bottomEdges, vtkIdTypeArray *topEdges)
 {
   int *inExt = input->GetExtent();
   int xdim = exExt[1] - exExt[0] + 1;
   int ydim = exExt[3] - exExt[2] + 1;
   double n0[3], n1[3];  // used in gradient macro
-  double *values = self->GetValues();
-  int numContours = self->GetNumberOfContours();
   PointsType *inPtPtrX, *inPtPtrY, *inPtPtrZ;
   PointsType *p0, *p1, *p2, *p3;
   T *inPtrX, *inPtrY, *inPtrZ;
@@ -400,8 +414,10 @@ void ContourGrid(vtkGridSynchronizedTemplates3D *self,
     {
     newGradients = vtkFloatArray::New();
     }
+  vtkGridSynchronizedTemplates3DInitializeLock.Lock();
   vtkGridSynchronizedTemplates3DInitializeOutput(exExt, input, output, 
                                                  newScalars, newNormals, newGradients, inScalars);
+  vtkGridSynchronizedTemplates3DInitializeLock.Unlock();
   newPts = output->GetPoints();
   newPolys = output->GetPolys();
 
@@ -530,7 +546,7 @@ void ContourGrid(vtkGridSynchronizedTemplates3D *self,
                   {
                   *isect2Ptr = *(isect2Ptr-3);
                   }
-                else if (j > XMin && *(isect2Ptr - yisectstep + 1) > -1)
+                else if (j > YMin && *(isect2Ptr - yisectstep + 1) > -1)
                   {
                   *isect2Ptr = *(isect2Ptr - yisectstep + 1);
                   }
@@ -706,6 +722,41 @@ void ContourGrid(vtkGridSynchronizedTemplates3D *self,
         inPtPtrY += 3*incY;
         inPtrY += incY;
         }
+
+      // Record the edges shared with neighboring slabs.  Of the z edges
+      // of the bottom plane, only points that sit on a vertex can also be
+      // generated by the slab below.
+      if (k == ZMin && bottomEdges)
+        {
+        vtkIdType edge[2];
+        isect2Ptr = (k%2 ? isect1 + zstep*3 : isect1);
+        inPtrY = inPtrZ;
+        for (j = 0; j < ydim; j++)
+          {
+          inPtrX = inPtrY;
+          for (i = 0; i < xdim; i++)
+            {
+            for (jj = 0; jj < 3; jj++)
+              {
+              if (isect2Ptr[jj] > -1 && (jj < 2 || *inPtrX == value))
+                {
+                edge[0] = (j*xdim + i)*3 + jj;
+                edge[1] = isect2Ptr[jj];
+                bottomEdges->InsertNextTupleValue(edge);
+                }
+              }
+            isect2Ptr += 3;
+            ++inPtrX;
+            }
+          inPtrY += incY;
+          }
+        }
+      if (k == ZMax && topEdges)
+        {
+        vtkSynchronizedTemplatesMerger::AddEdges(
+          topEdges, (k%2 ? isect1 + zstep*3 : isect1),
+          (k%2 ? isect1 : isect1 + zstep*3), zstep);
+        }
       inPtPtrZ += 3*incZ;
       inPtrZ += incZ;
       }
@@ -738,12 +789,56 @@ void ContourGrid(vtkGridSynchronizedTemplates3D *self,
 template <class T>
 void ContourGrid(vtkGridSynchronizedTemplates3D *self,
                  int *exExt, T *scalars, vtkStructuredGrid *input,
-                 vtkPolyData *output, vtkDataArray *inScalars)
+                 vtkPolyData *output, vtkDataArray *inScalars,
+                 double *values, int numContours,
+                 vtkIdTypeArray *bottomEdges, vtkIdTypeArray *topEdges)
 {
   switch(input->GetPoints()->GetData()->GetDataType())
     {
     vtkTemplateMacro(
-      ContourGrid(self, exExt, scalars, input, output, (VTK_TT*)0, inScalars));
+      ContourGrid(self, exExt, scalars, input, output, (VTK_TT*)0, inScalars,
+                  values, numContours, bottomEdges, topEdges));
+    }
+}
+
+//----------------------------------------------------------------------------
+// What the tasks contouring the slabs of a grid need.
+struct vtkGridSynchronizedTemplates3DTaskData
+{
+  vtkGridSynchronizedTemplates3D *Filter;
+  vtkSynchronizedTemplatesMerger *Merger;
+  vtkStructuredGrid *Input;
+  vtkDataArray *InScalars;
+  void *Scalars;
+  int ScalarType;
+  double *Values;
+};
+
+//----------------------------------------------------------------------------
+// Contour the pieces [begin, end).
+static void vtkGridSynchronizedTemplates3DExecutePieces(void *arg,
+                                                        vtkIdType begin,
+                                                        vtkIdType end)
+{
+  vtkGridSynchronizedTemplates3DTaskData *td =
+    static_cast<vtkGridSynchronizedTemplates3DTaskData *>(arg);
+  vtkSynchronizedTemplatesMerger *merger = td->Merger;
+  int numSlabs = merger->GetNumberOfSlabs();
+
+  for (vtkIdType idx = begin; idx < end; ++idx)
+    {
+    int piece = static_cast<int>(idx);
+    int slabExt[6];
+    merger->GetPieceExtent(piece, slabExt);
+    switch (td->ScalarType)
+      {
+      vtkTemplateMacro(
+        ContourGrid(td->Filter, slabExt, (VTK_TT *)td->Scalars, td->Input,
+                    merger->GetPiece(piece), td->InScalars,
+                    td->Values + piece / numSlabs, 1,
+                    merger->GetBottomEdges(piece),
+                    merger->GetTopEdges(piece)));
+      }
     }
 }
 
@@ -782,23 +877,65 @@ void vtkGridSynchronizedTemplates3D::ThreadedExecute(int *exExt, int ,
   //
   // Check data type and execute appropriate function
   //
+  void *scalars;
+  int scalarType;
+  vtkDoubleArray *image = NULL;
   if (inScalars->GetNumberOfComponents() == 1 )
     {
-    void *scalars = inScalars->GetVoidPointer(0);
-    switch (inScalars->GetDataType())
-      {
-      vtkTemplateMacro(
-        ContourGrid(this, exExt, (VTK_TT *)scalars, input, output, inScalars));
-      }//switch
+    scalars = inScalars->GetVoidPointer(0);
+    scalarType = inScalars->GetDataType();
     }
   else //multiple components - have to convert
     {
-    vtkDoubleArray *image = vtkDoubleArray::New();
+    image = vtkDoubleArray::New();
     image->SetNumberOfComponents(inScalars->GetNumberOfComponents());
     image->Allocate(dataSize*image->GetNumberOfComponents());
     inScalars->GetTuples(0,dataSize,image);
-    double *scalars = image->GetPointer(0);
-    ContourGrid(this, exExt, scalars, input, output, inScalars);
+    scalars = image->GetPointer(0);
+    scalarType = VTK_DOUBLE;
+    }
+
+  int numContours = this->GetNumberOfContours();
+  vtkSynchronizedTemplatesMerger *merger = NULL;
+  if (this->NumberOfThreads > 1)
+    {
+    merger = vtkSynchronizedTemplatesMerger::New();
+    merger->Initialize(exExt, numContours, this->NumberOfThreads);
+    if (merger->GetNumberOfSlabs() < 2)
+      {
+      merger->Delete();
+      merger = NULL;
+      }
+    }
+
+  if (merger == NULL)
+    {
+    switch (scalarType)
+      {
+      vtkTemplateMacro(
+        ContourGrid(this, exExt, (VTK_TT *)scalars, input, output, inScalars,
+                    this->GetValues(), numContours, NULL, NULL));
+      }//switch
+    }
+  else
+    {
+    // Contour the slabs on the global scheduler, then stitch them.
+    vtkGridSynchronizedTemplates3DTaskData td;
+    td.Filter = this;
+    td.Merger = merger;
+    td.Input = input;
+    td.InScalars = inScalars;
+    td.Scalars = scalars;
+    td.ScalarType = scalarType;
+    td.Values = this->GetValues();
+    vtkTaskScheduler::GetGlobalScheduler()->ParallelFor(
+      0, merger->GetNumberOfPieces(), 1,
+      vtkGridSynchronizedTemplates3DExecutePieces, &td);
+    merger->Merge(output);
+    merger->Delete();
+    }
+  if (image)
+    {
     image->Delete();
     }
 
@@ -925,6 +1062,7 @@ void vtkGridSynchronizedTemplates3D::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Compute Normals: " << (this->ComputeNormals ? "On\n" : "Off\n");
   os << indent << "Compute Gradients: " << (this->ComputeGradients ? "On\n" : "Off\n");
   os << indent << "Compute Scalars: " << (this->ComputeScalars ? "On\n" : "Off\n");
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << endl;
 }
 
 //----------------------------------------------------------------------------
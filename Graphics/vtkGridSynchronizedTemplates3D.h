@@ -17,12 +17,17 @@
 // .SECTION Description
 // vtkGridSynchronizedTemplates3D is a 3D implementation of the synchronized 
 // template algorithm.
+//
+// When NumberOfThreads is larger than one, the execute extent is cut into
+// slabs along k that are contoured on the threads of the global
+// vtkTaskScheduler and then stitched together, so the output has the same
+// triangles as a single pass.
 
 // .SECTION Caveats
 // This filter is specialized to 3D grids.
 
 // .SECTION See Also
-// vtkContourFilter vtkSynchronizedTemplates3D
+// vtkContourFilter vtkSynchronizedTemplates3D vtkSynchronizedTemplatesMerger
 
 #ifndef __vtkGridSynchronizedTemplates3D_h
 #define __vtkGridSynchronizedTemplates3D_h
@@ -127,6 +132,12 @@ public:
   // from the input will be larger than this value (KiloBytes).
   void SetInputMemoryLimit(long limit);
 
+  // Description:
+  // Set/Get the number of threads used to contour the execute extent.
+  // It defaults to vtkMultiThreader::GetGlobalDefaultNumberOfThreads().
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
 protected:
   vtkGridSynchronizedTemplates3D();
   ~vtkGridSynchronizedTemplates3D();
@@ -143,6 +154,8 @@ protected:
   int MinimumPieceSize[3];
   int ExecuteExtent[6];
 
+  int NumberOfThreads;
+
 private:
   vtkGridSynchronizedTemplates3D(const vtkGridSynchronizedTemplates3D&);  // Not implemented.
   void operator=(const vtkGridSynchronizedTemplates3D&);  // Not implemented.
@@ -24,11 +24,13 @@
 #include "vtkBSPIntersections.h"
 #include "vtkObjectFactory.h"
 #include "vtkDataSet.h"
+#include "vtkDoubleArray.h"
 #include "vtkFloatArray.h"
 #include "vtkMath.h"
 #include "vtkCell.h"
 #include "vtkCellArray.h"
 #include "vtkGarbageCollector.h"
+#include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkPolyData.h"
 #include "vtkPoints.h"
@@ -38,6 +40,8 @@
 #include "vtkImageData.h"
 #include "vtkUniformGrid.h"
 #include "vtkRectilinearGrid.h"
+#include "vtkScratchPool.h"
+#include "vtkTaskScheduler.h"
 
 #ifdef _MSC_VER
 #pragma warning ( disable : 4100 )
@@ -83,6 +87,48 @@ static char * makeEntry(const char *s)
 
 // Timing data ---------------------------------------------
 
+// Regions with more points than this are divided on separate tasks.
+#define VTK_KD_TREE_TASK_SIZE 10000
+
+// The two children of a region, divided on separate tasks.
+struct vtkKdTreeDivideRegions
+{
+  vtkKdTree *Tree;
+  vtkKdNode *Nodes[2];
+  float *Points[2];
+  int *Ids[2];
+  int Level;
+};
+
+// The cells of a data set whose centers are computed in parallel.
+struct vtkKdTreeCellCenters
+{
+  vtkKdTree *Tree;
+  vtkDataSet *DataSet;
+  float *Centers;
+  int MaxCellSize;
+};
+
+// The regions searched in parallel for duplicate points.
+struct vtkKdTreeMapDuplicates
+{
+  vtkKdTree *Tree;
+  vtkIdType *Map;
+  int **UniqueFound;
+  int *IdCount;
+  int Failed;
+};
+
+// The points located in parallel by FindPoints() or FindClosestPoints().
+struct vtkKdTreeFindPoints
+{
+  vtkKdTree *Tree;
+  vtkPoints *Points;
+  vtkIdType *Ids;
+  double *Dist2;
+  int Closest;
+};
+
 vtkStandardNewMacro(vtkKdTree);
 
 //----------------------------------------------------------------------------
@@ -631,7 +677,7 @@ float *vtkKdTree::ComputeCellCenters(int set)
 //----------------------------------------------------------------------------
 float *vtkKdTree::ComputeCellCenters(vtkDataSet *set)
 {
-  int i,j;
+  int i;
   int totalCells;
 
   if (set)
@@ -673,51 +719,72 @@ float *vtkKdTree::ComputeCellCenters(vtkDataSet *set)
       }
     }
 
-  double *weights = new double [maxCellSize];
+  // The centers of the cells of each data set are computed in parallel.
 
-  float *cptr = center;
-  double dcenter[3];
+  vtkKdTreeCellCenters centers;
+  centers.Tree = this;
+  centers.Centers = center;
+  centers.MaxCellSize = maxCellSize;
 
-  if (set)
+  int numSets = set ? 1 : this->NumDataSetsAllocated;
+
+  for (i=0; i<numSets; i++)
     {
-    for (j=0; j<totalCells; j++)
+    vtkDataSet *iset = set ? set : this->DataSets[i];
+
+    if (!iset) 
       {
-      this->ComputeCellCenter(set->GetCell(j), dcenter, weights);
-      cptr[0] = (float)dcenter[0];
-      cptr[1] = (float)dcenter[1];
-      cptr[2] = (float)dcenter[2];
-      cptr += 3;
+      continue;
       }
-    }
-  else
-    {
-    for (i=0; i<this->NumDataSetsAllocated; i++)
+
+    int nCells = iset->GetNumberOfCells();
+
+    if (nCells > 0)
       {
-      if (!this->DataSets[i]) 
-        {
-        continue;
-        }
-  
-      vtkDataSet *iset = this->DataSets[i];
+      // GetCell() with a generic cell is thread safe once it has been
+      // called from a single thread.
 
-      int nCells = iset->GetNumberOfCells();
+      vtkGenericCell *cell = vtkGenericCell::New();
+      iset->GetCell(0, cell);
+      cell->Delete();
 
-      for (j=0; j<nCells; j++)
-        {
-        this->ComputeCellCenter(iset->GetCell(j), dcenter, weights);
-        cptr[0] = (float)dcenter[0];
-        cptr[1] = (float)dcenter[1];
-        cptr[2] = (float)dcenter[2];
-        cptr += 3;
-        }
+      centers.DataSet = iset;
+      vtkTaskScheduler::GetGlobalScheduler()->ParallelFor(
+        0, nCells, 0, vtkKdTree::ComputeCellCentersTask, &centers);
+      centers.Centers += 3*nCells;
       }
     }
 
-  delete [] weights;
-
   return center;
 }
 
+//----------------------------------------------------------------------------
+void vtkKdTree::ComputeCellCentersTask(void *data, vtkIdType begin,
+                                       vtkIdType end)
+{
+  vtkKdTreeCellCenters *centers = static_cast<vtkKdTreeCellCenters *>(data);
+
+  vtkScratchPool *pool = vtkScratchPool::GetThreadPool();
+  vtkGenericCell *cell = pool->AcquireGenericCell();
+  double *weights = new double [centers->MaxCellSize];
+
+  float *cptr = centers->Centers + 3*begin;
+  double dcenter[3];
+
+  for (vtkIdType j = begin; j < end; j++)
+    {
+    centers->DataSet->GetCell(j, cell);
+    centers->Tree->ComputeCellCenter(cell, dcenter, weights);
+    cptr[0] = (float)dcenter[0];
+    cptr[1] = (float)dcenter[1];
+    cptr[2] = (float)dcenter[2];
+    cptr += 3;
+    }
+
+  delete [] weights;
+  pool->ReleaseGenericCell(cell);
+}
+
 //----------------------------------------------------------------------------
 void vtkKdTree::ComputeCellCenter(vtkDataSet *set, int cellId, float *center)
 {
@@ -1322,13 +1389,45 @@ int vtkKdTree::DivideRegion(vtkKdNode *kd, float *c1, int *ids, int level)
   int *leftIds  = ids;
   int *rightIds = ids ? ids + nleft : NULL;
   
-  this->DivideRegion(kd->GetLeft(), c1, leftIds, level + 1);
-  
-  this->DivideRegion(kd->GetRight(), c1 + nleft*3, rightIds, level + 1);
+  // The children use separate parts of the arrays, so large ones are
+  // divided on separate threads.
+
+  vtkKdTreeDivideRegions regions;
+  regions.Tree = this;
+  regions.Nodes[0] = kd->GetLeft();
+  regions.Nodes[1] = kd->GetRight();
+  regions.Points[0] = c1;
+  regions.Points[1] = c1 + nleft*3;
+  regions.Ids[0] = leftIds;
+  regions.Ids[1] = rightIds;
+  regions.Level = level + 1;
+
+  if (kd->GetNumberOfPoints() > VTK_KD_TREE_TASK_SIZE)
+    {
+    vtkTaskScheduler::GetGlobalScheduler()->ParallelFor(
+      0, 2, 1, vtkKdTree::DivideRegionsTask, &regions);
+    }
+  else
+    {
+    vtkKdTree::DivideRegionsTask(&regions, 0, 2);
+    }
   
   return 0;
 }
 
+//----------------------------------------------------------------------------
+void vtkKdTree::DivideRegionsTask(void *data, vtkIdType begin, vtkIdType end)
+{
+  vtkKdTreeDivideRegions *regions =
+    static_cast<vtkKdTreeDivideRegions *>(data);
+
+  for (vtkIdType i = begin; i < end; i++)
+    {
+    regions->Tree->DivideRegion(regions->Nodes[i], regions->Points[i],
+                                regions->Ids[i], regions->Level);
+    }
+}
+
 //----------------------------------------------------------------------------
 // Rearrange the point array.  Try dim1 first.  If there's a problem
 // go to dim2, then dim3.
@@ -1961,94 +2060,126 @@ vtkIdTypeArray *vtkKdTree::BuildMapForDuplicatePoints(float tolerance = 0.0)
 
   vtkIdTypeArray *uniqueIds = vtkIdTypeArray::New();
   uniqueIds->SetNumberOfValues(this->NumberOfLocatorPoints);
+  vtkIdType *map = uniqueIds->GetPointer(0);
 
-  int idx = 0;
-  int nextRegionId = 0;
-  float *point = this->LocatorPoints;
+  int failed = 0;
 
-  while (idx < this->NumberOfLocatorPoints)
+  if (tolerance == 0.0)
     {
-    // first point we have in this region
+    // Equal points are in the same region, so each region is searched
+    // independently of the others.
 
-    int currentId = this->LocatorIds[idx];
+    vtkKdTreeMapDuplicates regions;
+    regions.Tree = this;
+    regions.Map = map;
+    regions.UniqueFound = uniqueFound;
+    regions.IdCount = idCount;
+    regions.Failed = 0;
 
-    int regionId = this->GetRegionContainingPoint(point[0],point[1],point[2]);
+    vtkTaskScheduler::GetGlobalScheduler()->ParallelFor(
+      0, this->NumberOfRegions, 0, vtkKdTree::MapDuplicatePointsTask,
+      &regions);
 
-    if ((regionId == -1) || (regionId != nextRegionId))
+    failed = regions.Failed;
+    }
+  else
+    {
+    // Points are compared with the unique points found in the regions
+    // before their own, so the regions are searched in order.
+
+    for (i=0; !failed && (i<this->NumberOfRegions); i++)
       {
-      delete [] idCount;
-      for (i=0; i<this->NumberOfRegions; i++) delete [] uniqueFound[i];
-      delete [] uniqueFound;
-      uniqueIds->Delete();
-      vtkErrorMacro(<< "vtkKdTree::BuildMapForDuplicatePoints corrupt k-d tree");
-      return NULL; 
+      failed = !this->MapDuplicatePointsInRegion(i, map, uniqueFound,
+                                     idCount, tolerance, tolerance2);
       }
+    }
+
+  for (i=0; i<this->NumberOfRegions; i++)
+    {
+    delete [] uniqueFound[i];
+    }
+  delete [] uniqueFound;
+  delete [] idCount;
+
+  if (failed)
+    {
+    uniqueIds->Delete();
+    vtkErrorMacro(<< "vtkKdTree::BuildMapForDuplicatePoints corrupt k-d tree");
+    return NULL; 
+    }
 
-    int duplicateFound = -1;
+  TIMERDONE("Find duplicate points");
+
+  return uniqueIds;
+}
+
+//----------------------------------------------------------------------------
+// Map each point of a region to itself or to a unique point found before
+// it within the tolerance.  Return 0 if the points are not in the region.
+int vtkKdTree::MapDuplicatePointsInRegion(int regionId, vtkIdType *map,
+                                          int **uniqueFound, int *idCount,
+                                          float tolerance, float tolerance2)
+{
+  int idx = this->LocatorRegionLocation[regionId];
+  int numRegionPoints = this->RegionList[regionId]->GetNumberOfPoints();
+
+  if (numRegionPoints == 0)
+    {
+    return 1;
+    }
+
+  float *point = this->LocatorPoints + (idx * 3);
 
-    if ((tolerance > 0.0) && (regionId > 0))
+  if (this->GetRegionContainingPoint(point[0],point[1],point[2]) != regionId)
+    {
+    return 0;
+    }
+
+  for (int idx2 = idx; idx2 < idx + numRegionPoints; idx2++)
+    {
+    int currentId = this->LocatorIds[idx2];
+
+    int duplicateFound = this->SearchRegionForDuplicate(point,
+                          uniqueFound[regionId], idCount[regionId], tolerance2);
+
+    if ((tolerance > 0.0) && (duplicateFound < 0) && (regionId > 0)) 
       {
       duplicateFound = this->SearchNeighborsForDuplicate(regionId, point, 
-                               uniqueFound, idCount, tolerance, tolerance2);
+                                   uniqueFound, idCount, tolerance, tolerance2);
       }
 
     if (duplicateFound >= 0)
       {
-      uniqueIds->SetValue(currentId, this->LocatorIds[duplicateFound]);
+      map[currentId] = this->LocatorIds[duplicateFound];
       }
     else
       {
-      uniqueFound[regionId][idCount[regionId]++] = idx;
-      uniqueIds->SetValue(currentId, currentId);
+      uniqueFound[regionId][idCount[regionId]++] = idx2;
+      map[currentId] = currentId;
       }
 
-    // test the other points in this region
+    point += 3;
+    }
 
-    int numRegionPoints = this->RegionList[regionId]->GetNumberOfPoints();
+  return 1;
+}
 
-    int secondIdx = idx + 1;
-    int nextFirstIdx = idx + numRegionPoints;
+//----------------------------------------------------------------------------
+void vtkKdTree::MapDuplicatePointsTask(void *data, vtkIdType begin,
+                                       vtkIdType end)
+{
+  vtkKdTreeMapDuplicates *regions =
+    static_cast<vtkKdTreeMapDuplicates *>(data);
 
-    for (int idx2 = secondIdx ; idx2 < nextFirstIdx; idx2++)
+  for (vtkIdType i = begin; i < end; i++)
+    {
+    if (!regions->Tree->MapDuplicatePointsInRegion(static_cast<int>(i),
+                 regions->Map, regions->UniqueFound, regions->IdCount,
+                 0.0, 0.0))
       {
-      point += 3;
-      currentId = this->LocatorIds[idx2];
-
-      duplicateFound = this->SearchRegionForDuplicate(point,
-                            uniqueFound[regionId], idCount[regionId], tolerance2);
-
-      if ((tolerance > 0.0) && (duplicateFound < 0) && (regionId > 0)) 
-        {
-        duplicateFound =  this->SearchNeighborsForDuplicate(regionId, point, 
-                                     uniqueFound, idCount, tolerance, tolerance2);
-        }
-
-      if (duplicateFound >= 0)
-        {
-        uniqueIds->SetValue(currentId, this->LocatorIds[duplicateFound]);
-        }
-      else
-        {
-        uniqueFound[regionId][idCount[regionId]++] = idx2;
-        uniqueIds->SetValue(currentId, currentId);
-        }
+      regions->Failed = 1;
       }
-
-    idx = nextFirstIdx;
-    point += 3;
-    nextRegionId++;
-    }
-
-  for (i=0; i<this->NumberOfRegions; i++)
-    {
-    delete [] uniqueFound[i];
     }
-  delete [] uniqueFound;
-  delete [] idCount;
-
-  TIMERDONE("Find duplicate points");
-
-  return uniqueIds;
 }
 
 //----------------------------------------------------------------------------
@@ -2128,15 +2259,17 @@ int vtkKdTree::SearchNeighborsForDuplicate(int regionId, float *point,
 
   for (int reg=0; reg < nRegions; reg++)
     {
-    if ((regionIds[reg] == regionId)  || (len[reg] == 0) )
+    int neighbor = regionIds[reg];
+
+    if ((neighbor == regionId)  || (len[neighbor] == 0) )
       {
       continue;
       }
 
-    duplicateFound = this->SearchRegionForDuplicate(point,  pointsSoFar[reg], 
-                                                  len[reg], tolerance2);
+    duplicateFound = this->SearchRegionForDuplicate(point,
+                        pointsSoFar[neighbor], len[neighbor], tolerance2);
 
-    if (duplicateFound) 
+    if (duplicateFound >= 0) 
       {
       break;
       }
@@ -2396,12 +2529,11 @@ int vtkKdTree::FindClosestPointInSphere(double x, double y, double z,
 {
   int *regionIds = new int [this->NumberOfRegions];
 
-  this->BSPCalculator->ComputeIntersectionsUsingDataBoundsOn();
-
-  int nRegions = 
-    this->BSPCalculator->IntersectsSphere2(regionIds, this->NumberOfRegions, x, y, z, radius);
+  // Search the tree directly rather than with the BSPCalculator, so that
+  // several threads may look for points at once.
 
-  this->BSPCalculator->ComputeIntersectionsUsingDataBoundsOff();
+  int nRegions = vtkKdTree::FindRegionsInSphere2(this->Top, regionIds,
+                              this->NumberOfRegions, x, y, z, radius);
 
   double minDistance2 = 4 * this->MaxWidth * this->MaxWidth;
   int closeId = -1;
@@ -2432,6 +2564,183 @@ int vtkKdTree::FindClosestPointInSphere(double x, double y, double z,
   return closeId;
 }
 
+//----------------------------------------------------------------------------
+// Put in ids the IDs of the regions whose data bounds are within the
+// squared distance rSquared of the point, and return their number.
+int vtkKdTree::FindRegionsInSphere2(vtkKdNode *node, int *ids, int len,
+                                    double x, double y, double z,
+                                    double rSquared)
+{
+  if (len <= 0)
+    {
+    return 0;
+    }
+
+  double *min = node->GetMinDataBounds();
+  double *max = node->GetMaxDataBounds();
+  double p[3];
+  p[0] = x; p[1] = y; p[2] = z;
+  double dist2 = 0.0;
+
+  for (int i=0; i<3; i++)
+    {
+    double d = (p[i] < min[i]) ? (min[i] - p[i]) :
+               ((p[i] > max[i]) ? (p[i] - max[i]) : 0.0);
+    dist2 += d * d;
+    }
+
+  if (dist2 > rSquared)
+    {
+    return 0;
+    }
+
+  if (node->GetLeft() == NULL)
+    {
+    ids[0] = node->GetID();
+    return 1;
+    }
+
+  int nnodes = vtkKdTree::FindRegionsInSphere2(node->GetLeft(), ids, len,
+                                               x, y, z, rSquared);
+
+  nnodes += vtkKdTree::FindRegionsInSphere2(node->GetRight(), ids + nnodes,
+                                            len - nnodes, x, y, z, rSquared);
+
+  return nnodes;
+}
+
+//----------------------------------------------------------------------------
+void vtkKdTree::FindPointsWithinRadius(double R, const double x[3],
+                                       vtkIdList *result)
+{
+  result->Reset();
+
+  if (!this->LocatorPoints)
+    {
+    vtkErrorMacro(<< "vtkKdTree::FindPointsWithinRadius - must build locator first");
+    return;
+    }
+
+  double R2 = R * R;
+
+  int *regionIds = new int [this->NumberOfRegions];
+
+  int nRegions = vtkKdTree::FindRegionsInSphere2(this->Top, regionIds,
+                              this->NumberOfRegions, x[0], x[1], x[2], R2);
+
+  for (int reg=0; reg < nRegions; reg++)
+    {
+    int regionId = regionIds[reg];
+    int idx = this->LocatorRegionLocation[regionId];
+    int numPoints = this->RegionList[regionId]->GetNumberOfPoints();
+
+    float *candidate = this->LocatorPoints + (idx * 3);
+
+    for (int i=0; i < numPoints; i++)
+      {
+      double dx = x[0] - (double)candidate[0];
+      double dy = x[1] - (double)candidate[1];
+      double dz = x[2] - (double)candidate[2];
+
+      if (dx*dx + dy*dy + dz*dz <= R2)
+        {
+        result->InsertNextId((vtkIdType)this->LocatorIds[idx + i]);
+        }
+
+      candidate += 3;
+      }
+    }
+
+  delete [] regionIds;
+}
+
+//----------------------------------------------------------------------------
+void vtkKdTree::FindPoints(vtkPoints *points, vtkIdTypeArray *ids)
+{
+  vtkIdType numPoints = points->GetNumberOfPoints();
+
+  ids->SetNumberOfComponents(1);
+  ids->SetNumberOfTuples(numPoints);
+
+  if (!this->LocatorPoints)
+    {
+    vtkErrorMacro(<< "vtkKdTree::FindPoints - must build locator first");
+    ids->FillComponent(0, -1);
+    return;
+    }
+
+  vtkKdTreeFindPoints find;
+  find.Tree = this;
+  find.Points = points;
+  find.Ids = ids->GetPointer(0);
+  find.Dist2 = NULL;
+  find.Closest = 0;
+
+  vtkTaskScheduler::GetGlobalScheduler()->ParallelFor(
+    0, numPoints, 0, vtkKdTree::FindPointsTask, &find);
+}
+
+//----------------------------------------------------------------------------
+void vtkKdTree::FindClosestPoints(vtkPoints *points, vtkIdTypeArray *ids,
+                                  vtkDoubleArray *dist2)
+{
+  vtkIdType numPoints = points->GetNumberOfPoints();
+
+  ids->SetNumberOfComponents(1);
+  ids->SetNumberOfTuples(numPoints);
+
+  if (dist2)
+    {
+    dist2->SetNumberOfComponents(1);
+    dist2->SetNumberOfTuples(numPoints);
+    }
+
+  if (!this->LocatorPoints)
+    {
+    vtkErrorMacro(<< "vtkKdTree::FindClosestPoints - must build locator first");
+    ids->FillComponent(0, -1);
+    return;
+    }
+
+  vtkKdTreeFindPoints find;
+  find.Tree = this;
+  find.Points = points;
+  find.Ids = ids->GetPointer(0);
+  find.Dist2 = dist2 ? dist2->GetPointer(0) : NULL;
+  find.Closest = 1;
+
+  vtkTaskScheduler::GetGlobalScheduler()->ParallelFor(
+    0, numPoints, 0, vtkKdTree::FindPointsTask, &find);
+}
+
+//----------------------------------------------------------------------------
+void vtkKdTree::FindPointsTask(void *data, vtkIdType begin, vtkIdType end)
+{
+  vtkKdTreeFindPoints *find = static_cast<vtkKdTreeFindPoints *>(data);
+
+  double x[3];
+  double dist2;
+
+  for (vtkIdType i = begin; i < end; i++)
+    {
+    find->Points->GetPoint(i, x);
+
+    if (find->Closest)
+      {
+      find->Ids[i] = find->Tree->FindClosestPoint(x, dist2);
+
+      if (find->Dist2)
+        {
+        find->Dist2[i] = dist2;
+        }
+      }
+    else
+      {
+      find->Ids[i] = find->Tree->FindPoint(x);
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 vtkIdTypeArray *vtkKdTree::GetPointsInRegion(int regionId)
 {
@@ -47,6 +47,10 @@
 //     tolerance, or you can use FindPoint and FindClosestPoint to
 //     locate points in the original set that the tree was built from.
 //
+//     The subtrees of large regions are built, and the cell centers are
+//     computed, on the threads of the vtkTaskScheduler.  The tree is the
+//     same as when it is built serially.
+//
 // .SECTION See Also
 //      vtkLocator vtkCellLocator vtkPKdTree
 
@@ -56,6 +60,7 @@
 #include "vtkLocator.h"
 
 class vtkTimerLog;
+class vtkDoubleArray;
 class vtkIdList;
 class vtkIdTypeArray;
 class vtkIntArray;
@@ -389,6 +394,9 @@ public:
   //
   // You must have called BuildLocatorFromPoints() before calling this.
   // You are responsible for deleting the returned array.
+  //
+  // With a tolerance of zero the regions are searched in parallel, since
+  // equal points are always in the same region.
   vtkIdTypeArray *BuildMapForDuplicatePoints(float tolerance);
 
   // Description:
@@ -405,6 +413,21 @@ public:
   vtkIdType FindClosestPoint(double *x, double &dist2);
   vtkIdType FindClosestPoint(double x, double y, double z, double &dist2);
 
+  // Description:
+  // Find all points supplied to BuildLocatorFromPoints() that are
+  // within the distance R of x, inclusive, and put their Ids in
+  // result.  The Ids are in no particular order.
+  void FindPointsWithinRadius(double R, const double x[3], vtkIdList *result);
+
+  // Description:
+  // Batch versions of FindPoint() and FindClosestPoint().  Set ids,
+  // and dist2 if it is not NULL, to one value per point of points,
+  // computed on the threads of the vtkTaskScheduler.  The single
+  // point queries may also be called from several threads at once.
+  void FindPoints(vtkPoints *points, vtkIdTypeArray *ids);
+  void FindClosestPoints(vtkPoints *points, vtkIdTypeArray *ids,
+                         vtkDoubleArray *dist2);
+
   // Description:
   // Find the Id of the point in the given region which is
   // closest to the given point.  Return the ID of the point,
@@ -613,6 +636,20 @@ private:
 
   int FindClosestPointInSphere(double x, double y, double z, double radius,
                                int skipRegion, double &dist2);
+  static int FindRegionsInSphere2(vtkKdNode *node, int *ids, int len,
+                                  double x, double y, double z,
+                                  double rSquared);
+  int MapDuplicatePointsInRegion(int regionId, vtkIdType *map,
+                                 int **uniqueFound, int *idCount,
+                                 float tolerance, float tolerance2);
+//BTX
+  static void DivideRegionsTask(void *data, vtkIdType begin, vtkIdType end);
+  static void ComputeCellCentersTask(void *data, vtkIdType begin,
+                                     vtkIdType end);
+  static void MapDuplicatePointsTask(void *data, vtkIdType begin,
+                                     vtkIdType end);
+  static void FindPointsTask(void *data, vtkIdType begin, vtkIdType end);
+//ETX
 
   int _DepthOrderRegions(vtkIntArray *IdsOfInterest, double *dop,
                                 vtkIntArray *orderedList);
@@ -15,17 +15,27 @@
 #include "vtkProbeFilter.h"
 
 #include "vtkCell.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkScratchPool.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTaskScheduler.h"
+
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
 
 vtkCxxRevisionMacro(vtkProbeFilter, "1.82.12.2");
 vtkStandardNewMacro(vtkProbeFilter);
 
+// The largest number of points probed by a task.
+#define VTK_PROBE_FILTER_TASK_SIZE 4096
+
 //----------------------------------------------------------------------------
 vtkProbeFilter::vtkProbeFilter()
 {
@@ -135,32 +145,36 @@ void vtkProbeFilter::Probe(vtkDataSet *input, vtkDataSet *source,
   tol2 = source->GetLength();
   tol2 = tol2 ? tol2*tol2 / 1000.0 : 0.001;
 
-  // Loop over all input points, interpolating source data
+  // Loop over all input points, interpolating source data, unless the
+  // threads of the task scheduler probed them.
   //
-  int abort=0;
-  vtkIdType progressInterval=numPts/20 + 1;
-  for (ptId=0; ptId < numPts && !abort; ptId++)
+  if (!this->ProbeInParallel(input, source, outPD, tol2))
     {
-    if ( !(ptId % progressInterval) )
+    int abort=0;
+    vtkIdType progressInterval=numPts/20 + 1;
+    for (ptId=0; ptId < numPts && !abort; ptId++)
       {
-      this->UpdateProgress((double)ptId/numPts);
-      abort = GetAbortExecute();
-      }
+      if ( !(ptId % progressInterval) )
+        {
+        this->UpdateProgress((double)ptId/numPts);
+        abort = GetAbortExecute();
+        }
 
-    // Get the xyz coordinate of the point in the input dataset
-    input->GetPoint(ptId, x);
+      // Get the xyz coordinate of the point in the input dataset
+      input->GetPoint(ptId, x);
 
-    // Find the cell that contains xyz and get it
-    cell = source->FindAndGetCell(x,NULL,-1,tol2,subId,pcoords,weights);
-    if (cell)
-      {
-      // Interpolate the point data
-      outPD->InterpolatePoint(pd,ptId,cell->PointIds,weights);
-      this->ValidPoints->InsertNextValue(ptId);
-      }
-    else
-      {
-      outPD->NullPoint(ptId);
+      // Find the cell that contains xyz and get it
+      cell = source->FindAndGetCell(x,NULL,-1,tol2,subId,pcoords,weights);
+      if (cell)
+        {
+        // Interpolate the point data
+        outPD->InterpolatePoint(pd,ptId,cell->PointIds,weights);
+        this->ValidPoints->InsertNextValue(ptId);
+        }
+      else
+        {
+        outPD->NullPoint(ptId);
+        }
       }
     }
   // BUG FIX: JB.
@@ -179,6 +193,285 @@ void vtkProbeFilter::Probe(vtkDataSet *input, vtkDataSet *source,
     }
 }
 
+//----------------------------------------------------------------------------
+// What the tasks probing the points need.
+struct vtkProbeFilterTaskData
+{
+  vtkDataSet *Input;
+  vtkDataSet *Source;
+  vtkPointData *SourcePD;
+  vtkPointData *OutPD;
+  int CopyInput;  // copy the structure of Input in each task
+  int CopySource; // copy the structure of Source in each task
+  double Tol2;
+  int MaxCellSize;
+  double Bounds[6];
+  vtkIdType *Order;        // the points in probing order, or NULL
+  unsigned int *Codes;     // the Morton codes of the points
+  unsigned char *Valid;    // 1 for the points found in the source
+};
+
+//----------------------------------------------------------------------------
+// Spread the 10 low bits of i to every third bit.
+static unsigned int vtkProbeFilterSpreadBits(unsigned int i)
+{
+  i &= 0x3ff;
+  i = (i | (i << 16)) & 0x30000ff;
+  i = (i | (i << 8)) & 0x300f00f;
+  i = (i | (i << 4)) & 0x30c30c3;
+  i = (i | (i << 2)) & 0x9249249;
+  return i;
+}
+
+//----------------------------------------------------------------------------
+// Compute the Morton codes of the points [begin, end) on a 1024^3 grid
+// over the bounds of the input.
+static void vtkProbeFilterComputeCodes(void *arg, vtkIdType begin,
+                                       vtkIdType end)
+{
+  vtkProbeFilterTaskData *td = static_cast<vtkProbeFilterTaskData *>(arg);
+  double scale[3];
+  int i;
+  for (i = 0; i < 3; ++i)
+    {
+    double length = td->Bounds[2*i+1] - td->Bounds[2*i];
+    scale[i] = length > 0.0 ? 1023.0 / length : 0.0;
+    }
+  double x[3];
+  for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+    td->Input->GetPoint(ptId, x);
+    unsigned int code = 0;
+    for (i = 0; i < 3; ++i)
+      {
+      double q = (x[i] - td->Bounds[2*i]) * scale[i];
+      q = q < 0.0 ? 0.0 : (q > 1023.0 ? 1023.0 : q);
+      code |= vtkProbeFilterSpreadBits(static_cast<unsigned int>(q)) << i;
+      }
+    td->Codes[ptId] = code;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Orders the points by Morton code, then by id.
+class vtkProbeFilterCodeLess
+{
+public:
+  vtkProbeFilterCodeLess(const unsigned int *codes) : Codes(codes) {}
+  bool operator()(vtkIdType a, vtkIdType b) const
+    {
+    return this->Codes[a] < this->Codes[b] ||
+      (this->Codes[a] == this->Codes[b] && a < b);
+    }
+  const unsigned int *Codes;
+};
+
+//----------------------------------------------------------------------------
+// Return a new dataset with the structure of ds.  Image data and
+// rectilinear grids keep the cells returned by FindAndGetCell() and the
+// point returned by GetPoint() in the dataset, so each task uses its own.
+static vtkDataSet *vtkProbeFilterCopyStructure(vtkDataSet *ds)
+{
+  vtkDataSet *copy = ds->NewInstance();
+  copy->CopyStructure(ds);
+  return copy;
+}
+
+//----------------------------------------------------------------------------
+// Probe the points at [begin, end) of the probing order.  This is the
+// loop of vtkProbeFilter::Probe() with thread safe locating: point sets
+// are given a generic cell of the thread, which FindCell() leaves with
+// the cell it found, and other datasets are copied.
+static void vtkProbeFilterProbePoints(void *arg, vtkIdType begin,
+                                      vtkIdType end)
+{
+  vtkProbeFilterTaskData *td = static_cast<vtkProbeFilterTaskData *>(arg);
+  vtkDataSet *input = td->Input;
+  vtkDataSet *source = td->Source;
+  if (td->CopyInput)
+    {
+    input = vtkProbeFilterCopyStructure(td->Input);
+    }
+  if (td->CopySource)
+    {
+    source = vtkProbeFilterCopyStructure(td->Source);
+    }
+
+  double fastweights[256];
+  double *weights = fastweights;
+  if (td->MaxCellSize > 256)
+    {
+    weights = new double[td->MaxCellSize];
+    }
+  vtkScratchPool *pool = vtkScratchPool::GetThreadPool();
+  vtkGenericCell *gencell = pool->AcquireGenericCell();
+
+  // The tuple written to points outside of the source.  The arrays are
+  // reached by index, since vtkPointData::NullPoint() registers the
+  // output point data and allocates a tuple for each point.
+  int numArrays = td->OutPD->GetNumberOfArrays();
+  int i, maxComponents = 1;
+  for (i = 0; i < numArrays; ++i)
+    {
+    int numComponents = td->OutPD->GetArray(i)->GetNumberOfComponents();
+    maxComponents = (numComponents > maxComponents ?
+                     numComponents : maxComponents);
+    }
+  vtkstd::vector<double> nullTuple(maxComponents, 0.0);
+
+  double x[3];
+  double pcoords[3];
+  int subId;
+  for (vtkIdType idx = begin; idx < end; ++idx)
+    {
+    vtkIdType ptId = td->Order ? td->Order[idx] : idx;
+    input->GetPoint(ptId, x);
+
+    vtkCell *cell = NULL;
+    if (td->CopySource)
+      {
+      cell = source->FindAndGetCell(x, NULL, -1, td->Tol2, subId, pcoords,
+                                    weights);
+      }
+    else if (source->FindCell(x, NULL, gencell, -1, td->Tol2, subId,
+                              pcoords, weights) >= 0)
+      {
+      cell = gencell;
+      }
+    if (cell)
+      {
+      td->OutPD->InterpolatePoint(td->SourcePD, ptId, cell->PointIds,
+                                  weights);
+      td->Valid[ptId] = 1;
+      }
+    else
+      {
+      for (i = 0; i < numArrays; ++i)
+        {
+        td->OutPD->GetArray(i)->SetTuple(ptId, &nullTuple[0]);
+        }
+      }
+    }
+
+  pool->ReleaseGenericCell(gencell);
+  if (weights != fastweights)
+    {
+    delete [] weights;
+    }
+  if (source != td->Source)
+    {
+    source->Delete();
+    }
+  if (input != td->Input)
+    {
+    input->Delete();
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkProbeFilter::ProbeInParallel(vtkDataSet *input, vtkDataSet *source,
+                                    vtkPointData *outPD, double tol2)
+{
+  vtkTaskScheduler *scheduler = vtkTaskScheduler::GetGlobalScheduler();
+  vtkIdType numPts = input->GetNumberOfPoints();
+  if (scheduler->GetNumberOfThreads() < 2 ||
+      numPts <= VTK_PROBE_FILTER_TASK_SIZE ||
+      source->IsA("vtkStructuredGrid"))
+    {
+    return 0;
+    }
+  int i;
+  for (i = 0; i < outPD->GetNumberOfArrays(); ++i)
+    {
+    if (outPD->GetArray(i)->GetDataType() == VTK_BIT)
+      {
+      return 0;
+      }
+    }
+
+  vtkDebugMacro(<<"Probing " << numPts << " points on "
+                << scheduler->GetNumberOfThreads() << " threads");
+
+  // The tasks write each point once, into arrays that already hold them.
+  for (i = 0; i < outPD->GetNumberOfArrays(); ++i)
+    {
+    outPD->GetArray(i)->SetNumberOfTuples(numPts);
+    }
+
+  vtkProbeFilterTaskData td;
+  td.Input = input;
+  td.Source = source;
+  td.SourcePD = source->GetPointData();
+  td.OutPD = outPD;
+  td.CopyInput = !input->IsA("vtkPointSet");
+  td.CopySource = !source->IsA("vtkPointSet");
+  td.Tol2 = tol2;
+  td.MaxCellSize = source->GetMaxCellSize();
+  td.Order = NULL;
+  td.Codes = NULL;
+  vtkstd::vector<unsigned char> valid(numPts, 0);
+  td.Valid = &valid[0];
+
+  // Build the point locator and the links of the source here, since
+  // FindCell() builds them on first use.
+  if (!td.CopySource && source->GetNumberOfPoints() > 0)
+    {
+    vtkIdList *cellIds = vtkIdList::New();
+    source->GetPointCells(0, cellIds);
+    cellIds->Delete();
+    double x[3];
+    source->GetPoint(0, x);
+    source->FindPoint(x);
+    }
+
+  // The points of structured inputs are already in a coherent order.
+  vtkstd::vector<vtkIdType> order;
+  if (input->IsA("vtkPolyData") || input->IsA("vtkUnstructuredGrid"))
+    {
+    vtkstd::vector<unsigned int> codes(numPts);
+    input->GetBounds(td.Bounds);
+    td.Codes = &codes[0];
+    scheduler->ParallelFor(0, numPts, VTK_PROBE_FILTER_TASK_SIZE,
+                           vtkProbeFilterComputeCodes, &td);
+    order.resize(numPts);
+    for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+      {
+      order[ptId] = ptId;
+      }
+    vtkstd::sort(order.begin(), order.end(),
+                 vtkProbeFilterCodeLess(td.Codes));
+    td.Codes = NULL;
+    td.Order = &order[0];
+    }
+
+  // Probe a twentieth of the points at a time, reporting progress and
+  // checking for abort in between like the serial loop.
+  vtkIdType progressInterval = numPts/20 + 1;
+  int abort = 0;
+  for (vtkIdType begin = 0; begin < numPts && !abort;
+       begin += progressInterval)
+    {
+    this->UpdateProgress((double)begin/numPts);
+    abort = this->GetAbortExecute();
+    if (!abort)
+      {
+      vtkIdType end = begin + progressInterval;
+      scheduler->ParallelFor(begin, end < numPts ? end : numPts,
+                             VTK_PROBE_FILTER_TASK_SIZE,
+                             vtkProbeFilterProbePoints, &td);
+      }
+    }
+
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+    {
+    if (valid[ptId])
+      {
+      this->ValidPoints->InsertNextValue(ptId);
+      }
+    }
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 int vtkProbeFilter::RequestInformation(
   vtkInformation *vtkNotUsed(request),
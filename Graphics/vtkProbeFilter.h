@@ -27,6 +27,18 @@
 // rendering techniques can be used to visualize the results. Another example:
 // a line or curve can be used to probe data to produce x-y plots along
 // that line or curve.
+//
+// When the vtkTaskScheduler has more than one thread, the points are
+// probed on its threads and the output is the same as with one thread.
+// The points of poly data and unstructured grid inputs are probed in
+// Morton (Z curve) order, so that nearby points are probed together.
+// Poly data and unstructured grid sources share their point locator and
+// links among the threads; other sources, except structured grids,
+// are copied for each task.  Structured grid sources and outputs with
+// bit arrays are probed on one thread.
+
+// .SECTION See Also
+// vtkPProbeFilter vtkTaskScheduler
 
 #ifndef __vtkProbeFilter_h
 #define __vtkProbeFilter_h
@@ -34,6 +46,7 @@
 #include "vtkDataSetAlgorithm.h"
 
 class vtkIdTypeArray;
+class vtkPointData;
 
 class VTK_GRAPHICS_EXPORT vtkProbeFilter : public vtkDataSetAlgorithm
 {
@@ -83,6 +96,14 @@ protected:
 
   void Probe(vtkDataSet *input, vtkDataSet *source, vtkDataSet *output);
 
+  // Description:
+  // Probe the points of input on the threads of the task scheduler, if
+  // the source and the output allow it, and return 1.  Return 0 without
+  // probing otherwise.  The output point data must be allocated for
+  // the points of input.
+  int ProbeInParallel(vtkDataSet *input, vtkDataSet *source,
+                      vtkPointData *outPD, double tol2);
+
   vtkIdTypeArray *ValidPoints;
 private:
   vtkProbeFilter(const vtkProbeFilter&);  // Not implemented.
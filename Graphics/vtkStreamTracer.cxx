@@ -34,6 +34,7 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkRungeKutta2.h"
 #include "vtkRungeKutta4.h"
 #include "vtkRungeKutta45.h"
+#include "vtkTaskScheduler.h"
 
 vtkCxxRevisionMacro(vtkStreamTracer, "1.35.6.1");
 vtkStandardNewMacro(vtkStreamTracer);
@@ -70,6 +71,7 @@ vtkStreamTracer::vtkStreamTracer()
 
   this->ComputeVorticity = 1;
   this->RotationScale = 1.0;
+  this->ThreadedIntegration = 1;
 
   this->LastUsedTimeStep = 0.0;
 
@@ -633,9 +635,58 @@ int vtkStreamTracer::CheckInputs(vtkInterpolatedVelocityField*& func,
   return VTK_OK;
 }
 
+// The streamlines of a range of seeds, with what is needed to integrate
+// them.  When the seeds are integrated one after the other, the outputs
+// are those of the filter.
+class vtkStreamTracerLines
+{
+public:
+  vtkDataArray* SeedSource;
+  vtkIdList* SeedIds;
+  vtkIntArray* IntegrationDirections;
+  const char* VecName;
+  vtkIdType Begin;
+  vtkIdType End;
+  int ReportProgress;
+  int MaxCellSize;
+
+  vtkInterpolatedVelocityField* Func;
+  vtkDataSet* DataSet; // copy of the input given to Func, if any
+  vtkInitialValueProblemSolver* Integrator;
+  vtkGenericCell* Cell;
+  double* Weights;
+  vtkDoubleArray* CellVectors;
+
+  vtkPoints* Points;
+  vtkCellArray* Lines;
+  vtkDataSetAttributes* PointData;
+  vtkDoubleArray* Time;
+  vtkIntArray* RetVals;
+  vtkDoubleArray* Vorticity;
+  vtkDoubleArray* Rotation;
+  vtkDoubleArray* AngularVel;
+
+  double LastPoint[3];
+  int LastPointSet;
+  double LastUsedTimeStep;
+  int LastUsedTimeStepSet;
+  int Abort;
+};
+
+// The ranges of seeds integrated together on the threads.
+struct vtkStreamTracerTaskData
+{
+  vtkStreamTracer* Self;
+  vtkStreamTracerLines* Ranges;
+};
+
+// The number of ranges of seeds for each thread.  Streamlines differ in
+// length, so there are more ranges than threads to balance the work.
+#define VTK_STREAM_TRACER_RANGES_PER_THREAD 8
+
 void vtkStreamTracer::Integrate(vtkDataSet *input0,
                                 vtkPolyData* output,
-                                vtkDataArray* seedSource, 
+                                vtkDataArray* seedSource,
                                 vtkIdList* seedIds,
                                 vtkIntArray* integrationDirections,
                                 double lastPoint[3],
@@ -643,17 +694,11 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
                                 int maxCellSize,
                                 const char *vecName)
 {
-  int i;
   vtkIdType numLines = seedIds->GetNumberOfIds();
 
   // Useful pointers
   vtkDataSetAttributes* outputPD = output->GetPointData();
   vtkDataSetAttributes* outputCD = output->GetCellData();
-  vtkPointData* inputPD;
-  vtkDataSet* input;
-  vtkDataArray* inVectors;
-
-  int direction=1;
 
   double* weights = 0;
   if ( maxCellSize > 0 )
@@ -667,11 +712,11 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
     return;
     }
 
-  // Used in GetCell() 
+  // Used in GetCell()
   vtkGenericCell* cell = vtkGenericCell::New();
 
   // Create a new integrator, the type is the same as Integrator
-  vtkInitialValueProblemSolver* integrator = 
+  vtkInitialValueProblemSolver* integrator =
     this->GetIntegrator()->NewInstance();
   integrator->SetFunctionSet(func);
 
@@ -701,7 +746,7 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
     cellVectors = vtkDoubleArray::New();
     cellVectors->SetNumberOfComponents(3);
     cellVectors->Allocate(3*VTK_CELL_SIZE);
-    
+
     vorticity = vtkDoubleArray::New();
     vorticity->SetName("Vorticity");
     vorticity->SetNumberOfComponents(3);
@@ -712,7 +757,7 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
     angularVel = vtkDoubleArray::New();
     angularVel->SetName("AngularVelocity");
     }
-  
+
   // We will interpolate all point attributes of the input on
   // each point of the output (unless they are turned off)
   // Note that we are using only the first input, if there are more
@@ -721,18 +766,150 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
   // Note:  It is an overestimation to have the estimate the same number of
   // output points and input points.  We sill have to squeeze at end.
 
-  vtkIdType numPtsTotal=0;
-  double velocity[3];
+  vtkStreamTracerLines lines;
+  lines.SeedSource = seedSource;
+  lines.SeedIds = seedIds;
+  lines.IntegrationDirections = integrationDirections;
+  lines.VecName = vecName;
+  lines.Begin = 0;
+  lines.End = numLines;
+  lines.ReportProgress = 1;
+  lines.MaxCellSize = maxCellSize;
+  lines.Func = func;
+  lines.DataSet = 0;
+  lines.Integrator = integrator;
+  lines.Cell = cell;
+  lines.Weights = weights;
+  lines.CellVectors = cellVectors;
+  lines.Points = outputPoints;
+  lines.Lines = outputLines;
+  lines.PointData = outputPD;
+  lines.Time = time;
+  lines.RetVals = retVals;
+  lines.Vorticity = vorticity;
+  lines.Rotation = rotation;
+  lines.AngularVel = angularVel;
+  lines.LastPointSet = 0;
+  lines.LastUsedTimeStepSet = 0;
+  lines.Abort = 0;
+
+  int shouldAbort;
+  int threaded = 0;
+  if (this->ThreadedIntegration)
+    {
+    threaded = this->IntegrateInThreads(input0, &lines);
+    }
+  if (threaded)
+    {
+    shouldAbort = (threaded < 0);
+    }
+  else
+    {
+    this->IntegrateLines(&lines);
+    shouldAbort = lines.Abort;
+    }
+  if (lines.LastPointSet)
+    {
+    memcpy(lastPoint, lines.LastPoint, 3*sizeof(double));
+    }
+  if (lines.LastUsedTimeStepSet)
+    {
+    this->LastUsedTimeStep = lines.LastUsedTimeStep;
+    }
 
-  int shouldAbort = 0;
+  if (!shouldAbort)
+    {
+    // Create the output polyline
+    output->SetPoints(outputPoints);
+    outputPD->AddArray(time);
+    if (vorticity)
+      {
+      outputPD->AddArray(vorticity);
+      outputPD->AddArray(rotation);
+      outputPD->AddArray(angularVel);
+      }
 
-  for(int currentLine = 0; currentLine < numLines; currentLine++)
+    vtkIdType numPts = outputPoints->GetNumberOfPoints();
+    if ( numPts > 1 )
+      {
+      // Assign geometry and attributes
+      output->SetLines(outputLines);
+      if (this->GenerateNormalsInIntegrate)
+        {
+        this->GenerateNormals(output, 0, vecName);
+        }
+
+      outputCD->AddArray(retVals);
+      }
+    }
+
+  if (vorticity)
+    {
+    vorticity->Delete();
+    rotation->Delete();
+    angularVel->Delete();
+    }
+
+  if (cellVectors)
+    {
+    cellVectors->Delete();
+    }
+  retVals->Delete();
+
+  outputPoints->Delete();
+  outputLines->Delete();
+
+  time->Delete();
+
+
+  integrator->Delete();
+  cell->Delete();
+
+  delete[] weights;
+
+  output->Squeeze();
+  return;
+}
+
+void vtkStreamTracer::IntegrateLines(vtkStreamTracerLines *lines)
+{
+  int i;
+  vtkIdType numLines = lines->SeedIds->GetNumberOfIds();
+
+  // Useful pointers
+  vtkInterpolatedVelocityField* func = lines->Func;
+  vtkInitialValueProblemSolver* integrator = lines->Integrator;
+  vtkGenericCell* cell = lines->Cell;
+  double* weights = lines->Weights;
+  vtkDoubleArray* cellVectors = lines->CellVectors;
+  vtkPoints* outputPoints = lines->Points;
+  vtkCellArray* outputLines = lines->Lines;
+  vtkDataSetAttributes* outputPD = lines->PointData;
+  vtkDoubleArray* time = lines->Time;
+  vtkIntArray* retVals = lines->RetVals;
+  vtkDoubleArray* vorticity = lines->Vorticity;
+  vtkDoubleArray* rotation = lines->Rotation;
+  vtkDoubleArray* angularVel = lines->AngularVel;
+  vtkPointData* inputPD;
+  vtkDataSet* input;
+  vtkDataArray* inVectors;
+
+  int direction=1;
+
+  vtkIdType numPtsTotal=outputPoints->GetNumberOfPoints();
+  double velocity[3];
+
+  for(vtkIdType currentLine = lines->Begin; currentLine < lines->End;
+      currentLine++)
     {
 
     double progress = static_cast<double>(currentLine)/numLines;
-    this->UpdateProgress(progress);
+    if (lines->ReportProgress)
+      {
+      this->UpdateProgress(progress);
+      }
 
-    switch (integrationDirections->GetValue(currentLine))
+    switch (lines->IntegrationDirections->GetValue(currentLine))
       {
       case FORWARD:
         direction = 1;
@@ -745,13 +922,13 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
     // temporary variables used in the integration
     double point1[3], point2[3], pcoords[3], vort[3], omega;
     vtkIdType index, numPts=0;
-    
+
     // Clear the last cell to avoid starting a search from
     // the last point in the streamline
     func->ClearLastCellId();
 
     // Initial point
-    seedSource->GetTuple(seedIds->GetId(currentLine), point1);
+    lines->SeedSource->GetTuple(lines->SeedIds->GetId(currentLine), point1);
     memcpy(point2, point1, 3*sizeof(double));
     if (!func->FunctionValues(point1, velocity))
       {
@@ -764,7 +941,7 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
     time->InsertNextValue(0.0);
 
     // We will always pass a time step to the integrator.
-    // If the user specifies a step size with another unit, we will 
+    // If the user specifies a step size with another unit, we will
     // have to convert it to time.
     IntervalInformation delT;
     delT.Unit = TIME_UNIT;
@@ -780,7 +957,7 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
     // Make sure we use the dataset found by the vtkInterpolatedVelocityField
     input = func->GetLastDataSet();
     inputPD = input->GetPointData();
-    inVectors = inputPD->GetVectors(vecName);
+    inVectors = inputPD->GetVectors(lines->VecName);
 
     // Convert intervals to time unit
     input->GetCell(func->GetLastCellId(), cell);
@@ -790,14 +967,14 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
     // Never call conversion methods if speed == 0
     if (speed != 0.0)
       {
-      this->ConvertIntervals(delT.Interval, minStep, maxStep, direction, 
+      this->ConvertIntervals(delT.Interval, minStep, maxStep, direction,
                              cellLength, speed);
       }
 
     // Interpolate all point attributes on first point
     func->GetLastWeights(weights);
     outputPD->InterpolatePoint(inputPD, nextPoint, cell->PointIds, weights);
-    
+
     // Compute vorticity if required
     // This can be used later for streamribbon generation.
     if (this->ComputeVorticity)
@@ -824,7 +1001,7 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
 
     vtkIdType numSteps = 0;
     double error = 0;
-    // Integrate until the maximum propagation length is reached, 
+    // Integrate until the maximum propagation length is reached,
     // maximum number of steps is reached or until a boundary is encountered.
     // Begin Integration
     while ( propagation < this->MaximumPropagation.Interval )
@@ -836,16 +1013,16 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
         break;
         }
 
-      if ( numSteps++ % 1000 == 1 )
+      if ( numSteps++ % 1000 == 1 && lines->ReportProgress )
         {
-        progress = 
+        progress =
           (currentLine + propagation / this->MaximumPropagation.Interval) /
           numLines ;
         this->UpdateProgress(progress);
 
         if (this->GetAbortExecute())
           {
-          shouldAbort = 1;
+          lines->Abort = 1;
           break;
           }
         }
@@ -859,10 +1036,10 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
 
       // If, with the next step, propagation will be larger than
       // max, reduce it so that it is (approximately) equal to max.
-      aStep.Interval = fabs(this->ConvertToUnit(delT, 
+      aStep.Interval = fabs(this->ConvertToUnit(delT,
                                                 this->MaximumPropagation.Unit,
                                                 cellLength, speed));
-      if ( (propagation + aStep.Interval) >  
+      if ( (propagation + aStep.Interval) >
            this->MaximumPropagation.Interval )
         {
         aStep.Interval = this->MaximumPropagation.Interval - propagation;
@@ -876,17 +1053,19 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
           }
         maxStep = delT.Interval;
         }
-      this->LastUsedTimeStep = delT.Interval;
-          
+      lines->LastUsedTimeStep = delT.Interval;
+      lines->LastUsedTimeStepSet = 1;
+
       // Calculate the next step using the integrator provided
       // Break if the next point is out of bounds.
       if ((tmp=
-           integrator->ComputeNextStep(point1, point2, 0, delT.Interval, 
-                                       stepTaken, minStep, maxStep, 
+           integrator->ComputeNextStep(point1, point2, 0, delT.Interval,
+                                       stepTaken, minStep, maxStep,
                                        this->MaximumError, error)) != 0)
         {
         retVal = tmp;
-        memcpy(lastPoint, point2, 3*sizeof(double));
+        memcpy(lines->LastPoint, point2, 3*sizeof(double));
+        lines->LastPointSet = 1;
         break;
         }
 
@@ -898,7 +1077,7 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
         {
         disp[i] = point2[i] - point1[i];
         }
-      if ( (delT.Interval == 0) ||  
+      if ( (delT.Interval == 0) ||
            (vtkMath::Norm(disp) / fabs(delT.Interval) <= this->TerminalSpeed) )
         {
         retVal = STAGNATION;
@@ -907,7 +1086,7 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
 
       accumTime += stepTaken;
       // Calculate propagation (using the same units as MaximumPropagation
-      propagation += fabs(this->ConvertToUnit(delT, 
+      propagation += fabs(this->ConvertToUnit(delT,
                                               this->MaximumPropagation.Unit,
                                               cellLength, speed));
 
@@ -923,13 +1102,14 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
       if ( !func->FunctionValues(point2, velocity) )
         {
         retVal = OUT_OF_DOMAIN;
-        memcpy(lastPoint, point2, 3*sizeof(double));
+        memcpy(lines->LastPoint, point2, 3*sizeof(double));
+        lines->LastPointSet = 1;
         break;
         }
       // Make sure we use the dataset found by the vtkInterpolatedVelocityField
       input = func->GetLastDataSet();
       inputPD = input->GetPointData();
-      inVectors = inputPD->GetVectors(vecName);
+      inVectors = inputPD->GetVectors(lines->VecName);
 
       // Point is valid. Insert it.
       numPts++;
@@ -962,7 +1142,7 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
         omega *= this->RotationScale;
         index = angularVel->InsertNextValue(omega);
         rotation->InsertNextValue(rotation->GetValue(index-1) +
-                                  (angularVel->GetValue(index-1) + omega)/2 * 
+                                  (angularVel->GetValue(index-1) + omega)/2 *
                                   (accumTime - time->GetValue(index-1)));
         }
 
@@ -974,12 +1154,12 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
         }
 
       // Convert all intervals to time
-      this->ConvertIntervals(step, minStep, maxStep, direction, 
+      this->ConvertIntervals(step, minStep, maxStep, direction,
                              cellLength, speed);
 
 
       // If the solver is adaptive and the next time step (delT.Interval)
-      // that the solver wants to use is smaller than minStep or larger 
+      // that the solver wants to use is smaller than minStep or larger
       // than maxStep, re-adjust it. This has to be done every step
       // because minStep and maxStep can change depending on the cell
       // size (unless it is specified in time units)
@@ -1002,7 +1182,7 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
       // End Integration
       }
 
-    if (shouldAbort)
+    if (lines->Abort)
       {
       break;
       }
@@ -1017,59 +1197,218 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
       retVals->InsertNextValue(retVal);
       }
     }
+}
 
-  if (!shouldAbort)
+// Append the tuples of from to to, which have the same type and number
+// of components.
+static void vtkStreamTracerAppendArray(vtkDataArray* to, vtkDataArray* from)
+{
+  vtkIdType numTuples = from->GetNumberOfTuples();
+  if (numTuples == 0)
     {
-    // Create the output polyline
-    output->SetPoints(outputPoints);
-    outputPD->AddArray(time);
-    if (vorticity)
+    return;
+    }
+  if (from->GetDataType() == VTK_BIT)
+    {
+    for (vtkIdType i = 0; i < numTuples; i++)
       {
-      outputPD->AddArray(vorticity);
-      outputPD->AddArray(rotation);
-      outputPD->AddArray(angularVel);
+      to->InsertNextTuple(from->GetTuple(i));
       }
-    
-    vtkIdType numPts = outputPoints->GetNumberOfPoints();
-    if ( numPts > 1 )
-      {
-      // Assign geometry and attributes
-      output->SetLines(outputLines);
-      if (this->GenerateNormalsInIntegrate)
-        {
-        this->GenerateNormals(output, 0, vecName);
-        }
+    return;
+    }
+  vtkIdType numValues = numTuples*from->GetNumberOfComponents();
+  void* dest = to->WriteVoidPointer(
+    to->GetNumberOfTuples()*to->GetNumberOfComponents(), numValues);
+  memcpy(dest, from->GetVoidPointer(0), numValues*from->GetDataTypeSize());
+}
 
-      outputCD->AddArray(retVals);
-      }
+void vtkStreamTracer::IntegrateLinesTask(void *arg, vtkIdType begin,
+                                         vtkIdType end)
+{
+  vtkStreamTracerTaskData* td = static_cast<vtkStreamTracerTaskData*>(arg);
+  for (vtkIdType range = begin; range < end; range++)
+    {
+    td->Self->IntegrateLines(td->Ranges + range);
     }
+}
 
-  if (vorticity)
+int vtkStreamTracer::IntegrateInThreads(vtkDataSet *input,
+                                        vtkStreamTracerLines *lines)
+{
+  vtkTaskScheduler* scheduler = vtkTaskScheduler::GetGlobalScheduler();
+  int numThreads = scheduler->GetNumberOfThreads();
+  vtkIdType numLines = lines->SeedIds->GetNumberOfIds();
+
+  // With several inputs, where a streamline starts depends on where the
+  // previous one ended.  vtkStructuredGrid::GetCell() changes the grid.
+  if (numThreads < 2 || numLines < 2 ||
+      this->GetNumberOfInputConnections(0) != 1 ||
+      !(input->IsA("vtkUnstructuredGrid") || input->IsA("vtkPolyData") ||
+        input->IsA("vtkImageData") || input->IsA("vtkRectilinearGrid")))
     {
-    vorticity->Delete();
-    rotation->Delete();
-    angularVel->Delete();
+    return 0;
     }
 
-  if (cellVectors)
+  vtkDebugMacro(<<"Integrating " << numLines << " seeds on "
+                << numThreads << " threads");
+
+  // The bounds, and the point locator and links used by FindCell(), are
+  // built here since the datasets build them on first use.  The other
+  // datasets change when they locate points, so each range gets a copy.
+  int copyInput = !input->IsA("vtkPointSet");
+  input->GetLength();
+  if (!copyInput && input->GetNumberOfPoints() > 0)
     {
-    cellVectors->Delete();
+    vtkIdList* cellIds = vtkIdList::New();
+    input->GetPointCells(0, cellIds);
+    cellIds->Delete();
+    double x[3];
+    input->GetPoint(0, x);
+    input->FindPoint(x);
     }
-  retVals->Delete();
 
-  outputPoints->Delete();
-  outputLines->Delete();
+  vtkIdType numRanges = numThreads*VTK_STREAM_TRACER_RANGES_PER_THREAD;
+  numRanges = (numRanges < numLines ? numRanges : numLines);
+  vtkIdType rangesPerRound = 2*numThreads;
+  vtkStreamTracerLines* ranges = new vtkStreamTracerLines[rangesPerRound];
+  vtkStreamTracerTaskData td;
+  td.Self = this;
+  td.Ranges = ranges;
+
+  // Integrate a few ranges per thread at a time, reporting progress and
+  // checking for abort in between.
+  int abort = 0;
+  for (vtkIdType first = 0; first < numRanges && !abort;
+       first += rangesPerRound)
+    {
+    vtkIdType numRound = numRanges - first;
+    numRound = (numRound < rangesPerRound ? numRound : rangesPerRound);
+    this->UpdateProgress(static_cast<double>(first)/numRanges);
+    abort = this->GetAbortExecute();
+    if (abort)
+      {
+      break;
+      }
 
-  time->Delete();
+    vtkIdType r;
+    for (r = 0; r < numRound; r++)
+      {
+      vtkStreamTracerLines* range = ranges + r;
+      *range = *lines;
+      range->Begin = (first + r)*numLines/numRanges;
+      range->End = (first + r + 1)*numLines/numRanges;
+      range->ReportProgress = 0;
+      range->Func = lines->Func->NewInstance();
+      range->Func->CopyParameters(lines->Func);
+      range->Func->SelectVectors(lines->VecName);
+      range->DataSet = 0;
+      if (copyInput)
+        {
+        range->DataSet = input->NewInstance();
+        range->DataSet->ShallowCopy(input);
+        range->DataSet->GetLength();
+        }
+      range->Func->AddDataSet(range->DataSet ? range->DataSet : input);
+      range->Integrator = lines->Integrator->NewInstance();
+      range->Integrator->SetFunctionSet(range->Func);
+      range->Cell = vtkGenericCell::New();
+      range->Weights = 0;
+      if (lines->MaxCellSize > 0)
+        {
+        range->Weights = new double[lines->MaxCellSize];
+        }
+      if (lines->CellVectors)
+        {
+        range->CellVectors = vtkDoubleArray::New();
+        range->CellVectors->SetNumberOfComponents(3);
+        range->CellVectors->Allocate(3*VTK_CELL_SIZE);
+        }
+      range->Points = vtkPoints::New();
+      range->Points->SetDataType(lines->Points->GetDataType());
+      range->Lines = vtkCellArray::New();
+      range->PointData = vtkPointData::New();
+      range->PointData->InterpolateAllocate(input->GetPointData());
+      range->Time = vtkDoubleArray::New();
+      range->RetVals = vtkIntArray::New();
+      if (lines->Vorticity)
+        {
+        range->Vorticity = vtkDoubleArray::New();
+        range->Vorticity->SetNumberOfComponents(3);
+        range->Rotation = vtkDoubleArray::New();
+        range->AngularVel = vtkDoubleArray::New();
+        }
+      range->LastPointSet = 0;
+      range->LastUsedTimeStepSet = 0;
+      }
 
+    scheduler->ParallelFor(0, numRound, 1,
+                           vtkStreamTracer::IntegrateLinesTask, &td);
 
-  integrator->Delete();
-  cell->Delete();
+    // Append the streamlines in the order of the seeds.
+    for (r = 0; r < numRound; r++)
+      {
+      vtkStreamTracerLines* range = ranges + r;
+      vtkIdType offset = lines->Points->GetNumberOfPoints();
+      vtkStreamTracerAppendArray(lines->Points->GetData(),
+                                 range->Points->GetData());
+      int numArrays = lines->PointData->GetNumberOfArrays();
+      for (int a = 0; a < numArrays; a++)
+        {
+        vtkStreamTracerAppendArray(lines->PointData->GetArray(a),
+                                   range->PointData->GetArray(a));
+        }
+      vtkStreamTracerAppendArray(lines->Time, range->Time);
+      vtkStreamTracerAppendArray(lines->RetVals, range->RetVals);
+      vtkIdType npts;
+      vtkIdType* pts;
+      range->Lines->InitTraversal();
+      while (range->Lines->GetNextCell(npts, pts))
+        {
+        lines->Lines->InsertNextCell(npts);
+        for (vtkIdType i = 0; i < npts; i++)
+          {
+          lines->Lines->InsertCellPoint(pts[i] + offset);
+          }
+        }
+      if (lines->Vorticity)
+        {
+        vtkStreamTracerAppendArray(lines->Vorticity, range->Vorticity);
+        vtkStreamTracerAppendArray(lines->Rotation, range->Rotation);
+        vtkStreamTracerAppendArray(lines->AngularVel, range->AngularVel);
+        range->Vorticity->Delete();
+        range->Rotation->Delete();
+        range->AngularVel->Delete();
+        range->CellVectors->Delete();
+        }
+      if (range->LastPointSet)
+        {
+        memcpy(lines->LastPoint, range->LastPoint, 3*sizeof(double));
+        lines->LastPointSet = 1;
+        }
+      if (range->LastUsedTimeStepSet)
+        {
+        lines->LastUsedTimeStep = range->LastUsedTimeStep;
+        lines->LastUsedTimeStepSet = 1;
+        }
 
-  delete[] weights;
-  
-  output->Squeeze();
-  return;
+      range->Points->Delete();
+      range->Lines->Delete();
+      range->PointData->Delete();
+      range->Time->Delete();
+      range->RetVals->Delete();
+      delete [] range->Weights;
+      range->Cell->Delete();
+      range->Integrator->Delete();
+      range->Func->Delete();
+      if (range->DataSet)
+        {
+        range->DataSet->Delete();
+        }
+      }
+    }
+
+  delete [] ranges;
+  return abort ? -1 : 1;
 }
 
 void vtkStreamTracer::GenerateNormals(vtkPolyData* output, double* firstNormal, 
@@ -1325,4 +1664,6 @@ void vtkStreamTracer::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Vorticity computation: " 
      << (this->ComputeVorticity ? " On" : " Off") << endl;
   os << indent << "Rotation scale: " << this->RotationScale << endl;
+  os << indent << "Threaded integration: "
+     << (this->ThreadedIntegration ? " On" : " Off") << endl;
 }
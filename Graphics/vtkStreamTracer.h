@@ -73,6 +73,7 @@ class vtkGenericCell;
 class vtkIdList;
 class vtkIntArray;
 class vtkInterpolatedVelocityField;
+class vtkStreamTracerLines;
 
 class VTK_GRAPHICS_EXPORT vtkStreamTracer : public vtkPolyDataAlgorithm
 {
@@ -277,6 +278,18 @@ public:
   vtkGetMacro(ComputeVorticity, int);
   vtkBooleanMacro(ComputeVorticity, int);
 
+  // Description:
+  // Turn on/off integrating the seeds on the threads of the
+  // vtkTaskScheduler.  Each thread integrates with its own velocity
+  // field, and the streamlines are output in the order of the seeds, so
+  // the output is the same as when the seeds are integrated one after the
+  // other.  That is what is done anyway when there are several inputs or
+  // when the input is not a vtkUnstructuredGrid, vtkPolyData,
+  // vtkImageData or vtkRectilinearGrid.  On by default.
+  vtkSetMacro(ThreadedIntegration, int);
+  vtkGetMacro(ThreadedIntegration, int);
+  vtkBooleanMacro(ThreadedIntegration, int);
+
   // Description
   // This can be used to scale the rate with which the streamribbons
   // twist. The default is 1.
@@ -317,6 +330,18 @@ protected:
                        double lastPoint[3], 
                        double delt,
                        vtkInterpolatedVelocityField* func);
+
+  // Integrate the seeds of lines, appending the streamlines to its
+  // outputs.
+  void IntegrateLines(vtkStreamTracerLines *lines);
+
+  // Integrate the seeds in ranges of seeds on the threads of the
+  // vtkTaskScheduler, and append the streamlines to the outputs in the
+  // order of the seeds.  Return 0 without integrating if the input
+  // cannot be shared by the threads, -1 if the filter was aborted and 1
+  // otherwise.
+  int IntegrateInThreads(vtkDataSet *input, vtkStreamTracerLines *lines);
+  static void IntegrateLinesTask(void *arg, vtkIdType begin, vtkIdType end);
   int CheckInputs(vtkInterpolatedVelocityField*& func,
                   int* maxCellSize,
                   vtkInformationVector **inputVector);
@@ -374,6 +399,7 @@ protected:
 
   int ComputeVorticity;
   double RotationScale;
+  int ThreadedIntegration;
 
   vtkInterpolatedVelocityField* InterpolatorPrototype;
 
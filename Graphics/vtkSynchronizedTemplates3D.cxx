@@ -17,20 +17,25 @@
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCharArray.h"
+#include "vtkCriticalSection.h"
 #include "vtkDoubleArray.h"
 #include "vtkExtentTranslator.h"
 #include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkIntArray.h"
 #include "vtkLongArray.h"
 #include "vtkMath.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkShortArray.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredPoints.h"
+#include "vtkSynchronizedTemplatesMerger.h"
+#include "vtkTaskScheduler.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnsignedIntArray.h"
 #include "vtkUnsignedLongArray.h"
@@ -58,6 +63,8 @@ vtkSynchronizedTemplates3D::vtkSynchronizedTemplates3D()
 
   this->ArrayComponent = 0;
 
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+
   // by default process active point scalars
   this->SetInputArrayToProcess(0,0,0,vtkDataObject::FIELD_ASSOCIATION_POINTS,
                                vtkDataSetAttributes::SCALARS);
@@ -82,6 +89,11 @@ unsigned long vtkSynchronizedTemplates3D::GetMTime()
 }
 
 
+//----------------------------------------------------------------------------
+// Serializes the output initialization of slabs contoured in parallel,
+// which registers the lookup tables of the input arrays.
+static vtkSimpleCriticalSection vtkSynchronizedTemplates3DInitializeLock;
+
 //----------------------------------------------------------------------------
 void vtkSynchronizedTemplates3DInitializeOutput(
   int *ext,vtkImageData *input,
@@ -249,19 +261,22 @@ if (ComputeScalars) \
 
 //----------------------------------------------------------------------------
 //
-// Contouring filter specialized for images
+// Contouring filter specialized for images.  The ids of the edges on the
+// bottom and top planes of the extent are recorded in bottomEdges and
+// topEdges when they are not NULL.  Progress is reported when
+// progressScale is positive.
 //
 template <class T>
 void ContourImage(vtkSynchronizedTemplates3D *self, int *exExt,
                   vtkInformation *inInfo,
                   vtkImageData *data, vtkPolyData *output, T *ptr, 
-                  vtkDataArray *inScalars)
+                  vtkDataArray *inScalars, double *values, int numContours,
+                  double progressScale, vtkIdTypeArray *bottomEdges,
+                  vtkIdTypeArray *topEdges)
 {
   int *inExt = data->GetExtent();
   int xdim = exExt[1] - exExt[0] + 1;
   int ydim = exExt[3] - exExt[2] + 1;
-  double *values = self->GetValues();
-  int numContours = self->GetNumberOfContours();
   T *inPtrX, *inPtrY, *inPtrZ;
   T *s0, *s1, *s2, *s3;
   int xMin, xMax, yMin, yMax, zMin, zMax;
@@ -312,10 +327,12 @@ void ContourImage(vtkSynchronizedTemplates3D *self, int *exExt,
     {
     newGradients = vtkFloatArray::New();
     }
+  vtkSynchronizedTemplates3DInitializeLock.Lock();
   vtkSynchronizedTemplates3DInitializeOutput(exExt, 
                                              data, output, 
                                              newScalars, newNormals, 
                                              newGradients, inScalars);
+  vtkSynchronizedTemplates3DInitializeLock.Unlock();
   newPts = output->GetPoints();
   newPolys = output->GetPolys();
   
@@ -375,8 +392,12 @@ void ContourImage(vtkSynchronizedTemplates3D *self, int *exExt,
     //==================================================================
     for (k = zMin; k <= zMax; k++)
       {
-      self->UpdateProgress((double)vidx/numContours + 
-                           (k-zMin)/((zMax - zMin+1.0)*numContours));
+      if (progressScale > 0.0)
+        {
+        self->UpdateProgress(progressScale*
+                             ((double)vidx/numContours + 
+                              (k-zMin)/((zMax - zMin+1.0)*numContours)));
+        }
       z = origin[2] + spacing[2]*k;
       x[2] = z;
 
@@ -602,6 +623,41 @@ void ContourImage(vtkSynchronizedTemplates3D *self, int *exExt,
           }
         inPtrY += yInc;
         }
+
+      // Record the edges shared with neighboring slabs.  Of the z edges
+      // of the bottom plane, only points that sit on a vertex can also be
+      // generated by the slab below.
+      if (k == zMin && bottomEdges)
+        {
+        vtkIdType edge[2];
+        isect2Ptr = (k%2 ? isect1 + zstep*3 : isect1);
+        inPtrY = inPtrZ;
+        for (j = 0; j < ydim; j++)
+          {
+          inPtrX = inPtrY;
+          for (i = 0; i < xdim; i++)
+            {
+            for (jj = 0; jj < 3; jj++)
+              {
+              if (isect2Ptr[jj] > -1 && (jj < 2 || *inPtrX == value))
+                {
+                edge[0] = (j*xdim + i)*3 + jj;
+                edge[1] = isect2Ptr[jj];
+                bottomEdges->InsertNextTupleValue(edge);
+                }
+              }
+            isect2Ptr += 3;
+            inPtrX += xInc;
+            }
+          inPtrY += yInc;
+          }
+        }
+      if (k == zMax && topEdges)
+        {
+        vtkSynchronizedTemplatesMerger::AddEdges(
+          topEdges, (k%2 ? isect1 + zstep*3 : isect1),
+          (k%2 ? isect1 : isect1 + zstep*3), zstep);
+        }
       inPtrZ += zInc;
       }
     }
@@ -658,6 +714,50 @@ unsigned long vtkSynchronizedTemplates3D::GetInputMemoryLimit()
 
 
 
+//----------------------------------------------------------------------------
+// What the tasks contouring the slabs of an image need.
+struct vtkSynchronizedTemplates3DTaskData
+{
+  vtkSynchronizedTemplates3D *Filter;
+  vtkSynchronizedTemplatesMerger *Merger;
+  vtkImageData *Data;
+  vtkInformation *InInfo;
+  vtkDataArray *InScalars;
+  double *Values;
+  double ProgressScale;
+};
+
+//----------------------------------------------------------------------------
+// Contour the pieces [begin, end).  Piece 0 runs on the thread that
+// executes the filter, so it is the one that reports progress.
+static void vtkSynchronizedTemplates3DExecutePieces(void *arg,
+                                                    vtkIdType begin,
+                                                    vtkIdType end)
+{
+  vtkSynchronizedTemplates3DTaskData *td =
+    static_cast<vtkSynchronizedTemplates3DTaskData *>(arg);
+  vtkSynchronizedTemplatesMerger *merger = td->Merger;
+  int numSlabs = merger->GetNumberOfSlabs();
+
+  for (vtkIdType idx = begin; idx < end; ++idx)
+    {
+    int piece = static_cast<int>(idx);
+    int slabExt[6];
+    merger->GetPieceExtent(piece, slabExt);
+    void *ptr = td->Data->GetArrayPointerForExtent(td->InScalars, slabExt);
+    switch (td->InScalars->GetDataType())
+      {
+      vtkTemplateMacro(
+        ContourImage(td->Filter, slabExt, td->InInfo, td->Data,
+                     merger->GetPiece(piece), (VTK_TT *)ptr, td->InScalars,
+                     td->Values + piece / numSlabs, 1,
+                     (piece == 0 ? td->ProgressScale : 0.0),
+                     merger->GetBottomEdges(piece),
+                     merger->GetTopEdges(piece)));
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 //
 // Contouring filter specialized for images (or slices from images)
@@ -697,13 +797,52 @@ void vtkSynchronizedTemplates3D::ThreadedExecute(vtkImageData *data,
     return;
     }
   
-  ptr = data->GetArrayPointerForExtent(inScalars, exExt);
-  switch (inScalars->GetDataType())
+  int numContours = this->GetNumberOfContours();
+  vtkSynchronizedTemplatesMerger *merger = NULL;
+  if (this->NumberOfThreads > 1)
     {
-    vtkTemplateMacro(
-      ContourImage(this, exExt, inInfo, data, output, 
-                   (VTK_TT *)ptr, inScalars));
+    merger = vtkSynchronizedTemplatesMerger::New();
+    merger->Initialize(exExt, numContours, this->NumberOfThreads);
+    if (merger->GetNumberOfSlabs() < 2)
+      {
+      merger->Delete();
+      merger = NULL;
+      }
     }
+
+  if (merger == NULL)
+    {
+    ptr = data->GetArrayPointerForExtent(inScalars, exExt);
+    switch (inScalars->GetDataType())
+      {
+      vtkTemplateMacro(
+        ContourImage(this, exExt, inInfo, data, output, 
+                     (VTK_TT *)ptr, inScalars, this->GetValues(),
+                     numContours, 1.0, NULL, NULL));
+      }
+    return;
+    }
+
+  // Contour the slabs on the global scheduler, then stitch them.  Piece
+  // 0 is assumed to finish about when its share of the work is done.
+  int numPieces = merger->GetNumberOfPieces();
+  vtkSynchronizedTemplates3DTaskData td;
+  td.Filter = this;
+  td.Merger = merger;
+  td.Data = data;
+  td.InInfo = inInfo;
+  td.InScalars = inScalars;
+  td.Values = this->GetValues();
+  td.ProgressScale = (double)this->NumberOfThreads / numPieces;
+  if (td.ProgressScale > 1.0)
+    {
+    td.ProgressScale = 1.0;
+    }
+  vtkTaskScheduler::GetGlobalScheduler()->ParallelFor(
+    0, numPieces, 1, vtkSynchronizedTemplates3DExecutePieces, &td);
+
+  merger->Merge(output);
+  merger->Delete();
 }
 
 //----------------------------------------------------------------------------
@@ -852,6 +991,7 @@ void vtkSynchronizedTemplates3D::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Compute Gradients: " << (this->ComputeGradients ? "On\n" : "Off\n");
   os << indent << "Compute Scalars: " << (this->ComputeScalars ? "On\n" : "Off\n");
   os << indent << "ArrayComponent: " << this->ArrayComponent << endl;
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << endl;
 }
 
 
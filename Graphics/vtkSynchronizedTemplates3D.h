@@ -18,12 +18,17 @@
 // vtkSynchronizedTemplates3D is a 3D implementation of the synchronized 
 // template algorithm. Note that vtkContourFilter will automatically
 // use this class when appropriate.
+//
+// When NumberOfThreads is larger than one, the execute extent is cut into
+// slabs along z that are contoured on the threads of the global
+// vtkTaskScheduler and then stitched together, so the output has the same
+// triangles as a single pass.
 
 // .SECTION Caveats
 // This filter is specialized to 3D images (aka volumes).
 
 // .SECTION See Also
-// vtkContourFilter vtkSynchronizedTemplates2D
+// vtkContourFilter vtkSynchronizedTemplates2D vtkSynchronizedTemplatesMerger
 
 #ifndef __vtkSynchronizedTemplates3D_h
 #define __vtkSynchronizedTemplates3D_h
@@ -135,6 +140,12 @@ public:
   vtkSetMacro(ArrayComponent, int);
   vtkGetMacro(ArrayComponent, int);
 
+  // Description:
+  // Set/Get the number of threads used to contour the execute extent.
+  // It defaults to vtkMultiThreader::GetGlobalDefaultNumberOfThreads().
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
 protected:
   vtkSynchronizedTemplates3D();
   ~vtkSynchronizedTemplates3D();
@@ -152,6 +163,8 @@ protected:
 
   int ArrayComponent;
 
+  int NumberOfThreads;
+
 private:
   vtkSynchronizedTemplates3D(const vtkSynchronizedTemplates3D&);  // Not implemented.
   void operator=(const vtkSynchronizedTemplates3D&);  // Not implemented.
@@ -0,0 +1,348 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSynchronizedTemplatesMerger.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkSynchronizedTemplatesMerger.h"
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkIdTypeArray.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+
+vtkCxxRevisionMacro(vtkSynchronizedTemplatesMerger, "1.1");
+vtkStandardNewMacro(vtkSynchronizedTemplatesMerger);
+
+//----------------------------------------------------------------------------
+vtkSynchronizedTemplatesMerger::vtkSynchronizedTemplatesMerger()
+{
+  for (int idx = 0; idx < 6; ++idx)
+    {
+    this->Extent[idx] = 0;
+    }
+  this->NumberOfContours = 0;
+  this->NumberOfSlabs = 0;
+  this->SlabBounds = NULL;
+  this->Pieces = NULL;
+  this->BottomEdges = NULL;
+  this->TopEdges = NULL;
+}
+
+//----------------------------------------------------------------------------
+vtkSynchronizedTemplatesMerger::~vtkSynchronizedTemplatesMerger()
+{
+  this->Reset();
+}
+
+//----------------------------------------------------------------------------
+void vtkSynchronizedTemplatesMerger::Reset()
+{
+  int numPieces = this->GetNumberOfPieces();
+  for (int piece = 0; piece < numPieces; ++piece)
+    {
+    this->Pieces[piece]->Delete();
+    if (this->BottomEdges[piece])
+      {
+      this->BottomEdges[piece]->Delete();
+      }
+    if (this->TopEdges[piece])
+      {
+      this->TopEdges[piece]->Delete();
+      }
+    }
+  delete [] this->SlabBounds;
+  delete [] this->Pieces;
+  delete [] this->BottomEdges;
+  delete [] this->TopEdges;
+  this->SlabBounds = NULL;
+  this->Pieces = NULL;
+  this->BottomEdges = NULL;
+  this->TopEdges = NULL;
+  this->NumberOfContours = 0;
+  this->NumberOfSlabs = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkSynchronizedTemplatesMerger::Initialize(int extent[6],
+                                                int numberOfContours,
+                                                int numberOfThreads)
+{
+  int idx;
+
+  this->Reset();
+  for (idx = 0; idx < 6; ++idx)
+    {
+    this->Extent[idx] = extent[idx];
+    }
+  this->NumberOfContours = (numberOfContours > 0 ? numberOfContours : 0);
+
+  // Aim for two pieces per thread, counting every contour value, but keep
+  // the slabs at least two cells thick so that the boundary planes stay a
+  // small part of the work.
+  int numSlabs = 1;
+  if (numberOfThreads > 1 && this->NumberOfContours > 0)
+    {
+    numSlabs = (2*numberOfThreads + this->NumberOfContours - 1) /
+      this->NumberOfContours;
+    }
+  int layers = extent[5] - extent[4];
+  if (numSlabs > layers / 2)
+    {
+    numSlabs = layers / 2;
+    }
+  if (numSlabs < 1)
+    {
+    numSlabs = 1;
+    }
+  this->NumberOfSlabs = numSlabs;
+
+  this->SlabBounds = new int [numSlabs + 1];
+  for (idx = 0; idx <= numSlabs; ++idx)
+    {
+    this->SlabBounds[idx] = extent[4] + (layers * idx) / numSlabs;
+    }
+
+  int numPieces = this->GetNumberOfPieces();
+  this->Pieces = new vtkPolyData* [numPieces];
+  this->BottomEdges = new vtkIdTypeArray* [numPieces];
+  this->TopEdges = new vtkIdTypeArray* [numPieces];
+  for (int piece = 0; piece < numPieces; ++piece)
+    {
+    int slab = piece % numSlabs;
+    this->Pieces[piece] = vtkPolyData::New();
+    this->BottomEdges[piece] = NULL;
+    this->TopEdges[piece] = NULL;
+    if (slab > 0)
+      {
+      this->BottomEdges[piece] = vtkIdTypeArray::New();
+      this->BottomEdges[piece]->SetNumberOfComponents(2);
+      }
+    if (slab < numSlabs - 1)
+      {
+      this->TopEdges[piece] = vtkIdTypeArray::New();
+      this->TopEdges[piece]->SetNumberOfComponents(2);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSynchronizedTemplatesMerger::GetPieceExtent(int piece, int extent[6])
+{
+  int slab = piece % this->NumberOfSlabs;
+  extent[0] = this->Extent[0];
+  extent[1] = this->Extent[1];
+  extent[2] = this->Extent[2];
+  extent[3] = this->Extent[3];
+  extent[4] = this->SlabBounds[slab];
+  extent[5] = this->SlabBounds[slab + 1];
+}
+
+//----------------------------------------------------------------------------
+vtkPolyData *vtkSynchronizedTemplatesMerger::GetPiece(int piece)
+{
+  return this->Pieces[piece];
+}
+
+//----------------------------------------------------------------------------
+vtkIdTypeArray *vtkSynchronizedTemplatesMerger::GetBottomEdges(int piece)
+{
+  return this->BottomEdges[piece];
+}
+
+//----------------------------------------------------------------------------
+vtkIdTypeArray *vtkSynchronizedTemplatesMerger::GetTopEdges(int piece)
+{
+  return this->TopEdges[piece];
+}
+
+//----------------------------------------------------------------------------
+void vtkSynchronizedTemplatesMerger::AddEdges(vtkIdTypeArray *edges,
+                                              int *plane, int *zPlane,
+                                              int planeSize)
+{
+  vtkIdType edge[2];
+  for (int idx = 0; idx < 3*planeSize; idx += 3)
+    {
+    if (plane[idx] > -1)
+      {
+      edge[0] = idx;
+      edge[1] = plane[idx];
+      edges->InsertNextTupleValue(edge);
+      }
+    if (plane[idx + 1] > -1)
+      {
+      edge[0] = idx + 1;
+      edge[1] = plane[idx + 1];
+      edges->InsertNextTupleValue(edge);
+      }
+    if (zPlane && zPlane[idx + 2] > -1)
+      {
+      edge[0] = idx + 2;
+      edge[1] = zPlane[idx + 2];
+      edges->InsertNextTupleValue(edge);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSynchronizedTemplatesMerger::AppendPiece(int piece,
+                                                 vtkIdType *pointMap)
+{
+  vtkPolyData *output = this->Pieces[0];
+  vtkPolyData *input = this->Pieces[piece];
+  vtkPoints *outPts = output->GetPoints();
+  vtkPoints *inPts = input->GetPoints();
+  vtkPointData *outPD = output->GetPointData();
+  vtkPointData *inPD = input->GetPointData();
+  vtkCellData *outCD = output->GetCellData();
+  vtkCellData *inCD = input->GetCellData();
+  vtkCellArray *outPolys = output->GetPolys();
+  int numPointArrays = outPD->GetNumberOfArrays();
+  int numCellArrays = outCD->GetNumberOfArrays();
+  int idx;
+
+  // The pieces were all initialized alike, so their arrays line up.
+  vtkIdType numPts = input->GetNumberOfPoints();
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+    {
+    if (pointMap[ptId] < 0)
+      {
+      pointMap[ptId] = outPts->InsertNextPoint(inPts->GetPoint(ptId));
+      for (idx = 0; idx < numPointArrays; ++idx)
+        {
+        outPD->GetArray(idx)->InsertNextTuple(
+          inPD->GetArray(idx)->GetTuple(ptId));
+        }
+      }
+    }
+
+  // Triangles are dropped when stitching collapses them, as a single pass
+  // would not have generated them.
+  vtkCellArray *inPolys = input->GetPolys();
+  vtkIdType npts, *pts, ptIds[3];
+  vtkIdType cellId = 0;
+  for (inPolys->InitTraversal(); inPolys->GetNextCell(npts, pts); ++cellId)
+    {
+    ptIds[0] = pointMap[pts[0]];
+    ptIds[1] = pointMap[pts[1]];
+    ptIds[2] = pointMap[pts[2]];
+    if (ptIds[0] != ptIds[1] &&
+        ptIds[0] != ptIds[2] &&
+        ptIds[1] != ptIds[2])
+      {
+      outPolys->InsertNextCell(3, ptIds);
+      for (idx = 0; idx < numCellArrays; ++idx)
+        {
+        outCD->GetArray(idx)->InsertNextTuple(
+          inCD->GetArray(idx)->GetTuple(cellId));
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSynchronizedTemplatesMerger::Merge(vtkPolyData *output)
+{
+  int numSlabs = this->NumberOfSlabs;
+  int numPieces = this->GetNumberOfPieces();
+  if (numPieces == 0)
+    {
+    return;
+    }
+
+  for (int vidx = 0; vidx < this->NumberOfContours; ++vidx)
+    {
+    vtkIdType *belowMap = NULL;
+    for (int slab = 0; slab < numSlabs; ++slab)
+      {
+      int piece = vidx*numSlabs + slab;
+      vtkIdType numPts = this->Pieces[piece]->GetNumberOfPoints();
+      vtkIdType *pointMap = new vtkIdType [numPts + 1];
+      vtkIdType ptId;
+      if (piece == 0)
+        {
+        // The first piece is the output, so its ids do not change.
+        for (ptId = 0; ptId < numPts; ++ptId)
+          {
+          pointMap[ptId] = ptId;
+          }
+        }
+      else
+        {
+        for (ptId = 0; ptId < numPts; ++ptId)
+          {
+          pointMap[ptId] = -1;
+          }
+        if (slab > 0)
+          {
+          // Walk the two sorted edge lists together.  An x or y edge of
+          // the shared plane is the same point in both slabs.  A z edge
+          // point on a vertex is the one the slab below found on the z
+          // edge under the vertex, unless it was already matched to an x
+          // or y edge of the plane.
+          vtkIdTypeArray *bottom = this->BottomEdges[piece];
+          vtkIdTypeArray *top = this->TopEdges[piece - 1];
+          vtkIdType *b = bottom->GetPointer(0);
+          vtkIdType *bEnd = b + 2*bottom->GetNumberOfTuples();
+          vtkIdType *t = top->GetPointer(0);
+          vtkIdType *tEnd = t + 2*top->GetNumberOfTuples();
+          while (b < bEnd && t < tEnd)
+            {
+            if (b[0] < t[0])
+              {
+              b += 2;
+              }
+            else if (t[0] < b[0])
+              {
+              t += 2;
+              }
+            else
+              {
+              if (b[0] % 3 != 2 || pointMap[b[1]] < 0)
+                {
+                pointMap[b[1]] = belowMap[t[1]];
+                }
+              b += 2;
+              t += 2;
+              }
+            }
+          }
+        this->AppendPiece(piece, pointMap);
+        }
+      delete [] belowMap;
+      belowMap = pointMap;
+      }
+    delete [] belowMap;
+    }
+
+  vtkPolyData *first = this->Pieces[0];
+  first->Squeeze();
+  output->SetPoints(first->GetPoints());
+  output->SetPolys(first->GetPolys());
+  output->GetPointData()->ShallowCopy(first->GetPointData());
+  output->GetCellData()->ShallowCopy(first->GetCellData());
+}
+
+//----------------------------------------------------------------------------
+void vtkSynchronizedTemplatesMerger::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Extent: (" << this->Extent[0] << ", "
+     << this->Extent[1] << ", " << this->Extent[2] << ", "
+     << this->Extent[3] << ", " << this->Extent[4] << ", "
+     << this->Extent[5] << ")\n";
+  os << indent << "Number Of Contours: " << this->NumberOfContours << "\n";
+  os << indent << "Number Of Slabs: " << this->NumberOfSlabs << "\n";
+}
@@ -0,0 +1,120 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSynchronizedTemplatesMerger.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkSynchronizedTemplatesMerger - stitch slabs of a structured contour
+// .SECTION Description
+// vtkSynchronizedTemplatesMerger is a helper for the synchronized templates
+// filters that contour a structured extent on several threads.  The extent
+// is cut into slabs along z that share their boundary planes, and every
+// (contour value, slab) pair is contoured into its own vtkPolyData piece.
+//
+// While contouring, each piece records the point ids of the edges of its
+// boundary planes.  The top plane of a slab lists the x and y edges of the
+// plane together with the z edges of the plane below it, and the bottom
+// plane lists its x and y edges and the z edges of points that sit exactly
+// on a grid vertex.  Merge() appends the pieces in the order a single pass
+// would have produced them, and maps every boundary point of a slab to the
+// point already generated by the slab below.  The result has the same
+// triangles as contouring the whole extent in one pass.
+//
+// The edge ids are stored as pairs (edge key, point id), where the key of
+// edge e (0 = x, 1 = y, 2 = z) at vertex (i, j) of the plane is
+// 3*(j*xdim + i) + e.  Keys must be recorded in increasing order.
+// .SECTION See Also
+// vtkSynchronizedTemplates3D vtkGridSynchronizedTemplates3D
+
+#ifndef __vtkSynchronizedTemplatesMerger_h
+#define __vtkSynchronizedTemplatesMerger_h
+
+#include "vtkObject.h"
+
+class vtkIdTypeArray;
+class vtkPolyData;
+
+class VTK_GRAPHICS_EXPORT vtkSynchronizedTemplatesMerger : public vtkObject
+{
+public:
+  static vtkSynchronizedTemplatesMerger *New();
+
+  vtkTypeRevisionMacro(vtkSynchronizedTemplatesMerger,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Split the extent into slabs for contouring the given number of values
+  // on the given number of threads, and create the pieces.  Each slab is
+  // at least two cells thick.  An extent too thin to split gets a single
+  // slab.
+  void Initialize(int extent[6], int numberOfContours, int numberOfThreads);
+
+  // Description:
+  // Get the number of slabs and pieces chosen by Initialize().
+  vtkGetMacro(NumberOfSlabs, int);
+  int GetNumberOfPieces()
+    {return this->NumberOfSlabs * this->NumberOfContours;}
+
+  // Description:
+  // Get the extent of the slab used by a piece.  Piece p contours
+  // value p / NumberOfSlabs over slab p % NumberOfSlabs.
+  void GetPieceExtent(int piece, int extent[6]);
+
+  // Description:
+  // Get the output of a piece.
+  vtkPolyData *GetPiece(int piece);
+
+  // Description:
+  // Get the arrays a piece records its boundary edges into.  They are NULL
+  // when the boundary is the boundary of the whole extent.
+  vtkIdTypeArray *GetBottomEdges(int piece);
+  vtkIdTypeArray *GetTopEdges(int piece);
+
+  //BTX
+  // Description:
+  // Append the x and y edges of plane, and the z edges of zPlane, to the
+  // edge array.  Both planes hold three ids per vertex, -1 meaning that
+  // the edge is not cut.
+  static void AddEdges(vtkIdTypeArray *edges, int *plane, int *zPlane,
+                       int planeSize);
+  //ETX
+
+  // Description:
+  // Stitch the pieces together into output.  The points, cells and
+  // attributes of the first piece are reused.
+  void Merge(vtkPolyData *output);
+
+  // Description:
+  // Release the pieces.
+  void Reset();
+
+protected:
+  vtkSynchronizedTemplatesMerger();
+  ~vtkSynchronizedTemplatesMerger();
+
+  // Append the points of piece that are not on the bottom boundary, and
+  // its triangles, to the first piece.
+  void AppendPiece(int piece, vtkIdType *pointMap);
+
+  int Extent[6];
+  int NumberOfContours;
+  int NumberOfSlabs;
+  int *SlabBounds;
+  vtkPolyData **Pieces;
+  vtkIdTypeArray **BottomEdges;
+  vtkIdTypeArray **TopEdges;
+
+private:
+  vtkSynchronizedTemplatesMerger(const vtkSynchronizedTemplatesMerger&);  // Not implemented.
+  void operator=(const vtkSynchronizedTemplatesMerger&);  // Not implemented.
+};
+
+#endif
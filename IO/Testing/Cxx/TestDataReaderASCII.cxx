@@ -0,0 +1,330 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataReaderASCII.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the reading of ASCII arrays by vtkDataReader.
+// .SECTION Description
+// Writes an ASCII polydata file with points, polygons and a field of
+// arrays of every type, whose values are written in many ways: short and
+// long reals, exponents, signs, leading zeros, long runs of blanks, a
+// token holding two values.  The file is read from a string and from a
+// file with one and four threads, and the values must be those extracted
+// one by one with the stream operators.
+
+#include "vtkCellArray.h"
+#include "vtkDataArray.h"
+#include "vtkMath.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataReader.h"
+#include "vtkTaskScheduler.h"
+
+#include <vtkstd/string>
+
+#include <math.h>
+#include <stdio.h>
+
+#define NUMBER_OF_POINTS 60000
+
+// A real written in one of the ways a file may hold it.
+static void WriteReal(vtkstd::string& text, int isFloat)
+{
+  char token[64];
+  double v = vtkMath::Floor(vtkMath::Random(-50000, 50000))*
+    pow(10.0, vtkMath::Floor(vtkMath::Random(-15, 10)));
+  switch (vtkMath::Floor(vtkMath::Random(0, isFloat ? 8 : 9)))
+    {
+    case 0: sprintf(token, "%g", v); break;
+    case 1: sprintf(token, "%e", v); break;
+    case 2: sprintf(token, "%.9g", v); break;
+    case 3: sprintf(token, "%+.3E", v); break;
+    case 4: sprintf(token, "%f", v); break;
+    case 5: sprintf(token, "%d.", vtkMath::Floor(vtkMath::Random(-500, 500)));
+      break;
+    case 6: sprintf(token, "%s.%05d", vtkMath::Random() < 0.5 ? "-" : "+",
+                    vtkMath::Floor(vtkMath::Random(0, 100000)));
+      break;
+    case 7: sprintf(token, "%s",
+                    vtkMath::Random() < 0.5 ? "-0" : "000.250e+2"); break;
+    default: sprintf(token, "%.17g", v); break;
+    }
+  text += token;
+}
+
+// An integer between min and max written in one of the ways a file may
+// hold it.
+static void WriteInteger(vtkstd::string& text, long min, long max)
+{
+  char token[64];
+  long v = static_cast<long>(floor(vtkMath::Random(min, max)));
+  switch (vtkMath::Floor(vtkMath::Random(0, 4)))
+    {
+    case 0: sprintf(token, "%ld", v); break;
+    case 1: sprintf(token, "%s%ld", v >= 0 ? "+" : "", v); break;
+    case 2: sprintf(token, "%07ld", v); break;
+    default: sprintf(token, "%ld", v/1000); break;
+    }
+  text += token;
+}
+
+static vtkstd::string MakeFile()
+{
+  vtkstd::string text = "# vtk DataFile Version 3.0\n"
+    "ASCII arrays\nASCII\nDATASET POLYDATA\n";
+  char line[256];
+  int i;
+  sprintf(line, "POINTS %d double\n", NUMBER_OF_POINTS);
+  text += line;
+  for (i = 0; i < 3*NUMBER_OF_POINTS; ++i)
+    {
+    WriteReal(text, 0);
+    text += (i % 3 == 2 ? "\n" : " ");
+    }
+
+  // Triangles and quads.
+  int numCells = NUMBER_OF_POINTS/4;
+  sprintf(line, "POLYGONS %d %d\n", numCells, 4*numCells + numCells/2);
+  text += line;
+  for (i = 0; i < numCells; ++i)
+    {
+    int npts = 3 + i % 2;
+    sprintf(line, "%d", npts);
+    text += line;
+    for (int j = 0; j < npts; ++j)
+      {
+      sprintf(line, " %d",
+              vtkMath::Floor(vtkMath::Random(0, NUMBER_OF_POINTS)));
+      text += line;
+      }
+    text += "\n";
+    }
+
+  static const char* types[] =
+    { "float", "double", "char", "unsigned_char", "short", "unsigned_short",
+      "int", "unsigned_int", "long", "unsigned_long" };
+  static const long mins[] =
+    { 0, 0, -128, 0, -32768, 0, -2000000000, 0, -2000000000, 0 };
+  static const long maxs[] =
+    { 0, 0, 127, 255, 32767, 65535, 2000000000, 2000000000, 2000000000,
+      2000000000 };
+  sprintf(line, "POINT_DATA %d\nFIELD FieldData 10\n", NUMBER_OF_POINTS);
+  text += line;
+  for (int a = 0; a < 10; ++a)
+    {
+    // Arrays named by numbers, so that numbers follow the values.
+    sprintf(line, "%d 1 %d %s\n", a, NUMBER_OF_POINTS, types[a]);
+    text += line;
+    for (i = 0; i < NUMBER_OF_POINTS; ++i)
+      {
+      if (a == 6 && i == NUMBER_OF_POINTS/2)
+        {
+        // Two values in one token: the rest of the array is read with
+        // the stream operators.
+        text += "12-5";
+        ++i;
+        }
+      else if (a < 2)
+        {
+        WriteReal(text, a == 0);
+        }
+      else
+        {
+        WriteInteger(text, mins[a], maxs[a]);
+        }
+      text += (i % 9 == 8 ? "\n" : vtkMath::Random() < 0.5 ? " " : "\t ");
+      if (a == 1 && vtkMath::Random() < 0.25)
+        {
+        // Long runs of blanks, so that the values do not fit in the
+        // first block read.
+        text.append(100, ' ');
+        }
+      }
+    text += "\n";
+    }
+  return text;
+}
+
+// The values of an array extracted one by one from the text, as
+// vtkDataReader::Read() does.
+template <class T, class R>
+int CompareValues(istrstream& is, vtkDataArray* array, T*, R*)
+{
+  vtkIdType n = array->GetNumberOfTuples()*array->GetNumberOfComponents();
+  T* values = static_cast<T*>(array->GetVoidPointer(0));
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    R r;
+    is >> r;
+    T v = static_cast<T>(r);
+    if (is.fail() || memcmp(&v, values + i, sizeof(T)) != 0)
+      {
+      cerr << "Value " << i << " of " << array->GetName() << " is "
+           << values[i] << " instead of " << v << "\n";
+      return 0;
+      }
+    }
+  return 1;
+}
+
+static int CompareOutput(vtkPolyData* output, const vtkstd::string& text)
+{
+  istrstream is(text.c_str(), static_cast<int>(text.size()));
+  char word[256];
+  is.getline(word, 256);
+  is.getline(word, 256);
+  is.getline(word, 256);
+  is.getline(word, 256);
+  is >> word >> word >> word;
+
+  if (output->GetNumberOfPoints() != NUMBER_OF_POINTS ||
+      !CompareValues(is, output->GetPoints()->GetData(),
+                     static_cast<double*>(0), static_cast<double*>(0)))
+    {
+    cerr << "The points differ\n";
+    return 0;
+    }
+
+  is >> word >> word >> word;
+  vtkCellArray* polys = output->GetPolys();
+  vtkIdType n = polys->GetData()->GetNumberOfTuples();
+  if (n != NUMBER_OF_POINTS + NUMBER_OF_POINTS/8)
+    {
+    cerr << "The polygons have " << n << " values\n";
+    return 0;
+    }
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    vtkIdType id;
+    is >> id;
+    if (polys->GetData()->GetValue(i) != id)
+      {
+      cerr << "Value " << i << " of the polygons differs\n";
+      return 0;
+      }
+    }
+
+  is >> word >> word >> word >> word >> word;
+  vtkPointData* pd = output->GetPointData();
+  if (pd->GetNumberOfArrays() != 10)
+    {
+    cerr << pd->GetNumberOfArrays() << " point arrays instead of 10\n";
+    return 0;
+    }
+  int ok = 1;
+  for (int a = 0; ok && a < 10; ++a)
+    {
+    char name[256];
+    is >> name >> word >> word >> word;
+    vtkDataArray* array = pd->GetArray(a);
+    if (!array || strcmp(array->GetName(), name) != 0 ||
+        array->GetNumberOfTuples() != NUMBER_OF_POINTS)
+      {
+      cerr << "Array " << a << " is not " << name << "\n";
+      return 0;
+      }
+    switch (array->GetDataType())
+      {
+      case VTK_FLOAT:
+        ok = CompareValues(is, array, static_cast<float*>(0),
+                           static_cast<float*>(0));
+        break;
+      case VTK_DOUBLE:
+        ok = CompareValues(is, array, static_cast<double*>(0),
+                           static_cast<double*>(0));
+        break;
+      case VTK_CHAR:
+        ok = CompareValues(is, array, static_cast<char*>(0),
+                           static_cast<int*>(0));
+        break;
+      case VTK_UNSIGNED_CHAR:
+        ok = CompareValues(is, array, static_cast<unsigned char*>(0),
+                           static_cast<int*>(0));
+        break;
+      case VTK_SHORT:
+        ok = CompareValues(is, array, static_cast<short*>(0),
+                           static_cast<short*>(0));
+        break;
+      case VTK_UNSIGNED_SHORT:
+        ok = CompareValues(is, array, static_cast<unsigned short*>(0),
+                           static_cast<unsigned short*>(0));
+        break;
+      case VTK_INT:
+        ok = CompareValues(is, array, static_cast<int*>(0),
+                           static_cast<int*>(0));
+        break;
+      case VTK_UNSIGNED_INT:
+        ok = CompareValues(is, array, static_cast<unsigned int*>(0),
+                           static_cast<unsigned int*>(0));
+        break;
+      case VTK_LONG:
+        ok = CompareValues(is, array, static_cast<long*>(0),
+                           static_cast<long*>(0));
+        break;
+      case VTK_UNSIGNED_LONG:
+        ok = CompareValues(is, array, static_cast<unsigned long*>(0),
+                           static_cast<unsigned long*>(0));
+        break;
+      default:
+        ok = 0;
+      }
+    }
+  return ok;
+}
+
+static int Read(const vtkstd::string& text, const char* fileName,
+                int numThreads)
+{
+  vtkTaskScheduler::GetGlobalScheduler()->SetNumberOfThreads(numThreads);
+  vtkPolyDataReader* reader = vtkPolyDataReader::New();
+  if (fileName)
+    {
+    reader->SetFileName(fileName);
+    }
+  else
+    {
+    reader->ReadFromInputStringOn();
+    reader->SetInputString(text.c_str(), static_cast<int>(text.size()));
+    }
+  reader->Update();
+  int ok = CompareOutput(reader->GetOutput(), text);
+  if (!ok)
+    {
+    cerr << "Reading from " << (fileName ? "a file" : "a string") << " with "
+         << numThreads << " threads failed\n";
+    }
+  reader->Delete();
+  return ok;
+}
+
+int TestDataReaderASCII(int, char *[])
+{
+  vtkMath::RandomSeed(8775070);
+  vtkstd::string text = MakeFile();
+  int ok = Read(text, 0, 1);
+  ok = Read(text, 0, 4) && ok;
+
+  const char* fileName = "TestDataReaderASCII.vtk";
+  FILE* fp = fopen(fileName, "wb");
+  if (!fp)
+    {
+    cerr << "Cannot write " << fileName << "\n";
+    return 1;
+    }
+  fwrite(text.c_str(), 1, text.size(), fp);
+  fclose(fp);
+  ok = Read(text, fileName, 1) && ok;
+  ok = Read(text, fileName, 4) && ok;
+  remove(fileName);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,236 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestLZ4DataCompressor.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of vtkLZ4DataCompressor.
+// .SECTION Description
+// Compresses buffers of several sizes and contents with and without
+// regrouping the bytes of the words, checks that they uncompress to the
+// original data and that damaged buffers are rejected.  Then writes an
+// image with the compressor, checks that it is smaller than the
+// uncompressed file, and that the reader picks the compressor from the
+// file.
+
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkLZ4DataCompressor.h"
+#include "vtkPointData.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkXMLImageDataReader.h"
+#include "vtkXMLImageDataWriter.h"
+#include "vtksys/SystemTools.hxx"
+
+#include <math.h>
+
+static void FillTestBuffer(unsigned char *buffer, unsigned long size,
+                           int pattern, unsigned int &seed)
+{
+  unsigned long i;
+  switch (pattern)
+    {
+    case 0:
+      // Random bytes do not compress.
+      for (i = 0; i < size; ++i)
+        {
+        seed = seed*1103515245 + 12345;
+        buffer[i] = static_cast<unsigned char>(seed >> 16);
+        }
+      break;
+    case 1:
+      // Long runs.
+      for (i = 0; i < size; ++i)
+        {
+        buffer[i] = static_cast<unsigned char>(i / 1000);
+        }
+      break;
+    default:
+      // A smooth float field.
+      for (i = 0; i + sizeof(float) <= size; i += sizeof(float))
+        {
+        float f = static_cast<float>(sin(i*0.001)*100.0);
+        memcpy(buffer + i, &f, sizeof(float));
+        }
+      for (; i < size; ++i)
+        {
+        buffer[i] = 0;
+        }
+      break;
+    }
+}
+
+int TestLZ4DataCompressor(int, char *[])
+{
+  int retVal = 0;
+  unsigned int seed = 1;
+  unsigned long sizes[6] = { 0, 1, 12, 13, 1001, 70000 };
+  int wordSizes[3] = { 1, 4, 8 };
+
+  vtkLZ4DataCompressor *compressor = vtkLZ4DataCompressor::New();
+  for (int s = 0; s < 6; ++s)
+    {
+    unsigned long size = sizes[s];
+    unsigned char *buffer = new unsigned char [size + 1];
+    unsigned char *result = new unsigned char [size + 1];
+    for (int pattern = 0; pattern < 3; ++pattern)
+      {
+      FillTestBuffer(buffer, size, pattern, seed);
+      for (int w = 0; w < 3; ++w)
+        {
+        compressor->SetWordSize(wordSizes[w]);
+        vtkUnsignedCharArray *compressed =
+          compressor->Compress(buffer, size);
+        if (!compressed)
+          {
+          cerr << "Could not compress " << size << " bytes\n";
+          retVal = 1;
+          continue;
+          }
+        unsigned long compressedSize = compressed->GetNumberOfTuples();
+        if (compressedSize > compressor->GetMaximumCompressionSpace(size))
+          {
+          cerr << size << " bytes compressed to " << compressedSize
+               << " bytes, more than the maximum\n";
+          retVal = 1;
+          }
+        if (size > 0 &&
+            (compressor->Uncompress(compressed->GetPointer(0),
+                                    compressedSize, result, size) != size ||
+             memcmp(buffer, result, size) != 0))
+          {
+          cerr << "Pattern " << pattern << " of " << size
+               << " bytes with word size " << wordSizes[w]
+               << " does not uncompress to the original data\n";
+          retVal = 1;
+          }
+        compressed->Delete();
+        }
+      }
+    delete [] buffer;
+    delete [] result;
+    }
+
+  // Damaged buffers must be rejected without crashing.
+  unsigned long size = 70000;
+  unsigned char *buffer = new unsigned char [size];
+  unsigned char *result = new unsigned char [size];
+  FillTestBuffer(buffer, size, 2, seed);
+  compressor->SetWordSize(4);
+  vtkUnsignedCharArray *compressed = compressor->Compress(buffer, size);
+  unsigned char *data = compressed->GetPointer(0);
+  unsigned long compressedSize = compressed->GetNumberOfTuples();
+  compressor->GlobalWarningDisplayOff();
+  if (compressor->Uncompress(data, compressedSize, result, size - 1) != 0 ||
+      compressor->Uncompress(data, compressedSize/2, result, size) != 0)
+    {
+    cerr << "Truncated data were not rejected\n";
+    retVal = 1;
+    }
+  for (int i = 0; i < 1000; ++i)
+    {
+    seed = seed*1103515245 + 12345;
+    data[1 + (seed >> 8) % (compressedSize - 1)] ^=
+      static_cast<unsigned char>((seed >> 20) | 1);
+    compressor->Uncompress(data, compressedSize, result, size);
+    }
+  data[0] = 9;
+  if (compressor->Uncompress(data, compressedSize, result, size) != 0)
+    {
+    cerr << "Invalid word size was not rejected\n";
+    retVal = 1;
+    }
+  compressor->GlobalWarningDisplayOn();
+  compressed->Delete();
+  delete [] buffer;
+  delete [] result;
+
+  // Write a smooth field with and without compression.
+  vtkImageData *image = vtkImageData::New();
+  image->SetDimensions(64, 64, 64);
+  vtkFloatArray *field = vtkFloatArray::New();
+  field->SetName("Field");
+  for (int k = 0; k < 64; ++k)
+    {
+    for (int j = 0; j < 64; ++j)
+      {
+      for (int i = 0; i < 64; ++i)
+        {
+        field->InsertNextValue(
+          static_cast<float>(sin(0.1*i)*cos(0.07*j) + 0.01*k));
+        }
+      }
+    }
+  image->GetPointData()->SetScalars(field);
+  field->Delete();
+
+  const char *rawName = "TestLZ4DataCompressorRaw.vti";
+  const char *lz4Name = "TestLZ4DataCompressor.vti";
+  vtkXMLImageDataWriter *writer = vtkXMLImageDataWriter::New();
+  writer->SetInput(image);
+  writer->SetDataModeToAppended();
+  writer->EncodeAppendedDataOff();
+  writer->SetFileName(rawName);
+  writer->SetCompressor(0);
+  writer->Write();
+  writer->SetFileName(lz4Name);
+  compressor->SetWordSize(1);
+  writer->SetCompressor(compressor);
+  writer->Write();
+  writer->Delete();
+  if (compressor->GetWordSize() != 4)
+    {
+    cerr << "The writer set the word size to " << compressor->GetWordSize()
+         << " instead of 4\n";
+    retVal = 1;
+    }
+  unsigned long rawSize = vtksys::SystemTools::FileLength(rawName);
+  unsigned long lz4Size = vtksys::SystemTools::FileLength(lz4Name);
+  cout << "Uncompressed " << rawSize << " bytes, lz4 " << lz4Size
+       << " bytes\n";
+  if (lz4Size == 0 || lz4Size >= rawSize)
+    {
+    cerr << "The lz4 file is not smaller than the uncompressed file\n";
+    retVal = 1;
+    }
+
+  vtkXMLImageDataReader *reader = vtkXMLImageDataReader::New();
+  reader->SetFileName(lz4Name);
+  reader->Update();
+  vtkDataArray *readField =
+    reader->GetOutput()->GetPointData()->GetArray("Field");
+  if (!readField ||
+      readField->GetNumberOfTuples() != image->GetNumberOfPoints())
+    {
+    cerr << "Could not read the lz4 file\n";
+    retVal = 1;
+    }
+  else
+    {
+    vtkDataArray *scalars = image->GetPointData()->GetScalars();
+    for (vtkIdType ptId = 0; ptId < image->GetNumberOfPoints(); ++ptId)
+      {
+      if (readField->GetComponent(ptId, 0) != scalars->GetComponent(ptId, 0))
+        {
+        cerr << "The lz4 file differs at point " << ptId << "\n";
+        retVal = 1;
+        break;
+        }
+      }
+    }
+  reader->Delete();
+
+  vtksys::SystemTools::RemoveFile(rawName);
+  vtksys::SystemTools::RemoveFile(lz4Name);
+  image->Delete();
+  compressor->Delete();
+  return retVal;
+}
@@ -0,0 +1,298 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSTLReader.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the merging of points by vtkSTLReader.
+// .SECTION Description
+// Writes binary and ASCII STL files of a surface whose triangles share
+// vertices, with degenerate triangles, zeros of either sign and isolated
+// triangles, and of two solids in the ASCII file.  The files are read
+// with and without merging, with one and four threads, and with a
+// vtkPointLocator, and the outputs must be those that merging the
+// vertices with vtkMergePoints gives.
+
+#include "vtkByteSwap.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMath.h"
+#include "vtkMergePoints.h"
+#include "vtkPointLocator.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSTLReader.h"
+#include "vtkTaskScheduler.h"
+
+#include <vtkstd/vector>
+
+#include <math.h>
+#include <stdio.h>
+
+#define GRID_SIZE 80
+#define NUMBER_OF_ISOLATED_TRIANGLES 20000
+
+// The vertices of the triangles, 9 coordinates per triangle.
+static void MakeTriangles(vtkstd::vector<float>& x)
+{
+  float grid[GRID_SIZE][GRID_SIZE][3];
+  int i, j, k;
+  for (i = 0; i < GRID_SIZE; ++i)
+    {
+    for (j = 0; j < GRID_SIZE; ++j)
+      {
+      grid[i][j][0] = static_cast<float>(0.1*i);
+      grid[i][j][1] = static_cast<float>(0.1*j - 1.0);
+      grid[i][j][2] = static_cast<float>(sin(0.3*i)*cos(0.2*j));
+      }
+    }
+  for (i = 0; i + 1 < GRID_SIZE; ++i)
+    {
+    for (j = 0; j + 1 < GRID_SIZE; ++j)
+      {
+      const float* v[6] = { grid[i][j], grid[i+1][j], grid[i+1][j+1],
+                            grid[i][j], grid[i+1][j+1], grid[i][j+1] };
+      for (k = 0; k < 6; ++k)
+        {
+        x.insert(x.end(), v[k], v[k] + 3);
+        // Zeros of either sign.
+        if (i == 0 && j % 2 && k == 3)
+          {
+          x[x.size() - 3] = -0.0f;
+          }
+        }
+      if (j % 7 == 3)
+        {
+        // A degenerate triangle.
+        x.insert(x.end(), v[0], v[0] + 3);
+        x.insert(x.end(), v[1], v[1] + 3);
+        x.insert(x.end(), v[0], v[0] + 3);
+        }
+      }
+    }
+  for (i = 0; i < 9*NUMBER_OF_ISOLATED_TRIANGLES; ++i)
+    {
+    double v = vtkMath::Floor(vtkMath::Random(0, 800000))*1.0e-5 - 1.0;
+    x.push_back(static_cast<float>(v));
+    }
+}
+
+static int WriteBinary(const char* fileName, const vtkstd::vector<float>& x)
+{
+  FILE* fp = fopen(fileName, "wb");
+  if (!fp)
+    {
+    return 0;
+    }
+  char header[84];
+  memset(header, ' ', 84);
+  // A bogus count, which must be ignored.
+  memset(header + 80, 0, 4);
+  fwrite(header, 1, 84, fp);
+  size_t numTris = x.size()/9;
+  for (size_t i = 0; i < numTris; ++i)
+    {
+    float facet[12] = { 0.0f, 0.0f, 1.0f };
+    memcpy(facet + 3, &x[9*i], 9*sizeof(float));
+    vtkByteSwap::Swap4LERange(facet, 12);
+    fwrite(facet, 4, 12, fp);
+    // The last facet has no attribute.
+    if (i + 1 < numTris)
+      {
+      fwrite(header, 1, 2, fp);
+      }
+    }
+  fclose(fp);
+  return 1;
+}
+
+// Write the triangles as ASCII and set x to the values fscanf() reads.
+static int WriteASCII(const char* fileName, vtkstd::vector<float>& x)
+{
+  FILE* fp = fopen(fileName, "w");
+  if (!fp)
+    {
+    return 0;
+    }
+  size_t numTris = x.size()/9;
+  fprintf(fp, "solid first\n");
+  for (size_t i = 0; i < numTris; ++i)
+    {
+    if (i == numTris/3)
+      {
+      fprintf(fp, "endsolid first\nsolid second\n");
+      }
+    fprintf(fp, " facet normal 0 0 1\n  outer loop\n");
+    for (int j = 0; j < 3; ++j)
+      {
+      fprintf(fp, "   vertex");
+      for (int k = 0; k < 3; ++k)
+        {
+        float& v = x[9*i + 3*j + k];
+        char token[64];
+        switch (vtkMath::Floor(vtkMath::Random(0, 6)))
+          {
+          case 0: sprintf(token, "%e", v); break;
+          case 1: sprintf(token, "%.9g", v); break;
+          case 2: sprintf(token, "%+.3E", v); break;
+          case 3: sprintf(token, "%f", v); break;
+          case 4: sprintf(token, "%.12e", v); break;
+          default: sprintf(token, "%g", v); break;
+          }
+        sscanf(token, "%f", &v);
+        fprintf(fp, " %s", token);
+        }
+      fprintf(fp, "\n");
+      }
+    fprintf(fp, "  endloop\n endfacet\n");
+    }
+  fprintf(fp, "endsolid second\n");
+  fclose(fp);
+  return 1;
+}
+
+// The output of the reader before the points were merged as they are
+// read.
+static vtkPolyData* Merge(const vtkstd::vector<float>& x)
+{
+  size_t numTris = x.size()/9;
+  vtkPoints* newPts = vtkPoints::New();
+  size_t i;
+  for (i = 0; i < 3*numTris; ++i)
+    {
+    newPts->InsertNextPoint(&x[3*i]);
+    }
+  vtkPoints* points = vtkPoints::New();
+  vtkCellArray* polys = vtkCellArray::New();
+  vtkFloatArray* scalars = vtkFloatArray::New();
+  vtkMergePoints* locator = vtkMergePoints::New();
+  locator->InitPointInsertion(points, newPts->GetBounds());
+  for (i = 0; i < numTris; ++i)
+    {
+    vtkIdType ids[3];
+    for (int j = 0; j < 3; ++j)
+      {
+      locator->InsertUniquePoint(newPts->GetPoint(3*i + j), ids[j]);
+      }
+    if (ids[0] != ids[1] && ids[0] != ids[2] && ids[1] != ids[2])
+      {
+      polys->InsertNextCell(3, ids);
+      scalars->InsertNextValue(i < numTris/3 ? 0.0f : 1.0f);
+      }
+    }
+  vtkPolyData* output = vtkPolyData::New();
+  output->SetPoints(points);
+  output->SetPolys(polys);
+  output->GetCellData()->SetScalars(scalars);
+  locator->Delete();
+  scalars->Delete();
+  polys->Delete();
+  points->Delete();
+  newPts->Delete();
+  return output;
+}
+
+static int CompareArrays(vtkDataArray* a, vtkDataArray* b)
+{
+  return a && b && a->GetDataType() == b->GetDataType() &&
+    a->GetNumberOfTuples() == b->GetNumberOfTuples() &&
+    a->GetNumberOfComponents() == b->GetNumberOfComponents() &&
+    memcmp(a->GetVoidPointer(0), b->GetVoidPointer(0),
+           a->GetNumberOfTuples()*a->GetNumberOfComponents()*
+           a->GetDataTypeSize()) == 0;
+}
+
+static int Read(const char* fileName, const vtkstd::vector<float>& x,
+                vtkPolyData* expected, int merging, int scalarTags,
+                vtkPointLocator* locator, int numThreads)
+{
+  vtkTaskScheduler::GetGlobalScheduler()->SetNumberOfThreads(numThreads);
+  vtkSTLReader* reader = vtkSTLReader::New();
+  reader->SetFileName(fileName);
+  reader->SetMerging(merging);
+  reader->SetScalarTags(scalarTags);
+  reader->SetLocator(locator);
+  reader->Update();
+  vtkPolyData* output = reader->GetOutput();
+
+  int ok = 1;
+  vtkIdType numTris = static_cast<vtkIdType>(x.size()/9);
+  if (merging)
+    {
+    ok = output->GetNumberOfPoints() < 3*numTris &&
+      CompareArrays(output->GetPoints()->GetData(),
+                    expected->GetPoints()->GetData()) &&
+      CompareArrays(output->GetPolys()->GetData(),
+                    expected->GetPolys()->GetData()) &&
+      (!scalarTags ||
+       CompareArrays(output->GetCellData()->GetScalars(),
+                     expected->GetCellData()->GetScalars()));
+    }
+  else
+    {
+    vtkIdTypeArray* cells = output->GetPolys()->GetData();
+    ok = output->GetNumberOfPoints() == 3*numTris &&
+      output->GetNumberOfPolys() == numTris &&
+      memcmp(output->GetPoints()->GetVoidPointer(0), &x[0],
+             x.size()*sizeof(float)) == 0;
+    for (vtkIdType i = 0; ok && i < 4*numTris; ++i)
+      {
+      ok = (cells->GetValue(i) == (i % 4 ? 3*(i/4) + i % 4 - 1 : 3));
+      }
+    }
+  if (!ok)
+    {
+    cerr << "Reading " << fileName << " with merging " << merging
+         << ", scalar tags " << scalarTags << ", "
+         << (locator ? locator->GetClassName() : "no locator") << " and "
+         << numThreads << " threads failed\n";
+    }
+  reader->Delete();
+  return ok;
+}
+
+int TestSTLReader(int, char *[])
+{
+  vtkMath::RandomSeed(8775070);
+  vtkstd::vector<float> x;
+  MakeTriangles(x);
+  const char* binaryName = "TestSTLReaderBinary.stl";
+  const char* asciiName = "TestSTLReaderASCII.stl";
+  if (!WriteBinary(binaryName, x))
+    {
+    cerr << "Cannot write " << binaryName << "\n";
+    return 1;
+    }
+  vtkPolyData* expected = Merge(x);
+  int ok = Read(binaryName, x, expected, 1, 0, 0, 1);
+  ok = Read(binaryName, x, expected, 0, 0, 0, 1) && ok;
+  expected->Delete();
+  remove(binaryName);
+
+  if (!WriteASCII(asciiName, x))
+    {
+    cerr << "Cannot write " << asciiName << "\n";
+    return 1;
+    }
+  expected = Merge(x);
+  ok = Read(asciiName, x, expected, 1, 1, 0, 1) && ok;
+  ok = Read(asciiName, x, expected, 1, 1, 0, 4) && ok;
+  ok = Read(asciiName, x, expected, 0, 0, 0, 4) && ok;
+  vtkPointLocator* locator = vtkPointLocator::New();
+  locator->SetTolerance(0.0);
+  ok = Read(asciiName, x, expected, 1, 1, locator, 4) && ok;
+  locator->Delete();
+  expected->Delete();
+  remove(asciiName);
+  return ok ? 0 : 1;
+}
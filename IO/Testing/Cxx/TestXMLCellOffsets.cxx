@@ -0,0 +1,170 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLCellOffsets.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of reading XML cells into offsets and connectivity arrays.
+// .SECTION Description
+// Writes an unstructured grid of mixed cells and a polydata in several
+// pieces, reads them back with StoreCellOffsets on and off and compares
+// the cells.  With StoreCellOffsets on, the grid cells must stay in the
+// offsets layout.
+
+#include "vtkCellArray.h"
+#include "vtkIdList.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkXMLPolyDataReader.h"
+#include "vtkXMLPolyDataWriter.h"
+#include "vtkXMLUnstructuredGridReader.h"
+#include "vtkXMLUnstructuredGridWriter.h"
+#include "vtksys/SystemTools.hxx"
+
+static vtkPoints *MakePoints(vtkIdType numPoints)
+{
+  vtkPoints *points = vtkPoints::New();
+  for (vtkIdType i = 0; i < numPoints; ++i)
+    {
+    points->InsertNextPoint(i*0.1, (i % 13)*1.0, (i % 29)*-0.5);
+    }
+  return points;
+}
+
+static int CompareCells(vtkDataSet *expected, vtkDataSet *actual,
+                        const char *name)
+{
+  if (actual->GetNumberOfCells() != expected->GetNumberOfCells() ||
+      actual->GetNumberOfPoints() != expected->GetNumberOfPoints())
+    {
+    cerr << name << ": wrong number of cells or points\n";
+    return 1;
+    }
+  vtkIdList *a = vtkIdList::New();
+  vtkIdList *b = vtkIdList::New();
+  int retVal = 0;
+  for (vtkIdType i = 0; !retVal && i < expected->GetNumberOfCells(); ++i)
+    {
+    expected->GetCellPoints(i, a);
+    actual->GetCellPoints(i, b);
+    retVal = (a->GetNumberOfIds() != b->GetNumberOfIds() ||
+              expected->GetCellType(i) != actual->GetCellType(i));
+    for (vtkIdType j = 0; !retVal && j < a->GetNumberOfIds(); ++j)
+      {
+      retVal = (a->GetId(j) != b->GetId(j));
+      }
+    if (retVal)
+      {
+      cerr << name << ": cell " << i << " differs\n";
+      }
+    }
+  a->Delete();
+  b->Delete();
+  return retVal;
+}
+
+static int TestUnstructuredGrid()
+{
+  int retVal = 0;
+  vtkUnstructuredGrid *grid = vtkUnstructuredGrid::New();
+  vtkPoints *points = MakePoints(1000);
+  grid->SetPoints(points);
+  points->Delete();
+  grid->Allocate(996);
+  for (vtkIdType i = 0; i < 996; ++i)
+    {
+    vtkIdType ids[4] = { i, i + 1, i + 2, i + 3 };
+    int type = (i % 3 == 0 ? VTK_TRIANGLE :
+                (i % 3 == 1 ? VTK_QUAD : VTK_TETRA));
+    grid->InsertNextCell(type, (type == VTK_TRIANGLE ? 3 : 4), ids);
+    }
+
+  const char *fileName = "TestXMLCellOffsets.vtu";
+  vtkXMLUnstructuredGridWriter *writer = vtkXMLUnstructuredGridWriter::New();
+  writer->SetInput(grid);
+  writer->SetFileName(fileName);
+  writer->SetNumberOfPieces(3);
+  writer->Write();
+  writer->Delete();
+
+  for (int store = 0; store < 2; ++store)
+    {
+    vtkXMLUnstructuredGridReader *reader =
+      vtkXMLUnstructuredGridReader::New();
+    reader->SetFileName(fileName);
+    reader->SetStoreCellOffsets(store);
+    reader->Update();
+    vtkUnstructuredGrid *output = reader->GetOutput();
+    retVal |= CompareCells(grid, output, "Unstructured grid");
+    if (output->GetCells()->IsStorageInterleaved() == store)
+      {
+      cerr << "Unstructured grid: StoreCellOffsets " << store
+           << " gave the wrong layout\n";
+      retVal = 1;
+      }
+    reader->Delete();
+    }
+
+  vtksys::SystemTools::RemoveFile(fileName);
+  grid->Delete();
+  return retVal;
+}
+
+static int TestPolyData()
+{
+  int retVal = 0;
+  vtkPolyData *polyData = vtkPolyData::New();
+  vtkPoints *points = MakePoints(500);
+  polyData->SetPoints(points);
+  points->Delete();
+  vtkCellArray *polys = vtkCellArray::New();
+  vtkCellArray *lines = vtkCellArray::New();
+  for (vtkIdType i = 0; i < 497; ++i)
+    {
+    vtkIdType ids[4] = { i, i + 1, i + 2, i + 3 };
+    polys->InsertNextCell((i % 2 ? 3 : 4), ids);
+    if (i % 5 == 0)
+      {
+      lines->InsertNextCell(2, ids);
+      }
+    }
+  polyData->SetPolys(polys);
+  polyData->SetLines(lines);
+  polys->Delete();
+  lines->Delete();
+
+  const char *fileName = "TestXMLCellOffsets.vtp";
+  vtkXMLPolyDataWriter *writer = vtkXMLPolyDataWriter::New();
+  writer->SetInput(polyData);
+  writer->SetFileName(fileName);
+  writer->SetNumberOfPieces(2);
+  writer->Write();
+  writer->Delete();
+
+  vtkXMLPolyDataReader *reader = vtkXMLPolyDataReader::New();
+  reader->SetFileName(fileName);
+  reader->StoreCellOffsetsOn();
+  reader->Update();
+  retVal |= CompareCells(polyData, reader->GetOutput(), "Polydata");
+  reader->Delete();
+
+  vtksys::SystemTools::RemoveFile(fileName);
+  polyData->Delete();
+  return retVal;
+}
+
+int TestXMLCellOffsets(int, char *[])
+{
+  int retVal = TestUnstructuredGrid();
+  retVal |= TestPolyData();
+  return retVal;
+}
@@ -0,0 +1,160 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLCompressionThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the threaded compression of the XML writers and readers.
+// .SECTION Description
+// Writes an image with compressed binary and appended data on one and on
+// several threads, checks that the files are identical, and reads them
+// back on several threads.  The block size is small so that the arrays
+// span many batches of blocks, and the big endian files are byte swapped.
+
+#include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkMultiThreader.h"
+#include "vtkPointData.h"
+#include "vtkShortArray.h"
+#include "vtkTaskScheduler.h"
+#include "vtkXMLImageDataReader.h"
+#include "vtkXMLImageDataWriter.h"
+#include "vtksys/SystemTools.hxx"
+
+#include <vtksys/ios/sstream>
+#include <vtkstd/string>
+
+#define VTK_TEST_DIM 37
+
+static vtkstd::string ReadTestFile(const char *fileName)
+{
+  ifstream file(fileName, ios::in | ios::binary);
+  vtksys_ios::ostringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+static int WriteTestFile(vtkImageData *image, const char *fileName,
+                         int dataMode, int byteOrder, int numThreads)
+{
+  vtkXMLImageDataWriter *writer = vtkXMLImageDataWriter::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetDataMode(dataMode);
+  writer->SetByteOrder(byteOrder);
+  writer->SetIdTypeToInt32();
+  writer->SetBlockSize(1024);
+  writer->SetNumberOfThreads(numThreads);
+  int result = writer->Write();
+  writer->Delete();
+  return result;
+}
+
+static int CompareArrays(vtkDataArray *expected, vtkDataArray *actual,
+                         const char *name)
+{
+  if (!actual ||
+      actual->GetNumberOfTuples() != expected->GetNumberOfTuples() ||
+      actual->GetNumberOfComponents() != expected->GetNumberOfComponents())
+    {
+    cerr << name << ": array " << expected->GetName() << " missing\n";
+    return 1;
+    }
+  for (vtkIdType i = 0; i < expected->GetNumberOfTuples(); ++i)
+    {
+    for (int c = 0; c < expected->GetNumberOfComponents(); ++c)
+      {
+      if (actual->GetComponent(i, c) != expected->GetComponent(i, c))
+        {
+        cerr << name << ": array " << expected->GetName()
+             << " differs at tuple " << i << "\n";
+        return 1;
+        }
+      }
+    }
+  return 0;
+}
+
+int TestXMLCompressionThreads(int, char *[])
+{
+  int retVal = 0;
+  vtkTaskScheduler::GetGlobalScheduler()->SetNumberOfThreads(4);
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+
+  vtkImageData *image = vtkImageData::New();
+  image->SetDimensions(VTK_TEST_DIM, VTK_TEST_DIM, VTK_TEST_DIM);
+  vtkDoubleArray *doubles = vtkDoubleArray::New();
+  doubles->SetName("Doubles");
+  doubles->SetNumberOfComponents(3);
+  vtkShortArray *shorts = vtkShortArray::New();
+  shorts->SetName("Shorts");
+  vtkIdTypeArray *ids = vtkIdTypeArray::New();
+  ids->SetName("Ids");
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+    doubles->InsertNextTuple3(i*0.25, (i % 97)*1.5, -1.0*i);
+    shorts->InsertNextValue(static_cast<short>((i*7919) % 30011));
+    ids->InsertNextValue(i*3 % 1000003);
+    }
+  image->GetPointData()->SetScalars(doubles);
+  image->GetPointData()->AddArray(shorts);
+  image->GetPointData()->AddArray(ids);
+  doubles->Delete();
+  shorts->Delete();
+  ids->Delete();
+
+  const char *serialName = "TestXMLCompressionThreadsSerial.vti";
+  const char *threadedName = "TestXMLCompressionThreads.vti";
+  int dataModes[2] = { vtkXMLWriter::Binary, vtkXMLWriter::Appended };
+  int byteOrders[2] = { vtkXMLWriter::LittleEndian, vtkXMLWriter::BigEndian };
+  for (int test = 0; test < 4; ++test)
+    {
+    vtksys_ios::ostringstream name;
+    name << (test / 2 ? "Appended" : "Binary")
+         << (test % 2 ? " big endian" : " little endian");
+    if (!WriteTestFile(image, serialName, dataModes[test / 2],
+                       byteOrders[test % 2], 1) ||
+        !WriteTestFile(image, threadedName, dataModes[test / 2],
+                       byteOrders[test % 2], 4))
+      {
+      cerr << name.str() << ": could not write the files\n";
+      retVal = 1;
+      continue;
+      }
+    if (ReadTestFile(serialName) != ReadTestFile(threadedName))
+      {
+      cerr << name.str() << ": threaded file differs\n";
+      retVal = 1;
+      }
+
+    // The parser of the reader takes the global default number of
+    // threads.
+    vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+    vtkXMLImageDataReader *reader = vtkXMLImageDataReader::New();
+    reader->SetFileName(threadedName);
+    reader->Update();
+    vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
+    vtkPointData *pd = reader->GetOutput()->GetPointData();
+    retVal |= CompareArrays(image->GetPointData()->GetArray("Doubles"),
+                            pd->GetArray("Doubles"), name.str().c_str());
+    retVal |= CompareArrays(image->GetPointData()->GetArray("Shorts"),
+                            pd->GetArray("Shorts"), name.str().c_str());
+    retVal |= CompareArrays(image->GetPointData()->GetArray("Ids"),
+                            pd->GetArray("Ids"), name.str().c_str());
+    reader->Delete();
+    }
+
+  vtksys::SystemTools::RemoveFile(serialName);
+  vtksys::SystemTools::RemoveFile(threadedName);
+  image->Delete();
+  return retVal;
+}
@@ -0,0 +1,291 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLMappedArrays.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the memory mapped reading of raw appended XML arrays.
+// .SECTION Description
+// Checks that the release function of a user array is called once when
+// the array stops using it.  Then writes an image and an unstructured
+// grid with raw appended data, reads them back with MapAppendedData on
+// and checks the arrays, including one whose odd length leaves the next
+// arrays unaligned in the file.  Modifying a read array must not change
+// the file.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCharArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkFieldData.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkXMLImageDataReader.h"
+#include "vtkXMLImageDataWriter.h"
+#include "vtkXMLUnstructuredGridReader.h"
+#include "vtkXMLUnstructuredGridWriter.h"
+#include "vtksys/SystemTools.hxx"
+
+#include <vtksys/ios/sstream>
+#include <vtkstd/string>
+
+static int ReleaseCount = 0;
+static void *ReleasedArray = 0;
+
+static void TestRelease(void *array, void *clientData)
+{
+  ++ReleaseCount;
+  ReleasedArray = array;
+  if (clientData != &ReleaseCount)
+    {
+    ReleasedArray = 0;
+    }
+}
+
+static vtkstd::string ReadTestFile(const char *fileName)
+{
+  ifstream file(fileName, ios::in | ios::binary);
+  vtksys_ios::ostringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+static int CompareArrays(vtkDataArray *expected, vtkDataArray *actual,
+                         const char *name)
+{
+  if (!actual ||
+      actual->GetNumberOfTuples() != expected->GetNumberOfTuples() ||
+      actual->GetNumberOfComponents() != expected->GetNumberOfComponents())
+    {
+    cerr << name << ": array " << expected->GetName() << " missing\n";
+    return 1;
+    }
+  for (vtkIdType i = 0; i < expected->GetNumberOfTuples(); ++i)
+    {
+    for (int c = 0; c < expected->GetNumberOfComponents(); ++c)
+      {
+      if (actual->GetComponent(i, c) != expected->GetComponent(i, c))
+        {
+        cerr << name << ": array " << expected->GetName()
+             << " differs at tuple " << i << "\n";
+        return 1;
+        }
+      }
+    }
+  return 0;
+}
+
+static int TestReleaseFunction()
+{
+  int retVal = 0;
+  float buffer[16];
+  for (int i = 0; i < 16; ++i)
+    {
+    buffer[i] = static_cast<float>(i);
+    }
+
+  // Growing the array copies the user array and releases it.
+  vtkFloatArray *array = vtkFloatArray::New();
+  array->SetArray(buffer, 16, 1);
+  array->SetUserArrayReleaseFunction(&TestRelease, &ReleaseCount);
+  array->InsertNextValue(16.0f);
+  if (ReleaseCount != 1 || ReleasedArray != buffer ||
+      array->GetValue(15) != 15.0f || array->GetValue(16) != 16.0f)
+    {
+    cerr << "Resizing did not release the user array once\n";
+    retVal = 1;
+    }
+  array->Delete();
+  if (ReleaseCount != 1)
+    {
+    cerr << "The release function was called again\n";
+    retVal = 1;
+    }
+
+  // Setting the same array again keeps it, and deleting releases it.
+  ReleaseCount = 0;
+  array = vtkFloatArray::New();
+  array->SetArray(buffer, 16, 1);
+  array->SetUserArrayReleaseFunction(&TestRelease, &ReleaseCount);
+  array->SetArray(buffer, 8, 1);
+  if (ReleaseCount != 0)
+    {
+    cerr << "Setting the same user array released it\n";
+    retVal = 1;
+    }
+  array->Delete();
+  if (ReleaseCount != 1 || ReleasedArray != buffer)
+    {
+    cerr << "Deleting the array did not release the user array\n";
+    retVal = 1;
+    }
+  return retVal;
+}
+
+static int TestImage()
+{
+  int retVal = 0;
+  vtkImageData *image = vtkImageData::New();
+  image->SetDimensions(31, 17, 11);
+  vtkIdType numPoints = image->GetNumberOfPoints();
+  vtkIdType numCells = image->GetNumberOfCells();
+  vtkCharArray *chars = vtkCharArray::New();
+  chars->SetName("Chars");
+  vtkDoubleArray *doubles = vtkDoubleArray::New();
+  doubles->SetName("Doubles");
+  doubles->SetNumberOfComponents(3);
+  vtkIntArray *ints = vtkIntArray::New();
+  ints->SetName("Ints");
+  vtkFloatArray *floats = vtkFloatArray::New();
+  floats->SetName("Floats");
+  vtkIdType i;
+  for (i = 0; i < numPoints; ++i)
+    {
+    chars->InsertNextValue(static_cast<char>(i % 101));
+    doubles->InsertNextTuple3(i*0.5, -1.0*i, (i % 7)*0.25);
+    }
+  for (i = 0; i < numCells; ++i)
+    {
+    ints->InsertNextValue(static_cast<int>(i*31 % 9973));
+    }
+  for (i = 0; i < 5; ++i)
+    {
+    floats->InsertNextValue(static_cast<float>(i)*1.5f);
+    }
+  // The odd number of chars leaves the doubles unaligned in the file.
+  image->GetPointData()->AddArray(chars);
+  image->GetPointData()->AddArray(doubles);
+  image->GetCellData()->AddArray(ints);
+  image->GetFieldData()->AddArray(floats);
+  chars->Delete();
+  doubles->Delete();
+  ints->Delete();
+  floats->Delete();
+
+  const char *fileName = "TestXMLMappedArrays.vti";
+  vtkXMLImageDataWriter *writer = vtkXMLImageDataWriter::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetDataModeToAppended();
+  writer->EncodeAppendedDataOff();
+  writer->SetCompressor(0);
+  writer->Write();
+  writer->Delete();
+  vtkstd::string contents = ReadTestFile(fileName);
+
+  vtkXMLImageDataReader *reader = vtkXMLImageDataReader::New();
+  reader->SetFileName(fileName);
+  reader->MapAppendedDataOn();
+  reader->Update();
+  vtkImageData *output = reader->GetOutput();
+  vtkPointData *pd = output->GetPointData();
+  retVal |= CompareArrays(image->GetPointData()->GetArray("Chars"),
+                          pd->GetArray("Chars"), "Image");
+  retVal |= CompareArrays(image->GetPointData()->GetArray("Doubles"),
+                          pd->GetArray("Doubles"), "Image");
+  retVal |= CompareArrays(image->GetCellData()->GetArray("Ints"),
+                          output->GetCellData()->GetArray("Ints"), "Image");
+  retVal |= CompareArrays(image->GetFieldData()->GetArray("Floats"),
+                          output->GetFieldData()->GetArray("Floats"),
+                          "Image");
+
+  // Changes to the arrays stay in memory.
+  vtkDataArray *readInts = output->GetCellData()->GetArray("Ints");
+  if (readInts)
+    {
+    for (i = 0; i < readInts->GetNumberOfTuples(); ++i)
+      {
+      readInts->SetComponent(i, 0, -1);
+      }
+    }
+  reader->Delete();
+  if (ReadTestFile(fileName) != contents)
+    {
+    cerr << "Modifying a read array changed the file\n";
+    retVal = 1;
+    }
+
+  vtksys::SystemTools::RemoveFile(fileName);
+  image->Delete();
+  return retVal;
+}
+
+static int TestUnstructuredGrid()
+{
+  int retVal = 0;
+  vtkUnstructuredGrid *grid = vtkUnstructuredGrid::New();
+  vtkPoints *points = vtkPoints::New();
+  vtkIdType i;
+  for (i = 0; i < 1000; ++i)
+    {
+    points->InsertNextPoint(i*0.1, (i % 13)*1.0, (i % 29)*-0.5);
+    }
+  grid->SetPoints(points);
+  points->Delete();
+  grid->Allocate(998);
+  for (i = 0; i < 998; ++i)
+    {
+    vtkIdType ids[3] = { i, i + 1, i + 2 };
+    grid->InsertNextCell(VTK_TRIANGLE, 3, ids);
+    }
+  vtkDoubleArray *cellValues = vtkDoubleArray::New();
+  cellValues->SetName("CellValues");
+  for (i = 0; i < 998; ++i)
+    {
+    cellValues->InsertNextValue(i*0.75);
+    }
+  grid->GetCellData()->AddArray(cellValues);
+  cellValues->Delete();
+
+  const char *fileName = "TestXMLMappedArrays.vtu";
+  vtkXMLUnstructuredGridWriter *writer = vtkXMLUnstructuredGridWriter::New();
+  writer->SetInput(grid);
+  writer->SetFileName(fileName);
+  writer->SetDataModeToAppended();
+  writer->EncodeAppendedDataOff();
+  writer->SetCompressor(0);
+  writer->Write();
+  writer->Delete();
+
+  vtkXMLUnstructuredGridReader *reader = vtkXMLUnstructuredGridReader::New();
+  reader->SetFileName(fileName);
+  reader->MapAppendedDataOn();
+  reader->Update();
+  vtkUnstructuredGrid *output = reader->GetOutput();
+  if (output->GetNumberOfCells() != grid->GetNumberOfCells())
+    {
+    cerr << "Unstructured grid: wrong number of cells\n";
+    retVal = 1;
+    }
+  retVal |= CompareArrays(grid->GetPoints()->GetData(),
+                          output->GetPoints()->GetData(),
+                          "Unstructured grid");
+  retVal |= CompareArrays(grid->GetCellData()->GetArray("CellValues"),
+                          output->GetCellData()->GetArray("CellValues"),
+                          "Unstructured grid");
+  reader->Delete();
+
+  vtksys::SystemTools::RemoveFile(fileName);
+  grid->Delete();
+  return retVal;
+}
+
+int TestXMLMappedArrays(int, char *[])
+{
+  int retVal = TestReleaseFunction();
+  retVal |= TestImage();
+  retVal |= TestUnstructuredGrid();
+  return retVal;
+}
@@ -33,6 +33,11 @@ void vtkDataCompressor::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent);
 }
 
+//----------------------------------------------------------------------------
+void vtkDataCompressor::SetDataWordSize(int)
+{
+}
+
 //----------------------------------------------------------------------------
 unsigned long
 vtkDataCompressor::Compress(const unsigned char* uncompressedData,
@@ -38,6 +38,12 @@ public:
   // size of the output buffer that can be passed to the four-argument
   // Compress method.
   virtual unsigned long GetMaximumCompressionSpace(unsigned long size)=0;
+
+  // Description:
+  // Tell the compressor the size in bytes of the words of the data to be
+  // compressed next, for compressors that can use it.  The default
+  // implementation ignores it.
+  virtual void SetDataWordSize(int wordSize);
   
   // Description:
   // Compress the given input data buffer into the given output
@@ -18,6 +18,7 @@
 #include "vtkByteSwap.h"
 #include "vtkCellData.h"
 #include "vtkCharArray.h"
+#include "vtkDecimalParser.h"
 #include "vtkDoubleArray.h"
 #include "vtkErrorCode.h"
 #include "vtkFieldData.h"
@@ -33,6 +34,8 @@
 #include "vtkRectilinearGrid.h"
 #include "vtkShortArray.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTaskScheduler.h"
+#include "vtkTimerLog.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnsignedIntArray.h"
 #include "vtkUnsignedLongArray.h"
@@ -561,6 +564,7 @@ int vtkDataReader::IsFileValid(const char *dstype)
 // no geometry was defined).
 int vtkDataReader::ReadCellData(vtkDataSet *ds, int numCells)
 {
+  vtkTimerLogTraceScope scope("IO", this, "ReadCellData");
   char line[256];
   vtkDataSetAttributes *a=ds->GetCellData();
 
@@ -689,6 +693,7 @@ int vtkDataReader::ReadCellData(vtkDataSet *ds, int numCells)
 // no geometry was defined).
 int vtkDataReader::ReadPointData(vtkDataSet *ds, int numPts)
 {
+  vtkTimerLogTraceScope scope("IO", this, "ReadPointData");
   char line[256];
   vtkDataSetAttributes *a=ds->GetPointData();
 
@@ -829,22 +834,548 @@ int vtkReadBinaryData(istream *IS, T *data, int numTuples, int numComp)
   return 1;
 }
 
-// General templated function to read data of various types.
+// The ASCII values of arrays are parsed from blocks of characters read
+// from the stream instead of with the stream extraction operators, which
+// are slow.  Tokens are parsed here only when their value is computed
+// exactly, or with a single rounding for reals as strtod() does; the
+// other tokens are extracted one by one with the operators, so that the
+// values are the same.  After a token that is not a value by itself the
+// operators read the rest of the array from the stream.  The characters
+// read past the last value are given back to the stream by going back to
+// the start of the block and skipping the characters used, which works
+// for streams in text mode.
+
+// The largest size of the blocks read, for each thread.
+#define VTK_DATA_READER_BLOCK_SIZE 1048576
+
+// The size of the first block read for each value of an array.
+#define VTK_DATA_READER_BYTES_PER_VALUE 32
+
+// Smaller arrays are read with the extraction operators.
+#define VTK_DATA_READER_MIN_FAST_VALUES 256
+
+static inline int vtkDataReaderIsSpace(char c)
+{
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' ||
+    c == '\f';
+}
+
+// Parse the token [p, end) as a decimal integer of at most 9 significant
+// digits.  Return 0 for other tokens, and for negative ones if sign is 0.
+static int vtkDataReaderParseInteger(const char* p, const char* end,
+                                     int sign, long& value)
+{
+  int negative = 0;
+  if (*p == '-' || *p == '+')
+    {
+    negative = (*p++ == '-');
+    if (negative && !sign)
+      {
+      return 0;
+      }
+    }
+  if (p == end)
+    {
+    return 0;
+    }
+  while (p < end && *p == '0')
+    {
+    ++p;
+    }
+  if (end - p > 9)
+    {
+    return 0;
+    }
+  long v = 0;
+  for (; p < end; ++p)
+    {
+    if (!vtkDecimalParserIsDigit(*p))
+      {
+      return 0;
+      }
+    v = 10*v + (*p - '0');
+    }
+  value = negative ? -v : v;
+  return 1;
+}
+
+// Parse a token into a value of each type read by the extraction
+// operators.  chars are read as ints, as vtkDataReader::Read() does.
+static inline int vtkDataReaderParseValue(const char* p, const char* end,
+                                          char* value)
+{
+  long v;
+  if (!vtkDataReaderParseInteger(p, end, 1, v))
+    {
+    return 0;
+    }
+  *value = (char) v;
+  return 1;
+}
+
+static inline int vtkDataReaderParseValue(const char* p, const char* end,
+                                          unsigned char* value)
+{
+  long v;
+  if (!vtkDataReaderParseInteger(p, end, 1, v))
+    {
+    return 0;
+    }
+  *value = (unsigned char) v;
+  return 1;
+}
+
+static inline int vtkDataReaderParseValue(const char* p, const char* end,
+                                          short* value)
+{
+  long v;
+  if (!vtkDataReaderParseInteger(p, end, 1, v) ||
+      v < VTK_SHORT_MIN || v > VTK_SHORT_MAX)
+    {
+    return 0;
+    }
+  *value = static_cast<short>(v);
+  return 1;
+}
+
+static inline int vtkDataReaderParseValue(const char* p, const char* end,
+                                          unsigned short* value)
+{
+  long v;
+  if (!vtkDataReaderParseInteger(p, end, 0, v) || v > VTK_UNSIGNED_SHORT_MAX)
+    {
+    return 0;
+    }
+  *value = static_cast<unsigned short>(v);
+  return 1;
+}
+
+static inline int vtkDataReaderParseValue(const char* p, const char* end,
+                                          int* value)
+{
+  long v;
+  if (!vtkDataReaderParseInteger(p, end, 1, v))
+    {
+    return 0;
+    }
+  *value = static_cast<int>(v);
+  return 1;
+}
+
+static inline int vtkDataReaderParseValue(const char* p, const char* end,
+                                          unsigned int* value)
+{
+  long v;
+  if (!vtkDataReaderParseInteger(p, end, 0, v))
+    {
+    return 0;
+    }
+  *value = static_cast<unsigned int>(v);
+  return 1;
+}
+
+static inline int vtkDataReaderParseValue(const char* p, const char* end,
+                                          long* value)
+{
+  return vtkDataReaderParseInteger(p, end, 1, *value);
+}
+
+static inline int vtkDataReaderParseValue(const char* p, const char* end,
+                                          unsigned long* value)
+{
+  long v;
+  if (!vtkDataReaderParseInteger(p, end, 0, v))
+    {
+    return 0;
+    }
+  *value = static_cast<unsigned long>(v);
+  return 1;
+}
+
+static inline int vtkDataReaderParseValue(const char* p, const char* end,
+                                          float* value)
+{
+  return vtkDecimalParserParseFloat(p, end, *value);
+}
+
+static inline int vtkDataReaderParseValue(const char* p, const char* end,
+                                          double* value)
+{
+  return vtkDecimalParserParseDouble(p, end, *value);
+}
+
+// Extract a token with the extraction operator, as vtkDataReader::Read()
+// does.  Return 0 unless the whole token is the value.
 template <class T>
-int vtkReadASCIIData(vtkDataReader *self, T *data, int numTuples, int numComp)
+int vtkDataReaderExtractValue(const char* p, const char* end, T* value)
+{
+  istrstream is(p, static_cast<int>(end - p));
+  is >> *value;
+  return !is.fail() && is.eof();
+}
+
+static int vtkDataReaderExtractValue(const char* p, const char* end,
+                                     char* value)
+{
+  int v;
+  if (!vtkDataReaderExtractValue(p, end, &v))
+    {
+    return 0;
+    }
+  *value = (char) v;
+  return 1;
+}
+
+static int vtkDataReaderExtractValue(const char* p, const char* end,
+                                     unsigned char* value)
+{
+  int v;
+  if (!vtkDataReaderExtractValue(p, end, &v))
+    {
+    return 0;
+    }
+  *value = (unsigned char) v;
+  return 1;
+}
+
+// Parse at most max values from [p, end), which ends with a complete
+// token.  Return the number of values parsed, with stop set to the end of
+// the last one, or to the start of the first token that is not a value
+// by itself if failed is set.
+template <class T>
+vtkIdType vtkDataReaderParseValues(const char* p, const char* end, T* data,
+                                   vtkIdType max, const char*& stop,
+                                   int& failed)
+{
+  vtkIdType count = 0;
+  stop = p;
+  failed = 0;
+  while (count < max)
+    {
+    while (p < end && vtkDataReaderIsSpace(*p))
+      {
+      ++p;
+      }
+    if (p == end)
+      {
+      break;
+      }
+    const char* token = p;
+    while (p < end && !vtkDataReaderIsSpace(*p))
+      {
+      ++p;
+      }
+    if (!vtkDataReaderParseValue(token, p, data + count) &&
+        !vtkDataReaderExtractValue(token, p, data + count))
+      {
+      stop = token;
+      failed = 1;
+      break;
+      }
+    ++count;
+    stop = p;
+    }
+  return count;
+}
+
+// The blocks of characters read from a stream.  The buffer holds the
+// end of the previous block, from the token cut by its end, followed by
+// the last block read.  Each block after the first is twice as large as
+// the previous one, up to a maximum size.
+class vtkDataReaderBlocks
+{
+public:
+  vtkDataReaderBlocks(istream* is, size_t blockSize, size_t maxBlockSize)
+    {
+    this->IS = is;
+    this->BlockSize = blockSize;
+    this->MaxBlockSize = maxBlockSize;
+    this->Capacity = this->BlockSize;
+    this->Buffer = new char[this->Capacity];
+    this->Size = 0;
+    this->Kept = 0;
+    this->AtEnd = 0;
+    this->Length[0] = this->Length[1] = 0;
+    }
+  ~vtkDataReaderBlocks()
+    {
+    delete [] this->Buffer;
+    }
+
+  // Keep the last keep characters of the buffer, which must be in the
+  // last block, and read the next block after them.  Return 0 if the
+  // position in the stream is not known.
+  int Read(size_t keep)
+    {
+    vtkstd::streampos position = this->IS->tellg();
+    if (position == vtkstd::streampos(-1))
+      {
+      return 0;
+      }
+    if (this->Size > 0)
+      {
+      this->BlockSize = (this->BlockSize < this->MaxBlockSize/2 ?
+                         2*this->BlockSize : this->MaxBlockSize);
+      }
+    if (keep + this->BlockSize > this->Capacity)
+      {
+      this->Capacity = keep + this->BlockSize;
+      char* buffer = new char[this->Capacity];
+      memcpy(buffer, this->Buffer + this->Size - keep, keep);
+      delete [] this->Buffer;
+      this->Buffer = buffer;
+      }
+    else
+      {
+      memmove(this->Buffer, this->Buffer + this->Size - keep, keep);
+      }
+    this->Kept = keep;
+    this->Position[0] = this->Position[1];
+    this->Length[0] = this->Length[1];
+    this->Position[1] = position;
+    this->IS->read(this->Buffer + keep, this->BlockSize);
+    this->Length[1] = static_cast<size_t>(this->IS->gcount());
+    this->Size = keep + this->Length[1];
+    if (this->Length[1] < this->BlockSize)
+      {
+      this->AtEnd = 1;
+      }
+    return 1;
+    }
+
+  // Leave the stream just after the first n characters of the buffer.
+  void Seek(size_t n)
+    {
+    this->IS->clear();
+    if (n >= this->Kept)
+      {
+      this->IS->seekg(this->Position[1]);
+      n -= this->Kept;
+      }
+    else
+      {
+      this->IS->seekg(this->Position[0]);
+      n += this->Length[0] - this->Kept;
+      }
+    if (n > 0)
+      {
+      this->IS->ignore(static_cast<vtkstd::streamsize>(n));
+      }
+    }
+
+  char* Buffer;
+  size_t Size;
+  size_t Kept;
+  int AtEnd;
+
+private:
+  istream* IS;
+  size_t BlockSize;
+  size_t MaxBlockSize;
+  size_t Capacity;
+  vtkstd::streampos Position[2];
+  size_t Length[2];
+};
+
+// The chunks of a block parsed on the threads.
+template <class T>
+struct vtkDataReaderChunks
+{
+  const char** Begin; // the chunks, with the end of the last one
+  T** Data;
+  vtkIdType* Max;
+  vtkIdType* Count;
+  const char** Stop;
+  int* Failed;
+};
+
+template <class T>
+void vtkDataReaderParseChunks(void* arg, vtkIdType begin, vtkIdType end)
+{
+  vtkDataReaderChunks<T>* chunks = static_cast<vtkDataReaderChunks<T>*>(arg);
+  for (vtkIdType i = begin; i < end; ++i)
+    {
+    chunks->Count[i] = vtkDataReaderParseValues(
+      chunks->Begin[i], chunks->Begin[i+1], chunks->Data[i], chunks->Max[i],
+      chunks->Stop[i], chunks->Failed[i]);
+    }
+}
+
+// Parse at most max values of [p, end), which ends with a complete token,
+// splitting it at line ends into chunks parsed on the threads.  Same
+// return values as vtkDataReaderParseValues().
+template <class T>
+vtkIdType vtkDataReaderParseValuesInThreads(const char* p, const char* end,
+                                            T* data, vtkIdType max,
+                                            int numThreads,
+                                            const char*& stop, int& failed)
+{
+  vtkDataReaderChunks<T> chunks;
+  chunks.Begin = new const char*[numThreads+1];
+  chunks.Data = new T*[numThreads];
+  chunks.Max = new vtkIdType[numThreads];
+  chunks.Count = new vtkIdType[numThreads];
+  chunks.Stop = new const char*[numThreads];
+  chunks.Failed = new int[numThreads];
+
+  // The first chunk is parsed into data, the others into buffers large
+  // enough for all their tokens.
+  int numChunks = 0;
+  chunks.Begin[0] = p;
+  while (chunks.Begin[numChunks] < end)
+    {
+    const char* b = chunks.Begin[numChunks];
+    const char* e = b + (end - p)/numThreads;
+    while (e < end && *e != '\n')
+      {
+      ++e;
+      }
+    e = (e < end && numChunks + 1 < numThreads ? e + 1 : end);
+    vtkIdType size = (e - b)/2 + 1;
+    chunks.Max[numChunks] = (size < max ? size : max);
+    chunks.Data[numChunks] =
+      numChunks ? new T[chunks.Max[numChunks]] : data;
+    chunks.Begin[++numChunks] = e;
+    }
+
+  vtkTaskScheduler::GetGlobalScheduler()->ParallelFor(
+    0, numChunks, 1, vtkDataReaderParseChunks<T>, &chunks);
+
+  // Copy the values of the chunks in order until max values or a token
+  // that could not be parsed.  The chunk with the last value is parsed
+  // again to find where it ends.
+  vtkIdType count = 0;
+  stop = p;
+  failed = 0;
+  for (int i = 0; i < numChunks; ++i)
+    {
+    if (count + chunks.Count[i] > max)
+      {
+      count += vtkDataReaderParseValues(chunks.Begin[i], chunks.Begin[i+1],
+                                        data + count, max - count, stop,
+                                        failed);
+      break;
+      }
+    if (i > 0 && chunks.Count[i] > 0)
+      {
+      memcpy(data + count, chunks.Data[i], chunks.Count[i]*sizeof(T));
+      }
+    count += chunks.Count[i];
+    if (chunks.Count[i] > 0 || chunks.Failed[i])
+      {
+      stop = chunks.Stop[i];
+      }
+    if (chunks.Failed[i] || count == max)
+      {
+      failed = chunks.Failed[i];
+      break;
+      }
+    }
+
+  for (int i = 1; i < numChunks; ++i)
+    {
+    delete [] chunks.Data[i];
+    }
+  delete [] chunks.Begin;
+  delete [] chunks.Data;
+  delete [] chunks.Max;
+  delete [] chunks.Count;
+  delete [] chunks.Stop;
+  delete [] chunks.Failed;
+  return count;
+}
+
+// Read at most numValues ASCII values of the stream, and leave it just
+// after the last one.  Return the number of values read; the next ones
+// must be read with the extraction operators.
+template <class T>
+vtkIdType vtkDataReaderReadASCIIValues(istream* is, T* data,
+                                       vtkIdType numValues)
 {
-  int i, j;
+  if (numValues < VTK_DATA_READER_MIN_FAST_VALUES)
+    {
+    return 0;
+    }
+  // The first block is sized for the values, so that reading an array
+  // does not read far past it.
+  int numThreads = vtkTaskScheduler::GetGlobalScheduler()->GetNumberOfThreads();
+  size_t maxBlockSize =
+    numThreads*static_cast<size_t>(VTK_DATA_READER_BLOCK_SIZE);
+  size_t blockSize = maxBlockSize;
+  if (static_cast<size_t>(numValues) <
+      maxBlockSize/VTK_DATA_READER_BYTES_PER_VALUE)
+    {
+    blockSize = static_cast<size_t>(numValues)*VTK_DATA_READER_BYTES_PER_VALUE;
+    }
+  vtkDataReaderBlocks blocks(is, blockSize, maxBlockSize);
+  if (!blocks.Read(0))
+    {
+    is->clear();
+    return 0;
+    }
 
-  for (i=0; i<numTuples; i++)
+  vtkIdType count = 0;
+  size_t resume;
+  for (;;)
     {
-    for (j=0; j<numComp; j++)
+    // The token cut by the end of the block is parsed with the next one.
+    const char* buffer = blocks.Buffer;
+    size_t complete = blocks.Size;
+    if (!blocks.AtEnd)
       {
-      if ( !self->Read(data++) )
+      while (complete > 0 && !vtkDataReaderIsSpace(buffer[complete-1]))
         {
-        vtkGenericWarningMacro(<<"Error reading ascii data!");
-        return 0;
+        --complete;
         }
       }
+
+    const char* stop;
+    int failed;
+    vtkIdType max = numValues - count;
+    if (numThreads > 1 && complete > VTK_DATA_READER_BLOCK_SIZE &&
+        max > static_cast<vtkIdType>(complete/64))
+      {
+      count += vtkDataReaderParseValuesInThreads(buffer, buffer + complete,
+                                                 data + count, max,
+                                                 numThreads, stop, failed);
+      }
+    else
+      {
+      count += vtkDataReaderParseValues(buffer, buffer + complete,
+                                        data + count, max, stop, failed);
+      }
+    resume = stop - buffer;
+    if (count == numValues || failed || blocks.AtEnd)
+      {
+      break;
+      }
+    // A token longer than a block is left to the extraction operators.
+    resume = complete;
+    if (complete < blocks.Kept || !blocks.Read(blocks.Size - complete))
+      {
+      break;
+      }
+    }
+
+  blocks.Seek(resume);
+  return count;
+}
+
+// General templated function to read data of various types.
+template <class T>
+int vtkReadASCIIData(vtkDataReader *self, T *data, int numTuples, int numComp)
+{
+  vtkIdType numValues = static_cast<vtkIdType>(numTuples)*numComp;
+  vtkIdType i = vtkDataReaderReadASCIIValues(self->GetIStream(), data,
+                                             numValues);
+
+  for (; i<numValues; i++)
+    {
+    if ( !self->Read(data+i) )
+      {
+      vtkGenericWarningMacro(<<"Error reading ascii data!");
+      return 0;
+      }
     }
   return 1;
 }
@@ -1074,6 +1605,7 @@ vtkDataArray *vtkDataReader::ReadArray(const char *dataType, int numTuples, int
 // Read point coordinates. Return 0 if error.
 int vtkDataReader::ReadPoints(vtkPointSet *ps, int numPts)
 {
+  vtkTimerLogTraceScope scope("IO", this, "ReadPoints");
   char line[256];
   vtkDataArray *data;
 
@@ -1605,6 +2137,7 @@ int vtkDataReader::ReadLutData(vtkDataSetAttributes *a)
 // Read lookup table. Return 0 if error.
 int vtkDataReader::ReadCells(int size, int *data)
 {
+  vtkTimerLogTraceScope scope("IO", this, "ReadCells");
   char line[256];
   int i;
 
@@ -1623,7 +2156,8 @@ int vtkDataReader::ReadCells(int size, int *data)
     }
   else // ascii
     {
-    for (i=0; i<size; i++)
+    i = static_cast<int>(vtkDataReaderReadASCIIValues(this->IS, data, size));
+    for (; i<size; i++)
       {
       if (!this->Read(data+i))
         {
@@ -1643,6 +2177,7 @@ int vtkDataReader::ReadCells(int size, int *data)
 int vtkDataReader::ReadCells(int size, int *data, 
                              int skip1, int read2, int skip3)
 {
+  vtkTimerLogTraceScope scope("IO", this, "ReadCells");
   char line[256];
   int i, numCellPts, junk, *tmp, *pTmp;
 
@@ -1697,6 +2232,11 @@ int vtkDataReader::ReadCells(int size, int *data,
     }
   else // ascii
     {
+    // without other pieces the cells are read as one chunk, as above.
+    if (skip1 == 0 && skip3 == 0)
+      {
+      return this->ReadCells(size, data);
+      }
     // skip cells before the piece
     for (i=0; i<skip1; i++)
       {
@@ -0,0 +1,176 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkDecimalParser.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkDecimalParser - fast conversion of decimal reals
+// .SECTION Description
+// Functions shared by the ASCII readers to convert a token holding a
+// decimal real without going through the C library.  A token is
+// converted only when its significant digits, without the trailing
+// zeros, and its power of ten are both exact in the floating point type.
+// The value is then the product or the quotient of two exact numbers, so
+// it is rounded once, as strtod() and the extraction operators round it.
+// Other tokens are rejected and must be converted by the caller.
+
+// .SECTION See Also
+// vtkDataReader vtkSTLReader
+// .SECTION Warning
+// Do not include this file in a header file.  It is not installed.
+
+#ifndef __vtkDecimalParser_h
+#define __vtkDecimalParser_h
+
+#include "vtkSystemIncludes.h"
+
+static const double vtkDecimalParserPowersOfTen[] =
+{
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+//----------------------------------------------------------------------------
+static inline int vtkDecimalParserIsDigit(char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+//----------------------------------------------------------------------------
+// Parse the token [p, end) as a decimal real number whose significant
+// digits are at most maxMantissa and whose power of ten is at most
+// maxExponent in magnitude, which must be at most 22.  Return 0 for
+// other tokens.
+static inline int vtkDecimalParserParseReal(const char* p, const char* end,
+                                            double maxMantissa,
+                                            int maxExponent, double& value)
+{
+  int negative = 0;
+  if (p < end && (*p == '-' || *p == '+'))
+    {
+    negative = (*p++ == '-');
+    }
+
+  // Zeros after the last nonzero digit are left out of the mantissa and
+  // go into the power of ten instead.
+  double mantissa = 0.0;
+  int exponent = 0;
+  int zeros = 0;
+  int digits = 0;
+  int fraction = 0;
+  for (; p < end; ++p)
+    {
+    if (*p == '.' && !fraction)
+      {
+      fraction = 1;
+      continue;
+      }
+    if (!vtkDecimalParserIsDigit(*p))
+      {
+      break;
+      }
+    ++digits;
+    exponent -= fraction;
+    if (*p == '0')
+      {
+      zeros += (mantissa != 0.0);
+      continue;
+      }
+    for (; zeros > 0; --zeros)
+      {
+      mantissa *= 10.0;
+      }
+    mantissa = 10.0*mantissa + (*p - '0');
+    if (mantissa > maxMantissa)
+      {
+      return 0;
+      }
+    }
+  if (digits == 0)
+    {
+    return 0;
+    }
+  exponent += zeros;
+
+  if (p < end && (*p == 'e' || *p == 'E'))
+    {
+    int negativeExponent = 0;
+    if (++p < end && (*p == '-' || *p == '+'))
+      {
+      negativeExponent = (*p++ == '-');
+      }
+    if (p == end)
+      {
+      return 0;
+      }
+    int e = 0;
+    for (; p < end && vtkDecimalParserIsDigit(*p); ++p)
+      {
+      e = 10*e + (*p - '0');
+      if (e > 1000)
+        {
+        return 0;
+        }
+      }
+    exponent += (negativeExponent ? -e : e);
+    }
+  if (p != end)
+    {
+    return 0;
+    }
+  if (mantissa != 0.0 && (exponent > maxExponent || exponent < -maxExponent))
+    {
+    return 0;
+    }
+  if (mantissa == 0.0)
+    {
+    value = 0.0;
+    }
+  else if (exponent < 0)
+    {
+    value = mantissa / vtkDecimalParserPowersOfTen[-exponent];
+    }
+  else
+    {
+    value = mantissa * vtkDecimalParserPowersOfTen[exponent];
+    }
+  if (negative)
+    {
+    value = -value;
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+// Parse the token [p, end) as a float.  The mantissa and the power of ten
+// are floats, so the value is rounded once even though the quotient is
+// computed in double first.
+static inline int vtkDecimalParserParseFloat(const char* p, const char* end,
+                                             float& value)
+{
+  double v;
+  if (!vtkDecimalParserParseReal(p, end, 16777216.0, 10, v))
+    {
+    return 0;
+    }
+  value = static_cast<float>(v);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+// Parse the token [p, end) as a double.
+static inline int vtkDecimalParserParseDouble(const char* p, const char* end,
+                                              double& value)
+{
+  return vtkDecimalParserParseReal(p, end, 9007199254740992.0, 22, value);
+}
+
+#endif
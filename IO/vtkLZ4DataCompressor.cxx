@@ -0,0 +1,201 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkLZ4DataCompressor.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLZ4DataCompressor.h"
+#include "vtkObjectFactory.h"
+#include "vtk_lz4.h"
+
+vtkCxxRevisionMacro(vtkLZ4DataCompressor, "1.1");
+vtkStandardNewMacro(vtkLZ4DataCompressor);
+
+//----------------------------------------------------------------------------
+vtkLZ4DataCompressor::vtkLZ4DataCompressor()
+{
+  this->WordSize = 1;
+  this->Shuffle = 1;
+}
+
+//----------------------------------------------------------------------------
+vtkLZ4DataCompressor::~vtkLZ4DataCompressor()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkLZ4DataCompressor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "WordSize: " << this->WordSize << endl;
+  os << indent << "Shuffle: " << this->Shuffle << endl;
+}
+
+//----------------------------------------------------------------------------
+// Store byte b of every word in the b-th part of out.  Bytes after the
+// last complete word are copied as they are.
+static void vtkLZ4DataCompressorShuffle(const unsigned char* in,
+                                        unsigned char* out,
+                                        unsigned long size, int wordSize)
+{
+  unsigned long numWords = size / wordSize;
+  for(int b=0; b < wordSize; ++b)
+    {
+    const unsigned char* ip = in + b;
+    unsigned char* op = out + b*numWords;
+    for(unsigned long i=0; i < numWords; ++i, ip += wordSize)
+      {
+      *op++ = *ip;
+      }
+    }
+  memcpy(out + numWords*wordSize, in + numWords*wordSize,
+         size - numWords*wordSize);
+}
+
+//----------------------------------------------------------------------------
+static void vtkLZ4DataCompressorUnshuffle(const unsigned char* in,
+                                          unsigned char* out,
+                                          unsigned long size, int wordSize)
+{
+  unsigned long numWords = size / wordSize;
+  for(int b=0; b < wordSize; ++b)
+    {
+    const unsigned char* ip = in + b*numWords;
+    unsigned char* op = out + b;
+    for(unsigned long i=0; i < numWords; ++i, op += wordSize)
+      {
+      *op = *ip++;
+      }
+    }
+  memcpy(out + numWords*wordSize, in + numWords*wordSize,
+         size - numWords*wordSize);
+}
+
+//----------------------------------------------------------------------------
+unsigned long
+vtkLZ4DataCompressor::CompressBuffer(const unsigned char* uncompressedData,
+                                     unsigned long uncompressedSize,
+                                     unsigned char* compressedData,
+                                     unsigned long compressionSpace)
+{
+  if(uncompressedSize > LZ4_MAX_INPUT_SIZE || compressionSpace < 2)
+    {
+    vtkErrorMacro("Cannot compress " << uncompressedSize << " bytes into "
+                  << compressionSpace << " bytes with lz4.");
+    return 0;
+    }
+  unsigned long space = compressionSpace - 1;
+  if(space > static_cast<unsigned long>(LZ4_MAX_INPUT_SIZE))
+    {
+    space = LZ4_COMPRESSBOUND(LZ4_MAX_INPUT_SIZE);
+    }
+
+  // Regroup the bytes of the words into a temporary buffer.  The buffer
+  // is not kept so that several threads may compress at once.
+  int wordSize = this->Shuffle ? this->WordSize : 1;
+  if(uncompressedSize < static_cast<unsigned long>(2*wordSize))
+    {
+    wordSize = 1;
+    }
+  const unsigned char* input = uncompressedData;
+  unsigned char* shuffled = 0;
+  if(wordSize > 1)
+    {
+    shuffled = new unsigned char[uncompressedSize];
+    vtkLZ4DataCompressorShuffle(uncompressedData, shuffled,
+                                uncompressedSize, wordSize);
+    input = shuffled;
+    }
+
+  compressedData[0] = static_cast<unsigned char>(wordSize);
+  int compressedSize =
+    LZ4_compress_default(reinterpret_cast<const char*>(input),
+                         reinterpret_cast<char*>(compressedData+1),
+                         static_cast<int>(uncompressedSize),
+                         static_cast<int>(space));
+  delete [] shuffled;
+
+  if(compressedSize <= 0)
+    {
+    vtkErrorMacro("LZ4 error while compressing data.");
+    return 0;
+    }
+
+  return compressedSize + 1;
+}
+
+//----------------------------------------------------------------------------
+unsigned long
+vtkLZ4DataCompressor::UncompressBuffer(const unsigned char* compressedData,
+                                       unsigned long compressedSize,
+                                       unsigned char* uncompressedData,
+                                       unsigned long uncompressedSize)
+{
+  if(compressedSize < 2 || compressedSize - 1 > LZ4_MAX_INPUT_SIZE ||
+     uncompressedSize > LZ4_MAX_INPUT_SIZE)
+    {
+    vtkErrorMacro("Cannot uncompress " << compressedSize << " bytes into "
+                  << uncompressedSize << " bytes with lz4.");
+    return 0;
+    }
+  int wordSize = compressedData[0];
+  if(wordSize < 1 || wordSize > 8)
+    {
+    vtkErrorMacro("LZ4 compressed data have an invalid word size "
+                  << wordSize << ".");
+    return 0;
+    }
+
+  unsigned char* output = uncompressedData;
+  unsigned char* shuffled = 0;
+  if(wordSize > 1)
+    {
+    shuffled = new unsigned char[uncompressedSize];
+    output = shuffled;
+    }
+  int decSize =
+    LZ4_decompress_safe(reinterpret_cast<const char*>(compressedData+1),
+                        reinterpret_cast<char*>(output),
+                        static_cast<int>(compressedSize-1),
+                        static_cast<int>(uncompressedSize));
+  if(shuffled && decSize >= 0)
+    {
+    vtkLZ4DataCompressorUnshuffle(shuffled, uncompressedData,
+                                  uncompressedSize, wordSize);
+    }
+  delete [] shuffled;
+
+  if(decSize < 0)
+    {
+    vtkErrorMacro("LZ4 error while uncompressing data.");
+    return 0;
+    }
+
+  // Make sure the output size matched that expected.
+  if(static_cast<unsigned long>(decSize) != uncompressedSize)
+    {
+    vtkErrorMacro("Decompression produced incorrect size.\n"
+                  "Expected " << uncompressedSize << " and got " << decSize);
+    return 0;
+    }
+
+  return decSize;
+}
+
+//----------------------------------------------------------------------------
+unsigned long
+vtkLZ4DataCompressor::GetMaximumCompressionSpace(unsigned long size)
+{
+  // lz4 needs at most one byte more per 255 plus 16 bytes, and the word
+  // size takes one byte.
+  return size + size/255 + 16 + 1;
+}
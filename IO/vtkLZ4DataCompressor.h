@@ -0,0 +1,91 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkLZ4DataCompressor.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkLZ4DataCompressor - Fast data compression using lz4.
+// .SECTION Description
+// vtkLZ4DataCompressor provides a concrete vtkDataCompressor class
+// using lz4 for compressing and uncompressing data.  lz4 trades
+// compression ratio for speed: it compresses several times faster than
+// zlib and decompresses faster still.
+//
+// Numeric data compress much better when the bytes of equal
+// significance of the words are stored together, so by default the
+// bytes are regrouped this way before compressing.  The first byte of
+// each compressed buffer holds the word size used for the regrouping,
+// 1 meaning that the bytes are in their original order, and the lz4
+// block follows.  vtkXMLWriter sets the word size for every array it
+// writes.
+// .SECTION See Also
+// vtkZLibDataCompressor vtkXMLWriter
+
+#ifndef __vtkLZ4DataCompressor_h
+#define __vtkLZ4DataCompressor_h
+
+#include "vtkDataCompressor.h"
+
+class VTK_IO_EXPORT vtkLZ4DataCompressor : public vtkDataCompressor
+{
+public:
+  vtkTypeRevisionMacro(vtkLZ4DataCompressor,vtkDataCompressor);
+  void PrintSelf(ostream& os, vtkIndent indent);
+  static vtkLZ4DataCompressor* New();
+
+  // Description:
+  // Get the maximum space that may be needed to store data of the
+  // given uncompressed size after compression.  This is the minimum
+  // size of the output buffer that can be passed to the four-argument
+  // Compress method.
+  unsigned long GetMaximumCompressionSpace(unsigned long size);
+
+  // Description:
+  // Get/Set the size in bytes of the words of the data to compress.
+  // The default is 1.
+  vtkSetClampMacro(WordSize, int, 1, 8);
+  vtkGetMacro(WordSize, int);
+
+  // Description:
+  // Set the word size from the data to compress.
+  virtual void SetDataWordSize(int wordSize)
+    { this->SetWordSize(wordSize); }
+
+  // Description:
+  // Get/Set whether the bytes of the words are grouped by significance
+  // before compressing.  The default is on.
+  vtkSetMacro(Shuffle, int);
+  vtkGetMacro(Shuffle, int);
+  vtkBooleanMacro(Shuffle, int);
+
+protected:
+  vtkLZ4DataCompressor();
+  ~vtkLZ4DataCompressor();
+
+  int WordSize;
+  int Shuffle;
+
+  // Compression method required by vtkDataCompressor.
+  unsigned long CompressBuffer(const unsigned char* uncompressedData,
+                               unsigned long uncompressedSize,
+                               unsigned char* compressedData,
+                               unsigned long compressionSpace);
+  // Decompression method required by vtkDataCompressor.
+  unsigned long UncompressBuffer(const unsigned char* compressedData,
+                                 unsigned long compressedSize,
+                                 unsigned char* uncompressedData,
+                                 unsigned long uncompressedSize);
+private:
+  vtkLZ4DataCompressor(const vtkLZ4DataCompressor&);  // Not implemented.
+  void operator=(const vtkLZ4DataCompressor&);  // Not implemented.
+};
+
+#endif
@@ -0,0 +1,169 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkMappedFile.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkMappedFile.h"
+
+#if defined(_WIN32) && !defined(__CYGWIN__)
+# define VTK_MAP_FILE_WIN32
+# include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__) || defined(__CYGWIN__)
+# define VTK_MAP_FILE_POSIX
+# include <sys/types.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
+//----------------------------------------------------------------------------
+vtkMappedFile::vtkMappedFile()
+{
+  this->Base = 0;
+  this->Length = 0;
+  this->Data = 0;
+  this->Size = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkMappedFile::~vtkMappedFile()
+{
+  this->Unmap();
+}
+
+//----------------------------------------------------------------------------
+void vtkMappedFile::Unmap()
+{
+  if(this->Base)
+    {
+#if defined(VTK_MAP_FILE_WIN32)
+    UnmapViewOfFile(this->Base);
+#elif defined(VTK_MAP_FILE_POSIX)
+    munmap(this->Base, this->Length);
+#endif
+    }
+  this->Base = 0;
+  this->Length = 0;
+  this->Data = 0;
+  this->Size = 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkMappedFile::Map(const char* fileName)
+{
+  return this->MapFile(fileName, 0, 0, 1);
+}
+
+//----------------------------------------------------------------------------
+int vtkMappedFile::MapRange(const char* fileName, vtkIdType position,
+                            vtkIdType length)
+{
+  if(position < 0 || length <= 0)
+    {
+    this->Unmap();
+    return 0;
+    }
+  return this->MapFile(fileName, position, length, 0);
+}
+
+//----------------------------------------------------------------------------
+int vtkMappedFile::MapFile(const char* fileName, vtkIdType position,
+                           vtkIdType length, int wholeFile)
+{
+  this->Unmap();
+  void* base = 0;
+  size_t start = 0;
+  size_t end = 0;
+#if defined(VTK_MAP_FILE_WIN32)
+  HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, 0,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+  if(file == INVALID_HANDLE_VALUE)
+    {
+    return 0;
+    }
+  DWORD sizeHigh = 0;
+  DWORD sizeLow = GetFileSize(file, &sizeHigh);
+  DWORDLONG fileSize = (static_cast<DWORDLONG>(sizeHigh) << 32) | sizeLow;
+  DWORDLONG last = (wholeFile ? fileSize :
+                    static_cast<DWORDLONG>(position) + length);
+  if(last > 0 && last <= fileSize && static_cast<size_t>(last) == last)
+    {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    end = static_cast<size_t>(last);
+    start = static_cast<size_t>(position);
+    start -= start % info.dwAllocationGranularity;
+    // A copy on write mapping keeps changes to the data out of the file.
+    // The view holds its own reference to the file.
+    HANDLE fileMapping =
+      CreateFileMappingA(file, 0, wholeFile ? PAGE_READONLY : PAGE_WRITECOPY,
+                         0, 0, 0);
+    if(fileMapping)
+      {
+      DWORDLONG offset = static_cast<DWORDLONG>(start);
+      base = MapViewOfFile(fileMapping,
+                           wholeFile ? FILE_MAP_READ : FILE_MAP_COPY,
+                           static_cast<DWORD>(offset >> 32),
+                           static_cast<DWORD>(offset & 0xffffffff),
+                           static_cast<SIZE_T>(end - start));
+      CloseHandle(fileMapping);
+      }
+    }
+  CloseHandle(file);
+#elif defined(VTK_MAP_FILE_POSIX)
+  int fd = open(fileName, O_RDONLY);
+  if(fd < 0)
+    {
+    return 0;
+    }
+  struct stat fs;
+  if(fstat(fd, &fs) == 0)
+    {
+    // Pages past the end of the file cannot be accessed.
+    off_t last = (wholeFile ? fs.st_size :
+                  static_cast<off_t>(position) + static_cast<off_t>(length));
+    if(last > 0 && last <= fs.st_size &&
+       static_cast<off_t>(static_cast<size_t>(last)) == last)
+      {
+      long pageSize = sysconf(_SC_PAGESIZE);
+      end = static_cast<size_t>(last);
+      start = static_cast<size_t>(position);
+      start -= start % (pageSize > 0 ? pageSize : 4096);
+      // A private mapping keeps changes to the data out of the file.
+      base = mmap(0, end - start,
+                  wholeFile ? PROT_READ : PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE, fd, static_cast<off_t>(start));
+      if(base == MAP_FAILED)
+        {
+        base = 0;
+        }
+      }
+    }
+  close(fd);
+#else
+  (void)fileName;
+  (void)position;
+  (void)length;
+  (void)wholeFile;
+#endif
+  if(!base)
+    {
+    return 0;
+    }
+  this->Base = base;
+  this->Length = end - start;
+  this->Data = static_cast<char*>(base) + (static_cast<size_t>(position) -
+                                           start);
+  this->Size = end - static_cast<size_t>(position);
+  return 1;
+}
@@ -0,0 +1,76 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkMappedFile.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkMappedFile - map a file or a range of a file into memory
+// .SECTION Description
+// vtkMappedFile maps a file, or a range of bytes of a file, into memory
+// with mmap or MapViewOfFile, so that readers can parse or use the bytes
+// in place.  The mapping is released when the object is destroyed.  On
+// platforms without memory mapping, Map always fails and the readers fall
+// back to reading the file.
+
+// .SECTION See Also
+// vtkSTLReader vtkXMLDataReader
+
+#ifndef __vtkMappedFile_h
+#define __vtkMappedFile_h
+
+#include "vtkSystemIncludes.h"
+
+#include <stddef.h>
+
+class VTK_IO_EXPORT vtkMappedFile
+{
+public:
+  vtkMappedFile();
+  ~vtkMappedFile();
+
+  // Description:
+  // Map the whole file for reading.  Returns 0 if the file cannot be
+  // mapped or is empty.
+  int Map(const char* fileName);
+
+  // Description:
+  // Map length bytes of the file starting at position.  The mapping is
+  // private: the bytes may be changed, and the changes are not written
+  // to the file.  Returns 0 if the file cannot be mapped or is shorter
+  // than position + length.
+  int MapRange(const char* fileName, vtkIdType position, vtkIdType length);
+
+  // Description:
+  // Release the mapping.
+  void Unmap();
+
+  // Description:
+  // Get the mapped bytes, or 0 when nothing is mapped.
+  char* GetData() { return this->Data; }
+  size_t GetSize() { return this->Size; }
+
+protected:
+  int MapFile(const char* fileName, vtkIdType position, vtkIdType length,
+              int wholeFile);
+
+  // The mapping starts at a multiple of the page size, so the data may
+  // start inside it.
+  void* Base;
+  size_t Length;
+  char* Data;
+  size_t Size;
+
+private:
+  vtkMappedFile(const vtkMappedFile&);  // Not implemented.
+  void operator=(const vtkMappedFile&);  // Not implemented.
+};
+
+#endif
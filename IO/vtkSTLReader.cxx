@@ -17,13 +17,18 @@
 #include "vtkByteSwap.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
+#include "vtkDecimalParser.h"
 #include "vtkFloatArray.h"
 #include "vtkMergePoints.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMappedFile.h"
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTaskScheduler.h"
+
+#include <vtkstd/vector>
 
 #include <ctype.h>
 
@@ -33,6 +38,269 @@ vtkStandardNewMacro(vtkSTLReader);
 #define VTK_ASCII 0
 #define VTK_BINARY 1
 
+// Bytes of an ASCII file parsed by each thread at a time.
+#define VTK_STL_READER_CHUNK_SIZE 1048576
+
+//----------------------------------------------------------------------------
+// Hash of the coordinates of a point.  Zeros of either sign compare equal
+// and hash the same.
+static inline vtkTypeUInt32 vtkSTLReaderHash(const float x[3])
+{
+  vtkTypeUInt32 h = 0;
+  for (int i = 0; i < 3; ++i)
+    {
+    float y = (x[i] == 0.0f ? 0.0f : x[i]);
+    vtkTypeUInt32 k;
+    memcpy(&k, &y, 4);
+    h = (h ^ k)*0x9e3779b1;
+    h ^= h >> 15;
+    }
+  h *= 0x85ebca6b;
+  h ^= h >> 13;
+  return h;
+}
+
+//----------------------------------------------------------------------------
+// Builds the points and triangles of the output from the vertices of the
+// facets.  When merging, the ids of the points are kept in an open
+// addressing hash table keyed by their coordinates, and points are merged
+// when all their coordinates compare equal, as in vtkMergePoints.
+// Triangles that have merged vertices are then dropped.
+class vtkSTLReaderTriangles
+{
+public:
+  vtkSTLReaderTriangles(int merging, vtkIdType numTriangles,
+                        vtkFloatArray *scalars);
+  ~vtkSTLReaderTriangles();
+
+  // Add the triangle of vertices x with the scalar s.
+  void InsertNextTriangle(const float x[9], float s);
+
+  vtkFloatArray *Points;
+  vtkIdTypeArray *Cells;
+  vtkIdType NumberOfCells;
+
+protected:
+  vtkIdType InsertNextPoint(const float x[3]);
+  void Resize(size_t size);
+
+  int Merging;
+  vtkFloatArray *Scalars;
+  vtkIdType NumberOfPoints;
+  vtkstd::vector<vtkIdType> Slots; // point ids, or -1 for empty slots
+};
+
+vtkSTLReaderTriangles::vtkSTLReaderTriangles(int merging,
+                                             vtkIdType numTriangles,
+                                             vtkFloatArray *scalars)
+{
+  this->Points = vtkFloatArray::New();
+  this->Points->SetNumberOfComponents(3);
+  this->Cells = vtkIdTypeArray::New();
+  this->NumberOfCells = 0;
+  this->Merging = merging;
+  this->Scalars = scalars;
+  this->NumberOfPoints = 0;
+  if (merging)
+    {
+    // Closed surfaces have about half as many points as triangles, and
+    // the table is kept at most half full.
+    size_t size = 1024;
+    while (size < static_cast<size_t>(numTriangles))
+      {
+      size *= 2;
+      }
+    this->Slots.resize(size, -1);
+    }
+  else
+    {
+    this->Points->Allocate(9*numTriangles);
+    }
+  this->Cells->Allocate(4*numTriangles);
+}
+
+vtkSTLReaderTriangles::~vtkSTLReaderTriangles()
+{
+  this->Points->Delete();
+  this->Cells->Delete();
+}
+
+void vtkSTLReaderTriangles::Resize(size_t size)
+{
+  this->Slots.assign(size, -1);
+  const float *pts = this->Points->GetPointer(0);
+  size_t mask = size - 1;
+  for (vtkIdType id = 0; id < this->NumberOfPoints; ++id)
+    {
+    size_t i = vtkSTLReaderHash(pts + 3*id) & mask;
+    while (this->Slots[i] >= 0)
+      {
+      i = (i + 1) & mask;
+      }
+    this->Slots[i] = id;
+    }
+}
+
+inline vtkIdType vtkSTLReaderTriangles::InsertNextPoint(const float x[3])
+{
+  if (this->Merging)
+    {
+    const float *pts = this->Points->GetPointer(0);
+    size_t mask = this->Slots.size() - 1;
+    size_t i = vtkSTLReaderHash(x) & mask;
+    for (; this->Slots[i] >= 0; i = (i + 1) & mask)
+      {
+      const float *p = pts + 3*this->Slots[i];
+      if (p[0] == x[0] && p[1] == x[1] && p[2] == x[2])
+        {
+        return this->Slots[i];
+        }
+      }
+    this->Slots[i] = this->NumberOfPoints;
+    }
+  memcpy(this->Points->WritePointer(3*this->NumberOfPoints, 3), x,
+         3*sizeof(float));
+  if (this->Merging &&
+      2*static_cast<size_t>(this->NumberOfPoints + 1) > this->Slots.size())
+    {
+    this->NumberOfPoints++;
+    this->Resize(2*this->Slots.size());
+    return this->NumberOfPoints - 1;
+    }
+  return this->NumberOfPoints++;
+}
+
+void vtkSTLReaderTriangles::InsertNextTriangle(const float x[9], float s)
+{
+  vtkIdType ids[3];
+  ids[0] = this->InsertNextPoint(x);
+  ids[1] = this->InsertNextPoint(x + 3);
+  ids[2] = this->InsertNextPoint(x + 6);
+  if (!this->Merging ||
+      (ids[0] != ids[1] && ids[0] != ids[2] && ids[1] != ids[2]))
+    {
+    vtkIdType *cell = this->Cells->WritePointer(4*this->NumberOfCells, 4);
+    cell[0] = 3;
+    cell[1] = ids[0];
+    cell[2] = ids[1];
+    cell[3] = ids[2];
+    this->NumberOfCells++;
+    if (this->Scalars)
+      {
+      this->Scalars->InsertNextValue(s);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+static inline int vtkSTLReaderIsSpace(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Parse the real at p, after blanks, into value as fscanf() with %f does,
+// and move p past it.  The real must be followed by a space.  Returns 0
+// if there is none.
+static int vtkSTLReaderParseFloat(const char *&p, const char *end,
+                                  float &value)
+{
+  while (p < end && (*p == ' ' || *p == '\t'))
+    {
+    ++p;
+    }
+  const char *t = p;
+  while (t < end && !vtkSTLReaderIsSpace(*t))
+    {
+    ++t;
+    }
+  if (vtkDecimalParserParseFloat(p, t, value))
+    {
+    p = t;
+    return 1;
+    }
+
+  // Other reals are given to sscanf().
+  char token[64];
+  int length = static_cast<int>(t - p);
+  if (length > 63)
+    {
+    return 0;
+    }
+  memcpy(token, p, length);
+  token[length] = '\0';
+  int n = 0;
+  if (length == 0 || sscanf(token, "%f%n", &value, &n) != 1 || n != length)
+    {
+    return 0;
+    }
+  p = t;
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+// The vertices of the lines of an ASCII file between Begin and End, and
+// the number of vertices before each endsolid line.
+struct vtkSTLReaderChunk
+{
+  const char *Begin;
+  const char *End;
+  vtkstd::vector<float> Vertices;
+  vtkstd::vector<vtkIdType> EndSolids;
+  int Failed;
+};
+
+// Parse the chunks of lines in [begin, end).
+static void vtkSTLReaderParseChunks(void *data, vtkIdType begin,
+                                    vtkIdType end)
+{
+  vtkSTLReaderChunk *chunks = static_cast<vtkSTLReaderChunk *>(data);
+  for (vtkIdType c = begin; c < end; ++c)
+    {
+    vtkSTLReaderChunk &chunk = chunks[c];
+    chunk.Vertices.clear();
+    chunk.EndSolids.clear();
+    chunk.Failed = 0;
+    const char *p = chunk.Begin;
+    while (p < chunk.End)
+      {
+      // The first word of the line tells what it holds.
+      while (p < chunk.End && (*p == ' ' || *p == '\t' || *p == '\r'))
+        {
+        ++p;
+        }
+      const char *word = p;
+      while (p < chunk.End && !vtkSTLReaderIsSpace(*p))
+        {
+        ++p;
+        }
+      if (p - word == 6 && tolower(word[0]) == 'v' &&
+          tolower(word[1]) == 'e' && tolower(word[2]) == 'r' &&
+          tolower(word[3]) == 't' && tolower(word[4]) == 'e' &&
+          tolower(word[5]) == 'x')
+        {
+        float x[3];
+        if (!vtkSTLReaderParseFloat(p, chunk.End, x[0]) ||
+            !vtkSTLReaderParseFloat(p, chunk.End, x[1]) ||
+            !vtkSTLReaderParseFloat(p, chunk.End, x[2]))
+          {
+          chunk.Failed = 1;
+          break;
+          }
+        chunk.Vertices.insert(chunk.Vertices.end(), x, x + 3);
+        }
+      else if (p - word == 8 && (!strncmp(word, "endsolid", 8) ||
+                                 !strncmp(word, "ENDSOLID", 8)))
+        {
+        chunk.EndSolids.push_back(
+          static_cast<vtkIdType>(chunk.Vertices.size()/3));
+        }
+      while (p < chunk.End && *p++ != '\n')
+        {
+        }
+      }
+    }
+}
+
 // Construct object with merging set to true.
 vtkSTLReader::vtkSTLReader()
 {
@@ -115,15 +383,35 @@ int vtkSTLReader::RequestData(
   newPolys = vtkCellArray::New();
   newPolys->Allocate(10000,20000);
 
-  // Depending upon file type, read differently
+  int type = this->GetSTLFileType(fp);
+  if (type == VTK_ASCII && ScalarTags) 
+    {
+    newScalars = vtkFloatArray::New();
+    newScalars->Allocate(5000,10000);
+    }
+
+  // The default locator merges points of identical coordinates, which a
+  // hash table of the points does while the file is read.
+  if ( this->Merging && this->Locator == NULL )
+    {
+    this->CreateDefaultLocator();
+    }
+  int hashMerging = this->Merging &&
+    !strcmp(this->Locator->GetClassName(), "vtkMergePoints");
+
+  // Read the file from memory if it can be mapped, otherwise depending
+  // upon file type, read differently
   //
-  if ( this->GetSTLFileType(fp) == VTK_ASCII )
+  vtkMappedFile file;
+  int merged = 0;
+  if ( file.Map(this->FileName) &&
+       this->ReadMappedSTL(file.GetData(), file.GetSize(), type, hashMerging,
+                           newPts, newPolys, newScalars) )
+    {
+    merged = hashMerging;
+    }
+  else if ( type == VTK_ASCII )
     {
-    if (ScalarTags) 
-      {
-      newScalars = vtkFloatArray::New();
-      newScalars->Allocate(5000,10000);
-      }
     if ( this->ReadASCIISTL(fp,newPts,newPolys,newScalars) )
       {
       return 1;
@@ -147,7 +435,17 @@ int vtkSTLReader::RequestData(
   //
   // If merging is on, create hash table and merge points/triangles.
   //
-  if ( this->Merging )  
+  if ( merged )
+    {
+    mergedPts = newPts;
+    mergedPolys = newPolys;
+    mergedScalars = newScalars;
+
+    vtkDebugMacro(<< "Merged to: " 
+    << mergedPts->GetNumberOfPoints() << " points, " 
+    << mergedPolys->GetNumberOfCells() << " triangles");
+    }
+  else if ( this->Merging )  
     {
     int i;
     vtkIdType *pts = 0;
@@ -166,10 +464,6 @@ int vtkSTLReader::RequestData(
       mergedScalars->Allocate(newPolys->GetSize());
       }
     
-    if ( this->Locator == NULL )
-      {
-      this->CreateDefaultLocator();
-      }
     this->Locator->InitPointInsertion (mergedPts, newPts->GetBounds());
 
     for (newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts); )
@@ -235,6 +529,125 @@ int vtkSTLReader::RequestData(
   return 1;
 }
 
+int vtkSTLReader::ReadMappedSTL(const char *data, size_t size, int type,
+                                int merging, vtkPoints *newPts,
+                                vtkCellArray *newPolys,
+                                vtkFloatArray *scalars)
+{
+  vtkSTLReaderTriangles *triangles;
+  if ( type == VTK_BINARY )
+    {
+    vtkDebugMacro(<< " Reading mapped BINARY STL file");
+
+    // As when reading the file, the count of the header is ignored and
+    // the facets of 50 bytes are read until the end.
+    size_t numTris = (size < 84 + 48 ? 0 : (size - 84 - 48)/50 + 1);
+    if ( numTris > static_cast<size_t>(VTK_LARGE_ID/4) )
+      {
+      return 0;
+      }
+    triangles = new vtkSTLReaderTriangles(
+      merging, static_cast<vtkIdType>(numTris), 0);
+    for (size_t i = 0; i < numTris; i++)
+      {
+      float x[9];
+      memcpy(x, data + 84 + 50*i + 12, 36);
+      vtkByteSwap::Swap4LERange(x, 9);
+      triangles->InsertNextTriangle(x, 0.0f);
+
+      if ( (i % 65536) == 0 && i != 0 )
+        {
+        this->UpdateProgress(static_cast<double>(i)/numTris);
+        }
+      }
+    }
+  else
+    {
+    vtkDebugMacro(<< " Reading mapped ASCII STL file");
+
+    // The lines after the header are parsed in chunks on the threads,
+    // numThreads chunks at a time, and their vertices are added in
+    // order.  The scalar of a triangle is the number of endsolid lines
+    // before it.
+    const char *end = data + size;
+    const char *p = static_cast<const char *>(memchr(data, '\n', size));
+    p = (p ? p + 1 : end);
+    int numThreads =
+      vtkTaskScheduler::GetGlobalScheduler()->GetNumberOfThreads();
+    vtkSTLReaderChunk *chunks = new vtkSTLReaderChunk[numThreads];
+    triangles = new vtkSTLReaderTriangles(
+      merging, static_cast<vtkIdType>(size/256), scalars);
+    vtkstd::vector<float> vertices;   // vertices not yet in a triangle
+    vtkstd::vector<vtkIdType> endSolids; // vertices before endsolid lines
+    vtkIdType numVertices = 0;
+    vtkIdType first = 0;
+    size_t solid = 0;
+    int failed = 0;
+    while (p < end && !failed)
+      {
+      int numChunks = 0;
+      for (; numChunks < numThreads && p < end; numChunks++)
+        {
+        const char *e = end;
+        if ( end - p > VTK_STL_READER_CHUNK_SIZE )
+          {
+          e = p + VTK_STL_READER_CHUNK_SIZE;
+          e = static_cast<const char *>(memchr(e, '\n', end - e));
+          e = (e ? e + 1 : end);
+          }
+        chunks[numChunks].Begin = p;
+        chunks[numChunks].End = e;
+        p = e;
+        }
+      vtkTaskScheduler::GetGlobalScheduler()->ParallelFor(
+        0, numChunks, 1, vtkSTLReaderParseChunks, chunks);
+
+      for (int c = 0; c < numChunks && !failed; c++)
+        {
+        vtkSTLReaderChunk &chunk = chunks[c];
+        failed = chunk.Failed;
+        for (size_t i = 0; i < chunk.EndSolids.size(); i++)
+          {
+          endSolids.push_back(numVertices + chunk.EndSolids[i]);
+          }
+        numVertices += static_cast<vtkIdType>(chunk.Vertices.size()/3);
+        vertices.insert(vertices.end(), chunk.Vertices.begin(),
+                        chunk.Vertices.end());
+        size_t v = 0;
+        for (; v + 9 <= vertices.size(); v += 9, first += 3)
+          {
+          for (; solid < endSolids.size() && endSolids[solid] <= first;
+               solid++)
+            {
+            }
+          triangles->InsertNextTriangle(&vertices[v],
+                                        static_cast<float>(solid));
+          }
+        vertices.erase(vertices.begin(), vertices.begin() + v);
+        }
+      this->UpdateProgress(static_cast<double>(p - data)/size);
+      }
+    delete [] chunks;
+
+    // Files that do not hold whole triangles of vertices are left to the
+    // reading from the file.
+    if ( failed || !vertices.empty() )
+      {
+      delete triangles;
+      if ( scalars )
+        {
+        scalars->Reset();
+        }
+      return 0;
+      }
+    }
+
+  newPts->SetData(triangles->Points);
+  newPolys->SetCells(triangles->NumberOfCells, triangles->Cells);
+  delete triangles;
+  return 1;
+}
+
 int vtkSTLReader::ReadBinarySTL(FILE *fp, vtkPoints *newPts, 
                                 vtkCellArray *newPolys)
 {
@@ -24,6 +24,14 @@
 // point data is merged after reading. Merging is performed by default, 
 // however, merging requires a large amount of temporary storage since a 
 // 3D hash table must be constructed.
+//
+// Where the file can be memory mapped, it is read from memory.  The
+// facets of a binary file are taken directly from the mapping, and the
+// lines of an ASCII file are parsed in chunks on the threads of the
+// vtkTaskScheduler.  With the default locator, which merges points of
+// identical coordinates, the points are merged as they are read with an
+// open addressing hash table keyed by their coordinates.  The output is
+// the same as with the locator.
 
 // .SECTION Caveats
 // Binary files written on one system may not be readable on other systems.
@@ -95,6 +103,11 @@ protected:
   int ReadASCIISTL(FILE *fp, vtkPoints*, vtkCellArray*, 
                    vtkFloatArray* scalars=0);
   int GetSTLFileType(FILE *fp);
+
+  // Read the file mapped at data.  The points are merged if merging is
+  // set.  Returns 0 if the file cannot be read this way.
+  int ReadMappedSTL(const char *data, size_t size, int type, int merging,
+                    vtkPoints*, vtkCellArray*, vtkFloatArray* scalars);
 private:
   vtkSTLReader(const vtkSTLReader&);  // Not implemented.
   void operator=(const vtkSTLReader&);  // Not implemented.
@@ -19,7 +19,9 @@
 #include "vtkCommand.h"
 #include "vtkDataCompressor.h"
 #include "vtkInputStream.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
+#include "vtkTaskScheduler.h"
 #include "vtkXMLDataElement.h"
 
 vtkCxxRevisionMacro(vtkXMLDataParser, "1.29.6.1");
@@ -42,6 +44,7 @@ vtkXMLDataParser::vtkXMLDataParser()
   this->BlockCompressedSizes = 0;
   this->BlockStartOffsets = 0;
   this->Compressor = 0;
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
 
   this->AsciiDataBuffer = 0;
   this->AsciiDataBufferLength = 0;
@@ -91,6 +94,7 @@ void vtkXMLDataParser::PrintSelf(ostream& os, vtkIndent indent)
     {
     os << indent << "Compressor: (none)\n";
     }
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
   os << indent << "Progress: " << this->Progress << "\n";
   os << indent << "Abort: " << this->Abort << "\n";
   os << indent << "AttributesEncoding: " << this->AttributesEncoding << "\n";
@@ -536,6 +540,88 @@ unsigned char* vtkXMLDataParser::ReadBlock(unsigned int block)
   return decompressBuffer;
 }
 
+//----------------------------------------------------------------------------
+// What the tasks decompressing a batch of complete blocks need.  The
+// compressed blocks were read into Compressed, which starts at the
+// offset of FirstBlock.  Block i of the batch is decompressed and byte
+// swapped into the i-th block of Output, and Results[i] is set to 1 on
+// success.
+struct vtkXMLDataParserUncompressTaskData
+{
+  vtkXMLDataParser* Parser;
+  unsigned char* Compressed;
+  unsigned int FirstBlock;
+  unsigned char* Output;
+  int WordSize;
+  int* Results;
+};
+
+//----------------------------------------------------------------------------
+void vtkXMLDataParser::UncompressBlocksTask(void* arg, vtkIdType begin,
+                                            vtkIdType end)
+{
+  vtkXMLDataParserUncompressTaskData* td =
+    static_cast<vtkXMLDataParserUncompressTaskData*>(arg);
+  vtkXMLDataParser* self = td->Parser;
+  OffsetType firstOffset = self->BlockStartOffsets[td->FirstBlock];
+  OffsetType blockSize = self->BlockUncompressedSize;
+  for(vtkIdType i=begin; i < end; ++i)
+    {
+    unsigned int block = td->FirstBlock + static_cast<unsigned int>(i);
+    unsigned char* output = td->Output + i*blockSize;
+    OffsetType result =
+      self->Compressor->Uncompress(
+        td->Compressed + (self->BlockStartOffsets[block] - firstOffset),
+        self->BlockCompressedSizes[block], output, blockSize);
+    if(result > 0)
+      {
+      self->PerformByteSwap(output, blockSize / td->WordSize, td->WordSize);
+      }
+    td->Results[i] = (result > 0)? 1:0;
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkXMLDataParser::ReadBlocks(unsigned int firstBlock,
+                                 unsigned int numBlocks,
+                                 unsigned char* buffer, int wordSize)
+{
+  // The compressed blocks are stored one after another, so the whole
+  // batch is read at once.  Only the decompression runs in parallel.
+  unsigned int lastBlock = firstBlock + numBlocks - 1;
+  OffsetType beginOffset = this->BlockStartOffsets[firstBlock];
+  OffsetType compressedSize = (this->BlockStartOffsets[lastBlock] +
+                               this->BlockCompressedSizes[lastBlock] -
+                               beginOffset);
+  unsigned char* readBuffer = new unsigned char[compressedSize];
+  if(!this->DataStream->Seek(beginOffset) ||
+     (this->DataStream->Read(readBuffer, compressedSize) <
+      static_cast<unsigned long>(compressedSize)))
+    {
+    delete [] readBuffer;
+    return 0;
+    }
+
+  vtkXMLDataParserUncompressTaskData td;
+  td.Parser = this;
+  td.Compressed = readBuffer;
+  td.FirstBlock = firstBlock;
+  td.Output = buffer;
+  td.WordSize = wordSize;
+  td.Results = new int[numBlocks];
+  vtkTaskScheduler::GetGlobalScheduler()->ParallelFor(
+    0, numBlocks, 1, vtkXMLDataParser::UncompressBlocksTask, &td);
+
+  int result = 1;
+  for(unsigned int i=0; i < numBlocks; ++i)
+    {
+    result = result && td.Results[i];
+    }
+  delete [] td.Results;
+  delete [] readBuffer;
+  return result;
+}
+
 //----------------------------------------------------------------------------
 vtkXMLDataParser::OffsetType
 vtkXMLDataParser::ReadUncompressedData(unsigned char* data,
@@ -700,6 +786,29 @@ vtkXMLDataParser::ReadCompressedData(unsigned char* data,
     this->UpdateProgress(float(outputPointer-data)/length);
 
     unsigned int currentBlock = firstBlock+1;
+
+    // Decompress batches of a few complete blocks per thread in
+    // parallel while there are enough of them.
+    unsigned int batchBlocks = 4*this->NumberOfThreads;
+    while(this->NumberOfThreads > 1 && lastBlock-currentBlock > 1 &&
+          !this->Abort)
+      {
+      unsigned int n = lastBlock-currentBlock;
+      if(n > batchBlocks)
+        {
+        n = batchBlocks;
+        }
+      if(!this->ReadBlocks(currentBlock, n, outputPointer, wordSize))
+        {
+        return 0;
+        }
+      currentBlock += n;
+      outputPointer += n*blockSize;
+
+      // Report progress.
+      this->UpdateProgress(float(outputPointer-data)/length);
+      }
+
     for(;currentBlock != lastBlock && !this->Abort; ++currentBlock)
       {
       // Read this block.
@@ -859,6 +968,45 @@ vtkXMLDataParser::ReadAppendedData(OffsetType offset,
   return this->ReadBinaryData(buffer, startWord, numWords, wordType);
 }
 
+//----------------------------------------------------------------------------
+int vtkXMLDataParser::FindRawAppendedData(OffsetType offset,
+                                          OffsetType numWords,
+                                          int wordType,
+                                          OffsetType& position)
+{
+#ifdef VTK_WORDS_BIGENDIAN
+  int nativeByteOrder = vtkXMLDataParser::BigEndian;
+#else
+  int nativeByteOrder = vtkXMLDataParser::LittleEndian;
+#endif
+  if(this->Compressor || this->ByteOrder != nativeByteOrder ||
+     this->AppendedDataStream->IsA("vtkBase64InputStream"))
+    {
+    return 0;
+    }
+
+  // The words follow the length of the data, which must cover them.
+  HeaderType rsize;
+  const unsigned long len = sizeof(HeaderType);
+  OffsetType start = this->AppendedDataPosition+offset;
+  this->Stream->clear(this->Stream->rdstate() & ~ios::failbit);
+  this->Stream->clear(this->Stream->rdstate() & ~ios::eofbit);
+  this->SeekG(start);
+  if(!this->Stream->read(reinterpret_cast<char*>(&rsize), len))
+    {
+    this->Stream->clear(this->Stream->rdstate() & ~ios::failbit);
+    this->Stream->clear(this->Stream->rdstate() & ~ios::eofbit);
+    return 0;
+    }
+  this->PerformByteSwap(&rsize, 1, len);
+  if(OffsetType(rsize) < numWords*OffsetType(this->GetWordTypeSize(wordType)))
+    {
+    return 0;
+    }
+  position = start+len;
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 //----------------------------------------------------------------------------
 // Define a parsing function template.  The extra "long" argument is used
@@ -79,6 +79,15 @@ public:
     { return this->ReadAppendedData(offset, buffer, startWord, numWords,
                                     VTK_CHAR); }
 
+  // Description:
+  // Find the stream position of the words of an appended array that may
+  // be used in place, without reading it through the parser.  This is
+  // possible when the appended data are raw, not compressed, in the
+  // native byte order and hold at least numWords words.  Returns 1 and
+  // sets position on success, or 0 if the data must be read.
+  int FindRawAppendedData(OffsetType offset, OffsetType numWords,
+                          int wordType, OffsetType& position);
+
   // Description:
   // Read from an ascii data section starting at the current position in
   // the stream.  Returns the number of words read.
@@ -98,6 +107,16 @@ public:
   virtual void SetCompressor(vtkDataCompressor*);
   vtkGetObjectMacro(Compressor, vtkDataCompressor);
 
+  // Description:
+  // Get/Set the number of threads used to decompress binary and appended
+  // data.  Batches of complete blocks are read in order and decompressed
+  // on the global vtkTaskScheduler.  The compressor must allow concurrent
+  // calls to Uncompress() on separate buffers, as vtkZLibDataCompressor
+  // does.  The default is
+  // vtkMultiThreader::GetGlobalDefaultNumberOfThreads().
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
   // Description:
   // Get the size of a word of the given type.
   unsigned long GetWordTypeSize(int wordType);
@@ -157,6 +176,9 @@ protected:
   unsigned int FindBlockSize(unsigned int block);
   int ReadBlock(unsigned int block, unsigned char* buffer);
   unsigned char* ReadBlock(unsigned int block);
+  int ReadBlocks(unsigned int firstBlock, unsigned int numBlocks,
+                 unsigned char* buffer, int wordSize);
+  static void UncompressBlocksTask(void* arg, vtkIdType begin, vtkIdType end);
   OffsetType ReadUncompressedData(unsigned char* data,
                                   OffsetType startWord,
                                   OffsetType numWords,
@@ -223,6 +245,9 @@ protected:
   HeaderType* BlockCompressedSizes;
   OffsetType* BlockStartOffsets;
 
+  // The number of threads used to decompress blocks.
+  int NumberOfThreads;
+
   // Ascii data parsing.
   unsigned char* AsciiDataBuffer;
   OffsetType AsciiDataBufferLength;
@@ -16,8 +16,10 @@
 
 #include "vtkCallbackCommand.h"
 #include "vtkCellData.h"
+#include "vtkDataArray.h"
 #include "vtkDataArraySelection.h"
 #include "vtkDataSet.h"
+#include "vtkMappedFile.h"
 #include "vtkPointData.h"
 #include "vtkXMLDataElement.h"
 #include "vtkXMLDataParser.h"
@@ -50,6 +52,8 @@ vtkXMLDataReader::vtkXMLDataReader()
   this->PointDataOffset = NULL;
   this->CellDataTimeStep = NULL;
   this->CellDataOffset = NULL;
+
+  this->MapAppendedData = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -80,6 +84,7 @@ vtkXMLDataReader::~vtkXMLDataReader()
 void vtkXMLDataReader::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "MapAppendedData: " << this->MapAppendedData << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -496,7 +501,9 @@ void vtkXMLDataReader::ReadXMLData()
           }
         fieldData->AddArray(array);
         array->Delete();  
-        if (!this->ReadData(eNested, array->GetVoidPointer(0),
+        if (!this->MapData(eNested, array,
+                           numTuples*array->GetNumberOfComponents()) &&
+            !this->ReadData(eNested, array->GetVoidPointer(0),
           array->GetDataType(), 0, numTuples*array->GetNumberOfComponents()))
           {
           this->DataError = 1;
@@ -513,6 +520,10 @@ int vtkXMLDataReader::ReadArrayForPoints(vtkXMLDataElement* da,
 {
   vtkIdType components = outArray->GetNumberOfComponents();
   vtkIdType numberOfTuples = this->GetNumberOfPoints();
+  if(this->MapData(da, outArray, numberOfTuples*components))
+    {
+    return 1;
+    }
   return this->ReadData(da, outArray->GetVoidPointer(0),
                         outArray->GetDataType(),
                         0, numberOfTuples*components);
@@ -524,6 +535,10 @@ int vtkXMLDataReader::ReadArrayForCells(vtkXMLDataElement* da,
 {
   vtkIdType components = outArray->GetNumberOfComponents();
   vtkIdType numberOfTuples = this->GetNumberOfCells();
+  if(this->MapData(da, outArray, numberOfTuples*components))
+    {
+    return 1;
+    }
   return this->ReadData(da, outArray->GetVoidPointer(0),
                         outArray->GetDataType(),
                         0, numberOfTuples*components);
@@ -565,6 +580,52 @@ int vtkXMLDataReader::ReadData(vtkXMLDataElement* da, void* data, int wordType,
   return result;
 }
 
+//----------------------------------------------------------------------------
+static void vtkXMLDataReaderUnmap(void*, void* clientData)
+{
+  delete static_cast<vtkMappedFile*>(clientData);
+}
+
+//----------------------------------------------------------------------------
+int vtkXMLDataReader::MapData(vtkXMLDataElement* da, vtkDataArray* array,
+                              vtkIdType numWords)
+{
+  // Only files read by name can be mapped.
+  if(!this->MapAppendedData || this->AbortExecute || !this->FileName ||
+     !this->Stream || numWords <= 0 || array->GetMaxId()+1 != numWords ||
+     array->GetDataType() == VTK_BIT || !da->GetAttribute("offset"))
+    {
+    return 0;
+    }
+
+  // The words must be aligned in memory as they are in the file.
+  int offset = 0;
+  da->GetScalarAttribute("offset", offset);
+  int wordType = array->GetDataType();
+  vtkXMLDataParser::OffsetType wordSize =
+    this->XMLParser->GetWordTypeSize(wordType);
+  vtkXMLDataParser::OffsetType position;
+  if(wordSize != array->GetDataTypeSize() ||
+     !this->XMLParser->FindRawAppendedData(offset, numWords, wordType,
+                                           position) ||
+     position % wordSize != 0)
+    {
+    return 0;
+    }
+
+  // The mapping is private, so changes to the array stay out of the
+  // file.  It is released with the array.
+  vtkMappedFile* file = new vtkMappedFile;
+  if(!file->MapRange(this->FileName, position, numWords*wordSize))
+    {
+    delete file;
+    return 0;
+    }
+  array->SetVoidArray(file->GetData(), numWords, 1);
+  array->SetUserArrayReleaseFunction(&vtkXMLDataReaderUnmap, file);
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 void vtkXMLDataReader::DataProgressCallbackFunction(vtkObject*, unsigned long,
                                                     void* clientdata, void*)
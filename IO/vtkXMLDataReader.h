@@ -44,6 +44,20 @@ public:
   // SetupOutputInformation to outInfo
   virtual void CopyOutputInformation(vtkInformation *outInfo, int port);
 
+  // Description:
+  // Get/Set whether arrays stored raw in the appended data section are
+  // memory mapped from the file instead of read.  An array is mapped
+  // when the appended data are not encoded or compressed, are in the
+  // native byte order, start at a multiple of the word size in the file,
+  // and fill the whole output array.  Other arrays are read.  The
+  // mapping is private, so modifying an array does not change the file,
+  // and it is released when the array releases its memory.  The file
+  // must not be truncated while its arrays are in use.  The default is
+  // off.
+  vtkSetMacro(MapAppendedData, int);
+  vtkGetMacro(MapAppendedData, int);
+  vtkBooleanMacro(MapAppendedData, int);
+
 protected:
   vtkXMLDataReader();
   ~vtkXMLDataReader();  
@@ -79,6 +93,13 @@ protected:
   // Read data from a given element.
   int ReadData(vtkXMLDataElement* da, void* data, int wordType,
                vtkIdType startWord, vtkIdType numWords);
+
+  // Map the first numWords words of the given element into the array
+  // when MapAppendedData is on and the file allows it.  The array must
+  // hold exactly numWords words.  Returns 1 if the array was mapped and
+  // 0 if the data must be read.
+  int MapData(vtkXMLDataElement* da, vtkDataArray* array,
+              vtkIdType numWords);
   
   // Callback registered with the DataProgressObserver.
   static void DataProgressCallbackFunction(vtkObject*, unsigned long, void*,
@@ -108,6 +129,9 @@ protected:
   // The observer to report progress from reading data from XMLParser.
   vtkCallbackCommand* DataProgressObserver;  
 
+  // Whether raw appended arrays are memory mapped.
+  int MapAppendedData;
+
   // Specify the last time step read, usefull to know if we need to rearead data
   // //PointData
   int *PointDataTimeStep;
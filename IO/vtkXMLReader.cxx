@@ -25,10 +25,12 @@
 #include "vtkXMLDataElement.h"
 #include "vtkXMLDataParser.h"
 #include "vtkXMLFileReadTester.h"
+#include "vtkLZ4DataCompressor.h"
 #include "vtkZLibDataCompressor.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTimerLog.h"
 
 #include <sys/stat.h>
 #include <assert.h>
@@ -250,12 +252,17 @@ void vtkXMLReader::SetupCompressor(const char* type)
   vtkObject* object = vtkInstantiator::CreateInstance(type);
   vtkDataCompressor* compressor = vtkDataCompressor::SafeDownCast(object);
   
-  // In static builds, the vtkZLibDataCompressor may not have been
-  // registered with the vtkInstantiator.  Check for it here.
+  // In static builds, the vtkZLibDataCompressor and
+  // vtkLZ4DataCompressor may not have been registered with the
+  // vtkInstantiator.  Check for them here.
   if(!compressor && (strcmp(type, "vtkZLibDataCompressor") == 0))
     {
     compressor = vtkZLibDataCompressor::New();
     }
+  else if(!compressor && (strcmp(type, "vtkLZ4DataCompressor") == 0))
+    {
+    compressor = vtkLZ4DataCompressor::New();
+    }
   
   if(!compressor)
     {
@@ -278,6 +285,8 @@ int vtkXMLReader::ReadXMLInformation()
   // only Parse if something has changed
   if(this->GetMTime() > this->ReadMTime)
     {
+    vtkTimerLogTraceScope scope("IO", this, "ReadXMLInformation");
+
     // Destroy any old information that was parsed.
     if(this->XMLParser)
       {
@@ -457,7 +466,10 @@ int vtkXMLReader::RequestData(vtkInformation *request,
     this->DataError = 0;
 
     // Let the subclasses read the data they want.
+    {
+    vtkTimerLogTraceScope scope("IO", this, "ReadXMLData");
     this->ReadXMLData();
+    }
     
     // If we aborted or there was an error, provide empty output.
     if(this->DataError || this->AbortExecute)
@@ -358,7 +358,8 @@ vtkXMLStructuredDataReader
       // progress range.
       vtkIdType volumeTuples =
         (inDimensions[0]*inDimensions[1]*inDimensions[2]);
-      if(!this->ReadData(da, array->GetVoidPointer(0), array->GetDataType(),
+      if(!this->MapData(da, array, volumeTuples*components) &&
+         !this->ReadData(da, array->GetVoidPointer(0), array->GetDataType(),
                          0, volumeTuples*components))
         {
         return 0;
@@ -34,6 +34,7 @@ vtkXMLUnstructuredDataReader::vtkXMLUnstructuredDataReader()
   this->NumberOfPoints = 0;
   this->TotalNumberOfPoints = 0;
   this->TotalNumberOfCells = 0;
+  this->StoreCellOffsets = 0;
 
   this->PointsTimeStep = -1;  //invalid state
   this->PointsOffset = (unsigned long)-1;
@@ -52,6 +53,7 @@ vtkXMLUnstructuredDataReader::~vtkXMLUnstructuredDataReader()
 void vtkXMLUnstructuredDataReader::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "StoreCellOffsets: " << this->StoreCellOffsets << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -529,6 +531,12 @@ int vtkXMLUnstructuredDataReader::ReadCellArray(vtkIdType numberOfCells,
       }
     }
   
+  if(this->StoreCellOffsets &&
+     (outCells->GetNumberOfCells() == 0 || !outCells->IsStorageInterleaved()))
+    {
+    return this->ReadCellOffsets(numberOfCells, eCells, outCells);
+    }
+  
   // Split progress range into 1/5 for offsets array and 4/5 for
   // connectivity array.  This assumes an average of 4 points per
   // cell.  Unfortunately, we cannot know the length of the
@@ -675,6 +683,188 @@ int vtkXMLUnstructuredDataReader::ReadCellArray(vtkIdType numberOfCells,
   return 1;
 }
 
+//----------------------------------------------------------------------------
+template <class T>
+int vtkXMLUnstructuredDataReaderCheckOffsets(T* offsets,
+                                             vtkIdType numberOfCells)
+{
+  for(vtkIdType i = 0; i < numberOfCells; ++i)
+    {
+    if(offsets[i+1] <= offsets[i])
+      {
+      return 0;
+      }
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkXMLUnstructuredDataReaderShiftIds(T* ids, vtkIdType length,
+                                          vtkIdType shift)
+{
+  for(vtkIdType i = 0; i < length; ++i)
+    {
+    ids[i] = static_cast<T>(ids[i] + shift);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Read the cells into offsets and connectivity arrays of the file's types
+// and give them to the output, or append them to its arrays.
+int vtkXMLUnstructuredDataReader::ReadCellOffsets(vtkIdType numberOfCells,
+                                                  vtkXMLDataElement* eCells,
+                                                  vtkCellArray* outCells)
+{
+  float progressRange[2] = {0,0};
+  this->GetProgressRange(progressRange);
+  float fractions[3] = {0, 0.2, 1};
+  this->SetProgressRange(progressRange, 0, fractions);
+  
+  // Read the cell offsets after a leading 0.
+  vtkXMLDataElement* eOffsets = this->FindDataArrayWithName(eCells, "offsets");
+  if(!eOffsets)
+    {
+    vtkErrorMacro("Cannot read cell offsets from " << eCells->GetName()
+                  << " in piece " << this->Piece
+                  << " because the \"offsets\" array could not be found.");
+    return 0;
+    }
+  vtkDataArray* c1 = this->CreateDataArray(eOffsets);
+  if(!c1 || (c1->GetNumberOfComponents() != 1))
+    {
+    vtkErrorMacro("Cannot read cell offsets from " << eCells->GetName()
+                  << " in piece " << this->Piece
+                  << " because the \"offsets\" array could not be created"
+                  << " with one component.");
+    return 0;
+    }
+  c1->SetNumberOfTuples(numberOfCells+1);
+  c1->SetTuple1(0, 0);
+  if(!this->ReadData(eOffsets, c1->GetVoidPointer(1), c1->GetDataType(),
+                     0, numberOfCells))
+    {
+    vtkErrorMacro("Cannot read cell offsets from " << eCells->GetName()
+                  << " in piece " << this->Piece
+                  << " because the \"offsets\" array is not long enough.");
+    c1->Delete();
+    return 0;
+    }
+  if(!vtkCellArray::IsIdArray(c1) && !(c1 = this->ConvertToIdTypeArray(c1)))
+    {
+    vtkErrorMacro("Cannot read cell offsets from " << eCells->GetName()
+                  << " in piece " << this->Piece
+                  << " because the \"offsets\" array could not be"
+                  << " converted to a vtkIdTypeArray.");
+    return 0;
+    }
+  
+  // Check the contents of the cell offsets array.
+  int valid = 0;
+  switch (c1->GetDataType())
+    {
+    vtkTemplateMacro(
+      valid = vtkXMLUnstructuredDataReaderCheckOffsets(
+        static_cast<VTK_TT*>(c1->GetVoidPointer(0)), numberOfCells));
+    }
+  if(!valid)
+    {
+    vtkErrorMacro("Cannot read cell connectivity from " << eCells->GetName()
+                  << " in piece " << this->Piece
+                  << " because the \"offsets\" array is"
+                  << " not monotonically increasing or starts with a"
+                  << " value less than 1.");
+    c1->Delete();
+    return 0;
+    }
+  
+  this->SetProgressRange(progressRange, 1, fractions);
+  
+  // Read the cell point connectivity array.
+  vtkIdType cpLength = static_cast<vtkIdType>(c1->GetTuple1(numberOfCells));
+  vtkXMLDataElement* eConn = this->FindDataArrayWithName(eCells, "connectivity");
+  if(!eConn)
+    {
+    vtkErrorMacro("Cannot read cell connectivity from " << eCells->GetName()
+                  << " in piece " << this->Piece
+                  << " because the \"connectivity\" array could not be found.");
+    c1->Delete();
+    return 0;
+    }
+  vtkDataArray* c0 = this->CreateDataArray(eConn);
+  if(!c0 || (c0->GetNumberOfComponents() != 1))
+    {
+    vtkErrorMacro("Cannot read cell connectivity from " << eCells->GetName()
+                  << " in piece " << this->Piece
+                  << " because the \"connectivity\" array could not be created"
+                  << " with one component.");
+    c1->Delete();
+    return 0;
+    }
+  c0->SetNumberOfTuples(cpLength);
+  if(!this->ReadData(eConn, c0->GetVoidPointer(0), c0->GetDataType(),
+                     0, cpLength))
+    {
+    vtkErrorMacro("Cannot read cell connectivity from " << eCells->GetName()
+                  << " in piece " << this->Piece
+                  << " because the \"connectivity\" array is not long enough.");
+    c0->Delete();
+    c1->Delete();
+    return 0;
+    }
+  if(!vtkCellArray::IsIdArray(c0) && !(c0 = this->ConvertToIdTypeArray(c0)))
+    {
+    vtkErrorMacro("Cannot read cell connectivity from " << eCells->GetName()
+                  << " in piece " << this->Piece
+                  << " because the \"connectivity\" array could not be"
+                  << " converted to a vtkIdTypeArray.");
+    c1->Delete();
+    return 0;
+    }
+  
+  if(outCells->GetNumberOfCells() == 0)
+    {
+    // Increment the point indices for the appended version's index.
+    if(this->StartPoint)
+      {
+      switch (c0->GetDataType())
+        {
+        vtkTemplateMacro(
+          vtkXMLUnstructuredDataReaderShiftIds(
+            static_cast<VTK_TT*>(c0->GetVoidPointer(0)), cpLength,
+            this->StartPoint));
+        }
+      }
+    outCells->SetData(c1, c0);
+    }
+  else
+    {
+    // Append to the arrays of the previous pieces.
+    vtkDataArray* offsets = outCells->GetOffsetsArray();
+    vtkDataArray* connectivity = outCells->GetConnectivityArray();
+    offsets->Register(this);
+    connectivity->Register(this);
+    double lastOffset = offsets->GetTuple1(offsets->GetNumberOfTuples()-1);
+    vtkIdType i;
+    for(i=1; i <= numberOfCells; ++i)
+      {
+      offsets->InsertNextTuple1(lastOffset + c1->GetTuple1(i));
+      }
+    for(i=0; i < cpLength; ++i)
+      {
+      connectivity->InsertNextTuple1(c0->GetTuple1(i) + this->StartPoint);
+      }
+    outCells->SetData(offsets, connectivity);
+    offsets->UnRegister(this);
+    connectivity->UnRegister(this);
+    }
+  
+  c0->Delete();
+  c1->Delete();
+  
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 int vtkXMLUnstructuredDataReader::ReadArrayForPoints(vtkXMLDataElement* da,
                                                      vtkDataArray* outArray)
@@ -682,6 +872,10 @@ int vtkXMLUnstructuredDataReader::ReadArrayForPoints(vtkXMLDataElement* da,
   vtkIdType startPoint = this->StartPoint;
   vtkIdType numPoints = this->NumberOfPoints[this->Piece];  
   vtkIdType components = outArray->GetNumberOfComponents();
+  if(startPoint == 0 && this->MapData(da, outArray, numPoints*components))
+    {
+    return 1;
+    }
   return this->ReadData(da, outArray->GetVoidPointer(startPoint*components),
                         outArray->GetDataType(), 0, numPoints*components);
 }
@@ -55,6 +55,14 @@ public:
   // SetupOutputInformation to outInfo
   virtual void CopyOutputInformation(vtkInformation *outInfo, int port);
 
+  // Description:
+  // Keep the cells as the offsets and connectivity arrays read from the
+  // file (see vtkCellArray::SetData()) instead of building the interleaved
+  // cell list.  This saves a copy of the connectivity and, for
+  // vtkUnstructuredGrid, the cell locations.  Off by default.
+  vtkSetMacro(StoreCellOffsets, int);
+  vtkGetMacro(StoreCellOffsets, int);
+  vtkBooleanMacro(StoreCellOffsets, int);
 
 protected:
   vtkXMLUnstructuredDataReader();
@@ -85,6 +93,8 @@ protected:
   int ReadPieceData();
   int ReadCellArray(vtkIdType numberOfCells, vtkIdType totalNumberOfCells,
                     vtkXMLDataElement* eCells, vtkCellArray* outCells);
+  int ReadCellOffsets(vtkIdType numberOfCells, vtkXMLDataElement* eCells,
+                      vtkCellArray* outCells);
   
   // Read a data array whose tuples coorrespond to points.
   int ReadArrayForPoints(vtkXMLDataElement* da, vtkDataArray* outArray);
@@ -110,6 +120,8 @@ protected:
   vtkXMLDataElement** PointElements;
   vtkIdType* NumberOfPoints;
   
+  int StoreCellOffsets;
+  
   int PointsTimeStep;
   unsigned long PointsOffset;
   int PointsNeedToReadTimeStep(vtkXMLDataElement *eNested);
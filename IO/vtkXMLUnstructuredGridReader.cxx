@@ -146,12 +146,20 @@ void vtkXMLUnstructuredGridReader::SetupOutputData()
   cellTypes->SetNumberOfTuples(this->GetNumberOfCells());
   vtkCellArray* outCells = vtkCellArray::New();
   
-  vtkIdTypeArray* locations = vtkIdTypeArray::New();
-  locations->SetNumberOfTuples(this->GetNumberOfCells());
+  // Cells kept with offsets need no locations.
+  vtkIdTypeArray* locations = 0;
+  if(!this->StoreCellOffsets)
+    {
+    locations = vtkIdTypeArray::New();
+    locations->SetNumberOfTuples(this->GetNumberOfCells());
+    }
   
   output->SetCells(cellTypes, locations, outCells);
   
-  locations->Delete();
+  if(locations)
+    {
+    locations->Delete();
+    }
   outCells->Delete();
   cellTypes->Delete();
 }
@@ -251,7 +259,7 @@ int vtkXMLUnstructuredGridReader::ReadPieceData()
   // Save the start location where the new cell connectivity will be
   // appended.
   vtkIdType startLoc = 0;
-  if(output->GetCells()->GetData())
+  if(!this->StoreCellOffsets && output->GetCells()->GetData())
     {
     startLoc = output->GetCells()->GetData()->GetNumberOfTuples();
     }
@@ -279,15 +287,18 @@ int vtkXMLUnstructuredGridReader::ReadPieceData()
     }
   
   // Construct the cell locations.
-  vtkIdTypeArray* locations = output->GetCellLocationsArray();
-  vtkIdType* locs = locations->GetPointer(this->StartCell);
-  vtkIdType* begin = output->GetCells()->GetData()->GetPointer(startLoc);
-  vtkIdType* cur = begin;
-  vtkIdType i;
-  for(i=0; i < this->NumberOfCells[this->Piece]; ++i)
+  if(!this->StoreCellOffsets)
     {
-    locs[i] = startLoc + cur - begin;
-    cur += *cur + 1;
+    vtkIdTypeArray* locations = output->GetCellLocationsArray();
+    vtkIdType* locs = locations->GetPointer(this->StartCell);
+    vtkIdType* begin = output->GetCells()->GetData()->GetPointer(startLoc);
+    vtkIdType* cur = begin;
+    vtkIdType i;
+    for(i=0; i < this->NumberOfCells[this->Piece]; ++i)
+      {
+      locs[i] = startLoc + cur - begin;
+      cur += *cur + 1;
+      }
     }
   
   // Set the range of progress for the cell types.
@@ -347,6 +358,10 @@ int vtkXMLUnstructuredGridReader::ReadArrayForCells(vtkXMLDataElement* da,
   vtkIdType startCell = this->StartCell;
   vtkIdType numCells = this->NumberOfCells[this->Piece];  
   vtkIdType components = outArray->GetNumberOfComponents();
+  if(startCell == 0 && this->MapData(da, outArray, numCells*components))
+    {
+    return 1;
+    }
   return this->ReadData(da, outArray->GetVoidPointer(startCell*components),
                         outArray->GetDataType(), 0, numCells*components);
 }
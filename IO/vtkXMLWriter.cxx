@@ -23,10 +23,12 @@
 #include "vtkErrorCode.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
 #include "vtkOutputStream.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTaskScheduler.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkZLibDataCompressor.h"
 #define vtkOffsetsManager_DoNotInclude
@@ -76,6 +78,7 @@ vtkXMLWriter::vtkXMLWriter()
   this->CompressionHeader = 0;
   this->Int32IdTypeBuffer = 0;
   this->ByteSwapBuffer = 0;
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
 
   this->EncodeAppendedData = 1;
   this->AppendedDataPosition = 0;
@@ -155,6 +158,7 @@ void vtkXMLWriter::PrintSelf(ostream& os, vtkIndent indent)
     }
   os << indent << "EncodeAppendedData: " << this->EncodeAppendedData << "\n";
   os << indent << "BlockSize: " << this->BlockSize << "\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
   if(this->Stream)
     {
     os << indent << "Stream: " << this->Stream << "\n";
@@ -707,6 +711,9 @@ int vtkXMLWriter::WriteBinaryData(void* data, int numWords, int wordType)
   unsigned long outWordSize = this->GetOutputWordTypeSize(wordType);
   if(this->Compressor)
     {
+    // Some compressors group the bytes of the words by significance.
+    this->Compressor->SetDataWordSize(static_cast<int>(outWordSize));
+
     // Need to compress the data.  Create compression header.  This
     // reserves enough space in the output.
     if(!this->CreateCompressionHeader(numWords*outWordSize))
@@ -804,6 +811,14 @@ int vtkXMLWriter::WriteBinaryDataInternal(void* data, int numWords,
   unsigned long blockWords = this->BlockSize/outWordSize;
   unsigned long memBlockSize = blockWords*memWordSize;
 
+  // Compressing takes most of the time, so compress several blocks at
+  // once when there are enough of them.
+  if(this->Compressor && this->NumberOfThreads > 1 &&
+     static_cast<unsigned long>(numWords) > blockWords)
+    {
+    return this->WriteBinaryDataParallel(data, numWords, wordType);
+    }
+
 #ifdef VTK_USE_64BIT_IDS
   // If the type is vtkIdType, it may need to be converted to the type
   // requested for output.
@@ -947,6 +962,166 @@ int vtkXMLWriter::WriteBinaryDataBlock(unsigned char* in_data, int numWords,
     }
 }
 
+//----------------------------------------------------------------------------
+// What the tasks compressing a batch of blocks need.  Block i of the
+// batch starts at word i*BlockWords of Data.  When the words must be
+// converted or byte swapped, this is done in the block's part of
+// Staging.  The compressed block is stored in the block's part of
+// Output, and its size, or 0 on failure, in OutputSizes.
+struct vtkXMLWriterCompressTaskData
+{
+  vtkXMLWriter* Writer;
+  unsigned char* Data;
+  unsigned long NumberOfWords;
+  unsigned long BlockWords;
+  unsigned long MemWordSize;
+  unsigned long OutWordSize;
+  int ConvertIds;
+  int Swap;
+  unsigned char* Staging;
+  unsigned char* Output;
+  unsigned long OutputSpace;
+  unsigned long* OutputSizes;
+};
+
+//----------------------------------------------------------------------------
+void vtkXMLWriter::CompressBlocksTask(void* arg, vtkIdType begin,
+                                      vtkIdType end)
+{
+  vtkXMLWriterCompressTaskData* td =
+    static_cast<vtkXMLWriterCompressTaskData*>(arg);
+  for(vtkIdType i=begin; i < end; ++i)
+    {
+    unsigned long firstWord = i*td->BlockWords;
+    unsigned long numWords = td->NumberOfWords - firstWord;
+    if(numWords > td->BlockWords)
+      {
+      numWords = td->BlockWords;
+      }
+    unsigned char* block = td->Data + firstWord*td->MemWordSize;
+    unsigned long size = numWords*td->OutWordSize;
+
+    if(td->Staging)
+      {
+      unsigned char* staged = td->Staging + i*td->BlockWords*td->OutWordSize;
+#ifdef VTK_USE_64BIT_IDS
+      if(td->ConvertIds)
+        {
+        vtkIdType* ids = reinterpret_cast<vtkIdType*>(block);
+        Int32IdType* out = reinterpret_cast<Int32IdType*>(staged);
+        for(unsigned long j=0; j < numWords; ++j)
+          {
+          out[j] = static_cast<Int32IdType>(ids[j]);
+          }
+        }
+      else
+#endif
+        {
+        memcpy(staged, block, size);
+        }
+      if(td->Swap)
+        {
+        td->Writer->PerformByteSwap(staged, numWords, td->OutWordSize);
+        }
+      block = staged;
+      }
+
+    td->OutputSizes[i] =
+      td->Writer->Compressor->Compress(block, size,
+                                       td->Output + i*td->OutputSpace,
+                                       td->OutputSpace);
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkXMLWriter::WriteBinaryDataParallel(void* data, int numWords,
+                                          int wordType)
+{
+  // Compress batches of a few blocks per thread on the global scheduler,
+  // then write each batch in order.  The blocks and the compression
+  // header are the same as when writing one block at a time.
+  vtkXMLWriterCompressTaskData td;
+  td.Writer = this;
+  td.MemWordSize = this->GetWordTypeSize(wordType);
+  td.OutWordSize = this->GetOutputWordTypeSize(wordType);
+  td.BlockWords = this->BlockSize/td.OutWordSize;
+  td.ConvertIds = 0;
+#ifdef VTK_USE_64BIT_IDS
+  td.ConvertIds = ((wordType == VTK_ID_TYPE) &&
+                   (this->IdType == vtkXMLWriter::Int32));
+#endif
+#ifdef VTK_WORDS_BIGENDIAN
+  td.Swap = (td.OutWordSize > 1 && this->ByteOrder != vtkXMLWriter::BigEndian);
+#else
+  td.Swap = (td.OutWordSize > 1 &&
+             this->ByteOrder != vtkXMLWriter::LittleEndian);
+#endif
+
+  unsigned long numBlocks = (numWords + td.BlockWords - 1)/td.BlockWords;
+  unsigned long batchBlocks = 4*this->NumberOfThreads;
+  if(batchBlocks > numBlocks)
+    {
+    batchBlocks = numBlocks;
+    }
+  unsigned long batchWords = batchBlocks*td.BlockWords;
+  td.OutputSpace =
+    this->Compressor->GetMaximumCompressionSpace(td.BlockWords*td.OutWordSize);
+  td.Staging = 0;
+  if(td.ConvertIds || td.Swap)
+    {
+    td.Staging = new unsigned char[batchWords*td.OutWordSize];
+    }
+  td.Output = new unsigned char[batchBlocks*td.OutputSpace];
+  td.OutputSizes = new unsigned long[batchBlocks];
+
+  unsigned char* ptr = reinterpret_cast<unsigned char*>(data);
+  unsigned long wordsLeft = numWords;
+  this->SetProgressPartial(0);
+  int result = 1;
+  while(result && wordsLeft > 0)
+    {
+    td.Data = ptr;
+    td.NumberOfWords = (batchWords < wordsLeft)? batchWords : wordsLeft;
+    vtkIdType count = (td.NumberOfWords + td.BlockWords - 1)/td.BlockWords;
+    vtkTaskScheduler::GetGlobalScheduler()->ParallelFor(
+      0, count, 1, vtkXMLWriter::CompressBlocksTask, &td);
+
+    for(vtkIdType i=0; result && i < count; ++i)
+      {
+      if(!td.OutputSizes[i])
+        {
+        vtkErrorMacro("Error compressing block "
+                      << this->CompressionBlockNumber << ".");
+        result = 0;
+        break;
+        }
+      result = this->DataStream->Write(td.Output + i*td.OutputSpace,
+                                       td.OutputSizes[i]);
+      this->Stream->flush();
+      if (this->Stream->fail())
+        {
+        this->SetErrorCode(vtkErrorCode::GetLastSystemError());
+        result = 0;
+        }
+
+      // Store the compressed size in the compression header.
+      this->CompressionHeader[3+this->CompressionBlockNumber++] =
+        static_cast<HeaderType>(td.OutputSizes[i]);
+      }
+
+    ptr += td.NumberOfWords*td.MemWordSize;
+    wordsLeft -= td.NumberOfWords;
+    this->SetProgressPartial(float(numWords-wordsLeft)/numWords);
+    }
+  this->SetProgressPartial(1);
+
+  delete [] td.Staging;
+  delete [] td.Output;
+  delete [] td.OutputSizes;
+
+  return result;
+}
+
 //----------------------------------------------------------------------------
 void vtkXMLWriter::PerformByteSwap(void* data, int numWords, int wordSize)
 {
@@ -102,6 +102,16 @@ public:
   // be a multiple of the largest scalar data type.
   virtual void SetBlockSize(unsigned int blockSize);
   vtkGetMacro(BlockSize, unsigned int);
+
+  // Description:
+  // Get/Set the number of threads used to compress binary and appended
+  // data.  Batches of blocks are compressed on the global
+  // vtkTaskScheduler and written in order, so the file is the same for
+  // any number of threads.  The compressor must allow concurrent calls
+  // to Compress() on separate buffers, as vtkZLibDataCompressor does.
+  // The default is vtkMultiThreader::GetGlobalDefaultNumberOfThreads().
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
   
   // Description:
   // Get/Set the data mode used for the file's data.  The options are
@@ -245,6 +255,9 @@ protected:
   HeaderType*    CompressionHeader;
   unsigned int   CompressionHeaderLength;
   unsigned long  CompressionHeaderPosition;
+
+  // The number of threads used to compress blocks.
+  int NumberOfThreads;
   
   // The output stream used to write binary and appended data.  May
   // transparently encode the data.
@@ -406,6 +419,8 @@ protected:
   // Internal utility methods.
   int WriteBinaryDataInternal(void* data, int numWords, int wordType);
   int WriteBinaryDataBlock(unsigned char* in_data, int numWords, int wordType);
+  int WriteBinaryDataParallel(void* data, int numWords, int wordType);
+  static void CompressBlocksTask(void* arg, vtkIdType begin, vtkIdType end);
   void PerformByteSwap(void* data, int numWords, int wordSize);
   int CreateCompressionHeader(unsigned long size);
   int WriteCompressionBlock(unsigned char* data, unsigned long size);
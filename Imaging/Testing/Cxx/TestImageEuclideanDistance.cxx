@@ -0,0 +1,282 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageEuclideanDistance.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the algorithms of vtkImageEuclideanDistance.
+// .SECTION Description
+// Transforms images with unit and anisotropic spacings, in two and three
+// dimensions, with Initialize on and off, with each algorithm, float and
+// double output and one and four threads.  The distances must be those
+// computed by the definition, and with unit spacing all the algorithms
+// must give the same values.  The feature ids must be points whose
+// distances are the output values.
+
+#include "vtkDataArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkImageEuclideanDistance.h"
+#include "vtkMath.h"
+#include "vtkPointData.h"
+#include "vtkTaskScheduler.h"
+
+#include <vtkstd/vector>
+
+#include <math.h>
+
+// An image of ones with a few zeros, or of small values when
+// initialValues is on.
+static vtkImageData *MakeImage(int type, const int dims[3],
+                               const double spacing[3], int initialValues)
+{
+  vtkImageData *image = vtkImageData::New();
+  image->SetDimensions(dims[0], dims[1], dims[2]);
+  image->SetSpacing(spacing[0], spacing[1], spacing[2]);
+  image->SetScalarType(type);
+  image->AllocateScalars();
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+    int v = (vtkMath::Random() < 59.0/60.0 ? 1 : 0);
+    if (initialValues)
+      {
+      v *= 20 + vtkMath::Floor(vtkMath::Random(0, 200));
+      }
+    scalars->SetComponent(i, 0, v);
+    }
+  return image;
+}
+
+// The square distances computed by the definition: the first axis gives
+// each point the smaller of its value and the square distance to the
+// nearest zero of its row, and the other axes the smallest of these
+// values plus the square distance to the point.
+static void Distances(vtkImageData *image, int dimensionality,
+                      int initialize, vtkstd::vector<double> &d2)
+{
+  int dims[3];
+  double spacing[3];
+  image->GetDimensions(dims);
+  image->GetSpacing(spacing);
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  vtkIdType n = image->GetNumberOfPoints();
+  vtkstd::vector<double> f(n);
+  vtkIdType i, j;
+  for (i = 0; i < n; ++i)
+    {
+    f[i] = scalars->GetComponent(i, 0);
+    if (initialize)
+      {
+      f[i] = (f[i] ? VTK_INT_MAX : 0.0);
+      }
+    }
+  vtkstd::vector<double> g(f);
+  for (i = 0; i < n; ++i)
+    {
+    for (j = i - i % dims[0]; j < i - i % dims[0] + dims[0]; ++j)
+      {
+      double d = (i - j)*spacing[0]*(i - j)*spacing[0];
+      if (f[j] == 0.0 && d < g[i])
+        {
+        g[i] = d;
+        }
+      }
+    }
+  d2.resize(n);
+  for (i = 0; i < n; ++i)
+    {
+    d2[i] = g[i];
+    for (j = 0; j < n; ++j)
+      {
+      int di[3] = { static_cast<int>(i % dims[0] - j % dims[0]),
+                    static_cast<int>(i/dims[0] % dims[1] -
+                                     j/dims[0] % dims[1]),
+                    static_cast<int>(i/dims[0]/dims[1] - j/dims[0]/dims[1]) };
+      if (di[0] || (dimensionality < 2 && di[1]) ||
+          (dimensionality < 3 && di[2]))
+        {
+        continue;
+        }
+      double d = g[j] + di[1]*spacing[1]*di[1]*spacing[1] +
+        di[2]*spacing[2]*di[2]*spacing[2];
+      d2[i] = (d < d2[i] ? d : d2[i]);
+      }
+    }
+}
+
+static vtkImageData *Transform(vtkImageData *image, int dimensionality,
+                               int initialize, int algorithm, int type,
+                               int ids, int numThreads)
+{
+  vtkTaskScheduler::GetGlobalScheduler()->SetNumberOfThreads(numThreads);
+  vtkImageEuclideanDistance *edt = vtkImageEuclideanDistance::New();
+  edt->SetInput(image);
+  edt->SetDimensionality(dimensionality);
+  edt->SetInitialize(initialize);
+  edt->SetAlgorithm(algorithm);
+  edt->SetOutputScalarType(type);
+  edt->SetGenerateFeatureIds(ids);
+  edt->Update();
+  vtkImageData *output = vtkImageData::New();
+  output->DeepCopy(edt->GetOutput());
+  edt->Delete();
+  return output;
+}
+
+// Whether the feature ids of the output hold points whose distances are
+// the output values.
+static int CheckFeatureIds(vtkImageData *image, vtkImageData *output,
+                           int initialize)
+{
+  vtkIdTypeArray *ids = vtkIdTypeArray::SafeDownCast(
+    output->GetPointData()->GetArray("FeatureIds"));
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  vtkDataArray *values = output->GetPointData()->GetScalars();
+  vtkIdType n = image->GetNumberOfPoints();
+  if (!ids || ids->GetNumberOfTuples() != n)
+    {
+    return 0;
+    }
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    vtkIdType id = ids->GetValue(i);
+    double v = values->GetComponent(i, 0);
+    if (id < 0 || id >= n)
+      {
+      if (id != -1 || fabs(v - VTK_INT_MAX) > 1e-6*VTK_INT_MAX)
+        {
+        return 0;
+        }
+      continue;
+      }
+    double f = scalars->GetComponent(id, 0);
+    if (initialize && f != 0.0)
+      {
+      return 0;
+      }
+    double x[3], y[3];
+    image->GetPoint(i, x);
+    image->GetPoint(id, y);
+    double d = (initialize ? 0.0 : f) + vtkMath::Distance2BetweenPoints(x, y);
+    if (fabs(d - v) > 1e-6*(d > 1.0 ? d : 1.0))
+      {
+      return 0;
+      }
+    }
+  return 1;
+}
+
+static int TestImage(int type, int dim0, int dim1, int dim2, double spacing0,
+                     double spacing1, double spacing2, int dimensionality,
+                     int initialize)
+{
+  int dims[3] = { dim0, dim1, dim2 };
+  double spacing[3] = { spacing0, spacing1, spacing2 };
+  vtkImageData *image = MakeImage(type, dims, spacing, !initialize);
+  vtkstd::vector<double> expected;
+  Distances(image, dimensionality, initialize, expected);
+  int unitSpacing = (spacing0 == 1.0 && spacing1 == 1.0 && spacing2 == 1.0);
+  vtkImageData *first = 0;
+
+  int retVal = 0;
+  for (int algorithm = VTK_EDT_SAITO_CACHED; algorithm <= VTK_EDT_LINEAR;
+       ++algorithm)
+    {
+    for (int numThreads = 1; numThreads <= 4; numThreads += 3)
+      {
+      for (int outType = VTK_FLOAT; outType <= VTK_DOUBLE; ++outType)
+        {
+        int ids = (algorithm == VTK_EDT_LINEAR && numThreads == 4);
+        vtkImageData *output = Transform(image, dimensionality, initialize,
+                                         algorithm, outType, ids, numThreads);
+        vtkDataArray *values = output->GetPointData()->GetScalars();
+        int ok = (values->GetDataType() == outType &&
+                  values->GetNumberOfTuples() ==
+                  static_cast<vtkIdType>(expected.size()));
+        for (vtkIdType i = 0; ok && i < values->GetNumberOfTuples(); ++i)
+          {
+          double d = expected[i];
+          double v = values->GetComponent(i, 0);
+          // Float values are exact for the integer distances of unit
+          // spacing, below the maximum distance.
+          double tol = ((outType == VTK_FLOAT && !(unitSpacing && d < 1e7)) ?
+                        1e-6 : 1e-12)*(d > 1.0 ? d : 1.0);
+          ok = (fabs(v - d) <= tol);
+          }
+        if (ok && ids)
+          {
+          ok = CheckFeatureIds(image, output, initialize);
+          }
+        // With unit spacing, the double values of all the algorithms are
+        // the same.
+        if (ok && unitSpacing && outType == VTK_DOUBLE)
+          {
+          if (!first)
+            {
+            first = output;
+            first->Register(0);
+            }
+          vtkDataArray *a = first->GetPointData()->GetScalars();
+          ok = (memcmp(a->GetVoidPointer(0), values->GetVoidPointer(0),
+                       a->GetNumberOfTuples()*sizeof(double)) == 0);
+          }
+        if (!ok)
+          {
+          cerr << image->GetScalarTypeAsString() << " " << dim0 << "x"
+               << dim1 << "x" << dim2 << " image, spacing " << spacing0
+               << " " << spacing1 << " " << spacing2 << ", dimensionality "
+               << dimensionality << ", initialize " << initialize
+               << ", algorithm " << algorithm << ", " << numThreads
+               << " threads, " << (outType == VTK_FLOAT ? "float" : "double")
+               << " output" << (ids ? " with feature ids" : "")
+               << ": the distances differ\n";
+          retVal = 1;
+          }
+        output->Delete();
+        }
+      }
+    }
+  if (first)
+    {
+    first->Delete();
+    }
+  image->Delete();
+  return retVal;
+}
+
+int TestImageEuclideanDistance(int, char *[])
+{
+  vtkMath::RandomSeed(8775070);
+  int retVal = 0;
+  retVal |= TestImage(VTK_UNSIGNED_CHAR, 23, 19, 11, 1.0, 1.0, 1.0, 3, 1);
+  retVal |= TestImage(VTK_SHORT, 17, 21, 9, 0.7, 1.3, 2.1, 3, 1);
+  retVal |= TestImage(VTK_FLOAT, 18, 15, 10, 1.0, 1.0, 1.0, 3, 0);
+  retVal |= TestImage(VTK_DOUBLE, 13, 16, 12, 1.5, 0.5, 1.0, 3, 0);
+  retVal |= TestImage(VTK_INT, 40, 35, 3, 1.0, 1.0, 1.0, 2, 1);
+  retVal |= TestImage(VTK_SHORT, 31, 1, 1, 0.3, 1.0, 1.0, 1, 1);
+
+  // Output types other than float and double are rejected.
+  vtkImageEuclideanDistance *edt = vtkImageEuclideanDistance::New();
+  edt->SetOutputScalarTypeToFloat();
+  int display = vtkObject::GetGlobalWarningDisplay();
+  vtkObject::GlobalWarningDisplayOff();
+  edt->SetOutputScalarType(VTK_INT);
+  vtkObject::SetGlobalWarningDisplay(display);
+  if (edt->GetOutputScalarType() != VTK_FLOAT)
+    {
+    cerr << "The output scalar type " << edt->GetOutputScalarType()
+         << " was accepted\n";
+    retVal = 1;
+    }
+  edt->Delete();
+  return retVal;
+}
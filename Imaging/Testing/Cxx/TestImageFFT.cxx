@@ -0,0 +1,291 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageFFT.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of vtkImageFFT and vtkImageRFFT.
+// .SECTION Description
+// Transforms real and complex images whose dimensions have factors of 2,
+// 3, 4 and larger primes, with one and four threads.  The transforms must
+// be the discrete Fourier transforms computed by the definition, and the
+// reverse transforms of the transforms must be the images.  The reverse
+// transform of a real image must be the conjugate of its transform,
+// scaled by the number of points.  The half spectrum must be the first
+// half of the transform along x, and give back real images of even width
+// in two and three dimensions.  Float output must be the double output
+// rounded.
+
+#include "vtkDataArray.h"
+#include "vtkImageData.h"
+#include "vtkImageFFT.h"
+#include "vtkImageRFFT.h"
+#include "vtkMath.h"
+#include "vtkPointData.h"
+
+#include <vtkstd/vector>
+
+#include <math.h>
+
+static vtkImageData *MakeImage(int type, int numComp, const int dims[3])
+{
+  vtkImageData *image = vtkImageData::New();
+  image->SetDimensions(dims[0], dims[1], dims[2]);
+  image->SetScalarType(type);
+  image->SetNumberOfScalarComponents(numComp);
+  image->AllocateScalars();
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+    for (int c = 0; c < numComp; ++c)
+      {
+      scalars->SetComponent(i, c, vtkMath::Floor(vtkMath::Random(0, 256)) -
+                            (type == VTK_UNSIGNED_CHAR ? 0 : 128));
+      }
+    }
+  return image;
+}
+
+// The discrete Fourier transform of the first two components of image,
+// computed one axis after the other by the definition.
+static void Transform(vtkImageData *image, vtkstd::vector<double> &x)
+{
+  int dims[3];
+  image->GetDimensions(dims);
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  vtkIdType n = image->GetNumberOfPoints();
+  x.assign(2*n, 0.0);
+  vtkIdType i;
+  for (i = 0; i < n; ++i)
+    {
+    x[2*i] = scalars->GetComponent(i, 0);
+    if (scalars->GetNumberOfComponents() > 1)
+      {
+      x[2*i + 1] = scalars->GetComponent(i, 1);
+      }
+    }
+  vtkIdType inc = 1;
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    int N = dims[axis];
+    vtkstd::vector<double> row(2*N);
+    for (i = 0; i < n; ++i)
+      {
+      // i is the first value of a row along the axis.
+      if ((i / inc) % N)
+        {
+        continue;
+        }
+      int k, j;
+      for (k = 0; k < N; ++k)
+        {
+        double re = 0.0;
+        double im = 0.0;
+        for (j = 0; j < N; ++j)
+          {
+          double a = -2.0*vtkMath::DoublePi()*((k*j) % N)/N;
+          double xr = x[2*(i + j*inc)];
+          double xi = x[2*(i + j*inc) + 1];
+          re += xr*cos(a) - xi*sin(a);
+          im += xr*sin(a) + xi*cos(a);
+          }
+        row[2*k] = re;
+        row[2*k + 1] = im;
+        }
+      for (k = 0; k < N; ++k)
+        {
+        x[2*(i + k*inc)] = row[2*k];
+        x[2*(i + k*inc) + 1] = row[2*k + 1];
+        }
+      }
+    inc *= N;
+    }
+}
+
+// The first (N + 2)/2 values of the rows along x of the image x of N
+// values along x.
+static void HalfSpectrum(const vtkstd::vector<double> &x, int dim0,
+                         vtkstd::vector<double> &half)
+{
+  int halfDim0 = dim0/2 + 1;
+  vtkIdType numRows = static_cast<vtkIdType>(x.size())/(2*dim0);
+  half.resize(2*halfDim0*numRows);
+  for (vtkIdType i = 0; i < numRows; ++i)
+    {
+    for (int j = 0; j < 2*halfDim0; ++j)
+      {
+      half[2*halfDim0*i + j] = x[2*dim0*i + j];
+      }
+    }
+}
+
+// The largest difference between the values of the output and x, relative
+// to the largest value of x.
+static double Difference(vtkImageData *output, const vtkstd::vector<double> &x,
+                         int type = VTK_DOUBLE)
+{
+  vtkDataArray *scalars = output->GetPointData()->GetScalars();
+  if (scalars->GetDataType() != type ||
+      scalars->GetNumberOfComponents() != 2 ||
+      2*scalars->GetNumberOfTuples() != static_cast<vtkIdType>(x.size()))
+    {
+    return VTK_DOUBLE_MAX;
+    }
+  double maxValue = 0.0;
+  double maxDifference = 0.0;
+  for (size_t i = 0; i < x.size(); ++i)
+    {
+    maxValue = (fabs(x[i]) > maxValue ? fabs(x[i]) : maxValue);
+    double d = fabs(scalars->GetComponent(i/2, i%2) - x[i]);
+    maxDifference = (d > maxDifference ? d : maxDifference);
+    }
+  return maxDifference / (maxValue > 0.0 ? maxValue : 1.0);
+}
+
+static int TestImage(int type, int numComp, int dim0, int dim1, int dim2)
+{
+  int dims[3] = { dim0, dim1, dim2 };
+  vtkImageData *image = MakeImage(type, numComp, dims);
+  vtkstd::vector<double> expected;
+  Transform(image, expected);
+  vtkstd::vector<double> values(expected.size());
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+    values[2*i] = scalars->GetComponent(i, 0);
+    values[2*i + 1] = (numComp > 1 ? scalars->GetComponent(i, 1) : 0.0);
+    }
+
+  int retVal = 0;
+  for (int numThreads = 1; numThreads <= 4; numThreads += 3)
+    {
+    vtkImageFFT *fft = vtkImageFFT::New();
+    fft->SetInput(image);
+    fft->SetNumberOfThreads(numThreads);
+    vtkImageRFFT *rfft = vtkImageRFFT::New();
+    rfft->SetInput(fft->GetOutput());
+    rfft->SetNumberOfThreads(numThreads);
+    rfft->Update();
+
+    double fftDifference = Difference(fft->GetOutput(), expected);
+    double rfftDifference = Difference(rfft->GetOutput(), values);
+    if (numComp == 1)
+      {
+      vtkImageRFFT *real = vtkImageRFFT::New();
+      real->SetInput(image);
+      real->SetNumberOfThreads(numThreads);
+      real->Update();
+      vtkstd::vector<double> conjugate(expected);
+      for (size_t i = 0; i < conjugate.size(); ++i)
+        {
+        conjugate[i] *= (i % 2 ? -1.0 : 1.0) / image->GetNumberOfPoints();
+        }
+      double realDifference = Difference(real->GetOutput(), conjugate);
+      rfftDifference = (realDifference > rfftDifference ?
+                        realDifference : rfftDifference);
+      real->Delete();
+      }
+    if (fftDifference > 1e-12 || rfftDifference > 1e-12)
+      {
+      cerr << image->GetScalarTypeAsString() << " " << dim0 << "x" << dim1
+           << "x" << dim2 << " image of " << numComp << " components, "
+           << numThreads << " threads: the fft differs by "
+           << fftDifference << ", the rfft by " << rfftDifference << "\n";
+      retVal = 1;
+      }
+
+    // The half spectrum, reversed for real images of even width, in
+    // three and two dimensions.
+    fft->HalfSpectrumOn();
+    rfft->HalfSpectrumOn();
+    rfft->Update();
+    vtkstd::vector<double> half;
+    HalfSpectrum(expected, dim0, half);
+    fftDifference = Difference(fft->GetOutput(), half);
+    rfftDifference = 0.0;
+    if (numComp == 1 && dim0 % 2 == 0)
+      {
+      rfftDifference = Difference(rfft->GetOutput(), values);
+      fft->SetDimensionality(2);
+      rfft->SetDimensionality(2);
+      rfft->Update();
+      double difference = Difference(rfft->GetOutput(), values);
+      rfftDifference = (difference > rfftDifference ?
+                        difference : rfftDifference);
+      fft->SetDimensionality(3);
+      rfft->SetDimensionality(3);
+      }
+    if (fftDifference > 1e-12 || rfftDifference > 1e-12)
+      {
+      cerr << image->GetScalarTypeAsString() << " " << dim0 << "x" << dim1
+           << "x" << dim2 << " image of " << numComp << " components, "
+           << numThreads << " threads: the half spectrum differs by "
+           << fftDifference << ", its rfft by " << rfftDifference << "\n";
+      retVal = 1;
+      }
+
+    // Float output.
+    fft->HalfSpectrumOff();
+    rfft->HalfSpectrumOff();
+    fft->SetOutputScalarTypeToFloat();
+    fft->Update();
+    fftDifference = Difference(fft->GetOutput(), expected, VTK_FLOAT);
+    fft->SetOutputScalarTypeToDouble();
+    rfft->SetOutputScalarTypeToFloat();
+    rfft->Update();
+    rfftDifference = Difference(rfft->GetOutput(), values, VTK_FLOAT);
+    if (fftDifference > 1e-6 || rfftDifference > 1e-6)
+      {
+      cerr << image->GetScalarTypeAsString() << " " << dim0 << "x" << dim1
+           << "x" << dim2 << " image of " << numComp << " components, "
+           << numThreads << " threads: the float fft differs by "
+           << fftDifference << ", the float rfft by " << rfftDifference
+           << "\n";
+      retVal = 1;
+      }
+    rfft->Delete();
+    fft->Delete();
+    }
+  image->Delete();
+  return retVal;
+}
+
+int TestImageFFT(int, char *[])
+{
+  vtkMath::RandomSeed(8775070);
+  int retVal = 0;
+  retVal |= TestImage(VTK_SHORT, 1, 12, 15, 7);
+  retVal |= TestImage(VTK_DOUBLE, 2, 12, 15, 7);
+  retVal |= TestImage(VTK_FLOAT, 3, 16, 9, 1);
+  retVal |= TestImage(VTK_UNSIGNED_CHAR, 1, 11, 8, 5);
+  retVal |= TestImage(VTK_INT, 2, 1, 25, 6);
+  retVal |= TestImage(VTK_DOUBLE, 1, 64, 2, 3);
+  retVal |= TestImage(VTK_FLOAT, 1, 10, 6, 9);
+
+  // Output types other than float and double are rejected.
+  vtkImageFFT *fft = vtkImageFFT::New();
+  vtkImageRFFT *rfft = vtkImageRFFT::New();
+  int display = vtkObject::GetGlobalWarningDisplay();
+  vtkObject::GlobalWarningDisplayOff();
+  fft->SetOutputScalarType(VTK_INT);
+  rfft->SetOutputScalarType(VTK_SHORT);
+  vtkObject::SetGlobalWarningDisplay(display);
+  if (fft->GetOutputScalarType() != VTK_DOUBLE ||
+      rfft->GetOutputScalarType() != VTK_DOUBLE)
+    {
+    cerr << "The output scalar types " << fft->GetOutputScalarType()
+         << " and " << rfft->GetOutputScalarType() << " were accepted\n";
+    retVal = 1;
+    }
+  rfft->Delete();
+  fft->Delete();
+  return retVal;
+}
@@ -0,0 +1,140 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageMedian3D.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the histogram medians of vtkImageMedian3D.
+// .SECTION Description
+// Filters images of integer types, with odd and even kernels, kernels
+// larger than the image, several components and one and four threads.
+// The medians of integer data, computed with histograms, must be those
+// of the same data cast to double, computed by sorting.
+
+#include "vtkDataArray.h"
+#include "vtkImageCast.h"
+#include "vtkImageData.h"
+#include "vtkImageMedian3D.h"
+#include "vtkMath.h"
+#include "vtkPointData.h"
+
+// An image of values from min to min + range - 1 with smooth regions and
+// noise.
+static vtkImageData *MakeImage(int type, int numComp, int min, int range)
+{
+  vtkImageData *image = vtkImageData::New();
+  image->SetDimensions(23, 19, 11);
+  image->SetScalarType(type);
+  image->SetNumberOfScalarComponents(numComp);
+  image->AllocateScalars();
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  vtkIdType n = image->GetNumberOfPoints();
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    for (int c = 0; c < numComp; ++c)
+      {
+      int v = (vtkMath::Random() < 0.75 ?
+               static_cast<int>((i/23 % 19)*(range/19.0)) +
+               vtkMath::Floor(vtkMath::Random(0, range/8 + 1)) :
+               vtkMath::Floor(vtkMath::Random(0, range)));
+      scalars->SetComponent(i, c, min + (v < range ? v : range - 1));
+      }
+    }
+  return image;
+}
+
+static vtkImageData *Median(vtkImageData *image, int size0, int size1,
+                            int size2, int numThreads)
+{
+  vtkImageMedian3D *median = vtkImageMedian3D::New();
+  median->SetInput(image);
+  median->SetKernelSize(size0, size1, size2);
+  median->SetNumberOfThreads(numThreads);
+  median->Update();
+  vtkImageData *output = vtkImageData::New();
+  output->DeepCopy(median->GetOutput());
+  median->Delete();
+  return output;
+}
+
+static int Compare(vtkImageData *image, const char *name)
+{
+  static const int kernels[][3] =
+    { {3, 3, 3}, {7, 5, 3}, {4, 4, 2}, {1, 6, 1}, {5, 1, 1}, {6, 5, 13} };
+  vtkImageCast *cast = vtkImageCast::New();
+  cast->SetInput(image);
+  cast->SetOutputScalarTypeToDouble();
+  cast->Update();
+
+  int retVal = 0;
+  for (int k = 0; k < 6; ++k)
+    {
+    const int *size = kernels[k];
+    vtkImageData *expected =
+      Median(cast->GetOutput(), size[0], size[1], size[2], 1);
+    vtkDataArray *e = expected->GetPointData()->GetScalars();
+    for (int numThreads = 1; numThreads <= 4; numThreads += 3)
+      {
+      vtkImageData *output =
+        Median(image, size[0], size[1], size[2], numThreads);
+      vtkDataArray *o = output->GetPointData()->GetScalars();
+      int numComp = e->GetNumberOfComponents();
+      vtkIdType n = e->GetNumberOfTuples()*numComp;
+      vtkIdType i = 0;
+      if (o->GetDataType() != image->GetScalarType() ||
+          o->GetNumberOfTuples()*o->GetNumberOfComponents() != n)
+        {
+        i = -1;
+        }
+      for (; i >= 0 && i < n; ++i)
+        {
+        if (o->GetComponent(i/numComp, i%numComp) !=
+            e->GetComponent(i/numComp, i%numComp))
+          {
+          break;
+          }
+        }
+      if (i != n)
+        {
+        cerr << name << ", kernel " << size[0] << "x" << size[1] << "x"
+             << size[2] << ", " << numThreads << " threads: value " << i
+             << " differs\n";
+        retVal = 1;
+        }
+      output->Delete();
+      }
+    expected->Delete();
+    }
+  cast->Delete();
+  return retVal;
+}
+
+int TestImageMedian3D(int, char *[])
+{
+  vtkMath::RandomSeed(8775070);
+  int retVal = 0;
+  vtkImageData *image = MakeImage(VTK_UNSIGNED_CHAR, 1, 0, 256);
+  retVal |= Compare(image, "unsigned char");
+  image->Delete();
+  image = MakeImage(VTK_CHAR, 3, -128, 256);
+  retVal |= Compare(image, "char, 3 components");
+  image->Delete();
+  image = MakeImage(VTK_SHORT, 1, -1024, 4096);
+  retVal |= Compare(image, "short");
+  image->Delete();
+  image = MakeImage(VTK_UNSIGNED_SHORT, 2, 0, 65536);
+  retVal |= Compare(image, "unsigned short, 2 components");
+  image->Delete();
+  image = MakeImage(VTK_INT, 1, -100000, 1000000);
+  retVal |= Compare(image, "int");
+  image->Delete();
+  return retVal;
+}
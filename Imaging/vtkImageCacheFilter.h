@@ -39,6 +39,12 @@ public:
   // it defaults to 10.
   void SetCacheSize(int size);
   int GetCacheSize();
+
+  // Description:
+  // This is the maximum memory, in kilobytes, that the retained images
+  // may take.  It defaults to 0, no limit other than the cache size.
+  void SetCacheMemoryLimit(unsigned long limit);
+  unsigned long GetCacheMemoryLimit();
   
 protected:
   vtkImageCacheFilter();
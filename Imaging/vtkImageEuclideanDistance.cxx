@@ -14,11 +14,14 @@
 =========================================================================*/
 #include "vtkImageEuclideanDistance.h"
 
+#include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
+#include "vtkPointData.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTaskScheduler.h"
 
 #include <math.h>
 
@@ -33,6 +36,26 @@ vtkImageEuclideanDistance::vtkImageEuclideanDistance()
   this->Initialize = 1;
   this->ConsiderAnisotropy = 1;
   this->Algorithm = VTK_EDT_SAITO;
+  this->OutputScalarType = VTK_DOUBLE;
+  this->GenerateFeatureIds = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageEuclideanDistance::SetOutputScalarType(int type)
+{
+  vtkDebugMacro(<< this->GetClassName() << " (" << this <<
+    "): setting OutputScalarType to " << type);
+  if (type != VTK_FLOAT && type != VTK_DOUBLE)
+    {
+    vtkErrorMacro(<< "SetOutputScalarType: Output must be type float "
+                  << "or double, not " << type);
+    return;
+    }
+  if (this->OutputScalarType != type)
+    {
+    this->OutputScalarType = type;
+    this->Modified();
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -40,7 +63,8 @@ vtkImageEuclideanDistance::vtkImageEuclideanDistance()
 int vtkImageEuclideanDistance::IterativeRequestInformation(
   vtkInformation* vtkNotUsed(input), vtkInformation* output)
 {
-  vtkDataObject::SetPointDataActiveScalarInfo(output, VTK_DOUBLE, 1);
+  vtkDataObject::SetPointDataActiveScalarInfo(output, this->OutputScalarType,
+                                              1);
   return 1;
 }
 
@@ -58,19 +82,19 @@ int vtkImageEuclideanDistance::IterativeRequestUpdateExtent(
 
 //----------------------------------------------------------------------------
 // This templated execute method handles any type input, but the output
-// is always doubles.
-template <class TT>
+// is always floats or doubles.
+template <class TT, class OT>
 void vtkImageEuclideanDistanceCopyData(vtkImageEuclideanDistance *self,
                                        vtkImageData *inData, TT *inPtr,
                                        vtkImageData *outData, int outExt[6], 
-                                       double *outPtr )
+                                       OT *outPtr )
 {
   vtkIdType inInc0, inInc1, inInc2;
   TT *inPtr0, *inPtr1, *inPtr2;
 
   int outMin0, outMax0, outMin1, outMax1, outMin2, outMax2;
   vtkIdType outInc0, outInc1, outInc2;
-  double *outPtr0, *outPtr1, *outPtr2;
+  OT *outPtr0, *outPtr1, *outPtr2;
   
   int idx0, idx1, idx2;
   
@@ -92,7 +116,7 @@ void vtkImageEuclideanDistanceCopyData(vtkImageEuclideanDistance *self,
 
       for (idx0 = outMin0; idx0 <= outMax0; ++idx0)
         {
-        *outPtr0 = *inPtr0 ;
+        *outPtr0 = static_cast<OT>(*inPtr0);
         inPtr0 += inInc0;
         outPtr0 += outInc0;
         }
@@ -106,19 +130,19 @@ void vtkImageEuclideanDistanceCopyData(vtkImageEuclideanDistance *self,
 
 //----------------------------------------------------------------------------
 // This templated execute method handles any type input, but the output
-// is always doubles.
-template <class T>
+// is always floats or doubles.
+template <class T, class OT>
 void vtkImageEuclideanDistanceInitialize(vtkImageEuclideanDistance *self,
                                          vtkImageData *inData, T *inPtr,
                                          vtkImageData *outData, 
-                                         int outExt[6], double *outPtr )
+                                         int outExt[6], OT *outPtr )
 {
   vtkIdType inInc0, inInc1, inInc2;
   T *inPtr0, *inPtr1, *inPtr2;
 
   int outMin0, outMax0, outMin1, outMax1, outMin2, outMax2;
   vtkIdType outInc0, outInc1, outInc2;
-  double *outPtr0, *outPtr1, *outPtr2;
+  OT *outPtr0, *outPtr1, *outPtr2;
   
   int idx0, idx1, idx2;
   double maxDist;
@@ -149,7 +173,7 @@ void vtkImageEuclideanDistanceInitialize(vtkImageEuclideanDistance *self,
         for (idx0 = outMin0; idx0 <= outMax0; ++idx0)
           {
           if( *inPtr0 == 0 ) {*outPtr0 = 0;}
-          else {*outPtr0 = maxDist;}
+          else {*outPtr0 = static_cast<OT>(maxDist);}
                   
           inPtr0 += inInc0;
           outPtr0 += outInc0;
@@ -167,7 +191,7 @@ void vtkImageEuclideanDistanceInitialize(vtkImageEuclideanDistance *self,
     {
     vtkImageEuclideanDistanceCopyData( self, 
                                        inData, (T *)(inPtr), 
-                                       outData, outExt, (double *)(outPtr) );
+                                       outData, outExt, outPtr );
     }
 }
 
@@ -180,14 +204,15 @@ void vtkImageEuclideanDistanceInitialize(vtkImageEuclideanDistance *self,
 // 
 // Notations stay as close as possible to those used in the paper.
 //
+template <class OT>
 void vtkImageEuclideanDistanceExecuteSaito(vtkImageEuclideanDistance *self,
                                            vtkImageData *outData, 
-                                           int outExt[6], double *outPtr )
+                                           int outExt[6], OT *outPtr )
 {
   
   int outMin0, outMax0, outMin1, outMax1, outMin2, outMax2;
   vtkIdType outInc0, outInc1, outInc2;
-  double *outPtr0, *outPtr1, *outPtr2;
+  OT *outPtr0, *outPtr1, *outPtr2;
   int idx0, idx1, idx2, inSize0;
   double maxDist;
   double *sq;
@@ -243,7 +268,7 @@ void vtkImageEuclideanDistanceExecuteSaito(vtkImageEuclideanDistance *self,
           if(*outPtr0 != 0)
             {
             df++ ;
-            if(sq[df] < *outPtr0) {*outPtr0 = sq[df];}
+            if(sq[df] < *outPtr0) {*outPtr0 = static_cast<OT>(sq[df]);}
             }
           else 
             {
@@ -259,7 +284,7 @@ void vtkImageEuclideanDistanceExecuteSaito(vtkImageEuclideanDistance *self,
           if(*outPtr0 != 0)
             {
             df++ ;
-            if(sq[df] < *outPtr0) {*outPtr0 = sq[df];}
+            if(sq[df] < *outPtr0) {*outPtr0 = static_cast<OT>(sq[df]);}
             }
           else 
             {
@@ -307,7 +332,10 @@ void vtkImageEuclideanDistanceExecuteSaito(vtkImageEuclideanDistance *self,
               {
               m=buffer+sq[n+1];
               if(buff[idx0+n]<=m) {n=b;}
-              else if(m<*(outPtr0+n*outInc0)) {*(outPtr0+n*outInc0)=m;}
+              else if(m<*(outPtr0+n*outInc0))
+                {
+                *(outPtr0+n*outInc0)=static_cast<OT>(m);
+                }
               }
             a=b; 
             }
@@ -336,7 +364,10 @@ void vtkImageEuclideanDistanceExecuteSaito(vtkImageEuclideanDistance *self,
               {
               m=buffer+sq[n+1];
               if(buff[idx0-n]<=m) {n=b;}
-              else if(m<*(outPtr0-n*outInc0)) {*(outPtr0-n*outInc0)=m;}
+              else if(m<*(outPtr0-n*outInc0))
+                {
+                *(outPtr0-n*outInc0)=static_cast<OT>(m);
+                }
               }
             a=b;  
             }
@@ -362,14 +393,16 @@ void vtkImageEuclideanDistanceExecuteSaito(vtkImageEuclideanDistance *self,
 //----------------------------------------------------------------------------
 // Execute Saito's algorithm, modified for Cache Efficiency
 //
+template <class OT>
 void vtkImageEuclideanDistanceExecuteSaitoCached(
   vtkImageEuclideanDistance *self,
-  vtkImageData *outData, int outExt[6], double *outPtr )
+  vtkImageData *outData, int outExt[6], OT *outPtr )
 {
   
   int outMin0, outMax0, outMin1, outMax1, outMin2, outMax2;
   vtkIdType outInc0, outInc1, outInc2;
-  double *outPtr0, *outPtr1, *outPtr2;
+  OT *outPtr0, *outPtr1, *outPtr2;
+  double *tempPtr0;
   //
   int idx0, idx1, idx2, inSize0;
   
@@ -428,7 +461,7 @@ void vtkImageEuclideanDistanceExecuteSaitoCached(
           if(*outPtr0 != 0)
             {
             df++ ;
-            if(sq[df] < *outPtr0) {*outPtr0 = sq[df];}
+            if(sq[df] < *outPtr0) {*outPtr0 = static_cast<OT>(sq[df]);}
             }
           else 
             {
@@ -445,7 +478,7 @@ void vtkImageEuclideanDistanceExecuteSaitoCached(
           if(*outPtr0 != 0)
             {
             df++ ;
-            if(sq[df] < *outPtr0) {*outPtr0 = sq[df];}
+            if(sq[df] < *outPtr0) {*outPtr0 = static_cast<OT>(sq[df]);}
             }
           else 
             {
@@ -478,8 +511,8 @@ void vtkImageEuclideanDistanceExecuteSaitoCached(
               
         // forward scan 
         a=0; buffer=buff[ outMin0 ];
-        outPtr0 = temp ;
-        outPtr0 ++;
+        tempPtr0 = temp ;
+        tempPtr0 ++;
               
         for (idx0 = outMin0+1; idx0 <= outMax0; ++idx0)
           {
@@ -494,7 +527,7 @@ void vtkImageEuclideanDistanceExecuteSaitoCached(
               {
               m=buffer+sq[n+1];
               if(buff[idx0+n]<=m) {n=b;}  
-              else if(m<*(outPtr0+n)) {*(outPtr0+n)=m;}
+              else if(m<*(tempPtr0+n)) {*(tempPtr0+n)=m;}
               }
             a=b; 
             }
@@ -504,11 +537,11 @@ void vtkImageEuclideanDistanceExecuteSaitoCached(
             }
                   
           buffer=buff[idx0];
-          outPtr0 ++;
+          tempPtr0 ++;
           }
               
         // backward scan
-        outPtr0 -= 2;
+        tempPtr0 -= 2;
         a=0;
         buffer=buff[outMax0];
     
@@ -524,7 +557,7 @@ void vtkImageEuclideanDistanceExecuteSaitoCached(
               {
               m=buffer+sq[n+1];
               if(buff[idx0-n]<=m) {n=b;}
-              else if(m<*(outPtr0-n)) {*(outPtr0-n)=m;}
+              else if(m<*(tempPtr0-n)) {*(tempPtr0-n)=m;}
               }
             a=b;  
             }
@@ -533,14 +566,14 @@ void vtkImageEuclideanDistanceExecuteSaitoCached(
             a=0;
             }
           buffer=buff[idx0];
-          outPtr0 --;
+          tempPtr0 --;
           }
 
         // Unbuffer current values 
         outPtr0 = outPtr1;
         for (idx0 = outMin0; idx0 <= outMax0; ++idx0)
           {
-          *outPtr0 = temp[idx0];
+          *outPtr0 = static_cast<OT>(temp[idx0]);
           outPtr0 += outInc0;
           }
 
@@ -554,6 +587,355 @@ void vtkImageEuclideanDistanceExecuteSaitoCached(
   free(temp);
   free(sq);
 }
+
+//----------------------------------------------------------------------------
+// Set the feature id of each point: the point itself if its value is zero,
+// or if the input values are the initial distances, and none otherwise.
+// The ids of the points are the offsets of their values, since the output
+// has one component and spans the whole extent.
+template <class OT>
+void vtkImageEuclideanDistanceInitializeIds(vtkImageEuclideanDistance *self,
+                                            vtkImageData *outData,
+                                            int outExt[6], OT *outPtr,
+                                            vtkIdType *idPtr)
+{
+  int outMin0, outMax0, outMin1, outMax1, outMin2, outMax2;
+  vtkIdType outInc0, outInc1, outInc2;
+  OT *outPtr0, *outPtr1, *outPtr2;
+  OT *outBase = static_cast<OT *>(outData->GetScalarPointer());
+  int idx0, idx1, idx2;
+  int initialize = self->GetInitialize();
+
+  self->PermuteExtent(outExt, outMin0,outMax0,outMin1,outMax1,outMin2,outMax2);
+  self->PermuteIncrements(outData->GetIncrements(), outInc0, outInc1, outInc2);
+
+  outPtr2 = outPtr;
+  for (idx2 = outMin2; idx2 <= outMax2; ++idx2)
+    {
+    outPtr1 = outPtr2;
+    for (idx1 = outMin1; idx1 <= outMax1; ++idx1)
+      {
+      outPtr0 = outPtr1;
+      for (idx0 = outMin0; idx0 <= outMax0; ++idx0)
+        {
+        idPtr[outPtr0 - outPtr] =
+          (initialize && *outPtr0 != 0 ? -1 : outPtr0 - outBase);
+        outPtr0 += outInc0;
+        }
+      outPtr1 += outInc1;
+      }
+    outPtr2 += outInc2;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Execute the algorithm of Felzenszwalb and Huttenlocher.
+//
+// P. F. Felzenszwalb and D. P. Huttenlocher. Distance transforms of
+// sampled functions. Cornell Computing and Information Science Technical
+// Report TR2004-1963, 2004.
+//
+// The first iteration is the first iteration of Saito's algorithm, which
+// is linear.  The next ones compute for each row the lower envelope of the
+// parabolas f(q) + spacing*(x-q)^2 of its values f: v holds the roots of
+// the parabolas of the envelope, and parabola v[k] is the lowest between
+// z[k] and z[k+1].  The feature ids, if any, follow the values.
+template <class OT>
+void vtkImageEuclideanDistanceExecuteLinear(vtkImageEuclideanDistance *self,
+                                            vtkImageData *outData, 
+                                            int outExt[6], OT *outPtr,
+                                            vtkIdType *idPtr)
+{
+  int outMin0, outMax0, outMin1, outMax1, outMin2, outMax2;
+  vtkIdType outInc0, outInc1, outInc2;
+  OT *outPtr0, *outPtr1, *outPtr2;
+  int idx0, idx1, idx2, inSize0;
+  double maxDist;
+  double *sq;
+  int df, k, q;
+  double m, s;
+  double spacing;
+  vtkIdType site;
+  
+  // Reorder axes (The outs here are just placeholdes
+  self->PermuteExtent(outExt, outMin0,outMax0,outMin1,outMax1,outMin2,outMax2);
+  self->PermuteIncrements(outData->GetIncrements(), outInc0, outInc1, outInc2);
+  
+  inSize0 = outMax0 - outMin0 + 1;  
+  maxDist = self->GetMaximumDistance();
+
+  // precompute sq[] as Saito's algorithm does.
+  sq = new double[inSize0*2+2];
+  for(df=2*inSize0+1;df>inSize0;df--)
+    {
+    sq[df]=maxDist;
+    }
+  if ( self->GetConsiderAnisotropy() )
+    {
+    spacing = outData->GetSpacing()[ self->GetIteration() ];
+    }
+  else
+    {
+    spacing = 1;
+    }
+  spacing*=spacing;
+  for(df=inSize0;df>=0;df--) 
+    {
+    sq[df]=df*df*spacing;
+    }
+
+  if ( self->GetIteration() == 0 ) 
+    {
+    outPtr2 = outPtr;
+    for (idx2 = outMin2; idx2 <= outMax2; ++idx2)
+      {
+      outPtr1 = outPtr2;
+      for (idx1 = outMin1; idx1 <= outMax1; ++idx1)
+        {
+        outPtr0 = outPtr1;
+        df = inSize0;
+        site = -1;
+        for (idx0 = outMin0; idx0 <= outMax0; ++idx0)
+          {
+          if (*outPtr0 != 0)
+            {
+            df++;
+            if (sq[df] < *outPtr0)
+              {
+              *outPtr0 = static_cast<OT>(sq[df]);
+              if (idPtr)
+                {
+                idPtr[outPtr0 - outPtr] = site;
+                }
+              }
+            }
+          else 
+            {
+            df = 0;
+            site = (idPtr ? idPtr[outPtr0 - outPtr] : -1);
+            }
+          outPtr0 += outInc0;
+          }
+              
+        outPtr0 -= outInc0;
+        df = inSize0;
+        site = -1;
+        for (idx0 = outMax0; idx0 >= outMin0; --idx0)
+          {
+          if (*outPtr0 != 0)
+            {
+            df++;
+            if (sq[df] < *outPtr0)
+              {
+              *outPtr0 = static_cast<OT>(sq[df]);
+              if (idPtr)
+                {
+                idPtr[outPtr0 - outPtr] = site;
+                }
+              }
+            }
+          else 
+            {
+            df = 0;
+            site = (idPtr ? idPtr[outPtr0 - outPtr] : -1);
+            }
+          outPtr0 -= outInc0;
+          }
+        outPtr1 += outInc1;
+        }
+      outPtr2 += outInc2;
+      }      
+    }
+  else // next iterations are all identical. 
+    {
+    double *f = new double[inSize0];
+    double *z = new double[inSize0 + 1];
+    int *v = new int[inSize0];
+    vtkIdType *ids = (idPtr ? new vtkIdType[inSize0] : 0);
+
+    outPtr2 = outPtr;
+    for (idx2 = outMin2; idx2 <= outMax2; ++idx2)
+      {
+      outPtr1 = outPtr2;
+      for (idx1 = outMin1; idx1 <= outMax1; ++idx1)
+        {
+        // Buffer current values 
+        outPtr0 = outPtr1;
+        for (q = 0; q < inSize0; ++q)
+          {
+          f[q] = *outPtr0;
+          if (ids)
+            {
+            ids[q] = idPtr[outPtr0 - outPtr];
+            }
+          outPtr0 += outInc0;
+          }
+
+        // Build the lower envelope.
+        k = 0;
+        v[0] = 0;
+        z[0] = -VTK_DOUBLE_MAX;
+        z[1] = VTK_DOUBLE_MAX;
+        for (q = 1; q < inSize0; ++q)
+          {
+          // Where parabola q gets below parabola v[k].
+          s = ((f[q] - f[v[k]])/spacing + (q - v[k])*(double)(q + v[k])) /
+            (2.0*(q - v[k]));
+          while (s <= z[k])
+            {
+            --k;
+            s = ((f[q] - f[v[k]])/spacing + (q - v[k])*(double)(q + v[k])) /
+              (2.0*(q - v[k]));
+            }
+          ++k;
+          v[k] = q;
+          z[k] = s;
+          z[k+1] = VTK_DOUBLE_MAX;
+          }
+
+        // Take the values of the envelope that are lower.
+        k = 0;
+        outPtr0 = outPtr1;
+        for (idx0 = 0; idx0 < inSize0; ++idx0)
+          {
+          while (z[k+1] < idx0)
+            {
+            ++k;
+            }
+          q = v[k];
+          m = f[q] + sq[idx0 > q ? idx0 - q : q - idx0];
+          if (m < f[idx0])
+            {
+            *outPtr0 = static_cast<OT>(m);
+            if (ids)
+              {
+              idPtr[outPtr0 - outPtr] = ids[q];
+              }
+            }
+          outPtr0 += outInc0;
+          }
+        outPtr1 += outInc1;
+        }
+      outPtr2 += outInc2;            
+      } 
+
+    delete [] f;
+    delete [] z;
+    delete [] v;
+    delete [] ids;
+    }
+
+  delete [] sq;
+}
+
+//----------------------------------------------------------------------------
+// This templated function executes the filter on a piece of the output.
+// idPtr points to the feature ids of the piece, if any.
+template <class OT>
+void vtkImageEuclideanDistanceExecute(vtkImageEuclideanDistance *self,
+                                      vtkImageData *inData,
+                                      vtkImageData *outData, int outExt[6],
+                                      OT *outPtr, vtkIdType *idPtr)
+{
+  void *inPtr = inData->GetScalarPointerForExtent(outExt);
+
+  if ( self->GetIteration() == 0 )
+    {
+    switch (inData->GetScalarType())
+      {
+      vtkTemplateMacro(
+        vtkImageEuclideanDistanceInitialize(self, 
+                                            inData, (VTK_TT *)(inPtr), 
+                                            outData, outExt, outPtr ));
+      default:
+        vtkGenericWarningMacro(<< "Execute: Unknown ScalarType");
+        return;
+      } 
+    if (idPtr)
+      {
+      vtkImageEuclideanDistanceInitializeIds(self, outData, outExt,
+                                             outPtr, idPtr);
+      }
+    } 
+  else if ( inPtr != outPtr )
+    {
+    switch (inData->GetScalarType())
+      {    
+      vtkTemplateMacro(
+        vtkImageEuclideanDistanceCopyData(self, 
+                                          inData, (VTK_TT *)(inPtr), 
+                                          outData, outExt, outPtr ));
+      }
+    }
+  
+  // Call the specific algorithms.  Only the linear one gives feature ids.
+  if ( idPtr || self->GetAlgorithm() == VTK_EDT_LINEAR )
+    {
+    vtkImageEuclideanDistanceExecuteLinear( self, outData, outExt, 
+                                            outPtr, idPtr );
+    }
+  else if ( self->GetAlgorithm() == VTK_EDT_SAITO_CACHED )
+    {
+    vtkImageEuclideanDistanceExecuteSaitoCached( self, outData, outExt, 
+                                                 outPtr );
+    }
+  else
+    {
+    vtkImageEuclideanDistanceExecuteSaito( self, outData, outExt, outPtr );
+    }
+}
+
+//----------------------------------------------------------------------------
+// The pieces of an iteration, executed on the threads of the task
+// scheduler.
+struct vtkImageEuclideanDistanceTask
+{
+  vtkImageEuclideanDistance *Filter;
+  vtkImageData *InData;
+  vtkImageData *OutData;
+  vtkIdType *FeatureIds;
+  int Extent[6];
+  int NumberOfPieces;
+};
+
+//----------------------------------------------------------------------------
+static void vtkImageEuclideanDistanceExecutePieces(void *data,
+                                                   vtkIdType begin,
+                                                   vtkIdType end)
+{
+  vtkImageEuclideanDistanceTask *task =
+    static_cast<vtkImageEuclideanDistanceTask *>(data);
+  vtkImageData *outData = task->OutData;
+  int *ext = outData->GetExtent();
+  int *dims = outData->GetDimensions();
+  for (vtkIdType piece = begin; piece < end; ++piece)
+    {
+    int pieceExt[6];
+    task->Filter->SplitExtent(pieceExt, task->Extent, piece,
+                              task->NumberOfPieces);
+    void *outPtr = outData->GetScalarPointerForExtent(pieceExt);
+    vtkIdType *idPtr = 0;
+    if (task->FeatureIds)
+      {
+      idPtr = task->FeatureIds + (pieceExt[0] - ext[0]) +
+        (pieceExt[2] - ext[2])*dims[0] +
+        (pieceExt[4] - ext[4])*static_cast<vtkIdType>(dims[0])*dims[1];
+      }
+    if (outData->GetScalarType() == VTK_FLOAT)
+      {
+      vtkImageEuclideanDistanceExecute(task->Filter, task->InData, outData,
+                                       pieceExt, static_cast<float *>(outPtr),
+                                       idPtr);
+      }
+    else
+      {
+      vtkImageEuclideanDistanceExecute(task->Filter, task->InData, outData,
+                                       pieceExt,
+                                       static_cast<double *>(outPtr), idPtr);
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkImageEuclideanDistance::AllocateOutputScalars(vtkImageData *outData)
 {
@@ -563,7 +945,9 @@ void vtkImageEuclideanDistance::AllocateOutputScalars(vtkImageData *outData)
 
 //----------------------------------------------------------------------------
 // This method is passed input and output Datas, and executes the
-// EuclideanDistance algorithm to fill the output from the input.
+// EuclideanDistance algorithm to fill the output from the input.  The
+// rows along the axis of the iteration are split into pieces, which the
+// threads of the task scheduler execute.
 int vtkImageEuclideanDistance::IterativeRequestData(
   vtkInformation* vtkNotUsed( request ),
   vtkInformationVector** inputVector,
@@ -576,10 +960,24 @@ int vtkImageEuclideanDistance::IterativeRequestData(
   vtkImageData *outData = vtkImageData::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  this->AllocateOutputScalars(outData);
+  // The input of the next iterations is the output of the last one,
+  // whose values are updated in place.
+  vtkDataArray *inScalars = inData->GetPointData()->GetScalars();
+  outData->SetExtent(outData->GetWholeExtent());
+  if ( this->GetIteration() > 0 && inScalars &&
+       inScalars->GetDataType() == this->OutputScalarType &&
+       inScalars->GetNumberOfComponents() == 1 &&
+       inScalars->GetNumberOfTuples() == inData->GetNumberOfPoints() &&
+       inData->GetNumberOfPoints() == outData->GetNumberOfPoints() )
+    {
+    outData->GetPointData()->SetScalars(inScalars);
+    }
+  else
+    {
+    this->AllocateOutputScalars(outData);
+    }
   
   void *inPtr;
-  void *outPtr;
 
   vtkDebugMacro(<<"Executing image euclidean distance");
   
@@ -588,7 +986,6 @@ int vtkImageEuclideanDistance::IterativeRequestData(
   
   inPtr = inData->GetScalarPointerForExtent(
     inInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT()));
-  outPtr = outData->GetScalarPointer();
    
   if (!inPtr)
     {
@@ -597,10 +994,11 @@ int vtkImageEuclideanDistance::IterativeRequestData(
     }
    
   
-  // this filter expects that the output be doubles.
-  if (outData->GetScalarType() != VTK_DOUBLE)
+  // this filter expects that the output be floats or doubles.
+  if (outData->GetScalarType() != VTK_DOUBLE &&
+      outData->GetScalarType() != VTK_FLOAT)
     {
-    vtkErrorMacro(<< "Execute: Output must be be type double.");
+    vtkErrorMacro(<< "Execute: Output must be be type float or double.");
     return 1;
     }
   
@@ -610,48 +1008,69 @@ int vtkImageEuclideanDistance::IterativeRequestData(
     vtkErrorMacro(<< "Execute: Cannot handle more than 1 components");
     return 1;
     }
-  
-  if ( this->GetIteration() == 0 )
+
+  if ( this->Algorithm != VTK_EDT_SAITO &&
+       this->Algorithm != VTK_EDT_SAITO_CACHED &&
+       this->Algorithm != VTK_EDT_LINEAR )
     {
-    switch (inData->GetScalarType())
+    vtkErrorMacro(<< "Execute: Unknown Algorithm");
+    return 1;
+    }
+
+  // The feature ids of the first iteration are updated in place by the
+  // next ones.
+  vtkIdTypeArray *featureIds = 0;
+  if ( this->GenerateFeatureIds )
+    {
+    if ( this->GetIteration() == 0 )
       {
-      vtkTemplateMacro(
-        vtkImageEuclideanDistanceInitialize(this, 
-                                            inData, (VTK_TT *)(inPtr), 
-                                            outData, outExt, 
-                                            (double *)(outPtr) ));
-      default:
-        vtkErrorMacro(<< "Execute: Unknown ScalarType");
+      featureIds = vtkIdTypeArray::New();
+      featureIds->SetName("FeatureIds");
+      featureIds->SetNumberOfTuples(outData->GetNumberOfPoints());
+      outData->GetPointData()->AddArray(featureIds);
+      featureIds->Delete();
+      }
+    else
+      {
+      featureIds = vtkIdTypeArray::SafeDownCast(
+        inData->GetPointData()->GetArray("FeatureIds"));
+      if (!featureIds ||
+          featureIds->GetNumberOfTuples() != outData->GetNumberOfPoints())
+        {
+        vtkErrorMacro(<< "Execute: No feature ids from the last iteration.");
         return 1;
-      } 
-    } 
-  else 
-    { 
-    if( inData != outData )
-      switch (inData->GetScalarType())
-        {    
-        vtkTemplateMacro(
-          vtkImageEuclideanDistanceCopyData(this, 
-                                            inData, (VTK_TT *)(inPtr), 
-                                            outData, outExt, 
-                                            (double *)(outPtr) ));
         }
+      outData->GetPointData()->AddArray(featureIds);
+      }
     }
-  
-  // Call the specific algorithms. 
-  switch( this->GetAlgorithm() ) 
+  else
     {
-    case VTK_EDT_SAITO:
-      vtkImageEuclideanDistanceExecuteSaito( this, outData, outExt, 
-                                             (double *)(outPtr) );
-      break;
-    case VTK_EDT_SAITO_CACHED:
-      vtkImageEuclideanDistanceExecuteSaitoCached( this, outData, outExt, 
-                                                   (double *)(outPtr) );
-      break;
-    default:
-      vtkErrorMacro(<< "Execute: Unknown Algorithm");
+    outData->GetPointData()->RemoveArray("FeatureIds");
     }
+
+  vtkImageEuclideanDistanceTask task;
+  task.Filter = this;
+  task.InData = inData;
+  task.OutData = outData;
+  task.FeatureIds = (featureIds ? featureIds->GetPointer(0) : 0);
+  memcpy(task.Extent, outExt, 6 * sizeof(int));
+  task.NumberOfPieces = 1;
+  int numThreads =
+    vtkTaskScheduler::GetGlobalScheduler()->GetNumberOfThreads();
+  if (numThreads > 1)
+    {
+    // Several pieces per thread balance rows of different costs.
+    int splitExt[6];
+    task.NumberOfPieces =
+      this->SplitExtent(splitExt, outExt, 0, 4 * numThreads);
+    }
+
+  // always shut off debugging to avoid threading problems with GetMacros
+  int debug = this->Debug;
+  this->Debug = 0;
+  vtkTaskScheduler::GetGlobalScheduler()->ParallelFor(
+    0, task.NumberOfPieces, 1, vtkImageEuclideanDistanceExecutePieces, &task);
+  this->Debug = debug;
   
   this->UpdateProgress((this->GetIteration()+1.0)/3.0);
 
@@ -745,10 +1164,18 @@ void vtkImageEuclideanDistance::PrintSelf(ostream& os, vtkIndent indent)
     {
     os << "Saito\n";
     }
+  else if ( this->Algorithm == VTK_EDT_LINEAR )
+    {
+    os << "Linear\n";
+    }
   else 
     {
     os << "Saito Cached\n";
     }
+
+  os << indent << "Output Scalar Type: " << this->OutputScalarType << "\n";
+  os << indent << "Generate Feature Ids: " 
+     << (this->GenerateFeatureIds ? "On\n" : "Off\n");
 }
   
 
@@ -29,6 +29,15 @@
 // slow it very significantly. In that case, one should use 
 // ::SetAlgorithmToSaitoCached() instead for better performance. 
 //
+// ::SetAlgorithmToLinear() selects the algorithm of Felzenszwalb and
+// Huttenlocher, which computes the lower envelope of the parabolas of a
+// row in linear time.  It gives the same distances as Saito's algorithm
+// with a cost that does not depend on the distances, and can also give
+// the nearest feature of each point.
+//
+// Each pass is split along the other axes and the pieces are executed on
+// the threads of the vtkTaskScheduler.
+//
 // References:
 //
 // T. Saito and J.I. Toriwaki. New algorithms for Euclidean distance 
@@ -38,6 +47,10 @@
 // O. Cuisenaire. Distance Transformation: fast algorithms and applications
 // to medical image processing. PhD Thesis, Universite catholique de Louvain,
 // October 1999. http://ltswww.epfl.ch/~cuisenai/papers/oc_thesis.pdf 
+//
+// P. F. Felzenszwalb and D. P. Huttenlocher. Distance transforms of
+// sampled functions. Cornell Computing and Information Science Technical
+// Report TR2004-1963, 2004.
  
 
 #ifndef __vtkImageEuclideanDistance_h
@@ -47,6 +60,7 @@
 
 #define VTK_EDT_SAITO_CACHED 0
 #define VTK_EDT_SAITO 1 
+#define VTK_EDT_LINEAR 2
 
 class VTK_IMAGING_EXPORT vtkImageEuclideanDistance : public vtkImageDecomposeFilter
 {
@@ -92,6 +106,7 @@ public:
   // Selects a Euclidean DT algorithm. 
   // 1. Saito
   // 2. Saito-cached 
+  // 3. Linear (Felzenszwalb and Huttenlocher)
   // More algorithms will be added later on. 
   vtkSetMacro(Algorithm, int);
   vtkGetMacro(Algorithm, int);
@@ -99,6 +114,32 @@ public:
     { this->SetAlgorithm(VTK_EDT_SAITO); } 
   void SetAlgorithmToSaitoCached () 
     { this->SetAlgorithm(VTK_EDT_SAITO_CACHED); }   
+  void SetAlgorithmToLinear () 
+    { this->SetAlgorithm(VTK_EDT_LINEAR); }   
+
+  // Description:
+  // Set the scalar type of the output, which is also that of the results
+  // passed from one axis to the next: VTK_DOUBLE (the default) or
+  // VTK_FLOAT, which halves the memory used.  Float distances are exact
+  // for squared distances up to 2^24 voxels.  Other types are rejected.
+  void SetOutputScalarType(int type);
+  vtkGetMacro(OutputScalarType, int);
+  void SetOutputScalarTypeToFloat()
+    { this->SetOutputScalarType(VTK_FLOAT); }
+  void SetOutputScalarTypeToDouble()
+    { this->SetOutputScalarType(VTK_DOUBLE); }
+
+  // Description:
+  // When on, the output gets a vtkIdTypeArray named "FeatureIds" that
+  // holds for each point the id of the nearest zero point of the input,
+  // whose square distance is the output value, or -1 when the value is
+  // MaximumDistance.  With Initialize off, each point starts as its own
+  // feature at the distance of its input value.  The feature ids are
+  // computed by the linear algorithm, which is used whenever they are
+  // generated.
+  vtkSetMacro(GenerateFeatureIds, int);
+  vtkGetMacro(GenerateFeatureIds, int);
+  vtkBooleanMacro(GenerateFeatureIds, int);
 
   virtual int IterativeRequestData(vtkInformation*,
                                    vtkInformationVector**,
@@ -112,6 +153,8 @@ protected:
   int Initialize;
   int ConsiderAnisotropy;
   int Algorithm;
+  int OutputScalarType;
+  int GenerateFeatureIds;
 
   // Replaces "EnlargeOutputUpdateExtent"
   virtual void AllocateOutputScalars(vtkImageData *outData);
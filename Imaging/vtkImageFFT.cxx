@@ -24,12 +24,65 @@
 vtkCxxRevisionMacro(vtkImageFFT, "1.40");
 vtkStandardNewMacro(vtkImageFFT);
 
+// The number of complex values of the rows transformed together.
+#define VTK_IMAGE_FFT_BATCH_VALUES 8192
+
+//----------------------------------------------------------------------------
+vtkImageFFT::vtkImageFFT()
+{
+  this->HalfSpectrum = 0;
+  this->OutputScalarType = VTK_DOUBLE;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFFT::SetOutputScalarType(int type)
+{
+  vtkDebugMacro(<< this->GetClassName() << " (" << this <<
+    "): setting OutputScalarType to " << type);
+  if (type != VTK_FLOAT && type != VTK_DOUBLE)
+    {
+    vtkErrorMacro(<< "SetOutputScalarType: Output must be type float "
+                  << "or double, not " << type);
+    return;
+    }
+  if (this->OutputScalarType != type)
+    {
+    this->OutputScalarType = type;
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFFT::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "HalfSpectrum: " << (this->HalfSpectrum ? "On\n" : "Off\n");
+  os << indent << "OutputScalarType: " << this->OutputScalarType << "\n";
+}
+
 //----------------------------------------------------------------------------
 // This extent of the components changes to real and imaginary values.
+// The results passed from one axis to the next are doubles; only the last
+// axis writes the output scalar type.  The half spectrum keeps the
+// frequencies 0 to N/2 of the x axis.
 int vtkImageFFT::IterativeRequestInformation(
   vtkInformation* vtkNotUsed(input), vtkInformation* output)
 {
-  vtkDataObject::SetPointDataActiveScalarInfo(output, VTK_DOUBLE, 2);
+  int type = VTK_DOUBLE;
+  if (this->Iteration == this->NumberOfIterations - 1)
+    {
+    type = this->OutputScalarType;
+    }
+  vtkDataObject::SetPointDataActiveScalarInfo(output, type, 2);
+
+  if (this->HalfSpectrum && this->Iteration == 0)
+    {
+    int wExt[6];
+    output->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wExt);
+    wExt[1] = wExt[0] + (wExt[1] - wExt[0] + 1) / 2;
+    output->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wExt, 6);
+    }
   return 1;
 }
 
@@ -57,27 +110,33 @@ int vtkImageFFT::IterativeRequestUpdateExtent(
 }
 
 //----------------------------------------------------------------------------
-// This templated execute method handles any type input, but the output
-// is always doubles.
-template <class T>
+// This templated execute method handles any type input, and double or
+// float output.  The rows are transformed in batches, interleaved so
+// that the butterfly stages of all the rows of a batch run together.
+// Real rows are transformed two at a time.
+template <class T, class OT>
 void vtkImageFFTExecute(vtkImageFFT *self,
                         vtkImageData *inData, int inExt[6], T *inPtr,
-                        vtkImageData *outData, int outExt[6], double *outPtr,
+                        vtkImageData *outData, int outExt[6], OT *outPtr,
                         int id)
 {
-  vtkImageComplex *inComplex;
-  vtkImageComplex *outComplex;
+  vtkImageComplex *rows;
+  vtkImageComplex *work;
+  vtkImageComplex *roots;
+  vtkImageComplex *result;
   vtkImageComplex *pComplex;
   //
   int inMin0, inMax0;
   vtkIdType inInc0, inInc1, inInc2;
-  T *inPtr0, *inPtr1, *inPtr2;
+  T **inRows;
   //
   int outMin0, outMax0, outMin1, outMax1, outMin2, outMax2;
   vtkIdType outInc0, outInc1, outInc2;
-  double *outPtr0, *outPtr1, *outPtr2;
+  OT **outRows;
+  OT *outPtr0;
   //
   int idx0, idx1, idx2, inSize0, numberOfComponents;
+  int real, batchSize, numRows, row, num, numComplex, stride, r;
   unsigned long count = 0;
   unsigned long target;
   double startProgress;
@@ -99,69 +158,126 @@ void vtkImageFFTExecute(vtkImageFFT *self,
     vtkGenericWarningMacro("No real components");
     return;
     }
+  // Without imaginary components, two rows make one complex row.
+  real = (numberOfComponents == 1);
 
   // Allocate the arrays of complex numbers
-  inComplex = new vtkImageComplex[inSize0];
-  outComplex = new vtkImageComplex[inSize0];
+  batchSize = VTK_IMAGE_FFT_BATCH_VALUES / inSize0;
+  batchSize = (batchSize < 1 ? 1 : (batchSize > 16 ? 16 : batchSize));
+  rows = new vtkImageComplex[inSize0 * batchSize];
+  work = new vtkImageComplex[inSize0 * batchSize * 2];
+  roots = vtkImageFourierFilter::NewFftRoots(inSize0);
+  inRows = new T *[batchSize * 2];
+  outRows = new OT *[batchSize * 2];
+  if (real)
+    {
+    batchSize = batchSize * 2;
+    }
 
-  target = (unsigned long)((outMax2-outMin2+1)*(outMax1-outMin1+1)
+  numRows = (outMax2 - outMin2 + 1)*(outMax1 - outMin1 + 1);
+  target = (unsigned long)((numRows / batchSize + 1)
                            * self->GetNumberOfIterations() / 50.0);
   target++;
 
-  // loop over other axes
-  inPtr2 = inPtr;
-  outPtr2 = outPtr;
-  for (idx2 = outMin2; idx2 <= outMax2; ++idx2)
+  // loop over the batches of rows
+  for (row = 0; !self->AbortExecute && row < numRows; row += batchSize)
     {
-    inPtr1 = inPtr2;
-    outPtr1 = outPtr2;
-    for (idx1 = outMin1; !self->AbortExecute && idx1 <= outMax1; ++idx1)
+    if (!id) 
       {
-      if (!id) 
+      if (!(count%target))
         {
-        if (!(count%target))
-          {
-          self->UpdateProgress(count/(50.0*target) + startProgress);
-          }
-        count++;
+        self->UpdateProgress(count/(50.0*target) + startProgress);
         }
-      // copy into complex numbers
-      inPtr0 = inPtr1;
-      pComplex = inComplex;
-      for (idx0 = inMin0; idx0 <= inMax0; ++idx0)
+      count++;
+      }
+    num = (numRows - row < batchSize ? numRows - row : batchSize);
+    for (r = 0; r < num; ++r)
+      {
+      idx1 = (row + r) % (outMax1 - outMin1 + 1);
+      idx2 = (row + r) / (outMax1 - outMin1 + 1);
+      inRows[r] = inPtr + idx1*inInc1 + idx2*inInc2;
+      outRows[r] = outPtr + idx1*outInc1 + idx2*outInc2;
+      }
+
+    // copy into complex numbers
+    numComplex = (real ? (num + 1) / 2 : num);
+    pComplex = rows;
+    for (idx0 = 0; idx0 < inSize0; ++idx0)
+      {
+      for (r = 0; r < numComplex; ++r)
         {
-        pComplex->Real = (double)(*inPtr0);
-        pComplex->Imag = 0.0;
-        if (numberOfComponents > 1)
+        if (real)
+          { // the next row is the imaginary part
+          pComplex->Real = (double)(inRows[2*r][idx0*inInc0]);
+          pComplex->Imag = 0.0;
+          if (2*r + 1 < num)
+            {
+            pComplex->Imag = (double)(inRows[2*r + 1][idx0*inInc0]);
+            }
+          }
+        else
           { // yes we have an imaginary input
-          pComplex->Imag = (double)(inPtr0[1]);;
+          pComplex->Real = (double)(inRows[r][idx0*inInc0]);
+          pComplex->Imag = (double)(inRows[r][idx0*inInc0 + 1]);
           }
-        inPtr0 += inInc0;
         ++pComplex;
         }
+      }
       
-      // Call the method that performs the fft
-      self->ExecuteFft(inComplex, outComplex, inSize0);
+    // Call the method that performs the fft
+    self->ExecuteFftRows(rows, work, roots, inSize0, numComplex, 1);
+    result = rows;
+    stride = numComplex;
+    if (real)
+      {
+      self->SplitRealFftRows(rows, work, inSize0, numComplex);
+      result = work;
+      stride = 2 * numComplex;
+      }
 
-      // copy into output
-      outPtr0 = outPtr1;
-      pComplex = outComplex + (outMin0 - inMin0);
-      for (idx0 = outMin0; idx0 <= outMax0; ++idx0)
+    // copy into output
+    for (idx0 = outMin0; idx0 <= outMax0; ++idx0)
+      {
+      pComplex = result + (idx0 - inMin0)*stride;
+      for (r = 0; r < num; ++r)
         {
-        *outPtr0 = (double)pComplex->Real;
-        outPtr0[1] = (double)pComplex->Imag;
-        outPtr0 += outInc0;
+        outPtr0 = outRows[r] + (idx0 - outMin0)*outInc0;
+        *outPtr0 = (OT)pComplex->Real;
+        outPtr0[1] = (OT)pComplex->Imag;
         ++pComplex;
         }
-      inPtr1 += inInc1;
-      outPtr1 += outInc1;
       }
-    inPtr2 += inInc2;
-    outPtr2 += outInc2;
     }
     
-  delete [] inComplex;
-  delete [] outComplex;
+  delete [] rows;
+  delete [] work;
+  delete [] roots;
+  delete [] inRows;
+  delete [] outRows;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkImageFFTExecute1(vtkImageFFT *self,
+                         vtkImageData *inData, int inExt[6], T *inPtr,
+                         vtkImageData *outData, int outExt[6], void *outPtr,
+                         int id)
+{
+  switch (outData->GetScalarType())
+    {
+    case VTK_DOUBLE:
+      vtkImageFFTExecute(self, inData, inExt, inPtr, outData, outExt,
+                         static_cast<double *>(outPtr), id);
+      break;
+    case VTK_FLOAT:
+      vtkImageFFTExecute(self, inData, inExt, inPtr, outData, outExt,
+                         static_cast<float *>(outPtr), id);
+      break;
+    default:
+      vtkErrorWithObjectMacro(
+        self, "Execute: Output must be be type double or float.");
+      return;
+    }
 }
 
 
@@ -182,13 +298,6 @@ void vtkImageFFT::ThreadedExecute(vtkImageData *inData, vtkImageData *outData,
   inPtr = inData->GetScalarPointerForExtent(inExt);
   outPtr = outData->GetScalarPointerForExtent(outExt);
   
-  // this filter expects that the output be doubles.
-  if (outData->GetScalarType() != VTK_DOUBLE)
-    {
-    vtkErrorMacro(<< "Execute: Output must be be type double.");
-    return;
-    }
-
   // this filter expects input to have 1 or two components
   if (outData->GetNumberOfScalarComponents() != 1 && 
       outData->GetNumberOfScalarComponents() != 2)
@@ -200,9 +309,9 @@ void vtkImageFFT::ThreadedExecute(vtkImageData *inData, vtkImageData *outData,
   // choose which templated function to call.
   switch (inData->GetScalarType())
     {
-    vtkTemplateMacro(vtkImageFFTExecute(this, inData, inExt, 
-                                        (VTK_TT *)(inPtr), outData, outExt, 
-                                        (double *)(outPtr), threadId));
+    vtkTemplateMacro(vtkImageFFTExecute1(this, inData, inExt, 
+                                         (VTK_TT *)(inPtr), outData, outExt, 
+                                         outPtr, threadId));
     default:
       vtkErrorMacro(<< "Execute: Unknown ScalarType");
       return;
@@ -16,12 +16,15 @@
 // .SECTION Description
 // vtkImageFFT implements a  fast Fourier transform.  The input
 // can have real or complex data in any components and data types, but
-// the output is always complex doubles with real values in component0, and
-// imaginary values in component1.  The filter is fastest for images that
+// the output is complex doubles by default, with real values in component0,
+// and imaginary values in component1.  The filter is fastest for images that
 // have power of two sizes.  The filter uses a butterfly fitlers for each
 // prime factor of the dimension.  This makes images with prime number dimensions 
 // (i.e. 17x17) much slower to compute.  Multi dimensional (i.e volumes) 
-// FFT's are decomposed so that each axis executes in series.
+// FFT's are decomposed so that each axis executes in series.  The rows
+// along an axis are transformed in small batches, which share the twiddle
+// factors and walk the data a few rows at a time, and rows of real data
+// are transformed two at a time.
 
 
 #ifndef __vtkImageFFT_h
@@ -35,7 +38,31 @@ class VTK_IMAGING_EXPORT vtkImageFFT : public vtkImageFourierFilter
 public:
   static vtkImageFFT *New();
   vtkTypeRevisionMacro(vtkImageFFT,vtkImageFourierFilter);
+  void PrintSelf(ostream& os, vtkIndent indent);
 
+  // Description:
+  // When HalfSpectrum is on, the output holds only the frequencies 0 to
+  // N/2 along the x axis, where N is the number of x values of the
+  // input.  For a real input the other frequencies are the conjugates of
+  // these, and the results passed to the y and z axes are about half as
+  // large.  vtkImageRFFT with HalfSpectrum on reverses such a transform.
+  // Off by default: the output has the whole spectrum.
+  vtkSetMacro(HalfSpectrum, int);
+  vtkGetMacro(HalfSpectrum, int);
+  vtkBooleanMacro(HalfSpectrum, int);
+
+  // Description:
+  // Set the scalar type of the output: VTK_DOUBLE (the default) or
+  // VTK_FLOAT, which halves its size.  The transform is computed in double
+  // precision either way.  The frequency-domain filters, such as
+  // vtkImageButterworthLowPass, need a double input.  Other types are
+  // rejected.
+  void SetOutputScalarType(int type);
+  vtkGetMacro(OutputScalarType, int);
+  void SetOutputScalarTypeToFloat()
+    { this->SetOutputScalarType(VTK_FLOAT); }
+  void SetOutputScalarTypeToDouble()
+    { this->SetOutputScalarType(VTK_DOUBLE); }
 
   // Description:
   // Used internally for streaming and threads.  
@@ -49,7 +76,7 @@ public:
                   int num, int total);
 
 protected:
-  vtkImageFFT() {};
+  vtkImageFFT();
   ~vtkImageFFT() {};
 
   virtual int IterativeRequestInformation(vtkInformation* in,
@@ -59,6 +86,9 @@ protected:
   
   void ThreadedExecute(vtkImageData *inData, vtkImageData *outData,
                        int outExt[6], int threadId);
+
+  int HalfSpectrum;
+  int OutputScalarType;
 private:
   vtkImageFFT(const vtkImageFFT&);  // Not implemented.
   void operator=(const vtkImageFFT&);  // Not implemented.
@@ -14,6 +14,8 @@
 =========================================================================*/
 #include "vtkImageFourierFilter.h"
 
+#include "vtkMath.h"
+
 #include <math.h>
 
 vtkCxxRevisionMacro(vtkImageFourierFilter, "1.18");
@@ -147,63 +149,281 @@ void vtkImageFourierFilter::ExecuteFftStepN(vtkImageComplex *p_in,
 //----------------------------------------------------------------------------
 // This function calculates the whole fft (or rfft) of an array.
 // The contents of the input array are changed.
-// It is engineered for no decimation so input and output cannot be equal.
 // (fb = 1) => fft, (fb = -1) => rfft;
 void vtkImageFourierFilter::ExecuteFftForwardBackward(vtkImageComplex *in, 
                                                       vtkImageComplex *out, 
                                                       int N, int fb)
 {
-  vtkImageComplex *p1, *p2, *p3;
-  int block_size = 1;
-  int rest_size = N;
-  int n = 2;
-  int idx;
+  vtkImageComplex *roots = vtkImageFourierFilter::NewFftRoots(N);
+  this->ExecuteFftRows(in, out, roots, N, 1, fb);
+  memcpy(out, in, N * sizeof(vtkImageComplex));
+  delete [] roots;
+}
 
-  // If this is a reverse transform (scale accordingly).
-  if(fb == -1)
-    {  
-    p1 = in;
-    for(idx = 0; idx < N; ++idx)
+
+
+/*=========================================================================
+        Interleaved rows of complex numbers.
+
+  The stages below are those of a self-sorting (Stockham) fft: a stage of
+  radix r takes the sequences of length n of the numbers x with stride s
+  (n*s = N) and leaves in y the r sequences of length n/r with stride s*r
+  whose transforms are those of the sequences of x.  The s sequences, and
+  the rows, are contiguous: the inner loops run over L = s*numRows
+  numbers.  Twiddle factor W_n^k is root k*s of the N roots, conjugated
+  for the rfft.
+=========================================================================*/
+
+//----------------------------------------------------------------------------
+static inline void vtkImageFourierFilterRoot(const vtkImageComplex *roots,
+                                             int k, int fb,
+                                             vtkImageComplex &w)
+{
+  w.Real = roots[k].Real;
+  w.Imag = fb * roots[k].Imag;
+}
+
+//----------------------------------------------------------------------------
+static void vtkImageFourierFilterStep2(const vtkImageComplex *x,
+                                       vtkImageComplex *y,
+                                       const vtkImageComplex *roots,
+                                       int n, int s, int L, int fb)
+{
+  int m = n / 2;
+  vtkImageComplex w, d;
+  for (int p = 0; p < m; ++p)
+    {
+    vtkImageFourierFilterRoot(roots, p*s, fb, w);
+    const vtkImageComplex *x0 = x + p*L;
+    const vtkImageComplex *x1 = x + (p + m)*L;
+    vtkImageComplex *y0 = y + 2*p*L;
+    vtkImageComplex *y1 = y0 + L;
+    for (int t = 0; t < L; ++t)
       {
-      p1->Real = p1->Real / (float)(N);
-      p1->Imag = p1->Imag / (float)(N);
-      ++p1;
+      vtkImageComplexAdd(x0[t], x1[t], y0[t]);
+      vtkImageComplexSubtract(x0[t], x1[t], d);
+      vtkImageComplexMultiply(d, w, y1[t]);
       }
     }
-  p1 = in;
-  p2 = out;
-  while(block_size < N && n <= N)
+}
+
+//----------------------------------------------------------------------------
+static void vtkImageFourierFilterStep3(const vtkImageComplex *x,
+                                       vtkImageComplex *y,
+                                       const vtkImageComplex *roots,
+                                       int n, int s, int L, int fb)
+{
+  int m = n / 3;
+  // The imaginary part of W_3 (its real part is -1/2).
+  double sn = -fb * 0.5 * sqrt(3.0);
+  vtkImageComplex w1, w2, t1, t2, u, m1, d;
+  for (int p = 0; p < m; ++p)
+    {
+    vtkImageFourierFilterRoot(roots, p*s, fb, w1);
+    vtkImageFourierFilterRoot(roots, 2*p*s, fb, w2);
+    const vtkImageComplex *x0 = x + p*L;
+    const vtkImageComplex *x1 = x + (p + m)*L;
+    const vtkImageComplex *x2 = x + (p + 2*m)*L;
+    vtkImageComplex *y0 = y + 3*p*L;
+    vtkImageComplex *y1 = y0 + L;
+    vtkImageComplex *y2 = y1 + L;
+    for (int t = 0; t < L; ++t)
+      {
+      vtkImageComplexAdd(x1[t], x2[t], t1);
+      vtkImageComplexSubtract(x1[t], x2[t], t2);
+      vtkImageComplexAdd(x0[t], t1, y0[t]);
+      m1.Real = x0[t].Real - 0.5 * t1.Real;
+      m1.Imag = x0[t].Imag - 0.5 * t1.Imag;
+      u.Real = -sn * t2.Imag;
+      u.Imag = sn * t2.Real;
+      vtkImageComplexAdd(m1, u, d);
+      vtkImageComplexMultiply(d, w1, y1[t]);
+      vtkImageComplexSubtract(m1, u, d);
+      vtkImageComplexMultiply(d, w2, y2[t]);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+static void vtkImageFourierFilterStep4(const vtkImageComplex *x,
+                                       vtkImageComplex *y,
+                                       const vtkImageComplex *roots,
+                                       int n, int s, int L, int fb)
+{
+  int m = n / 4;
+  vtkImageComplex w1, w2, w3, t0, t1, t2, t3, d;
+  for (int p = 0; p < m; ++p)
     {
-    if((rest_size % n) == 0)
+    vtkImageFourierFilterRoot(roots, p*s, fb, w1);
+    vtkImageFourierFilterRoot(roots, 2*p*s, fb, w2);
+    vtkImageFourierFilterRoot(roots, 3*p*s, fb, w3);
+    const vtkImageComplex *x0 = x + p*L;
+    const vtkImageComplex *x1 = x + (p + m)*L;
+    const vtkImageComplex *x2 = x + (p + 2*m)*L;
+    const vtkImageComplex *x3 = x + (p + 3*m)*L;
+    vtkImageComplex *y0 = y + 4*p*L;
+    vtkImageComplex *y1 = y0 + L;
+    vtkImageComplex *y2 = y1 + L;
+    vtkImageComplex *y3 = y2 + L;
+    for (int t = 0; t < L; ++t)
       {
-      // n is a prime factor, perform one "butterfly" stage of the fft.
-      if(n == 2)
+      vtkImageComplexAdd(x0[t], x2[t], t0);
+      vtkImageComplexSubtract(x0[t], x2[t], t1);
+      vtkImageComplexAdd(x1[t], x3[t], t2);
+      // t3 = (x1 - x3) * W_4
+      vtkImageComplexSubtract(x1[t], x3[t], d);
+      t3.Real = fb * d.Imag;
+      t3.Imag = -fb * d.Real;
+      vtkImageComplexAdd(t0, t2, y0[t]);
+      vtkImageComplexAdd(t1, t3, d);
+      vtkImageComplexMultiply(d, w1, y1[t]);
+      vtkImageComplexSubtract(t0, t2, d);
+      vtkImageComplexMultiply(d, w2, y2[t]);
+      vtkImageComplexSubtract(t1, t3, d);
+      vtkImageComplexMultiply(d, w3, y3[t]);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// A stage of any radix r.
+static void vtkImageFourierFilterStepN(const vtkImageComplex *x,
+                                       vtkImageComplex *y,
+                                       const vtkImageComplex *roots,
+                                       int n, int s, int L, int r, int fb)
+{
+  int m = n / r;
+  int j, k, t;
+  vtkImageComplex w, c, d;
+  for (int p = 0; p < m; ++p)
+    {
+    for (j = 0; j < r; ++j)
+      {
+      vtkImageComplex *yj = y + (r*p + j)*L;
+      const vtkImageComplex *xk = x + p*L;
+      for (t = 0; t < L; ++t)
         {
-        this->ExecuteFftStep2(p1, p2, N, block_size, fb);
+        yj[t] = xk[t];
         }
-      else
+      for (k = 1; k < r; ++k)
         {
-        this->ExecuteFftStepN(p1, p2, N, block_size, n, fb);
+        // W_r^(j*k) is root (j*k % r)*N/r, and N/r = m*s.
+        vtkImageFourierFilterRoot(roots, (j*k % r)*m*s, fb, c);
+        xk = x + (p + k*m)*L;
+        for (t = 0; t < L; ++t)
+          {
+          vtkImageComplexMultiply(xk[t], c, d);
+          vtkImageComplexAdd(yj[t], d, yj[t]);
+          }
         }
-      block_size = block_size * n;
-      rest_size = rest_size / n;
-      // switch input and output.
-      p3 = p1;
-      p1 = p2;
-      p2 = p3;
+      if (j && p)
+        {
+        vtkImageFourierFilterRoot(roots, j*p*s, fb, w);
+        for (t = 0; t < L; ++t)
+          {
+          vtkImageComplexMultiply(yj[t], w, yj[t]);
+          }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkImageComplex *vtkImageFourierFilter::NewFftRoots(int N)
+{
+  vtkImageComplex *roots = new vtkImageComplex[N];
+  double q = -2.0 * vtkMath::DoublePi() / N;
+  for (int k = 0; k < N; ++k)
+    {
+    roots[k].Real = cos(q * k);
+    roots[k].Imag = sin(q * k);
+    }
+  return roots;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFourierFilter::ExecuteFftRows(vtkImageComplex *rows,
+                                           vtkImageComplex *work,
+                                           const vtkImageComplex *roots,
+                                           int N, int numRows, int fb)
+{
+  vtkImageComplex *x = rows;
+  vtkImageComplex *y = work;
+  vtkImageComplex *tmp;
+  int n = N;
+  int s = 1;
+  int r, idx;
+
+  while (n > 1)
+    {
+    int L = s * numRows;
+    if (n % 4 == 0)
+      {
+      r = 4;
+      vtkImageFourierFilterStep4(x, y, roots, n, s, L, fb);
+      }
+    else if (n % 2 == 0)
+      {
+      r = 2;
+      vtkImageFourierFilterStep2(x, y, roots, n, s, L, fb);
+      }
+    else if (n % 3 == 0)
+      {
+      r = 3;
+      vtkImageFourierFilterStep3(x, y, roots, n, s, L, fb);
       }
     else
       {
-      // n is not a prime factor. increment n to see if n+1 is.
-      ++n;
+      // The smallest prime factor left.
+      r = 5;
+      while (n % r)
+        {
+        r += 2;
+        }
+      vtkImageFourierFilterStepN(x, y, roots, n, s, L, r, fb);
       }
+    n = n / r;
+    s = s * r;
+    // switch input and output.
+    tmp = x;
+    x = y;
+    y = tmp;
     }
-  // If the results ended up in the input, copy to output.
-  if(p1 != out)
+
+  // If the results ended up in work, copy them to the rows.
+  if (x != rows)
+    {
+    memcpy(rows, x, N * numRows * sizeof(vtkImageComplex));
+    }
+
+  // If this is a reverse transform (scale accordingly).
+  if (fb == -1)
+    {
+    double scale = 1.0 / N;
+    for (idx = 0; idx < N * numRows; ++idx)
+      {
+      vtkImageComplexScale(rows[idx], scale, rows[idx]);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFourierFilter::SplitRealFftRows(const vtkImageComplex *rows,
+                                             vtkImageComplex *out,
+                                             int N, int numRows)
+{
+  for (int k = 0; k < N; ++k)
     {
-    for(n = 0; n < N; ++n)
+    // The transform of a real row at -k is the conjugate of that at k.
+    const vtkImageComplex *z = rows + k*numRows;
+    const vtkImageComplex *zn = rows + ((N - k) % N)*numRows;
+    vtkImageComplex *o = out + 2*k*numRows;
+    for (int r = 0; r < numRows; ++r)
       {
-      *out++ = *p1++;
+      o[2*r].Real = 0.5 * (z[r].Real + zn[r].Real);
+      o[2*r].Imag = 0.5 * (z[r].Imag - zn[r].Imag);
+      o[2*r + 1].Real = 0.5 * (z[r].Imag + zn[r].Imag);
+      o[2*r + 1].Imag = 0.5 * (zn[r].Real - z[r].Real);
       }
     }
 }
@@ -105,6 +105,33 @@ public:
   // (It is engineered for no decimation)
   void ExecuteRfft(vtkImageComplex *in, vtkImageComplex *out, int N);
 
+  // Description:
+  // This function calculates the fft (fb = 1) or the rfft (fb = -1) of
+  // numRows rows of N complex numbers at once.  The rows are interleaved:
+  // number i of row r is rows[i*numRows + r].  The results are left in
+  // rows, and work must hold as many numbers.  The roots are the N
+  // twiddle factors returned by NewFftRoots(N), so that they are computed
+  // once for all the rows of a transform.  Each prime factor of N is a
+  // butterfly stage: factors of 2, 3 and 4 have their own stages.
+  void ExecuteFftRows(vtkImageComplex *rows, vtkImageComplex *work,
+                      const vtkImageComplex *roots, int N, int numRows,
+                      int fb);
+
+  // Description:
+  // Return the N roots of unity exp(-2 pi i k / N) used by
+  // ExecuteFftRows().  The array must be deleted with delete [].
+  static vtkImageComplex *NewFftRoots(int N);
+
+  // Description:
+  // The transforms of two real rows are computed at once by putting the
+  // second row in the imaginary part of the first.  This function
+  // separates the transforms of numRows such interleaved rows of N
+  // numbers into 2*numRows interleaved rows of out: the transform of the
+  // real part of row r is out row 2*r, that of its imaginary part out
+  // row 2*r + 1.  It works for the fft and the rfft.
+  void SplitRealFftRows(const vtkImageComplex *rows, vtkImageComplex *out,
+                        int N, int numRows);
+
   //ETX
   
 protected:
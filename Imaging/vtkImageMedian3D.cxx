@@ -179,6 +179,319 @@ double *vtkImageMedian3DAccumulateMedian(int &UpNum, int &DownNum,
   return Median;
 }
 
+//-----------------------------------------------------------------------------
+// A histogram of the values of a neighborhood in two tiers: fine bins
+// count each value and coarse bins count the values of 2^Shift fine bins.
+// The coarse bin of the last median found is kept with the number of
+// values below it, so that the next median is searched from there.
+class vtkImageMedian3DHistogram
+{
+public:
+  vtkImageMedian3DHistogram(int numBins)
+    {
+    this->Shift = 0;
+    while ((1 << (2*this->Shift)) < numBins)
+      {
+      this->Shift++;
+      }
+    int numCoarse = ((numBins - 1) >> this->Shift) + 1;
+    this->Fine = new int[numBins];
+    this->Coarse = new int[numCoarse];
+    memset(this->Fine, 0, numBins*sizeof(int));
+    memset(this->Coarse, 0, numCoarse*sizeof(int));
+    this->Cursor = 0;
+    this->Below = 0;
+    }
+  ~vtkImageMedian3DHistogram()
+    {
+    delete [] this->Fine;
+    delete [] this->Coarse;
+    }
+
+  void Add(int bin)
+    {
+    this->Fine[bin]++;
+    this->Coarse[bin >> this->Shift]++;
+    this->Below += ((bin >> this->Shift) < this->Cursor);
+    }
+  void Remove(int bin)
+    {
+    this->Fine[bin]--;
+    this->Coarse[bin >> this->Shift]--;
+    this->Below -= ((bin >> this->Shift) < this->Cursor);
+    }
+
+  // Return the bin of the value of rank k (from 0) in increasing order.
+  int Find(int k)
+    {
+    while (this->Below > k)
+      {
+      this->Below -= this->Coarse[--this->Cursor];
+      }
+    while (this->Below + this->Coarse[this->Cursor] <= k)
+      {
+      this->Below += this->Coarse[this->Cursor++];
+      }
+    k -= this->Below;
+    int bin = this->Cursor << this->Shift;
+    while (k >= this->Fine[bin])
+      {
+      k -= this->Fine[bin++];
+      }
+    return bin;
+    }
+
+private:
+  int *Fine;
+  int *Coarse;
+  int Shift;
+  int Cursor;
+  int Below;
+};
+
+//-----------------------------------------------------------------------------
+// Compute the medians of integer data with a histogram of the neighborhood,
+// which is updated as the neighborhood moves along the rows.  The values
+// are the same as those of vtkImageMedian3DAccumulateMedian, which for an
+// even number of samples gives the median of all but the last one.
+// Returns 0, leaving the output alone, if the input values span more than
+// VTK_IMAGE_MEDIAN3D_MAX_BINS values.
+#define VTK_IMAGE_MEDIAN3D_MAX_BINS 65536
+
+template <class T>
+int vtkImageMedian3DHistogramExecute(vtkImageMedian3D *self,
+                                     vtkImageData *inData,
+                                     vtkImageData *outData, T *outPtr,
+                                     int outExt[6], int id,
+                                     vtkDataArray *inArray)
+{
+  int *kernelMiddle, *kernelSize;
+  int outIdx0, outIdx1, outIdx2, outIdxC;
+  vtkIdType inInc0, inInc1, inInc2;
+  vtkIdType outIncX, outIncY, outIncZ;
+  int hoodMin[3], hoodMax[3], regionMax[3];
+  int middleMin[3], middleMax[3];
+  int idx0, idx1, idx2;
+  int *inExt;
+  int numComp;
+  unsigned long count = 0;
+  unsigned long target;
+
+  inData->GetIncrements(inInc0, inInc1, inInc2);
+  outData->GetContinuousIncrements(outExt, outIncX, outIncY, outIncZ);
+  kernelMiddle = self->GetKernelMiddle();
+  kernelSize = self->GetKernelSize();
+  numComp = inArray->GetNumberOfComponents();
+  inExt = inData->GetExtent();
+
+  // The neighborhood of the first pixel, the region of the input used by
+  // the output extent, and the portion of the output that needs no
+  // boundary computation, clipped by the input image extent.
+  for (idx0 = 0; idx0 < 3; ++idx0)
+    {
+    hoodMin[idx0] = outExt[2*idx0] - kernelMiddle[idx0];
+    hoodMax[idx0] = hoodMin[idx0] + kernelSize[idx0] - 1;
+    regionMax[idx0] = outExt[2*idx0+1] - kernelMiddle[idx0] +
+      kernelSize[idx0] - 1;
+    hoodMin[idx0] = (hoodMin[idx0] > inExt[2*idx0]) ?
+      hoodMin[idx0] : inExt[2*idx0];
+    hoodMax[idx0] = (hoodMax[idx0] < inExt[2*idx0+1]) ?
+      hoodMax[idx0] : inExt[2*idx0+1];
+    regionMax[idx0] = (regionMax[idx0] < inExt[2*idx0+1]) ?
+      regionMax[idx0] : inExt[2*idx0+1];
+    middleMin[idx0] = inExt[2*idx0] + kernelMiddle[idx0];
+    middleMax[idx0] = inExt[2*idx0+1] - (kernelSize[idx0] - 1) +
+      kernelMiddle[idx0];
+    }
+
+  T *inPtr = static_cast<T *>(
+    inArray->GetVoidPointer((hoodMin[0] - inExt[0])*inInc0 +
+                            (hoodMin[1] - inExt[2])*inInc1 +
+                            (hoodMin[2] - inExt[4])*inInc2));
+
+  // The range of the values in the region.
+  T minValue = *inPtr;
+  T maxValue = *inPtr;
+  T *inPtr0, *inPtr1, *inPtr2 = inPtr;
+  for (idx2 = hoodMin[2]; idx2 <= regionMax[2]; ++idx2)
+    {
+    inPtr1 = inPtr2;
+    for (idx1 = hoodMin[1]; idx1 <= regionMax[1]; ++idx1)
+      {
+      inPtr0 = inPtr1;
+      for (idx0 = (regionMax[0] - hoodMin[0] + 1)*numComp; idx0 > 0; --idx0)
+        {
+        minValue = (*inPtr0 < minValue ? *inPtr0 : minValue);
+        maxValue = (*inPtr0 > maxValue ? *inPtr0 : maxValue);
+        ++inPtr0;
+        }
+      inPtr1 += inInc1;
+      }
+    inPtr2 += inInc2;
+    }
+  if (static_cast<double>(maxValue) - static_cast<double>(minValue) >=
+      VTK_IMAGE_MEDIAN3D_MAX_BINS)
+    {
+    return 0;
+    }
+  vtkImageMedian3DHistogram histogram(
+    static_cast<int>(maxValue - minValue) + 1);
+
+  target = (unsigned long)((outExt[5] - outExt[4] + 1)*
+    (outExt[3] - outExt[2] + 1)/50.0);
+  target++;
+
+  int hoodStartMin0 = hoodMin[0];
+  int hoodStartMax0 = hoodMax[0];
+  int hoodStartMin1 = hoodMin[1];
+  int hoodStartMax1 = hoodMax[1];
+  int rowLength = (outExt[1] - outExt[0] + 1)*numComp;
+  inPtr2 = inPtr;
+  for (outIdx2 = outExt[4]; outIdx2 <= outExt[5]; ++outIdx2)
+    {
+    inPtr1 = inPtr2;
+    hoodMin[1] = hoodStartMin1;
+    hoodMax[1] = hoodStartMax1;
+    for (outIdx1 = outExt[2];
+         !self->AbortExecute && outIdx1 <= outExt[3]; ++outIdx1)
+      {
+      if (!id)
+        {
+        if (!(count%target))
+          {
+          self->UpdateProgress(count/(50.0*target));
+          }
+        count++;
+        }
+      int hoodSize12 = (hoodMax[1] - hoodMin[1] + 1)*
+        (hoodMax[2] - hoodMin[2] + 1);
+      vtkIdType lastOffset = (hoodMax[1] - hoodMin[1])*inInc1 +
+        (hoodMax[2] - hoodMin[2])*inInc2;
+      for (outIdxC = 0; outIdxC < numComp; outIdxC++)
+        {
+        // The columns of the row from lo to hi are in the histogram.
+        int lo = hoodStartMin0;
+        int hi = lo - 1;
+        hoodMin[0] = hoodStartMin0;
+        hoodMax[0] = hoodStartMax0;
+        T *outPtr0 = outPtr + outIdxC;
+        for (outIdx0 = outExt[0]; outIdx0 <= outExt[1]; ++outIdx0)
+          {
+          for (; hi < hoodMax[0] || lo < hoodMin[0]; )
+            {
+            int add = (hi < hoodMax[0]);
+            int column = (add ? ++hi : lo++);
+            inPtr0 = inPtr1 + (column - hoodStartMin0)*inInc0 + outIdxC;
+            for (idx2 = hoodMin[2]; idx2 <= hoodMax[2]; ++idx2)
+              {
+              T *tmpPtr = inPtr0;
+              for (idx1 = hoodMin[1]; idx1 <= hoodMax[1]; ++idx1)
+                {
+                if (add)
+                  {
+                  histogram.Add(static_cast<int>(*tmpPtr - minValue));
+                  }
+                else
+                  {
+                  histogram.Remove(static_cast<int>(*tmpPtr - minValue));
+                  }
+                tmpPtr += inInc1;
+                }
+              inPtr0 += inInc2;
+              }
+            }
+
+          int num = (hi - lo + 1)*hoodSize12;
+          int bin;
+          if (num % 2)
+            {
+            bin = histogram.Find(num/2);
+            }
+          else
+            {
+            int last = static_cast<int>(
+              inPtr1[(hi - hoodStartMin0)*inInc0 + lastOffset + outIdxC] -
+              minValue);
+            histogram.Remove(last);
+            bin = histogram.Find(num/2 - 1);
+            histogram.Add(last);
+            }
+          *outPtr0 = static_cast<T>(minValue + bin);
+          outPtr0 += numComp;
+
+          // shift neighborhood considering boundaries
+          if (outIdx0 >= middleMin[0])
+            {
+            ++hoodMin[0];
+            }
+          if (outIdx0 < middleMax[0])
+            {
+            ++hoodMax[0];
+            }
+          }
+
+        // Empty the histogram for the next row.
+        for (; lo <= hi; ++lo)
+          {
+          inPtr0 = inPtr1 + (lo - hoodStartMin0)*inInc0 + outIdxC;
+          for (idx2 = hoodMin[2]; idx2 <= hoodMax[2]; ++idx2)
+            {
+            T *tmpPtr = inPtr0;
+            for (idx1 = hoodMin[1]; idx1 <= hoodMax[1]; ++idx1)
+              {
+              histogram.Remove(static_cast<int>(*tmpPtr - minValue));
+              tmpPtr += inInc1;
+              }
+            inPtr0 += inInc2;
+            }
+          }
+        }
+      outPtr += rowLength + outIncY;
+
+      // shift neighborhood considering boundaries
+      if (outIdx1 >= middleMin[1])
+        {
+        inPtr1 += inInc1;
+        ++hoodMin[1];
+        }
+      if (outIdx1 < middleMax[1])
+        {
+        ++hoodMax[1];
+        }
+      }
+    // shift neighborhood considering boundaries
+    if (outIdx2 >= middleMin[2])
+      {
+      inPtr2 += inInc2;
+      ++hoodMin[2];
+      }
+    if (outIdx2 < middleMax[2])
+      {
+      ++hoodMax[2];
+      }
+    outPtr += outIncZ;
+    }
+
+  return 1;
+}
+
+// Real data are left to vtkImageMedian3DAccumulateMedian.
+static int vtkImageMedian3DHistogramExecute(vtkImageMedian3D *,
+                                            vtkImageData *, vtkImageData *,
+                                            float *, int *, int,
+                                            vtkDataArray *)
+{
+  return 0;
+}
+
+static int vtkImageMedian3DHistogramExecute(vtkImageMedian3D *,
+                                            vtkImageData *, vtkImageData *,
+                                            double *, int *, int,
+                                            vtkDataArray *)
+{
+  return 0;
+}
+
 //-----------------------------------------------------------------------------
 // This method contains the second switch statement that calls the correct
 // templated function for the mask types.
@@ -217,6 +530,13 @@ void vtkImageMedian3DExecute(vtkImageMedian3D *self,
     {
     return;
     }
+
+  if (vtkImageMedian3DHistogramExecute(self, inData, outData, outPtr, outExt,
+                                       id, inArray))
+    {
+    delete [] Sort;
+    return;
+    }
   
   // Get information to march through data
   inData->GetIncrements(inInc0, inInc1, inInc2); 
@@ -19,6 +19,12 @@
 // Neighborhoods can be no more than 3 dimensional.  Setting one
 // axis of the neighborhood kernelSize to 1 changes the filter
 // into a 2D median.  
+//
+// Integer data whose values span at most 65536 values are filtered with
+// a histogram of the neighborhood, updated as the neighborhood moves
+// along each row, so the cost per pixel grows with the kernel area
+// rather than its volume.  Other data are sorted.  Both give the same
+// values.
 
 
 #ifndef __vtkImageMedian3D_h
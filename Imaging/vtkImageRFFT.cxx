@@ -24,12 +24,72 @@
 vtkCxxRevisionMacro(vtkImageRFFT, "1.36");
 vtkStandardNewMacro(vtkImageRFFT);
 
+// The number of complex values of the rows transformed together.
+#define VTK_IMAGE_RFFT_BATCH_VALUES 8192
+
+//----------------------------------------------------------------------------
+vtkImageRFFT::vtkImageRFFT()
+{
+  this->HalfSpectrum = 0;
+  this->OutputScalarType = VTK_DOUBLE;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageRFFT::SetOutputScalarType(int type)
+{
+  vtkDebugMacro(<< this->GetClassName() << " (" << this <<
+    "): setting OutputScalarType to " << type);
+  if (type != VTK_FLOAT && type != VTK_DOUBLE)
+    {
+    vtkErrorMacro(<< "SetOutputScalarType: Output must be type float "
+                  << "or double, not " << type);
+    return;
+    }
+  if (this->OutputScalarType != type)
+    {
+    this->OutputScalarType = type;
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkImageRFFT::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "HalfSpectrum: " << (this->HalfSpectrum ? "On\n" : "Off\n");
+  os << indent << "OutputScalarType: " << this->OutputScalarType << "\n";
+}
+
+// The number of values of the rows of x whose half spectrum has size
+// values.
+static int vtkImageRFFTFullSize(int size)
+{
+  return (size > 1 ? 2*(size - 1) : 1);
+}
+
 //----------------------------------------------------------------------------
 // This extent of the components changes to real and imaginary values.
+// The results passed from one axis to the next are doubles; only the last
+// axis writes the output scalar type.  A half spectrum is restored to
+// whole rows along x.
 int vtkImageRFFT::IterativeRequestInformation(
   vtkInformation* vtkNotUsed(input), vtkInformation* output)
 {
-  vtkDataObject::SetPointDataActiveScalarInfo(output, VTK_DOUBLE, 2);
+  int type = VTK_DOUBLE;
+  if (this->Iteration == this->NumberOfIterations - 1)
+    {
+    type = this->OutputScalarType;
+    }
+  vtkDataObject::SetPointDataActiveScalarInfo(output, type, 2);
+
+  if (this->HalfSpectrum && this->Iteration == 0)
+    {
+    int wExt[6];
+    output->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wExt);
+    wExt[1] = wExt[0] + vtkImageRFFTFullSize(wExt[1] - wExt[0] + 1) - 1;
+    output->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wExt, 6);
+    }
   return 1;
 }
 
@@ -52,33 +112,51 @@ int vtkImageRFFT::IterativeRequestUpdateExtent(
   int *wExt = input->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT());
   int inExt[6];
   vtkImageRFFTInternalRequestUpdateExtent(inExt,outExt,wExt,this->Iteration);
+  // The conjugates of the half spectrum come from the mirrored rows.
+  if (this->HalfSpectrum && this->Iteration == 0)
+    {
+    memcpy(inExt, wExt, 6 * sizeof(int));
+    }
   input->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(),inExt,6);
 
   return 1;
 }
 
 //----------------------------------------------------------------------------
-// This templated execute method handles any type input, but the output
-// is always doubles.
-template <class T>
+// This templated execute method handles any type input, and double or
+// float output.  The rows are transformed in batches, interleaved so
+// that the butterfly stages of all the rows of a batch run together.
+// Real rows are transformed two at a time.  The rows of a half spectrum
+// are completed with the conjugates of the values of the mirrored rows,
+// those whose indices along the transformed axes are negated.
+template <class T, class OT>
 void vtkImageRFFTExecute(vtkImageRFFT *self,
                          vtkImageData *inData, int inExt[6], T *inPtr,
-                         vtkImageData *outData, int outExt[6], double *outPtr,
+                         vtkImageData *outData, int outExt[6], OT *outPtr,
                          int id)
 {
-  vtkImageComplex *inComplex;
-  vtkImageComplex *outComplex;
+  vtkImageComplex *rows;
+  vtkImageComplex *work;
+  vtkImageComplex *roots;
+  vtkImageComplex *result;
   vtkImageComplex *pComplex;
   //
   int inMin0, inMax0;
   vtkIdType inInc0, inInc1, inInc2;
-  T *inPtr0, *inPtr1, *inPtr2;
+  T **inRows;
+  T **mirrorRows;
+  int *wExt;
+  int half;
   //
   int outMin0, outMax0, outMin1, outMax1, outMin2, outMax2;
   vtkIdType outInc0, outInc1, outInc2;
-  double *outPtr0, *outPtr1, *outPtr2;
+  OT **outRows;
+  OT *outPtr0;
   //
-  int idx0, idx1, idx2, inSize0, numberOfComponents;
+  int idx0, idx1, idx2, inSize0, size0, numberOfComponents;
+  T *inPtr0;
+  double sign;
+  int real, batchSize, numRows, row, num, numComplex, stride, r;
   unsigned long count = 0;
   unsigned long target;
   double startProgress;
@@ -92,6 +170,9 @@ void vtkImageRFFTExecute(vtkImageRFFT *self,
   self->PermuteIncrements(outData->GetIncrements(), outInc0, outInc1, outInc2);
   
   inSize0 = inMax0 - inMin0 + 1;
+  half = (self->GetHalfSpectrum() && self->GetIteration() == 0);
+  size0 = (half ? vtkImageRFFTFullSize(inSize0) : inSize0);
+  wExt = inData->GetWholeExtent();
   
   // Input has to have real components at least.
   numberOfComponents = inData->GetNumberOfScalarComponents();
@@ -100,69 +181,153 @@ void vtkImageRFFTExecute(vtkImageRFFT *self,
     vtkGenericWarningMacro("No real components");
     return;
     }
+  // Without imaginary components, two rows make one complex row.
+  real = (numberOfComponents == 1);
 
   // Allocate the arrays of complex numbers
-  inComplex = new vtkImageComplex[inSize0];
-  outComplex = new vtkImageComplex[inSize0];
+  batchSize = VTK_IMAGE_RFFT_BATCH_VALUES / size0;
+  batchSize = (batchSize < 1 ? 1 : (batchSize > 16 ? 16 : batchSize));
+  rows = new vtkImageComplex[size0 * batchSize];
+  work = new vtkImageComplex[size0 * batchSize * 2];
+  roots = vtkImageFourierFilter::NewFftRoots(size0);
+  inRows = new T *[batchSize * 2];
+  mirrorRows = new T *[batchSize * 2];
+  outRows = new OT *[batchSize * 2];
+  if (real)
+    {
+    batchSize = batchSize * 2;
+    }
 
-  target = (unsigned long)((outMax2-outMin2+1)*(outMax1-outMin1+1)
+  numRows = (outMax2 - outMin2 + 1)*(outMax1 - outMin1 + 1);
+  target = (unsigned long)((numRows / batchSize + 1)
                            * self->GetNumberOfIterations() / 50.0);
   target++;
 
-  // loop over other axes
-  inPtr2 = inPtr;
-  outPtr2 = outPtr;
-  for (idx2 = outMin2; idx2 <= outMax2; ++idx2)
+  // loop over the batches of rows
+  for (row = 0; !self->AbortExecute && row < numRows; row += batchSize)
     {
-    inPtr1 = inPtr2;
-    outPtr1 = outPtr2;
-    for (idx1 = outMin1; !self->AbortExecute && idx1 <= outMax1; ++idx1)
+    if (!id) 
       {
-      if (!id) 
+      if (!(count%target))
         {
-        if (!(count%target))
+        self->UpdateProgress(count/(50.0*target) + startProgress);
+        }
+      count++;
+      }
+    num = (numRows - row < batchSize ? numRows - row : batchSize);
+    for (r = 0; r < num; ++r)
+      {
+      idx1 = (row + r) % (outMax1 - outMin1 + 1);
+      idx2 = (row + r) / (outMax1 - outMin1 + 1);
+      inRows[r] = inPtr + idx1*inInc1 + idx2*inInc2;
+      outRows[r] = outPtr + idx1*outInc1 + idx2*outInc2;
+      if (half)
+        { // the input has the whole extent
+        idx1 += outMin1 - wExt[2];
+        idx2 += outMin2 - wExt[4];
+        if (self->GetDimensionality() > 1)
+          {
+          idx1 = (wExt[3] - wExt[2] + 1 - idx1) % (wExt[3] - wExt[2] + 1);
+          }
+        if (self->GetDimensionality() > 2)
           {
-          self->UpdateProgress(count/(50.0*target) + startProgress);
+          idx2 = (wExt[5] - wExt[4] + 1 - idx2) % (wExt[5] - wExt[4] + 1);
           }
-        count++;
+        mirrorRows[r] = static_cast<T *>(
+          inData->GetScalarPointer(inMin0, wExt[2] + idx1, wExt[4] + idx2));
         }
-      // copy into complex numbers
-      inPtr0 = inPtr1;
-      pComplex = inComplex;
-      for (idx0 = inMin0; idx0 <= inMax0; ++idx0)
+      }
+
+    // copy into complex numbers
+    numComplex = (real ? (num + 1) / 2 : num);
+    pComplex = rows;
+    for (idx0 = 0; idx0 < size0; ++idx0)
+      {
+      for (r = 0; r < numComplex; ++r)
         {
-        pComplex->Real = (double)(*inPtr0);
-        pComplex->Imag = 0.0;
-        if (numberOfComponents > 1)
+        T **rowPtrs = inRows;
+        vtkIdType offset = idx0*inInc0;
+        sign = 1.0;
+        if (idx0 >= inSize0)
+          { // the conjugate of the mirrored value
+          rowPtrs = mirrorRows;
+          offset = (size0 - idx0)*inInc0;
+          sign = -1.0;
+          }
+        if (real)
+          { // the next row is the imaginary part
+          pComplex->Real = (double)(rowPtrs[2*r][offset]);
+          pComplex->Imag = 0.0;
+          if (2*r + 1 < num)
+            {
+            pComplex->Imag = (double)(rowPtrs[2*r + 1][offset]);
+            }
+          }
+        else
           { // yes we have an imaginary input
-          pComplex->Imag = (double)(inPtr0[1]);;
+          inPtr0 = rowPtrs[r] + offset;
+          pComplex->Real = (double)(*inPtr0);
+          pComplex->Imag = sign * (double)(inPtr0[1]);
           }
-        inPtr0 += inInc0;
         ++pComplex;
         }
+      }
       
-      // Call the method that performs the RFFT
-      self->ExecuteRfft(inComplex, outComplex, inSize0);
+    // Call the method that performs the rfft
+    self->ExecuteFftRows(rows, work, roots, size0, numComplex, -1);
+    result = rows;
+    stride = numComplex;
+    if (real)
+      {
+      self->SplitRealFftRows(rows, work, size0, numComplex);
+      result = work;
+      stride = 2 * numComplex;
+      }
 
-      // copy into output
-      outPtr0 = outPtr1;
-      pComplex = outComplex + (outMin0 - inMin0);
-      for (idx0 = outMin0; idx0 <= outMax0; ++idx0)
+    // copy into output
+    for (idx0 = outMin0; idx0 <= outMax0; ++idx0)
+      {
+      pComplex = result + (idx0 - inMin0)*stride;
+      for (r = 0; r < num; ++r)
         {
-        *outPtr0 = (double)pComplex->Real;
-        outPtr0[1] = (double)pComplex->Imag;
-        outPtr0 += outInc0;
+        outPtr0 = outRows[r] + (idx0 - outMin0)*outInc0;
+        *outPtr0 = (OT)pComplex->Real;
+        outPtr0[1] = (OT)pComplex->Imag;
         ++pComplex;
         }
-      inPtr1 += inInc1;
-      outPtr1 += outInc1;
       }
-    inPtr2 += inInc2;
-    outPtr2 += outInc2;
     }
     
-  delete [] inComplex;
-  delete [] outComplex;
+  delete [] rows;
+  delete [] work;
+  delete [] roots;
+  delete [] inRows;
+  delete [] mirrorRows;
+  delete [] outRows;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkImageRFFTExecute1(vtkImageRFFT *self,
+                          vtkImageData *inData, int inExt[6], T *inPtr,
+                          vtkImageData *outData, int outExt[6], void *outPtr,
+                          int id)
+{
+  switch (outData->GetScalarType())
+    {
+    case VTK_DOUBLE:
+      vtkImageRFFTExecute(self, inData, inExt, inPtr, outData, outExt,
+                          static_cast<double *>(outPtr), id);
+      break;
+    case VTK_FLOAT:
+      vtkImageRFFTExecute(self, inData, inExt, inPtr, outData, outExt,
+                          static_cast<float *>(outPtr), id);
+      break;
+    default:
+      vtkErrorWithObjectMacro(
+        self, "Execute: Output must be be type double or float.");
+      return;
+    }
 }
 
 
@@ -183,13 +348,6 @@ void vtkImageRFFT::ThreadedExecute(vtkImageData *inData, vtkImageData *outData,
   inPtr = inData->GetScalarPointerForExtent(inExt);
   outPtr = outData->GetScalarPointerForExtent(outExt);
   
-  // this filter expects that the output be doubles.
-  if (outData->GetScalarType() != VTK_DOUBLE)
-    {
-    vtkErrorMacro(<< "Execute: Output must be be type double.");
-    return;
-    }
-
   // this filter expects input to have 1 or two components
   if (outData->GetNumberOfScalarComponents() != 1 && 
       outData->GetNumberOfScalarComponents() != 2)
@@ -202,9 +360,9 @@ void vtkImageRFFT::ThreadedExecute(vtkImageData *inData, vtkImageData *outData,
   switch (inData->GetScalarType())
     {
     vtkTemplateMacro(
-      vtkImageRFFTExecute(this, inData, inExt, 
-                          (VTK_TT *)(inPtr), outData, outExt, 
-                          (double *)(outPtr), threadId));
+      vtkImageRFFTExecute1(this, inData, inExt, 
+                           (VTK_TT *)(inPtr), outData, outExt, 
+                           outPtr, threadId));
     default:
       vtkErrorMacro(<< "Execute: Unknown ScalarType");
       return;
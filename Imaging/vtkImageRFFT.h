@@ -16,8 +16,8 @@
 // .SECTION Description
 // vtkImageRFFT implements the reverse fast Fourier transform.  The input
 // can have real or complex data in any components and data types, but
-// the output is always complex doubles with real values in component0, and
-// imaginary values in component1.  The filter is fastest for images that
+// the output is complex doubles by default, with real values in component0,
+// and imaginary values in component1.  The filter is fastest for images that
 // have power of two sizes.  The filter uses a butterfly fitlers for each
 // prime factor of the dimension.  This makes images with prime number dimensions 
 // (i.e. 17x17) much slower to compute.  Multi dimensional (i.e volumes) 
@@ -42,6 +42,28 @@ class VTK_IMAGING_EXPORT vtkImageRFFT : public vtkImageFourierFilter
 public:
   static vtkImageRFFT *New();
   vtkTypeRevisionMacro(vtkImageRFFT,vtkImageFourierFilter);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // When HalfSpectrum is on, the input is the half spectrum of a real image
+  // made by vtkImageFFT with HalfSpectrum on: it holds M frequencies along
+  // the x axis, and the others are found from the conjugate symmetry of
+  // the spectrum.  The output then has 2*(M - 1) values along x, so an
+  // image of odd width comes back one value narrower.  Off by default.
+  vtkSetMacro(HalfSpectrum, int);
+  vtkGetMacro(HalfSpectrum, int);
+  vtkBooleanMacro(HalfSpectrum, int);
+
+  // Description:
+  // Set the scalar type of the output: VTK_DOUBLE (the default) or
+  // VTK_FLOAT, which halves its size.  The transform is computed in double
+  // precision either way.  Other types are rejected.
+  void SetOutputScalarType(int type);
+  vtkGetMacro(OutputScalarType, int);
+  void SetOutputScalarTypeToFloat()
+    { this->SetOutputScalarType(VTK_FLOAT); }
+  void SetOutputScalarTypeToDouble()
+    { this->SetOutputScalarType(VTK_DOUBLE); }
 
   
   // Description:
@@ -55,7 +77,7 @@ public:
                   int num, int total);
 
 protected:
-  vtkImageRFFT() {};
+  vtkImageRFFT();
   ~vtkImageRFFT() {};
 
   virtual int IterativeRequestInformation(vtkInformation* in,
@@ -65,6 +87,9 @@ protected:
 
   void ThreadedExecute(vtkImageData *inData, vtkImageData *outData,
                        int outExt[6], int threadId);
+
+  int HalfSpectrum;
+  int OutputScalarType;
 private:
   vtkImageRFFT(const vtkImageRFFT&);  // Not implemented.
   void operator=(const vtkImageRFFT&);  // Not implemented.
@@ -23,12 +23,42 @@
 #include "vtkCellData.h"
 #include "vtkPolyData.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTaskScheduler.h"
+
+#include <vtkstd/vector>
 
 vtkCxxRevisionMacro(vtkPProbeFilter, "1.10");
 vtkStandardNewMacro(vtkPProbeFilter);
 
 vtkCxxSetObjectMacro(vtkPProbeFilter, Controller, vtkMultiProcessController);
 
+// The largest number of points merged by a task.
+#define VTK_PPROBE_FILTER_TASK_SIZE 4096
+
+//----------------------------------------------------------------------------
+// What the tasks merging the points probed by another process need.
+struct vtkPProbeFilterMergeData
+{
+  vtkDataArray *From;
+  vtkDataArray *To;
+  vtkIdType *ValidPoints;
+};
+
+//----------------------------------------------------------------------------
+// Copy the tuples of the valid points [begin, end) of the remote array.
+static void vtkPProbeFilterMergePoints(void *arg, vtkIdType begin,
+                                       vtkIdType end)
+{
+  vtkPProbeFilterMergeData *md = static_cast<vtkPProbeFilterMergeData *>(arg);
+  vtkstd::vector<double> tuple(md->From->GetNumberOfComponents());
+  for (vtkIdType i = begin; i < end; ++i)
+    {
+    vtkIdType pointId = md->ValidPoints[i];
+    md->From->GetTuple(pointId, &tuple[0]);
+    md->To->SetTuple(pointId, &tuple[0]);
+    }
+}
+
 //----------------------------------------------------------------------------
 vtkPProbeFilter::vtkPProbeFilter()
 {
@@ -90,12 +120,10 @@ int vtkPProbeFilter::RequestData(vtkInformation *request,
     vtkDataSet *remoteProbeOutput = output->NewInstance();
     vtkPointData *remotePointData;
     vtkPointData *pointData = output->GetPointData();
-    vtkIdType i;
-    vtkIdType j;
-    vtkIdType k;
-    vtkIdType pointId;
-    vtkIdType numComponents = pointData->GetNumberOfComponents();
-    double *tuple = new double[numComponents];
+    vtkTaskScheduler *scheduler = vtkTaskScheduler::GetGlobalScheduler();
+    vtkPProbeFilterMergeData md;
+    int i;
+    int j;
     for (i = 1; i < numProcs; i++)
       {
       this->Controller->Receive(&numRemotePoints, 1, i, 1970);
@@ -104,23 +132,34 @@ int vtkPProbeFilter::RequestData(vtkInformation *request,
         this->Controller->Receive(validPoints, i, 1971);
         this->Controller->Receive(remoteProbeOutput, i, 1972);
       
+        // Copy the points found by the remote process array by array,
+        // on the threads of the scheduler.  The bits of bit arrays are
+        // packed, so they are copied on this thread.
         remotePointData = remoteProbeOutput->GetPointData();
-        for (j = 0; j < numRemotePoints; j++)
+        md.ValidPoints = validPoints->GetPointer(0);
+        for (j = 0; j < pointData->GetNumberOfArrays(); j++)
           {
-          pointId = validPoints->GetValue(j);
-        
-          remotePointData->GetTuple(pointId, tuple);
-        
-          for (k = 0; k < numComponents; k++)
+          md.From = remotePointData->GetArray(j);
+          md.To = pointData->GetArray(j);
+          if (!md.From)
+            {
+            continue;
+            }
+          if (md.To->GetDataType() == VTK_BIT)
+            {
+            vtkPProbeFilterMergePoints(&md, 0, numRemotePoints);
+            }
+          else
             {
-            output->GetPointData()->SetComponent(pointId, k, tuple[k]);
+            scheduler->ParallelFor(0, numRemotePoints,
+                                   VTK_PPROBE_FILTER_TASK_SIZE,
+                                   vtkPProbeFilterMergePoints, &md);
             }
           }
         }
       }
     validPoints->Delete();
     remoteProbeOutput->Delete();
-    delete [] tuple;
     }
 
   return 1;
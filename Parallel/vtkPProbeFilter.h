@@ -14,6 +14,10 @@
 =========================================================================*/
 // .NAME vtkPProbeFilter - probe dataset in parallel
 // .SECTION Description
+// vtkPProbeFilter probes a piece of the source on each process, with the
+// threads of vtkProbeFilter, and merges the points found by the other
+// processes into the output of process 0 on the threads of the
+// vtkTaskScheduler.
 
 #ifndef __vtkPProbeFilter_h
 #define __vtkPProbeFilter_h
@@ -0,0 +1,220 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPolyDataMapperVertexBuffers.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the vertex buffer objects of the OpenGL poly data mapper.
+// .SECTION Description
+// Renders a colored sphere with vertex buffer objects and with a display
+// list and compares the images.  Then changes the points, the normals and
+// the scalars one at a time and checks that only the changed array is
+// uploaded again, and that the images still match.  The test passes
+// without drawing anything when the OpenGL implementation, such as an old
+// software Mesa, has no GL_ARB_vertex_buffer_object.
+
+#include "vtkActor.h"
+#include "vtkDataArray.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkImageDifference.h"
+#include "vtkOpenGLPolyDataMapper.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkRenderWindow.h"
+#include "vtkRenderer.h"
+#include "vtkSphereSource.h"
+#include "vtkToolkits.h"
+#include "vtkWindowToImageFilter.h"
+
+#ifdef VTK_USE_MANGLED_MESA
+#include "vtkMesaPolyDataMapper.h"
+#endif
+
+// The contents counted by GetNumberOfBufferUploads().
+enum { Points, Normals, Colors, TCoords, Cells, NumberOfContents };
+static const char *ContentNames[NumberOfContents] =
+  { "points", "normals", "colors", "texture coordinates", "cells" };
+
+static int GetUploads(vtkPolyDataMapper *mapper, int contents)
+{
+  vtkOpenGLPolyDataMapper *glMapper =
+    vtkOpenGLPolyDataMapper::SafeDownCast(mapper);
+  if (glMapper)
+    {
+    return glMapper->GetNumberOfBufferUploads(contents);
+    }
+#ifdef VTK_USE_MANGLED_MESA
+  vtkMesaPolyDataMapper *mesaMapper =
+    vtkMesaPolyDataMapper::SafeDownCast(mapper);
+  if (mesaMapper)
+    {
+    return mesaMapper->GetNumberOfBufferUploads(contents);
+    }
+#endif
+  return 0;
+}
+
+static void SetUseVertexBufferObjects(vtkPolyDataMapper *mapper, int use)
+{
+  vtkOpenGLPolyDataMapper *glMapper =
+    vtkOpenGLPolyDataMapper::SafeDownCast(mapper);
+  if (glMapper)
+    {
+    glMapper->SetUseVertexBufferObjects(use);
+    }
+#ifdef VTK_USE_MANGLED_MESA
+  vtkMesaPolyDataMapper *mesaMapper =
+    vtkMesaPolyDataMapper::SafeDownCast(mapper);
+  if (mesaMapper)
+    {
+    mesaMapper->SetUseVertexBufferObjects(use);
+    }
+#endif
+}
+
+// Render with a display list and then with the vertex buffer objects,
+// which are left on, and compare the images.
+static int CompareRenders(vtkRenderWindow *renWin, vtkPolyDataMapper *mapper,
+                          const char *name)
+{
+  vtkWindowToImageFilter *grab = vtkWindowToImageFilter::New();
+  grab->SetInput(renWin);
+  vtkImageData *images[2];
+  for (int i = 0; i < 2; ++i)
+    {
+    SetUseVertexBufferObjects(mapper, i);
+    renWin->Render();
+    grab->Modified();
+    grab->Update();
+    images[i] = vtkImageData::New();
+    images[i]->DeepCopy(grab->GetOutput());
+    }
+  grab->Delete();
+
+  vtkImageDifference *difference = vtkImageDifference::New();
+  difference->SetInput(images[0]);
+  difference->SetImage(images[1]);
+  difference->Update();
+  double error = difference->GetThresholdedError();
+  difference->Delete();
+  images[0]->Delete();
+  images[1]->Delete();
+  if (error > 10.0)
+    {
+    cerr << name << ": the vertex buffer image differs from the display "
+         << "list image by " << error << "\n";
+    return 1;
+    }
+  return 0;
+}
+
+// Render and check that only the given contents were uploaded.
+static int CheckUploads(vtkRenderWindow *renWin, vtkPolyDataMapper *mapper,
+                        int uploaded, const char *name)
+{
+  int before[NumberOfContents];
+  int i;
+  for (i = 0; i < NumberOfContents; ++i)
+    {
+    before[i] = GetUploads(mapper, i);
+    }
+  renWin->Render();
+  int retVal = 0;
+  for (i = 0; i < NumberOfContents; ++i)
+    {
+    int expected = before[i] + (i == uploaded ? 1 : 0);
+    if (GetUploads(mapper, i) != expected)
+      {
+      cerr << name << ": the " << ContentNames[i] << " were uploaded "
+           << GetUploads(mapper, i) - before[i] << " times\n";
+      retVal = 1;
+      }
+    }
+  return retVal;
+}
+
+int TestPolyDataMapperVertexBuffers(int, char *[])
+{
+  vtkSphereSource *sphere = vtkSphereSource::New();
+  sphere->SetThetaResolution(32);
+  sphere->SetPhiResolution(16);
+  sphere->Update();
+  vtkPolyData *polyData = vtkPolyData::New();
+  polyData->DeepCopy(sphere->GetOutput());
+  sphere->Delete();
+  vtkIdType numPts = polyData->GetNumberOfPoints();
+  vtkFloatArray *scalars = vtkFloatArray::New();
+  for (vtkIdType i = 0; i < numPts; ++i)
+    {
+    scalars->InsertNextValue(static_cast<float>(i % 17));
+    }
+  polyData->GetPointData()->SetScalars(scalars);
+  scalars->Delete();
+
+  vtkPolyDataMapper *mapper = vtkPolyDataMapper::New();
+  mapper->SetInput(polyData);
+  mapper->SetScalarRange(0, 16);
+  vtkActor *actor = vtkActor::New();
+  actor->SetMapper(mapper);
+  vtkRenderer *renderer = vtkRenderer::New();
+  renderer->AddActor(actor);
+  vtkRenderWindow *renWin = vtkRenderWindow::New();
+  renWin->SetSize(300, 300);
+  renWin->AddRenderer(renderer);
+
+  int retVal = 0;
+  SetUseVertexBufferObjects(mapper, 1);
+  renWin->Render();
+  if (GetUploads(mapper, Points) == 0)
+    {
+    cout << "The vertex buffer objects are not supported, skipping.\n";
+    }
+  else
+    {
+    retVal |= CompareRenders(renWin, mapper, "Sphere");
+
+    // Nothing changed.
+    retVal |= CheckUploads(renWin, mapper, -1, "Unchanged sphere");
+
+    // Move a point.
+    double x[3];
+    polyData->GetPoint(0, x);
+    x[2] *= 1.2;
+    polyData->GetPoints()->SetPoint(0, x);
+    polyData->GetPoints()->Modified();
+    retVal |= CheckUploads(renWin, mapper, Points, "Moved point");
+
+    // Turn a normal.
+    vtkDataArray *normals = polyData->GetPointData()->GetNormals();
+    normals->SetTuple3(numPts/2, 1.0, 0.0, 0.0);
+    normals->Modified();
+    retVal |= CheckUploads(renWin, mapper, Normals, "Turned normal");
+
+    // Change the scalars.
+    for (vtkIdType i = 0; i < numPts; i += 3)
+      {
+      scalars->SetValue(i, 16.0f - scalars->GetValue(i));
+      }
+    scalars->Modified();
+    retVal |= CheckUploads(renWin, mapper, Colors, "Changed scalars");
+
+    retVal |= CompareRenders(renWin, mapper, "Changed sphere");
+    }
+
+  actor->Delete();
+  mapper->Delete();
+  polyData->Delete();
+  renderer->Delete();
+  renWin->Delete();
+  return retVal;
+}
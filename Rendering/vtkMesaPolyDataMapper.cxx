@@ -15,6 +15,9 @@
 // Make sure this is first, so any includes of gl.h can be stoped if needed
 #define VTK_IMPLEMENT_MESA_CXX
 
+// The buffer object entry points are called directly.
+#define GL_GLEXT_PROTOTYPES
+
 #include "MangleMesaInclude/gl_mangle.h"
 #include "MangleMesaInclude/gl.h"
 
@@ -41,7 +44,9 @@
 #define vtkOpenGLPolyDataMapperDrawPolygons vtkMesaPolyDataMapperDrawPolygons
 #define vtkOpenGLPolyDataMapperDrawTStrips vtkMesaPolyDataMapperDrawTStrips
 #define vtkOpenGLPolyDataMapperDrawTStripLines vtkMesaPolyDataMapperDrawTStripLines
+#define vtkOpenGLPolyDataMapperBuffers vtkMesaPolyDataMapperBuffers
 #include "vtkOpenGLPolyDataMapper.cxx"
+#undef vtkOpenGLPolyDataMapperBuffers
 #undef vtkOpenGLPolyDataMapperDrawTStripLines
 #undef vtkOpenGLPolyDataMapperDrawTStrips
 #undef vtkOpenGLPolyDataMapperDrawPolygons
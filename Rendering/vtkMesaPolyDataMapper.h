@@ -31,6 +31,9 @@ class vtkRenderWindow;
 class vtkMesaRenderer;
 class vtkTimerLog;
 class vtkOpenGLTexture;
+//BTX
+class vtkMesaPolyDataMapperBuffers;
+//ETX
 
 class VTK_RENDERING_EXPORT vtkMesaPolyDataMapper : public vtkPolyDataMapper
 {
@@ -52,6 +55,22 @@ public:
   // Description:
   // Draw method for Mesa.
   virtual int Draw(vtkRenderer *ren, vtkActor *a);
+
+  // Description:
+  // Get/Set whether the mapper draws from vertex buffer objects instead
+  // of a display list or immediate mode, when the Mesa library supports
+  // GL_ARB_vertex_buffer_object.  See vtkOpenGLPolyDataMapper.  The
+  // default is off.
+  vtkSetMacro(UseVertexBufferObjects, int);
+  vtkGetMacro(UseVertexBufferObjects, int);
+  vtkBooleanMacro(UseVertexBufferObjects, int);
+
+  // Description:
+  // Get how many times the vertex buffer objects were filled with the
+  // points (0), normals (1), colors (2), texture coordinates (3) or cells
+  // (4) of the input.  This lets tests check that only the arrays that
+  // changed are uploaded again.
+  int GetNumberOfBufferUploads(int contents);
   
 protected:
   vtkMesaPolyDataMapper();
@@ -99,9 +118,22 @@ protected:
                    vtkCellArray *ca,
                    vtkRenderer *ren);
 
+  // Description:
+  // Draw the input from the vertex buffer objects, updating them first.
+  // CanUseVertexBufferObjects returns whether the input and the render
+  // window allow it.
+  int CanUseVertexBufferObjects(vtkRenderer *ren, vtkActor *a);
+  int DrawVertexBufferObjects(vtkRenderer *ren, vtkActor *a);
+  void ReleaseVertexBufferObjects();
+
   vtkIdType TotalCells;
   int ListId;
   vtkOpenGLTexture* InternalColorTexture;
+
+  int UseVertexBufferObjects;
+//BTX
+  vtkMesaPolyDataMapperBuffers *Buffers;
+//ETX
   vtkRenderWindow *RenderWindow;   // RenderWindow used for the previous render
 private:
   vtkMesaPolyDataMapper(const vtkMesaPolyDataMapper&);  // Not implemented.
@@ -36,9 +36,13 @@
 
 #ifndef VTK_IMPLEMENT_MESA_CXX
 # include "vtkOpenGL.h"
+# include "vtkOpenGLExtensionManager.h"
+# include "vtkgl.h"
 #endif
 
 #include <math.h>
+#include <string.h>
+#include <vtkstd/vector>
 
 
 #ifndef VTK_IMPLEMENT_MESA_CXX
@@ -61,13 +65,117 @@ vtkStandardNewMacro(vtkOpenGLPolyDataMapper);
 #define VTK_PDM_TCOORD_1D          0x800
 #define VTK_PDM_OPAQUE_COLORS      0x1000
 #define VTK_PDM_USE_FIELD_DATA     0x2000
-      
+
+// The buffer object entry points.  The OpenGL mapper loads them with
+// vtkOpenGLExtensionManager, while the mangled Mesa library exports them
+// when its gl.h declares them.
+#ifdef VTK_IMPLEMENT_MESA_CXX
+# if defined(GL_ARB_vertex_buffer_object) && defined(GL_GLEXT_PROTOTYPES)
+#  define VTK_PDM_USE_BUFFERS
+#  define vtkPDMGenBuffers glGenBuffersARB
+#  define vtkPDMDeleteBuffers glDeleteBuffersARB
+#  define vtkPDMBindBuffer glBindBufferARB
+#  define vtkPDMBufferData glBufferDataARB
+#  define vtkPDMBufferSubData glBufferSubDataARB
+#  define VTK_PDM_ARRAY_BUFFER GL_ARRAY_BUFFER_ARB
+#  define VTK_PDM_ELEMENT_ARRAY_BUFFER GL_ELEMENT_ARRAY_BUFFER_ARB
+#  define VTK_PDM_STATIC_DRAW GL_STATIC_DRAW_ARB
+typedef GLsizeiptrARB vtkPDMSizeType;
+typedef GLintptrARB vtkPDMOffsetType;
+# endif
+#else
+# define VTK_PDM_USE_BUFFERS
+# define vtkPDMGenBuffers vtkgl::GenBuffersARB
+# define vtkPDMDeleteBuffers vtkgl::DeleteBuffersARB
+# define vtkPDMBindBuffer vtkgl::BindBufferARB
+# define vtkPDMBufferData vtkgl::BufferDataARB
+# define vtkPDMBufferSubData vtkgl::BufferSubDataARB
+# define VTK_PDM_ARRAY_BUFFER vtkgl::ARRAY_BUFFER_ARB
+# define VTK_PDM_ELEMENT_ARRAY_BUFFER vtkgl::ELEMENT_ARRAY_BUFFER_ARB
+# define VTK_PDM_STATIC_DRAW vtkgl::STATIC_DRAW_ARB
+typedef vtkgl::GLsizeiptrARB vtkPDMSizeType;
+typedef vtkgl::GLintptrARB vtkPDMOffsetType;
+#endif
+
+// The state of the vertex buffer objects.  The vertex buffer holds each
+// attribute of all the points in its own block, so that the attributes
+// can be uploaded separately.  The index buffer holds the point ids of
+// each kind of cell in its own range.
+class vtkOpenGLPolyDataMapperBuffers
+{
+public:
+  enum { Points, Normals, Colors, TCoords, NumberOfAttributes };
+  enum { Verts, Lines, Polys, Strips, NumberOfCellTypes };
+
+  vtkOpenGLPolyDataMapperBuffers()
+    {
+    this->Window = 0;
+    this->Supported = 0;
+    this->VertexBuffer = 0;
+    this->IndexBuffer = 0;
+    for (int i = 0; i <= NumberOfAttributes; ++i)
+      {
+      this->Uploads[i] = 0;
+      }
+    this->Reset();
+    }
+
+  // Forget what the buffers hold, so that everything is uploaded again.
+  void Reset()
+    {
+    this->NumberOfPoints = 0;
+    for (int i = 0; i < NumberOfAttributes; ++i)
+      {
+      this->Components[i] = 0;
+      this->Offsets[i] = 0;
+      this->Arrays[i] = 0;
+      this->ArrayTimes[i] = 0;
+      }
+    for (int j = 0; j < NumberOfCellTypes; ++j)
+      {
+      this->Cells[j] = 0;
+      this->CellTimes[j] = 0;
+      this->Modes[j] = GL_POINTS;
+      this->First[j] = 0;
+      this->Count[j] = 0;
+      }
+    }
+
+  // The window for which Supported was checked.
+  vtkWindow *Window;
+  int Supported;
+
+  GLuint VertexBuffer;
+  GLuint IndexBuffer;
+
+  // The layout and contents of the vertex buffer.  Components is 0 for
+  // an attribute that is not drawn.  Arrays holds the arrays the
+  // attributes were made from, which for mapped colors are the scalars.
+  vtkIdType NumberOfPoints;
+  int Components[NumberOfAttributes];
+  vtkIdType Offsets[NumberOfAttributes];
+  vtkDataArray *Arrays[NumberOfAttributes];
+  unsigned long ArrayTimes[NumberOfAttributes];
+
+  // The contents of the index buffer.
+  vtkCellArray *Cells[NumberOfCellTypes];
+  unsigned long CellTimes[NumberOfCellTypes];
+  GLenum Modes[NumberOfCellTypes];
+  vtkIdType First[NumberOfCellTypes];
+  vtkIdType Count[NumberOfCellTypes];
+
+  // How many times each attribute, and then the cells, were uploaded.
+  int Uploads[NumberOfAttributes + 1];
+};
+
 // Construct empty object.
 vtkOpenGLPolyDataMapper::vtkOpenGLPolyDataMapper()
 {
   this->ListId = 0;
   this->TotalCells = 0;
   this->InternalColorTexture = 0;
+  this->UseVertexBufferObjects = 0;
+  this->Buffers = new vtkOpenGLPolyDataMapperBuffers;
 }
 
 // Destructor (don't call ReleaseGraphicsResources() since it is virtual
@@ -82,6 +190,7 @@ vtkOpenGLPolyDataMapper::~vtkOpenGLPolyDataMapper()
     this->InternalColorTexture->Delete();
     this->InternalColorTexture = 0;
     }
+  delete this->Buffers;
 }
 
 // Release the graphics resources used by this mapper.  In this case, release
@@ -94,6 +203,12 @@ void vtkOpenGLPolyDataMapper::ReleaseGraphicsResources(vtkWindow *win)
     glDeleteLists(this->ListId,1);
     this->ListId = 0;
     }
+  if (win && (this->Buffers->VertexBuffer || this->Buffers->IndexBuffer))
+    {
+    win->MakeCurrent();
+    this->ReleaseVertexBufferObjects();
+    }
+  this->Buffers->Window = 0;
   this->LastWindow = NULL; 
   // We may not want to do this here.
   if (this->InternalColorTexture)
@@ -247,56 +362,101 @@ void vtkOpenGLPolyDataMapper::RenderPiece(vtkRenderer *ren, vtkActor *act)
     glMaterialfv( GL_FRONT_AND_BACK, GL_DIFFUSE, info );
     }
 
-  //
-  // if something has changed regenerate colors and display lists
-  // if required
-  //
-  int noAbort=1;
-  if ( this->GetMTime() > this->BuildTime || 
-       input->GetMTime() > this->BuildTime ||
-       act->GetProperty()->GetMTime() > this->BuildTime ||
-       ren->GetRenderWindow() != this->LastWindow)
-    {
-    if (!this->ImmediateModeRendering && 
-        !this->GetGlobalImmediateModeRendering())
+  // Vertex buffer objects replace the display list and immediate mode
+  // rendering.  They are updated as needed by DrawVertexBufferObjects.
+  if (this->UseVertexBufferObjects &&
+      this->CanUseVertexBufferObjects(ren, act))
+    {
+    if (ren->GetRenderWindow() != this->LastWindow)
       {
-      this->ReleaseGraphicsResources(ren->GetRenderWindow());
+      this->ReleaseGraphicsResources(this->LastWindow);
       this->LastWindow = ren->GetRenderWindow();
-      
-      // If we are coloring by texture, then load the texture map.
-      // Use Map as indicator, because texture hangs around.
-      if (this->ColorTextureMap)
-        {
-        this->InternalColorTexture->Load(ren);
-        }
-      
-      // get a unique display list id
-      this->ListId = glGenLists(1);
-      glNewList(this->ListId,GL_COMPILE);
-
-      noAbort = this->Draw(ren,act);
-      glEndList();
-
-      // Time the actual drawing
-      this->Timer->StartTimer();
-      glCallList(this->ListId);
-      this->Timer->StopTimer();      
+      this->LastWindow->MakeCurrent();
       }
-    else
+    else if (this->ListId)
       {
-      this->ReleaseGraphicsResources(ren->GetRenderWindow());
-      this->LastWindow = ren->GetRenderWindow();
+      glDeleteLists(this->ListId,1);
+      this->ListId = 0;
       }
-    if (noAbort)
+    if (this->ColorTextureMap)
       {
-      this->BuildTime.Modified();
+      this->InternalColorTexture->Load(ren);
       }
+    this->Timer->StartTimer();
+    this->DrawVertexBufferObjects(ren,act);
+    this->Timer->StopTimer();
     }
-  // if nothing changed but we are using display lists, draw it
   else
     {
-    if (!this->ImmediateModeRendering && 
-        !this->GetGlobalImmediateModeRendering())
+    //
+    // if something has changed regenerate colors and display lists
+    // if required
+    //
+    int noAbort=1;
+    if ( this->GetMTime() > this->BuildTime || 
+         input->GetMTime() > this->BuildTime ||
+         act->GetProperty()->GetMTime() > this->BuildTime ||
+         ren->GetRenderWindow() != this->LastWindow)
+      {
+      if (!this->ImmediateModeRendering && 
+          !this->GetGlobalImmediateModeRendering())
+        {
+        this->ReleaseGraphicsResources(ren->GetRenderWindow());
+        this->LastWindow = ren->GetRenderWindow();
+      
+        // If we are coloring by texture, then load the texture map.
+        // Use Map as indicator, because texture hangs around.
+        if (this->ColorTextureMap)
+          {
+          this->InternalColorTexture->Load(ren);
+          }
+      
+        // get a unique display list id
+        this->ListId = glGenLists(1);
+        glNewList(this->ListId,GL_COMPILE);
+
+        noAbort = this->Draw(ren,act);
+        glEndList();
+
+        // Time the actual drawing
+        this->Timer->StartTimer();
+        glCallList(this->ListId);
+        this->Timer->StopTimer();      
+        }
+      else
+        {
+        this->ReleaseGraphicsResources(ren->GetRenderWindow());
+        this->LastWindow = ren->GetRenderWindow();
+        }
+      if (noAbort)
+        {
+        this->BuildTime.Modified();
+        }
+      }
+    // if nothing changed but we are using display lists, draw it
+    else
+      {
+      if (!this->ImmediateModeRendering && 
+          !this->GetGlobalImmediateModeRendering())
+        {
+        // If we are coloring by texture, then load the texture map.
+        // Use Map as indicator, because texture hangs around.
+        if (this->ColorTextureMap)
+          {
+          this->InternalColorTexture->Load(ren);
+          }
+
+        // Time the actual drawing
+        this->Timer->StartTimer();
+        glCallList(this->ListId);
+        this->Timer->StopTimer();      
+        }
+      }
+   
+    // if we are in immediate mode rendering we always
+    // want to draw the primitives here
+    if (this->ImmediateModeRendering ||
+        this->GetGlobalImmediateModeRendering())
       {
       // If we are coloring by texture, then load the texture map.
       // Use Map as indicator, because texture hangs around.
@@ -304,30 +464,12 @@ void vtkOpenGLPolyDataMapper::RenderPiece(vtkRenderer *ren, vtkActor *act)
         {
         this->InternalColorTexture->Load(ren);
         }
-
       // Time the actual drawing
       this->Timer->StartTimer();
-      glCallList(this->ListId);
+      this->Draw(ren,act);
       this->Timer->StopTimer();      
       }
     }
-   
-  // if we are in immediate mode rendering we always
-  // want to draw the primitives here
-  if (this->ImmediateModeRendering ||
-      this->GetGlobalImmediateModeRendering())
-    {
-    // If we are coloring by texture, then load the texture map.
-    // Use Map as indicator, because texture hangs around.
-    if (this->ColorTextureMap)
-      {
-      this->InternalColorTexture->Load(ren);
-      }
-    // Time the actual drawing
-    this->Timer->StartTimer();
-    this->Draw(ren,act);
-    this->Timer->StopTimer();      
-    }
 
   this->TimeToDraw = (float)this->Timer->GetElapsedTime();
 
@@ -1604,6 +1746,45 @@ void vtkOpenGLPolyDataMapperDrawTStripLines(int idx,
 }
 
 // Draw method for OpenGL.
+// If we are doing vertex colors then set lmcolor to adjust 
+// the current materials ambient and diffuse values using   
+// vertex color commands otherwise tell it not to.          
+static void vtkOpenGLPolyDataMapperSetColorMaterial(vtkProperty *prop,
+                                                    int scalarMaterialMode,
+                                                    vtkUnsignedCharArray *c)
+{
+  glDisable( GL_COLOR_MATERIAL );
+  if (c)
+    {
+    GLenum lmcolorMode;
+    if (scalarMaterialMode == VTK_MATERIALMODE_DEFAULT)
+      {
+      if (prop->GetAmbient() > prop->GetDiffuse())
+        {
+        lmcolorMode = GL_AMBIENT;
+        }
+      else
+        {
+        lmcolorMode = GL_DIFFUSE;
+        }
+      }
+    else if (scalarMaterialMode == VTK_MATERIALMODE_AMBIENT_AND_DIFFUSE)
+      {
+      lmcolorMode = GL_AMBIENT_AND_DIFFUSE;
+      }
+    else if (scalarMaterialMode == VTK_MATERIALMODE_AMBIENT)
+      {
+      lmcolorMode = GL_AMBIENT;
+      }
+    else // if (scalarMaterialMode == VTK_MATERIALMODE_DIFFUSE)
+      {
+      lmcolorMode = GL_DIFFUSE;
+      } 
+    glColorMaterial( GL_FRONT_AND_BACK, lmcolorMode);
+    glEnable( GL_COLOR_MATERIAL );
+    }
+}
+
 int vtkOpenGLPolyDataMapper::Draw(vtkRenderer *aren, vtkActor *act)
 {
   vtkOpenGLRenderer *ren = (vtkOpenGLRenderer *)aren;
@@ -1671,39 +1852,7 @@ int vtkOpenGLPolyDataMapper::Draw(vtkRenderer *aren, vtkActor *act)
     n = input->GetCellData()->GetNormals();
     }
   
-  // if we are doing vertex colors then set lmcolor to adjust 
-  // the current materials ambient and diffuse values using   
-  // vertex color commands otherwise tell it not to.          
-  glDisable( GL_COLOR_MATERIAL );
-  if (c)
-    {
-    GLenum lmcolorMode;
-    if (this->ScalarMaterialMode == VTK_MATERIALMODE_DEFAULT)
-      {
-      if (prop->GetAmbient() > prop->GetDiffuse())
-        {
-        lmcolorMode = GL_AMBIENT;
-        }
-      else
-        {
-        lmcolorMode = GL_DIFFUSE;
-        }
-      }
-    else if (this->ScalarMaterialMode == VTK_MATERIALMODE_AMBIENT_AND_DIFFUSE)
-      {
-      lmcolorMode = GL_AMBIENT_AND_DIFFUSE;
-      }
-    else if (this->ScalarMaterialMode == VTK_MATERIALMODE_AMBIENT)
-      {
-      lmcolorMode = GL_AMBIENT;
-      }
-    else // if (this->ScalarMaterialMode == VTK_MATERIALMODE_DIFFUSE)
-      {
-      lmcolorMode = GL_DIFFUSE;
-      } 
-    glColorMaterial( GL_FRONT_AND_BACK, lmcolorMode);
-    glEnable( GL_COLOR_MATERIAL );
-    }
+  vtkOpenGLPolyDataMapperSetColorMaterial(prop, this->ScalarMaterialMode, c);
   
   unsigned long idx = 0;
   if (n && !cellNormals)
@@ -1919,9 +2068,555 @@ int vtkOpenGLPolyDataMapper::Draw(vtkRenderer *aren, vtkActor *act)
   return noAbort;
 }
 
+//----------------------------------------------------------------------------
+// Return whether the current OpenGL context supports and has loaded the
+// buffer object extension.
+static int vtkOpenGLPolyDataMapperLoadBuffers(vtkRenderWindow *renWin)
+{
+#if !defined(VTK_PDM_USE_BUFFERS)
+  (void)renWin;
+  return 0;
+#elif defined(VTK_IMPLEMENT_MESA_CXX)
+  (void)renWin;
+  const char *name = "GL_ARB_vertex_buffer_object";
+  size_t length = strlen(name);
+  const char *extensions =
+    reinterpret_cast<const char *>(glGetString(GL_EXTENSIONS));
+  const char *p = extensions;
+  while (p && (p = strstr(p, name)) != 0)
+    {
+    if ((p == extensions || p[-1] == ' ') &&
+        (p[length] == ' ' || p[length] == '\0'))
+      {
+      return 1;
+      }
+    p += length;
+    }
+  return 0;
+#else
+  vtkOpenGLExtensionManager *extensions = vtkOpenGLExtensionManager::New();
+  extensions->SetRenderWindow(renWin);
+  int supported =
+    extensions->LoadSupportedExtension("GL_ARB_vertex_buffer_object");
+  extensions->Delete();
+  return supported;
+#endif
+}
+
+//----------------------------------------------------------------------------
+// Find the point attributes drawn with the input, as Draw does.  Returns
+// 0 if colors or normals are given by cell.
+static int vtkOpenGLPolyDataMapperGetPointAttributes(
+  vtkPolyData *input, vtkProperty *prop, vtkUnsignedCharArray *colors,
+  int scalarMode, vtkFloatArray *colorCoordinates,
+  int interpolateScalarsBeforeMapping,
+  vtkDataArray *&n, vtkUnsignedCharArray *&c, vtkDataArray *&t)
+{
+  c = colors;
+  if (c &&
+      (scalarMode == VTK_SCALAR_MODE_USE_CELL_DATA ||
+       scalarMode == VTK_SCALAR_MODE_USE_CELL_FIELD_DATA ||
+       scalarMode == VTK_SCALAR_MODE_USE_FIELD_DATA ||
+       !input->GetPointData()->GetScalars()) &&
+      scalarMode != VTK_SCALAR_MODE_USE_POINT_FIELD_DATA)
+    {
+    return 0;
+    }
+
+  n = input->GetPointData()->GetNormals();
+  if (prop->GetInterpolation() == VTK_FLAT)
+    {
+    n = 0;
+    }
+  if (n == 0 && input->GetCellData()->GetNormals())
+    {
+    return 0;
+    }
+
+  t = input->GetPointData()->GetTCoords();
+  if (t && t->GetNumberOfComponents() > 2)
+    {
+    t = 0;
+    }
+  if (interpolateScalarsBeforeMapping && colorCoordinates)
+    {
+    t = colorCoordinates;
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkOpenGLPolyDataMapper::CanUseVertexBufferObjects(vtkRenderer *ren,
+                                                       vtkActor *act)
+{
+  vtkOpenGLPolyDataMapperBuffers *b = this->Buffers;
+  if (b->Window != ren->GetRenderWindow())
+    {
+    b->Window = ren->GetRenderWindow();
+    b->Supported =
+      vtkOpenGLPolyDataMapperLoadBuffers(ren->GetRenderWindow());
+    }
+  if (!b->Supported)
+    {
+    return 0;
+    }
+
+  vtkPolyData *input = this->GetInput();
+  vtkProperty *prop = act->GetProperty();
+  vtkDataArray *n;
+  vtkUnsignedCharArray *c;
+  vtkDataArray *t;
+  if (!vtkOpenGLPolyDataMapperGetPointAttributes(
+        input, prop, this->Colors, this->ScalarMode, this->ColorCoordinates,
+        this->InterpolateScalarsBeforeMapping, n, c, t))
+    {
+    return 0;
+    }
+  if ((c && c->GetNumberOfComponents() != 4) ||
+      static_cast<double>(input->GetNumberOfPoints()) >
+      static_cast<double>(VTK_UNSIGNED_INT_MAX))
+    {
+    return 0;
+    }
+
+  // Polygons and strips are lit with a normal per polygon when there are
+  // no point normals, and culled polygons are drawn with the polygon mode
+  // of the representation.
+  if (input->GetPolys()->GetNumberOfCells() > 0 ||
+      input->GetStrips()->GetNumberOfCells() > 0)
+    {
+    if (!n ||
+        (prop->GetRepresentation() != VTK_SURFACE &&
+         (prop->GetBackfaceCulling() || prop->GetFrontfaceCulling())))
+      {
+      return 0;
+      }
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+static void vtkOpenGLPolyDataMapperCopyToFloat(T *in, int inComps,
+                                               float *out, int outComps,
+                                               vtkIdType numPts)
+{
+  for (vtkIdType i = 0; i < numPts; ++i, in += inComps)
+    {
+    for (int j = 0; j < outComps; ++j)
+      {
+      *out++ = static_cast<float>(in[j]);
+      }
+    }
+}
+
+#ifdef VTK_PDM_USE_BUFFERS
+//----------------------------------------------------------------------------
+// Upload an attribute to its block of the bound vertex buffer.  Colors
+// are unsigned chars, the other attributes floats.
+static void vtkOpenGLPolyDataMapperUploadAttribute(vtkDataArray *array,
+                                                   int comps,
+                                                   vtkIdType numPts,
+                                                   vtkIdType offset)
+{
+  if (array->GetDataType() == VTK_UNSIGNED_CHAR)
+    {
+    vtkPDMBufferSubData(VTK_PDM_ARRAY_BUFFER,
+                        static_cast<vtkPDMOffsetType>(offset),
+                        static_cast<vtkPDMSizeType>(numPts*comps),
+                        array->GetVoidPointer(0));
+    return;
+    }
+
+  vtkPDMSizeType size =
+    static_cast<vtkPDMSizeType>(numPts*comps*sizeof(float));
+  if (array->GetDataType() == VTK_FLOAT &&
+      array->GetNumberOfComponents() == comps)
+    {
+    vtkPDMBufferSubData(VTK_PDM_ARRAY_BUFFER,
+                        static_cast<vtkPDMOffsetType>(offset), size,
+                        array->GetVoidPointer(0));
+    return;
+    }
+
+  vtkstd::vector<float> data(numPts*comps);
+  switch (array->GetDataType())
+    {
+    vtkTemplateMacro(
+      vtkOpenGLPolyDataMapperCopyToFloat(
+        static_cast<VTK_TT*>(array->GetVoidPointer(0)),
+        array->GetNumberOfComponents(), &data[0], comps, numPts));
+    default:
+      return;
+    }
+  vtkPDMBufferSubData(VTK_PDM_ARRAY_BUFFER,
+                      static_cast<vtkPDMOffsetType>(offset), size, &data[0]);
+}
+#endif
+
+//----------------------------------------------------------------------------
+// Append the point ids of the cells drawn with the given primitive.
+// Polygons are drawn as triangle fans, strips as triangles with the
+// orientation of the strip, and both as their edges in wireframe.
+static void vtkOpenGLPolyDataMapperAddCells(vtkCellArray *ca, int cellType,
+                                            GLenum mode,
+                                            vtkstd::vector<GLuint> &ids)
+{
+  vtkIdType npts = 0;
+  vtkIdType *pts = 0;
+  vtkIdType j;
+  for (ca->InitTraversal(); ca->GetNextCell(npts, pts); )
+    {
+    if (mode == GL_POINTS)
+      {
+      for (j = 0; j < npts; ++j)
+        {
+        ids.push_back(static_cast<GLuint>(pts[j]));
+        }
+      }
+    else if (mode == GL_LINES)
+      {
+      for (j = 0; j + 1 < npts; ++j)
+        {
+        ids.push_back(static_cast<GLuint>(pts[j]));
+        ids.push_back(static_cast<GLuint>(pts[j+1]));
+        }
+      if (cellType == vtkOpenGLPolyDataMapperBuffers::Polys && npts > 2)
+        {
+        ids.push_back(static_cast<GLuint>(pts[npts-1]));
+        ids.push_back(static_cast<GLuint>(pts[0]));
+        }
+      else if (cellType == vtkOpenGLPolyDataMapperBuffers::Strips)
+        {
+        for (j = 0; j + 2 < npts; ++j)
+          {
+          ids.push_back(static_cast<GLuint>(pts[j]));
+          ids.push_back(static_cast<GLuint>(pts[j+2]));
+          }
+        }
+      }
+    else if (cellType == vtkOpenGLPolyDataMapperBuffers::Polys)
+      {
+      for (j = 1; j + 1 < npts; ++j)
+        {
+        ids.push_back(static_cast<GLuint>(pts[0]));
+        ids.push_back(static_cast<GLuint>(pts[j]));
+        ids.push_back(static_cast<GLuint>(pts[j+1]));
+        }
+      }
+    else
+      {
+      for (j = 0; j + 2 < npts; ++j)
+        {
+        int odd = static_cast<int>(j & 1);
+        ids.push_back(static_cast<GLuint>(pts[j+odd]));
+        ids.push_back(static_cast<GLuint>(pts[j+1-odd]));
+        ids.push_back(static_cast<GLuint>(pts[j+2]));
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkOpenGLPolyDataMapper::DrawVertexBufferObjects(vtkRenderer *ren,
+                                                     vtkActor *act)
+{
+  (void)ren;
+#ifdef VTK_PDM_USE_BUFFERS
+  typedef vtkOpenGLPolyDataMapperBuffers Buffers;
+  Buffers *b = this->Buffers;
+  vtkPolyData *input = this->GetInput();
+  vtkProperty *prop = act->GetProperty();
+  int i;
+
+  // if the primitives are invisable then get out of here 
+  if (prop->GetOpacity() <= 0.0)
+    {
+    return 1;
+    }
+
+  vtkDataArray *n;
+  vtkUnsignedCharArray *c;
+  vtkDataArray *t;
+  vtkOpenGLPolyDataMapperGetPointAttributes(
+    input, prop, this->Colors, this->ScalarMode, this->ColorCoordinates,
+    this->InterpolateScalarsBeforeMapping, n, c, t);
+
+  // Lay out the vertex buffer again if the attributes drawn or the
+  // number of points changed.
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkDataArray *arrays[Buffers::NumberOfAttributes];
+  int comps[Buffers::NumberOfAttributes];
+  arrays[Buffers::Points] = input->GetPoints()->GetData();
+  arrays[Buffers::Normals] = n;
+  arrays[Buffers::Colors] = c;
+  arrays[Buffers::TCoords] = t;
+  comps[Buffers::Points] = 3;
+  comps[Buffers::Normals] = n ? 3 : 0;
+  comps[Buffers::Colors] = c ? 4 : 0;
+  comps[Buffers::TCoords] = t ? t->GetNumberOfComponents() : 0;
+  // MapScalars() makes new colors, or texture coordinates, whenever the
+  // input changes, so they are known by the scalars they are mapped from
+  // and the time of the mapper and its lookup table.
+  vtkDataArray *sources[Buffers::NumberOfAttributes];
+  unsigned long times[Buffers::NumberOfAttributes];
+  for (i = 0; i < Buffers::NumberOfAttributes; ++i)
+    {
+    sources[i] = arrays[i];
+    times[i] = (arrays[i] ? arrays[i]->GetMTime() : 0);
+    }
+  // Points are often marked modified through vtkPoints.
+  if (input->GetPoints()->GetMTime() > times[Buffers::Points])
+    {
+    times[Buffers::Points] = input->GetPoints()->GetMTime();
+    }
+  if (c || (t && t == this->ColorCoordinates))
+    {
+    int cellFlag = 0;
+    vtkDataArray *scalars = vtkAbstractMapper::GetScalars(
+      input, this->ScalarMode, this->ArrayAccessMode, this->ArrayId,
+      this->ArrayName, cellFlag);
+    if (scalars)
+      {
+      int mapped = (c ? Buffers::Colors : Buffers::TCoords);
+      sources[mapped] = scalars;
+      times[mapped] = scalars->GetMTime();
+      if (this->GetMTime() > times[mapped])
+        {
+        times[mapped] = this->GetMTime();
+        }
+      }
+    }
+
+  int layoutChanged = (b->VertexBuffer == 0 || b->NumberOfPoints != numPts);
+  for (i = 0; i < Buffers::NumberOfAttributes; ++i)
+    {
+    layoutChanged |= (b->Components[i] != comps[i]);
+    }
+  if (!b->VertexBuffer)
+    {
+    vtkPDMGenBuffers(1, &b->VertexBuffer);
+    }
+  vtkPDMBindBuffer(VTK_PDM_ARRAY_BUFFER, b->VertexBuffer);
+  if (layoutChanged)
+    {
+    vtkIdType size = 0;
+    for (i = 0; i < Buffers::NumberOfAttributes; ++i)
+      {
+      b->Components[i] = comps[i];
+      b->Offsets[i] = size;
+      b->Arrays[i] = 0;
+      size += numPts*comps[i]*
+        (i == Buffers::Colors ? sizeof(unsigned char) : sizeof(float));
+      }
+    b->NumberOfPoints = numPts;
+    vtkPDMBufferData(VTK_PDM_ARRAY_BUFFER,
+                     static_cast<vtkPDMSizeType>(size), 0,
+                     VTK_PDM_STATIC_DRAW);
+    }
+
+  // Upload the attributes whose arrays changed.
+  for (i = 0; i < Buffers::NumberOfAttributes; ++i)
+    {
+    if (comps[i] && (b->Arrays[i] != sources[i] ||
+                     b->ArrayTimes[i] != times[i]))
+      {
+      vtkOpenGLPolyDataMapperUploadAttribute(arrays[i], comps[i], numPts,
+                                             b->Offsets[i]);
+      b->Arrays[i] = sources[i];
+      b->ArrayTimes[i] = times[i];
+      ++b->Uploads[i];
+      }
+    }
+
+  // Rebuild the index buffer if the cells or the primitives changed.
+  int rep = prop->GetRepresentation();
+  vtkCellArray *cells[Buffers::NumberOfCellTypes];
+  GLenum modes[Buffers::NumberOfCellTypes];
+  cells[Buffers::Verts] = input->GetVerts();
+  cells[Buffers::Lines] = input->GetLines();
+  cells[Buffers::Polys] = input->GetPolys();
+  cells[Buffers::Strips] = input->GetStrips();
+  modes[Buffers::Verts] = GL_POINTS;
+  modes[Buffers::Lines] = (rep == VTK_POINTS ? GL_POINTS : GL_LINES);
+  modes[Buffers::Polys] = (rep == VTK_POINTS ? GL_POINTS :
+                           rep == VTK_WIREFRAME ? GL_LINES : GL_TRIANGLES);
+  modes[Buffers::Strips] = modes[Buffers::Polys];
+  int cellsChanged = (b->IndexBuffer == 0);
+  for (i = 0; i < Buffers::NumberOfCellTypes; ++i)
+    {
+    cellsChanged |= (b->Cells[i] != cells[i] ||
+                     b->CellTimes[i] != cells[i]->GetMTime() ||
+                     b->Modes[i] != modes[i]);
+    }
+  if (!b->IndexBuffer)
+    {
+    vtkPDMGenBuffers(1, &b->IndexBuffer);
+    }
+  vtkPDMBindBuffer(VTK_PDM_ELEMENT_ARRAY_BUFFER, b->IndexBuffer);
+  if (cellsChanged)
+    {
+    vtkstd::vector<GLuint> ids;
+    for (i = 0; i < Buffers::NumberOfCellTypes; ++i)
+      {
+      b->First[i] = static_cast<vtkIdType>(ids.size());
+      vtkOpenGLPolyDataMapperAddCells(cells[i], i, modes[i], ids);
+      b->Count[i] = static_cast<vtkIdType>(ids.size()) - b->First[i];
+      b->Cells[i] = cells[i];
+      b->CellTimes[i] = cells[i]->GetMTime();
+      b->Modes[i] = modes[i];
+      }
+    vtkPDMBufferData(VTK_PDM_ELEMENT_ARRAY_BUFFER,
+                     static_cast<vtkPDMSizeType>(ids.size()*sizeof(GLuint)),
+                     ids.empty() ? 0 : &ids[0], VTK_PDM_STATIC_DRAW);
+    ++b->Uploads[Buffers::NumberOfAttributes];
+    }
+
+  // Point the arrays at their blocks.
+  char *base = 0;
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glVertexPointer(3, GL_FLOAT, 0, base + b->Offsets[Buffers::Points]);
+  if (n)
+    {
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glNormalPointer(GL_FLOAT, 0, base + b->Offsets[Buffers::Normals]);
+    }
+  if (c)
+    {
+    // Opaque colors leave the alpha of the material alone.
+    glEnableClientState(GL_COLOR_ARRAY);
+    glColorPointer(c->GetName() ? 3 : 4, GL_UNSIGNED_BYTE, 4,
+                   base + b->Offsets[Buffers::Colors]);
+    }
+  if (t)
+    {
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glTexCoordPointer(comps[Buffers::TCoords], GL_FLOAT, 0,
+                      base + b->Offsets[Buffers::TCoords]);
+    }
+
+  vtkOpenGLPolyDataMapperSetColorMaterial(prop, this->ScalarMaterialMode, c);
+
+  int resolve = 0, zResolve = 0;
+  double zRes = 0.0;
+  if ( this->GetResolveCoincidentTopology() )
+    {
+    resolve = 1;
+    if ( this->GetResolveCoincidentTopology() == VTK_RESOLVE_SHIFT_ZBUFFER )
+      {
+      zResolve = 1;
+      zRes = this->GetResolveCoincidentTopologyZShift();
+      }
+    else
+      {
+#ifdef GL_VERSION_1_1
+      double f, u;
+      glEnable(GL_POLYGON_OFFSET_FILL);
+      this->GetResolveCoincidentTopologyPolygonOffsetParameters(f,u);
+      glPolygonOffset(f,u);
+#endif      
+      }
+    }
+
+  // Draw in the order and with the lighting of Draw.
+  const GLuint *first = 0;
+  if (!n)
+    {
+    glDisable( GL_LIGHTING);
+    }
+  for (i = 0; i < Buffers::NumberOfCellTypes; ++i)
+    {
+    if (i == Buffers::Lines && zResolve)
+      {
+      glDepthRange(zRes, 1.);
+      }
+    else if (i == Buffers::Polys && !n)
+      {
+      glEnable( GL_LIGHTING);
+      if (rep == VTK_POINTS)
+        {
+        glDisable( GL_LIGHTING);
+        }
+      }
+    else if (i == Buffers::Strips && zResolve)
+      {
+      glDepthRange(2*zRes, 1.);
+      }
+    if (b->Count[i] > 0)
+      {
+      glDrawElements(b->Modes[i], static_cast<GLsizei>(b->Count[i]),
+                     GL_UNSIGNED_INT, first + b->First[i]);
+      }
+    }
+  if (!n && rep == VTK_POINTS)
+    {
+    glEnable( GL_LIGHTING);
+    }
+
+  if (resolve)
+    {
+    if ( zResolve )
+      {
+      glDepthRange(0., 1.);
+      }
+    else
+      {
+#ifdef GL_VERSION_1_1
+      glDisable(GL_POLYGON_OFFSET_FILL);
+#endif
+      }
+    }
+
+  glDisableClientState(GL_VERTEX_ARRAY);
+  glDisableClientState(GL_NORMAL_ARRAY);
+  glDisableClientState(GL_COLOR_ARRAY);
+  glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+  vtkPDMBindBuffer(VTK_PDM_ARRAY_BUFFER, 0);
+  vtkPDMBindBuffer(VTK_PDM_ELEMENT_ARRAY_BUFFER, 0);
+
+  this->UpdateProgress(1.0);
+  return 1;
+#else
+  (void)act;
+  return 0;
+#endif
+}
+
+//----------------------------------------------------------------------------
+// Delete the buffer objects.  The context of their window must be current.
+void vtkOpenGLPolyDataMapper::ReleaseVertexBufferObjects()
+{
+#ifdef VTK_PDM_USE_BUFFERS
+  if (this->Buffers->VertexBuffer)
+    {
+    vtkPDMDeleteBuffers(1, &this->Buffers->VertexBuffer);
+    this->Buffers->VertexBuffer = 0;
+    }
+  if (this->Buffers->IndexBuffer)
+    {
+    vtkPDMDeleteBuffers(1, &this->Buffers->IndexBuffer);
+    this->Buffers->IndexBuffer = 0;
+    }
+#endif
+  this->Buffers->Reset();
+}
+
+//----------------------------------------------------------------------------
+int vtkOpenGLPolyDataMapper::GetNumberOfBufferUploads(int contents)
+{
+  if (contents < 0 ||
+      contents > vtkOpenGLPolyDataMapperBuffers::NumberOfAttributes)
+    {
+    return 0;
+    }
+  return this->Buffers->Uploads[contents];
+}
+
 void vtkOpenGLPolyDataMapper::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+  os << indent << "UseVertexBufferObjects: "
+     << this->UseVertexBufferObjects << "\n";
 }
 
   
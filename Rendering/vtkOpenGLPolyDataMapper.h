@@ -31,6 +31,9 @@ class vtkProperty;
 class vtkRenderWindow;
 class vtkOpenGLRenderer;
 class vtkOpenGLTexture;
+//BTX
+class vtkOpenGLPolyDataMapperBuffers;
+//ETX
 
 class VTK_RENDERING_EXPORT vtkOpenGLPolyDataMapper : public vtkPolyDataMapper
 {
@@ -52,6 +55,26 @@ public:
   // Description:
   // Draw method for OpenGL.
   virtual int Draw(vtkRenderer *ren, vtkActor *a);
+
+  // Description:
+  // Get/Set whether the mapper draws from vertex buffer objects instead
+  // of a display list or immediate mode, when the OpenGL implementation
+  // supports GL_ARB_vertex_buffer_object.  The points, normals, colors
+  // and texture coordinates are packed one after the other in one
+  // buffer object, and the cells in an index buffer object.  When the
+  // input changes, only the attributes whose arrays changed are uploaded
+  // again.  Inputs colored or shaded by cell, and polygons or strips
+  // without point normals, are drawn as usual.  The default is off.
+  vtkSetMacro(UseVertexBufferObjects, int);
+  vtkGetMacro(UseVertexBufferObjects, int);
+  vtkBooleanMacro(UseVertexBufferObjects, int);
+
+  // Description:
+  // Get how many times the vertex buffer objects were filled with the
+  // points (0), normals (1), colors (2), texture coordinates (3) or cells
+  // (4) of the input.  This lets tests check that only the arrays that
+  // changed are uploaded again.
+  int GetNumberOfBufferUploads(int contents);
   
 protected:
   vtkOpenGLPolyDataMapper();
@@ -99,10 +122,23 @@ protected:
                    vtkCellArray *ca,
                    vtkRenderer *ren);
     
+  // Description:
+  // Draw the input from the vertex buffer objects, updating them first.
+  // CanUseVertexBufferObjects returns whether the input and the render
+  // window allow it.
+  int CanUseVertexBufferObjects(vtkRenderer *ren, vtkActor *a);
+  int DrawVertexBufferObjects(vtkRenderer *ren, vtkActor *a);
+  void ReleaseVertexBufferObjects();
+
   vtkIdType TotalCells;
   int ListId;
   vtkOpenGLTexture* InternalColorTexture;
 
+  int UseVertexBufferObjects;
+//BTX
+  vtkOpenGLPolyDataMapperBuffers *Buffers;
+//ETX
+
 private:
   vtkOpenGLPolyDataMapper(const vtkOpenGLPolyDataMapper&);  // Not implemented.
   void operator=(const vtkOpenGLPolyDataMapper&);  // Not implemented.
@@ -20,6 +20,7 @@
 #include "vtkMath.h"
 #include "vtkPolyData.h"
 #include "vtkRenderWindow.h"
+#include "vtkTimerLog.h"
 
 vtkCxxRevisionMacro(vtkPolyDataMapper, "1.38");
 
@@ -48,6 +49,7 @@ vtkPolyDataMapper::vtkPolyDataMapper()
 
 void vtkPolyDataMapper::Render(vtkRenderer *ren, vtkActor *act) 
 {
+  vtkTimerLogTraceScope scope("Render", this, "Render");
   if (this->Static)
     {
     this->RenderPiece(ren,act);
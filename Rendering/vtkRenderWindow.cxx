@@ -20,6 +20,7 @@
 #include "vtkMath.h"
 #include "vtkRenderWindowInteractor.h"
 #include "vtkRendererCollection.h"
+#include "vtkTimerLog.h"
 #include "vtkTransform.h"
 
 vtkCxxRevisionMacro(vtkRenderWindow, "1.144");
@@ -218,6 +219,7 @@ void vtkRenderWindow::Render()
     {
     return;
     }
+  vtkTimerLogTraceScope scope("Render", this, "Render");
 
   // reset the Abort flag
   this->AbortRender = 0;
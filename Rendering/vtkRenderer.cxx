@@ -147,6 +147,7 @@ void vtkRenderer::Render(void)
   int      i;
   vtkProp  *aProp;
   int *size;
+  vtkTimerLogTraceScope scope("Render", this, "Render");
 
   t1 = vtkTimerLog::GetUniversalTime();
 
@@ -0,0 +1,26 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtk_lz4.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#ifndef __vtk_lz4_h
+#define __vtk_lz4_h
+
+/* Use the lz4 library configured for VTK.  */
+#include "vtkToolkits.h"
+#ifdef VTK_USE_SYSTEM_LZ4
+# include <lz4.h>
+#else
+# include <vtklz4/lz4.h>
+#endif
+
+#endif
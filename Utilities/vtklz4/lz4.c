@@ -0,0 +1,353 @@
+/* lz4.c -- compress and decompress blocks in the LZ4 block format
+
+  See lz4.h for a description of the format.
+
+  The compressor finds matches with a hash table of the positions of
+  the last four byte sequences seen, as the fast mode of the reference
+  implementation does.  When no match is found for a while, it skips
+  ahead faster and faster, so incompressible data go through quickly.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.  See Copyright.txt or http://www.kitware.com/Copyright.htm
+  for details.
+*/
+
+#include "lz4.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#define LZ4_MINMATCH 4
+#define LZ4_LASTLITERALS 5
+#define LZ4_MFLIMIT 12
+#define LZ4_MAX_DISTANCE 65535
+#define LZ4_HASHLOG 12
+#define LZ4_SKIPTRIGGER 6
+#define LZ4_RUN_MASK 15
+#define LZ4_ML_MASK 15
+
+typedef unsigned char lz4_byte;
+
+/* Sequences are compared and hashed as 32-bit words read with memcpy,
+   which compilers turn into single unaligned loads where allowed.  */
+static unsigned long lz4_read32(const lz4_byte* p)
+{
+  unsigned int v32;
+  unsigned long v;
+  if(sizeof(unsigned int) == 4)
+    {
+    memcpy(&v32, p, 4);
+    return v32;
+    }
+  v = (unsigned long)p[0] | ((unsigned long)p[1] << 8) |
+    ((unsigned long)p[2] << 16) | ((unsigned long)p[3] << 24);
+  return v;
+}
+
+static unsigned int lz4_hash(unsigned long sequence)
+{
+  return (unsigned int)
+    (((sequence * 2654435761UL) & 0xffffffffUL) >> (32 - LZ4_HASHLOG));
+}
+
+/* Return the number of bytes at ip and match that are equal, without
+   reading at or beyond limit.  */
+static size_t lz4_count(const lz4_byte* ip, const lz4_byte* match,
+                        const lz4_byte* limit)
+{
+  const lz4_byte* start = ip;
+  while(ip + sizeof(size_t) <= limit)
+    {
+    size_t a;
+    size_t b;
+    memcpy(&a, ip, sizeof(size_t));
+    memcpy(&b, match, sizeof(size_t));
+    if(a != b)
+      {
+      break;
+      }
+    ip += sizeof(size_t);
+    match += sizeof(size_t);
+    }
+  while(ip < limit && *ip == *match)
+    {
+    ++ip;
+    ++match;
+    }
+  return (size_t)(ip - start);
+}
+
+/* Write the continuation bytes of a length field whose token value was
+   15.  */
+static lz4_byte* lz4_write_length(lz4_byte* op, size_t length)
+{
+  while(length >= 255)
+    {
+    *op++ = 255;
+    length -= 255;
+    }
+  *op++ = (lz4_byte)length;
+  return op;
+}
+
+/*-------------------------------------------------------------------------*/
+int LZ4_compressBound(int inputSize)
+{
+  return LZ4_COMPRESSBOUND(inputSize);
+}
+
+/*-------------------------------------------------------------------------*/
+int LZ4_compress_default(const char* source, char* dest,
+                         int inputSize, int maxOutputSize)
+{
+  const lz4_byte* src = (const lz4_byte*)source;
+  const lz4_byte* ip = src;
+  const lz4_byte* anchor = src;
+  const lz4_byte* iend = src + inputSize;
+  const lz4_byte* mflimit = iend - LZ4_MFLIMIT;
+  const lz4_byte* matchlimit = iend - LZ4_LASTLITERALS;
+  lz4_byte* op = (lz4_byte*)dest;
+  lz4_byte* oend = op + maxOutputSize;
+  size_t lastRun;
+
+  /* Positions of the last sequences seen, by hash.  */
+  unsigned int table[1 << LZ4_HASHLOG];
+
+  if(inputSize < 0 || inputSize > LZ4_MAX_INPUT_SIZE || maxOutputSize < 1)
+    {
+    return 0;
+    }
+
+  /* Blocks too short for a match are all literals.  */
+  if(inputSize > LZ4_MFLIMIT)
+    {
+    memset(table, 0, sizeof(table));
+    ++ip;
+    for(;;)
+      {
+      const lz4_byte* match;
+      lz4_byte* token;
+      size_t litLength;
+      size_t matchLength;
+      unsigned int offset;
+      unsigned int searchCount = (1 << LZ4_SKIPTRIGGER) + 1;
+      unsigned int step = 1;
+
+      /* Find a match.  The table starts out pointing at the first byte,
+         and a stale entry is caught by comparing the bytes.  */
+      for(;;)
+        {
+        unsigned long sequence;
+        unsigned int h;
+        if(ip > mflimit)
+          {
+          goto lastLiterals;
+          }
+        sequence = lz4_read32(ip);
+        h = lz4_hash(sequence);
+        match = src + table[h];
+        table[h] = (unsigned int)(ip - src);
+        if(match < ip && ip - match <= LZ4_MAX_DISTANCE &&
+           lz4_read32(match) == sequence)
+          {
+          break;
+          }
+        ip += step;
+        step = searchCount++ >> LZ4_SKIPTRIGGER;
+        }
+
+      /* Extend the match backwards over the pending literals.  */
+      while(ip > anchor && match > src && ip[-1] == match[-1])
+        {
+        --ip;
+        --match;
+        }
+
+      /* Write the token and the literals, leaving room for the offset,
+         the match length and the last literals.  */
+      litLength = (size_t)(ip - anchor);
+      if((size_t)(oend - op) <
+         1 + litLength + litLength/255 + 1 + 2 + 1 + LZ4_LASTLITERALS)
+        {
+        return 0;
+        }
+      token = op++;
+      if(litLength >= LZ4_RUN_MASK)
+        {
+        *token = LZ4_RUN_MASK << 4;
+        op = lz4_write_length(op, litLength - LZ4_RUN_MASK);
+        }
+      else
+        {
+        *token = (lz4_byte)(litLength << 4);
+        }
+      memcpy(op, anchor, litLength);
+      op += litLength;
+
+      /* Write the offset and the match length.  */
+      offset = (unsigned int)(ip - match);
+      *op++ = (lz4_byte)(offset & 0xff);
+      *op++ = (lz4_byte)(offset >> 8);
+      matchLength = lz4_count(ip + LZ4_MINMATCH, match + LZ4_MINMATCH,
+                              matchlimit);
+      ip += LZ4_MINMATCH + matchLength;
+      if(matchLength >= LZ4_ML_MASK)
+        {
+        if((size_t)(oend - op) <
+           (matchLength - LZ4_ML_MASK)/255 + 1 + 1 + LZ4_LASTLITERALS)
+          {
+          return 0;
+          }
+        *token += LZ4_ML_MASK;
+        op = lz4_write_length(op, matchLength - LZ4_ML_MASK);
+        }
+      else
+        {
+        *token += (lz4_byte)matchLength;
+        }
+      anchor = ip;
+
+      if(ip > mflimit)
+        {
+        break;
+        }
+
+      /* Remember a position inside the match, which helps repetitive
+         data.  */
+      table[lz4_hash(lz4_read32(ip - 2))] = (unsigned int)(ip - 2 - src);
+      }
+    }
+
+lastLiterals:
+  /* The last sequence has literals only.  */
+  lastRun = (size_t)(iend - anchor);
+  if((size_t)(oend - op) < 1 + lastRun + (lastRun + 255 - LZ4_RUN_MASK)/255)
+    {
+    return 0;
+    }
+  if(lastRun >= LZ4_RUN_MASK)
+    {
+    *op++ = LZ4_RUN_MASK << 4;
+    op = lz4_write_length(op, lastRun - LZ4_RUN_MASK);
+    }
+  else
+    {
+    *op++ = (lz4_byte)(lastRun << 4);
+    }
+  memcpy(op, anchor, lastRun);
+  op += lastRun;
+
+  return (int)(op - (lz4_byte*)dest);
+}
+
+/*-------------------------------------------------------------------------*/
+/* Read the continuation bytes of a length field.  Returns 0 if the
+   input ends first or the length exceeds limit.  */
+static int lz4_read_length(const lz4_byte** ip, const lz4_byte* iend,
+                           size_t* length, size_t limit)
+{
+  unsigned int s;
+  do
+    {
+    if(*ip >= iend)
+      {
+      return 0;
+      }
+    s = *(*ip)++;
+    *length += s;
+    if(*length > limit)
+      {
+      return 0;
+      }
+    } while(s == 255);
+  return 1;
+}
+
+/*-------------------------------------------------------------------------*/
+int LZ4_decompress_safe(const char* source, char* dest,
+                        int compressedSize, int maxDecompressedSize)
+{
+  const lz4_byte* ip = (const lz4_byte*)source;
+  const lz4_byte* iend = ip + compressedSize;
+  lz4_byte* const ostart = (lz4_byte*)dest;
+  lz4_byte* op = ostart;
+  lz4_byte* oend = op + maxDecompressedSize;
+
+  if(compressedSize <= 0 || maxDecompressedSize < 0)
+    {
+    return -1;
+    }
+
+  for(;;)
+    {
+    unsigned int token;
+    size_t length;
+    size_t offset;
+    const lz4_byte* match;
+
+    /* Copy the literals.  */
+    if(ip >= iend)
+      {
+      return -1;
+      }
+    token = *ip++;
+    length = token >> 4;
+    if(length == LZ4_RUN_MASK &&
+       !lz4_read_length(&ip, iend, &length, (size_t)(iend - ip)))
+      {
+      return -1;
+      }
+    if((size_t)(iend - ip) < length || (size_t)(oend - op) < length)
+      {
+      return -1;
+      }
+    memcpy(op, ip, length);
+    ip += length;
+    op += length;
+
+    /* The last sequence ends the block.  */
+    if(ip == iend)
+      {
+      break;
+      }
+
+    /* Copy the match, which may overlap the bytes it produces.  */
+    if(iend - ip < 2)
+      {
+      return -1;
+      }
+    offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+    ip += 2;
+    if(offset == 0 || offset > (size_t)(op - ostart))
+      {
+      return -1;
+      }
+    match = op - offset;
+    length = token & LZ4_ML_MASK;
+    if(length == LZ4_ML_MASK &&
+       !lz4_read_length(&ip, iend, &length, (size_t)(oend - op)))
+      {
+      return -1;
+      }
+    length += LZ4_MINMATCH;
+    if((size_t)(oend - op) < length)
+      {
+      return -1;
+      }
+    if(offset >= length)
+      {
+      memcpy(op, match, length);
+      op += length;
+      }
+    else
+      {
+      while(length--)
+        {
+        *op++ = *match++;
+        }
+      }
+    }
+
+  return (int)(op - ostart);
+}
@@ -0,0 +1,75 @@
+/* lz4.h -- interface of the VTK lz4 library
+
+  This library is VTK code, written for VTK, that reads and writes
+  blocks in the LZ4 block format, a byte oriented LZ77 format built for
+  speed.  It is not a copy or a release of the reference LZ4 library
+  and has no version of its own.  It declares the few block functions
+  VTK needs under the names the reference library gives them, so that
+  VTK_USE_SYSTEM_LZ4 can replace it with a system lz4 library.
+
+  A block is a sequence of sequences.  Each sequence starts with a token
+  byte whose high four bits hold the number of literal bytes and whose
+  low four bits hold the match length minus four.  A field value of 15
+  is continued by bytes that are added to it, up to and including the
+  first byte that is not 255.  The literals follow the literal length,
+  then the match offset as two little endian bytes, then the match
+  length continuation bytes.  The last sequence has literals only.  The
+  last five bytes of a block are always literals, and the last match
+  starts at least twelve bytes before the end of the block.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.  See Copyright.txt or http://www.kitware.com/Copyright.htm
+  for details.
+*/
+
+#ifndef LZ4_H
+#define LZ4_H
+
+#include "vtk_lz4_mangle.h"
+#include <vtklz4/lz4DllConfig.h>
+
+#if defined(_WIN32) && defined(LZ4_DLL)
+# if defined(vtklz4_EXPORTS)
+#  define LZ4LIB_API __declspec(dllexport)
+# else
+#  define LZ4LIB_API __declspec(dllimport)
+# endif
+#else
+# define LZ4LIB_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The largest input size accepted by the compressor.  */
+#define LZ4_MAX_INPUT_SIZE 0x7E000000
+
+/* Return the largest size a block of inputSize bytes can compress to,
+   or 0 if inputSize is negative or too large.  */
+#define LZ4_COMPRESSBOUND(isize) \
+  ((unsigned)(isize) > (unsigned)LZ4_MAX_INPUT_SIZE ? 0 : \
+   (isize) + ((isize)/255) + 16)
+LZ4LIB_API int LZ4_compressBound(int inputSize);
+
+/* Compress srcSize bytes from src into the dstCapacity bytes at dst.
+   Returns the number of bytes written, or 0 if the output does not fit.
+   The output always fits when dstCapacity is at least
+   LZ4_compressBound(srcSize).  The function keeps its state on the
+   stack, so it may be called concurrently from several threads.  */
+LZ4LIB_API int LZ4_compress_default(const char* src, char* dst,
+                                    int srcSize, int dstCapacity);
+
+/* Decompress the compressedSize bytes of a block at src into the
+   dstCapacity bytes at dst.  Returns the number of bytes written, or a
+   negative value if the block is malformed or does not fit.  The
+   function never reads or writes outside of the given buffers.  */
+LZ4LIB_API int LZ4_decompress_safe(const char* src, char* dst,
+                                   int compressedSize, int dstCapacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LZ4_H */
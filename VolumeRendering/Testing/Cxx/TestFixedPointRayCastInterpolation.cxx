@@ -0,0 +1,152 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestFixedPointRayCastInterpolation.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the trilinear interpolation of the fixed point ray caster.
+// .SECTION Description
+// Interpolates random cells at random positions with the interpolation
+// macros used by the vtkFixedPointVolumeRayCastMapper helpers, and checks
+// that the SSE2 versions give the same values as the portable versions.
+// The corners of the cells include the extreme table indices.
+
+#include "vtkFixedPointVolumeRayCastHelper.h"
+#include "vtkFixedPointVolumeRayCastMapper.h"
+
+static unsigned int TestInterpolationRandom(unsigned int &seed)
+{
+  seed = seed*1103515245 + 12345;
+  return (seed >> 8);
+}
+
+static unsigned int TestInterpolationCorner(unsigned int &seed,
+                                            unsigned int max)
+{
+  unsigned int r = TestInterpolationRandom(seed);
+  switch (r % 8)
+    {
+    case 0:
+      return 0;
+    case 1:
+      return max;
+    default:
+      return (r >> 3) % (max + 1);
+    }
+}
+
+int TestFixedPointRayCastInterpolation(int, char *[])
+{
+  int useSSE2 = vtkFixedPointVolumeRayCastHelper::IsSSE2Supported();
+  cout << "SSE2 interpolation " << (useSSE2 ? "supported" : "not supported")
+       << "\n";
+
+  vtkFixedPointVolumeRayCastMapper *mapper =
+    vtkFixedPointVolumeRayCastMapper::New();
+  if (!mapper->GetUseSSE2())
+    {
+    cerr << "UseSSE2 should be on by default\n";
+    mapper->Delete();
+    return 1;
+    }
+  mapper->Delete();
+
+  unsigned int seed = 1;
+  unsigned int w1X, w1Y, w1Z;
+  unsigned int w2X, w2Y, w2Z;
+  unsigned int w1Xw1Y, w2Xw1Y, w1Xw2Y, w2Xw2Y;
+  unsigned int A, B, C, D, E, F, G, H;
+  unsigned int mA, mB, mC, mD, mE, mF, mG, mH;
+  unsigned int cA[4], cB[4], cC[4], cD[4], cE[4], cF[4], cG[4], cH[4];
+  unsigned short val, expectedVal, mag, expectedMag;
+  unsigned short cVal[4], expectedCVal[4];
+  unsigned int pos[3];
+  int c, i;
+
+  for (int sample = 0; sample < 200000; ++sample)
+    {
+    // Positions on the cell faces matter as much as those inside.
+    for (i = 0; i < 3; ++i)
+      {
+      pos[i] = TestInterpolationRandom(seed);
+      if (sample % 16 == 0)
+        {
+        pos[i] &= ~VTKKW_FP_MASK;
+        }
+      else if (sample % 16 == 1)
+        {
+        pos[i] |= VTKKW_FP_MASK;
+        }
+      }
+    A = TestInterpolationCorner(seed, 0x7fff);
+    B = TestInterpolationCorner(seed, 0x7fff);
+    C = TestInterpolationCorner(seed, 0x7fff);
+    D = TestInterpolationCorner(seed, 0x7fff);
+    E = TestInterpolationCorner(seed, 0x7fff);
+    F = TestInterpolationCorner(seed, 0x7fff);
+    G = TestInterpolationCorner(seed, 0x7fff);
+    H = TestInterpolationCorner(seed, 0x7fff);
+    mA = TestInterpolationCorner(seed, 0xff);
+    mB = TestInterpolationCorner(seed, 0xff);
+    mC = TestInterpolationCorner(seed, 0xff);
+    mD = TestInterpolationCorner(seed, 0xff);
+    mE = TestInterpolationCorner(seed, 0xff);
+    mF = TestInterpolationCorner(seed, 0xff);
+    mG = TestInterpolationCorner(seed, 0xff);
+    mH = TestInterpolationCorner(seed, 0xff);
+
+    VTKKWRCHelper_ComputeWeights(pos);
+    VTKKWRCHelper_InterpolateScalar(val);
+    VTKKWRCHelper_InterpolateMagnitude(mag);
+    VTKKWRCHelper_InterpolateScalarGeneric(expectedVal);
+    VTKKWRCHelper_InterpolateMagnitudeGeneric(expectedMag);
+    if (val != expectedVal || mag != expectedMag)
+      {
+      cerr << "Sample " << sample << " interpolated to " << val << ", "
+           << mag << " instead of " << expectedVal << ", " << expectedMag
+           << "\n";
+      return 1;
+      }
+
+    // The component macros use A through H as arrays.
+    for (c = 0; c < 4; ++c)
+      {
+      cA[c] = TestInterpolationCorner(seed, 0x7fff);
+      cB[c] = TestInterpolationCorner(seed, 0x7fff);
+      cC[c] = TestInterpolationCorner(seed, 0x7fff);
+      cD[c] = TestInterpolationCorner(seed, 0x7fff);
+      cE[c] = TestInterpolationCorner(seed, 0x7fff);
+      cF[c] = TestInterpolationCorner(seed, 0x7fff);
+      cG[c] = TestInterpolationCorner(seed, 0x7fff);
+      cH[c] = TestInterpolationCorner(seed, 0x7fff);
+      }
+    {
+    unsigned int *A = cA, *B = cB, *C = cC, *D = cD;
+    unsigned int *E = cE, *F = cF, *G = cG, *H = cH;
+    int components = 2 + sample % 3;
+    VTKKWRCHelper_InterpolateScalarComponent(cVal, c, components);
+    VTKKWRCHelper_InterpolateScalarComponentGeneric(expectedCVal, c,
+                                                    components);
+    for (c = 0; c < components; ++c)
+      {
+      if (cVal[c] != expectedCVal[c])
+        {
+        cerr << "Sample " << sample << " interpolated component " << c
+             << " to " << cVal[c] << " instead of " << expectedCVal[c]
+             << "\n";
+        return 1;
+        }
+      }
+    }
+    }
+
+  return 0;
+}
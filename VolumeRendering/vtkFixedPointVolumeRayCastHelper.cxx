@@ -17,6 +17,14 @@
 
 #include <math.h>
 
+#if defined(VTKKW_FP_USE_SSE2) && !defined(_M_X64) && !defined(__x86_64__)
+# if defined(_MSC_VER)
+#  include <intrin.h>
+# elif defined(__GNUC__)
+#  include <cpuid.h>
+# endif
+#endif
+
 vtkCxxRevisionMacro(vtkFixedPointVolumeRayCastHelper, "1.2");
 vtkStandardNewMacro(vtkFixedPointVolumeRayCastHelper);
 
@@ -28,6 +36,37 @@ vtkFixedPointVolumeRayCastHelper::~vtkFixedPointVolumeRayCastHelper()
 {
 }
 
+// Every x86-64 processor has SSE2. A 32 bit build compiled for SSE2 asks
+// the processor, using the feature flags of cpuid function 1.
+int vtkFixedPointVolumeRayCastHelper::IsSSE2Supported()
+{
+#if !defined(VTKKW_FP_USE_SSE2)
+  return 0;
+#elif defined(_M_X64) || defined(__x86_64__)
+  return 1;
+#elif defined(_MSC_VER)
+  static int supported = -1;
+  if ( supported < 0 )
+    {
+    int info[4];
+    __cpuid( info, 1 );
+    supported = ( info[3] & (1 << 26) ) ? 1 : 0;
+    }
+  return supported;
+#elif defined(__GNUC__)
+  static int supported = -1;
+  if ( supported < 0 )
+    {
+    unsigned int eax, ebx, ecx, edx;
+    supported = ( __get_cpuid( 1, &eax, &ebx, &ecx, &edx ) &&
+                  ( edx & bit_SSE2 ) ) ? 1 : 0;
+    }
+  return supported;
+#else
+  return 1;
+#endif
+}
+
 void vtkFixedPointVolumeRayCastHelper::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
@@ -23,6 +23,16 @@
 #ifndef __vtkFixedPointVolumeRayCastHelper_h
 #define __vtkFixedPointVolumeRayCastHelper_h
 
+//BTX
+// The trilinear interpolation macros have SSE2 versions that are compiled
+// in when the compiler targets SSE2. They are used when the processor
+// supports SSE2 and the mapper has UseSSE2 on, and compute the same values
+// as the portable versions.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VTKKW_FP_USE_SSE2
+#endif
+//ETX
+
 //BTX
 #define VTKKWRCHelper_GetCellScalarValues( DATA, SCALE, SHIFT ) \
   A = static_cast<unsigned int >(SCALE*(*(DATA     ) + SHIFT)); \
@@ -109,7 +119,7 @@
 
 
 //BTX
-#define VTKKWRCHelper_ComputeWeights( POS )                                             \
+#define VTKKWRCHelper_ComputeWeightsGeneric( POS )                                      \
   w2X = (POS[0]&VTKKW_FP_MASK);                                                         \
   w2Y = (POS[1]&VTKKW_FP_MASK);                                                         \
   w2Z = (POS[2]&VTKKW_FP_MASK);                                                         \
@@ -121,12 +131,12 @@
   w1Xw1Y = (0x4000+(w1X*w1Y))>>VTKKW_FP_SHIFT;                                          \
   w2Xw1Y = (0x4000+(w2X*w1Y))>>VTKKW_FP_SHIFT;                                          \
   w1Xw2Y = (0x4000+(w1X*w2Y))>>VTKKW_FP_SHIFT;                                          \
-  w2Xw2Y = (0x4000+(w2X*w2Y))>>VTKKW_FP_SHIFT;                                          \
+  w2Xw2Y = (0x4000+(w2X*w2Y))>>VTKKW_FP_SHIFT;
 //ETX
 
 
 //BTX
-#define VTKKWRCHelper_InterpolateScalar( VAL )                                  \
+#define VTKKWRCHelper_InterpolateScalarGeneric( VAL )                           \
   VAL =                                                                         \
     (0x7fff + ((A*((0x4000 + w1Xw1Y*w1Z)>>VTKKW_FP_SHIFT)) +                    \
                (B*((0x4000 + w2Xw1Y*w1Z)>>VTKKW_FP_SHIFT)) +                    \
@@ -139,7 +149,7 @@
 //ETX
 
 //BTX
-#define VTKKWRCHelper_InterpolateMagnitude( VAL )                                       \
+#define VTKKWRCHelper_InterpolateMagnitudeGeneric( VAL )                                \
   VAL =                                                                                 \
     (0x7fff + ((mA*((0x4000 + w1Xw1Y*w1Z)>>VTKKW_FP_SHIFT)) +                           \
                (mB*((0x4000 + w2Xw1Y*w1Z)>>VTKKW_FP_SHIFT)) +                           \
@@ -152,7 +162,7 @@
 //ETX
 
 //BTX  
-#define VTKKWRCHelper_InterpolateScalarComponent( VAL, CIDX, COMPONENTS )               \
+#define VTKKWRCHelper_InterpolateScalarComponentGeneric( VAL, CIDX, COMPONENTS )        \
   for ( CIDX = 0; CIDX < COMPONENTS; CIDX++ )                                           \
     {                                                                                   \
     VAL[CIDX] =                                                                         \
@@ -168,7 +178,7 @@
 //ETX 
       
 //BTX 
-#define VTKKWRCHelper_InterpolateMagnitudeComponent( VAL, CIDX, COMPONENTS )            \
+#define VTKKWRCHelper_InterpolateMagnitudeComponentGeneric( VAL, CIDX, COMPONENTS )     \
   for ( CIDX = 0; CIDX < COMPONENTS; CIDX++ )                                           \
     {                                                                                   \
     VAL[CIDX] =                                                                         \
@@ -183,6 +193,123 @@
     }
 //ETX
 
+#ifdef VTKKW_FP_USE_SSE2
+
+//BTX
+// Compute the weights as above, and the eight trilinear weights of the
+// corners A through H packed into _weightsSSE2.
+#define VTKKWRCHelper_ComputeWeights( POS )                                             \
+  VTKKWRCHelper_ComputeWeightsGeneric( POS );                                           \
+  __m128i _weightsSSE2 = _mm_setzero_si128();                                           \
+  if ( useSSE2 )                                                                        \
+    {                                                                                   \
+    __m128i _wXY = _mm_setr_epi16( static_cast<short>(w1Xw1Y), static_cast<short>(w2Xw1Y), \
+                                   static_cast<short>(w1Xw2Y), static_cast<short>(w2Xw2Y), \
+                                   static_cast<short>(w1Xw1Y), static_cast<short>(w2Xw1Y), \
+                                   static_cast<short>(w1Xw2Y), static_cast<short>(w2Xw2Y) ); \
+    __m128i _wZ  = _mm_setr_epi16( static_cast<short>(w1Z), static_cast<short>(w1Z),    \
+                                   static_cast<short>(w1Z), static_cast<short>(w1Z),    \
+                                   static_cast<short>(w2Z), static_cast<short>(w2Z),    \
+                                   static_cast<short>(w2Z), static_cast<short>(w2Z) );  \
+    __m128i _lo  = _mm_mullo_epi16( _wXY, _wZ );                                        \
+    __m128i _hi  = _mm_mulhi_epi16( _wXY, _wZ );                                        \
+    __m128i _rnd = _mm_set1_epi32( 0x4000 );                                            \
+    _weightsSSE2 = _mm_packs_epi32(                                                     \
+      _mm_srli_epi32( _mm_add_epi32( _mm_unpacklo_epi16( _lo, _hi ), _rnd ), VTKKW_FP_SHIFT ), \
+      _mm_srli_epi32( _mm_add_epi32( _mm_unpackhi_epi16( _lo, _hi ), _rnd ), VTKKW_FP_SHIFT ) ); \
+    }
+//ETX
+
+//BTX
+// Interpolate the eight corner values with _weightsSSE2. The weights and
+// the values (indices into the 32768 entry tables) fit in 15 bits, so
+// _mm_madd_epi16 computes the products and the pairwise sums exactly.
+#define VTKKWRCHelper_InterpolateSSE2( VAL, A, B, C, D, E, F, G, H )                    \
+  {                                                                                     \
+  __m128i _sum = _mm_madd_epi16(                                                        \
+    _mm_setr_epi16( static_cast<short>(A), static_cast<short>(B),                       \
+                    static_cast<short>(C), static_cast<short>(D),                       \
+                    static_cast<short>(E), static_cast<short>(F),                       \
+                    static_cast<short>(G), static_cast<short>(H) ), _weightsSSE2 );     \
+  _sum = _mm_add_epi32( _sum, _mm_shuffle_epi32( _sum, 0x4e ) );                        \
+  _sum = _mm_add_epi32( _sum, _mm_shuffle_epi32( _sum, 0xb1 ) );                        \
+  VAL = (0x7fff + static_cast<unsigned int>(_mm_cvtsi128_si32( _sum ))) >> VTKKW_FP_SHIFT; \
+  }
+//ETX
+
+//BTX
+#define VTKKWRCHelper_InterpolateScalar( VAL )                                          \
+  if ( useSSE2 )                                                                        \
+    {                                                                                   \
+    VTKKWRCHelper_InterpolateSSE2( VAL, A, B, C, D, E, F, G, H );                       \
+    }                                                                                   \
+  else                                                                                  \
+    {                                                                                   \
+    VTKKWRCHelper_InterpolateScalarGeneric( VAL );                                      \
+    }
+//ETX
+
+//BTX
+#define VTKKWRCHelper_InterpolateMagnitude( VAL )                                       \
+  if ( useSSE2 )                                                                        \
+    {                                                                                   \
+    VTKKWRCHelper_InterpolateSSE2( VAL, mA, mB, mC, mD, mE, mF, mG, mH );               \
+    }                                                                                   \
+  else                                                                                  \
+    {                                                                                   \
+    VTKKWRCHelper_InterpolateMagnitudeGeneric( VAL );                                   \
+    }
+//ETX
+
+//BTX
+#define VTKKWRCHelper_InterpolateScalarComponent( VAL, CIDX, COMPONENTS )               \
+  if ( useSSE2 )                                                                        \
+    {                                                                                   \
+    for ( CIDX = 0; CIDX < COMPONENTS; CIDX++ )                                         \
+      {                                                                                 \
+      VTKKWRCHelper_InterpolateSSE2( VAL[CIDX], A[CIDX], B[CIDX], C[CIDX], D[CIDX],     \
+                                     E[CIDX], F[CIDX], G[CIDX], H[CIDX] );              \
+      }                                                                                 \
+    }                                                                                   \
+  else                                                                                  \
+    {                                                                                   \
+    VTKKWRCHelper_InterpolateScalarComponentGeneric( VAL, CIDX, COMPONENTS );           \
+    }
+//ETX
+
+//BTX
+#define VTKKWRCHelper_InterpolateMagnitudeComponent( VAL, CIDX, COMPONENTS )            \
+  if ( useSSE2 )                                                                        \
+    {                                                                                   \
+    for ( CIDX = 0; CIDX < COMPONENTS; CIDX++ )                                         \
+      {                                                                                 \
+      VTKKWRCHelper_InterpolateSSE2( VAL[CIDX], mA[CIDX], mB[CIDX], mC[CIDX], mD[CIDX], \
+                                     mE[CIDX], mF[CIDX], mG[CIDX], mH[CIDX] );          \
+      }                                                                                 \
+    }                                                                                   \
+  else                                                                                  \
+    {                                                                                   \
+    VTKKWRCHelper_InterpolateMagnitudeComponentGeneric( VAL, CIDX, COMPONENTS );        \
+    }
+//ETX
+
+#else
+
+//BTX
+#define VTKKWRCHelper_ComputeWeights( POS )                                     \
+  VTKKWRCHelper_ComputeWeightsGeneric( POS )
+#define VTKKWRCHelper_InterpolateScalar( VAL )                                  \
+  VTKKWRCHelper_InterpolateScalarGeneric( VAL )
+#define VTKKWRCHelper_InterpolateMagnitude( VAL )                               \
+  VTKKWRCHelper_InterpolateMagnitudeGeneric( VAL )
+#define VTKKWRCHelper_InterpolateScalarComponent( VAL, CIDX, COMPONENTS )       \
+  VTKKWRCHelper_InterpolateScalarComponentGeneric( VAL, CIDX, COMPONENTS )
+#define VTKKWRCHelper_InterpolateMagnitudeComponent( VAL, CIDX, COMPONENTS )    \
+  VTKKWRCHelper_InterpolateMagnitudeComponentGeneric( VAL, CIDX, COMPONENTS )
+//ETX
+
+#endif
+
 //BTX
 #define VTKKWRCHelper_InterpolateShading( DTABLE, STABLE, COLOR )                                       \
   unsigned int _tmpDColor[3];                                                                           \
@@ -845,7 +972,10 @@
   unsigned int Einc = dim[0]*dim[1]*components;                                         \
   unsigned int Finc = dim[0]*dim[1]*components                     + components;        \
   unsigned int Ginc = dim[0]*dim[1]*components + dim[0]*components;                     \
-  unsigned int Hinc = dim[0]*dim[1]*components + dim[0]*components + components;
+  unsigned int Hinc = dim[0]*dim[1]*components + dim[0]*components + components;     \
+  int useSSE2 = ( mapper->GetUseSSE2() &&                                               \
+                  vtkFixedPointVolumeRayCastHelper::IsSSE2Supported() );                \
+  (void)useSSE2;
 //ETX
 
 //BTX
@@ -1286,6 +1416,10 @@
 
 #include "vtkObject.h"
 
+#ifdef VTKKW_FP_USE_SSE2
+#include <emmintrin.h> // For the SSE2 interpolation macros
+#endif
+
 class vtkFixedPointVolumeRayCastMapper;
 class vtkVolume;
 
@@ -1300,6 +1434,11 @@ public:
                                 int,
                                 vtkVolume *,
                                 vtkFixedPointVolumeRayCastMapper *) {}
+
+  // Description:
+  // Return 1 if the SSE2 interpolation kernels were compiled in and the
+  // processor supports SSE2, 0 otherwise.
+  static int IsSSE2Supported();
   
 protected:
   vtkFixedPointVolumeRayCastHelper();
@@ -430,6 +430,7 @@ vtkFixedPointVolumeRayCastMapper::vtkFixedPointVolumeRayCastMapper()
   this->CompositeGOShadeHelper = vtkFixedPointVolumeRayCastCompositeGOShadeHelper::New();
   
   this->IntermixIntersectingGeometry = 1;
+  this->UseSSE2 = 1;
   
   int i;
   for ( i = 0; i < 4; i++ )
@@ -3032,6 +3033,8 @@ void vtkFixedPointVolumeRayCastMapper::PrintSelf(ostream& os, vtkIndent indent)
      << this->AutoAdjustSampleDistances << endl;
   os << indent << "Intermix Intersecting Geometry: "
     << (this->IntermixIntersectingGeometry ? "On\n" : "Off\n");
+  os << indent << "Use SSE2: "
+    << (this->UseSSE2 ? "On\n" : "Off\n");
   
   os << indent << "ShadingRequired: " << this->ShadingRequired << endl;
   os << indent << "GradientOpacityRequired: " << this->GradientOpacityRequired
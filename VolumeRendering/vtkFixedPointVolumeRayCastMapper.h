@@ -153,6 +153,15 @@ public:
   vtkGetMacro( IntermixIntersectingGeometry, int );
   vtkBooleanMacro( IntermixIntersectingGeometry, int );
 
+  // Description:
+  // If UseSSE2 is on (the default), the trilinear interpolation in the
+  // helpers is done with SSE2 instructions when VTK was compiled for SSE2
+  // and the processor supports it. The image is the same either way;
+  // turning this off selects the portable code.
+  vtkSetClampMacro( UseSSE2, int, 0, 1 );
+  vtkGetMacro( UseSSE2, int );
+  vtkBooleanMacro( UseSSE2, int );
+
   // Description:
   // What is the image sample distance required to achieve the desired time?
   // A version of this method is provided that does not require the volume
@@ -317,6 +326,7 @@ protected:
   float            RetrieveRenderTime( vtkRenderer *ren );
 
   int              IntermixIntersectingGeometry;
+  int              UseSSE2;
 
   float            MinimumViewDistance;
 
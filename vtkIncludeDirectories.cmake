@@ -136,6 +136,7 @@ ENDIF (VTK_USE_MATROX_IMAGING)
 #-----------------------------------------------------------------------------
 # Include directories for 3rd-party utilities provided by VTK.
 VTK_THIRD_PARTY_INCLUDE2(ZLIB)
+VTK_THIRD_PARTY_INCLUDE2(LZ4)
 VTK_THIRD_PARTY_INCLUDE2(JPEG)
 VTK_THIRD_PARTY_INCLUDE2(PNG)
 VTK_THIRD_PARTY_INCLUDE2(TIFF)